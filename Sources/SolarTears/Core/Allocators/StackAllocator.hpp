@@ -1,7 +1,7 @@
 #pragma once
 
 #include <new>
-#include "..\..\Logging\LoggerQueue.hpp"
+#include "../../Logging/LoggerQueue.hpp"
 
 class StackAllocator //Allocates static objects that live the whole time of the application
 {
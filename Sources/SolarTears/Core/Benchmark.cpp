@@ -0,0 +1,341 @@
+#include "Benchmark.hpp"
+#include "FrameCounter.hpp"
+#include "ThreadPool.hpp"
+#include "Util.hpp"
+#include "Scene/Scene.hpp"
+#include "Scene/SceneDescription/SceneDescription.hpp"
+#include "Scene/SceneDescription/StressSceneGenerator.hpp"
+#include "Scene/SceneDescription/GltfSceneImporter.hpp"
+#include "../Rendering/Common/FrameGraph/FrameGraphConfig.hpp"
+#include "../Rendering/Common/FrameGraph/FrameGraphDescription.hpp"
+#include "../Rendering/Common/FrameGraph/ModernFrameGraph.hpp"
+#include "../Rendering/Common/FrameGraph/Passes/CopyImagePass.hpp"
+#include "../Rendering/Common/FrameGraph/Passes/GBufferPass.hpp"
+#include "../Rendering/Common/FrameLatency.hpp"
+#include "../Rendering/Vulkan/VulkanRenderer.hpp"
+#include "../Rendering/Vulkan/VulkanUtils.hpp"
+#include "../Logging/LoggerQueue.hpp"
+#include "../Logging/ConsoleLogger.hpp"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+	float Percentile(const std::vector<float>& sortedValues, float percentile)
+	{
+		size_t index = (size_t)(percentile * (float)(sortedValues.size() - 1) + 0.5f);
+		return sortedValues[std::min(index, sortedValues.size() - 1)];
+	}
+
+	void PrintTimeStatistics(const char* name, std::vector<float>& values)
+	{
+		std::sort(values.begin(), values.end());
+
+		float sum = 0.0f;
+		for(float value: values)
+		{
+			sum += value;
+		}
+
+		std::printf("%-12s avg %8.3f  min %8.3f  median %8.3f  p95 %8.3f  p99 %8.3f  max %8.3f\n", name, sum / (float)values.size(), values.front(), Percentile(values, 0.5f), Percentile(values, 0.95f), Percentile(values, 0.99f), values.back());
+	}
+
+	void CreateGridSceneDescription(const BenchmarkConfig& config, SceneDescription& sceneDesc)
+	{
+		sceneDesc.GetRenderableComponent().AddMaterial("BenchmarkMaterial", RenderableSceneMaterialData
+		{
+			.TextureFilename   = config.TextureFilename,
+			.NormalMapFilename = L""
+		});
+
+		RenderableSceneGeometryData quadGeometry;
+		quadGeometry.Vertices =
+		{
+			RenderableSceneVertex{.Position = DirectX::XMFLOAT3(-1.0f, -1.0f, 0.0f), .Normal = DirectX::XMFLOAT3(0.0f, 0.0f, -1.0f), .Texcoord = DirectX::XMFLOAT2(0.0f, 1.0f)},
+			RenderableSceneVertex{.Position = DirectX::XMFLOAT3(-1.0f,  1.0f, 0.0f), .Normal = DirectX::XMFLOAT3(0.0f, 0.0f, -1.0f), .Texcoord = DirectX::XMFLOAT2(0.0f, 0.0f)},
+			RenderableSceneVertex{.Position = DirectX::XMFLOAT3( 1.0f,  1.0f, 0.0f), .Normal = DirectX::XMFLOAT3(0.0f, 0.0f, -1.0f), .Texcoord = DirectX::XMFLOAT2(1.0f, 0.0f)},
+			RenderableSceneVertex{.Position = DirectX::XMFLOAT3( 1.0f, -1.0f, 0.0f), .Normal = DirectX::XMFLOAT3(0.0f, 0.0f, -1.0f), .Texcoord = DirectX::XMFLOAT2(1.0f, 1.0f)}
+		};
+
+		quadGeometry.Indices =
+		{
+			0, 1, 2,
+			0, 2, 3
+		};
+
+		sceneDesc.GetRenderableComponent().AddGeometry("Quad", std::move(quadGeometry));
+
+		//Each scene object needs its own mesh, the object handles are looked up by mesh name
+		uint32_t gridSize  = std::max(config.ObjectGridSize, 1u);
+		float    cellScale = 1.0f / (float)gridSize;
+		for(uint32_t y = 0; y < gridSize; y++)
+		{
+			for(uint32_t x = 0; x < gridSize; x++)
+			{
+				std::string meshName = "BenchmarkMesh" + std::to_string(y * gridSize + x);
+				sceneDesc.GetRenderableComponent().AddMesh(meshName);
+				sceneDesc.GetRenderableComponent().AddSubmesh(meshName, RenderableSceneSubmeshData
+				{
+					.GeometryName = "Quad",
+					.MaterialName = "BenchmarkMaterial"
+				});
+
+				SceneDescriptionObject& sceneObject = sceneDesc.CreateEmptySceneObject();
+				sceneObject.SetLocation(SceneObjectLocation
+				{
+					.Position           = DirectX::XMFLOAT3(-1.0f + (2.0f * x + 1.0f) * cellScale, -1.0f + (2.0f * y + 1.0f) * cellScale, 1.0f),
+					.Scale              = cellScale,
+					.RotationQuaternion = DirectX::XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f)
+				});
+
+				sceneObject.SetMeshComponentName(meshName);
+			}
+		}
+	}
+
+	//Returns the object count
+	uint32_t CreateBenchmarkScene(const BenchmarkConfig& config, ThreadPool* threadPool, Vulkan::Renderer* renderer, Scene* scene)
+	{
+		uint32_t objectCount = 0;
+
+		SceneDescription sceneDesc;
+		if(!config.GltfFilename.empty())
+		{
+			GltfSceneImporter gltfImporter(threadPool);
+			gltfImporter.SetFallbackTexture(config.TextureFilename);
+			if(!gltfImporter.Import(config.GltfFilename, &sceneDesc))
+			{
+				throw std::runtime_error("Failed to import the glTF scene: " + gltfImporter.GetLastError());
+			}
+
+			const GltfImportStats& importStats = gltfImporter.GetLastImportStats();
+			std::printf("glTF import: %.3f ms (load %.3f ms, decode %.3f ms), %.1f MB of files, %.1f MB of geometry, peak process memory %.1f MB\n", importStats.ImportTimeMs, importStats.LoadTimeMs, importStats.DecodeTimeMs,
+			            (double)importStats.FileBytes / (1024.0 * 1024.0), (double)importStats.GeometryBytes / (1024.0 * 1024.0), (double)importStats.PeakProcessMemoryBytes / (1024.0 * 1024.0));
+			std::printf("glTF import: %u meshes, %u geometries, %u materials, %u skipped primitives\n", importStats.MeshCount, importStats.GeometryCount, importStats.MaterialCount, importStats.SkippedPrimitiveCount);
+
+			objectCount = importStats.ObjectCount;
+		}
+		else if(config.StressObjectCount != 0)
+		{
+			StressSceneGenerator stressSceneGenerator(StressSceneGenerator::CreateDefaultConfig(config.StressSeed, config.StressObjectCount));
+			stressSceneGenerator.Generate(&sceneDesc);
+
+			objectCount = config.StressObjectCount;
+		}
+		else
+		{
+			CreateGridSceneDescription(config, sceneDesc);
+
+			objectCount = config.ObjectGridSize * config.ObjectGridSize;
+		}
+
+		std::unordered_map<std::string_view, SceneObjectLocation> renderableObjectLocations;
+		sceneDesc.GetRenderableObjectLocations(renderableObjectLocations);
+
+		std::unordered_map<std::string_view, RenderableSceneObjectHandle> meshHandles;
+		BaseRenderableScene* renderableScene = renderer->InitScene(sceneDesc.GetRenderableComponent(), renderableObjectLocations, meshHandles);
+
+		sceneDesc.BuildScene(scene, renderableScene, meshHandles);
+		return objectCount;
+	}
+
+	void CreateBenchmarkFrameGraph(const BenchmarkConfig& config, Vulkan::Renderer* renderer)
+	{
+		FrameGraphConfig frameGraphConfig;
+		frameGraphConfig.SetScreenSize((uint16_t)config.Width, (uint16_t)config.Height);
+
+		FrameGraphDescription frameGraphDescription;
+		frameGraphDescription.AddRenderPass(GBufferPassBase::PassType,   "GBuffer");
+		frameGraphDescription.AddRenderPass(CopyImagePassBase::PassType, "CopyImage");
+
+		frameGraphDescription.AssignSubresourceName("GBuffer",   GBufferPassBase::GetSubresourceStringId(GBufferPassBase::PassSubresourceId::ColorBufferImage), "ColorBuffer");
+		frameGraphDescription.AssignSubresourceName("CopyImage", CopyImagePassBase::GetSubresourceStringId(CopyImagePassBase::PassSubresourceId::SrcImage),     "ColorBuffer");
+		frameGraphDescription.AssignSubresourceName("CopyImage", CopyImagePassBase::GetSubresourceStringId(CopyImagePassBase::PassSubresourceId::DstImage),     "Backbuffer");
+
+		frameGraphDescription.AssignBackbufferName("Backbuffer");
+
+		renderer->InitFrameGraph(std::move(frameGraphConfig), std::move(frameGraphDescription));
+	}
+}
+
+Benchmark::Benchmark(const BenchmarkConfig& config): mConfig(config)
+{
+}
+
+Benchmark::~Benchmark()
+{
+}
+
+BenchmarkConfig Benchmark::ParseCommandLine(std::span<const std::string_view> arguments)
+{
+	BenchmarkConfig config =
+	{
+		.FrameCount        = 1000,
+		.WarmupFrameCount  = 100,
+		.Width             = 768,
+		.Height            = 768,
+		.ObjectGridSize    = 16,
+		.StressObjectCount = 0,
+		.StressSeed        = 1,
+		.TextureFilename   = L"../Assets/Textures/Test1.dds",
+		.GltfFilename      = L""
+	};
+
+	auto parseUint = [](std::string_view argument, auto& outValue)
+	{
+		std::from_chars(argument.data(), argument.data() + argument.size(), outValue);
+	};
+
+	for(size_t argumentIndex = 0; argumentIndex + 1 < arguments.size(); argumentIndex++)
+	{
+		std::string_view argument = arguments[argumentIndex];
+		std::string_view value    = arguments[argumentIndex + 1];
+
+		if(argument == "-frames")
+		{
+			parseUint(value, config.FrameCount);
+		}
+		else if(argument == "-warmup")
+		{
+			parseUint(value, config.WarmupFrameCount);
+		}
+		else if(argument == "-width")
+		{
+			parseUint(value, config.Width);
+		}
+		else if(argument == "-height")
+		{
+			parseUint(value, config.Height);
+		}
+		else if(argument == "-grid")
+		{
+			parseUint(value, config.ObjectGridSize);
+		}
+		else if(argument == "-stress")
+		{
+			parseUint(value, config.StressObjectCount);
+		}
+		else if(argument == "-seed")
+		{
+			parseUint(value, config.StressSeed);
+		}
+		else if(argument == "-texture")
+		{
+			//Texture paths are expected to be ASCII
+			config.TextureFilename = std::wstring(value.begin(), value.end());
+		}
+		else if(argument == "-gltf")
+		{
+			config.GltfFilename = Utils::ConvertUTF8ToWstring(value);
+		}
+	}
+
+	config.FrameCount = std::max(config.FrameCount, 1u);
+	return config;
+}
+
+int Benchmark::Run()
+{
+	std::unique_ptr<LoggerQueue>  loggerQueue  = std::make_unique<LoggerQueue>();
+	std::unique_ptr<Logger>       logger       = std::make_unique<ConsoleLogger>();
+	std::unique_ptr<ThreadPool>   threadPool   = std::make_unique<ThreadPool>();
+	std::unique_ptr<FrameCounter> frameCounter = std::make_unique<FrameCounter>();
+
+	std::vector<float>       frameTimesMs;
+	std::vector<float>       gpuWaitTimesMs;
+	std::vector<double>      passGpuTimeSumsMs;
+	std::vector<std::string> passNames;
+
+	uint32_t objectCount = 0;
+
+	try
+	{
+		std::unique_ptr<Scene>            scene    = std::make_unique<Scene>(threadPool.get());
+		std::unique_ptr<Vulkan::Renderer> renderer = std::make_unique<Vulkan::Renderer>(loggerQueue.get(), frameCounter.get(), threadPool.get());
+
+		renderer->AttachToOffscreenTarget(mConfig.Width, mConfig.Height);
+		objectCount = CreateBenchmarkScene(mConfig, threadPool.get(), renderer.get(), scene.get());
+		CreateBenchmarkFrameGraph(mConfig, renderer.get());
+
+		const ModernFrameGraph* frameGraph = renderer->GetFrameGraph();
+		for(uint32_t passIndex = 0; passIndex < frameGraph->GetRenderPassCount(); passIndex++)
+		{
+			passNames.emplace_back(frameGraph->GetRenderPassName(passIndex));
+		}
+
+		passGpuTimeSumsMs.resize(passNames.size(), 0.0);
+		frameTimesMs.reserve(mConfig.FrameCount);
+		gpuWaitTimesMs.reserve(mConfig.FrameCount);
+
+		const uint32_t maxLogMessagesPerTick = 10;
+
+		FrameLatencyTracker* latencyTracker  = renderer->GetLatencyTracker();
+		uint32_t             totalFrameCount = mConfig.WarmupFrameCount + mConfig.FrameCount;
+		for(uint32_t frameIndex = 0; frameIndex < totalFrameCount; frameIndex++)
+		{
+			loggerQueue->FeedMessages(logger.get(), maxLogMessagesPerTick);
+
+			auto frameStartTime = std::chrono::steady_clock::now();
+
+			//There's no input, but the tracker measures the GPU waits relative to this point
+			latencyTracker->MarkInputSampled();
+
+			scene->UpdateScene(frameCounter->GetFrameCount(), 1.0f);
+			latencyTracker->MarkSimulationFinished();
+
+			renderer->Render();
+
+			auto frameEndTime = std::chrono::steady_clock::now();
+			frameCounter->IncrementFrame();
+
+			if(frameIndex < mConfig.WarmupFrameCount)
+			{
+				continue;
+			}
+
+			frameTimesMs.push_back(std::chrono::duration<float, std::milli>(frameEndTime - frameStartTime).count());
+			gpuWaitTimesMs.push_back(latencyTracker->GetLastFrameSample().GpuWaitMs);
+
+			//The pass timings lag a few frames behind, which doesn't matter for the averages
+			for(uint32_t passIndex = 0; passIndex < (uint32_t)passNames.size(); passIndex++)
+			{
+				passGpuTimeSumsMs[passIndex] += frameGraph->GetRenderPassGpuTimeMs(passIndex);
+			}
+		}
+
+		renderer.reset();
+		scene.reset();
+	}
+	catch(const Vulkan::VulkanUtils::VkException& exception)
+	{
+		loggerQueue->PostLogMessage(exception.ToString());
+		loggerQueue->FeedMessages(logger.get(), UINT32_MAX);
+		return 1;
+	}
+	catch(const std::exception& exception)
+	{
+		loggerQueue->PostLogMessage(exception.what());
+		loggerQueue->FeedMessages(logger.get(), UINT32_MAX);
+		return 1;
+	}
+
+	loggerQueue->FeedMessages(logger.get(), UINT32_MAX);
+
+	std::printf("Frames: %u (+%u warmup), resolution %ux%u, %u objects\n", mConfig.FrameCount, mConfig.WarmupFrameCount, mConfig.Width, mConfig.Height, objectCount);
+	std::printf("CPU times, ms:\n");
+	PrintTimeStatistics("Frame", frameTimesMs);
+	PrintTimeStatistics("GPU wait", gpuWaitTimesMs);
+
+	std::printf("GPU pass times, ms (avg):\n");
+	for(size_t passIndex = 0; passIndex < passNames.size(); passIndex++)
+	{
+		std::printf("%-24s %8.3f\n", passNames[passIndex].c_str(), passGpuTimeSumsMs[passIndex] / (double)mConfig.FrameCount);
+	}
+
+	return 0;
+}
\ No newline at end of file
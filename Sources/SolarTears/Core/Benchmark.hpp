@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <span>
+#include <string_view>
+
+struct BenchmarkConfig
+{
+	uint32_t     FrameCount;
+	uint32_t     WarmupFrameCount;
+	uint32_t     Width;
+	uint32_t     Height;
+	uint32_t     ObjectGridSize;    //The scene is a grid of ObjectGridSize x ObjectGridSize textured quads
+	uint32_t     StressObjectCount; //If non-zero, the grid is replaced by a procedural stress scene with this many objects
+	uint64_t     StressSeed;
+	std::wstring TextureFilename;
+	std::wstring GltfFilename;      //If not empty, the scene is imported from this glTF file instead
+};
+
+//Renders a fixed scene with the Vulkan renderer into an offscreen target and prints the frame time statistics to stdout.
+//Doesn't need a window or any input, so it can run on headless machines with a software Vulkan implementation
+class Benchmark
+{
+public:
+	Benchmark(const BenchmarkConfig& config);
+	~Benchmark();
+
+	//Accepts -frames N, -warmup N, -width N, -height N, -grid N, -stress N, -seed N, -texture PATH, -gltf PATH. Unknown arguments are ignored
+	static BenchmarkConfig ParseCommandLine(std::span<const std::string_view> arguments);
+
+	//Returns the process exit code
+	int Run();
+
+private:
+	BenchmarkConfig mConfig;
+};
\ No newline at end of file
@@ -1,11 +1,20 @@
 #include "Engine.hpp"
 #include "FrameCounter.hpp"
 #include "FPSCounter.hpp"
+#include "FrameCapture.hpp"
+#include "FixedTimestep.hpp"
+#include "FramePacer.hpp"
+#include "Telemetry/TelemetryPublisher.hpp"
+#include "Util.hpp"
 #include "Scene/SceneDescription/SceneDescription.hpp"
+#include "Scene/SceneDescription/GltfSceneImporter.hpp"
 #include "Scene/Scene.hpp"
 #include "../Input/Inputter.hpp"
 #include "../Rendering/Common/FrameGraph/FrameGraphConfig.hpp"
 #include "../Rendering/Common/FrameGraph/FrameGraphDescription.hpp"
+#include "../Rendering/Common/RenderStatistics.hpp"
+#include "../Rendering/Common/PerformanceHud.hpp"
+#include "../Rendering/Common/FrameLatency.hpp"
 #include "../Rendering/Vulkan/VulkanRenderer.hpp"
 #include "../Rendering/D3D12/D3D12Renderer.hpp"
 #include "../Logging/LoggerQueue.hpp"
@@ -13,8 +22,9 @@
 
 #include "../Rendering/Common/FrameGraph/Passes/CopyImagePass.hpp"
 #include "../Rendering/Common/FrameGraph/Passes/GBufferPass.hpp"
+#include "../Rendering/Common/FrameGraph/Passes/PerformanceHudPass.hpp"
 
-Engine::Engine(): mPaused(false)
+Engine::Engine(): mPaused(false), mShowPerformanceHud(false), mLateInputSampling(false)
 {
 	mLoggerQueue = std::make_unique<LoggerQueue>();
 	mLogger      = std::make_unique<VisualStudioDebugLogger>();
@@ -22,17 +32,38 @@ Engine::Engine(): mPaused(false)
 	mTimer      = std::make_unique<Timer>();
 	mThreadPool = std::make_unique<ThreadPool>();
 
+	mSimulationTimestep = std::make_unique<FixedTimestep>(SimulationStepTime, MaxSimulationStepsPerFrame);
+	mFramePacer         = std::make_unique<FramePacer>();
+
 	mFrameCounter = std::make_unique<FrameCounter>();
 	mFPSCounter   = std::make_unique<FPSCounter>();
 
+	mRenderStatistics   = std::make_unique<RenderStatistics>();
+	mTelemetryPublisher = std::make_unique<TelemetryPublisher>(mLoggerQueue.get());
+
 	mRenderingSystem = std::make_unique<D3D12::Renderer>(mLoggerQueue.get(), mFrameCounter.get(), mThreadPool.get());
 	mInputSystem     = std::make_unique<Inputter>(mLoggerQueue.get());
 
+	mRenderingSystem->GetLatencyTracker()->SetLateInputSampling(mLateInputSampling);
+
 	CreateScene();
 }
 
 Engine::~Engine()
 {
+	if(mCaptureRecorder)
+	{
+		if(mCaptureRecorder->SaveToFile(mCapturePath))
+		{
+			mLoggerQueue->PostLogMessage("Capture: recorded " + std::to_string(mCaptureRecorder->GetFrameCount()) + " frames to " + mCapturePath);
+		}
+		else
+		{
+			mLoggerQueue->PostLogMessage("Capture: failed to save " + mCapturePath);
+		}
+
+		mLoggerQueue->FeedMessages(mLogger.get(), UINT32_MAX);
+	}
 }
 
 void Engine::BindToWindow(Window* window)
@@ -64,36 +95,147 @@ void Engine::Update()
 	const uint32_t maxLogMessagesPerTick = 10;
 	mLoggerQueue->FeedMessages(mLogger.get(), maxLogMessagesPerTick);
 
+	FrameLatencyTracker* latencyTracker = mRenderingSystem->GetLatencyTracker();
+	if(!mPaused)
+	{
+		mFramePacer->WaitForNextFrame();
+		latencyTracker->WaitForInputSampling();
+	}
+
 	mInputSystem->UpdateControls();
+	latencyTracker->MarkInputSampled();
+
 	if(mInputSystem->GetKeyStateChange(ControlCode::Pause))
 	{
 		mPaused = !mPaused;
 		mInputSystem->SetPaused(mPaused);
 	}
 
+	if(mInputSystem->GetKeyStateChange(ControlCode::TogglePerformanceHud))
+	{
+		PerformanceHud* performanceHud = mRenderingSystem->GetPerformanceHud();
+		performanceHud->SetVisible(!performanceHud->IsVisible());
+	}
+
 	if(!mPaused)
 	{
 		mTimer->Tick();
 
-		mScene->ProcessControls(mInputSystem.get(), mTimer->GetDeltaTime());
+		//Replayed frames use the recorded time deltas, so the simulation doesn't depend on how fast the frames are rendered
+		float frameDeltaTime = mTimer->GetDeltaTime();
+		if(mCaptureReplayer)
+		{
+			std::span<const ObjectDataUpdateInfo> replayedObjectUpdates;
+			const FrameCaptureFrameHeader& replayedFrame = mCaptureReplayer->NextFrame(&replayedObjectUpdates);
+
+			mInputSystem->OverrideControlState(replayedFrame.Controls);
+			mScene->OverrideRenderableUpdates(replayedObjectUpdates);
+			frameDeltaTime = replayedFrame.DeltaTime;
+		}
+
+		mScene->ProcessLookControls(mInputSystem.get(), frameDeltaTime);
+
+		uint32_t simulationStepCount = mSimulationTimestep->Advance(frameDeltaTime);
+		for(uint32_t stepIndex = 0; stepIndex < simulationStepCount; stepIndex++)
+		{
+			mScene->SimulateStep(mInputSystem.get(), mSimulationTimestep->GetStepTime());
+		}
+
+		mScene->UpdateScene(mFrameCounter->GetFrameCount(), mSimulationTimestep->GetInterpolationFactor());
+		latencyTracker->MarkSimulationFinished();
+
+		if(mCaptureRecorder)
+		{
+			mCaptureRecorder->RecordFrame(frameDeltaTime, mInputSystem->GetControlState(), mScene->GetLastRenderableUpdates());
+		}
 
-		mScene->UpdateScene(mFrameCounter->GetFrameCount());
 		mRenderingSystem->Render();
+		mRenderStatistics->GatherFrame();
+		mRenderingSystem->GetPerformanceHud()->UpdateFrameData(mTimer->GetDeltaTime(), mRenderStatistics->GetLastFrameCounters(), latencyTracker->GetLastFrameSample());
+		mTelemetryPublisher->PublishFrame(mFrameCounter.get(), mTimer.get(), mRenderStatistics.get(), mLoggerQueue.get(), mThreadPool.get());
 
 		mFrameCounter->IncrementFrame();
 		mFPSCounter->LogFPS(mFrameCounter.get(), mTimer.get(), mLoggerQueue.get());
+		mRenderStatistics->LogStatistics(mFrameCounter.get(), mTimer.get(), mLoggerQueue.get());
+		latencyTracker->LogLatency(mTimer.get(), mLoggerQueue.get());
+
+		if(mCaptureReplayer)
+		{
+			mCaptureReplayer->RecordFrameTiming(mTimer->GetDeltaTime() * 1000.0f, latencyTracker->GetLastFrameSample().GpuWaitMs);
+			if(mCaptureReplayer->IsFinished())
+			{
+				FinishCaptureReplay();
+			}
+		}
 	}
 }
 
+void Engine::SetTargetFrameTime(float targetFrameTimeSeconds)
+{
+	mFramePacer->SetTargetFrameTime(targetFrameTimeSeconds);
+}
+
+void Engine::SetLateInputSampling(bool enabled)
+{
+	mLateInputSampling = enabled;
+	mRenderingSystem->GetLatencyTracker()->SetLateInputSampling(mLateInputSampling);
+
+	mLoggerQueue->PostLogMessage(std::string("Late input sampling ") + (mLateInputSampling ? "enabled" : "disabled"));
+}
+
+void Engine::SetPerformanceHudEnabled(bool enabled)
+{
+	mShowPerformanceHud = enabled;
+}
+
+void Engine::StartCaptureRecording(const std::string& capturePath)
+{
+	mCaptureReplayer.reset();
+
+	mCaptureRecorder = std::make_unique<FrameCaptureRecorder>();
+	mCapturePath     = capturePath;
+}
+
+void Engine::StartCaptureReplay(const std::string& capturePath)
+{
+	mCaptureRecorder.reset();
+
+	mCaptureReplayer = std::make_unique<FrameCaptureReplayer>();
+	mCapturePath     = capturePath;
+
+	if(!mCaptureReplayer->LoadFromFile(capturePath) || mCaptureReplayer->IsFinished())
+	{
+		mLoggerQueue->PostLogMessage("Capture: failed to load " + capturePath);
+		mCaptureReplayer.reset();
+		return;
+	}
+
+	mLoggerQueue->PostLogMessage("Capture: replaying " + std::to_string(mCaptureReplayer->GetFrameCount()) + " frames from " + capturePath);
+}
+
+void Engine::FinishCaptureReplay()
+{
+	mLoggerQueue->PostLogMessage("Capture: replay finished, average frame time " + std::to_string(mCaptureReplayer->GetAverageFrameTimeMs()) + " ms");
+
+	std::string timingsPath = mCapturePath + ".timings.csv";
+	if(!mCaptureReplayer->SaveTimingsToFile(timingsPath))
+	{
+		mLoggerQueue->PostLogMessage("Capture: failed to save " + timingsPath);
+	}
+
+	mCaptureReplayer.reset();
+}
+
 void Engine::CreateScene()
 {
 	mScene.reset();
-	mScene = std::make_unique<Scene>();
+	mScene = std::make_unique<Scene>(mThreadPool.get());
 
 	SceneDescription sceneDesc;
 	sceneDesc.GetRenderableComponent().AddMaterial("TestMaterial", RenderableSceneMaterialData
 	{
-		.TextureFilename = L"../Assets/Textures/Test1.dds"
+		.TextureFilename   = L"../Assets/Textures/Test1.dds",
+		.NormalMapFilename = L""
 	});
 
 	RenderableSceneGeometryData meshGeometry;
@@ -156,7 +298,33 @@ void Engine::CreateScene()
 
 	sceneObject.SetMeshComponentName("TestMesh");
 
+	BuildScene(sceneDesc);
+}
 
+void Engine::ImportGltfScene(const std::string& gltfPath)
+{
+	SceneDescription sceneDesc;
+
+	GltfSceneImporter gltfImporter(mThreadPool.get());
+	gltfImporter.SetFallbackTexture(L"../Assets/Textures/Test1.dds");
+	if(!gltfImporter.Import(Utils::ConvertUTF8ToWstring(gltfPath), &sceneDesc))
+	{
+		mLoggerQueue->PostLogMessage("glTF: failed to import " + gltfPath + ": " + gltfImporter.GetLastError());
+		return;
+	}
+
+	const GltfImportStats& importStats = gltfImporter.GetLastImportStats();
+	mLoggerQueue->PostLogMessage("glTF: imported " + gltfPath + " in " + std::to_string(importStats.ImportTimeMs) + " ms, " + std::to_string(importStats.ObjectCount) + " objects, peak process memory "
+	                             + std::to_string(importStats.PeakProcessMemoryBytes / (1024 * 1024)) + " MB");
+
+	mScene.reset();
+	mScene = std::make_unique<Scene>(mThreadPool.get());
+
+	BuildScene(sceneDesc);
+}
+
+void Engine::BuildScene(SceneDescription& sceneDesc)
+{
 	//Build/bake the scene
 	std::unordered_map<std::string_view, SceneObjectLocation> renderableObjectLocations;
 	sceneDesc.GetRenderableObjectLocations(renderableObjectLocations);
@@ -178,6 +346,12 @@ void Engine::CreateFrameGraph(Window* window)
 	frameGraphDescription.AddRenderPass(GBufferPassBase::PassType,   "GBuffer");
 	frameGraphDescription.AddRenderPass(CopyImagePassBase::PassType, "CopyImage");
 
+	if(mShowPerformanceHud)
+	{
+		frameGraphDescription.AddRenderPass(PerformanceHudPassBase::PassType, "PerformanceHud");
+		frameGraphDescription.AssignSubresourceName("PerformanceHud", PerformanceHudPassBase::GetSubresourceStringId(PerformanceHudPassBase::PassSubresourceId::ColorBufferImage), "ColorBuffer");
+	}
+
 	frameGraphDescription.AssignSubresourceName("GBuffer",   GBufferPassBase::GetSubresourceStringId(GBufferPassBase::PassSubresourceId::ColorBufferImage), "ColorBuffer");
 	frameGraphDescription.AssignSubresourceName("CopyImage", CopyImagePassBase::GetSubresourceStringId(CopyImagePassBase::PassSubresourceId::SrcImage),     "ColorBuffer");
 	frameGraphDescription.AssignSubresourceName("CopyImage", CopyImagePassBase::GetSubresourceStringId(CopyImagePassBase::PassSubresourceId::DstImage),     "Backbuffer");
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include "Window.hpp"
 #include "ThreadPool.hpp"
 #include "Timer.hpp"
@@ -10,11 +11,21 @@ class Inputter;
 class Logger;
 class LoggerQueue;
 class Scene;
+class SceneDescription;
 class FrameCounter;
 class FPSCounter;
+class RenderStatistics;
+class TelemetryPublisher;
+class FrameCaptureRecorder;
+class FrameCaptureReplayer;
+class FixedTimestep;
+class FramePacer;
 
 class Engine
 {
+	static constexpr float    SimulationStepTime         = 1.0f / 60.0f;
+	static constexpr uint32_t MaxSimulationStepsPerFrame = 5;
+
 public:
 	Engine();
 	~Engine();
@@ -22,12 +33,35 @@ public:
 	void BindToWindow(Window* window);
 	void Update();
 
+	//Limits the frame rate. 0 means no limit
+	void SetTargetFrameTime(float targetFrameTimeSeconds);
+
+	//Moves the time the frame would spend waiting on the GPU to before the input sampling, reducing the input-to-present latency
+	void SetLateInputSampling(bool enabled);
+
+	//Adds the performance overlay pass to the frame graph, takes effect the next time the frame graph is created. F1 shows/hides the overlay at runtime
+	void SetPerformanceHudEnabled(bool enabled);
+
+	//Records the frame input until the engine is destroyed, then saves it to capturePath
+	void StartCaptureRecording(const std::string& capturePath);
+
+	//Replays a recorded capture and saves the measured frame times to capturePath + ".timings.csv" when it ends
+	void StartCaptureReplay(const std::string& capturePath);
+
+	//Replaces the current scene with the one from a glTF 2.0 file. Keeps the current scene if the import fails
+	void ImportGltfScene(const std::string& gltfPath);
+
 private:
 	void CreateScene();
+	void BuildScene(SceneDescription& sceneDesc);
 	void CreateFrameGraph(Window* window);
 
+	void FinishCaptureReplay();
+
 private:
 	bool mPaused;
+	bool mShowPerformanceHud;
+	bool mLateInputSampling;
 
 	std::unique_ptr<Scene>  mScene;
 
@@ -37,9 +71,19 @@ private:
 	std::unique_ptr<Timer>      mTimer;
 	std::unique_ptr<ThreadPool> mThreadPool;
 
+	std::unique_ptr<FixedTimestep> mSimulationTimestep;
+	std::unique_ptr<FramePacer>    mFramePacer;
+
 	std::unique_ptr<Renderer> mRenderingSystem;
 	std::unique_ptr<Inputter> mInputSystem;
 
 	std::unique_ptr<FrameCounter> mFrameCounter;
 	std::unique_ptr<FPSCounter>   mFPSCounter;
+
+	std::unique_ptr<RenderStatistics>   mRenderStatistics;
+	std::unique_ptr<TelemetryPublisher> mTelemetryPublisher;
+
+	std::unique_ptr<FrameCaptureRecorder> mCaptureRecorder;
+	std::unique_ptr<FrameCaptureReplayer> mCaptureReplayer;
+	std::string                           mCapturePath;
 };
\ No newline at end of file
@@ -0,0 +1,44 @@
+#include "FixedTimestep.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+FixedTimestep::FixedTimestep(float stepTime, uint32_t maxStepsPerFrame): mStepTime(stepTime), mMaxStepsPerFrame(maxStepsPerFrame), mAccumulatedTime(0.0f)
+{
+	assert(stepTime > 0.0f);
+	assert(maxStepsPerFrame > 0);
+}
+
+FixedTimestep::~FixedTimestep()
+{
+}
+
+uint32_t FixedTimestep::Advance(float frameDeltaTime)
+{
+	mAccumulatedTime += std::max(frameDeltaTime, 0.0f);
+
+	uint32_t stepCount = 0;
+	while(mAccumulatedTime >= mStepTime && stepCount < mMaxStepsPerFrame)
+	{
+		mAccumulatedTime -= mStepTime;
+		stepCount++;
+	}
+
+	//Spiral of death protection
+	if(mAccumulatedTime >= mStepTime)
+	{
+		mAccumulatedTime = std::fmod(mAccumulatedTime, mStepTime);
+	}
+
+	return stepCount;
+}
+
+float FixedTimestep::GetStepTime() const
+{
+	return mStepTime;
+}
+
+float FixedTimestep::GetInterpolationFactor() const
+{
+	return mAccumulatedTime / mStepTime;
+}
\ No newline at end of file
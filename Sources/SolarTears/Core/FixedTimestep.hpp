@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+
+//Splits the variable frame time into fixed simulation steps. The time left over after the last step
+//is carried to the next frame and gives the interpolation factor between the last two simulated states
+class FixedTimestep
+{
+public:
+	FixedTimestep(float stepTime, uint32_t maxStepsPerFrame);
+	~FixedTimestep();
+
+	//Adds the frame time and returns the number of simulation steps to run this frame.
+	//At most maxStepsPerFrame steps are returned, the rest of the time is dropped so a slow frame can't make the next one even slower
+	uint32_t Advance(float frameDeltaTime);
+
+	float GetStepTime() const;
+
+	//0 means the previous simulation step, 1 means the last one
+	float GetInterpolationFactor() const;
+
+private:
+	float    mStepTime;
+	uint32_t mMaxStepsPerFrame;
+
+	float mAccumulatedTime;
+};
\ No newline at end of file
@@ -0,0 +1,206 @@
+#include "FrameCapture.hpp"
+#include <array>
+#include <cassert>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+	constexpr uint32_t CaptureFileMagic   = 0x43465453; //"STFC"
+	constexpr uint32_t CaptureFileVersion = 1;
+
+	struct CaptureFileHeader
+	{
+		uint32_t Magic;
+		uint32_t Version;
+		uint32_t FrameHeaderSize;
+		uint32_t ObjectUpdateSize;
+		uint32_t FrameCount;
+		uint32_t ObjectUpdateCount;
+	};
+}
+
+FrameCaptureRecorder::FrameCaptureRecorder()
+{
+}
+
+FrameCaptureRecorder::~FrameCaptureRecorder()
+{
+}
+
+void FrameCaptureRecorder::RecordFrame(float deltaTime, const ControlState& controlState, std::span<const ObjectDataUpdateInfo> objectUpdates)
+{
+	mFrames.push_back(FrameCaptureFrameHeader
+	{
+		.DeltaTime         = deltaTime,
+		.Controls          = controlState,
+		.ObjectUpdateCount = (uint32_t)objectUpdates.size()
+	});
+
+	mObjectUpdates.insert(mObjectUpdates.end(), objectUpdates.begin(), objectUpdates.end());
+}
+
+uint32_t FrameCaptureRecorder::GetFrameCount() const
+{
+	return (uint32_t)mFrames.size();
+}
+
+bool FrameCaptureRecorder::SaveToFile(const std::string& path) const
+{
+	std::ofstream fout(std::filesystem::path(path), std::ios::binary | std::ios::trunc);
+	if(!fout)
+	{
+		return false;
+	}
+
+	CaptureFileHeader fileHeader =
+	{
+		.Magic             = CaptureFileMagic,
+		.Version           = CaptureFileVersion,
+		.FrameHeaderSize   = sizeof(FrameCaptureFrameHeader),
+		.ObjectUpdateSize  = sizeof(ObjectDataUpdateInfo),
+		.FrameCount        = (uint32_t)mFrames.size(),
+		.ObjectUpdateCount = (uint32_t)mObjectUpdates.size()
+	};
+
+	fout.write(reinterpret_cast<const char*>(&fileHeader),           sizeof(CaptureFileHeader));
+	fout.write(reinterpret_cast<const char*>(mFrames.data()),        mFrames.size()        * sizeof(FrameCaptureFrameHeader));
+	fout.write(reinterpret_cast<const char*>(mObjectUpdates.data()), mObjectUpdates.size() * sizeof(ObjectDataUpdateInfo));
+
+	return fout.good();
+}
+
+FrameCaptureReplayer::FrameCaptureReplayer(): mNextFrameIndex(0), mNextObjectUpdateIndex(0)
+{
+}
+
+FrameCaptureReplayer::~FrameCaptureReplayer()
+{
+}
+
+bool FrameCaptureReplayer::LoadFromFile(const std::string& path)
+{
+	std::filesystem::path capturePath(path);
+	std::ifstream fin(capturePath, std::ios::binary);
+	if(!fin)
+	{
+		return false;
+	}
+
+	CaptureFileHeader fileHeader;
+	fin.read(reinterpret_cast<char*>(&fileHeader), sizeof(CaptureFileHeader));
+	if(!fin || fileHeader.Magic != CaptureFileMagic || fileHeader.Version != CaptureFileVersion)
+	{
+		return false;
+	}
+
+	//The capture is a memory dump, the layout has to match
+	if(fileHeader.FrameHeaderSize != sizeof(FrameCaptureFrameHeader) || fileHeader.ObjectUpdateSize != sizeof(ObjectDataUpdateInfo))
+	{
+		return false;
+	}
+
+	mFrames.resize(fileHeader.FrameCount);
+	mObjectUpdates.resize(fileHeader.ObjectUpdateCount);
+
+	fin.read(reinterpret_cast<char*>(mFrames.data()),        mFrames.size()        * sizeof(FrameCaptureFrameHeader));
+	fin.read(reinterpret_cast<char*>(mObjectUpdates.data()), mObjectUpdates.size() * sizeof(ObjectDataUpdateInfo));
+	if(!fin)
+	{
+		mFrames.clear();
+		mObjectUpdates.clear();
+		return false;
+	}
+
+	size_t totalObjectUpdateCount = 0;
+	for(const FrameCaptureFrameHeader& frame: mFrames)
+	{
+		totalObjectUpdateCount += frame.ObjectUpdateCount;
+	}
+
+	if(totalObjectUpdateCount != mObjectUpdates.size())
+	{
+		mFrames.clear();
+		mObjectUpdates.clear();
+		return false;
+	}
+
+	mNextFrameIndex        = 0;
+	mNextObjectUpdateIndex = 0;
+
+	mFrameTimings.clear();
+	mFrameTimings.reserve(mFrames.size());
+
+	return true;
+}
+
+bool FrameCaptureReplayer::IsFinished() const
+{
+	return mNextFrameIndex >= mFrames.size();
+}
+
+uint32_t FrameCaptureReplayer::GetFrameCount() const
+{
+	return (uint32_t)mFrames.size();
+}
+
+const FrameCaptureFrameHeader& FrameCaptureReplayer::NextFrame(std::span<const ObjectDataUpdateInfo>* outObjectUpdates)
+{
+	assert(!IsFinished());
+
+	const FrameCaptureFrameHeader& frame = mFrames[mNextFrameIndex];
+	*outObjectUpdates = std::span(mObjectUpdates.begin() + mNextObjectUpdateIndex, frame.ObjectUpdateCount);
+
+	mNextFrameIndex        += 1;
+	mNextObjectUpdateIndex += frame.ObjectUpdateCount;
+
+	return frame;
+}
+
+void FrameCaptureReplayer::RecordFrameTiming(float frameTimeMs, float gpuWaitMs)
+{
+	assert(mFrameTimings.size() < mNextFrameIndex);
+
+	mFrameTimings.push_back(FrameTiming
+	{
+		.FrameTimeMs = frameTimeMs,
+		.GpuWaitMs   = gpuWaitMs
+	});
+}
+
+float FrameCaptureReplayer::GetAverageFrameTimeMs() const
+{
+	if(mFrameTimings.empty())
+	{
+		return 0.0f;
+	}
+
+	double frameTimeSum = 0.0;
+	for(const FrameTiming& frameTiming: mFrameTimings)
+	{
+		frameTimeSum += frameTiming.FrameTimeMs;
+	}
+
+	return (float)(frameTimeSum / (double)mFrameTimings.size());
+}
+
+bool FrameCaptureReplayer::SaveTimingsToFile(const std::string& path) const
+{
+	std::ofstream fout(std::filesystem::path(path), std::ios::trunc);
+	if(!fout)
+	{
+		return false;
+	}
+
+	fout << "frame,sim_dt_ms,frame_ms,gpu_wait_ms\n";
+
+	std::array<char, 128> lineBuffer;
+	for(size_t frameIndex = 0; frameIndex < mFrameTimings.size(); frameIndex++)
+	{
+		std::snprintf(lineBuffer.data(), lineBuffer.size(), "%zu,%.4f,%.4f,%.4f\n", frameIndex, mFrames[frameIndex].DeltaTime * 1000.0f, mFrameTimings[frameIndex].FrameTimeMs, mFrameTimings[frameIndex].GpuWaitMs);
+		fout << lineBuffer.data();
+	}
+
+	return fout.good();
+}
\ No newline at end of file
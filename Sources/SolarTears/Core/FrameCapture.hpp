@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+#include "../Input/ControlState.hpp"
+#include "../Rendering/Common/Scene/RenderableSceneMisc.hpp"
+
+//Everything the simulation of one frame depends on, except the scene itself
+struct FrameCaptureFrameHeader
+{
+	float        DeltaTime;
+	ControlState Controls;
+	uint32_t     ObjectUpdateCount;
+};
+
+//Records the per-frame engine input so the same frames can be replayed later.
+//The capture is a plain memory dump, it's only valid on the same platform and the same build configuration
+class FrameCaptureRecorder
+{
+public:
+	FrameCaptureRecorder();
+	~FrameCaptureRecorder();
+
+	void RecordFrame(float deltaTime, const ControlState& controlState, std::span<const ObjectDataUpdateInfo> objectUpdates);
+
+	uint32_t GetFrameCount() const;
+
+	//Returns false if the file can't be written
+	bool SaveToFile(const std::string& path) const;
+
+private:
+	std::vector<FrameCaptureFrameHeader> mFrames;
+	std::vector<ObjectDataUpdateInfo>    mObjectUpdates;
+};
+
+//Feeds the recorded frames back to the engine. The simulation uses the recorded time deltas instead of the real ones,
+//so every replay of a capture simulates exactly the same frames and the measured frame times can be compared frame-by-frame
+class FrameCaptureReplayer
+{
+	struct FrameTiming
+	{
+		float FrameTimeMs;
+		float GpuWaitMs;
+	};
+
+public:
+	FrameCaptureReplayer();
+	~FrameCaptureReplayer();
+
+	//Returns false if the file can't be read or isn't a valid capture
+	bool LoadFromFile(const std::string& path);
+
+	bool     IsFinished()    const;
+	uint32_t GetFrameCount() const;
+
+	//Returns the recorded data of the next frame and advances to the frame after it
+	const FrameCaptureFrameHeader& NextFrame(std::span<const ObjectDataUpdateInfo>* outObjectUpdates);
+
+	//Should be called once per replayed frame with the real measured times
+	void RecordFrameTiming(float frameTimeMs, float gpuWaitMs);
+
+	float GetAverageFrameTimeMs() const;
+
+	//Writes the measured times as CSV, one line per frame. Returns false if the file can't be written
+	bool SaveTimingsToFile(const std::string& path) const;
+
+private:
+	std::vector<FrameCaptureFrameHeader> mFrames;
+	std::vector<ObjectDataUpdateInfo>    mObjectUpdates;
+
+	uint32_t mNextFrameIndex;
+	size_t   mNextObjectUpdateIndex;
+
+	std::vector<FrameTiming> mFrameTimings;
+};
\ No newline at end of file
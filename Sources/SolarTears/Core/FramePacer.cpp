@@ -0,0 +1,85 @@
+#include "FramePacer.hpp"
+#include <thread>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+FramePacer::FramePacer(): mTargetFrameDuration(Clock::duration::zero()), mNextFrameTime(Clock::now())
+{
+	mSpinDuration = std::chrono::microseconds(500);
+
+#ifdef _WIN32
+	//High resolution timers are supported since Windows 10 1803. Without them the sleep granularity is the system timer period
+	mWaitableTimer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+	if(mWaitableTimer == nullptr)
+	{
+		mSpinDuration = std::chrono::milliseconds(2);
+	}
+#endif
+}
+
+FramePacer::~FramePacer()
+{
+#ifdef _WIN32
+	if(mWaitableTimer != nullptr)
+	{
+		CloseHandle(mWaitableTimer);
+	}
+#endif
+}
+
+void FramePacer::SetTargetFrameTime(float targetFrameTimeSeconds)
+{
+	mTargetFrameDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(targetFrameTimeSeconds));
+	mNextFrameTime       = Clock::now();
+}
+
+void FramePacer::WaitForNextFrame()
+{
+	if(mTargetFrameDuration <= Clock::duration::zero())
+	{
+		return;
+	}
+
+	Clock::time_point currentTime = Clock::now();
+	if(currentTime >= mNextFrameTime)
+	{
+		mNextFrameTime = currentTime + mTargetFrameDuration;
+		return;
+	}
+
+	SleepUntil(mNextFrameTime - mSpinDuration);
+	while(Clock::now() < mNextFrameTime)
+	{
+		std::this_thread::yield();
+	}
+
+	mNextFrameTime += mTargetFrameDuration;
+}
+
+void FramePacer::SleepUntil(Clock::time_point wakeTime)
+{
+	Clock::duration sleepDuration = wakeTime - Clock::now();
+	if(sleepDuration <= Clock::duration::zero())
+	{
+		return;
+	}
+
+#ifdef _WIN32
+	if(mWaitableTimer != nullptr)
+	{
+		//Negative due time is relative, in 100 ns units
+		LARGE_INTEGER dueTime;
+		dueTime.QuadPart = -(LONGLONG)(std::chrono::duration_cast<std::chrono::nanoseconds>(sleepDuration).count() / 100);
+
+		if(SetWaitableTimerEx(mWaitableTimer, &dueTime, 0, nullptr, nullptr, nullptr, 0))
+		{
+			WaitForSingleObject(mWaitableTimer, INFINITE);
+			return;
+		}
+	}
+#endif
+
+	std::this_thread::sleep_until(wakeTime);
+}
\ No newline at end of file
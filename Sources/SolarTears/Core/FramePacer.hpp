@@ -0,0 +1,34 @@
+#pragma once
+
+#include <chrono>
+
+//Keeps the frames from starting more often than the target frame time
+class FramePacer
+{
+	using Clock = std::chrono::steady_clock;
+
+public:
+	FramePacer();
+	~FramePacer();
+
+	//0 disables the pacing
+	void SetTargetFrameTime(float targetFrameTimeSeconds);
+
+	//Sleeps until the next frame should start. Should be called once per frame before sampling the input.
+	//If the frame took longer than the target, returns immediately and starts counting from now instead of trying to catch up
+	void WaitForNextFrame();
+
+private:
+	void SleepUntil(Clock::time_point wakeTime);
+
+private:
+	Clock::duration   mTargetFrameDuration;
+	Clock::time_point mNextFrameTime;
+
+	//The OS sleeps can overshoot. The sleep ends this much earlier and the rest is spent spinning
+	Clock::duration mSpinDuration;
+
+#ifdef _WIN32
+	void* mWaitableTimer;
+#endif
+};
\ No newline at end of file
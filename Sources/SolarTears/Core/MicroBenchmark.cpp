@@ -0,0 +1,423 @@
+#include "MicroBenchmark.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <unordered_map>
+
+namespace
+{
+	constexpr uint64_t MaxIterationCount = 1000000000;
+
+	//Benchmark names are plain identifiers, but keep the output valid JSON anyway
+	std::string EscapeJsonString(std::string_view str)
+	{
+		std::string result;
+		result.reserve(str.size());
+		for(char character: str)
+		{
+			if(character == '"' || character == '\\')
+			{
+				result.push_back('\\');
+			}
+
+			result.push_back(character);
+		}
+
+		return result;
+	}
+}
+
+MicroBenchmarkState::MicroBenchmarkState(uint64_t iterationCount, int64_t argument): mIterationCount(iterationCount), mRemainingIterations(iterationCount), mArgument(argument)
+{
+	mStarted = false;
+	mPaused  = false;
+
+	mElapsedTime = std::chrono::steady_clock::duration::zero();
+
+	mItemsProcessed = 0;
+}
+
+MicroBenchmarkState::~MicroBenchmarkState()
+{
+}
+
+bool MicroBenchmarkState::KeepRunning()
+{
+	if(!mStarted)
+	{
+		mStarted       = true;
+		mLastStartTime = std::chrono::steady_clock::now();
+	}
+
+	if(mRemainingIterations == 0)
+	{
+		if(!mPaused)
+		{
+			mElapsedTime += std::chrono::steady_clock::now() - mLastStartTime;
+			mPaused       = true;
+		}
+
+		return false;
+	}
+
+	mRemainingIterations--;
+	return true;
+}
+
+void MicroBenchmarkState::PauseTiming()
+{
+	if(!mPaused)
+	{
+		mElapsedTime += std::chrono::steady_clock::now() - mLastStartTime;
+		mPaused       = true;
+	}
+}
+
+void MicroBenchmarkState::ResumeTiming()
+{
+	if(mPaused)
+	{
+		mLastStartTime = std::chrono::steady_clock::now();
+		mPaused        = false;
+	}
+}
+
+int64_t MicroBenchmarkState::GetArgument() const
+{
+	return mArgument;
+}
+
+uint64_t MicroBenchmarkState::GetIterationCount() const
+{
+	return mIterationCount;
+}
+
+double MicroBenchmarkState::GetElapsedNs() const
+{
+	return std::chrono::duration<double, std::nano>(mElapsedTime).count();
+}
+
+void MicroBenchmarkState::SetItemsProcessed(uint64_t itemCount)
+{
+	mItemsProcessed = itemCount;
+}
+
+uint64_t MicroBenchmarkState::GetItemsProcessed() const
+{
+	return mItemsProcessed;
+}
+
+void MicroBenchmarkState::SetCounter(std::string_view name, double value)
+{
+	auto counterIt = std::find_if(mCounters.begin(), mCounters.end(), [name](const std::pair<std::string, double>& counter)
+	{
+		return counter.first == name;
+	});
+
+	if(counterIt != mCounters.end())
+	{
+		counterIt->second = value;
+	}
+	else
+	{
+		mCounters.emplace_back(std::string(name), value);
+	}
+}
+
+std::span<const std::pair<std::string, double>> MicroBenchmarkState::GetCounters() const
+{
+	return mCounters;
+}
+
+void MicroBenchmarkState::SetError(std::string_view message)
+{
+	mError               = message;
+	mRemainingIterations = 0;
+}
+
+const std::string& MicroBenchmarkState::GetError() const
+{
+	return mError;
+}
+
+MicroBenchmarkSuite::MicroBenchmarkSuite()
+{
+}
+
+MicroBenchmarkSuite::~MicroBenchmarkSuite()
+{
+}
+
+MicroBenchmarkConfig MicroBenchmarkSuite::ParseCommandLine(std::span<const std::string_view> arguments)
+{
+	MicroBenchmarkConfig config =
+	{
+		.Filter              = "",
+		.JsonOutputPath      = "",
+		.BaselinePath        = "",
+		.RegressionThreshold = 0.1,
+		.MinTimeSeconds      = 0.5
+	};
+
+	for(size_t argumentIndex = 0; argumentIndex + 1 < arguments.size(); argumentIndex++)
+	{
+		std::string_view argument = arguments[argumentIndex];
+		std::string_view value    = arguments[argumentIndex + 1];
+
+		if(argument == "-filter")
+		{
+			config.Filter = value;
+		}
+		else if(argument == "-json")
+		{
+			config.JsonOutputPath = value;
+		}
+		else if(argument == "-baseline")
+		{
+			config.BaselinePath = value;
+		}
+		else if(argument == "-threshold")
+		{
+			config.RegressionThreshold = std::strtod(std::string(value).c_str(), nullptr);
+		}
+		else if(argument == "-mintime")
+		{
+			config.MinTimeSeconds = std::strtod(std::string(value).c_str(), nullptr);
+		}
+	}
+
+	return config;
+}
+
+void MicroBenchmarkSuite::Register(std::string_view name, MicroBenchmarkFunc func, std::initializer_list<int64_t> arguments)
+{
+	if(arguments.size() == 0)
+	{
+		mBenchmarks.push_back(RegisteredBenchmark
+		{
+			.Name     = std::string(name),
+			.Func     = func,
+			.Argument = 0
+		});
+
+		return;
+	}
+
+	for(int64_t argument: arguments)
+	{
+		mBenchmarks.push_back(RegisteredBenchmark
+		{
+			.Name     = std::string(name) + "/" + std::to_string(argument),
+			.Func     = func,
+			.Argument = argument
+		});
+	}
+}
+
+int MicroBenchmarkSuite::Run(const MicroBenchmarkConfig& config)
+{
+	std::vector<MicroBenchmarkResult> results;
+	bool                              anyFailed = false;
+
+	std::printf("%-48s %16s %12s %16s\n", "Benchmark", "Time", "Iterations", "Items/s");
+	for(const RegisteredBenchmark& benchmark: mBenchmarks)
+	{
+		if(!config.Filter.empty() && benchmark.Name.find(config.Filter) == std::string::npos)
+		{
+			continue;
+		}
+
+		MicroBenchmarkResult result = RunBenchmark(benchmark, config.MinTimeSeconds);
+		std::printf("%-48s %13.1f ns %12llu %16.0f\n", result.Name.c_str(), result.TimePerIterationNs, (unsigned long long)result.Iterations, result.ItemsPerSecond);
+		for(const auto& counter: result.Counters)
+		{
+			std::printf("    %-44s %16.4f\n", counter.first.c_str(), counter.second);
+		}
+
+		if(!result.Error.empty())
+		{
+			std::printf("    ERROR: %s\n", result.Error.c_str());
+			anyFailed = true;
+		}
+
+		std::fflush(stdout);
+		results.push_back(std::move(result));
+	}
+
+	if(!config.JsonOutputPath.empty() && !WriteJson(config.JsonOutputPath, results))
+	{
+		std::fprintf(stderr, "Cannot write %s\n", config.JsonOutputPath.c_str());
+		return 1;
+	}
+
+	if(!config.BaselinePath.empty() && !CompareToBaseline(config.BaselinePath, results, config.RegressionThreshold))
+	{
+		return 1;
+	}
+
+	return anyFailed ? 1 : 0;
+}
+
+MicroBenchmarkResult MicroBenchmarkSuite::RunBenchmark(const RegisteredBenchmark& benchmark, double minTimeSeconds) const
+{
+	//Same approach as Google Benchmark: grow the iteration count until the run takes long enough
+	const double minTimeNs = minTimeSeconds * 1.0e9;
+
+	uint64_t iterationCount = 1;
+	while(true)
+	{
+		MicroBenchmarkState state(iterationCount, benchmark.Argument);
+		benchmark.Func(state);
+
+		double elapsedNs = state.GetElapsedNs();
+		if(elapsedNs >= minTimeNs || iterationCount >= MaxIterationCount || !state.GetError().empty())
+		{
+			double elapsedSeconds = elapsedNs * 1.0e-9;
+
+			MicroBenchmarkResult result =
+			{
+				.Name               = benchmark.Name,
+				.Iterations         = iterationCount,
+				.TimePerIterationNs = elapsedNs / (double)iterationCount,
+				.ItemsPerSecond     = (elapsedSeconds > 0.0) ? ((double)state.GetItemsProcessed() / elapsedSeconds) : 0.0,
+				.Counters           = std::vector<std::pair<std::string, double>>(state.GetCounters().begin(), state.GetCounters().end()),
+				.Error              = state.GetError()
+			};
+
+			return result;
+		}
+
+		double multiplier = (elapsedNs > 0.0) ? (minTimeNs * 1.4 / elapsedNs) : 10.0;
+		multiplier = std::clamp(multiplier, 2.0, 10.0);
+
+		iterationCount = std::min((uint64_t)((double)iterationCount * multiplier), MaxIterationCount);
+	}
+}
+
+bool MicroBenchmarkSuite::WriteJson(const std::string& path, std::span<const MicroBenchmarkResult> results) const
+{
+	std::ofstream fout(std::filesystem::path(path), std::ios::trunc);
+	if(!fout)
+	{
+		return false;
+	}
+
+	std::time_t currentTime = std::time(nullptr);
+
+	char dateBuffer[64] = {0};
+	std::strftime(dateBuffer, sizeof(dateBuffer), "%Y-%m-%dT%H:%M:%S", std::localtime(&currentTime));
+
+#if defined(DEBUG) || defined(_DEBUG)
+	const char* buildType = "debug";
+#else
+	const char* buildType = "release";
+#endif
+
+	fout << "{\n";
+	fout << "  \"context\": {\n";
+	fout << "    \"date\": \"" << dateBuffer << "\",\n";
+	fout << "    \"executable\": \"SolarTears\",\n";
+	fout << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+	fout << "    \"library_build_type\": \"" << buildType << "\"\n";
+	fout << "  },\n";
+	fout << "  \"benchmarks\": [\n";
+
+	//One benchmark per line, CompareToBaseline relies on it
+	for(size_t resultIndex = 0; resultIndex < results.size(); resultIndex++)
+	{
+		const MicroBenchmarkResult& result = results[resultIndex];
+		std::string escapedName = EscapeJsonString(result.Name);
+
+		char numberBuffer[64];
+		std::snprintf(numberBuffer, sizeof(numberBuffer), "%.3f", result.TimePerIterationNs);
+
+		//Only the wall clock time is measured, cpu_time is there for compatibility with the Google Benchmark tools
+		fout << "    {\"name\": \"" << escapedName << "\", \"run_name\": \"" << escapedName << "\", \"run_type\": \"iteration\", \"iterations\": " << result.Iterations;
+		fout << ", \"real_time\": " << numberBuffer << ", \"cpu_time\": " << numberBuffer << ", \"time_unit\": \"ns\"";
+
+		std::snprintf(numberBuffer, sizeof(numberBuffer), "%.3f", result.ItemsPerSecond);
+		fout << ", \"items_per_second\": " << numberBuffer;
+
+		for(const auto& counter: result.Counters)
+		{
+			std::snprintf(numberBuffer, sizeof(numberBuffer), "%.6f", counter.second);
+			fout << ", \"" << EscapeJsonString(counter.first) << "\": " << numberBuffer;
+		}
+
+		if(!result.Error.empty())
+		{
+			fout << ", \"error_occurred\": true, \"error_message\": \"" << EscapeJsonString(result.Error) << "\"";
+		}
+
+		fout << ((resultIndex + 1 < results.size()) ? "},\n" : "}\n");
+	}
+
+	fout << "  ]\n";
+	fout << "}\n";
+
+	return fout.good();
+}
+
+bool MicroBenchmarkSuite::CompareToBaseline(const std::string& path, std::span<const MicroBenchmarkResult> results, double regressionThreshold) const
+{
+	std::filesystem::path baselinePath(path);
+
+	std::ifstream fin(baselinePath);
+	if(!fin)
+	{
+		std::fprintf(stderr, "Cannot open the baseline %s\n", path.c_str());
+		return false;
+	}
+
+	//Not a general JSON parser: the baseline is expected to be written by WriteJson, with one benchmark per line
+	const std::string_view nameKey     = "\"name\": \"";
+	const std::string_view realTimeKey = "\"real_time\": ";
+
+	std::unordered_map<std::string, double> baselineTimes;
+
+	std::string line;
+	while(std::getline(fin, line))
+	{
+		size_t namePos     = line.find(nameKey);
+		size_t realTimePos = line.find(realTimeKey);
+		if(namePos == std::string::npos || realTimePos == std::string::npos)
+		{
+			continue;
+		}
+
+		size_t nameBegin = namePos + nameKey.size();
+		size_t nameEnd   = line.find('"', nameBegin);
+		if(nameEnd == std::string::npos)
+		{
+			continue;
+		}
+
+		baselineTimes[line.substr(nameBegin, nameEnd - nameBegin)] = std::strtod(line.c_str() + realTimePos + realTimeKey.size(), nullptr);
+	}
+
+	std::printf("\nComparison against %s (threshold %+.1f%%):\n", path.c_str(), regressionThreshold * 100.0);
+	std::printf("%-48s %16s %16s %10s\n", "Benchmark", "Baseline", "Current", "Change");
+
+	bool regressed = false;
+	for(const MicroBenchmarkResult& result: results)
+	{
+		auto baselineIt = baselineTimes.find(result.Name);
+		if(baselineIt == baselineTimes.end() || baselineIt->second <= 0.0)
+		{
+			std::printf("%-48s %16s %13.1f ns %10s\n", result.Name.c_str(), "-", result.TimePerIterationNs, "new");
+			continue;
+		}
+
+		double relativeChange = result.TimePerIterationNs / baselineIt->second - 1.0;
+		bool   isRegression   = relativeChange > regressionThreshold;
+
+		std::printf("%-48s %13.1f ns %13.1f ns %+9.1f%%%s\n", result.Name.c_str(), baselineIt->second, result.TimePerIterationNs, relativeChange * 100.0, isRegression ? " REGRESSION" : "");
+		regressed = regressed || isRegression;
+	}
+
+	return !regressed;
+}
\ No newline at end of file
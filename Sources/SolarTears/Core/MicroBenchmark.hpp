@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <span>
+#include <chrono>
+#include <initializer_list>
+
+//Passed to each benchmark function. The timed region is the loop over KeepRunning()
+class MicroBenchmarkState
+{
+public:
+	MicroBenchmarkState(uint64_t iterationCount, int64_t argument);
+	~MicroBenchmarkState();
+
+	bool KeepRunning();
+
+	//Excludes per-iteration setup from the measured time
+	void PauseTiming();
+	void ResumeTiming();
+
+	int64_t  GetArgument()       const;
+	uint64_t GetIterationCount() const;
+	double   GetElapsedNs()      const;
+
+	void     SetItemsProcessed(uint64_t itemCount);
+	uint64_t GetItemsProcessed() const;
+
+	//Additional named values reported along with the timing, e.g. the times of sub-steps
+	void SetCounter(std::string_view name, double value);
+	std::span<const std::pair<std::string, double>> GetCounters() const;
+
+	//Marks the run as failed, for the benchmarks that also check the results. The benchmark should stop right after
+	void SetError(std::string_view message);
+	const std::string& GetError() const;
+
+	//Keeps the compiler from optimizing away the computation of the value
+	template<typename T>
+	static void DoNotOptimize(const T& value);
+
+private:
+	uint64_t mIterationCount;
+	uint64_t mRemainingIterations;
+	int64_t  mArgument;
+
+	bool                                  mStarted;
+	bool                                  mPaused;
+	std::chrono::steady_clock::time_point mLastStartTime;
+	std::chrono::steady_clock::duration   mElapsedTime;
+
+	uint64_t                                    mItemsProcessed;
+	std::vector<std::pair<std::string, double>> mCounters;
+
+	std::string mError;
+};
+
+using MicroBenchmarkFunc = void(*)(MicroBenchmarkState& state);
+
+struct MicroBenchmarkConfig
+{
+	std::string Filter;              //Only the benchmarks with names containing this string are run
+	std::string JsonOutputPath;      //If not empty, the results are written there
+	std::string BaselinePath;        //If not empty, the results are compared against the results stored there
+	double      RegressionThreshold; //Relative slowdown against the baseline that counts as a regression
+	double      MinTimeSeconds;      //Minimal measured time per benchmark
+};
+
+struct MicroBenchmarkResult
+{
+	std::string Name;
+	uint64_t    Iterations;
+	double      TimePerIterationNs;
+	double      ItemsPerSecond;
+
+	std::vector<std::pair<std::string, double>> Counters;
+
+	std::string Error; //Empty if the benchmark didn't fail
+};
+
+//CPU-only benchmarks for the engine hot paths. Needs no GPU and no window.
+//The JSON output follows the Google Benchmark format, so the results can be processed with its tools
+class MicroBenchmarkSuite
+{
+	struct RegisteredBenchmark
+	{
+		std::string        Name;
+		MicroBenchmarkFunc Func;
+		int64_t            Argument;
+	};
+
+public:
+	MicroBenchmarkSuite();
+	~MicroBenchmarkSuite();
+
+	//Accepts -filter STR, -json PATH, -baseline PATH, -threshold FRACTION, -mintime SECONDS. Unknown arguments are ignored
+	static MicroBenchmarkConfig ParseCommandLine(std::span<const std::string_view> arguments);
+
+	//Registers a benchmark once per argument, as "name/argument". With no arguments the benchmark is registered once, with the argument 0
+	void Register(std::string_view name, MicroBenchmarkFunc func, std::initializer_list<int64_t> arguments = {});
+
+	//Returns the process exit code: non-zero if any of the benchmarks failed or regressed against the baseline
+	int Run(const MicroBenchmarkConfig& config);
+
+private:
+	MicroBenchmarkResult RunBenchmark(const RegisteredBenchmark& benchmark, double minTimeSeconds) const;
+
+	bool WriteJson(const std::string& path, std::span<const MicroBenchmarkResult> results) const;
+	bool CompareToBaseline(const std::string& path, std::span<const MicroBenchmarkResult> results, double regressionThreshold) const;
+
+private:
+	std::vector<RegisteredBenchmark> mBenchmarks;
+};
+
+//Registers all engine benchmarks. Defined in MicroBenchmarkCases.cpp
+void RegisterEngineMicroBenchmarks(MicroBenchmarkSuite* suite);
+
+//Registers the job system benchmarks. Defined in ThreadPoolBenchmarkCases.cpp
+void RegisterThreadPoolMicroBenchmarks(MicroBenchmarkSuite* suite);
+
+#include "MicroBenchmark.inl"
\ No newline at end of file
@@ -0,0 +1,6 @@
+template<typename T>
+inline void MicroBenchmarkState::DoNotOptimize(const T& value)
+{
+	//A volatile read of the value forces it to be computed
+	[[maybe_unused]] volatile char sink = *reinterpret_cast<const volatile char*>(&value);
+}
\ No newline at end of file
@@ -0,0 +1,1706 @@
+#include "MicroBenchmark.hpp"
+#include "Math/QuaternionUtils.hpp"
+#include "Scene/Scene.hpp"
+#include "Scene/SceneObjectStore.hpp"
+#include "Scene/SceneDescription/SceneDescription.hpp"
+#include "Scene/SceneDescription/GltfSceneImporter.hpp"
+#include "ThreadPool.hpp"
+#include "../Input/Inputter.hpp"
+#include "../Rendering/Common/RenderingUtils.hpp"
+#include "../Rendering/Common/FrameGraph/FrameGraphConfig.hpp"
+#include "../Rendering/Common/FrameGraph/FrameGraphDescription.hpp"
+#include "../Rendering/Common/FrameGraph/ModernFrameGraph.hpp"
+#include "../Rendering/Common/FrameGraph/ModernFrameGraphBuilder.hpp"
+#include "../Rendering/Common/FrameGraph/Passes/CopyImagePass.hpp"
+#include "../Rendering/Common/FrameGraph/Passes/GBufferPass.hpp"
+#include "../Rendering/Common/Scene/BoundingVolumeHierarchy.hpp"
+#include "../Rendering/Common/Scene/FrustumCuller.hpp"
+#include "../Rendering/Common/Scene/ModernRenderableScene.hpp"
+#include "../Rendering/Common/Scene/ModernRenderableSceneBuilder.hpp"
+#include "../Rendering/Common/Scene/OcclusionCuller.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+
+namespace
+{
+	//Builds the API-independent part of the frame graph only
+	class MockFrameGraphBuilder: public ModernFrameGraphBuilder
+	{
+	public:
+		MockFrameGraphBuilder(ModernFrameGraph* graphToBuild): ModernFrameGraphBuilder(graphToBuild)
+		{
+		}
+
+		//The passes are sorted by dependency level, the last one has the highest
+		uint32_t GetDependencyLevelCount() const
+		{
+			return mTotalPassMetadatas[mRenderPassMetadataSpan.End - 1].DependencyLevel + 1;
+		}
+
+	protected:
+		void InitMetadataPayloads()                                             override {}
+		bool PropagateSubresourcePayloadDataVertically(const ResourceMetadata&) override {return false;}
+		bool PropagateSubresourcePayloadDataHorizontally(const PassMetadata&)   override {return false;}
+
+		void CreateTextures()     override {}
+		void CreateTextureViews() override {}
+		void BuildPassObjects()   override {}
+
+		void CreateBeforePassBarriers(const PassMetadata&, uint32_t) override {}
+		void CreateAfterPassBarriers(const PassMetadata&, uint32_t)  override {}
+
+		uint32_t GetSwapchainImageCount() const override {return Utils::InFlightFrameCount;}
+	};
+
+	//Exposes the object data packing
+	class MockRenderableScene: public ModernRenderableScene
+	{
+	public:
+		MockRenderableScene(): ModernRenderableScene(256)
+		{
+		}
+
+		void PackObjectDataTo(const SceneObjectLocation& location, DirectX::XMFLOAT4X4* outWorldMatrix) const
+		{
+			*outWorldMatrix = PackObjectData(location).WorldMatrix;
+		}
+
+		void SelectLods()
+		{
+			SelectMeshLods();
+		}
+
+		//The triangles the visible meshes are drawn with, either with the selected levels of detail or with the finest ones
+		uint64_t CountVisibleTriangles(bool finestLods) const
+		{
+			uint64_t triangleCount = 0;
+			for(uint32_t meshIndex: mVisibleMeshIndices)
+			{
+				for(uint32_t submeshIndex = mSceneMeshes[meshIndex].FirstSubmeshIndex; submeshIndex < mSceneMeshes[meshIndex].AfterLastSubmeshIndex; submeshIndex++)
+				{
+					const SceneSubmeshLod& submeshLod = finestLods ? mSceneSubmeshLods[mSceneSubmeshes[submeshIndex].FirstLodIndex] : GetSubmeshLod(meshIndex, submeshIndex);
+					triangleCount += (uint64_t)(submeshLod.IndexCount / 3) * mSceneMeshes[meshIndex].InstanceCount;
+				}
+			}
+
+			return triangleCount;
+		}
+
+		//The draws of the visible meshes, or of all meshes in the frustum as if there were no proxy meshes
+		uint32_t CountDraws(bool withoutProxies) const
+		{
+			std::vector<uint32_t> meshIndices;
+			if(withoutProxies)
+			{
+				QueryMeshesInFrustum(DirectX::XMLoadFloat4x4(&mCullingViewProjMatrix), meshIndices, nullptr);
+			}
+			else
+			{
+				meshIndices = mVisibleMeshIndices;
+			}
+
+			uint32_t drawCount = 0;
+			for(uint32_t meshIndex: meshIndices)
+			{
+				drawCount += mSceneMeshes[meshIndex].AfterLastSubmeshIndex - mSceneMeshes[meshIndex].FirstSubmeshIndex;
+			}
+
+			return drawCount;
+		}
+	};
+
+	//Keeps all scene buffers in host memory and loads no textures
+	class MockRenderableSceneBuilder: public ModernRenderableSceneBuilder
+	{
+	public:
+		MockRenderableSceneBuilder(ModernRenderableScene* sceneToBuild, std::vector<std::byte>* uploadMemory): ModernRenderableSceneBuilder(sceneToBuild, 512), mUploadMemoryRef(uploadMemory)
+		{
+		}
+
+		//The upload memory of the previous scene has to be the same
+		void SetPreviousScene(ModernRenderableScene* previousScene)
+		{
+			ModernRenderableSceneBuilder::SetPreviousScene(previousScene);
+		}
+
+		bool   IsLastBakePatch()             const {return mPatchingPreviousScene;}
+		size_t GetLastBakeIntermediateSize() const {return mIntermediateBufferSize;}
+
+	protected:
+		void CreateVertexBufferInfo(size_t)                  override {}
+		void CreateIndexBufferInfo(size_t)                   override {}
+		void CreateConstantBufferInfo(size_t)                override {}
+		void CreateUploadBufferInfo(size_t constantDataSize) override {mUploadMemoryRef->resize(constantDataSize);}
+
+		void AllocateTextureMetadataArrays(size_t)                                                                   override {}
+		void LoadTexture(const std::wstring&, std::span<const std::byte>, uint64_t, size_t, std::vector<std::byte>&) override {}
+
+		void FinishBufferCreation()  override {}
+		void FinishTextureCreation() override {}
+
+		void TakePreviousSceneResources() override {}
+		void FreePreviousSceneResources() override {}
+
+		std::byte* MapUploadBuffer() override {return mUploadMemoryRef->data();}
+
+		void       CreateIntermediateBuffer()      override {mIntermediateMemory.resize(mIntermediateBufferSize);}
+		std::byte* MapIntermediateBuffer()   const override {return mIntermediateMemory.data();}
+		void       UnmapIntermediateBuffer() const override {}
+
+		void WriteInitializationCommands()   const override {}
+		void SubmitInitializationCommands()  const override {}
+		void WaitForInitializationCommands() const override {}
+
+	private:
+		std::vector<std::byte>* mUploadMemoryRef;
+
+		mutable std::vector<std::byte> mIntermediateMemory;
+	};
+
+	struct SceneFixture
+	{
+		uint32_t ObjectCount;
+		bool     AllRigid;
+		uint32_t GeometryCount;
+		uint32_t GeometryGridSize;
+
+		SceneDescription                                          Description;
+		std::unordered_map<std::string_view, SceneObjectLocation> InitialLocations;
+
+		std::unique_ptr<MockRenderableScene>                              RenderableScene;
+		std::vector<std::byte>                                            UploadMemory;
+		std::unordered_map<std::string_view, RenderableSceneObjectHandle> ObjectHandles;
+
+		std::vector<ObjectDataUpdateInfo> RigidObjectUpdates;
+	};
+
+	//Deterministic pseudo-random locations, so the runs are comparable
+	SceneObjectLocation MakeObjectLocation(uint32_t objectIndex)
+	{
+		uint32_t hash = objectIndex * 2654435761u;
+
+		float x = (float)((hash >>  0) & 0xff) / 255.0f * 2.0f - 1.0f;
+		float y = (float)((hash >>  8) & 0xff) / 255.0f * 2.0f - 1.0f;
+		float z = (float)((hash >> 16) & 0xff) / 255.0f;
+
+		DirectX::XMFLOAT4 rotation;
+		DirectX::XMStoreFloat4(&rotation, DirectX::XMQuaternionRotationRollPitchYaw(x, y, z));
+
+		return SceneObjectLocation
+		{
+			.Position           = DirectX::XMFLOAT3(x * 100.0f, y * 100.0f, z * 100.0f),
+			.Scale              = 0.5f + z,
+			.RotationQuaternion = rotation
+		};
+	}
+
+	//Creates a scene of single-submesh objects over geometryCount geometries. Either every object or every second object is rigid, the rest are static.
+	//Each geometry is a square of geometryGridSize x geometryGridSize quads. The objects with the same geometry are drawn instanced
+	std::unique_ptr<SceneFixture> CreateSceneFixture(uint32_t objectCount, bool allRigid, uint32_t geometryCount, uint32_t geometryGridSize)
+	{
+		std::unique_ptr<SceneFixture> fixture = std::make_unique<SceneFixture>();
+		fixture->ObjectCount      = objectCount;
+		fixture->AllRigid         = allRigid;
+		fixture->GeometryCount    = geometryCount;
+		fixture->GeometryGridSize = geometryGridSize;
+
+		RenderableSceneDescription& renderableDescription = fixture->Description.GetRenderableComponent();
+		renderableDescription.AddMaterial("BenchmarkMaterial", RenderableSceneMaterialData
+		{
+			.TextureFilename   = L"",
+			.NormalMapFilename = L""
+		});
+
+		for(uint32_t geometryIndex = 0; geometryIndex < geometryCount; geometryIndex++)
+		{
+			RenderableSceneGeometryData geometry;
+			for(uint32_t y = 0; y <= geometryGridSize; y++)
+			{
+				for(uint32_t x = 0; x <= geometryGridSize; x++)
+				{
+					float u = (float)x / (float)geometryGridSize;
+					float v = (float)y / (float)geometryGridSize;
+
+					geometry.Vertices.push_back(RenderableSceneVertex
+					{
+						.Position = DirectX::XMFLOAT3(2.0f * u - 1.0f, 1.0f - 2.0f * v, (float)(geometryIndex % 4)),
+						.Normal   = DirectX::XMFLOAT3(0.0f, 0.0f, -1.0f),
+						.Texcoord = DirectX::XMFLOAT2(u, v)
+					});
+				}
+			}
+
+			for(uint32_t y = 0; y < geometryGridSize; y++)
+			{
+				for(uint32_t x = 0; x < geometryGridSize; x++)
+				{
+					RenderableSceneIndex topLeftIndex = y * (geometryGridSize + 1) + x;
+					RenderableSceneIndex rowStride    = geometryGridSize + 1;
+
+					geometry.Indices.insert(geometry.Indices.end(), {topLeftIndex, topLeftIndex + 1,             topLeftIndex + rowStride + 1});
+					geometry.Indices.insert(geometry.Indices.end(), {topLeftIndex, topLeftIndex + rowStride + 1, topLeftIndex + rowStride});
+				}
+			}
+
+			renderableDescription.AddGeometry("BenchmarkGeometry" + std::to_string(geometryIndex), std::move(geometry));
+		}
+
+		for(uint32_t objectIndex = 0; objectIndex < objectCount; objectIndex++)
+		{
+			std::string meshName = "BenchmarkMesh" + std::to_string(objectIndex);
+			renderableDescription.AddMesh(meshName);
+			renderableDescription.AddSubmesh(meshName, RenderableSceneSubmeshData
+			{
+				.GeometryName = "BenchmarkGeometry" + std::to_string(objectIndex % geometryCount),
+				.MaterialName = "BenchmarkMaterial"
+			});
+
+			if(allRigid || (objectIndex % 2 == 1))
+			{
+				renderableDescription.MarkMeshAsNonStatic(meshName);
+			}
+
+			SceneDescriptionObject& sceneObject = fixture->Description.CreateEmptySceneObject();
+			sceneObject.SetLocation(MakeObjectLocation(objectIndex));
+			sceneObject.SetMeshComponentName(meshName);
+		}
+
+		fixture->Description.GetRenderableObjectLocations(fixture->InitialLocations);
+
+		fixture->RenderableScene = std::make_unique<MockRenderableScene>();
+
+		MockRenderableSceneBuilder sceneBuilder(fixture->RenderableScene.get(), &fixture->UploadMemory);
+		sceneBuilder.Build(renderableDescription, fixture->InitialLocations, fixture->ObjectHandles);
+
+		for(const auto& [meshName, objectHandle]: fixture->ObjectHandles)
+		{
+			if(!renderableDescription.IsMeshStatic(std::string(meshName)))
+			{
+				fixture->RigidObjectUpdates.push_back(ObjectDataUpdateInfo
+				{
+					.ObjectId          = objectHandle,
+					.NewObjectLocation = fixture->InitialLocations.at(meshName)
+				});
+			}
+		}
+
+		std::sort(fixture->RigidObjectUpdates.begin(), fixture->RigidObjectUpdates.end(), [](const ObjectDataUpdateInfo& left, const ObjectDataUpdateInfo& right)
+		{
+			return left.ObjectId < right.ObjectId;
+		});
+
+		return fixture;
+	}
+
+	//The harness calls each benchmark several times with growing iteration counts, don't rebuild big scenes for each call
+	SceneFixture* GetSceneFixture(uint32_t objectCount, bool allRigid, uint32_t geometryCount, uint32_t geometryGridSize)
+	{
+		static std::unique_ptr<SceneFixture> cachedFixture;
+		if(cachedFixture == nullptr || cachedFixture->ObjectCount != objectCount || cachedFixture->AllRigid != allRigid || cachedFixture->GeometryCount != geometryCount || cachedFixture->GeometryGridSize != geometryGridSize)
+		{
+			cachedFixture.reset();
+			cachedFixture = CreateSceneFixture(objectCount, allRigid, geometryCount, geometryGridSize);
+		}
+
+		return cachedFixture.get();
+	}
+
+	//The camera of the frustum and occlusion culling benchmarks, moved along Z
+	FrameDataUpdateInfo CreateBenchmarkFrameData(float cameraZ)
+	{
+		DirectX::XMFLOAT4X4 projMatrix;
+		DirectX::XMStoreFloat4x4(&projMatrix, DirectX::XMMatrixPerspectiveFovLH(DirectX::XM_PIDIV2, 16.0f / 9.0f, 0.01f, 1000.0f));
+
+		return FrameDataUpdateInfo
+		{
+			.CameraLocation = SceneObjectLocation
+			{
+				.Position           = DirectX::XMFLOAT3(0.0f, 0.0f, cameraZ),
+				.Scale              = 1.0f,
+				.RotationQuaternion = DirectX::XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f)
+			},
+			.ProjMatrix     = projMatrix
+		};
+	}
+
+	//GBuffer pass followed by a chain of copy passes, the last one copying to the backbuffer
+	FrameGraphDescription CreateFrameGraphDescription(uint32_t copyPassCount)
+	{
+		FrameGraphDescription frameGraphDescription;
+
+		frameGraphDescription.AddRenderPass(GBufferPassBase::PassType, "GBuffer");
+		frameGraphDescription.AssignSubresourceName("GBuffer", GBufferPassBase::GetSubresourceStringId(GBufferPassBase::PassSubresourceId::ColorBufferImage), "Image0");
+
+		for(uint32_t copyPassIndex = 0; copyPassIndex < copyPassCount; copyPassIndex++)
+		{
+			std::string passName     = "CopyImage" + std::to_string(copyPassIndex);
+			std::string srcImageName = "Image" + std::to_string(copyPassIndex);
+			std::string dstImageName = (copyPassIndex + 1 == copyPassCount) ? std::string("Backbuffer") : ("Image" + std::to_string(copyPassIndex + 1));
+
+			frameGraphDescription.AddRenderPass(CopyImagePassBase::PassType, passName);
+			frameGraphDescription.AssignSubresourceName(passName, CopyImagePassBase::GetSubresourceStringId(CopyImagePassBase::PassSubresourceId::SrcImage), srcImageName);
+			frameGraphDescription.AssignSubresourceName(passName, CopyImagePassBase::GetSubresourceStringId(CopyImagePassBase::PassSubresourceId::DstImage), dstImageName);
+		}
+
+		frameGraphDescription.AssignBackbufferName("Backbuffer");
+		return frameGraphDescription;
+	}
+
+	void BenchmarkFrameGraphBuild(MicroBenchmarkState& state)
+	{
+		uint32_t copyPassCount = (uint32_t)state.GetArgument();
+		while(state.KeepRunning())
+		{
+			state.PauseTiming();
+
+			FrameGraphConfig frameGraphConfig;
+			frameGraphConfig.SetScreenSize(1920, 1080);
+
+			std::unique_ptr<ModernFrameGraph> frameGraph = std::make_unique<ModernFrameGraph>(std::move(frameGraphConfig));
+			FrameGraphDescription frameGraphDescription = CreateFrameGraphDescription(copyPassCount);
+
+			state.ResumeTiming();
+
+			MockFrameGraphBuilder frameGraphBuilder(frameGraph.get());
+			frameGraphBuilder.Build(std::move(frameGraphDescription));
+
+			state.PauseTiming();
+
+			//Each copy pass reads the image written by the previous one, so every pass gets its own dependency level
+			assert(frameGraphBuilder.GetDependencyLevelCount() == copyPassCount + 1);
+
+			frameGraph.reset();
+			state.ResumeTiming();
+		}
+
+		state.SetItemsProcessed(state.GetIterationCount() * (copyPassCount + 1));
+	}
+
+	constexpr std::array<std::string_view, BaseRenderableSceneBuilder::BuildStepCount> SceneBuildStepNames =
+	{
+		"Step1_BuildSortedMeshList_ms",
+		"Step2_DetectInstanceSpans_ms",
+		"Step3_SortInstanceSpans_ms",
+		"Step4_FillMeshLists_ms",
+		"Step5_AssignSubmeshGeometries_ms",
+		"Step6_AssignSubmeshMaterials_ms",
+		"Step7_FillInitialObjectData_ms",
+		"Step8_AssignMeshHandles_ms",
+		"Step9_ComputeBoundingVolumes_ms",
+		"Step10_CollectOccluders_ms",
+		"Step11_BuildHlodClusters_ms",
+		"Step12_AllocateDynamicObjectSlots_ms"
+	};
+
+	void BenchmarkSceneBake(MicroBenchmarkState& state)
+	{
+		SceneFixture* fixture = GetSceneFixture((uint32_t)state.GetArgument(), false, 4, 1);
+
+		std::array<double, BaseRenderableSceneBuilder::BuildStepCount> stepTimeSumsMs;
+		stepTimeSumsMs.fill(0.0);
+
+		while(state.KeepRunning())
+		{
+			state.PauseTiming();
+
+			std::unique_ptr<MockRenderableScene> renderableScene = std::make_unique<MockRenderableScene>();
+			std::vector<std::byte>               uploadMemory;
+
+			std::unordered_map<std::string_view, RenderableSceneObjectHandle> objectHandles;
+			objectHandles.reserve(fixture->ObjectCount);
+
+			state.ResumeTiming();
+
+			MockRenderableSceneBuilder sceneBuilder(renderableScene.get(), &uploadMemory);
+			sceneBuilder.Build(fixture->Description.GetRenderableComponent(), fixture->InitialLocations, objectHandles);
+
+			state.PauseTiming();
+
+			std::span<const float> stepTimesMs = sceneBuilder.GetLastBuildStepTimesMs();
+			for(uint32_t stepIndex = 0; stepIndex < BaseRenderableSceneBuilder::BuildStepCount; stepIndex++)
+			{
+				stepTimeSumsMs[stepIndex] += stepTimesMs[stepIndex];
+			}
+
+			renderableScene.reset();
+			state.ResumeTiming();
+		}
+
+		for(uint32_t stepIndex = 0; stepIndex < BaseRenderableSceneBuilder::BuildStepCount; stepIndex++)
+		{
+			state.SetCounter(SceneBuildStepNames[stepIndex], stepTimeSumsMs[stepIndex] / (double)state.GetIterationCount());
+		}
+
+		state.SetItemsProcessed(state.GetIterationCount() * fixture->ObjectCount);
+	}
+
+	//Rebuilds the scene of unique geometries with a bake cache filled by the first build, moving one static object each time, as when editing the scene in the editor.
+	//Each build patches the previous scene. The mock builder has no device allocations, the intermediate buffer size shows how much would be uploaded
+	void BenchmarkSceneRebake(MicroBenchmarkState& state)
+	{
+		uint32_t objectCount = (uint32_t)state.GetArgument();
+		SceneFixture* fixture = GetSceneFixture(objectCount, false, objectCount, 8);
+
+		RenderableSceneBakeCache bakeCache;
+		std::unordered_map<std::string_view, RenderableSceneObjectHandle> objectHandles;
+
+		//Even objects are static
+		std::unordered_map<std::string_view, SceneObjectLocation> editedLocations = fixture->InitialLocations;
+		SceneObjectLocation& editedLocation = editedLocations.at("BenchmarkMesh0");
+
+		//The patched scene keeps the upload memory of the previous one
+		std::unique_ptr<MockRenderableScene> previousScene = std::make_unique<MockRenderableScene>();
+		std::vector<std::byte>               uploadMemory;
+
+		double coldBuildTimeMs = 0.0;
+		{
+			MockRenderableSceneBuilder sceneBuilder(previousScene.get(), &uploadMemory);
+			sceneBuilder.SetBakeCache(&bakeCache);
+			sceneBuilder.Build(fixture->Description.GetRenderableComponent(), editedLocations, objectHandles);
+
+			std::span<const float> stepTimesMs = sceneBuilder.GetLastBuildStepTimesMs();
+			for(float stepTimeMs: stepTimesMs)
+			{
+				coldBuildTimeMs += stepTimeMs;
+			}
+		}
+
+		std::array<double, BaseRenderableSceneBuilder::BuildStepCount> stepTimeSumsMs;
+		stepTimeSumsMs.fill(0.0);
+
+		uint64_t patchedBakeCount     = 0;
+		uint64_t intermediateBytesSum = 0;
+		while(state.KeepRunning())
+		{
+			state.PauseTiming();
+
+			std::unique_ptr<MockRenderableScene> renderableScene = std::make_unique<MockRenderableScene>();
+
+			objectHandles.clear();
+			editedLocation.Position.x += 1.0f;
+
+			state.ResumeTiming();
+
+			MockRenderableSceneBuilder sceneBuilder(renderableScene.get(), &uploadMemory);
+			sceneBuilder.SetBakeCache(&bakeCache);
+			sceneBuilder.SetPreviousScene(previousScene.get());
+			sceneBuilder.Build(fixture->Description.GetRenderableComponent(), editedLocations, objectHandles);
+
+			state.PauseTiming();
+
+			std::span<const float> stepTimesMs = sceneBuilder.GetLastBuildStepTimesMs();
+			for(uint32_t stepIndex = 0; stepIndex < BaseRenderableSceneBuilder::BuildStepCount; stepIndex++)
+			{
+				stepTimeSumsMs[stepIndex] += stepTimesMs[stepIndex];
+			}
+
+			patchedBakeCount     += sceneBuilder.IsLastBakePatch() ? 1 : 0;
+			intermediateBytesSum += sceneBuilder.GetLastBakeIntermediateSize();
+
+			previousScene = std::move(renderableScene);
+			state.ResumeTiming();
+		}
+
+		const RenderableSceneBakeCache::BakeStats& bakeStats = bakeCache.GetLastBakeStats();
+		for(uint32_t stepIndex = 0; stepIndex < BaseRenderableSceneBuilder::BuildStepCount; stepIndex++)
+		{
+			state.SetCounter(SceneBuildStepNames[stepIndex], stepTimeSumsMs[stepIndex] / (double)state.GetIterationCount());
+		}
+
+		state.SetCounter("ColdBuildSteps_ms",        coldBuildTimeMs);
+		state.SetCounter("GeometryHits",             (double)bakeStats.GeometryHits);
+		state.SetCounter("GeometryMisses",           (double)bakeStats.GeometryMisses);
+		state.SetCounter("SimplifiedGeometryHits",   (double)bakeStats.SimplifiedGeometryHits);
+		state.SetCounter("SimplifiedGeometryMisses", (double)bakeStats.SimplifiedGeometryMisses);
+		state.SetCounter("PatchedBakes",             (double)patchedBakeCount / (double)state.GetIterationCount());
+		state.SetCounter("Upload_KB",                (double)intermediateBytesSum / (1024.0 * (double)state.GetIterationCount()));
+		state.SetItemsProcessed(state.GetIterationCount() * fixture->ObjectCount);
+	}
+
+	//Builds the scene of unique geometries with the scene cache file, as on the first launch, and then loads it from the file, as on the next launches
+	void BenchmarkSceneCacheLoad(MicroBenchmarkState& state)
+	{
+		uint32_t objectCount = (uint32_t)state.GetArgument();
+		SceneFixture* fixture = GetSceneFixture(objectCount, false, objectCount, 8);
+
+		std::filesystem::path sceneCachePath = std::filesystem::temp_directory_path() / L"SolarTearsBenchmarkSceneCache.bin";
+		std::filesystem::remove(sceneCachePath);
+
+		std::unordered_map<std::string_view, RenderableSceneObjectHandle> objectHandles;
+
+		double coldBuildTimeMs = 0.0;
+		{
+			std::unique_ptr<MockRenderableScene> renderableScene = std::make_unique<MockRenderableScene>();
+			std::vector<std::byte>               uploadMemory;
+
+			auto buildStartTime = std::chrono::steady_clock::now();
+
+			MockRenderableSceneBuilder sceneBuilder(renderableScene.get(), &uploadMemory);
+			sceneBuilder.SetSceneCacheFile(sceneCachePath.wstring());
+			sceneBuilder.Build(fixture->Description.GetRenderableComponent(), fixture->InitialLocations, objectHandles);
+
+			coldBuildTimeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - buildStartTime).count();
+		}
+
+		bool loadedFromCache = true;
+		while(state.KeepRunning())
+		{
+			state.PauseTiming();
+
+			std::unique_ptr<MockRenderableScene> renderableScene = std::make_unique<MockRenderableScene>();
+			std::vector<std::byte>               uploadMemory;
+
+			objectHandles.clear();
+
+			state.ResumeTiming();
+
+			MockRenderableSceneBuilder sceneBuilder(renderableScene.get(), &uploadMemory);
+			sceneBuilder.SetSceneCacheFile(sceneCachePath.wstring());
+			sceneBuilder.Build(fixture->Description.GetRenderableComponent(), fixture->InitialLocations, objectHandles);
+
+			state.PauseTiming();
+			loadedFromCache = loadedFromCache && sceneBuilder.IsLastBuildFromSceneCache();
+			renderableScene.reset();
+			state.ResumeTiming();
+		}
+
+		state.SetCounter("ColdBuild_ms",    coldBuildTimeMs);
+		state.SetCounter("CacheFile_MB",    (double)std::filesystem::file_size(sceneCachePath) / (1024.0 * 1024.0));
+		state.SetCounter("LoadedFromCache", loadedFromCache ? 1.0 : 0.0);
+		state.SetItemsProcessed(state.GetIterationCount() * fixture->ObjectCount);
+
+		std::filesystem::remove(sceneCachePath);
+	}
+
+	//A .glb file with meshCount meshes of 16x16 quads each, under a root node. Every fourth mesh is used by four nodes.
+	//The vertices are interleaved in one buffer view, like most exporters write them
+	void WriteBenchmarkGlbFile(const std::filesystem::path& filePath, uint32_t meshCount)
+	{
+		const uint32_t gridSize       = 16;
+		const uint32_t vertexCount    = (gridSize + 1) * (gridSize + 1);
+		const uint32_t indexCount     = gridSize * gridSize * 6;
+		const uint32_t vertexDataSize = vertexCount * sizeof(RenderableSceneVertex);
+		const uint32_t indexDataSize  = indexCount * sizeof(uint16_t);
+
+		std::vector<std::byte> binData((size_t)(vertexDataSize + indexDataSize) * meshCount);
+		for(uint32_t meshIndex = 0; meshIndex < meshCount; meshIndex++)
+		{
+			std::vector<RenderableSceneVertex> vertices;
+			for(uint32_t y = 0; y <= gridSize; y++)
+			{
+				for(uint32_t x = 0; x <= gridSize; x++)
+				{
+					vertices.push_back(RenderableSceneVertex
+					{
+						.Position = DirectX::XMFLOAT3((float)x / gridSize, (float)y / gridSize, (float)(meshIndex % 7) * 0.01f),
+						.Normal   = DirectX::XMFLOAT3(0.0f, 0.0f, 1.0f),
+						.Texcoord = DirectX::XMFLOAT2((float)x / gridSize, (float)y / gridSize)
+					});
+				}
+			}
+
+			std::vector<uint16_t> indices;
+			for(uint32_t y = 0; y < gridSize; y++)
+			{
+				for(uint32_t x = 0; x < gridSize; x++)
+				{
+					uint16_t cornerIndex = (uint16_t)(y * (gridSize + 1) + x);
+					indices.insert(indices.end(), {cornerIndex, (uint16_t)(cornerIndex + 1), (uint16_t)(cornerIndex + gridSize + 2), cornerIndex, (uint16_t)(cornerIndex + gridSize + 2), (uint16_t)(cornerIndex + gridSize + 1)});
+				}
+			}
+
+			memcpy(binData.data() + (size_t)vertexDataSize * meshIndex,                                     vertices.data(), vertexDataSize);
+			memcpy(binData.data() + (size_t)vertexDataSize * meshCount + (size_t)indexDataSize * meshIndex, indices.data(),  indexDataSize);
+		}
+
+		std::string meshesJson, accessorsJson, nodesJson, rootChildrenJson;
+		uint32_t    nodeIndex = 1;
+		for(uint32_t meshIndex = 0; meshIndex < meshCount; meshIndex++)
+		{
+			std::string vertexOffset  = std::to_string((size_t)vertexDataSize * meshIndex);
+			std::string accessorIndex = std::to_string(meshIndex * 4);
+
+			const char* separator = (meshIndex == 0) ? "" : ",";
+			meshesJson += std::string(separator) + "{\"primitives\":[{\"attributes\":{\"POSITION\":" + accessorIndex + ",\"NORMAL\":" + std::to_string(meshIndex * 4 + 1) + ",\"TEXCOORD_0\":" + std::to_string(meshIndex * 4 + 2)
+			            + "},\"indices\":" + std::to_string(meshIndex * 4 + 3) + ",\"material\":0}]}";
+
+			accessorsJson += std::string(separator) + "{\"bufferView\":0,\"byteOffset\":" + vertexOffset + ",\"componentType\":5126,\"count\":" + std::to_string(vertexCount) + ",\"type\":\"VEC3\",\"min\":[0,0,0],\"max\":[1,1,1]}"
+			               + ",{\"bufferView\":0,\"byteOffset\":" + std::to_string((size_t)vertexDataSize * meshIndex + 12) + ",\"componentType\":5126,\"count\":" + std::to_string(vertexCount) + ",\"type\":\"VEC3\"}"
+			               + ",{\"bufferView\":0,\"byteOffset\":" + std::to_string((size_t)vertexDataSize * meshIndex + 24) + ",\"componentType\":5126,\"count\":" + std::to_string(vertexCount) + ",\"type\":\"VEC2\"}"
+			               + ",{\"bufferView\":1,\"byteOffset\":" + std::to_string((size_t)indexDataSize * meshIndex) + ",\"componentType\":5123,\"count\":" + std::to_string(indexCount) + ",\"type\":\"SCALAR\"}";
+
+			uint32_t meshNodeCount = (meshIndex % 4 == 0) ? 4 : 1;
+			for(uint32_t meshNodeIndex = 0; meshNodeIndex < meshNodeCount; meshNodeIndex++)
+			{
+				SceneObjectLocation nodeLocation = MakeObjectLocation(nodeIndex);
+				nodesJson += ",{\"mesh\":" + std::to_string(meshIndex) + ",\"translation\":[" + std::to_string(nodeLocation.Position.x) + "," + std::to_string(nodeLocation.Position.y) + "," + std::to_string(nodeLocation.Position.z) + "]}";
+
+				rootChildrenJson += ((nodeIndex == 1) ? "" : ",") + std::to_string(nodeIndex);
+				nodeIndex++;
+			}
+		}
+
+		std::string json = "{\"asset\":{\"version\":\"2.0\"},\"scene\":0,\"scenes\":[{\"nodes\":[0]}]"
+		                   ",\"nodes\":[{\"translation\":[0,0,10],\"children\":[" + rootChildrenJson + "]}" + nodesJson + "]"
+		                   ",\"meshes\":[" + meshesJson + "],\"accessors\":[" + accessorsJson + "]"
+		                   ",\"materials\":[{\"pbrMetallicRoughness\":{}}]"
+		                   ",\"buffers\":[{\"byteLength\":" + std::to_string(binData.size()) + "}]"
+		                   ",\"bufferViews\":[{\"buffer\":0,\"byteLength\":" + std::to_string((size_t)vertexDataSize * meshCount) + ",\"byteStride\":32}"
+		                   ",{\"buffer\":0,\"byteOffset\":" + std::to_string((size_t)vertexDataSize * meshCount) + ",\"byteLength\":" + std::to_string((size_t)indexDataSize * meshCount) + "}]}";
+
+		//Both chunks are 4-byte aligned, JSON is padded with spaces
+		json.resize((json.size() + 3) & ~3ull, ' ');
+		binData.resize((binData.size() + 3) & ~3ull);
+
+		std::array<uint32_t, 3> glbHeader      = {0x46546c67, 2, (uint32_t)(12 + 8 + json.size() + 8 + binData.size())};
+		std::array<uint32_t, 2> jsonChunkHeader = {(uint32_t)json.size(), 0x4e4f534a};
+		std::array<uint32_t, 2> binChunkHeader  = {(uint32_t)binData.size(), 0x004e4942};
+
+		std::ofstream fout(filePath, std::ios::binary);
+		fout.write(reinterpret_cast<const char*>(glbHeader.data()),       sizeof(glbHeader));
+		fout.write(reinterpret_cast<const char*>(jsonChunkHeader.data()), sizeof(jsonChunkHeader));
+		fout.write(json.data(), (std::streamsize)json.size());
+		fout.write(reinterpret_cast<const char*>(binChunkHeader.data()),  sizeof(binChunkHeader));
+		fout.write(reinterpret_cast<const char*>(binData.data()), (std::streamsize)binData.size());
+	}
+
+	void RunGltfImportBenchmark(MicroBenchmarkState& state, ThreadPool* threadPool)
+	{
+		uint32_t meshCount = (uint32_t)state.GetArgument();
+
+		std::filesystem::path glbPath = std::filesystem::temp_directory_path() / L"SolarTearsBenchmarkScene.glb";
+		WriteBenchmarkGlbFile(glbPath, meshCount);
+
+		GltfSceneImporter gltfImporter(threadPool);
+
+		double loadTimeSumMs   = 0.0;
+		double decodeTimeSumMs = 0.0;
+		bool   importSucceeded = true;
+		while(state.KeepRunning())
+		{
+			state.PauseTiming();
+			std::unique_ptr<SceneDescription> sceneDescription = std::make_unique<SceneDescription>();
+			state.ResumeTiming();
+
+			importSucceeded = gltfImporter.Import(glbPath.wstring(), sceneDescription.get()) && importSucceeded;
+
+			state.PauseTiming();
+			loadTimeSumMs   += gltfImporter.GetLastImportStats().LoadTimeMs;
+			decodeTimeSumMs += gltfImporter.GetLastImportStats().DecodeTimeMs;
+			sceneDescription.reset();
+			state.ResumeTiming();
+		}
+
+		const GltfImportStats& importStats = gltfImporter.GetLastImportStats();
+		state.SetCounter("Load_ms",              loadTimeSumMs   / (double)state.GetIterationCount());
+		state.SetCounter("Decode_ms",            decodeTimeSumMs / (double)state.GetIterationCount());
+		state.SetCounter("File_MB",              (double)importStats.FileBytes              / (1024.0 * 1024.0));
+		state.SetCounter("PeakProcessMemory_MB", (double)importStats.PeakProcessMemoryBytes / (1024.0 * 1024.0));
+		state.SetCounter("Objects",              (double)importStats.ObjectCount);
+		state.SetCounter("ImportSucceeded",      importSucceeded ? 1.0 : 0.0);
+		state.SetItemsProcessed(state.GetIterationCount() * meshCount);
+
+		std::filesystem::remove(glbPath);
+	}
+
+	void BenchmarkGltfImport(MicroBenchmarkState& state)
+	{
+		RunGltfImportBenchmark(state, nullptr);
+	}
+
+	void BenchmarkGltfImportThreadPool(MicroBenchmarkState& state)
+	{
+		ThreadPool threadPool((uint_fast16_t)std::max(ThreadPool::GetHardwareThreads() - 1, 1u));
+		RunGltfImportBenchmark(state, &threadPool);
+	}
+
+	void BenchmarkUpdateRigidSceneObjects(MicroBenchmarkState& state)
+	{
+		SceneFixture* fixture = GetSceneFixture((uint32_t)state.GetArgument(), true, 4, 1);
+
+		//Every object moves every frame, the worst case for the update merging
+		uint64_t frameNumber = 1;
+		while(state.KeepRunning())
+		{
+			state.PauseTiming();
+
+			float frameOffset = (float)(frameNumber % 64) * 0.01f;
+			for(ObjectDataUpdateInfo& objectUpdate: fixture->RigidObjectUpdates)
+			{
+				objectUpdate.NewObjectLocation.Position.x += frameOffset;
+			}
+
+			state.ResumeTiming();
+
+			fixture->RenderableScene->UpdateRigidSceneObjects(fixture->RigidObjectUpdates, frameNumber);
+			frameNumber++;
+		}
+
+		state.SetItemsProcessed(state.GetIterationCount() * fixture->RigidObjectUpdates.size());
+	}
+
+	//Same updates as in BenchmarkUpdateRigidSceneObjects(), kept as separate arrays like an animation system would
+	void RunUpdateRigidSceneObjectBatchBenchmark(MicroBenchmarkState& state, ThreadPool* threadPool)
+	{
+		SceneFixture* fixture = GetSceneFixture((uint32_t)state.GetArgument(), true, 4, 1);
+
+		size_t updateCount = fixture->RigidObjectUpdates.size();
+
+		std::vector<RenderableSceneObjectHandle> objectIds(updateCount);
+		std::vector<DirectX::XMFLOAT3>           positions(updateCount);
+		std::vector<DirectX::XMFLOAT4>           rotations(updateCount);
+		std::vector<float>                       scales(updateCount);
+		for(size_t updateIndex = 0; updateIndex < updateCount; updateIndex++)
+		{
+			const ObjectDataUpdateInfo& objectUpdate = fixture->RigidObjectUpdates[updateIndex];
+
+			objectIds[updateIndex] = objectUpdate.ObjectId;
+			positions[updateIndex] = objectUpdate.NewObjectLocation.Position;
+			rotations[updateIndex] = objectUpdate.NewObjectLocation.RotationQuaternion;
+			scales[updateIndex]    = objectUpdate.NewObjectLocation.Scale;
+		}
+
+		ObjectDataUpdateBatch updateBatch =
+		{
+			.ObjectIds           = objectIds,
+			.Positions           = positions,
+			.RotationQuaternions = rotations,
+			.Scales              = scales
+		};
+
+		uint64_t frameNumber = 1;
+		while(state.KeepRunning())
+		{
+			state.PauseTiming();
+
+			float frameOffset = (float)(frameNumber % 64) * 0.01f;
+			for(DirectX::XMFLOAT3& position: positions)
+			{
+				position.x += frameOffset;
+			}
+
+			state.ResumeTiming();
+
+			//Same as Scene does it: the batch is applied by the per-frame call
+			fixture->RenderableScene->UpdateRigidSceneObjectBatch(updateBatch, threadPool);
+			fixture->RenderableScene->UpdateRigidSceneObjects({}, frameNumber);
+			frameNumber++;
+		}
+
+		state.SetItemsProcessed(state.GetIterationCount() * updateCount);
+	}
+
+	void BenchmarkUpdateRigidSceneObjectBatch(MicroBenchmarkState& state)
+	{
+		RunUpdateRigidSceneObjectBatchBenchmark(state, nullptr);
+	}
+
+	void BenchmarkUpdateRigidSceneObjectBatchThreadPool(MicroBenchmarkState& state)
+	{
+		ThreadPool threadPool((uint_fast16_t)std::max(ThreadPool::GetHardwareThreads() - 1, 1u));
+		RunUpdateRigidSceneObjectBatchBenchmark(state, &threadPool);
+	}
+
+	//The camera moves back and forth a bit every frame, like it does when the player walks around.
+	//Every object has its own geometry of 128 triangles, so every object gets its own level of detail
+	void BenchmarkSelectMeshLods(MicroBenchmarkState& state)
+	{
+		uint32_t objectCount = (uint32_t)state.GetArgument();
+		SceneFixture* fixture = GetSceneFixture(objectCount, false, objectCount, 8);
+
+		fixture->RenderableScene->UpdateFrameData(CreateBenchmarkFrameData(0.0f), 0);
+		fixture->RenderableScene->CullMeshes(nullptr);
+
+		uint64_t frameNumber = 1;
+		while(state.KeepRunning())
+		{
+			state.PauseTiming();
+			fixture->RenderableScene->UpdateFrameData(CreateBenchmarkFrameData((float)(frameNumber % 16) * 0.25f), frameNumber);
+			state.ResumeTiming();
+
+			fixture->RenderableScene->SelectLods();
+			frameNumber++;
+		}
+
+		double selectedTriangleCount = (double)fixture->RenderableScene->CountVisibleTriangles(false);
+		double finestTriangleCount   = (double)fixture->RenderableScene->CountVisibleTriangles(true);
+
+		state.SetCounter("VisibleMeshCount",         (double)fixture->RenderableScene->GetVisibleMeshCount());
+		state.SetCounter("TriangleReductionPercent", 100.0 * (1.0 - selectedTriangleCount / std::max(finestTriangleCount, 1.0)));
+		state.SetItemsProcessed(state.GetIterationCount() * fixture->RenderableScene->GetVisibleMeshCount());
+	}
+
+	//The camera is at the argument along Z. The 100000 objects span 0 to 100 along Z, the further the camera goes the less of them are in the frustum.
+	//The first call picks the mesh trees or the flat culler for the next ones
+	void BenchmarkCullMeshes(MicroBenchmarkState& state)
+	{
+		SceneFixture* fixture = GetSceneFixture(100000, false, 100000, 8);
+
+		fixture->RenderableScene->UpdateFrameData(CreateBenchmarkFrameData((float)state.GetArgument()), 0);
+		fixture->RenderableScene->CullMeshes(nullptr);
+		while(state.KeepRunning())
+		{
+			fixture->RenderableScene->CullMeshes(nullptr);
+		}
+
+		state.SetCounter("VisibleMeshCount", (double)fixture->RenderableScene->GetVisibleMeshCount());
+		state.SetItemsProcessed(state.GetIterationCount() * fixture->RenderableScene->GetMeshCount());
+	}
+
+	//The whole scene is far in front of the camera, so most of the static meshes are drawn with the proxies of their clusters
+	void BenchmarkCullMeshesHlod(MicroBenchmarkState& state)
+	{
+		uint32_t objectCount = (uint32_t)state.GetArgument();
+		SceneFixture* fixture = GetSceneFixture(objectCount, false, objectCount, 8);
+
+		fixture->RenderableScene->UpdateFrameData(CreateBenchmarkFrameData(-600.0f), 0);
+		while(state.KeepRunning())
+		{
+			fixture->RenderableScene->CullMeshes(nullptr);
+		}
+
+		state.SetCounter("DrawCount",            (double)fixture->RenderableScene->CountDraws(false));
+		state.SetCounter("DrawCountWithoutHlod", (double)fixture->RenderableScene->CountDraws(true));
+		state.SetItemsProcessed(state.GetIterationCount() * objectCount);
+	}
+
+	//Every frame removes the objects added a few frames ago and adds as many new ones on top of a scene of 10000 rigid objects, including the upload and the culling.
+	//The argument is the number of objects added per frame, 0 measures the frame without them
+	void BenchmarkAddRemoveObjects(MicroBenchmarkState& state)
+	{
+		constexpr uint32_t objectLifetimeFrameCount = 8;
+
+		uint32_t      addedObjectsPerFrame = (uint32_t)state.GetArgument();
+		SceneFixture* fixture              = GetSceneFixture(10000, true, 4, 1);
+
+		//The removed objects hold their slots for InFlightFrameCount more frames. The fixture description is shared with the other benchmarks, don't leave the slots there
+		RenderableSceneDescription& renderableDescription = fixture->Description.GetRenderableComponent();
+		renderableDescription.ReserveDynamicObjects(addedObjectsPerFrame * (objectLifetimeFrameCount + Utils::InFlightFrameCount + 1));
+
+		std::unique_ptr<MockRenderableScene>                              renderableScene = std::make_unique<MockRenderableScene>();
+		std::vector<std::byte>                                            uploadMemory;
+		std::unordered_map<std::string_view, RenderableSceneObjectHandle> objectHandles;
+
+		MockRenderableSceneBuilder sceneBuilder(renderableScene.get(), &uploadMemory);
+		sceneBuilder.Build(renderableDescription, fixture->InitialLocations, objectHandles);
+		renderableDescription.ReserveDynamicObjects(0);
+
+		renderableScene->UpdateFrameData(CreateBenchmarkFrameData(-150.0f), 0);
+
+		//The objects of each frame take their own part of the ring
+		std::vector<RenderableSceneObjectHandle> liveObjectHandles((size_t)addedObjectsPerFrame * objectLifetimeFrameCount, InvalidRenderableObjectHandle);
+		RenderableSceneObjectHandle              prototypeObjectHandle = fixture->RigidObjectUpdates.front().ObjectId;
+
+		uint32_t failedAddCount   = 0;
+		uint32_t addedObjectCount = 0;
+		uint64_t frameNumber      = 1;
+		while(state.KeepRunning())
+		{
+			size_t ringOffset = (size_t)(frameNumber % objectLifetimeFrameCount) * addedObjectsPerFrame;
+			for(uint32_t objectIndex = 0; objectIndex < addedObjectsPerFrame; objectIndex++)
+			{
+				RenderableSceneObjectHandle& objectHandle = liveObjectHandles[ringOffset + objectIndex];
+				if(objectHandle != InvalidRenderableObjectHandle)
+				{
+					renderableScene->RemoveObject(objectHandle);
+				}
+
+				objectHandle = renderableScene->AddObject(prototypeObjectHandle, MakeObjectLocation(addedObjectCount++));
+				if(objectHandle == InvalidRenderableObjectHandle)
+				{
+					failedAddCount++;
+				}
+			}
+
+			renderableScene->UpdateRigidSceneObjects({}, frameNumber);
+			renderableScene->CullMeshes(nullptr);
+			frameNumber++;
+		}
+
+		state.SetCounter("FailedAddCount",   (double)failedAddCount);
+		state.SetCounter("VisibleMeshCount", (double)renderableScene->GetVisibleMeshCount());
+		state.SetItemsProcessed(state.GetIterationCount() * addedObjectsPerFrame);
+	}
+
+	void BenchmarkPackObjectData(MicroBenchmarkState& state)
+	{
+		const uint32_t locationCount = 4096;
+
+		MockRenderableScene renderableScene;
+
+		std::vector<SceneObjectLocation> locations(locationCount);
+		for(uint32_t locationIndex = 0; locationIndex < locationCount; locationIndex++)
+		{
+			locations[locationIndex] = MakeObjectLocation(locationIndex);
+		}
+
+		std::vector<DirectX::XMFLOAT4X4> worldMatrices(locationCount);
+		while(state.KeepRunning())
+		{
+			for(uint32_t locationIndex = 0; locationIndex < locationCount; locationIndex++)
+			{
+				renderableScene.PackObjectDataTo(locations[locationIndex], &worldMatrices[locationIndex]);
+			}
+
+			MicroBenchmarkState::DoNotOptimize(worldMatrices.back());
+		}
+
+		state.SetItemsProcessed(state.GetIterationCount() * locationCount);
+	}
+
+	void BenchmarkQuaternionBetweenTwoVectors(MicroBenchmarkState& state)
+	{
+		const uint32_t vectorCount = 4096;
+
+		std::vector<DirectX::XMFLOAT3> vectors(vectorCount + 1);
+		for(uint32_t vectorIndex = 0; vectorIndex < vectorCount + 1; vectorIndex++)
+		{
+			SceneObjectLocation location  = MakeObjectLocation(vectorIndex);
+			DirectX::XMVECTOR   direction = DirectX::XMLoadFloat3(&location.Position);
+			DirectX::XMStoreFloat3(&vectors[vectorIndex], DirectX::XMVector3Normalize(DirectX::XMVectorAdd(direction, DirectX::XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f))));
+		}
+
+		std::vector<DirectX::XMFLOAT4> quaternions(vectorCount);
+		while(state.KeepRunning())
+		{
+			for(uint32_t vectorIndex = 0; vectorIndex < vectorCount; vectorIndex++)
+			{
+				DirectX::XMVECTOR a = DirectX::XMLoadFloat3(&vectors[vectorIndex + 0]);
+				DirectX::XMVECTOR b = DirectX::XMLoadFloat3(&vectors[vectorIndex + 1]);
+				DirectX::XMStoreFloat4(&quaternions[vectorIndex], Utils::QuaternionBetweenTwoVectorsNormalized(a, b));
+			}
+
+			MicroBenchmarkState::DoNotOptimize(quaternions.back());
+		}
+
+		state.SetItemsProcessed(state.GetIterationCount() * vectorCount);
+	}
+
+	//The scene object layout before SceneObjectStore, kept as the baseline for the transform update benchmarks
+	struct ArrayOfStructsSceneObject
+	{
+		uint64_t                    Id;
+		SceneObjectLocation         Location;
+		RenderableSceneObjectHandle RenderableHandle;
+	};
+
+	//The same translation and rotation applied to every object
+	void BenchmarkUpdateTransformsArrayOfStructs(MicroBenchmarkState& state)
+	{
+		uint32_t objectCount = (uint32_t)state.GetArgument();
+
+		std::vector<ArrayOfStructsSceneObject> sceneObjects(objectCount);
+		for(uint32_t objectIndex = 0; objectIndex < objectCount; objectIndex++)
+		{
+			sceneObjects[objectIndex] = ArrayOfStructsSceneObject
+			{
+				.Id               = objectIndex,
+				.Location         = MakeObjectLocation(objectIndex),
+				.RenderableHandle = objectIndex
+			};
+		}
+
+		DirectX::XMVECTOR translation   = DirectX::XMVectorSet(0.01f, 0.0f, -0.01f, 0.0f);
+		DirectX::XMVECTOR deltaRotation = DirectX::XMQuaternionRotationRollPitchYaw(0.0f, 0.001f, 0.0f);
+		while(state.KeepRunning())
+		{
+			for(ArrayOfStructsSceneObject& sceneObject: sceneObjects)
+			{
+				DirectX::XMVECTOR position = DirectX::XMLoadFloat3(&sceneObject.Location.Position);
+				DirectX::XMVECTOR rotation = DirectX::XMLoadFloat4(&sceneObject.Location.RotationQuaternion);
+
+				DirectX::XMStoreFloat3(&sceneObject.Location.Position,           DirectX::XMVectorAdd(position, translation));
+				DirectX::XMStoreFloat4(&sceneObject.Location.RotationQuaternion, DirectX::XMQuaternionMultiply(rotation, deltaRotation));
+			}
+
+			MicroBenchmarkState::DoNotOptimize(sceneObjects.back());
+		}
+
+		state.SetItemsProcessed(state.GetIterationCount() * objectCount);
+	}
+
+	void BenchmarkUpdateTransformsStore(MicroBenchmarkState& state)
+	{
+		uint32_t objectCount = (uint32_t)state.GetArgument();
+
+		const uint32_t componentMask = (uint32_t)SceneObjectComponentFlags::Renderable;
+
+		SceneObjectStore sceneObjects;
+		sceneObjects.Reserve(componentMask, objectCount);
+		for(uint32_t objectIndex = 0; objectIndex < objectCount; objectIndex++)
+		{
+			sceneObjects.CreateObject(componentMask, MakeObjectLocation(objectIndex), objectIndex);
+		}
+
+		DirectX::XMVECTOR translation   = DirectX::XMVectorSet(0.01f, 0.0f, -0.01f, 0.0f);
+		DirectX::XMVECTOR deltaRotation = DirectX::XMQuaternionRotationRollPitchYaw(0.0f, 0.001f, 0.0f);
+		while(state.KeepRunning())
+		{
+			for(uint32_t archetypeIndex = 0; archetypeIndex < sceneObjects.GetArchetypeCount(); archetypeIndex++)
+			{
+				SceneObjectArchetype& archetype = sceneObjects.GetArchetype(archetypeIndex);
+				for(DirectX::XMFLOAT3& position: archetype.Positions)
+				{
+					DirectX::XMStoreFloat3(&position, DirectX::XMVectorAdd(DirectX::XMLoadFloat3(&position), translation));
+				}
+
+				for(DirectX::XMFLOAT4& rotation: archetype.Rotations)
+				{
+					DirectX::XMStoreFloat4(&rotation, DirectX::XMQuaternionMultiply(DirectX::XMLoadFloat4(&rotation), deltaRotation));
+				}
+			}
+
+			MicroBenchmarkState::DoNotOptimize(sceneObjects.GetArchetype(0).Positions.back());
+		}
+
+		state.SetItemsProcessed(state.GetIterationCount() * objectCount);
+	}
+
+	void BenchmarkBuildScene(MicroBenchmarkState& state)
+	{
+		SceneFixture* fixture = GetSceneFixture((uint32_t)state.GetArgument(), false, 4, 1);
+
+		while(state.KeepRunning())
+		{
+			state.PauseTiming();
+			std::unique_ptr<Scene> scene = std::make_unique<Scene>(nullptr);
+			state.ResumeTiming();
+
+			fixture->Description.BuildScene(scene.get(), fixture->RenderableScene.get(), fixture->ObjectHandles);
+
+			state.PauseTiming();
+			scene.reset();
+			state.ResumeTiming();
+		}
+
+		state.SetItemsProcessed(state.GetIterationCount() * fixture->ObjectCount);
+	}
+
+	//Moves a free object and a hierarchy parent before the first simulation step of each frame, then runs several steps before the frame's UpdateScene().
+	//The later steps see no movement, the moves of the first step should still reach the renderable scene
+	void BenchmarkSimulateStepsPerFrame(MicroBenchmarkState& state)
+	{
+		uint32_t stepsPerFrame = (uint32_t)state.GetArgument();
+
+		SceneDescription sceneDescription;
+		RenderableSceneDescription& renderableDescription = sceneDescription.GetRenderableComponent();
+		renderableDescription.AddMaterial("BenchmarkMaterial", RenderableSceneMaterialData
+		{
+			.TextureFilename   = L"",
+			.NormalMapFilename = L""
+		});
+
+		RenderableSceneGeometryData geometry;
+		geometry.Vertices =
+		{
+			RenderableSceneVertex{.Position = DirectX::XMFLOAT3(-1.0f, -1.0f, 0.0f), .Normal = DirectX::XMFLOAT3(0.0f, 0.0f, -1.0f), .Texcoord = DirectX::XMFLOAT2(0.0f, 1.0f)},
+			RenderableSceneVertex{.Position = DirectX::XMFLOAT3( 0.0f,  1.0f, 0.0f), .Normal = DirectX::XMFLOAT3(0.0f, 0.0f, -1.0f), .Texcoord = DirectX::XMFLOAT2(0.5f, 0.0f)},
+			RenderableSceneVertex{.Position = DirectX::XMFLOAT3( 1.0f, -1.0f, 0.0f), .Normal = DirectX::XMFLOAT3(0.0f, 0.0f, -1.0f), .Texcoord = DirectX::XMFLOAT2(1.0f, 1.0f)}
+		};
+
+		geometry.Indices = {0, 1, 2};
+		renderableDescription.AddGeometry("BenchmarkGeometry", std::move(geometry));
+
+		//The free object, the parent and the child attached to the parent
+		const std::array<std::string, 3> meshNames = {"FreeMesh", "ParentMesh", "ChildMesh"};
+
+		std::array<uint32_t, 3> descriptionObjectIndices;
+		for(uint32_t objectIndex = 0; objectIndex < (uint32_t)meshNames.size(); objectIndex++)
+		{
+			renderableDescription.AddMesh(meshNames[objectIndex]);
+			renderableDescription.AddSubmesh(meshNames[objectIndex], RenderableSceneSubmeshData
+			{
+				.GeometryName = "BenchmarkGeometry",
+				.MaterialName = "BenchmarkMaterial"
+			});
+
+			renderableDescription.MarkMeshAsNonStatic(meshNames[objectIndex]);
+
+			SceneDescriptionObject& sceneObject = sceneDescription.CreateEmptySceneObject();
+			sceneObject.SetLocation(MakeObjectLocation(objectIndex));
+			sceneObject.SetMeshComponentName(meshNames[objectIndex]);
+			if(objectIndex == 2)
+			{
+				sceneObject.SetParentIndex(descriptionObjectIndices[1]);
+			}
+
+			descriptionObjectIndices[objectIndex] = sceneDescription.GetSceneObjectIndex(sceneObject);
+		}
+
+		std::unordered_map<std::string_view, SceneObjectLocation> initialLocations;
+		sceneDescription.GetRenderableObjectLocations(initialLocations);
+
+		MockRenderableScene                                               renderableScene;
+		std::vector<std::byte>                                            uploadMemory;
+		std::unordered_map<std::string_view, RenderableSceneObjectHandle> objectHandles;
+
+		MockRenderableSceneBuilder sceneBuilder(&renderableScene, &uploadMemory);
+		sceneBuilder.Build(renderableDescription, initialLocations, objectHandles);
+
+		Scene scene(nullptr);
+
+		std::vector<SceneObjectId> sceneObjectIds;
+		sceneDescription.BuildScene(&scene, &renderableScene, objectHandles, &sceneObjectIds);
+
+		Inputter inputter(nullptr);
+
+		uint64_t frameNumber      = 0;
+		uint32_t lostUpdateCount  = 0;
+		uint32_t wrongUpdateCount = 0;
+		while(state.KeepRunning())
+		{
+			frameNumber++;
+
+			//A new location on each frame
+			SceneObjectLocation freeLocation = MakeObjectLocation(0);
+			freeLocation.Position.x += (float)(frameNumber % 1024);
+
+			SceneObjectLocation parentLocation = MakeObjectLocation(1);
+			parentLocation.Position.y += (float)(frameNumber % 1024);
+
+			scene.SetObjectLocalLocation(sceneObjectIds[descriptionObjectIndices[0]], freeLocation);
+			scene.SetObjectLocalLocation(sceneObjectIds[descriptionObjectIndices[1]], parentLocation);
+
+			for(uint32_t stepIndex = 0; stepIndex < stepsPerFrame; stepIndex++)
+			{
+				scene.SimulateStep(&inputter, 1.0f / 60.0f);
+			}
+
+			scene.UpdateScene(frameNumber, 1.0f);
+
+			state.PauseTiming();
+			std::span<const ObjectDataUpdateInfo> renderableUpdates = scene.GetLastRenderableUpdates();
+			for(const std::string& meshName: meshNames)
+			{
+				RenderableSceneObjectHandle objectHandle = objectHandles.at(meshName);
+
+				auto updateIt = std::find_if(renderableUpdates.begin(), renderableUpdates.end(), [objectHandle](const ObjectDataUpdateInfo& updateInfo)
+				{
+					return updateInfo.ObjectId == objectHandle;
+				});
+
+				if(updateIt == renderableUpdates.end())
+				{
+					lostUpdateCount++;
+				}
+				else if(meshName == meshNames[0] && updateIt->NewObjectLocation.Position.x != freeLocation.Position.x)
+				{
+					wrongUpdateCount++;
+				}
+			}
+			state.ResumeTiming();
+		}
+
+		state.SetCounter("LostUpdates",  (double)lostUpdateCount);
+		state.SetCounter("WrongUpdates", (double)wrongUpdateCount);
+		if(lostUpdateCount != 0 || wrongUpdateCount != 0)
+		{
+			state.SetError("The objects moved in the first step of the frame didn't reach the renderable scene");
+		}
+	}
+
+	//Fills the scene description the same way as the scene fixture: one mesh for each object, over 4 geometries, every second object rigid
+	void BenchmarkSceneDescriptionIngest(MicroBenchmarkState& state)
+	{
+		uint32_t objectCount = (uint32_t)state.GetArgument();
+
+		std::vector<SceneObjectLocation> objectLocations(objectCount);
+		for(uint32_t objectIndex = 0; objectIndex < objectCount; objectIndex++)
+		{
+			objectLocations[objectIndex] = MakeObjectLocation(objectIndex);
+		}
+
+		while(state.KeepRunning())
+		{
+			state.PauseTiming();
+			std::unique_ptr<SceneDescription> sceneDescription = std::make_unique<SceneDescription>();
+			state.ResumeTiming();
+
+			RenderableSceneDescription& renderableDescription = sceneDescription->GetRenderableComponent();
+			renderableDescription.ReserveMeshes(objectCount);
+			sceneDescription->ReserveSceneObjects(objectCount);
+
+			for(uint32_t objectIndex = 0; objectIndex < objectCount; objectIndex++)
+			{
+				std::string meshName = "BenchmarkMesh" + std::to_string(objectIndex);
+				renderableDescription.AddMesh(meshName);
+				renderableDescription.AddSubmesh(meshName, RenderableSceneSubmeshData
+				{
+					.GeometryName = "BenchmarkGeometry" + std::to_string(objectIndex % 4),
+					.MaterialName = "BenchmarkMaterial"
+				});
+
+				if(objectIndex % 2 == 1)
+				{
+					renderableDescription.MarkMeshAsNonStatic(meshName);
+				}
+
+				SceneDescriptionObject& sceneObject = sceneDescription->CreateEmptySceneObject();
+				sceneObject.SetLocation(objectLocations[objectIndex]);
+				sceneObject.SetMeshComponentName(meshName);
+			}
+
+			state.PauseTiming();
+			sceneDescription.reset();
+			state.ResumeTiming();
+		}
+
+		state.SetItemsProcessed(state.GetIterationCount() * objectCount);
+	}
+
+	//Same objects, but IngestedInstancesPerMesh of them share each mesh and are added with one call.
+	//The per-object work is copying the location, so the time is compared to a plain copy of the locations
+	void BenchmarkSceneDescriptionIngestInstanced(MicroBenchmarkState& state)
+	{
+		const uint32_t IngestedInstancesPerMesh = 1024;
+
+		uint32_t objectCount = (uint32_t)state.GetArgument();
+		uint32_t meshCount   = (objectCount + IngestedInstancesPerMesh - 1) / IngestedInstancesPerMesh;
+
+		std::vector<SceneObjectLocation> objectLocations(objectCount);
+		for(uint32_t objectIndex = 0; objectIndex < objectCount; objectIndex++)
+		{
+			objectLocations[objectIndex] = MakeObjectLocation(objectIndex);
+		}
+
+		while(state.KeepRunning())
+		{
+			state.PauseTiming();
+			std::unique_ptr<SceneDescription> sceneDescription = std::make_unique<SceneDescription>();
+			state.ResumeTiming();
+
+			RenderableSceneDescription& renderableDescription = sceneDescription->GetRenderableComponent();
+			renderableDescription.ReserveMeshes(meshCount);
+			sceneDescription->ReserveMeshInstanceObjects(objectCount);
+
+			for(uint32_t meshIndex = 0; meshIndex < meshCount; meshIndex++)
+			{
+				std::string meshName = "BenchmarkMesh" + std::to_string(meshIndex);
+				renderableDescription.AddMesh(meshName);
+				renderableDescription.AddSubmesh(meshName, RenderableSceneSubmeshData
+				{
+					.GeometryName = "BenchmarkGeometry" + std::to_string(meshIndex % 4),
+					.MaterialName = "BenchmarkMaterial"
+				});
+
+				if(meshIndex % 2 == 1)
+				{
+					renderableDescription.MarkMeshAsNonStatic(meshName);
+				}
+
+				uint32_t firstObjectIndex = meshIndex * IngestedInstancesPerMesh;
+				uint32_t meshObjectCount  = std::min(IngestedInstancesPerMesh, objectCount - firstObjectIndex);
+				sceneDescription->CreateMeshInstanceObjects(meshName, std::span(objectLocations).subspan(firstObjectIndex, meshObjectCount));
+			}
+
+			state.PauseTiming();
+			sceneDescription.reset();
+			state.ResumeTiming();
+		}
+
+		state.SetItemsProcessed(state.GetIterationCount() * objectCount);
+
+		auto copyStartTime = std::chrono::steady_clock::now();
+		std::vector<SceneObjectLocation> copiedLocations(objectLocations.begin(), objectLocations.end());
+		auto copyEndTime = std::chrono::steady_clock::now();
+		MicroBenchmarkState::DoNotOptimize(copiedLocations.data());
+
+		state.SetCounter("PlainCopyMs", std::chrono::duration<double, std::milli>(copyEndTime - copyStartTime).count());
+	}
+
+	//The camera looks along +Z from the origin, the spheres are spread in front of it and to the sides
+	void RunFrustumCullBenchmark(MicroBenchmarkState& state, ThreadPool* threadPool)
+	{
+		uint32_t sphereCount = (uint32_t)state.GetArgument();
+
+		FrustumCuller frustumCuller;
+		frustumCuller.Resize(sphereCount);
+		for(uint32_t sphereIndex = 0; sphereIndex < sphereCount; sphereIndex++)
+		{
+			SceneObjectLocation location = MakeObjectLocation(sphereIndex);
+			frustumCuller.SetBoundingSphere(sphereIndex, DirectX::BoundingSphere(location.Position, location.Scale));
+		}
+
+		DirectX::XMMATRIX viewMatrix     = DirectX::XMMatrixLookToLH(DirectX::XMVectorZero(), DirectX::XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f), DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+		DirectX::XMMATRIX projMatrix     = DirectX::XMMatrixPerspectiveFovLH(DirectX::XM_PIDIV2, 16.0f / 9.0f, 0.01f, 100.0f);
+		DirectX::XMMATRIX viewProjMatrix = DirectX::XMMatrixMultiply(viewMatrix, projMatrix);
+
+		while(state.KeepRunning())
+		{
+			frustumCuller.Cull(threadPool, viewProjMatrix);
+			MicroBenchmarkState::DoNotOptimize(frustumCuller.GetVisibleIndices().size());
+		}
+
+		double visibleCount = (double)frustumCuller.GetVisibleIndices().size();
+		state.SetCounter("CulledPercent", 100.0 * (1.0 - visibleCount / (double)sphereCount));
+		state.SetItemsProcessed(state.GetIterationCount() * sphereCount);
+	}
+
+	void BenchmarkFrustumCull(MicroBenchmarkState& state)
+	{
+		RunFrustumCullBenchmark(state, nullptr);
+	}
+
+	void BenchmarkFrustumCullThreadPool(MicroBenchmarkState& state)
+	{
+		ThreadPool threadPool((uint_fast16_t)std::max(ThreadPool::GetHardwareThreads() - 1, 1u));
+		RunFrustumCullBenchmark(state, &threadPool);
+	}
+
+	//Same distribution as the frustum culling spheres
+	std::vector<DirectX::BoundingBox> CreateBenchmarkItemBounds(uint32_t itemCount)
+	{
+		std::vector<DirectX::BoundingBox> itemBounds(itemCount);
+		for(uint32_t itemIndex = 0; itemIndex < itemCount; itemIndex++)
+		{
+			SceneObjectLocation location = MakeObjectLocation(itemIndex);
+			DirectX::BoundingBox::CreateFromSphere(itemBounds[itemIndex], DirectX::BoundingSphere(location.Position, location.Scale));
+		}
+
+		return itemBounds;
+	}
+
+	void RunBoundingVolumeHierarchyBuildBenchmark(MicroBenchmarkState& state, ThreadPool* threadPool)
+	{
+		std::vector<DirectX::BoundingBox> itemBounds = CreateBenchmarkItemBounds((uint32_t)state.GetArgument());
+
+		BoundingVolumeHierarchy hierarchy;
+		while(state.KeepRunning())
+		{
+			hierarchy.Build(itemBounds, threadPool);
+			MicroBenchmarkState::DoNotOptimize(hierarchy.GetNodeCount());
+		}
+
+		state.SetCounter("NodeCount", (double)hierarchy.GetNodeCount());
+		state.SetItemsProcessed(state.GetIterationCount() * itemBounds.size());
+	}
+
+	void BenchmarkBoundingVolumeHierarchyBuild(MicroBenchmarkState& state)
+	{
+		RunBoundingVolumeHierarchyBuildBenchmark(state, nullptr);
+	}
+
+	void BenchmarkBoundingVolumeHierarchyBuildThreadPool(MicroBenchmarkState& state)
+	{
+		ThreadPool threadPool((uint_fast16_t)std::max(ThreadPool::GetHardwareThreads() - 1, 1u));
+		RunBoundingVolumeHierarchyBuildBenchmark(state, &threadPool);
+	}
+
+	//Every iteration moves 1% of the items a bit further along X, like the rigid objects do each frame. A full Build() is the brute force alternative
+	void BenchmarkBoundingVolumeHierarchyRefit(MicroBenchmarkState& state)
+	{
+		std::vector<DirectX::BoundingBox> itemBounds = CreateBenchmarkItemBounds((uint32_t)state.GetArgument());
+		uint32_t movedItemCount = std::max((uint32_t)itemBounds.size() / 100, 1u);
+
+		BoundingVolumeHierarchy hierarchy;
+		hierarchy.Build(itemBounds, nullptr);
+
+		uint32_t movedItemStart = 0;
+		while(state.KeepRunning())
+		{
+			for(uint32_t movedItemIndex = 0; movedItemIndex < movedItemCount; movedItemIndex++)
+			{
+				uint32_t itemIndex = (movedItemStart + movedItemIndex * 97) % (uint32_t)itemBounds.size();
+
+				itemBounds[itemIndex].Center.x += 0.1f;
+				hierarchy.UpdateItemBounds(itemIndex, itemBounds[itemIndex]);
+			}
+
+			hierarchy.Refit();
+			movedItemStart++;
+		}
+
+		state.SetCounter("QualityDegradation", hierarchy.GetQualityDegradation());
+		state.SetItemsProcessed(state.GetIterationCount() * movedItemCount);
+	}
+
+	//Same camera as in the frustum culling benchmark, compare with FrustumCuller::Cull
+	void RunBoundingVolumeHierarchyQueryFrustumBenchmark(MicroBenchmarkState& state, ThreadPool* threadPool)
+	{
+		std::vector<DirectX::BoundingBox> itemBounds = CreateBenchmarkItemBounds((uint32_t)state.GetArgument());
+
+		BoundingVolumeHierarchy hierarchy;
+		hierarchy.Build(itemBounds, nullptr);
+
+		DirectX::XMMATRIX viewMatrix = DirectX::XMMatrixLookToLH(DirectX::XMVectorZero(), DirectX::XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f), DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+		DirectX::XMMATRIX projMatrix = DirectX::XMMatrixPerspectiveFovLH(DirectX::XM_PIDIV2, 16.0f / 9.0f, 0.01f, 100.0f);
+
+		std::array<DirectX::XMFLOAT4, FrustumCuller::FrustumPlaneCount> frustumPlanes;
+		FrustumCuller::ExtractFrustumPlanes(DirectX::XMMatrixMultiply(viewMatrix, projMatrix), frustumPlanes);
+
+		std::vector<uint32_t> visibleItems;
+		while(state.KeepRunning())
+		{
+			visibleItems.clear();
+			hierarchy.QueryFrustum(frustumPlanes, visibleItems, threadPool);
+			MicroBenchmarkState::DoNotOptimize(visibleItems.size());
+		}
+
+		state.SetCounter("CulledPercent", 100.0 * (1.0 - (double)visibleItems.size() / (double)itemBounds.size()));
+		state.SetItemsProcessed(state.GetIterationCount() * itemBounds.size());
+	}
+
+	void BenchmarkBoundingVolumeHierarchyQueryFrustum(MicroBenchmarkState& state)
+	{
+		RunBoundingVolumeHierarchyQueryFrustumBenchmark(state, nullptr);
+	}
+
+	void BenchmarkBoundingVolumeHierarchyQueryFrustumThreadPool(MicroBenchmarkState& state)
+	{
+		ThreadPool threadPool((uint_fast16_t)std::max(ThreadPool::GetHardwareThreads() - 1, 1u));
+		RunBoundingVolumeHierarchyQueryFrustumBenchmark(state, &threadPool);
+	}
+
+	//Small spheres around the item centers, as for the proximity queries of gameplay code
+	void RunSphereQueryBenchmark(MicroBenchmarkState& state, bool useHierarchy)
+	{
+		std::vector<DirectX::BoundingBox> itemBounds = CreateBenchmarkItemBounds((uint32_t)state.GetArgument());
+
+		BoundingVolumeHierarchy hierarchy;
+		hierarchy.Build(itemBounds, nullptr);
+
+		std::vector<uint32_t> foundItems;
+		uint32_t queryIndex = 0;
+		while(state.KeepRunning())
+		{
+			DirectX::BoundingSphere querySphere(itemBounds[(queryIndex * 7919) % itemBounds.size()].Center, 5.0f);
+
+			foundItems.clear();
+			if(useHierarchy)
+			{
+				hierarchy.QuerySphere(querySphere, foundItems);
+			}
+			else
+			{
+				for(uint32_t itemIndex = 0; itemIndex < (uint32_t)itemBounds.size(); itemIndex++)
+				{
+					if(itemBounds[itemIndex].Intersects(querySphere))
+					{
+						foundItems.push_back(itemIndex);
+					}
+				}
+			}
+
+			MicroBenchmarkState::DoNotOptimize(foundItems.size());
+			queryIndex++;
+		}
+
+		state.SetItemsProcessed(state.GetIterationCount());
+	}
+
+	void BenchmarkBoundingVolumeHierarchyQuerySphere(MicroBenchmarkState& state)
+	{
+		RunSphereQueryBenchmark(state, true);
+	}
+
+	void BenchmarkBruteForceQuerySphere(MicroBenchmarkState& state)
+	{
+		RunSphereQueryBenchmark(state, false);
+	}
+
+	//Rays from the origin in different directions, as for picking
+	void RunRayQueryBenchmark(MicroBenchmarkState& state, bool useHierarchy)
+	{
+		std::vector<DirectX::BoundingBox> itemBounds = CreateBenchmarkItemBounds((uint32_t)state.GetArgument());
+
+		BoundingVolumeHierarchy hierarchy;
+		hierarchy.Build(itemBounds, nullptr);
+
+		const float maxRayDistance = 200.0f;
+
+		std::vector<uint32_t> foundItems;
+		uint32_t queryIndex = 0;
+		while(state.KeepRunning())
+		{
+			DirectX::XMVECTOR rayOrigin    = DirectX::XMVectorZero();
+			DirectX::XMVECTOR rayDirection = DirectX::XMVector3Normalize(DirectX::XMLoadFloat3(&itemBounds[(queryIndex * 7919) % itemBounds.size()].Center));
+
+			foundItems.clear();
+			if(useHierarchy)
+			{
+				hierarchy.QueryRay(rayOrigin, rayDirection, maxRayDistance, foundItems);
+			}
+			else
+			{
+				for(uint32_t itemIndex = 0; itemIndex < (uint32_t)itemBounds.size(); itemIndex++)
+				{
+					float hitDistance = 0.0f;
+					if(itemBounds[itemIndex].Intersects(rayOrigin, rayDirection, hitDistance) && hitDistance <= maxRayDistance)
+					{
+						foundItems.push_back(itemIndex);
+					}
+				}
+			}
+
+			MicroBenchmarkState::DoNotOptimize(foundItems.size());
+			queryIndex++;
+		}
+
+		state.SetItemsProcessed(state.GetIterationCount());
+	}
+
+	void BenchmarkBoundingVolumeHierarchyQueryRay(MicroBenchmarkState& state)
+	{
+		RunRayQueryBenchmark(state, true);
+	}
+
+	void BenchmarkBruteForceQueryRay(MicroBenchmarkState& state)
+	{
+		RunRayQueryBenchmark(state, false);
+	}
+
+	//A wall of gridSize x gridSize quads at Z = 20, it covers the whole view of the frustum culling benchmark camera
+	void AddBenchmarkOccluderWall(OcclusionCuller& occlusionCuller, uint32_t gridSize)
+	{
+		const float wallHalfSize = 40.0f;
+		const float wallDepth    = 20.0f;
+
+		std::vector<RenderableSceneVertex> wallVertices;
+		for(uint32_t y = 0; y <= gridSize; y++)
+		{
+			for(uint32_t x = 0; x <= gridSize; x++)
+			{
+				float u = (float)x / (float)gridSize;
+				float v = (float)y / (float)gridSize;
+
+				wallVertices.push_back(RenderableSceneVertex
+				{
+					.Position = DirectX::XMFLOAT3(wallHalfSize * (2.0f * u - 1.0f), wallHalfSize * (2.0f * v - 1.0f), wallDepth),
+					.Normal   = DirectX::XMFLOAT3(0.0f, 0.0f, -1.0f),
+					.Texcoord = DirectX::XMFLOAT2(u, v)
+				});
+			}
+		}
+
+		std::vector<RenderableSceneIndex> wallIndices;
+		for(uint32_t y = 0; y < gridSize; y++)
+		{
+			for(uint32_t x = 0; x < gridSize; x++)
+			{
+				RenderableSceneIndex topLeftIndex = (RenderableSceneIndex)(y * (gridSize + 1) + x);
+				RenderableSceneIndex rowStride    = (RenderableSceneIndex)(gridSize + 1);
+
+				wallIndices.insert(wallIndices.end(), {topLeftIndex, (RenderableSceneIndex)(topLeftIndex + rowStride), (RenderableSceneIndex)(topLeftIndex + 1)});
+				wallIndices.insert(wallIndices.end(), {(RenderableSceneIndex)(topLeftIndex + 1), (RenderableSceneIndex)(topLeftIndex + rowStride), (RenderableSceneIndex)(topLeftIndex + rowStride + 1)});
+			}
+		}
+
+		occlusionCuller.AddOccluder(wallVertices, wallIndices, DirectX::XMMatrixIdentity());
+	}
+
+	DirectX::XMMATRIX CreateBenchmarkViewProjMatrix()
+	{
+		DirectX::XMMATRIX viewMatrix = DirectX::XMMatrixLookToLH(DirectX::XMVectorZero(), DirectX::XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f), DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+		DirectX::XMMATRIX projMatrix = DirectX::XMMatrixPerspectiveFovLH(DirectX::XM_PIDIV2, 16.0f / 9.0f, 0.01f, 100.0f);
+
+		return DirectX::XMMatrixMultiply(viewMatrix, projMatrix);
+	}
+
+	//The argument is the wall grid size, the triangle count is twice its square
+	void RunOcclusionRenderBenchmark(MicroBenchmarkState& state, ThreadPool* threadPool)
+	{
+		OcclusionCuller occlusionCuller;
+		AddBenchmarkOccluderWall(occlusionCuller, (uint32_t)state.GetArgument());
+
+		DirectX::XMMATRIX viewProjMatrix = CreateBenchmarkViewProjMatrix();
+		while(state.KeepRunning())
+		{
+			occlusionCuller.RenderOccluders(threadPool, viewProjMatrix);
+		}
+
+		state.SetItemsProcessed(state.GetIterationCount() * occlusionCuller.GetOccluderTriangleCount());
+	}
+
+	void BenchmarkOcclusionCullerRenderOccluders(MicroBenchmarkState& state)
+	{
+		RunOcclusionRenderBenchmark(state, nullptr);
+	}
+
+	void BenchmarkOcclusionCullerRenderOccludersThreadPool(MicroBenchmarkState& state)
+	{
+		ThreadPool threadPool((uint_fast16_t)std::max(ThreadPool::GetHardwareThreads() - 1, 1u));
+		RunOcclusionRenderBenchmark(state, &threadPool);
+	}
+
+	//The items that pass the frustum test are tested against the wall, as in BaseRenderableScene::CullMeshes
+	void BenchmarkOcclusionCullerIsBoxVisible(MicroBenchmarkState& state)
+	{
+		std::vector<DirectX::BoundingBox> itemBounds = CreateBenchmarkItemBounds((uint32_t)state.GetArgument());
+
+		BoundingVolumeHierarchy hierarchy;
+		hierarchy.Build(itemBounds, nullptr);
+
+		DirectX::XMMATRIX viewProjMatrix = CreateBenchmarkViewProjMatrix();
+
+		std::array<DirectX::XMFLOAT4, FrustumCuller::FrustumPlaneCount> frustumPlanes;
+		FrustumCuller::ExtractFrustumPlanes(viewProjMatrix, frustumPlanes);
+
+		std::vector<uint32_t> frustumItems;
+		hierarchy.QueryFrustum(frustumPlanes, frustumItems, nullptr);
+
+		OcclusionCuller occlusionCuller;
+		AddBenchmarkOccluderWall(occlusionCuller, 16);
+		occlusionCuller.RenderOccluders(nullptr, viewProjMatrix);
+
+		size_t visibleCount = 0;
+		while(state.KeepRunning())
+		{
+			visibleCount = 0;
+			for(uint32_t itemIndex: frustumItems)
+			{
+				visibleCount += occlusionCuller.IsBoxVisible(itemBounds[itemIndex]) ? 1 : 0;
+			}
+
+			MicroBenchmarkState::DoNotOptimize(visibleCount);
+		}
+
+		state.SetCounter("OccludedPercent", 100.0 * (1.0 - (double)visibleCount / (double)std::max(frustumItems.size(), (size_t)1)));
+		state.SetItemsProcessed(state.GetIterationCount() * frustumItems.size());
+	}
+}
+
+void RegisterEngineMicroBenchmarks(MicroBenchmarkSuite* suite)
+{
+	suite->Register("ModernFrameGraphBuilder::Build",                 BenchmarkFrameGraphBuild,                {1, 3, 16, 64});
+	suite->Register("BaseRenderableSceneBuilder::Build",              BenchmarkSceneBake,                      {1024, 16384});
+	suite->Register("BaseRenderableSceneBuilder::Rebake",             BenchmarkSceneRebake,                    {10000});
+	suite->Register("BaseRenderableSceneBuilder::LoadSceneCache",     BenchmarkSceneCacheLoad,                 {10000, 100000});
+	suite->Register("GltfSceneImporter::Import",                      BenchmarkGltfImport,                     {1000, 10000});
+	suite->Register("GltfSceneImporter::Import_ThreadPool",           BenchmarkGltfImportThreadPool,           {1000, 10000});
+	suite->Register("ModernRenderableScene::UpdateRigidSceneObjects", BenchmarkUpdateRigidSceneObjects,        {1000, 10000, 100000, 1000000});
+	suite->Register("ModernRenderableScene::UpdateRigidSceneObjectBatch",            BenchmarkUpdateRigidSceneObjectBatch,           {100000, 1000000});
+	suite->Register("ModernRenderableScene::UpdateRigidSceneObjectBatch_ThreadPool", BenchmarkUpdateRigidSceneObjectBatchThreadPool, {100000, 1000000});
+	suite->Register("BaseRenderableScene::PackObjectData",            BenchmarkPackObjectData);
+	suite->Register("BaseRenderableScene::AddRemoveObjects",          BenchmarkAddRemoveObjects,               {0, 100, 1000});
+	suite->Register("BaseRenderableScene::SelectMeshLods",            BenchmarkSelectMeshLods,                 {10000, 100000});
+	suite->Register("BaseRenderableScene::CullMeshes",                BenchmarkCullMeshes,                     {0, 60, 85});
+	suite->Register("BaseRenderableScene::CullMeshes_Hlod",           BenchmarkCullMeshesHlod,                 {10000, 100000});
+	suite->Register("Utils::QuaternionBetweenTwoVectorsNormalized",   BenchmarkQuaternionBetweenTwoVectors);
+	suite->Register("SceneDescription::BuildScene",                   BenchmarkBuildScene,                     {1024, 16384});
+	suite->Register("Scene::SimulateStepsPerFrame",                   BenchmarkSimulateStepsPerFrame,          {1, 2, 5});
+	suite->Register("SceneDescription::Ingest",                       BenchmarkSceneDescriptionIngest,          {1000000});
+	suite->Register("SceneDescription::IngestInstanced",              BenchmarkSceneDescriptionIngestInstanced, {1000000, 5000000});
+	suite->Register("ArrayOfStructsSceneObjects::UpdateTransforms",   BenchmarkUpdateTransformsArrayOfStructs, {1000000});
+	suite->Register("SceneObjectStore::UpdateTransforms",             BenchmarkUpdateTransformsStore,          {1000000});
+	suite->Register("FrustumCuller::Cull",                            BenchmarkFrustumCull,                    {100000, 1000000});
+	suite->Register("FrustumCuller::Cull_ThreadPool",                 BenchmarkFrustumCullThreadPool,          {100000, 1000000});
+	suite->Register("BoundingVolumeHierarchy::Build",                 BenchmarkBoundingVolumeHierarchyBuild,           {100000, 1000000});
+	suite->Register("BoundingVolumeHierarchy::Build_ThreadPool",      BenchmarkBoundingVolumeHierarchyBuildThreadPool, {100000, 1000000});
+	suite->Register("BoundingVolumeHierarchy::Refit",                 BenchmarkBoundingVolumeHierarchyRefit,           {100000, 1000000});
+	suite->Register("BoundingVolumeHierarchy::QueryFrustum",          BenchmarkBoundingVolumeHierarchyQueryFrustum,    {100000, 1000000});
+	suite->Register("BoundingVolumeHierarchy::QueryFrustum_ThreadPool", BenchmarkBoundingVolumeHierarchyQueryFrustumThreadPool, {100000, 1000000});
+	suite->Register("BoundingVolumeHierarchy::QuerySphere",           BenchmarkBoundingVolumeHierarchyQuerySphere,     {100000, 1000000});
+	suite->Register("BruteForce::QuerySphere",                        BenchmarkBruteForceQuerySphere,                  {100000, 1000000});
+	suite->Register("BoundingVolumeHierarchy::QueryRay",              BenchmarkBoundingVolumeHierarchyQueryRay,        {100000, 1000000});
+	suite->Register("BruteForce::QueryRay",                           BenchmarkBruteForceQueryRay,                     {100000, 1000000});
+	suite->Register("OcclusionCuller::RenderOccluders",               BenchmarkOcclusionCullerRenderOccluders,           {1, 16, 64});
+	suite->Register("OcclusionCuller::RenderOccluders_ThreadPool",    BenchmarkOcclusionCullerRenderOccludersThreadPool, {1, 16, 64});
+	suite->Register("OcclusionCuller::IsBoxVisible",                  BenchmarkOcclusionCullerIsBoxVisible,              {100000, 1000000});
+
+	RegisterThreadPoolMicroBenchmarks(suite);
+}
\ No newline at end of file
@@ -1,8 +1,37 @@
 #include "Scene.hpp"
 #include "../../Rendering/Common/Scene/BaseRenderableScene.hpp"
 #include "../../Input/Inputter.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
 
-Scene::Scene()
+namespace
+{
+	SceneObjectLocation InterpolateRigidObjectLocation(const SceneObjectArchetype& archetype, size_t rowIndex, float factor)
+	{
+		SceneObjectLocation result;
+		result.Scale = archetype.PrevStepScales[rowIndex] + (archetype.Scales[rowIndex] - archetype.PrevStepScales[rowIndex]) * factor;
+
+		DirectX::XMStoreFloat3(&result.Position,           DirectX::XMVectorLerp(DirectX::XMLoadFloat3(&archetype.PrevStepPositions[rowIndex]), DirectX::XMLoadFloat3(&archetype.Positions[rowIndex]), factor));
+		DirectX::XMStoreFloat4(&result.RotationQuaternion, DirectX::XMQuaternionSlerp(DirectX::XMLoadFloat4(&archetype.PrevStepRotations[rowIndex]), DirectX::XMLoadFloat4(&archetype.Rotations[rowIndex]), factor));
+
+		return result;
+	}
+
+	bool RenderableUpdateLess(const ObjectDataUpdateInfo& left, const ObjectDataUpdateInfo& right)
+	{
+		return GetRenderableObjectIndex(left.ObjectId) < GetRenderableObjectIndex(right.ObjectId);
+	}
+
+	bool RigidObjectMovedLastStep(const SceneObjectArchetype& archetype, size_t rowIndex)
+	{
+		return memcmp(&archetype.PrevStepPositions[rowIndex], &archetype.Positions[rowIndex], sizeof(DirectX::XMFLOAT3)) != 0
+		    || memcmp(&archetype.PrevStepRotations[rowIndex], &archetype.Rotations[rowIndex], sizeof(DirectX::XMFLOAT4)) != 0
+		    || archetype.PrevStepScales[rowIndex] != archetype.Scales[rowIndex];
+	}
+}
+
+Scene::Scene(ThreadPool* threadPool): mCameraObjectId(0), mRenderableUpdatesOverridden(false), mThreadPoolRef(threadPool)
 {
 }
 
@@ -10,9 +39,56 @@ Scene::~Scene()
 {
 }
 
-void Scene::ProcessControls(Inputter* inputter, float dt)
+void Scene::ProcessLookControls(const Inputter* inputter, float dt)
+{
+	SceneObjectLocation cameraLocation = mSceneObjects.GetLocation(mCameraObjectId);
+
+	DirectX::XMVECTOR cameraQuaternion = DirectX::XMLoadFloat4(&cameraLocation.RotationQuaternion);
+	DirectX::XMMATRIX cameraRotation   = DirectX::XMMatrixRotationQuaternion(cameraQuaternion);
+
+	DirectX::XMVECTOR pitchAxis = DirectX::XMVector3TransformNormal(DirectX::XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f), cameraRotation);
+
+	DirectX::XMFLOAT2 axisDelta = inputter->GetAxis2Delta();
+
+	float rotationFactorXSin = sinf(axisDelta.x * dt / 2.0f);
+	float rotationFactorXCos = cosf(axisDelta.x * dt / 2.0f);
+
+	float rotationFactorYSin = sinf(-axisDelta.y * dt / 2.0f);
+	float rotationFactorYCos = cosf(-axisDelta.y * dt / 2.0f);
+
+	DirectX::XMVECTOR rotationFactorVecX  = DirectX::XMVectorSet(rotationFactorXSin, rotationFactorXSin, rotationFactorXSin, 0.0f);
+	DirectX::XMVECTOR rotationQuaternionX = DirectX::XMVectorSetW(DirectX::XMVectorMultiply(DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f), rotationFactorVecX), rotationFactorXCos);
+
+	DirectX::XMVECTOR rotationFactorVecY  = DirectX::XMVectorSet(rotationFactorYSin, rotationFactorYSin, rotationFactorYSin, 0.0f);
+	DirectX::XMVECTOR rotationQuaternionY = DirectX::XMVectorSetW(DirectX::XMVectorMultiply(pitchAxis, rotationFactorVecY), rotationFactorYCos);
+
+	DirectX::XMVECTOR resultQuaternion = cameraQuaternion;
+	resultQuaternion = DirectX::XMQuaternionMultiply(resultQuaternion, rotationQuaternionY);
+	resultQuaternion = DirectX::XMQuaternionMultiply(resultQuaternion, rotationQuaternionX);
+
+	DirectX::XMStoreFloat4(&cameraLocation.RotationQuaternion, resultQuaternion);
+	mSceneObjects.SetLocation(mCameraObjectId, cameraLocation);
+}
+
+void Scene::SimulateStep(const Inputter* inputter, float dt)
 {
-	SceneObjectLocation& cameraLocation = mSceneObjects[(uint32_t)SpecialSceneObjects::Camera].Location;
+	//Remember the state before the step for the render interpolation
+	mPrevStepCameraLocation = mSceneObjects.GetLocation(mCameraObjectId);
+	mSceneObjects.SavePrevStepLocations();
+
+	//Applied after the previous locations are saved, otherwise the objects would jump without ever being seen as moved
+	for(const PendingObjectLocation& pendingLocation: mPendingObjectLocations)
+	{
+		//The object could be despawned after its location was set
+		if(mSceneObjects.IsObjectAlive(pendingLocation.ObjectId))
+		{
+			mSceneObjects.SetLocation(pendingLocation.ObjectId, pendingLocation.Location);
+		}
+	}
+
+	mPendingObjectLocations.clear();
+
+	SceneObjectLocation cameraLocation = mSceneObjects.GetLocation(mCameraObjectId);
 
 	DirectX::XMVECTOR cameraQuaternion = DirectX::XMLoadFloat4(&cameraLocation.RotationQuaternion);
 	DirectX::XMMATRIX cameraRotation   = DirectX::XMMatrixRotationQuaternion(cameraQuaternion);
@@ -20,7 +96,6 @@ void Scene::ProcessControls(Inputter* inputter, float dt)
 	DirectX::XMVECTOR cameraPosition = DirectX::XMLoadFloat3(&cameraLocation.Position);
 
 	DirectX::XMVECTOR pitchAxis = DirectX::XMVector3TransformNormal(DirectX::XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f), cameraRotation);
-	DirectX::XMVECTOR yawAxis   = DirectX::XMVector3TransformNormal(DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f), cameraRotation);
 	DirectX::XMVECTOR rollAxis  = DirectX::XMVector3TransformNormal(DirectX::XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f), cameraRotation);
 
 	DirectX::XMVECTOR moveVector = DirectX::XMVectorZero();
@@ -50,48 +125,133 @@ void Scene::ProcessControls(Inputter* inputter, float dt)
 
 	cameraPosition = DirectX::XMVectorAdd(cameraPosition, moveVector);
 	DirectX::XMStoreFloat3(&cameraLocation.Position, cameraPosition);
+	mSceneObjects.SetLocation(mCameraObjectId, cameraLocation);
 
+	//Only the subtrees with changed local locations get new world locations, so only they reach the renderable component
+	mTransformHierarchy.UpdateWorldLocations(mThreadPoolRef, &mSceneObjects);
+}
 
-	DirectX::XMFLOAT2 axisDelta = inputter->GetAxis2Delta();
-
-	float rotationFactorXSin = sinf(axisDelta.x * dt / 2.0f);
-	float rotationFactorXCos = cosf(axisDelta.x * dt / 2.0f);
+void Scene::UpdateScene(uint64_t frameNumber, float interpolationFactor)
+{
+	UpdateRenderableComponent(frameNumber, interpolationFactor);
+}
 
-	float rotationFactorYSin = sinf(-axisDelta.y * dt / 2.0f);
-	float rotationFactorYCos = cosf(-axisDelta.y * dt / 2.0f);
+void Scene::OverrideRenderableUpdates(std::span<const ObjectDataUpdateInfo> objectUpdates)
+{
+	mCurrFrameRenderableUpdates.assign(objectUpdates.begin(), objectUpdates.end());
+	mRenderableUpdatesOverridden = true;
+}
 
-	DirectX::XMVECTOR rotationFactorVecX  = DirectX::XMVectorSet(rotationFactorXSin, rotationFactorXSin, rotationFactorXSin, 0.0f);
-	DirectX::XMVECTOR rotationQuaternionX = DirectX::XMVectorSetW(DirectX::XMVectorMultiply(DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f), rotationFactorVecX), rotationFactorXCos);
+std::span<const ObjectDataUpdateInfo> Scene::GetLastRenderableUpdates() const
+{
+	return mCurrFrameRenderableUpdates;
+}
 
-	DirectX::XMVECTOR rotationFactorVecY  = DirectX::XMVectorSet(rotationFactorYSin, rotationFactorYSin, rotationFactorYSin, 0.0f);
-	DirectX::XMVECTOR rotationQuaternionY = DirectX::XMVectorSetW(DirectX::XMVectorMultiply(pitchAxis, rotationFactorVecY), rotationFactorYCos);
+void Scene::SetObjectLocalLocation(SceneObjectId objectId, const SceneObjectLocation& localLocation)
+{
+	if(mTransformHierarchy.Contains(objectId))
+	{
+		mTransformHierarchy.SetLocalLocation(objectId, localLocation);
+	}
+	else
+	{
+		mPendingObjectLocations.push_back(PendingObjectLocation
+		{
+			.ObjectId = objectId,
+			.Location = localLocation
+		});
+	}
+}
 
-	DirectX::XMVECTOR resultQuaternion = DirectX::XMLoadFloat4(&cameraLocation.RotationQuaternion);
-	resultQuaternion = DirectX::XMQuaternionMultiply(resultQuaternion, rotationQuaternionY);
-	resultQuaternion = DirectX::XMQuaternionMultiply(resultQuaternion, rotationQuaternionX);
+bool Scene::SpawnRigidObject(SceneObjectId prototypeObjectId, const SceneObjectLocation& location, SceneObjectId* outObjectId)
+{
+	RenderableSceneObjectHandle renderableHandle = mRenderableComponentRef->AddObject(mSceneObjects.GetRenderableHandle(prototypeObjectId), location);
+	if(renderableHandle == InvalidRenderableObjectHandle)
+	{
+		return false;
+	}
 
-	DirectX::XMStoreFloat4(&cameraLocation.RotationQuaternion, resultQuaternion);
+	//The renderable component uploads the initial location itself, the object only sends updates once it moves
+	const uint32_t rigidObjectMask = (uint32_t)SceneObjectComponentFlags::Renderable | (uint32_t)SceneObjectComponentFlags::Rigid;
+	*outObjectId = mSceneObjects.CreateObject(rigidObjectMask, location, renderableHandle);
+	return true;
 }
 
-void Scene::UpdateScene(uint64_t frameNumber)
+void Scene::DespawnRigidObject(SceneObjectId objectId)
 {
-	UpdateRenderableComponent(frameNumber);
+	assert(!mTransformHierarchy.Contains(objectId));
+
+	mRenderableComponentRef->RemoveObject(mSceneObjects.GetRenderableHandle(objectId));
+	mSceneObjects.DestroyObject(objectId);
 }
 
-void Scene::UpdateRenderableComponent(uint64_t frameNumber)
+void Scene::UpdateRenderableComponent(uint64_t frameNumber, float interpolationFactor)
 {
-	//Update frame data
+	//Update frame data. The camera rotation is applied every frame, only the position needs the interpolation
+	SceneObjectLocation cameraLocation = mSceneObjects.GetLocation(mCameraObjectId);
+	DirectX::XMStoreFloat3(&cameraLocation.Position, DirectX::XMVectorLerp(DirectX::XMLoadFloat3(&mPrevStepCameraLocation.Position), DirectX::XMLoadFloat3(&cameraLocation.Position), interpolationFactor));
+
 	FrameDataUpdateInfo frameUpdateInfo =
 	{
-		.CameraLocation = mSceneObjects[(uint32_t)SpecialSceneObjects::Camera].Location,
+		.CameraLocation = cameraLocation,
 		.ProjMatrix     = mCamera.GetProjMatrix()
 	};
 
 	mRenderableComponentRef->UpdateFrameData(frameUpdateInfo, frameNumber);
 
 
-	//No objects move currently
-	std::span currentFrameMovedObjects = { mCurrFrameRenderableUpdates.begin(), mCurrFrameRenderableUpdates.begin() };
+	//Send the interpolated locations of the rigid objects that moved during the last step.
+	//The objects that stopped moving need one more update with the exact final location.
+	//With several steps per frame, the last step only sees its own moves. The objects moved in the earlier steps are found by the LocationChanged flag
+	if(!mRenderableUpdatesOverridden)
+	{
+		mCurrFrameRenderableUpdates.clear();
+
+		const uint32_t rigidRenderableMask = (uint32_t)SceneObjectComponentFlags::Renderable | (uint32_t)SceneObjectComponentFlags::Rigid;
+		for(uint32_t archetypeIndex = 0; archetypeIndex < mSceneObjects.GetArchetypeCount(); archetypeIndex++)
+		{
+			SceneObjectArchetype& archetype = mSceneObjects.GetArchetype(archetypeIndex);
+			if((archetype.ComponentMask & rigidRenderableMask) != rigidRenderableMask)
+			{
+				continue;
+			}
+
+			for(size_t rowIndex = 0; rowIndex < archetype.ObjectIds.size(); rowIndex++)
+			{
+				bool movedLastStep   = RigidObjectMovedLastStep(archetype, rowIndex);
+				bool wasInMotion     = archetype.Flags[rowIndex] & (uint32_t)SceneObjectFlags::InMotion;
+				bool locationChanged = archetype.Flags[rowIndex] & (uint32_t)SceneObjectFlags::LocationChanged;
+				if(movedLastStep || wasInMotion || locationChanged)
+				{
+					mCurrFrameRenderableUpdates.push_back(ObjectDataUpdateInfo
+					{
+						.ObjectId          = archetype.RenderableHandles[rowIndex],
+						.NewObjectLocation = InterpolateRigidObjectLocation(archetype, rowIndex, movedLastStep ? interpolationFactor : 1.0f)
+					});
+				}
+
+				if(movedLastStep)
+				{
+					archetype.Flags[rowIndex] |= (uint32_t)SceneObjectFlags::InMotion;
+				}
+				else
+				{
+					archetype.Flags[rowIndex] &= ~(uint32_t)SceneObjectFlags::InMotion;
+				}
+
+				archetype.Flags[rowIndex] &= ~(uint32_t)SceneObjectFlags::LocationChanged;
+			}
+		}
+
+		//The renderable component merges the updates with its own sorted list. The rows are created in handle order, but removals can break it
+		if(!std::is_sorted(mCurrFrameRenderableUpdates.begin(), mCurrFrameRenderableUpdates.end(), RenderableUpdateLess))
+		{
+			std::sort(mCurrFrameRenderableUpdates.begin(), mCurrFrameRenderableUpdates.end(), RenderableUpdateLess);
+		}
+	}
+
+	std::span currentFrameMovedObjects = { mCurrFrameRenderableUpdates.begin(), mCurrFrameRenderableUpdates.end() };
+	mRenderableUpdatesOverridden = false;
 
 	mRenderableComponentRef->UpdateRigidSceneObjects(currentFrameMovedObjects, frameNumber); //Always needs to be called
 }
\ No newline at end of file
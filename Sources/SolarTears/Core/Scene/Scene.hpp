@@ -1,13 +1,16 @@
 #pragma once
 
 #include <vector>
+#include <span>
 #include <string>
 #include <unordered_map>
 #include "PinholeCamera.hpp"
-#include "SceneObject.hpp"
+#include "SceneObjectStore.hpp"
+#include "SceneTransformHierarchy.hpp"
 #include "../../Rendering/Common/Scene/RenderableSceneMisc.hpp"
 
 class Inputter;
+class ThreadPool;
 class BaseRenderableScene;
 
 class Scene
@@ -21,21 +24,62 @@ class Scene
 		Count
 	};
 
+	struct PendingObjectLocation
+	{
+		SceneObjectId       ObjectId;
+		SceneObjectLocation Location;
+	};
+
 public:
-	Scene();
+	Scene(ThreadPool* threadPool);
 	~Scene();
 
-	void ProcessControls(Inputter* inputter, float dt);
-	void UpdateScene(uint64_t frameNumber);
+	//Camera rotation follows the mouse every rendered frame, it's not part of the fixed simulation step
+	void ProcessLookControls(const Inputter* inputter, float dt);
+
+	//Advances the simulation by one fixed step
+	void SimulateStep(const Inputter* inputter, float dt);
+
+	//Sends the scene state to the renderable component, interpolated between the last two simulation steps
+	void UpdateScene(uint64_t frameNumber, float interpolationFactor);
+
+	//Replaces the object updates of the next UpdateScene call, used to replay captures
+	void OverrideRenderableUpdates(std::span<const ObjectDataUpdateInfo> objectUpdates);
+
+	//The object updates sent to the renderable component on the last UpdateScene call
+	std::span<const ObjectDataUpdateInfo> GetLastRenderableUpdates() const;
+
+	//Sets the location relative to the parent for attached objects and the world location for the others.
+	//Takes effect on the next simulation step, so the move is interpolated like any other simulated one
+	void SetObjectLocalLocation(SceneObjectId objectId, const SceneObjectLocation& localLocation);
+
+	//Creates a rigid object drawn with the mesh of the prototype object. Returns false if the renderable component has no free dynamic object slots left.
+	//Should be called before UpdateScene() of the frame the object first shows up in
+	bool SpawnRigidObject(SceneObjectId prototypeObjectId, const SceneObjectLocation& location, SceneObjectId* outObjectId);
+
+	//Only for the objects created with SpawnRigidObject()
+	void DespawnRigidObject(SceneObjectId objectId);
 
 private:
-	void UpdateRenderableComponent(uint64_t frameNumber);
+	void UpdateRenderableComponent(uint64_t frameNumber, float interpolationFactor);
 
 private:
-	std::vector<SceneObject> mSceneObjects;
+	SceneObjectStore mSceneObjects;
+	SceneObjectId    mCameraObjectId;
+
+	SceneTransformHierarchy mTransformHierarchy;
+
+	//The world locations of the objects outside of the hierarchy set between the simulation steps
+	std::vector<PendingObjectLocation> mPendingObjectLocations;
 
 	PinholeCamera mCamera;
 
+	//The camera is not a rigid object, its location from before the last simulation step is stored separately
+	SceneObjectLocation mPrevStepCameraLocation;
+
 	BaseRenderableScene*              mRenderableComponentRef;
 	std::vector<ObjectDataUpdateInfo> mCurrFrameRenderableUpdates;
+	bool                              mRenderableUpdatesOverridden;
+
+	ThreadPool* mThreadPoolRef;
 };
\ No newline at end of file
@@ -0,0 +1,1698 @@
+#include "GltfSceneImporter.hpp"
+#include "SceneDescription.hpp"
+#include "../SceneTransformHierarchy.hpp"
+#include "../../ThreadPool.hpp"
+#include "../../Util.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <latch>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <Psapi.h>
+#else
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	//Read-only JSON tree over the text of the glTF file. The strings point into the text, the escape sequences are only resolved on GetString()
+	class JsonDocument
+	{
+	public:
+		static constexpr uint32_t InvalidValue = (uint32_t)(-1);
+		static constexpr uint32_t RootValue    = 0;
+
+		enum class ValueType: uint8_t
+		{
+			Null,
+			Bool,
+			Number,
+			String,
+			Array,
+			Object
+		};
+
+	private:
+		//Way deeper than any valid glTF file, only protects the stack from broken files
+		static constexpr uint32_t MaxNestingDepth = 256;
+
+		struct Value
+		{
+			ValueType        Type;
+			bool             Bool;
+			double           Number;
+			std::string_view RawString; //With the escape sequences
+			std::string_view Key;       //For the object members
+			uint32_t         ChildBegin;
+			uint32_t         ChildCount;
+		};
+
+	public:
+		bool Parse(std::string_view text);
+
+		ValueType GetType(uint32_t value) const;
+
+		//0 for anything but arrays and objects
+		uint32_t GetChildCount(uint32_t value)                     const;
+		uint32_t GetChild(uint32_t value, uint32_t childIndex)     const;
+		uint32_t FindMember(uint32_t objectValue, std::string_view key) const;
+
+		//The lookups of missing members give InvalidValue, and all reads of InvalidValue fail, so the lookups can be chained without checks
+		bool        GetNumber(uint32_t value, double* outNumber) const;
+		bool        GetUint(uint32_t value, uint32_t* outUint)   const;
+		std::string GetString(uint32_t value)                    const;
+
+	private:
+		bool ParseValue(uint32_t depth);
+		bool ParseRawString(std::string_view* outRawString);
+		bool ParseLiteral(std::string_view literal);
+
+		void FinishContainer(uint32_t containerValue, size_t childStackBegin);
+		void SkipWhitespace();
+
+	private:
+		std::string_view mText;
+		size_t           mPosition = 0;
+
+		std::vector<Value>    mValues;
+		std::vector<uint32_t> mChildIndices;
+
+		//The children of the containers still being parsed. Each container moves its children to mChildIndices when it's closed, so they stay contiguous
+		std::vector<uint32_t> mChildStack;
+	};
+
+	bool JsonDocument::Parse(std::string_view text)
+	{
+		mText     = text;
+		mPosition = 0;
+
+		mValues.clear();
+		mChildIndices.clear();
+		mChildStack.clear();
+
+		if(!ParseValue(0))
+		{
+			return false;
+		}
+
+		SkipWhitespace();
+		return mPosition == mText.size();
+	}
+
+	JsonDocument::ValueType JsonDocument::GetType(uint32_t value) const
+	{
+		if(value >= mValues.size())
+		{
+			return ValueType::Null;
+		}
+
+		return mValues[value].Type;
+	}
+
+	uint32_t JsonDocument::GetChildCount(uint32_t value) const
+	{
+		ValueType valueType = GetType(value);
+		if(valueType != ValueType::Array && valueType != ValueType::Object)
+		{
+			return 0;
+		}
+
+		return mValues[value].ChildCount;
+	}
+
+	uint32_t JsonDocument::GetChild(uint32_t value, uint32_t childIndex) const
+	{
+		if(childIndex >= GetChildCount(value))
+		{
+			return InvalidValue;
+		}
+
+		return mChildIndices[mValues[value].ChildBegin + childIndex];
+	}
+
+	uint32_t JsonDocument::FindMember(uint32_t objectValue, std::string_view key) const
+	{
+		if(GetType(objectValue) != ValueType::Object)
+		{
+			return InvalidValue;
+		}
+
+		//glTF objects only have a handful of members, and the keys never need unescaping
+		const Value& object = mValues[objectValue];
+		for(uint32_t childIndex = object.ChildBegin; childIndex < object.ChildBegin + object.ChildCount; childIndex++)
+		{
+			if(mValues[mChildIndices[childIndex]].Key == key)
+			{
+				return mChildIndices[childIndex];
+			}
+		}
+
+		return InvalidValue;
+	}
+
+	bool JsonDocument::GetNumber(uint32_t value, double* outNumber) const
+	{
+		if(GetType(value) != ValueType::Number)
+		{
+			return false;
+		}
+
+		*outNumber = mValues[value].Number;
+		return true;
+	}
+
+	bool JsonDocument::GetUint(uint32_t value, uint32_t* outUint) const
+	{
+		double number = 0.0;
+		if(!GetNumber(value, &number) || number < 0.0 || number > (double)UINT32_MAX || number != std::floor(number))
+		{
+			return false;
+		}
+
+		*outUint = (uint32_t)number;
+		return true;
+	}
+
+	std::string JsonDocument::GetString(uint32_t value) const
+	{
+		if(GetType(value) != ValueType::String)
+		{
+			return std::string();
+		}
+
+		std::string_view rawString = mValues[value].RawString;
+		if(rawString.find('\\') == std::string_view::npos)
+		{
+			return std::string(rawString);
+		}
+
+		auto parseHex = [](std::string_view hexDigits, uint32_t* outCodePoint)
+		{
+			const char* hexEnd = hexDigits.data() + hexDigits.size();
+			return hexDigits.size() == 4 && std::from_chars(hexDigits.data(), hexEnd, *outCodePoint, 16).ptr == hexEnd;
+		};
+
+		std::string result;
+		result.reserve(rawString.size());
+		for(size_t charIndex = 0; charIndex < rawString.size(); charIndex++)
+		{
+			if(rawString[charIndex] != '\\' || charIndex + 1 >= rawString.size())
+			{
+				result.push_back(rawString[charIndex]);
+				continue;
+			}
+
+			char escapedChar = rawString[++charIndex];
+			switch(escapedChar)
+			{
+			case 'b': result.push_back('\b'); break;
+			case 'f': result.push_back('\f'); break;
+			case 'n': result.push_back('\n'); break;
+			case 'r': result.push_back('\r'); break;
+			case 't': result.push_back('\t'); break;
+			case 'u':
+			{
+				uint32_t codePoint = 0;
+				if(!parseHex(rawString.substr(charIndex + 1, 4), &codePoint))
+				{
+					return result;
+				}
+
+				charIndex += 4;
+
+				//The characters outside of the basic plane are written as UTF-16 surrogate pairs
+				uint32_t lowSurrogate = 0;
+				if(codePoint >= 0xd800 && codePoint < 0xdc00 && rawString.substr(charIndex + 1, 2) == "\\u" && parseHex(rawString.substr(charIndex + 3, 4), &lowSurrogate))
+				{
+					codePoint  = 0x10000 + ((codePoint - 0xd800) << 10) + (lowSurrogate - 0xdc00);
+					charIndex += 6;
+				}
+
+				if(codePoint < 0x80)
+				{
+					result.push_back((char)codePoint);
+				}
+				else if(codePoint < 0x800)
+				{
+					result.push_back((char)(0xc0 | (codePoint >> 6)));
+					result.push_back((char)(0x80 | (codePoint & 0x3f)));
+				}
+				else if(codePoint < 0x10000)
+				{
+					result.push_back((char)(0xe0 | (codePoint >> 12)));
+					result.push_back((char)(0x80 | ((codePoint >> 6) & 0x3f)));
+					result.push_back((char)(0x80 | (codePoint & 0x3f)));
+				}
+				else
+				{
+					result.push_back((char)(0xf0 | (codePoint >> 18)));
+					result.push_back((char)(0x80 | ((codePoint >> 12) & 0x3f)));
+					result.push_back((char)(0x80 | ((codePoint >> 6) & 0x3f)));
+					result.push_back((char)(0x80 | (codePoint & 0x3f)));
+				}
+
+				break;
+			}
+			default:
+				result.push_back(escapedChar); //Quotes, slashes and backslashes
+				break;
+			}
+		}
+
+		return result;
+	}
+
+	bool JsonDocument::ParseValue(uint32_t depth)
+	{
+		SkipWhitespace();
+		if(depth > MaxNestingDepth || mPosition >= mText.size())
+		{
+			return false;
+		}
+
+		uint32_t valueIndex = (uint32_t)mValues.size();
+		mValues.push_back(Value
+		{
+			.Type       = ValueType::Null,
+			.Bool       = false,
+			.Number     = 0.0,
+			.RawString  = std::string_view(),
+			.Key        = std::string_view(),
+			.ChildBegin = 0,
+			.ChildCount = 0
+		});
+
+		char firstChar = mText[mPosition];
+		if(firstChar == '{' || firstChar == '[')
+		{
+			bool isObject = (firstChar == '{');
+			char endChar  = isObject ? '}' : ']';
+
+			mValues[valueIndex].Type = isObject ? ValueType::Object : ValueType::Array;
+			mPosition++;
+
+			size_t childStackBegin = mChildStack.size();
+
+			SkipWhitespace();
+			if(mPosition < mText.size() && mText[mPosition] == endChar)
+			{
+				mPosition++;
+				FinishContainer(valueIndex, childStackBegin);
+				return true;
+			}
+
+			while(true)
+			{
+				std::string_view key;
+				if(isObject)
+				{
+					SkipWhitespace();
+					if(!ParseRawString(&key))
+					{
+						return false;
+					}
+
+					SkipWhitespace();
+					if(mPosition >= mText.size() || mText[mPosition] != ':')
+					{
+						return false;
+					}
+
+					mPosition++;
+				}
+
+				uint32_t childIndex = (uint32_t)mValues.size();
+				if(!ParseValue(depth + 1))
+				{
+					return false;
+				}
+
+				mValues[childIndex].Key = key;
+				mChildStack.push_back(childIndex);
+
+				SkipWhitespace();
+				if(mPosition >= mText.size())
+				{
+					return false;
+				}
+
+				char separatorChar = mText[mPosition++];
+				if(separatorChar == endChar)
+				{
+					break;
+				}
+				else if(separatorChar != ',')
+				{
+					return false;
+				}
+			}
+
+			FinishContainer(valueIndex, childStackBegin);
+			return true;
+		}
+		else if(firstChar == '"')
+		{
+			mValues[valueIndex].Type = ValueType::String;
+			return ParseRawString(&mValues[valueIndex].RawString);
+		}
+		else if(firstChar == 't' || firstChar == 'f')
+		{
+			mValues[valueIndex].Type = ValueType::Bool;
+			mValues[valueIndex].Bool = (firstChar == 't');
+			return ParseLiteral((firstChar == 't') ? "true" : "false");
+		}
+		else if(firstChar == 'n')
+		{
+			return ParseLiteral("null");
+		}
+		else if(firstChar == '-' || (firstChar >= '0' && firstChar <= '9'))
+		{
+			mValues[valueIndex].Type = ValueType::Number;
+
+			std::from_chars_result parseResult = std::from_chars(mText.data() + mPosition, mText.data() + mText.size(), mValues[valueIndex].Number);
+			if(parseResult.ec != std::errc())
+			{
+				return false;
+			}
+
+			mPosition = parseResult.ptr - mText.data();
+			return true;
+		}
+
+		return false;
+	}
+
+	bool JsonDocument::ParseRawString(std::string_view* outRawString)
+	{
+		if(mPosition >= mText.size() || mText[mPosition] != '"')
+		{
+			return false;
+		}
+
+		size_t stringBegin = ++mPosition;
+		for(; mPosition < mText.size(); mPosition++)
+		{
+			char stringChar = mText[mPosition];
+			if(stringChar == '"')
+			{
+				*outRawString = mText.substr(stringBegin, mPosition - stringBegin);
+				mPosition++;
+				return true;
+			}
+			else if(stringChar == '\\')
+			{
+				mPosition++;
+			}
+			else if((unsigned char)stringChar < 0x20)
+			{
+				return false;
+			}
+		}
+
+		return false;
+	}
+
+	bool JsonDocument::ParseLiteral(std::string_view literal)
+	{
+		if(mText.substr(mPosition, literal.size()) != literal)
+		{
+			return false;
+		}
+
+		mPosition += literal.size();
+		return true;
+	}
+
+	void JsonDocument::FinishContainer(uint32_t containerValue, size_t childStackBegin)
+	{
+		mValues[containerValue].ChildBegin = (uint32_t)mChildIndices.size();
+		mValues[containerValue].ChildCount = (uint32_t)(mChildStack.size() - childStackBegin);
+
+		mChildIndices.insert(mChildIndices.end(), mChildStack.begin() + childStackBegin, mChildStack.end());
+		mChildStack.resize(childStackBegin);
+	}
+
+	void JsonDocument::SkipWhitespace()
+	{
+		while(mPosition < mText.size() && (mText[mPosition] == ' ' || mText[mPosition] == '\t' || mText[mPosition] == '\n' || mText[mPosition] == '\r'))
+		{
+			mPosition++;
+		}
+	}
+
+
+	//Read-only mapping of a whole file, same as the scene cache file does it. The accessors read the vertex data straight from the mapped pages
+	class MappedFile
+	{
+	public:
+		MappedFile();
+		~MappedFile();
+
+		MappedFile(const MappedFile&)            = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		bool Open(const std::filesystem::path& filePath);
+
+		std::span<const std::byte> GetData() const;
+
+	private:
+#ifdef _WIN32
+		HANDLE mFileHandle;
+		HANDLE mMappingHandle;
+#else
+		int mFileDescriptor;
+#endif
+
+		const std::byte* mMappedData;
+		size_t           mMappedSize;
+	};
+
+	MappedFile::MappedFile()
+	{
+#ifdef _WIN32
+		mFileHandle    = nullptr;
+		mMappingHandle = nullptr;
+#else
+		mFileDescriptor = -1;
+#endif
+
+		mMappedData = nullptr;
+		mMappedSize = 0;
+	}
+
+	MappedFile::~MappedFile()
+	{
+#ifdef _WIN32
+		if(mMappedData != nullptr)
+		{
+			UnmapViewOfFile(mMappedData);
+		}
+
+		if(mMappingHandle != nullptr)
+		{
+			CloseHandle(mMappingHandle);
+		}
+
+		if(mFileHandle != nullptr)
+		{
+			CloseHandle(mFileHandle);
+		}
+#else
+		if(mMappedData != nullptr)
+		{
+			munmap(const_cast<std::byte*>(mMappedData), mMappedSize);
+		}
+
+		if(mFileDescriptor >= 0)
+		{
+			close(mFileDescriptor);
+		}
+#endif
+	}
+
+	bool MappedFile::Open(const std::filesystem::path& filePath)
+	{
+		assert(mMappedData == nullptr);
+
+#ifdef _WIN32
+		mFileHandle = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if(mFileHandle == INVALID_HANDLE_VALUE)
+		{
+			mFileHandle = nullptr;
+			return false;
+		}
+
+		LARGE_INTEGER fileSize;
+		if(!GetFileSizeEx(mFileHandle, &fileSize))
+		{
+			return false;
+		}
+
+		//Empty files can't be mapped, but they are valid empty buffers
+		if(fileSize.QuadPart == 0)
+		{
+			return true;
+		}
+
+		mMappingHandle = CreateFileMappingW(mFileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if(mMappingHandle == nullptr)
+		{
+			return false;
+		}
+
+		mMappedData = reinterpret_cast<const std::byte*>(MapViewOfFile(mMappingHandle, FILE_MAP_READ, 0, 0, 0));
+		mMappedSize = (size_t)fileSize.QuadPart;
+#else
+		mFileDescriptor = open(filePath.c_str(), O_RDONLY);
+		if(mFileDescriptor < 0)
+		{
+			return false;
+		}
+
+		struct stat fileStat;
+		if(fstat(mFileDescriptor, &fileStat) != 0)
+		{
+			return false;
+		}
+
+		if(fileStat.st_size == 0)
+		{
+			return true;
+		}
+
+		void* mappedData = mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, mFileDescriptor, 0);
+		if(mappedData != MAP_FAILED)
+		{
+			//The whole file is read during the import
+			madvise(mappedData, (size_t)fileStat.st_size, MADV_WILLNEED);
+
+			mMappedData = reinterpret_cast<const std::byte*>(mappedData);
+			mMappedSize = (size_t)fileStat.st_size;
+		}
+#endif
+
+		return mMappedData != nullptr;
+	}
+
+	std::span<const std::byte> MappedFile::GetData() const
+	{
+		return std::span(mMappedData, mMappedSize);
+	}
+
+
+	constexpr uint32_t GlbMagic         = 0x46546c67; //"glTF"
+	constexpr uint32_t GlbVersion       = 2;
+	constexpr uint32_t GlbJsonChunkType = 0x4e4f534a; //"JSON"
+	constexpr uint32_t GlbBinChunkType  = 0x004e4942; //"BIN\0"
+
+	constexpr uint32_t GltfComponentByte          = 5120;
+	constexpr uint32_t GltfComponentUnsignedByte  = 5121;
+	constexpr uint32_t GltfComponentShort         = 5122;
+	constexpr uint32_t GltfComponentUnsignedShort = 5123;
+	constexpr uint32_t GltfComponentUnsignedInt   = 5125;
+	constexpr uint32_t GltfComponentFloat         = 5126;
+
+	constexpr uint32_t GltfModeTriangles = 4;
+
+	//Enough primitives per job to make the job overhead small, few enough to spread the large scenes over all workers
+	constexpr uint32_t PrimitivesPerJob = 16;
+
+	struct GlbChunkHeader
+	{
+		uint32_t Length;
+		uint32_t Type;
+	};
+
+	struct GlbHeader
+	{
+		uint32_t Magic;
+		uint32_t Version;
+		uint32_t Length;
+	};
+
+	struct GltfBufferView
+	{
+		const std::byte* Data;
+		uint32_t         Length;
+		uint32_t         Stride; //0 if tightly packed
+	};
+
+	struct GltfAccessor
+	{
+		const std::byte* Data; //The first element
+		uint32_t         Stride;
+		uint32_t         Count;
+		uint32_t         ComponentType;
+		uint32_t         ComponentCount;
+	};
+
+	//The parsed file. The buffers point into the mapped .glb file, the mapped .bin files or the decoded data URIs
+	struct GltfFile
+	{
+		MappedFile   MainFile;
+		JsonDocument Document;
+
+		std::vector<std::unique_ptr<MappedFile>> ExternalBufferFiles;
+		std::vector<std::vector<std::byte>>      DataUriBuffers;
+		std::vector<std::span<const std::byte>>  Buffers;
+		std::vector<GltfBufferView>             BufferViews;
+
+		std::filesystem::path Directory;
+		uint64_t              LoadedByteCount;
+	};
+
+	struct PrimitiveDecodeJob
+	{
+		uint32_t MeshIndex;
+		uint32_t PrimitiveIndex;
+		uint32_t PrimitiveValue;
+	};
+
+	//Runs rangeFunc(rangeBegin, rangeEnd) for consecutive ranges of itemsPerJob items on the thread pool.
+	//Same as in the frustum culling: the main thread takes the last range and then waits for the others
+	template<typename RangeFunc>
+	void ForEachItemRange(ThreadPool* threadPool, uint32_t itemCount, uint32_t itemsPerJob, const RangeFunc& rangeFunc)
+	{
+		if(threadPool == nullptr || itemCount <= itemsPerJob)
+		{
+			rangeFunc(0, itemCount);
+			return;
+		}
+
+		uint32_t jobCount = (itemCount + itemsPerJob - 1) / itemsPerJob;
+
+		std::latch rangeLatch(jobCount - 1);
+		for(uint32_t jobIndex = 0; jobIndex < jobCount - 1; jobIndex++)
+		{
+			struct JobData
+			{
+				const RangeFunc* Func;
+				std::latch*      Waitable;
+				uint32_t         RangeBegin;
+				uint32_t         RangeEnd;
+			}
+			jobData =
+			{
+				.Func       = &rangeFunc,
+				.Waitable   = &rangeLatch,
+				.RangeBegin = jobIndex * itemsPerJob,
+				.RangeEnd   = (jobIndex + 1) * itemsPerJob
+			};
+
+			auto rangeJob = [](void* userData, [[maybe_unused]] uint32_t userDataSize)
+			{
+				JobData* threadJobData = reinterpret_cast<JobData*>(userData);
+
+				(*threadJobData->Func)(threadJobData->RangeBegin, threadJobData->RangeEnd);
+				threadJobData->Waitable->count_down();
+			};
+
+			threadPool->EnqueueWork(rangeJob, &jobData, sizeof(JobData));
+		}
+
+		rangeFunc((jobCount - 1) * itemsPerJob, itemCount);
+		rangeLatch.wait();
+	}
+
+	bool DecodeBase64(std::string_view encodedText, std::vector<std::byte>& outData)
+	{
+		outData.clear();
+		outData.reserve(encodedText.size() / 4 * 3);
+
+		uint32_t bitBuffer = 0;
+		uint32_t bitCount  = 0;
+		for(char encodedChar: encodedText)
+		{
+			uint32_t sextet = 0;
+			if(encodedChar >= 'A' && encodedChar <= 'Z')
+			{
+				sextet = encodedChar - 'A';
+			}
+			else if(encodedChar >= 'a' && encodedChar <= 'z')
+			{
+				sextet = encodedChar - 'a' + 26;
+			}
+			else if(encodedChar >= '0' && encodedChar <= '9')
+			{
+				sextet = encodedChar - '0' + 52;
+			}
+			else if(encodedChar == '+' || encodedChar == '/')
+			{
+				sextet = (encodedChar == '+') ? 62 : 63;
+			}
+			else if(encodedChar == '=')
+			{
+				break;
+			}
+			else
+			{
+				return false;
+			}
+
+			bitBuffer  = (bitBuffer << 6) | sextet;
+			bitCount  += 6;
+			if(bitCount >= 8)
+			{
+				bitCount -= 8;
+				outData.push_back((std::byte)((bitBuffer >> bitCount) & 0xff));
+			}
+		}
+
+		return true;
+	}
+
+	//Data URIs are only supported in the base64 form, same as in every glTF exporter
+	bool DecodeDataUri(std::string_view uri, std::string_view* outMimeType, std::vector<std::byte>& outData)
+	{
+		const std::string_view dataPrefix   = "data:";
+		const std::string_view base64Marker = ";base64,";
+
+		size_t markerPos = uri.find(base64Marker);
+		if(!uri.starts_with(dataPrefix) || markerPos == std::string_view::npos)
+		{
+			return false;
+		}
+
+		*outMimeType = uri.substr(dataPrefix.size(), markerPos - dataPrefix.size());
+		return DecodeBase64(uri.substr(markerPos + base64Marker.size()), outData);
+	}
+
+	std::filesystem::path ResolveUriPath(const std::filesystem::path& directory, std::string_view uri)
+	{
+		//The relative URIs are percent-encoded, the exporters write the spaces in file names as %20
+		std::string decodedUri;
+		decodedUri.reserve(uri.size());
+		for(size_t charIndex = 0; charIndex < uri.size(); charIndex++)
+		{
+			uint32_t decodedChar = 0;
+			if(uri[charIndex] == '%' && charIndex + 2 < uri.size() && std::from_chars(uri.data() + charIndex + 1, uri.data() + charIndex + 3, decodedChar, 16).ptr == uri.data() + charIndex + 3)
+			{
+				decodedUri.push_back((char)decodedChar);
+				charIndex += 2;
+			}
+			else
+			{
+				decodedUri.push_back(uri[charIndex]);
+			}
+		}
+
+		return directory / Utils::ConvertUTF8ToWstring(decodedUri);
+	}
+
+	uint32_t GetComponentSize(uint32_t componentType)
+	{
+		switch(componentType)
+		{
+		case GltfComponentByte:
+		case GltfComponentUnsignedByte:
+			return 1;
+		case GltfComponentShort:
+		case GltfComponentUnsignedShort:
+			return 2;
+		case GltfComponentUnsignedInt:
+		case GltfComponentFloat:
+			return 4;
+		default:
+			return 0;
+		}
+	}
+
+	uint32_t GetComponentCount(std::string_view accessorType)
+	{
+		if(accessorType == "SCALAR") return 1;
+		if(accessorType == "VEC2")   return 2;
+		if(accessorType == "VEC3")   return 3;
+		if(accessorType == "VEC4")   return 4;
+		if(accessorType == "MAT2")   return 4;
+		if(accessorType == "MAT3")   return 9;
+		if(accessorType == "MAT4")   return 16;
+
+		return 0;
+	}
+
+	bool LoadGltfFile(const std::wstring& filename, GltfFile* outFile, std::string* outError)
+	{
+		std::filesystem::path filePath(filename);
+		outFile->Directory = filePath.parent_path();
+
+		if(!outFile->MainFile.Open(filePath))
+		{
+			*outError = "Can't read the file";
+			return false;
+		}
+
+		std::span<const std::byte> fileData = outFile->MainFile.GetData();
+		outFile->LoadedByteCount = fileData.size();
+
+		//The .glb files have the JSON and the first buffer in one file. The .gltf files are just the JSON
+		std::string_view          jsonText;
+		std::span<const std::byte> glbBinChunk;
+
+		GlbHeader glbHeader = {};
+		if(fileData.size() >= sizeof(GlbHeader))
+		{
+			memcpy(&glbHeader, fileData.data(), sizeof(GlbHeader));
+		}
+
+		if(glbHeader.Magic == GlbMagic)
+		{
+			if(glbHeader.Version != GlbVersion || glbHeader.Length > fileData.size())
+			{
+				*outError = "Unsupported or truncated .glb file";
+				return false;
+			}
+
+			size_t chunkOffset = sizeof(GlbHeader);
+			while(chunkOffset + sizeof(GlbChunkHeader) <= glbHeader.Length)
+			{
+				GlbChunkHeader chunkHeader;
+				memcpy(&chunkHeader, fileData.data() + chunkOffset, sizeof(GlbChunkHeader));
+
+				chunkOffset += sizeof(GlbChunkHeader);
+				if(chunkHeader.Length > glbHeader.Length - chunkOffset)
+				{
+					*outError = "Truncated .glb chunk";
+					return false;
+				}
+
+				const std::byte* chunkData = fileData.data() + chunkOffset;
+				if(chunkHeader.Type == GlbJsonChunkType && jsonText.empty())
+				{
+					jsonText = std::string_view(reinterpret_cast<const char*>(chunkData), chunkHeader.Length);
+				}
+				else if(chunkHeader.Type == GlbBinChunkType && glbBinChunk.empty())
+				{
+					glbBinChunk = std::span(chunkData, chunkHeader.Length);
+				}
+
+				chunkOffset += (chunkHeader.Length + 3) & ~3u;
+			}
+		}
+		else
+		{
+			jsonText = std::string_view(reinterpret_cast<const char*>(fileData.data()), fileData.size());
+		}
+
+		if(!outFile->Document.Parse(jsonText))
+		{
+			*outError = "Invalid JSON";
+			return false;
+		}
+
+		const JsonDocument& document = outFile->Document;
+
+		std::string version = document.GetString(document.FindMember(document.FindMember(JsonDocument::RootValue, "asset"), "version"));
+		if(!version.starts_with("2."))
+		{
+			*outError = "Not a glTF 2.0 file";
+			return false;
+		}
+
+		uint32_t buffersValue = document.FindMember(JsonDocument::RootValue, "buffers");
+		uint32_t bufferCount  = document.GetChildCount(buffersValue);
+
+		outFile->ExternalBufferFiles.resize(bufferCount);
+		outFile->DataUriBuffers.resize(bufferCount);
+		outFile->Buffers.resize(bufferCount);
+		for(uint32_t bufferIndex = 0; bufferIndex < bufferCount; bufferIndex++)
+		{
+			uint32_t bufferValue = document.GetChild(buffersValue, bufferIndex);
+
+			uint32_t byteLength = 0;
+			if(!document.GetUint(document.FindMember(bufferValue, "byteLength"), &byteLength))
+			{
+				*outError = "Buffer " + std::to_string(bufferIndex) + " has no byteLength";
+				return false;
+			}
+
+			std::span<const std::byte> bufferData;
+
+			uint32_t uriValue = document.FindMember(bufferValue, "uri");
+			if(uriValue == JsonDocument::InvalidValue)
+			{
+				//Only the first buffer of a .glb file can refer to the BIN chunk
+				if(bufferIndex == 0)
+				{
+					bufferData = glbBinChunk;
+				}
+			}
+			else
+			{
+				std::string uri = document.GetString(uriValue);
+
+				std::string_view mimeType;
+				if(uri.starts_with("data:"))
+				{
+					DecodeDataUri(uri, &mimeType, outFile->DataUriBuffers[bufferIndex]);
+					bufferData = outFile->DataUriBuffers[bufferIndex];
+				}
+				else
+				{
+					outFile->ExternalBufferFiles[bufferIndex] = std::make_unique<MappedFile>();
+					if(outFile->ExternalBufferFiles[bufferIndex]->Open(ResolveUriPath(outFile->Directory, uri)))
+					{
+						bufferData = outFile->ExternalBufferFiles[bufferIndex]->GetData();
+						outFile->LoadedByteCount += bufferData.size();
+					}
+				}
+			}
+
+			if(bufferData.size() < byteLength)
+			{
+				*outError = "Buffer " + std::to_string(bufferIndex) + " is missing or too small";
+				return false;
+			}
+
+			outFile->Buffers[bufferIndex] = bufferData.subspan(0, byteLength);
+		}
+
+		uint32_t bufferViewsValue = document.FindMember(JsonDocument::RootValue, "bufferViews");
+		uint32_t bufferViewCount  = document.GetChildCount(bufferViewsValue);
+
+		outFile->BufferViews.resize(bufferViewCount);
+		for(uint32_t bufferViewIndex = 0; bufferViewIndex < bufferViewCount; bufferViewIndex++)
+		{
+			uint32_t bufferViewValue = document.GetChild(bufferViewsValue, bufferViewIndex);
+
+			uint32_t bufferIndex = 0;
+			uint32_t byteOffset  = 0;
+			uint32_t byteLength  = 0;
+			uint32_t byteStride  = 0;
+			document.GetUint(document.FindMember(bufferViewValue, "byteOffset"), &byteOffset);
+			document.GetUint(document.FindMember(bufferViewValue, "byteStride"), &byteStride);
+
+			bool hasBuffer = document.GetUint(document.FindMember(bufferViewValue, "buffer"),     &bufferIndex) && bufferIndex < bufferCount;
+			bool hasLength = document.GetUint(document.FindMember(bufferViewValue, "byteLength"), &byteLength);
+			if(!hasBuffer || !hasLength || (uint64_t)byteOffset + byteLength > outFile->Buffers[bufferIndex].size())
+			{
+				*outError = "Buffer view " + std::to_string(bufferViewIndex) + " is out of the buffer range";
+				return false;
+			}
+
+			outFile->BufferViews[bufferViewIndex] = GltfBufferView
+			{
+				.Data   = outFile->Buffers[bufferIndex].data() + byteOffset,
+				.Length = byteLength,
+				.Stride = byteStride
+			};
+		}
+
+		return true;
+	}
+
+	//Only the accessors that point to the whole range of valid data. The sparse accessors and the accessors without buffer views are not supported
+	bool ResolveAccessor(const GltfFile& file, uint32_t accessorIndex, GltfAccessor* outAccessor)
+	{
+		const JsonDocument& document = file.Document;
+
+		uint32_t accessorValue = document.GetChild(document.FindMember(JsonDocument::RootValue, "accessors"), accessorIndex);
+		if(accessorValue == JsonDocument::InvalidValue || document.FindMember(accessorValue, "sparse") != JsonDocument::InvalidValue)
+		{
+			return false;
+		}
+
+		uint32_t bufferViewIndex = 0;
+		uint32_t byteOffset      = 0;
+		uint32_t componentType   = 0;
+		uint32_t count           = 0;
+		document.GetUint(document.FindMember(accessorValue, "byteOffset"), &byteOffset);
+
+		bool hasBufferView    = document.GetUint(document.FindMember(accessorValue, "bufferView"),    &bufferViewIndex) && bufferViewIndex < file.BufferViews.size();
+		bool hasComponentType = document.GetUint(document.FindMember(accessorValue, "componentType"), &componentType);
+		bool hasCount         = document.GetUint(document.FindMember(accessorValue, "count"),         &count);
+		if(!hasBufferView || !hasComponentType || !hasCount)
+		{
+			return false;
+		}
+
+		uint32_t componentSize  = GetComponentSize(componentType);
+		uint32_t componentCount = GetComponentCount(document.GetString(document.FindMember(accessorValue, "type")));
+		uint32_t elementSize    = componentSize * componentCount;
+		if(elementSize == 0)
+		{
+			return false;
+		}
+
+		const GltfBufferView& bufferView = file.BufferViews[bufferViewIndex];
+
+		uint32_t stride = (bufferView.Stride != 0) ? bufferView.Stride : elementSize;
+		if(stride < elementSize || (count != 0 && (uint64_t)byteOffset + (uint64_t)stride * (count - 1) + elementSize > bufferView.Length))
+		{
+			return false;
+		}
+
+		*outAccessor = GltfAccessor
+		{
+			.Data           = bufferView.Data + byteOffset,
+			.Stride         = stride,
+			.Count          = count,
+			.ComponentType  = componentType,
+			.ComponentCount = componentCount
+		};
+
+		return true;
+	}
+
+	//glTF is right-handed and its front faces are counter-clockwise. The engine is left-handed with clockwise front faces,
+	//so the Z axis is mirrored and the triangle winding is reversed
+	bool DecodePrimitive(const GltfFile& file, uint32_t primitiveValue, RenderableSceneGeometryData* outGeometry)
+	{
+		const JsonDocument& document = file.Document;
+
+		uint32_t mode = GltfModeTriangles;
+		document.GetUint(document.FindMember(primitiveValue, "mode"), &mode);
+		if(mode != GltfModeTriangles)
+		{
+			return false;
+		}
+
+		uint32_t attributesValue = document.FindMember(primitiveValue, "attributes");
+
+		uint32_t     positionAccessorIndex = 0;
+		GltfAccessor positionAccessor;
+		if(!document.GetUint(document.FindMember(attributesValue, "POSITION"), &positionAccessorIndex) || !ResolveAccessor(file, positionAccessorIndex, &positionAccessor))
+		{
+			return false;
+		}
+
+		if(positionAccessor.ComponentType != GltfComponentFloat || positionAccessor.ComponentCount != 3)
+		{
+			return false;
+		}
+
+		uint32_t vertexCount = positionAccessor.Count;
+
+		//The optional attributes are ignored if they are broken or in an unsupported format, the missing normals are computed from the triangles
+		uint32_t     normalAccessorIndex = 0;
+		GltfAccessor normalAccessor;
+		bool hasNormals = document.GetUint(document.FindMember(attributesValue, "NORMAL"), &normalAccessorIndex) && ResolveAccessor(file, normalAccessorIndex, &normalAccessor)
+		               && normalAccessor.ComponentType == GltfComponentFloat && normalAccessor.ComponentCount == 3 && normalAccessor.Count == vertexCount;
+
+		uint32_t     texcoordAccessorIndex = 0;
+		GltfAccessor texcoordAccessor;
+		bool hasTexcoords = document.GetUint(document.FindMember(attributesValue, "TEXCOORD_0"), &texcoordAccessorIndex) && ResolveAccessor(file, texcoordAccessorIndex, &texcoordAccessor)
+		                 && texcoordAccessor.ComponentCount == 2 && texcoordAccessor.Count == vertexCount;
+
+		outGeometry->Vertices.resize(vertexCount);
+		for(uint32_t vertexIndex = 0; vertexIndex < vertexCount; vertexIndex++)
+		{
+			DirectX::XMFLOAT3& position = outGeometry->Vertices[vertexIndex].Position;
+			memcpy(&position, positionAccessor.Data + (size_t)vertexIndex * positionAccessor.Stride, sizeof(DirectX::XMFLOAT3));
+			position.z = -position.z;
+		}
+
+		if(hasNormals)
+		{
+			for(uint32_t vertexIndex = 0; vertexIndex < vertexCount; vertexIndex++)
+			{
+				DirectX::XMFLOAT3& normal = outGeometry->Vertices[vertexIndex].Normal;
+				memcpy(&normal, normalAccessor.Data + (size_t)vertexIndex * normalAccessor.Stride, sizeof(DirectX::XMFLOAT3));
+				normal.z = -normal.z;
+			}
+		}
+
+		if(hasTexcoords)
+		{
+			//The texture coordinates have the same top-left origin in glTF and in the engine
+			for(uint32_t vertexIndex = 0; vertexIndex < vertexCount; vertexIndex++)
+			{
+				DirectX::XMFLOAT2& texcoord     = outGeometry->Vertices[vertexIndex].Texcoord;
+				const std::byte*   texcoordData = texcoordAccessor.Data + (size_t)vertexIndex * texcoordAccessor.Stride;
+				if(texcoordAccessor.ComponentType == GltfComponentFloat)
+				{
+					memcpy(&texcoord, texcoordData, sizeof(DirectX::XMFLOAT2));
+				}
+				else if(texcoordAccessor.ComponentType == GltfComponentUnsignedShort)
+				{
+					std::array<uint16_t, 2> normalizedTexcoord;
+					memcpy(normalizedTexcoord.data(), texcoordData, sizeof(normalizedTexcoord));
+					texcoord = DirectX::XMFLOAT2((float)normalizedTexcoord[0] / 65535.0f, (float)normalizedTexcoord[1] / 65535.0f);
+				}
+				else if(texcoordAccessor.ComponentType == GltfComponentUnsignedByte)
+				{
+					std::array<uint8_t, 2> normalizedTexcoord;
+					memcpy(normalizedTexcoord.data(), texcoordData, sizeof(normalizedTexcoord));
+					texcoord = DirectX::XMFLOAT2((float)normalizedTexcoord[0] / 255.0f, (float)normalizedTexcoord[1] / 255.0f);
+				}
+			}
+		}
+
+		uint32_t indexAccessorIndex = 0;
+		if(document.GetUint(document.FindMember(primitiveValue, "indices"), &indexAccessorIndex))
+		{
+			GltfAccessor indexAccessor;
+			if(!ResolveAccessor(file, indexAccessorIndex, &indexAccessor) || indexAccessor.ComponentCount != 1)
+			{
+				return false;
+			}
+
+			uint32_t triangleCount = indexAccessor.Count / 3;
+			outGeometry->Indices.resize((size_t)triangleCount * 3);
+
+			auto readIndices = [&]<typename IndexType>()
+			{
+				for(uint32_t triangleIndex = 0; triangleIndex < triangleCount; triangleIndex++)
+				{
+					std::array<IndexType, 3> triangleIndices;
+					for(uint32_t cornerIndex = 0; cornerIndex < 3; cornerIndex++)
+					{
+						memcpy(&triangleIndices[cornerIndex], indexAccessor.Data + ((size_t)triangleIndex * 3 + cornerIndex) * indexAccessor.Stride, sizeof(IndexType));
+					}
+
+					outGeometry->Indices[(size_t)triangleIndex * 3 + 0] = (RenderableSceneIndex)triangleIndices[0];
+					outGeometry->Indices[(size_t)triangleIndex * 3 + 1] = (RenderableSceneIndex)triangleIndices[2];
+					outGeometry->Indices[(size_t)triangleIndex * 3 + 2] = (RenderableSceneIndex)triangleIndices[1];
+				}
+			};
+
+			switch(indexAccessor.ComponentType)
+			{
+			case GltfComponentUnsignedByte:
+				readIndices.operator()<uint8_t>();
+				break;
+			case GltfComponentUnsignedShort:
+				readIndices.operator()<uint16_t>();
+				break;
+			case GltfComponentUnsignedInt:
+				readIndices.operator()<uint32_t>();
+				break;
+			default:
+				return false;
+			}
+
+			if(std::any_of(outGeometry->Indices.begin(), outGeometry->Indices.end(), [vertexCount](RenderableSceneIndex index) {return index >= vertexCount;}))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			uint32_t triangleCount = vertexCount / 3;
+			outGeometry->Indices.resize((size_t)triangleCount * 3);
+			for(uint32_t triangleIndex = 0; triangleIndex < triangleCount; triangleIndex++)
+			{
+				outGeometry->Indices[(size_t)triangleIndex * 3 + 0] = triangleIndex * 3 + 0;
+				outGeometry->Indices[(size_t)triangleIndex * 3 + 1] = triangleIndex * 3 + 2;
+				outGeometry->Indices[(size_t)triangleIndex * 3 + 2] = triangleIndex * 3 + 1;
+			}
+		}
+
+		if(!hasNormals)
+		{
+			//Area-weighted average of the triangle normals
+			for(size_t triangleStart = 0; triangleStart < outGeometry->Indices.size(); triangleStart += 3)
+			{
+				RenderableSceneVertex& vertex0 = outGeometry->Vertices[outGeometry->Indices[triangleStart + 0]];
+				RenderableSceneVertex& vertex1 = outGeometry->Vertices[outGeometry->Indices[triangleStart + 1]];
+				RenderableSceneVertex& vertex2 = outGeometry->Vertices[outGeometry->Indices[triangleStart + 2]];
+
+				DirectX::XMVECTOR position0 = DirectX::XMLoadFloat3(&vertex0.Position);
+				DirectX::XMVECTOR edge1     = DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&vertex1.Position), position0);
+				DirectX::XMVECTOR edge2     = DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&vertex2.Position), position0);
+
+				DirectX::XMVECTOR triangleNormal = DirectX::XMVector3Cross(edge1, edge2);
+				for(RenderableSceneVertex* vertex: {&vertex0, &vertex1, &vertex2})
+				{
+					DirectX::XMStoreFloat3(&vertex->Normal, DirectX::XMVectorAdd(DirectX::XMLoadFloat3(&vertex->Normal), triangleNormal));
+				}
+			}
+
+			for(RenderableSceneVertex& vertex: outGeometry->Vertices)
+			{
+				DirectX::XMStoreFloat3(&vertex.Normal, DirectX::XMVector3Normalize(DirectX::XMLoadFloat3(&vertex.Normal)));
+			}
+		}
+
+		return !outGeometry->Indices.empty();
+	}
+
+	bool ReadFloatArray(const JsonDocument& document, uint32_t arrayValue, std::span<float> outValues)
+	{
+		if(document.GetChildCount(arrayValue) != outValues.size())
+		{
+			return false;
+		}
+
+		for(uint32_t valueIndex = 0; valueIndex < (uint32_t)outValues.size(); valueIndex++)
+		{
+			double number = 0.0;
+			if(!document.GetNumber(document.GetChild(arrayValue, valueIndex), &number))
+			{
+				return false;
+			}
+
+			outValues[valueIndex] = (float)number;
+		}
+
+		return true;
+	}
+
+	//The engine locations only have uniform scale, the non-uniform node scales are replaced with the largest component
+	SceneObjectLocation ReadNodeLocalLocation(const JsonDocument& document, uint32_t nodeValue)
+	{
+		SceneObjectLocation localLocation =
+		{
+			.Position           = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f),
+			.Scale              = 1.0f,
+			.RotationQuaternion = DirectX::XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f)
+		};
+
+		DirectX::XMFLOAT3 nodeScale = DirectX::XMFLOAT3(1.0f, 1.0f, 1.0f);
+
+		//The column-major glTF matrix has the same memory layout as the row-major DirectXMath matrix for row vectors
+		DirectX::XMFLOAT4X4 nodeMatrix;
+		if(ReadFloatArray(document, document.FindMember(nodeValue, "matrix"), std::span(&nodeMatrix.m[0][0], 16)))
+		{
+			DirectX::XMVECTOR scale, rotation, translation;
+			if(DirectX::XMMatrixDecompose(&scale, &rotation, &translation, DirectX::XMLoadFloat4x4(&nodeMatrix)))
+			{
+				DirectX::XMStoreFloat3(&localLocation.Position,           translation);
+				DirectX::XMStoreFloat4(&localLocation.RotationQuaternion, rotation);
+				DirectX::XMStoreFloat3(&nodeScale,                        scale);
+			}
+		}
+		else
+		{
+			ReadFloatArray(document, document.FindMember(nodeValue, "translation"), std::span(&localLocation.Position.x,           3));
+			ReadFloatArray(document, document.FindMember(nodeValue, "rotation"),    std::span(&localLocation.RotationQuaternion.x, 4));
+			ReadFloatArray(document, document.FindMember(nodeValue, "scale"),       std::span(&nodeScale.x,                        3));
+		}
+
+		localLocation.Scale = std::max({std::abs(nodeScale.x), std::abs(nodeScale.y), std::abs(nodeScale.z)});
+		return localLocation;
+	}
+
+	SceneObjectLocation ConvertToEngineLocation(const SceneObjectLocation& gltfLocation)
+	{
+		//Mirroring the Z axis negates the Z position and the rotation around X and Y
+		SceneObjectLocation engineLocation = gltfLocation;
+		engineLocation.Position.z           = -gltfLocation.Position.z;
+		engineLocation.RotationQuaternion.x = -gltfLocation.RotationQuaternion.x;
+		engineLocation.RotationQuaternion.y = -gltfLocation.RotationQuaternion.y;
+
+		return engineLocation;
+	}
+
+	uint64_t QueryPeakProcessMemory()
+	{
+#ifdef _WIN32
+		PROCESS_MEMORY_COUNTERS memoryCounters = {};
+		if(GetProcessMemoryInfo(GetCurrentProcess(), &memoryCounters, sizeof(PROCESS_MEMORY_COUNTERS)))
+		{
+			return memoryCounters.PeakWorkingSetSize;
+		}
+
+		return 0;
+#else
+		rusage resourceUsage = {};
+		if(getrusage(RUSAGE_SELF, &resourceUsage) == 0)
+		{
+			return (uint64_t)resourceUsage.ru_maxrss * 1024; //In kilobytes on Linux
+		}
+
+		return 0;
+#endif
+	}
+}
+
+GltfSceneImporter::GltfSceneImporter(ThreadPool* threadPool): mThreadPoolRef(threadPool), mLastImportStats{}
+{
+}
+
+GltfSceneImporter::~GltfSceneImporter()
+{
+}
+
+void GltfSceneImporter::SetFallbackTexture(const std::wstring& textureFilename)
+{
+	mFallbackTextureFilename = textureFilename;
+}
+
+bool GltfSceneImporter::Import(const std::wstring& filename, SceneDescription* outSceneDescription)
+{
+	mLastImportStats = GltfImportStats{};
+	mLastError.clear();
+
+	auto importStartTime = std::chrono::steady_clock::now();
+
+	GltfFile gltfFile;
+	if(!LoadGltfFile(filename, &gltfFile, &mLastError))
+	{
+		return false;
+	}
+
+	auto loadEndTime = std::chrono::steady_clock::now();
+
+	const JsonDocument& document = gltfFile.Document;
+
+	uint32_t nodesValue  = document.FindMember(JsonDocument::RootValue, "nodes");
+	uint32_t meshesValue = document.FindMember(JsonDocument::RootValue, "meshes");
+	uint32_t nodeCount   = document.GetChildCount(nodesValue);
+	uint32_t meshCount   = document.GetChildCount(meshesValue);
+
+
+	//Flatten the node hierarchy of the default scene. Without scenes, all nodes that are not children of other nodes are the roots
+	std::vector<uint32_t> rootNodeIndices;
+
+	uint32_t sceneIndex = 0;
+	document.GetUint(document.FindMember(JsonDocument::RootValue, "scene"), &sceneIndex);
+
+	uint32_t sceneValue = document.GetChild(document.FindMember(JsonDocument::RootValue, "scenes"), sceneIndex);
+	if(sceneValue != JsonDocument::InvalidValue)
+	{
+		uint32_t sceneNodesValue = document.FindMember(sceneValue, "nodes");
+		for(uint32_t sceneNodeIndex = 0; sceneNodeIndex < document.GetChildCount(sceneNodesValue); sceneNodeIndex++)
+		{
+			uint32_t nodeIndex = 0;
+			if(document.GetUint(document.GetChild(sceneNodesValue, sceneNodeIndex), &nodeIndex) && nodeIndex < nodeCount)
+			{
+				rootNodeIndices.push_back(nodeIndex);
+			}
+		}
+	}
+	else
+	{
+		std::vector<uint8_t> childNodeFlags(nodeCount, 0);
+		for(uint32_t nodeIndex = 0; nodeIndex < nodeCount; nodeIndex++)
+		{
+			uint32_t childrenValue = document.FindMember(document.GetChild(nodesValue, nodeIndex), "children");
+			for(uint32_t childIndex = 0; childIndex < document.GetChildCount(childrenValue); childIndex++)
+			{
+				uint32_t childNodeIndex = 0;
+				if(document.GetUint(document.GetChild(childrenValue, childIndex), &childNodeIndex) && childNodeIndex < nodeCount)
+				{
+					childNodeFlags[childNodeIndex] = 1;
+				}
+			}
+		}
+
+		for(uint32_t nodeIndex = 0; nodeIndex < nodeCount; nodeIndex++)
+		{
+			if(!childNodeFlags[nodeIndex])
+			{
+				rootNodeIndices.push_back(nodeIndex);
+			}
+		}
+	}
+
+	struct NodeVisit
+	{
+		uint32_t            NodeIndex;
+		SceneObjectLocation ParentWorldLocation;
+	};
+
+	const SceneObjectLocation identityLocation =
+	{
+		.Position           = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f),
+		.Scale              = 1.0f,
+		.RotationQuaternion = DirectX::XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f)
+	};
+
+	std::vector<NodeVisit> nodeVisitStack;
+	for(uint32_t rootNodeIndex: rootNodeIndices)
+	{
+		nodeVisitStack.push_back(NodeVisit
+		{
+			.NodeIndex           = rootNodeIndex,
+			.ParentWorldLocation = identityLocation
+		});
+	}
+
+	//The hierarchy has to be a tree, the flags only protect from the broken files
+	std::vector<uint8_t>                          visitedNodeFlags(nodeCount, 0);
+	std::vector<std::vector<SceneObjectLocation>> meshObjectLocations(meshCount);
+	while(!nodeVisitStack.empty())
+	{
+		NodeVisit nodeVisit = nodeVisitStack.back();
+		nodeVisitStack.pop_back();
+
+		if(visitedNodeFlags[nodeVisit.NodeIndex])
+		{
+			continue;
+		}
+
+		visitedNodeFlags[nodeVisit.NodeIndex] = 1;
+
+		//The hierarchy is composed in glTF space and converted at the end
+		uint32_t            nodeValue     = document.GetChild(nodesValue, nodeVisit.NodeIndex);
+		SceneObjectLocation worldLocation = SceneTransformHierarchy::CombineLocations(nodeVisit.ParentWorldLocation, ReadNodeLocalLocation(document, nodeValue));
+
+		uint32_t meshIndex = 0;
+		if(document.GetUint(document.FindMember(nodeValue, "mesh"), &meshIndex) && meshIndex < meshCount)
+		{
+			meshObjectLocations[meshIndex].push_back(ConvertToEngineLocation(worldLocation));
+		}
+
+		uint32_t childrenValue = document.FindMember(nodeValue, "children");
+		for(uint32_t childIndex = 0; childIndex < document.GetChildCount(childrenValue); childIndex++)
+		{
+			uint32_t childNodeIndex = 0;
+			if(document.GetUint(document.GetChild(childrenValue, childIndex), &childNodeIndex) && childNodeIndex < nodeCount)
+			{
+				nodeVisitStack.push_back(NodeVisit
+				{
+					.NodeIndex           = childNodeIndex,
+					.ParentWorldLocation = worldLocation
+				});
+			}
+		}
+	}
+
+
+	//Decode the primitives of the used meshes. Each primitive is independent and goes straight from the file buffers into its own geometry
+	std::vector<PrimitiveDecodeJob> primitiveDecodeJobs;
+	for(uint32_t meshIndex = 0; meshIndex < meshCount; meshIndex++)
+	{
+		if(meshObjectLocations[meshIndex].empty())
+		{
+			continue;
+		}
+
+		uint32_t primitivesValue = document.FindMember(document.GetChild(meshesValue, meshIndex), "primitives");
+		for(uint32_t primitiveIndex = 0; primitiveIndex < document.GetChildCount(primitivesValue); primitiveIndex++)
+		{
+			primitiveDecodeJobs.push_back(PrimitiveDecodeJob
+			{
+				.MeshIndex      = meshIndex,
+				.PrimitiveIndex = primitiveIndex,
+				.PrimitiveValue = document.GetChild(primitivesValue, primitiveIndex)
+			});
+		}
+	}
+
+	std::vector<RenderableSceneGeometryData> primitiveGeometries(primitiveDecodeJobs.size());
+	std::vector<uint8_t>                     primitiveDecodedFlags(primitiveDecodeJobs.size(), 0);
+	ForEachItemRange(mThreadPoolRef, (uint32_t)primitiveDecodeJobs.size(), PrimitivesPerJob, [&](uint32_t rangeBegin, uint32_t rangeEnd)
+	{
+		for(uint32_t jobIndex = rangeBegin; jobIndex < rangeEnd; jobIndex++)
+		{
+			primitiveDecodedFlags[jobIndex] = DecodePrimitive(gltfFile, primitiveDecodeJobs[jobIndex].PrimitiveValue, &primitiveGeometries[jobIndex]);
+		}
+	});
+
+	auto decodeEndTime = std::chrono::steady_clock::now();
+
+
+	//Nothing can fail from here on, fill the scene description. The names are prefixed with the file name, so several files can go into one scene
+	RenderableSceneDescription& renderableDescription = outSceneDescription->GetRenderableComponent();
+
+	std::string  namePrefix     = Utils::ConvertWstringToUTF8(std::filesystem::path(filename).stem().wstring()) + "/";
+	std::wstring wideNamePrefix = std::filesystem::path(filename).stem().wstring() + L"/";
+
+	uint32_t imagesValue   = document.FindMember(JsonDocument::RootValue, "images");
+	uint32_t texturesValue = document.FindMember(JsonDocument::RootValue, "textures");
+
+	//Each image is resolved once, no matter how many materials use it
+	std::vector<std::wstring> imageTextureNames(document.GetChildCount(imagesValue));
+	std::vector<uint8_t>      imageResolvedFlags(imageTextureNames.size(), 0);
+	auto resolveTexture = [&](uint32_t textureInfoValue) -> std::wstring
+	{
+		uint32_t textureIndex = 0;
+		if(!document.GetUint(document.FindMember(textureInfoValue, "index"), &textureIndex))
+		{
+			return std::wstring();
+		}
+
+		//MSFT_texture_dds points to the DDS version of the image directly
+		uint32_t textureValue = document.GetChild(texturesValue, textureIndex);
+		uint32_t ddsSourceValue = document.FindMember(document.FindMember(document.FindMember(textureValue, "extensions"), "MSFT_texture_dds"), "source");
+
+		uint32_t imageIndex = 0;
+		if(!document.GetUint(ddsSourceValue, &imageIndex) && !document.GetUint(document.FindMember(textureValue, "source"), &imageIndex))
+		{
+			return std::wstring();
+		}
+
+		if(imageIndex >= imageTextureNames.size())
+		{
+			return std::wstring();
+		}
+
+		if(imageResolvedFlags[imageIndex])
+		{
+			return imageTextureNames[imageIndex];
+		}
+
+		imageResolvedFlags[imageIndex] = 1;
+
+		uint32_t    imageValue = document.GetChild(imagesValue, imageIndex);
+		std::string imageUri   = document.GetString(document.FindMember(imageValue, "uri"));
+		std::string mimeType   = document.GetString(document.FindMember(imageValue, "mimeType"));
+
+		//The embedded images are only usable if they are DDS already
+		const std::string_view ddsMimeType = "image/vnd-ms.dds";
+
+		uint32_t bufferViewIndex = 0;
+		if(document.GetUint(document.FindMember(imageValue, "bufferView"), &bufferViewIndex))
+		{
+			if(mimeType == ddsMimeType && bufferViewIndex < gltfFile.BufferViews.size())
+			{
+				const GltfBufferView& bufferView = gltfFile.BufferViews[bufferViewIndex];
+
+				imageTextureNames[imageIndex] = wideNamePrefix + L"Image" + std::to_wstring(imageIndex);
+				renderableDescription.AddTextureData(imageTextureNames[imageIndex], std::vector<std::byte>(bufferView.Data, bufferView.Data + bufferView.Length));
+			}
+		}
+		else if(imageUri.starts_with("data:"))
+		{
+			std::string_view       dataMimeType;
+			std::vector<std::byte> imageData;
+			if(DecodeDataUri(imageUri, &dataMimeType, imageData) && dataMimeType == ddsMimeType)
+			{
+				imageTextureNames[imageIndex] = wideNamePrefix + L"Image" + std::to_wstring(imageIndex);
+				renderableDescription.AddTextureData(imageTextureNames[imageIndex], std::move(imageData));
+			}
+		}
+		else if(!imageUri.empty())
+		{
+			std::filesystem::path imagePath = ResolveUriPath(gltfFile.Directory, imageUri);
+			imagePath.replace_extension(L".dds");
+
+			std::error_code fileError;
+			if(std::filesystem::exists(imagePath, fileError))
+			{
+				imageTextureNames[imageIndex] = imagePath.wstring();
+			}
+		}
+
+		return imageTextureNames[imageIndex];
+	};
+
+	uint32_t materialsValue = document.FindMember(JsonDocument::RootValue, "materials");
+	uint32_t materialCount  = document.GetChildCount(materialsValue);
+	for(uint32_t materialIndex = 0; materialIndex < materialCount; materialIndex++)
+	{
+		uint32_t materialValue = document.GetChild(materialsValue, materialIndex);
+
+		std::wstring textureFilename = resolveTexture(document.FindMember(document.FindMember(materialValue, "pbrMetallicRoughness"), "baseColorTexture"));
+		if(textureFilename.empty())
+		{
+			textureFilename = mFallbackTextureFilename;
+		}
+
+		renderableDescription.AddMaterial(namePrefix + "Material" + std::to_string(materialIndex), RenderableSceneMaterialData
+		{
+			.TextureFilename   = std::move(textureFilename),
+			.NormalMapFilename = resolveTexture(document.FindMember(materialValue, "normalTexture"))
+		});
+	}
+
+	//glTF draws the primitives without a material with the default one
+	std::string defaultMaterialName = namePrefix + "DefaultMaterial";
+	bool        defaultMaterialUsed = false;
+
+	std::vector<std::vector<RenderableSceneSubmeshData>> meshSubmeshes(meshCount);
+	for(size_t jobIndex = 0; jobIndex < primitiveDecodeJobs.size(); jobIndex++)
+	{
+		const PrimitiveDecodeJob& decodeJob = primitiveDecodeJobs[jobIndex];
+		if(!primitiveDecodedFlags[jobIndex])
+		{
+			mLastImportStats.SkippedPrimitiveCount++;
+			continue;
+		}
+
+		std::string materialName = defaultMaterialName;
+
+		uint32_t materialIndex = 0;
+		if(document.GetUint(document.FindMember(decodeJob.PrimitiveValue, "material"), &materialIndex) && materialIndex < materialCount)
+		{
+			materialName = namePrefix + "Material" + std::to_string(materialIndex);
+		}
+		else
+		{
+			defaultMaterialUsed = true;
+		}
+
+		mLastImportStats.GeometryBytes += primitiveGeometries[jobIndex].Vertices.size() * sizeof(RenderableSceneVertex);
+		mLastImportStats.GeometryBytes += primitiveGeometries[jobIndex].Indices.size()  * sizeof(RenderableSceneIndex);
+		mLastImportStats.GeometryCount++;
+
+		std::string geometryName = namePrefix + "Mesh" + std::to_string(decodeJob.MeshIndex) + "_" + std::to_string(decodeJob.PrimitiveIndex);
+		renderableDescription.AddGeometry(geometryName, std::move(primitiveGeometries[jobIndex]));
+
+		meshSubmeshes[decodeJob.MeshIndex].push_back(RenderableSceneSubmeshData
+		{
+			.GeometryName = std::move(geometryName),
+			.MaterialName = std::move(materialName)
+		});
+	}
+
+	if(defaultMaterialUsed)
+	{
+		renderableDescription.AddMaterial(defaultMaterialName, RenderableSceneMaterialData
+		{
+			.TextureFilename   = mFallbackTextureFilename,
+			.NormalMapFilename = L""
+		});
+	}
+
+	//The meshes used by a single node get a scene object, the meshes used by several nodes are instanced
+	size_t singleObjectCount = std::count_if(meshObjectLocations.begin(), meshObjectLocations.end(), [](const std::vector<SceneObjectLocation>& locations) {return locations.size() == 1;});
+	outSceneDescription->ReserveSceneObjects(singleObjectCount);
+	renderableDescription.ReserveMeshes(meshCount);
+
+	for(uint32_t meshIndex = 0; meshIndex < meshCount; meshIndex++)
+	{
+		const std::vector<SceneObjectLocation>& objectLocations = meshObjectLocations[meshIndex];
+		if(meshSubmeshes[meshIndex].empty())
+		{
+			continue;
+		}
+
+		std::string meshName = namePrefix + "Mesh" + std::to_string(meshIndex);
+		renderableDescription.AddMesh(meshName);
+		for(RenderableSceneSubmeshData& submesh: meshSubmeshes[meshIndex])
+		{
+			renderableDescription.AddSubmesh(meshName, std::move(submesh));
+		}
+
+		if(objectLocations.size() == 1)
+		{
+			SceneDescriptionObject& sceneObject = outSceneDescription->CreateEmptySceneObject();
+			sceneObject.SetLocation(objectLocations.front());
+			sceneObject.SetMeshComponentName(meshName);
+		}
+		else
+		{
+			outSceneDescription->CreateMeshInstanceObjects(meshName, objectLocations);
+		}
+
+		mLastImportStats.MeshCount++;
+		mLastImportStats.ObjectCount += (uint32_t)objectLocations.size();
+	}
+
+	auto importEndTime = std::chrono::steady_clock::now();
+
+	mLastImportStats.ImportTimeMs           = std::chrono::duration<float, std::milli>(importEndTime - importStartTime).count();
+	mLastImportStats.LoadTimeMs             = std::chrono::duration<float, std::milli>(loadEndTime   - importStartTime).count();
+	mLastImportStats.DecodeTimeMs           = std::chrono::duration<float, std::milli>(decodeEndTime - loadEndTime).count();
+	mLastImportStats.FileBytes              = gltfFile.LoadedByteCount;
+	mLastImportStats.PeakProcessMemoryBytes = QueryPeakProcessMemory();
+	mLastImportStats.MaterialCount          = materialCount + (defaultMaterialUsed ? 1 : 0);
+
+	return true;
+}
+
+const GltfImportStats& GltfSceneImporter::GetLastImportStats() const
+{
+	return mLastImportStats;
+}
+
+const std::string& GltfSceneImporter::GetLastError() const
+{
+	return mLastError;
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+class SceneDescription;
+class ThreadPool;
+
+struct GltfImportStats
+{
+	float ImportTimeMs; //Everything, including the file reads
+	float LoadTimeMs;   //Reading the files and parsing the JSON
+	float DecodeTimeMs; //The conversion of the accessor data to the scene geometry
+
+	uint64_t FileBytes;              //The glTF file and all external buffers
+	uint64_t GeometryBytes;          //The vertices and indices added to the scene description
+	uint64_t PeakProcessMemoryBytes; //The peak working set of the process by the end of the import
+
+	uint32_t MeshCount;
+	uint32_t ObjectCount;
+	uint32_t GeometryCount;
+	uint32_t MaterialCount;
+	uint32_t SkippedPrimitiveCount; //Non-triangle primitives and primitives with unsupported or broken accessors
+};
+
+//Loads the meshes, materials and node locations of a glTF 2.0 file (.gltf or .glb) into a scene description.
+//The node hierarchy is flattened to static objects, the meshes used by several nodes become mesh instances.
+//The engine only loads DDS textures, so each image is replaced with the .dds file of the same name next to it
+class GltfSceneImporter
+{
+public:
+	GltfSceneImporter(ThreadPool* threadPool);
+	~GltfSceneImporter();
+
+	//Used for the materials without a base color texture and for the images that have no DDS version
+	void SetFallbackTexture(const std::wstring& textureFilename);
+
+	//Returns false if the file can't be read or is not a valid glTF 2.0 file. The scene description is only changed on success
+	bool Import(const std::wstring& filename, SceneDescription* outSceneDescription);
+
+	const GltfImportStats& GetLastImportStats() const;
+	const std::string&     GetLastError()       const;
+
+private:
+	ThreadPool* mThreadPoolRef;
+
+	std::wstring mFallbackTextureFilename;
+
+	GltfImportStats mLastImportStats;
+	std::string     mLastError;
+};
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "SceneDescription.hpp"
 #include <algorithm>
+#include <cassert>
 
 SceneDescription::SceneDescription()
 {
@@ -33,51 +34,182 @@ SceneDescriptionObject& SceneDescription::GetCameraSceneObject()
 	return mSceneObjects[(uint32_t)Scene::SpecialSceneObjects::Camera];
 }
 
-void SceneDescription::BuildScene(Scene* scene, BaseRenderableScene* renderableComponent, const std::unordered_map<std::string_view, RenderableSceneObjectHandle>& meshHandles)
+void SceneDescription::CreateMeshInstanceObjects(const std::string& meshName, std::span<const SceneObjectLocation> locations)
+{
+	mRenderableComponentDescription.AddMeshInstances(meshName, locations);
+	mInstancedMeshNames.push_back(meshName);
+}
+
+void SceneDescription::ReserveSceneObjects(size_t objectCount)
+{
+	mSceneObjects.reserve(mSceneObjects.size() + objectCount);
+}
+
+void SceneDescription::ReserveMeshInstanceObjects(size_t objectCount)
+{
+	mRenderableComponentDescription.ReserveMeshInstances(objectCount);
+}
+
+uint32_t SceneDescription::GetSceneObjectIndex(const SceneDescriptionObject& sceneObject) const
+{
+	assert(&sceneObject >= mSceneObjects.data() && &sceneObject < mSceneObjects.data() + mSceneObjects.size());
+	return (uint32_t)(&sceneObject - mSceneObjects.data());
+}
+
+void SceneDescription::BuildScene(Scene* scene, BaseRenderableScene* renderableComponent, const std::unordered_map<std::string_view, RenderableSceneObjectHandle>& meshHandles, std::vector<SceneObjectId>* outSceneObjectIds)
 {
 	scene->mCurrFrameRenderableUpdates.clear();
+	scene->mPendingObjectLocations.clear();
+	scene->mSceneObjects.Clear();
+	scene->mTransformHierarchy.Clear();
+
+	const uint32_t staticObjectMask = (uint32_t)SceneObjectComponentFlags::Renderable;
+	const uint32_t rigidObjectMask  = (uint32_t)SceneObjectComponentFlags::Renderable | (uint32_t)SceneObjectComponentFlags::Rigid;
 
-	//Fill scene objects
-	scene->mSceneObjects.reserve(mSceneObjects.size());
+	//Fill scene objects. The rigid objects are added in the renderable handle order, so their updates come out sorted
+	std::vector<std::pair<RenderableSceneObjectHandle, size_t>> rigidObjects;
+	std::vector<SceneObjectId> sceneObjectIds(mSceneObjects.size());
 	for(size_t i = 0; i < mSceneObjects.size(); i++)
 	{
+		uint32_t                    componentMask    = 0;
 		RenderableSceneObjectHandle renderableHandle = (uint32_t)(-1);
 
 		auto renderableIt = meshHandles.find(mSceneObjects[i].GetMeshComponentName());
 		if(renderableIt != meshHandles.end())
 		{
+			componentMask    = staticObjectMask;
 			renderableHandle = renderableIt->second;
 
 			if(!mRenderableComponentDescription.IsMeshStatic(mSceneObjects[i].GetMeshComponentName()))
 			{
-				scene->mCurrFrameRenderableUpdates.push_back(ObjectDataUpdateInfo
-				{
-					.ObjectId          = renderableHandle,
-					.NewObjectLocation = mSceneObjects[i].GetLocation()
-				});
+				rigidObjects.push_back(std::make_pair(renderableHandle, i));
+				continue;
 			}
 		}
 
-		scene->mSceneObjects.emplace_back(SceneObject
+		SceneObjectId objectId = scene->mSceneObjects.CreateObject(componentMask, mSceneObjects[i].GetLocation(), renderableHandle);
+		sceneObjectIds[i] = objectId;
+
+		if(i == (size_t)Scene::SpecialSceneObjects::Camera)
 		{
-			.Id       = (uint64_t)i,
-			.Location = mSceneObjects[i].GetLocation(),
+			scene->mCameraObjectId = objectId;
+		}
+	}
+
+	//The instances of a mesh have consecutive handles, only the first one is looked up
+	struct RigidInstanceBatch
+	{
+		RenderableSceneObjectHandle          FirstHandle;
+		std::span<const SceneObjectLocation> Locations;
+	};
 
-			.RenderableHandle = renderableHandle,
-		});
+	std::vector<RigidInstanceBatch> rigidInstanceBatches;
+	size_t                          rigidInstanceCount = 0;
+	for(const std::string& meshName: mInstancedMeshNames)
+	{
+		std::span<const SceneObjectLocation> instanceLocations = mRenderableComponentDescription.GetMeshInstanceLocations(meshName);
+
+		auto renderableIt = meshHandles.find(meshName);
+		if(renderableIt == meshHandles.end())
+		{
+			for(const SceneObjectLocation& instanceLocation: instanceLocations)
+			{
+				scene->mSceneObjects.CreateObject(0, instanceLocation, (uint32_t)(-1));
+			}
+
+			continue;
+		}
+
+		if(!mRenderableComponentDescription.IsMeshStatic(meshName))
+		{
+			rigidInstanceBatches.push_back(RigidInstanceBatch
+			{
+				.FirstHandle = renderableIt->second,
+				.Locations   = instanceLocations
+			});
+
+			rigidInstanceCount += instanceLocations.size();
+			continue;
+		}
+
+		scene->mSceneObjects.Reserve(staticObjectMask, instanceLocations.size());
+		for(uint32_t instanceIndex = 0; instanceIndex < (uint32_t)instanceLocations.size(); instanceIndex++)
+		{
+			scene->mSceneObjects.CreateObject(staticObjectMask, instanceLocations[instanceIndex], renderableIt->second + instanceIndex);
+		}
 	}
 
-	std::sort(scene->mCurrFrameRenderableUpdates.begin(), scene->mCurrFrameRenderableUpdates.end(), [](const ObjectDataUpdateInfo& left, const ObjectDataUpdateInfo& right)
+	std::sort(rigidObjects.begin(), rigidObjects.end());
+	std::sort(rigidInstanceBatches.begin(), rigidInstanceBatches.end(), [](const RigidInstanceBatch& left, const RigidInstanceBatch& right)
 	{
-		return left.ObjectId < right.ObjectId;
+		return left.FirstHandle < right.FirstHandle;
 	});
 
+	//Both lists are sorted by handle, merge them
+	scene->mSceneObjects.Reserve(rigidObjectMask, rigidObjects.size() + rigidInstanceCount);
+
+	auto rigidObjectIt = rigidObjects.begin();
+	auto createRigidObjectsBefore = [&](RenderableSceneObjectHandle handleLimit)
+	{
+		for(; rigidObjectIt != rigidObjects.end() && rigidObjectIt->first < handleLimit; ++rigidObjectIt)
+		{
+			const auto& [renderableHandle, descriptionObjectIndex] = *rigidObjectIt;
+			sceneObjectIds[descriptionObjectIndex] = scene->mSceneObjects.CreateObject(rigidObjectMask, mSceneObjects[descriptionObjectIndex].GetLocation(), renderableHandle);
+		}
+	};
+
+	for(const RigidInstanceBatch& instanceBatch: rigidInstanceBatches)
+	{
+		createRigidObjectsBefore(instanceBatch.FirstHandle);
+		for(uint32_t instanceIndex = 0; instanceIndex < (uint32_t)instanceBatch.Locations.size(); instanceIndex++)
+		{
+			scene->mSceneObjects.CreateObject(rigidObjectMask, instanceBatch.Locations[instanceIndex], instanceBatch.FirstHandle + instanceIndex);
+		}
+	}
+
+	createRigidObjectsBefore(InvalidRenderableObjectHandle);
+
+	//Fill the transform hierarchy. Only the attached objects and their parents are part of it
+	std::vector<uint8_t> hierarchyObjectFlags(mSceneObjects.size(), 0);
+	for(size_t i = 0; i < mSceneObjects.size(); i++)
+	{
+		uint32_t parentIndex = mSceneObjects[i].GetParentIndex();
+		if(parentIndex != SceneDescriptionObject::NoParent)
+		{
+			hierarchyObjectFlags[i]           = 1;
+			hierarchyObjectFlags[parentIndex] = 1;
+		}
+	}
+
+	for(size_t i = 0; i < mSceneObjects.size(); i++)
+	{
+		if(hierarchyObjectFlags[i])
+		{
+			uint32_t      parentIndex    = mSceneObjects[i].GetParentIndex();
+			SceneObjectId parentObjectId = (parentIndex == SceneDescriptionObject::NoParent) ? SceneTransformHierarchy::NoParent : sceneObjectIds[parentIndex];
+			scene->mTransformHierarchy.AddNode(sceneObjectIds[i], parentObjectId, mSceneObjects[i].GetLocation());
+		}
+	}
+
+	//The objects are created with their local locations, replace them with the world ones. Nothing should count as moved on the first step
+	scene->mTransformHierarchy.Build();
+	scene->mTransformHierarchy.UpdateWorldLocations(nullptr, &scene->mSceneObjects);
+	scene->mSceneObjects.SavePrevStepLocations();
+	scene->mSceneObjects.ClearLocationChangedFlags();
+
+	scene->mPrevStepCameraLocation = scene->mSceneObjects.GetLocation(scene->mCameraObjectId);
+
 
 	//TODO: more camera control
 	scene->mCamera.SetProjectionParameters(mSceneCameraComponent.VerticalFov, (float)mSceneCameraComponent.ViewportWidth / (float)mSceneCameraComponent.ViewportHeight, 0.01f, 100.0f);
 
 	//Set scene components
 	scene->mRenderableComponentRef = renderableComponent;
+
+	if(outSceneObjectIds != nullptr)
+	{
+		*outSceneObjectIds = std::move(sceneObjectIds);
+	}
 }
 
 RenderableSceneDescription& SceneDescription::GetRenderableComponent()
@@ -87,6 +219,9 @@ RenderableSceneDescription& SceneDescription::GetRenderableComponent()
 
 void SceneDescription::GetRenderableObjectLocations(std::unordered_map<std::string_view, SceneObjectLocation>& outLocations)
 {
+	//The instanced objects are located by the renderable component itself
+	outLocations.reserve(outLocations.size() + mSceneObjects.size());
+
 	for(const SceneDescriptionObject& descriptionObject: mSceneObjects)
 	{
 		const std::string& meshComponentName = descriptionObject.GetMeshComponentName();
@@ -95,6 +230,20 @@ void SceneDescription::GetRenderableObjectLocations(std::unordered_map<std::stri
 			continue;
 		}
 
-		outLocations[descriptionObject.GetMeshComponentName()] = descriptionObject.GetLocation();
+		outLocations[descriptionObject.GetMeshComponentName()] = CalculateWorldLocation(GetSceneObjectIndex(descriptionObject));
 	}
+}
+
+SceneObjectLocation SceneDescription::CalculateWorldLocation(uint32_t sceneObjectIndex) const
+{
+	SceneObjectLocation worldLocation = mSceneObjects[sceneObjectIndex].GetLocation();
+
+	uint32_t parentIndex = mSceneObjects[sceneObjectIndex].GetParentIndex();
+	while(parentIndex != SceneDescriptionObject::NoParent)
+	{
+		worldLocation = SceneTransformHierarchy::CombineLocations(mSceneObjects[parentIndex].GetLocation(), worldLocation);
+		parentIndex   = mSceneObjects[parentIndex].GetParentIndex();
+	}
+
+	return worldLocation;
 }
\ No newline at end of file
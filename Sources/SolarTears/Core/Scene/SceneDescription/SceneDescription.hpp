@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <string>
+#include <span>
 #include <unordered_map>
 #include "../Scene.hpp"
 #include "SceneDescriptionObject.hpp"
@@ -17,17 +18,36 @@ public:
 	SceneDescriptionObject& CreateEmptySceneObject();
 	SceneDescriptionObject& GetCameraSceneObject();
 
+	//Creates one object for each location, all drawn with the same mesh. The objects don't need their own meshes, names or description objects,
+	//so it's a lot cheaper than CreateEmptySceneObject() for large scenes. The objects can't be attached to other objects. Can only be called once per mesh
+	void CreateMeshInstanceObjects(const std::string& meshName, std::span<const SceneObjectLocation> locations);
+
+	//Avoids reallocations when creating a lot of objects
+	void ReserveSceneObjects(size_t objectCount);
+	void ReserveMeshInstanceObjects(size_t objectCount);
+
+	//The index to use with SceneDescriptionObject::SetParentIndex(). Unlike the references, the indices stay valid after creating more objects
+	uint32_t GetSceneObjectIndex(const SceneDescriptionObject& sceneObject) const;
+
 public:
-	void BuildScene(Scene* scene, BaseRenderableScene* renderableComponent, const std::unordered_map<std::string_view, RenderableSceneObjectHandle>& meshHandles);
+	//outSceneObjectIds, if not null, receives the scene object id of each description object, in the order of GetSceneObjectIndex()
+	void BuildScene(Scene* scene, BaseRenderableScene* renderableComponent, const std::unordered_map<std::string_view, RenderableSceneObjectHandle>& meshHandles, std::vector<SceneObjectId>* outSceneObjectIds = nullptr);
 
 public:
 	RenderableSceneDescription& GetRenderableComponent();
 	void GetRenderableObjectLocations(std::unordered_map<std::string_view, SceneObjectLocation>& outLocations);
 
+private:
+	//Composes the location with the locations of all parents
+	SceneObjectLocation CalculateWorldLocation(uint32_t sceneObjectIndex) const;
+
 private:
 	//Scene description objects
 	std::vector<SceneDescriptionObject> mSceneObjects;
 
+	//The meshes of the objects created with CreateMeshInstanceObjects(). The locations are stored in the renderable component
+	std::vector<std::string> mInstancedMeshNames;
+
 	//Special object description
 	SceneCameraComponent mSceneCameraComponent;
 
@@ -1,6 +1,6 @@
 #include "SceneDescriptionObject.hpp"
 
-SceneDescriptionObject::SceneDescriptionObject()
+SceneDescriptionObject::SceneDescriptionObject(): mParentIndex(NoParent)
 {
 	mLocation = SceneObjectLocation
 	{
@@ -37,4 +37,14 @@ const std::string& SceneDescriptionObject::GetMeshComponentName() const
 void SceneDescriptionObject::SetMeshComponentName(const std::string& meshComponentName)
 {
 	mMeshComponentName = meshComponentName;
+}
+
+void SceneDescriptionObject::SetParentIndex(uint32_t parentIndex)
+{
+	mParentIndex = parentIndex;
+}
+
+uint32_t SceneDescriptionObject::GetParentIndex() const
+{
+	return mParentIndex;
 }
\ No newline at end of file
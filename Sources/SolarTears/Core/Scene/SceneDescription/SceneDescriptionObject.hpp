@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <memory>
@@ -24,8 +25,16 @@ public:
 	const std::string& GetMeshComponentName() const;
 	void SetMeshComponentName(const std::string& meshComponentName);
 
+	//The index of the parent object in the scene description. The location of an attached object is relative to the parent
+	void SetParentIndex(uint32_t parentIndex);
+	uint32_t GetParentIndex() const;
+
+public:
+	static constexpr uint32_t NoParent = (uint32_t)(-1);
+
 private:
 	SceneObjectLocation mLocation; //All scene objects have a location
+	uint32_t            mParentIndex;
 
 	std::string mMeshComponentName;
 };
\ No newline at end of file
@@ -0,0 +1,345 @@
+#include "StressSceneGenerator.hpp"
+#include "SceneDescription.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace
+{
+	//Minimal DDS header for uncompressed 32-bit RGBA data, the layout is fixed by the file format
+	struct DdsPixelFormat
+	{
+		uint32_t Size;
+		uint32_t Flags;
+		uint32_t FourCC;
+		uint32_t RGBBitCount;
+		uint32_t RBitMask;
+		uint32_t GBitMask;
+		uint32_t BBitMask;
+		uint32_t ABitMask;
+	};
+
+	struct DdsHeader
+	{
+		uint32_t       Size;
+		uint32_t       Flags;
+		uint32_t       Height;
+		uint32_t       Width;
+		uint32_t       PitchOrLinearSize;
+		uint32_t       Depth;
+		uint32_t       MipMapCount;
+		uint32_t       Reserved1[11];
+		DdsPixelFormat PixelFormat;
+		uint32_t       Caps;
+		uint32_t       Caps2;
+		uint32_t       Caps3;
+		uint32_t       Caps4;
+		uint32_t       Reserved2;
+	};
+
+	static_assert(sizeof(DdsHeader) == 124);
+
+	constexpr uint32_t DdsMagic = 0x20534444; //"DDS "
+
+	constexpr uint32_t DdsdCaps        = 0x00000001;
+	constexpr uint32_t DdsdHeight      = 0x00000002;
+	constexpr uint32_t DdsdWidth       = 0x00000004;
+	constexpr uint32_t DdsdPitch       = 0x00000008;
+	constexpr uint32_t DdsdPixelFormat = 0x00001000;
+	constexpr uint32_t DdpfAlphaPixels = 0x00000001;
+	constexpr uint32_t DdpfRgb         = 0x00000040;
+	constexpr uint32_t DdsCapsTexture  = 0x00001000;
+
+	constexpr uint32_t CheckerCellSize = 8;
+}
+
+StressSceneGenerator::StressSceneGenerator(const StressSceneConfig& config): mConfig(config)
+{
+	mRandomState = config.Seed;
+}
+
+StressSceneGenerator::~StressSceneGenerator()
+{
+}
+
+StressSceneConfig StressSceneGenerator::CreateDefaultConfig(uint64_t seed, uint32_t objectCount)
+{
+	const uint32_t instancesPerMesh   = 9;
+	const uint32_t uniqueMeshCount    = std::max(objectCount / 10, 1u);
+	const uint32_t instancedMeshCount = (objectCount - std::min(uniqueMeshCount, objectCount)) / instancesPerMesh;
+
+	return StressSceneConfig
+	{
+		.Seed = seed,
+
+		.UniqueMeshCount    = uniqueMeshCount,
+		.InstancedMeshCount = instancedMeshCount,
+		.InstancesPerMesh   = instancesPerMesh,
+		.SubmeshesPerMesh   = 2,
+
+		.MaterialCount = 64,
+		.TextureCount  = 16,
+		.TextureSize   = 64,
+
+		.RigidMeshFraction  = 0.25f,
+		.OccluderMeshStride = 0,
+		.SceneExtent        = 100.0f
+	};
+}
+
+void StressSceneGenerator::Generate(SceneDescription* outSceneDescription)
+{
+	mRandomState = mConfig.Seed;
+
+	RenderableSceneDescription& renderableDescription = outSceneDescription->GetRenderableComponent();
+
+	uint32_t submeshesPerMesh = std::max(mConfig.SubmeshesPerMesh, 1u);
+	uint32_t materialCount    = std::max(mConfig.MaterialCount,    1u);
+	uint32_t textureCount     = std::max(mConfig.TextureCount,     1u);
+
+	renderableDescription.ReserveMeshes((size_t)mConfig.UniqueMeshCount + mConfig.InstancedMeshCount);
+	outSceneDescription->ReserveSceneObjects(mConfig.UniqueMeshCount);
+	outSceneDescription->ReserveMeshInstanceObjects((size_t)mConfig.InstancedMeshCount * mConfig.InstancesPerMesh);
+
+	std::vector<std::wstring> textureNames(textureCount);
+	for(uint32_t textureIndex = 0; textureIndex < textureCount; textureIndex++)
+	{
+		uint32_t colorA = (uint32_t)NextRandom() | 0xff000000;
+		uint32_t colorB = (uint32_t)NextRandom() | 0xff000000;
+
+		std::vector<std::byte> ddsData;
+		CreateCheckerboardDds(std::max(mConfig.TextureSize, 1u), colorA, colorB, ddsData);
+
+		textureNames[textureIndex] = L"StressTexture" + std::to_wstring(textureIndex);
+		renderableDescription.AddTextureData(textureNames[textureIndex], std::move(ddsData));
+	}
+
+	std::vector<std::string> materialNames(materialCount);
+	for(uint32_t materialIndex = 0; materialIndex < materialCount; materialIndex++)
+	{
+		materialNames[materialIndex] = "StressMaterial" + std::to_string(materialIndex);
+		renderableDescription.AddMaterial(materialNames[materialIndex], RenderableSceneMaterialData
+		{
+			.TextureFilename   = textureNames[materialIndex % textureCount],
+			.NormalMapFilename = L""
+		});
+	}
+
+	//Geometries are named after the mesh (or the instanced mesh group) and the submesh index
+	auto addMeshGeometries = [&](const std::string& geometryPrefix, std::vector<RenderableSceneSubmeshData>& outSubmeshes)
+	{
+		outSubmeshes.clear();
+		for(uint32_t submeshIndex = 0; submeshIndex < submeshesPerMesh; submeshIndex++)
+		{
+			//Function argument evaluation order is unspecified, take the random values one by one
+			float halfWidth  = NextRandomFloat(0.1f, 1.0f);
+			float halfHeight = NextRandomFloat(0.1f, 1.0f);
+			float halfDepth  = NextRandomFloat(0.1f, 1.0f);
+
+			RenderableSceneGeometryData geometry;
+			CreateBoxGeometry(halfWidth, halfHeight, halfDepth, geometry);
+
+			std::string geometryName = geometryPrefix + "_" + std::to_string(submeshIndex);
+			renderableDescription.AddGeometry(geometryName, std::move(geometry));
+
+			outSubmeshes.push_back(RenderableSceneSubmeshData
+			{
+				.GeometryName = std::move(geometryName),
+				.MaterialName = materialNames[NextRandom() % materialCount]
+			});
+		}
+	};
+
+	auto addMesh = [&](const std::string& meshName, std::vector<RenderableSceneSubmeshData>& submeshes, bool isRigid, bool isOccluder)
+	{
+		renderableDescription.AddMesh(meshName);
+		for(RenderableSceneSubmeshData& submesh: submeshes)
+		{
+			renderableDescription.AddSubmesh(meshName, std::move(submesh));
+		}
+
+		if(isRigid)
+		{
+			renderableDescription.MarkMeshAsNonStatic(meshName);
+		}
+
+		if(isOccluder)
+		{
+			renderableDescription.MarkMeshAsOccluder(meshName);
+		}
+	};
+
+	//The occluders are picked by the static mesh count, so the random sequence is the same with and without them
+	uint32_t staticUniqueMeshCount = 0;
+
+	std::vector<RenderableSceneSubmeshData> meshSubmeshes;
+	for(uint32_t uniqueMeshIndex = 0; uniqueMeshIndex < mConfig.UniqueMeshCount; uniqueMeshIndex++)
+	{
+		std::string meshName = "StressUniqueMesh" + std::to_string(uniqueMeshIndex);
+		addMeshGeometries(meshName, meshSubmeshes);
+
+		bool isRigid    = NextRandomFloat(0.0f, 1.0f) < mConfig.RigidMeshFraction;
+		bool isOccluder = false;
+		if(!isRigid)
+		{
+			isOccluder = mConfig.OccluderMeshStride != 0 && staticUniqueMeshCount % mConfig.OccluderMeshStride == 0;
+			staticUniqueMeshCount++;
+		}
+
+		addMesh(meshName, meshSubmeshes, isRigid, isOccluder);
+
+		SceneDescriptionObject& sceneObject = outSceneDescription->CreateEmptySceneObject();
+		sceneObject.SetLocation(NextObjectLocation());
+		sceneObject.SetMeshComponentName(meshName);
+	}
+
+	//All instances of a mesh share the geometry and the static/rigid state, so the scene builder groups them together
+	std::vector<SceneObjectLocation> instanceLocations(mConfig.InstancesPerMesh);
+	for(uint32_t instancedMeshIndex = 0; instancedMeshIndex < mConfig.InstancedMeshCount; instancedMeshIndex++)
+	{
+		std::string meshName = "StressInstancedMesh" + std::to_string(instancedMeshIndex);
+		addMeshGeometries(meshName, meshSubmeshes);
+
+		bool isRigid = NextRandomFloat(0.0f, 1.0f) < mConfig.RigidMeshFraction;
+		addMesh(meshName, meshSubmeshes, isRigid, false);
+
+		for(uint32_t instanceIndex = 0; instanceIndex < mConfig.InstancesPerMesh; instanceIndex++)
+		{
+			instanceLocations[instanceIndex] = NextObjectLocation();
+		}
+
+		outSceneDescription->CreateMeshInstanceObjects(meshName, instanceLocations);
+	}
+}
+
+uint64_t StressSceneGenerator::NextRandom()
+{
+	//SplitMix64. The standard library distributions differ between implementations, so they can't be used for a reproducible workload
+	mRandomState += 0x9e3779b97f4a7c15ull;
+
+	uint64_t result = mRandomState;
+	result = (result ^ (result >> 30)) * 0xbf58476d1ce4e5b9ull;
+	result = (result ^ (result >> 27)) * 0x94d049bb133111ebull;
+	return result ^ (result >> 31);
+}
+
+float StressSceneGenerator::NextRandomFloat(float minValue, float maxValue)
+{
+	float unitValue = (float)(NextRandom() >> 40) / (float)(1ull << 24);
+	return minValue + (maxValue - minValue) * unitValue;
+}
+
+void StressSceneGenerator::CreateCheckerboardDds(uint32_t size, uint32_t colorA, uint32_t colorB, std::vector<std::byte>& outDdsData) const
+{
+	DdsHeader header;
+	memset(&header, 0, sizeof(DdsHeader));
+
+	header.Size              = sizeof(DdsHeader);
+	header.Flags             = DdsdCaps | DdsdHeight | DdsdWidth | DdsdPitch | DdsdPixelFormat;
+	header.Height            = size;
+	header.Width             = size;
+	header.PitchOrLinearSize = size * sizeof(uint32_t);
+	header.MipMapCount       = 1;
+	header.Caps              = DdsCapsTexture;
+
+	header.PixelFormat.Size        = sizeof(DdsPixelFormat);
+	header.PixelFormat.Flags       = DdpfRgb | DdpfAlphaPixels;
+	header.PixelFormat.RGBBitCount = 32;
+	header.PixelFormat.RBitMask    = 0x000000ff;
+	header.PixelFormat.GBitMask    = 0x0000ff00;
+	header.PixelFormat.BBitMask    = 0x00ff0000;
+	header.PixelFormat.ABitMask    = 0xff000000;
+
+	outDdsData.resize(sizeof(uint32_t) + sizeof(DdsHeader) + (size_t)size * size * sizeof(uint32_t));
+	memcpy(outDdsData.data(),                    &DdsMagic, sizeof(uint32_t));
+	memcpy(outDdsData.data() + sizeof(uint32_t), &header,   sizeof(DdsHeader));
+
+	std::byte* pixelData = outDdsData.data() + sizeof(uint32_t) + sizeof(DdsHeader);
+	for(uint32_t y = 0; y < size; y++)
+	{
+		for(uint32_t x = 0; x < size; x++)
+		{
+			uint32_t color = (((x / CheckerCellSize) + (y / CheckerCellSize)) % 2 == 0) ? colorA : colorB;
+			memcpy(pixelData + ((size_t)y * size + x) * sizeof(uint32_t), &color, sizeof(uint32_t));
+		}
+	}
+}
+
+void StressSceneGenerator::CreateBoxGeometry(float halfWidth, float halfHeight, float halfDepth, RenderableSceneGeometryData& outGeometry) const
+{
+	struct BoxFace
+	{
+		DirectX::XMFLOAT3 Normal;
+		DirectX::XMFLOAT3 Right;
+		DirectX::XMFLOAT3 Up;
+	};
+
+	const std::array<BoxFace, 6> boxFaces =
+	{
+		BoxFace{.Normal = DirectX::XMFLOAT3( 0.0f,  0.0f, -1.0f), .Right = DirectX::XMFLOAT3( 1.0f,  0.0f,  0.0f), .Up = DirectX::XMFLOAT3(0.0f, 1.0f,  0.0f)},
+		BoxFace{.Normal = DirectX::XMFLOAT3( 0.0f,  0.0f,  1.0f), .Right = DirectX::XMFLOAT3(-1.0f,  0.0f,  0.0f), .Up = DirectX::XMFLOAT3(0.0f, 1.0f,  0.0f)},
+		BoxFace{.Normal = DirectX::XMFLOAT3(-1.0f,  0.0f,  0.0f), .Right = DirectX::XMFLOAT3( 0.0f,  0.0f, -1.0f), .Up = DirectX::XMFLOAT3(0.0f, 1.0f,  0.0f)},
+		BoxFace{.Normal = DirectX::XMFLOAT3( 1.0f,  0.0f,  0.0f), .Right = DirectX::XMFLOAT3( 0.0f,  0.0f,  1.0f), .Up = DirectX::XMFLOAT3(0.0f, 1.0f,  0.0f)},
+		BoxFace{.Normal = DirectX::XMFLOAT3( 0.0f,  1.0f,  0.0f), .Right = DirectX::XMFLOAT3( 1.0f,  0.0f,  0.0f), .Up = DirectX::XMFLOAT3(0.0f, 0.0f,  1.0f)},
+		BoxFace{.Normal = DirectX::XMFLOAT3( 0.0f, -1.0f,  0.0f), .Right = DirectX::XMFLOAT3( 1.0f,  0.0f,  0.0f), .Up = DirectX::XMFLOAT3(0.0f, 0.0f, -1.0f)}
+	};
+
+	const std::array<DirectX::XMFLOAT2, 4> cornerSigns =
+	{
+		DirectX::XMFLOAT2(-1.0f, -1.0f),
+		DirectX::XMFLOAT2(-1.0f,  1.0f),
+		DirectX::XMFLOAT2( 1.0f,  1.0f),
+		DirectX::XMFLOAT2( 1.0f, -1.0f)
+	};
+
+	outGeometry.Vertices.clear();
+	outGeometry.Indices.clear();
+	outGeometry.Vertices.reserve(boxFaces.size() * cornerSigns.size());
+	outGeometry.Indices.reserve(boxFaces.size() * 6);
+
+	for(const BoxFace& face: boxFaces)
+	{
+		RenderableSceneIndex firstFaceIndex = (RenderableSceneIndex)outGeometry.Vertices.size();
+		for(const DirectX::XMFLOAT2& cornerSign: cornerSigns)
+		{
+			float cornerX = face.Normal.x + face.Right.x * cornerSign.x + face.Up.x * cornerSign.y;
+			float cornerY = face.Normal.y + face.Right.y * cornerSign.x + face.Up.y * cornerSign.y;
+			float cornerZ = face.Normal.z + face.Right.z * cornerSign.x + face.Up.z * cornerSign.y;
+
+			outGeometry.Vertices.push_back(RenderableSceneVertex
+			{
+				.Position = DirectX::XMFLOAT3(cornerX * halfWidth, cornerY * halfHeight, cornerZ * halfDepth),
+				.Normal   = face.Normal,
+				.Texcoord = DirectX::XMFLOAT2(cornerSign.x * 0.5f + 0.5f, 0.5f - cornerSign.y * 0.5f)
+			});
+		}
+
+		outGeometry.Indices.insert(outGeometry.Indices.end(),
+		{
+			firstFaceIndex + 0, firstFaceIndex + 1, firstFaceIndex + 2,
+			firstFaceIndex + 0, firstFaceIndex + 2, firstFaceIndex + 3
+		});
+	}
+}
+
+SceneObjectLocation StressSceneGenerator::NextObjectLocation()
+{
+	float yaw   = NextRandomFloat(-DirectX::XM_PI, DirectX::XM_PI);
+	float pitch = NextRandomFloat(-DirectX::XM_PI, DirectX::XM_PI);
+	float roll  = NextRandomFloat(-DirectX::XM_PI, DirectX::XM_PI);
+
+	DirectX::XMFLOAT4 rotation;
+	DirectX::XMStoreFloat4(&rotation, DirectX::XMQuaternionRotationRollPitchYaw(pitch, yaw, roll));
+
+	float positionX = NextRandomFloat(-mConfig.SceneExtent, mConfig.SceneExtent);
+	float positionY = NextRandomFloat(-mConfig.SceneExtent, mConfig.SceneExtent);
+	float positionZ = NextRandomFloat(-mConfig.SceneExtent, mConfig.SceneExtent);
+	float scale     = NextRandomFloat(0.5f, 2.0f);
+
+	return SceneObjectLocation
+	{
+		.Position           = DirectX::XMFLOAT3(positionX, positionY, positionZ),
+		.Scale              = scale,
+		.RotationQuaternion = rotation
+	};
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include "../SceneObjectLocation.hpp"
+
+class SceneDescription;
+struct RenderableSceneGeometryData;
+
+struct StressSceneConfig
+{
+	uint64_t Seed;
+
+	uint32_t UniqueMeshCount;    //Meshes with their own geometry, one object each
+	uint32_t InstancedMeshCount; //Meshes with geometry shared between several objects
+	uint32_t InstancesPerMesh;   //Object count for each instanced mesh
+	uint32_t SubmeshesPerMesh;   //Each submesh has its own geometry and a random material
+
+	uint32_t MaterialCount;
+	uint32_t TextureCount; //Textures are generated in memory and shared between materials
+	uint32_t TextureSize;
+
+	float    RigidMeshFraction;  //The fraction of unique and instanced meshes that are rigid, the rest is static
+	uint32_t OccluderMeshStride; //Every OccluderMeshStride-th static unique mesh is an occluder, 0 for none
+	float    SceneExtent;        //The objects are placed inside a cube [-SceneExtent, SceneExtent]
+};
+
+//Fills a scene description with a procedural workload for scaling tests. Doesn't read any files.
+//The same config always produces the same scene, on any platform
+class StressSceneGenerator
+{
+public:
+	StressSceneGenerator(const StressSceneConfig& config);
+	~StressSceneGenerator();
+
+	//A config with a 1:9 ratio of unique to instanced objects
+	static StressSceneConfig CreateDefaultConfig(uint64_t seed, uint32_t objectCount);
+
+	void Generate(SceneDescription* outSceneDescription);
+
+private:
+	uint64_t NextRandom();
+	float    NextRandomFloat(float minValue, float maxValue);
+
+	void CreateCheckerboardDds(uint32_t size, uint32_t colorA, uint32_t colorB, std::vector<std::byte>& outDdsData) const;
+	void CreateBoxGeometry(float halfWidth, float halfHeight, float halfDepth, RenderableSceneGeometryData& outGeometry)  const;
+
+	SceneObjectLocation NextObjectLocation();
+
+private:
+	StressSceneConfig mConfig;
+
+	uint64_t mRandomState;
+};
\ No newline at end of file
@@ -0,0 +1,251 @@
+#include "SceneObjectStore.hpp"
+#include <cassert>
+
+namespace
+{
+	template<typename T>
+	void SwapRemove(std::vector<T>& column, size_t rowIndex)
+	{
+		if(column.empty())
+		{
+			return;
+		}
+
+		column[rowIndex] = column.back();
+		column.pop_back();
+	}
+}
+
+SceneObjectStore::SceneObjectStore()
+{
+}
+
+SceneObjectStore::~SceneObjectStore()
+{
+}
+
+SceneObjectId SceneObjectStore::CreateObject(uint32_t componentMask, const SceneObjectLocation& location, RenderableSceneObjectHandle renderableHandle)
+{
+	uint32_t              archetypeIndex = GetOrCreateArchetype(componentMask);
+	SceneObjectArchetype& archetype      = mArchetypes[archetypeIndex];
+
+	uint32_t slotIndex = (uint32_t)mObjectSlots.size();
+	if(!mFreeSlotIndices.empty())
+	{
+		slotIndex = mFreeSlotIndices.back();
+		mFreeSlotIndices.pop_back();
+	}
+	else
+	{
+		//The last slot index is never used, so that (SceneObjectId)(-1) stays invalid
+		assert(slotIndex < SceneObjectSlotIndexMask);
+		mObjectSlots.push_back(ObjectSlot
+		{
+			.ArchetypeIndex = FreeSlotArchetypeIndex,
+			.RowIndex       = 0,
+			.Generation     = 0
+		});
+	}
+
+	ObjectSlot& objectSlot = mObjectSlots[slotIndex];
+	objectSlot.ArchetypeIndex = archetypeIndex;
+	objectSlot.RowIndex       = (uint32_t)archetype.ObjectIds.size();
+
+	SceneObjectId objectId = MakeSceneObjectId(slotIndex, objectSlot.Generation);
+
+	archetype.Positions.push_back(location.Position);
+	archetype.Rotations.push_back(location.RotationQuaternion);
+	archetype.Scales.push_back(location.Scale);
+	archetype.Flags.push_back(0);
+	archetype.ObjectIds.push_back(objectId);
+
+	if(componentMask & (uint32_t)SceneObjectComponentFlags::Renderable)
+	{
+		archetype.RenderableHandles.push_back(renderableHandle);
+	}
+
+	if(componentMask & (uint32_t)SceneObjectComponentFlags::Rigid)
+	{
+		archetype.PrevStepPositions.push_back(location.Position);
+		archetype.PrevStepRotations.push_back(location.RotationQuaternion);
+		archetype.PrevStepScales.push_back(location.Scale);
+	}
+
+	return objectId;
+}
+
+void SceneObjectStore::DestroyObject(SceneObjectId objectId)
+{
+	assert(IsObjectAlive(objectId));
+
+	uint32_t              slotIndex  = GetSceneObjectSlotIndex(objectId);
+	ObjectSlot            objectSlot = mObjectSlots[slotIndex];
+	SceneObjectArchetype& archetype  = mArchetypes[objectSlot.ArchetypeIndex];
+
+	SceneObjectId movedObjectId = archetype.ObjectIds.back();
+	mObjectSlots[GetSceneObjectSlotIndex(movedObjectId)].RowIndex = objectSlot.RowIndex;
+
+	SwapRemove(archetype.Positions,         objectSlot.RowIndex);
+	SwapRemove(archetype.Rotations,         objectSlot.RowIndex);
+	SwapRemove(archetype.Scales,            objectSlot.RowIndex);
+	SwapRemove(archetype.Flags,             objectSlot.RowIndex);
+	SwapRemove(archetype.ObjectIds,         objectSlot.RowIndex);
+	SwapRemove(archetype.RenderableHandles, objectSlot.RowIndex);
+	SwapRemove(archetype.PrevStepPositions, objectSlot.RowIndex);
+	SwapRemove(archetype.PrevStepRotations, objectSlot.RowIndex);
+	SwapRemove(archetype.PrevStepScales,    objectSlot.RowIndex);
+
+	mObjectSlots[slotIndex].ArchetypeIndex = FreeSlotArchetypeIndex;
+	mObjectSlots[slotIndex].Generation++;
+
+	mFreeSlotIndices.push_back(slotIndex);
+}
+
+bool SceneObjectStore::IsObjectAlive(SceneObjectId objectId) const
+{
+	uint32_t slotIndex = GetSceneObjectSlotIndex(objectId);
+	if(slotIndex >= mObjectSlots.size())
+	{
+		return false;
+	}
+
+	return mObjectSlots[slotIndex].ArchetypeIndex != FreeSlotArchetypeIndex && GetSceneObjectGeneration(objectId) == mObjectSlots[slotIndex].Generation;
+}
+
+void SceneObjectStore::Reserve(uint32_t componentMask, size_t objectCount)
+{
+	SceneObjectArchetype& archetype = mArchetypes[GetOrCreateArchetype(componentMask)];
+
+	size_t newSize = archetype.ObjectIds.size() + objectCount;
+	archetype.Positions.reserve(newSize);
+	archetype.Rotations.reserve(newSize);
+	archetype.Scales.reserve(newSize);
+	archetype.Flags.reserve(newSize);
+	archetype.ObjectIds.reserve(newSize);
+
+	if(componentMask & (uint32_t)SceneObjectComponentFlags::Renderable)
+	{
+		archetype.RenderableHandles.reserve(newSize);
+	}
+
+	if(componentMask & (uint32_t)SceneObjectComponentFlags::Rigid)
+	{
+		archetype.PrevStepPositions.reserve(newSize);
+		archetype.PrevStepRotations.reserve(newSize);
+		archetype.PrevStepScales.reserve(newSize);
+	}
+
+	mObjectSlots.reserve(mObjectSlots.size() + objectCount);
+}
+
+void SceneObjectStore::Clear()
+{
+	mArchetypes.clear();
+	mObjectSlots.clear();
+	mFreeSlotIndices.clear();
+}
+
+SceneObjectLocation SceneObjectStore::GetLocation(SceneObjectId objectId) const
+{
+	assert(IsObjectAlive(objectId));
+
+	ObjectSlot                  objectSlot = mObjectSlots[GetSceneObjectSlotIndex(objectId)];
+	const SceneObjectArchetype& archetype  = mArchetypes[objectSlot.ArchetypeIndex];
+
+	return SceneObjectLocation
+	{
+		.Position           = archetype.Positions[objectSlot.RowIndex],
+		.Scale              = archetype.Scales[objectSlot.RowIndex],
+		.RotationQuaternion = archetype.Rotations[objectSlot.RowIndex]
+	};
+}
+
+RenderableSceneObjectHandle SceneObjectStore::GetRenderableHandle(SceneObjectId objectId) const
+{
+	assert(IsObjectAlive(objectId));
+
+	ObjectSlot                  objectSlot = mObjectSlots[GetSceneObjectSlotIndex(objectId)];
+	const SceneObjectArchetype& archetype  = mArchetypes[objectSlot.ArchetypeIndex];
+
+	if(!(archetype.ComponentMask & (uint32_t)SceneObjectComponentFlags::Renderable))
+	{
+		return (RenderableSceneObjectHandle)(-1);
+	}
+
+	return archetype.RenderableHandles[objectSlot.RowIndex];
+}
+
+void SceneObjectStore::SetLocation(SceneObjectId objectId, const SceneObjectLocation& location)
+{
+	assert(IsObjectAlive(objectId));
+
+	ObjectSlot            objectSlot = mObjectSlots[GetSceneObjectSlotIndex(objectId)];
+	SceneObjectArchetype& archetype  = mArchetypes[objectSlot.ArchetypeIndex];
+
+	archetype.Positions[objectSlot.RowIndex] = location.Position;
+	archetype.Rotations[objectSlot.RowIndex] = location.RotationQuaternion;
+	archetype.Scales[objectSlot.RowIndex]    = location.Scale;
+
+	archetype.Flags[objectSlot.RowIndex] |= (uint32_t)SceneObjectFlags::LocationChanged;
+}
+
+void SceneObjectStore::ClearLocationChangedFlags()
+{
+	for(SceneObjectArchetype& archetype: mArchetypes)
+	{
+		for(uint32_t& flags: archetype.Flags)
+		{
+			flags &= ~(uint32_t)SceneObjectFlags::LocationChanged;
+		}
+	}
+}
+
+void SceneObjectStore::SavePrevStepLocations()
+{
+	for(SceneObjectArchetype& archetype: mArchetypes)
+	{
+		if(archetype.ComponentMask & (uint32_t)SceneObjectComponentFlags::Rigid)
+		{
+			archetype.PrevStepPositions.assign(archetype.Positions.begin(), archetype.Positions.end());
+			archetype.PrevStepRotations.assign(archetype.Rotations.begin(), archetype.Rotations.end());
+			archetype.PrevStepScales.assign(archetype.Scales.begin(), archetype.Scales.end());
+		}
+	}
+}
+
+uint32_t SceneObjectStore::GetArchetypeCount() const
+{
+	return (uint32_t)mArchetypes.size();
+}
+
+SceneObjectArchetype& SceneObjectStore::GetArchetype(uint32_t archetypeIndex)
+{
+	return mArchetypes[archetypeIndex];
+}
+
+const SceneObjectArchetype& SceneObjectStore::GetArchetype(uint32_t archetypeIndex) const
+{
+	return mArchetypes[archetypeIndex];
+}
+
+uint32_t SceneObjectStore::GetObjectCount() const
+{
+	return (uint32_t)(mObjectSlots.size() - mFreeSlotIndices.size());
+}
+
+uint32_t SceneObjectStore::GetOrCreateArchetype(uint32_t componentMask)
+{
+	//There are only a few component sets, a linear search is enough
+	for(uint32_t archetypeIndex = 0; archetypeIndex < (uint32_t)mArchetypes.size(); archetypeIndex++)
+	{
+		if(mArchetypes[archetypeIndex].ComponentMask == componentMask)
+		{
+			return archetypeIndex;
+		}
+	}
+
+	mArchetypes.emplace_back();
+	mArchetypes.back().ComponentMask = componentMask;
+
+	return (uint32_t)(mArchetypes.size() - 1);
+}
\ No newline at end of file
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <DirectXMath.h>
+#include "SceneObjectLocation.hpp"
+#include "../../Rendering/Common/Scene/RenderableSceneMisc.hpp"
+
+//Stays the same when other objects are created or destroyed. The slot index in the low bits and the generation of the slot in the high bits,
+//the generation changes each time the object is destroyed, so the ids of the destroyed objects never refer to the objects that take their slots
+using SceneObjectId = uint32_t;
+
+constexpr uint32_t SceneObjectSlotIndexBitCount = 24;
+constexpr uint32_t SceneObjectSlotIndexMask     = (1u << SceneObjectSlotIndexBitCount) - 1;
+
+inline SceneObjectId MakeSceneObjectId(uint32_t slotIndex, uint32_t generation)
+{
+	return (generation << SceneObjectSlotIndexBitCount) | (slotIndex & SceneObjectSlotIndexMask);
+}
+
+inline uint32_t GetSceneObjectSlotIndex(SceneObjectId objectId)
+{
+	return objectId & SceneObjectSlotIndexMask;
+}
+
+inline uint32_t GetSceneObjectGeneration(SceneObjectId objectId)
+{
+	return objectId >> SceneObjectSlotIndexBitCount;
+}
+
+enum class SceneObjectComponentFlags: uint32_t
+{
+	Renderable = 0x01, //Has a renderable handle
+	Rigid      = 0x02, //Can move after the scene is baked. Keeps the location from before the last simulation step for interpolation
+};
+
+enum class SceneObjectFlags: uint32_t
+{
+	InMotion        = 0x01, //Moved during the last simulation step
+	LocationChanged = 0x02, //The location was set since the last renderable update. Unlike InMotion, also covers the moves in the earlier steps of a frame
+};
+
+//All objects with the same set of components. Every column has one element per object, the columns the component set doesn't need are empty.
+//Rows are not stable, use SceneObjectId to refer to a specific object
+struct SceneObjectArchetype
+{
+	uint32_t ComponentMask;
+
+	std::vector<DirectX::XMFLOAT3> Positions;
+	std::vector<DirectX::XMFLOAT4> Rotations;
+	std::vector<float>             Scales;
+	std::vector<uint32_t>          Flags;
+	std::vector<SceneObjectId>     ObjectIds;
+
+	//Renderable component
+	std::vector<RenderableSceneObjectHandle> RenderableHandles;
+
+	//Rigid component
+	std::vector<DirectX::XMFLOAT3> PrevStepPositions;
+	std::vector<DirectX::XMFLOAT4> PrevStepRotations;
+	std::vector<float>             PrevStepScales;
+};
+
+//Structure-of-arrays storage for scene objects, grouped by component set
+class SceneObjectStore
+{
+	//The archetype index of the free slots
+	static constexpr uint32_t FreeSlotArchetypeIndex = (uint32_t)(-1);
+
+	struct ObjectSlot
+	{
+		uint32_t ArchetypeIndex;
+		uint32_t RowIndex;
+		uint8_t  Generation;
+	};
+
+public:
+	SceneObjectStore();
+	~SceneObjectStore();
+
+	//renderableHandle is only used if the component mask has the Renderable flag
+	SceneObjectId CreateObject(uint32_t componentMask, const SceneObjectLocation& location, RenderableSceneObjectHandle renderableHandle);
+
+	//Moves the last object of the archetype in place of the destroyed one
+	void DestroyObject(SceneObjectId objectId);
+
+	bool IsObjectAlive(SceneObjectId objectId) const;
+
+	void Reserve(uint32_t componentMask, size_t objectCount);
+	void Clear();
+
+	SceneObjectLocation         GetLocation(SceneObjectId objectId)         const;
+	RenderableSceneObjectHandle GetRenderableHandle(SceneObjectId objectId) const;
+
+	//Also sets the LocationChanged flag
+	void SetLocation(SceneObjectId objectId, const SceneObjectLocation& location);
+
+	//For the locations that are known to be already sent to the renderable component
+	void ClearLocationChangedFlags();
+
+	//Copies the current locations of all rigid objects to the previous step columns
+	void SavePrevStepLocations();
+
+	//Archetype pointers are invalidated when a new component set is used for the first time
+	uint32_t                    GetArchetypeCount()                     const;
+	SceneObjectArchetype&       GetArchetype(uint32_t archetypeIndex);
+	const SceneObjectArchetype& GetArchetype(uint32_t archetypeIndex)   const;
+
+	uint32_t GetObjectCount() const;
+
+private:
+	uint32_t GetOrCreateArchetype(uint32_t componentMask);
+
+private:
+	std::vector<SceneObjectArchetype> mArchetypes;
+
+	std::vector<ObjectSlot> mObjectSlots;
+	std::vector<uint32_t>   mFreeSlotIndices;
+};
\ No newline at end of file
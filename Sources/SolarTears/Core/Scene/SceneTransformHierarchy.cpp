@@ -0,0 +1,324 @@
+#include "SceneTransformHierarchy.hpp"
+#include "../ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <latch>
+
+SceneTransformHierarchy::SceneTransformHierarchy(): mUpdateIndex(0), mLastUpdatedNodeCount(0)
+{
+}
+
+SceneTransformHierarchy::~SceneTransformHierarchy()
+{
+}
+
+SceneObjectLocation SceneTransformHierarchy::CombineLocations(const SceneObjectLocation& parentWorldLocation, const SceneObjectLocation& localLocation)
+{
+	//The scale is uniform, so the combination is a location again
+	DirectX::XMVECTOR parentPosition = DirectX::XMLoadFloat3(&parentWorldLocation.Position);
+	DirectX::XMVECTOR parentRotation = DirectX::XMLoadFloat4(&parentWorldLocation.RotationQuaternion);
+	DirectX::XMVECTOR localPosition  = DirectX::XMLoadFloat3(&localLocation.Position);
+	DirectX::XMVECTOR localRotation  = DirectX::XMLoadFloat4(&localLocation.RotationQuaternion);
+
+	DirectX::XMVECTOR worldPosition = DirectX::XMVectorAdd(parentPosition, DirectX::XMVector3Rotate(DirectX::XMVectorScale(localPosition, parentWorldLocation.Scale), parentRotation));
+	DirectX::XMVECTOR worldRotation = DirectX::XMQuaternionMultiply(localRotation, parentRotation);
+
+	SceneObjectLocation worldLocation;
+	worldLocation.Scale = parentWorldLocation.Scale * localLocation.Scale;
+
+	DirectX::XMStoreFloat3(&worldLocation.Position,           worldPosition);
+	DirectX::XMStoreFloat4(&worldLocation.RotationQuaternion, worldRotation);
+
+	return worldLocation;
+}
+
+void SceneTransformHierarchy::AddNode(SceneObjectId objectId, SceneObjectId parentObjectId, const SceneObjectLocation& localLocation)
+{
+	mPendingNodes.push_back(PendingNode
+	{
+		.ObjectId       = objectId,
+		.ParentObjectId = parentObjectId,
+		.LocalLocation  = localLocation
+	});
+}
+
+void SceneTransformHierarchy::Build()
+{
+	//Pending nodes that are not built yet keep their indices, the built ones are moved to the new arrays
+	std::unordered_map<SceneObjectId, uint32_t> pendingNodeIndices;
+	pendingNodeIndices.reserve(mPendingNodes.size());
+	for(uint32_t pendingNodeIndex = 0; pendingNodeIndex < (uint32_t)mPendingNodes.size(); pendingNodeIndex++)
+	{
+		pendingNodeIndices[mPendingNodes[pendingNodeIndex].ObjectId] = pendingNodeIndex;
+	}
+
+	//Children lists as offsets into a single array
+	std::vector<uint32_t> childCounts(mPendingNodes.size() + 1, 0);
+	std::vector<uint32_t> rootPendingIndices;
+	for(uint32_t pendingNodeIndex = 0; pendingNodeIndex < (uint32_t)mPendingNodes.size(); pendingNodeIndex++)
+	{
+		auto parentIt = pendingNodeIndices.find(mPendingNodes[pendingNodeIndex].ParentObjectId);
+		if(parentIt == pendingNodeIndices.end())
+		{
+			assert(mPendingNodes[pendingNodeIndex].ParentObjectId == NoParent);
+			rootPendingIndices.push_back(pendingNodeIndex);
+		}
+		else
+		{
+			childCounts[parentIt->second + 1]++;
+		}
+	}
+
+	std::vector<uint32_t> childOffsets(mPendingNodes.size() + 1, 0);
+	for(size_t pendingNodeIndex = 1; pendingNodeIndex < childOffsets.size(); pendingNodeIndex++)
+	{
+		childOffsets[pendingNodeIndex] = childOffsets[pendingNodeIndex - 1] + childCounts[pendingNodeIndex];
+	}
+
+	std::vector<uint32_t> childPendingIndices(childOffsets.back());
+	std::vector<uint32_t> childWriteOffsets(childOffsets.begin(), childOffsets.end() - 1);
+	for(uint32_t pendingNodeIndex = 0; pendingNodeIndex < (uint32_t)mPendingNodes.size(); pendingNodeIndex++)
+	{
+		auto parentIt = pendingNodeIndices.find(mPendingNodes[pendingNodeIndex].ParentObjectId);
+		if(parentIt != pendingNodeIndices.end())
+		{
+			childPendingIndices[childWriteOffsets[parentIt->second]++] = pendingNodeIndex;
+		}
+	}
+
+	//Breadth-first order. Siblings end up next to each other
+	std::vector<uint32_t> nodeOrder;
+	nodeOrder.reserve(mPendingNodes.size());
+	nodeOrder.insert(nodeOrder.end(), rootPendingIndices.begin(), rootPendingIndices.end());
+
+	mLevelNodeOffsets.clear();
+	mLevelNodeOffsets.push_back(0);
+
+	size_t levelBegin = 0;
+	while(levelBegin < nodeOrder.size())
+	{
+		size_t levelEnd = nodeOrder.size();
+		mLevelNodeOffsets.push_back((uint32_t)levelEnd);
+
+		for(size_t orderIndex = levelBegin; orderIndex < levelEnd; orderIndex++)
+		{
+			uint32_t pendingNodeIndex = nodeOrder[orderIndex];
+			nodeOrder.insert(nodeOrder.end(), childPendingIndices.begin() + childOffsets[pendingNodeIndex], childPendingIndices.begin() + childOffsets[pendingNodeIndex + 1]);
+		}
+
+		levelBegin = levelEnd;
+	}
+
+	assert(nodeOrder.size() == mPendingNodes.size()); //Cycles are not allowed
+
+	size_t nodeCount = nodeOrder.size();
+	mObjectIds.resize(nodeCount);
+	mParentNodeIndices.resize(nodeCount);
+	mLocalPositions.resize(nodeCount);
+	mLocalRotations.resize(nodeCount);
+	mLocalScales.resize(nodeCount);
+	mWorldPositions.resize(nodeCount);
+	mWorldRotations.resize(nodeCount);
+	mWorldScales.resize(nodeCount);
+	mLocalChangedFlags.assign(nodeCount, 1);
+	mWorldChangedUpdateIndices.assign(nodeCount, 0);
+	mLevelLocalChanged.assign(mLevelNodeOffsets.size() - 1, 1);
+
+	mObjectNodeIndices.clear();
+	mObjectNodeIndices.reserve(nodeCount);
+	for(uint32_t nodeIndex = 0; nodeIndex < (uint32_t)nodeCount; nodeIndex++)
+	{
+		const PendingNode& pendingNode = mPendingNodes[nodeOrder[nodeIndex]];
+		mObjectNodeIndices[pendingNode.ObjectId] = nodeIndex;
+
+		mObjectIds[nodeIndex]      = pendingNode.ObjectId;
+		mLocalPositions[nodeIndex] = pendingNode.LocalLocation.Position;
+		mLocalRotations[nodeIndex] = pendingNode.LocalLocation.RotationQuaternion;
+		mLocalScales[nodeIndex]    = pendingNode.LocalLocation.Scale;
+	}
+
+	//The parents always come before the children
+	for(uint32_t nodeIndex = 0; nodeIndex < (uint32_t)nodeCount; nodeIndex++)
+	{
+		const PendingNode& pendingNode = mPendingNodes[nodeOrder[nodeIndex]];
+
+		auto parentIt = mObjectNodeIndices.find(pendingNode.ParentObjectId);
+		mParentNodeIndices[nodeIndex] = (parentIt == mObjectNodeIndices.end()) ? InvalidNodeIndex : parentIt->second;
+	}
+
+	mPendingNodes.clear();
+}
+
+void SceneTransformHierarchy::Clear()
+{
+	mPendingNodes.clear();
+	mObjectNodeIndices.clear();
+
+	mObjectIds.clear();
+	mParentNodeIndices.clear();
+	mLocalPositions.clear();
+	mLocalRotations.clear();
+	mLocalScales.clear();
+	mWorldPositions.clear();
+	mWorldRotations.clear();
+	mWorldScales.clear();
+	mLocalChangedFlags.clear();
+	mWorldChangedUpdateIndices.clear();
+
+	mLevelNodeOffsets.clear();
+	mLevelLocalChanged.clear();
+}
+
+bool SceneTransformHierarchy::Contains(SceneObjectId objectId) const
+{
+	return mObjectNodeIndices.contains(objectId);
+}
+
+void SceneTransformHierarchy::SetLocalLocation(SceneObjectId objectId, const SceneObjectLocation& localLocation)
+{
+	uint32_t nodeIndex = mObjectNodeIndices.at(objectId);
+
+	mLocalPositions[nodeIndex]    = localLocation.Position;
+	mLocalRotations[nodeIndex]    = localLocation.RotationQuaternion;
+	mLocalScales[nodeIndex]       = localLocation.Scale;
+	mLocalChangedFlags[nodeIndex] = 1;
+
+	//The level count is small, a binary search is enough
+	auto levelIt = std::upper_bound(mLevelNodeOffsets.begin(), mLevelNodeOffsets.end(), nodeIndex);
+	mLevelLocalChanged[(levelIt - mLevelNodeOffsets.begin()) - 1] = 1;
+}
+
+void SceneTransformHierarchy::UpdateWorldLocations(ThreadPool* threadPool, SceneObjectStore* objectStore)
+{
+	mUpdateIndex++;
+	mLastUpdatedNodeCount = 0;
+
+	bool prevLevelChanged = false;
+	for(size_t levelIndex = 0; levelIndex + 1 < mLevelNodeOffsets.size(); levelIndex++)
+	{
+		//The whole subtree below an unchanged level is unchanged too, unless it has its own local changes
+		if(!mLevelLocalChanged[levelIndex] && !prevLevelChanged)
+		{
+			continue;
+		}
+
+		uint32_t levelBegin = mLevelNodeOffsets[levelIndex];
+		uint32_t levelEnd   = mLevelNodeOffsets[levelIndex + 1];
+
+		uint32_t levelUpdatedNodeCount = 0;
+		if(threadPool == nullptr || levelEnd - levelBegin <= NodesPerJob)
+		{
+			levelUpdatedNodeCount = UpdateNodeRange(levelBegin, levelEnd, objectStore);
+		}
+		else
+		{
+			//Same as in the frame graph traversal: the main thread takes the last chunk and then waits for the others
+			uint32_t jobCount = (levelEnd - levelBegin + NodesPerJob - 1) / NodesPerJob;
+
+			std::latch            levelLatch(jobCount - 1);
+			std::atomic<uint32_t> updatedNodeCount = 0;
+
+			struct JobData
+			{
+				SceneTransformHierarchy* Hierarchy;
+				SceneObjectStore*        ObjectStore;
+				std::latch*              Waitable;
+				std::atomic<uint32_t>*   UpdatedNodeCount;
+				uint32_t                 NodeBegin;
+				uint32_t                 NodeEnd;
+			};
+
+			for(uint32_t jobIndex = 0; jobIndex < jobCount - 1; jobIndex++)
+			{
+				JobData jobData =
+				{
+					.Hierarchy        = this,
+					.ObjectStore      = objectStore,
+					.Waitable         = &levelLatch,
+					.UpdatedNodeCount = &updatedNodeCount,
+					.NodeBegin        = levelBegin + jobIndex * NodesPerJob,
+					.NodeEnd          = levelBegin + (jobIndex + 1) * NodesPerJob
+				};
+
+				auto jobFunc = [](void* userData, [[maybe_unused]] uint32_t userDataSize)
+				{
+					JobData* threadJobData = reinterpret_cast<JobData*>(userData);
+
+					uint32_t jobUpdatedNodeCount = threadJobData->Hierarchy->UpdateNodeRange(threadJobData->NodeBegin, threadJobData->NodeEnd, threadJobData->ObjectStore);
+					threadJobData->UpdatedNodeCount->fetch_add(jobUpdatedNodeCount, std::memory_order_relaxed);
+
+					threadJobData->Waitable->count_down();
+				};
+
+				threadPool->EnqueueWork(jobFunc, &jobData, sizeof(JobData));
+			}
+
+			levelUpdatedNodeCount = UpdateNodeRange(levelBegin + (jobCount - 1) * NodesPerJob, levelEnd, objectStore);
+
+			levelLatch.wait();
+			levelUpdatedNodeCount += updatedNodeCount.load(std::memory_order_relaxed);
+		}
+
+		mLevelLocalChanged[levelIndex] = 0;
+
+		prevLevelChanged       = (levelUpdatedNodeCount > 0);
+		mLastUpdatedNodeCount += levelUpdatedNodeCount;
+	}
+}
+
+uint32_t SceneTransformHierarchy::GetNodeCount() const
+{
+	return (uint32_t)mObjectIds.size();
+}
+
+uint32_t SceneTransformHierarchy::GetLastUpdatedNodeCount() const
+{
+	return mLastUpdatedNodeCount;
+}
+
+uint32_t SceneTransformHierarchy::UpdateNodeRange(uint32_t nodeBegin, uint32_t nodeEnd, SceneObjectStore* objectStore)
+{
+	//Different nodes write to different rows of the store, so the ranges can be processed in parallel
+	uint32_t updatedNodeCount = 0;
+	for(uint32_t nodeIndex = nodeBegin; nodeIndex < nodeEnd; nodeIndex++)
+	{
+		uint32_t parentNodeIndex = mParentNodeIndices[nodeIndex];
+		bool     parentChanged   = (parentNodeIndex != InvalidNodeIndex) && (mWorldChangedUpdateIndices[parentNodeIndex] == mUpdateIndex);
+		if(!mLocalChangedFlags[nodeIndex] && !parentChanged)
+		{
+			continue;
+		}
+
+		SceneObjectLocation worldLocation =
+		{
+			.Position           = mLocalPositions[nodeIndex],
+			.Scale              = mLocalScales[nodeIndex],
+			.RotationQuaternion = mLocalRotations[nodeIndex]
+		};
+
+		if(parentNodeIndex != InvalidNodeIndex)
+		{
+			SceneObjectLocation parentWorldLocation =
+			{
+				.Position           = mWorldPositions[parentNodeIndex],
+				.Scale              = mWorldScales[parentNodeIndex],
+				.RotationQuaternion = mWorldRotations[parentNodeIndex]
+			};
+
+			worldLocation = CombineLocations(parentWorldLocation, worldLocation);
+		}
+
+		mWorldPositions[nodeIndex] = worldLocation.Position;
+		mWorldRotations[nodeIndex] = worldLocation.RotationQuaternion;
+		mWorldScales[nodeIndex]    = worldLocation.Scale;
+
+		mLocalChangedFlags[nodeIndex]         = 0;
+		mWorldChangedUpdateIndices[nodeIndex] = mUpdateIndex;
+
+		objectStore->SetLocation(mObjectIds[nodeIndex], worldLocation);
+		updatedNodeCount++;
+	}
+
+	return updatedNodeCount;
+}
\ No newline at end of file
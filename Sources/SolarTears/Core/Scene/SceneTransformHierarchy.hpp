@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include <DirectXMath.h>
+#include "SceneObjectLocation.hpp"
+#include "SceneObjectStore.hpp"
+
+class ThreadPool;
+
+//Parent-child attachments between scene objects. The nodes are stored breadth-first, so each level of the hierarchy
+//is a contiguous range and all parents of a level are processed before it. Only the levels with changes are visited,
+//and only the nodes whose local location or any ancestor changed get their world locations recomputed
+class SceneTransformHierarchy
+{
+	static constexpr uint32_t InvalidNodeIndex = (uint32_t)(-1);
+	static constexpr uint32_t NodesPerJob      = 4096;
+
+	struct PendingNode
+	{
+		SceneObjectId       ObjectId;
+		SceneObjectId       ParentObjectId;
+		SceneObjectLocation LocalLocation;
+	};
+
+public:
+	static constexpr SceneObjectId NoParent = (SceneObjectId)(-1);
+
+public:
+	SceneTransformHierarchy();
+	~SceneTransformHierarchy();
+
+	//World location of a child, given the world location of the parent and the location relative to it
+	static SceneObjectLocation CombineLocations(const SceneObjectLocation& parentWorldLocation, const SceneObjectLocation& localLocation);
+
+	//The nodes can be added in any order, the parents have to be added before Build() is called
+	void AddNode(SceneObjectId objectId, SceneObjectId parentObjectId, const SceneObjectLocation& localLocation);
+
+	//Sorts the added nodes breadth-first. All nodes are dirty after building
+	void Build();
+
+	void Clear();
+
+	bool Contains(SceneObjectId objectId) const;
+
+	//Marks the node dirty. The world locations are recomputed on the next UpdateWorldLocations call
+	void SetLocalLocation(SceneObjectId objectId, const SceneObjectLocation& localLocation);
+
+	//Recomputes the world locations of the dirty subtrees and writes them to the store. Each level is split between
+	//the thread pool workers if it's big enough. threadPool can be nullptr.
+	//The store marks the written objects as LocationChanged, so the children moved in any step of the frame get to the renderable update
+	void UpdateWorldLocations(ThreadPool* threadPool, SceneObjectStore* objectStore);
+
+	uint32_t GetNodeCount()            const;
+	uint32_t GetLastUpdatedNodeCount() const;
+
+private:
+	//Returns the number of nodes with recomputed world locations
+	uint32_t UpdateNodeRange(uint32_t nodeBegin, uint32_t nodeEnd, SceneObjectStore* objectStore);
+
+private:
+	std::vector<PendingNode> mPendingNodes;
+
+	std::unordered_map<SceneObjectId, uint32_t> mObjectNodeIndices;
+
+	//Nodes, in breadth-first order
+	std::vector<SceneObjectId>     mObjectIds;
+	std::vector<uint32_t>          mParentNodeIndices;
+	std::vector<DirectX::XMFLOAT3> mLocalPositions;
+	std::vector<DirectX::XMFLOAT4> mLocalRotations;
+	std::vector<float>             mLocalScales;
+	std::vector<DirectX::XMFLOAT3> mWorldPositions;
+	std::vector<DirectX::XMFLOAT4> mWorldRotations;
+	std::vector<float>             mWorldScales;
+	std::vector<uint8_t>           mLocalChangedFlags;
+	std::vector<uint32_t>          mWorldChangedUpdateIndices; //The index of the last update that changed the world location
+
+	//Levels
+	std::vector<uint32_t> mLevelNodeOffsets;  //One more than the level count, the last one is the node count
+	std::vector<uint8_t>  mLevelLocalChanged; //Whether any node of the level has a changed local location
+
+	uint32_t mUpdateIndex;
+	uint32_t mLastUpdatedNodeCount;
+};
\ No newline at end of file
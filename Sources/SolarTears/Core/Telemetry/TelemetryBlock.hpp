@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+
+//The data the engine publishes every frame. The layout is shared with external readers, so new fields should only be appended together with a version bump
+struct TelemetryFrameData
+{
+	uint64_t FrameIndex;
+	float    TimeSeconds;
+	float    FrameTimeMs;
+
+	uint64_t DrawCount;
+	uint64_t TriangleCount;
+	uint64_t BarrierCount;
+	uint64_t DescriptorSetBindCount;
+	uint64_t UploadByteCount;
+
+	uint64_t ProcessWorkingSetBytes;
+	uint64_t ProcessPrivateBytes;
+
+	uint32_t LogQueueDepth;
+	uint32_t JobQueueDepth;
+};
+
+//The block that lives in shared memory. FrameData is protected by a seqlock: the sequence number is odd while the writer updates the data
+struct alignas(64) TelemetryBlock
+{
+	static constexpr uint32_t Magic   = 0x4d545453; //"STTM"
+	static constexpr uint32_t Version = 1;
+
+	uint32_t              BlockMagic;
+	uint32_t              BlockVersion;
+	uint32_t              WriterProcessId;
+	std::atomic<uint32_t> Sequence;
+
+	TelemetryFrameData FrameData;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free); //Lock-based atomics can't be shared between processes
+
+namespace Telemetry
+{
+	//Only one writer is allowed. Never waits for the readers
+	inline void WriteFrameData(TelemetryBlock* block, const TelemetryFrameData& frameData);
+
+	//Returns false if the writer was updating the block during each of the attempts
+	inline bool ReadFrameData(const TelemetryBlock* block, TelemetryFrameData* outFrameData, uint32_t maxAttempts);
+}
+
+#include "TelemetryBlock.inl"
\ No newline at end of file
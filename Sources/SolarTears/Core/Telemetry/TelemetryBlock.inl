@@ -0,0 +1,37 @@
+#include <cstring>
+
+inline void Telemetry::WriteFrameData(TelemetryBlock* block, const TelemetryFrameData& frameData)
+{
+	uint32_t sequence = block->Sequence.load(std::memory_order_relaxed);
+
+	block->Sequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	memcpy(&block->FrameData, &frameData, sizeof(TelemetryFrameData));
+
+	block->Sequence.store(sequence + 2, std::memory_order_release);
+}
+
+inline bool Telemetry::ReadFrameData(const TelemetryBlock* block, TelemetryFrameData* outFrameData, uint32_t maxAttempts)
+{
+	for(uint32_t attempt = 0; attempt < maxAttempts; attempt++)
+	{
+		uint32_t sequenceBefore = block->Sequence.load(std::memory_order_acquire);
+		if(sequenceBefore & 1)
+		{
+			continue;
+		}
+
+		memcpy(outFrameData, &block->FrameData, sizeof(TelemetryFrameData));
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		uint32_t sequenceAfter = block->Sequence.load(std::memory_order_relaxed);
+
+		if(sequenceBefore == sequenceAfter)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
\ No newline at end of file
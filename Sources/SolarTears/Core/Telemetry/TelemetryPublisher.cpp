@@ -0,0 +1,107 @@
+#include "TelemetryPublisher.hpp"
+#include "TelemetryBlock.hpp"
+#include "../Timer.hpp"
+#include "../FrameCounter.hpp"
+#include "../ThreadPool.hpp"
+#include "../../Logging/LoggerQueue.hpp"
+#include "../../Rendering/Common/RenderStatistics.hpp"
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <Psapi.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdio>
+#endif
+
+TelemetryPublisher::TelemetryPublisher(LoggerQueue* logger)
+{
+	mSharedMemory = std::make_unique<TelemetrySharedMemory>();
+	mBlock        = mSharedMemory->Create();
+
+	if(mBlock == nullptr)
+	{
+		logger->PostLogMessage("Telemetry: failed to create the shared memory block (is another instance running?), telemetry is disabled");
+	}
+
+#ifndef _WIN32
+	mStatmFileDescriptor = open("/proc/self/statm", O_RDONLY);
+#endif
+}
+
+TelemetryPublisher::~TelemetryPublisher()
+{
+#ifndef _WIN32
+	if(mStatmFileDescriptor >= 0)
+	{
+		close(mStatmFileDescriptor);
+	}
+#endif
+}
+
+void TelemetryPublisher::PublishFrame(const FrameCounter* frameCounter, const Timer* timer, const RenderStatistics* renderStatistics, const LoggerQueue* loggerQueue, const ThreadPool* threadPool)
+{
+	if(mBlock == nullptr)
+	{
+		return;
+	}
+
+	const RenderStatisticsCounters& frameCounters = renderStatistics->GetLastFrameCounters();
+
+	TelemetryFrameData frameData =
+	{
+		.FrameIndex             = frameCounter->GetFrameCount(),
+		.TimeSeconds            = timer->GetCurrTime(),
+		.FrameTimeMs            = timer->GetDeltaTime() * 1000.0f,
+		.DrawCount              = frameCounters.DrawCount,
+		.TriangleCount          = frameCounters.TriangleCount,
+		.BarrierCount           = frameCounters.BarrierCount,
+		.DescriptorSetBindCount = frameCounters.DescriptorSetBindCount,
+		.UploadByteCount        = frameCounters.UploadByteCount,
+		.ProcessWorkingSetBytes = 0,
+		.ProcessPrivateBytes    = 0,
+		.LogQueueDepth          = loggerQueue->GetQueuedMessageCount(),
+		.JobQueueDepth          = threadPool->GetQueuedJobCount()
+	};
+
+	QueryProcessMemory(&frameData.ProcessWorkingSetBytes, &frameData.ProcessPrivateBytes);
+
+	Telemetry::WriteFrameData(mBlock, frameData);
+}
+
+void TelemetryPublisher::QueryProcessMemory(uint64_t* outWorkingSetBytes, uint64_t* outPrivateBytes)
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS_EX memoryCounters = {};
+	if(GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&memoryCounters), sizeof(PROCESS_MEMORY_COUNTERS_EX)))
+	{
+		*outWorkingSetBytes = memoryCounters.WorkingSetSize;
+		*outPrivateBytes    = memoryCounters.PrivateUsage;
+	}
+#else
+	if(mStatmFileDescriptor < 0)
+	{
+		return;
+	}
+
+	//statm is a single line of page counts: total size, resident, shared, text, lib, data, dirty
+	char statmLine[128];
+	ssize_t readSize = pread(mStatmFileDescriptor, statmLine, sizeof(statmLine) - 1, 0);
+	if(readSize <= 0)
+	{
+		return;
+	}
+
+	statmLine[readSize] = '\0';
+
+	unsigned long long totalPages = 0, residentPages = 0, sharedPages = 0, textPages = 0, libPages = 0, dataPages = 0;
+	if(sscanf(statmLine, "%llu %llu %llu %llu %llu %llu", &totalPages, &residentPages, &sharedPages, &textPages, &libPages, &dataPages) == 6)
+	{
+		uint64_t pageSize = (uint64_t)sysconf(_SC_PAGESIZE);
+
+		*outWorkingSetBytes = residentPages * pageSize;
+		*outPrivateBytes    = dataPages     * pageSize;
+	}
+#endif
+}
\ No newline at end of file
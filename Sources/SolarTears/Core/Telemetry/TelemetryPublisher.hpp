@@ -0,0 +1,32 @@
+#pragma once
+
+#include <memory>
+#include "TelemetrySharedMemory.hpp"
+
+class Timer;
+class FrameCounter;
+class LoggerQueue;
+class ThreadPool;
+class RenderStatistics;
+
+//Publishes per-frame engine telemetry to shared memory for external monitoring tools
+class TelemetryPublisher
+{
+public:
+	TelemetryPublisher(LoggerQueue* logger);
+	~TelemetryPublisher();
+
+	//Should be called once per frame on the main thread, after the render statistics are gathered. Never blocks
+	void PublishFrame(const FrameCounter* frameCounter, const Timer* timer, const RenderStatistics* renderStatistics, const LoggerQueue* loggerQueue, const ThreadPool* threadPool);
+
+private:
+	void QueryProcessMemory(uint64_t* outWorkingSetBytes, uint64_t* outPrivateBytes);
+
+private:
+	std::unique_ptr<TelemetrySharedMemory> mSharedMemory;
+	TelemetryBlock*                        mBlock;
+
+#ifndef _WIN32
+	int mStatmFileDescriptor;
+#endif
+};
\ No newline at end of file
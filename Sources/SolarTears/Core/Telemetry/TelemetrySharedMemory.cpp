@@ -0,0 +1,216 @@
+#include "TelemetrySharedMemory.hpp"
+#include "TelemetryBlock.hpp"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <cerrno>
+#endif
+
+#include <new>
+
+namespace
+{
+#ifdef _WIN32
+	constexpr wchar_t TelemetryRegionName[] = L"Local\\SolarTearsTelemetry";
+#else
+	constexpr char TelemetryRegionName[] = "/SolarTearsTelemetry";
+
+	//POSIX regions outlive the process that created them. A region is only considered stale if it holds a valid block whose writer is gone,
+	//a region that is still being initialized by another instance is left alone
+	bool IsStaleRegion()
+	{
+		int fileDescriptor = shm_open(TelemetryRegionName, O_RDONLY, 0);
+		if(fileDescriptor < 0)
+		{
+			return false;
+		}
+
+		bool isStale = false;
+
+		struct stat regionStat;
+		if(fstat(fileDescriptor, &regionStat) == 0 && (size_t)regionStat.st_size >= sizeof(TelemetryBlock))
+		{
+			void* mappedData = mmap(nullptr, sizeof(TelemetryBlock), PROT_READ, MAP_SHARED, fileDescriptor, 0);
+			if(mappedData != MAP_FAILED)
+			{
+				const TelemetryBlock* block = reinterpret_cast<const TelemetryBlock*>(mappedData);
+				if(block->BlockMagic == TelemetryBlock::Magic && block->BlockVersion == TelemetryBlock::Version)
+				{
+					isStale = (kill((pid_t)block->WriterProcessId, 0) != 0 && errno == ESRCH);
+				}
+
+				munmap(mappedData, sizeof(TelemetryBlock));
+			}
+		}
+
+		close(fileDescriptor);
+		return isStale;
+	}
+#endif
+}
+
+TelemetrySharedMemory::TelemetrySharedMemory()
+{
+#ifdef _WIN32
+	mMappingHandle = nullptr;
+#else
+	mFileDescriptor = -1;
+	mIsOwner        = false;
+#endif
+
+	mMappedData = nullptr;
+}
+
+TelemetrySharedMemory::~TelemetrySharedMemory()
+{
+	Close();
+}
+
+TelemetryBlock* TelemetrySharedMemory::Create()
+{
+	Close();
+
+#ifdef _WIN32
+	mMappingHandle = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, (DWORD)sizeof(TelemetryBlock), TelemetryRegionName);
+	if(mMappingHandle == nullptr)
+	{
+		return nullptr;
+	}
+
+	if(GetLastError() == ERROR_ALREADY_EXISTS)
+	{
+		//Another engine instance is publishing, don't write into its block
+		Close();
+		return nullptr;
+	}
+
+	mMappedData = MapViewOfFile(mMappingHandle, FILE_MAP_WRITE, 0, 0, sizeof(TelemetryBlock));
+	uint32_t processId = GetCurrentProcessId();
+#else
+	//O_EXCL makes sure the region belongs to this instance only, so Close() never unlinks the region of another running engine
+	mFileDescriptor = shm_open(TelemetryRegionName, O_CREAT | O_EXCL | O_RDWR, 0644);
+	if(mFileDescriptor < 0 && errno == EEXIST && IsStaleRegion())
+	{
+		shm_unlink(TelemetryRegionName);
+		mFileDescriptor = shm_open(TelemetryRegionName, O_CREAT | O_EXCL | O_RDWR, 0644);
+	}
+
+	if(mFileDescriptor < 0)
+	{
+		return nullptr;
+	}
+
+	mIsOwner = true;
+	if(ftruncate(mFileDescriptor, sizeof(TelemetryBlock)) != 0)
+	{
+		Close();
+		return nullptr;
+	}
+
+	mMappedData = mmap(nullptr, sizeof(TelemetryBlock), PROT_READ | PROT_WRITE, MAP_SHARED, mFileDescriptor, 0);
+	if(mMappedData == MAP_FAILED)
+	{
+		mMappedData = nullptr;
+	}
+
+	uint32_t processId = (uint32_t)getpid();
+#endif
+
+	if(mMappedData == nullptr)
+	{
+		Close();
+		return nullptr;
+	}
+
+	TelemetryBlock* block = new(mMappedData) TelemetryBlock;
+	block->BlockMagic      = TelemetryBlock::Magic;
+	block->BlockVersion    = TelemetryBlock::Version;
+	block->WriterProcessId = processId;
+	block->FrameData       = {};
+	block->Sequence.store(0, std::memory_order_release);
+
+	return block;
+}
+
+const TelemetryBlock* TelemetrySharedMemory::Open()
+{
+	Close();
+
+#ifdef _WIN32
+	mMappingHandle = OpenFileMappingW(FILE_MAP_READ, FALSE, TelemetryRegionName);
+	if(mMappingHandle == nullptr)
+	{
+		return nullptr;
+	}
+
+	mMappedData = MapViewOfFile(mMappingHandle, FILE_MAP_READ, 0, 0, sizeof(TelemetryBlock));
+#else
+	mFileDescriptor = shm_open(TelemetryRegionName, O_RDONLY, 0);
+	if(mFileDescriptor < 0)
+	{
+		return nullptr;
+	}
+
+	mMappedData = mmap(nullptr, sizeof(TelemetryBlock), PROT_READ, MAP_SHARED, mFileDescriptor, 0);
+	if(mMappedData == MAP_FAILED)
+	{
+		mMappedData = nullptr;
+	}
+#endif
+
+	if(mMappedData == nullptr)
+	{
+		Close();
+		return nullptr;
+	}
+
+	const TelemetryBlock* block = reinterpret_cast<const TelemetryBlock*>(mMappedData);
+	if(block->BlockMagic != TelemetryBlock::Magic || block->BlockVersion != TelemetryBlock::Version)
+	{
+		Close();
+		return nullptr;
+	}
+
+	return block;
+}
+
+void TelemetrySharedMemory::Close()
+{
+#ifdef _WIN32
+	if(mMappedData != nullptr)
+	{
+		UnmapViewOfFile(mMappedData);
+		mMappedData = nullptr;
+	}
+
+	if(mMappingHandle != nullptr)
+	{
+		CloseHandle(mMappingHandle);
+		mMappingHandle = nullptr;
+	}
+#else
+	if(mMappedData != nullptr)
+	{
+		munmap(mMappedData, sizeof(TelemetryBlock));
+		mMappedData = nullptr;
+	}
+
+	if(mFileDescriptor >= 0)
+	{
+		close(mFileDescriptor);
+		mFileDescriptor = -1;
+	}
+
+	if(mIsOwner)
+	{
+		shm_unlink(TelemetryRegionName);
+		mIsOwner = false;
+	}
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+
+struct TelemetryBlock;
+
+//Named shared memory region that holds the telemetry block. Backed by a file mapping on Windows and by shm_open on POSIX systems
+class TelemetrySharedMemory
+{
+public:
+	TelemetrySharedMemory();
+	~TelemetrySharedMemory();
+
+	//Creates the region and initializes the block header. Returns nullptr on failure, including when another engine instance already owns the region
+	TelemetryBlock* Create();
+
+	//Opens the region created by a running engine. Returns nullptr if there is none
+	const TelemetryBlock* Open();
+
+private:
+	void Close();
+
+private:
+#ifdef _WIN32
+	void* mMappingHandle;
+#else
+	int  mFileDescriptor;
+	bool mIsOwner;
+#endif
+
+	void* mMappedData;
+};
\ No newline at end of file
@@ -1,10 +1,10 @@
 #include "ThreadPool.hpp"
 
-#include <Windows.h>
 #include <string>
 #include <cassert>
+#include <cstring>
 
-ThreadPool::ThreadPool(uint_fast16_t numOfThreads): mQueueMutexes(numOfThreads), mThreadQueues(numOfThreads), mThreadFinishFlags(numOfThreads), mLastTaskedThread(0)
+ThreadPool::ThreadPool(uint_fast16_t numOfThreads): mQueueMutexes(numOfThreads), mThreadQueues(numOfThreads), mThreadFinishFlags(numOfThreads), mLastTaskedThread(0), mQueuedJobCount(0)
 {
 	static_assert(sizeof(JobParameters) == 64);
 
@@ -36,6 +36,7 @@ ThreadPool::ThreadPool(uint_fast16_t numOfThreads): mQueueMutexes(numOfThreads),
 					//Take the task and dispatch it
 					JobParameters jobParams = threadQueue.front();
 					threadQueue.pop();
+					mQueuedJobCount.fetch_sub(1, std::memory_order_relaxed);
 
 					mQueueMutexes[currentQueue].unlock();	
 					jobParams.JobFunction(jobParams.AdditionalData, jobParams.AdditionalDataSize);
@@ -76,11 +77,16 @@ uint32_t ThreadPool::GetWorkerThreadCount() const
 	return uint32_t(mThreads.size());
 }
 
+uint32_t ThreadPool::GetQueuedJobCount() const
+{
+	return mQueuedJobCount.load(std::memory_order_relaxed);
+}
+
 void ThreadPool::EnqueueWork(JobFunc func, void* userData, size_t userDataSize)
 {
-	assert(userDataSize < sizeof(JobParameters::AdditionalData));
+	assert(userDataSize <= sizeof(JobParameters::AdditionalData));
 
-	size_t currentQueue = (mLastTaskedThread + 1) % mQueueMutexes.size();
+	size_t currentQueue = (mLastTaskedThread.load(std::memory_order_relaxed) + 1) % mQueueMutexes.size();
 	while(!mQueueMutexes[currentQueue].try_lock())
 	{
 		currentQueue = (currentQueue + 1) % mQueueMutexes.size();
@@ -89,6 +95,8 @@ void ThreadPool::EnqueueWork(JobFunc func, void* userData, size_t userDataSize)
 	mThreadQueues[currentQueue].push(JobParameters{.JobFunction = func, .AdditionalDataSize = (uint32_t)userDataSize});
 	memcpy(mThreadQueues[currentQueue].back().AdditionalData, userData, userDataSize);
 
+	mQueuedJobCount.fetch_add(1, std::memory_order_relaxed);
+
 	mQueueMutexes[currentQueue].unlock();
-	mLastTaskedThread = currentQueue;
+	mLastTaskedThread.store(currentQueue, std::memory_order_relaxed);
 }
\ No newline at end of file
@@ -5,6 +5,8 @@
 #include <queue>
 #include <mutex>
 #include <condition_variable>
+#include <atomic>
+#include <cstddef>
 
 //Based on https://vorbrodt.blog/2019/02/26/better-code-concurrency/
 class ThreadPool
@@ -15,7 +17,9 @@ class ThreadPool
 	{
 		JobFunc   JobFunction;
 		uint32_t  AdditionalDataSize;
-		std::byte AdditionalData[52];
+
+		//The jobs read their data in place as structures of pointers, so it has to be aligned for any type
+		alignas(std::max_align_t) std::byte AdditionalData[48];
 	};
 
 public:
@@ -26,6 +30,9 @@ public:
 
 	uint32_t GetWorkerThreadCount() const;
 
+	//The number of enqueued jobs not yet picked up by the workers. Approximate, but never blocks
+	uint32_t GetQueuedJobCount() const;
+
 	void EnqueueWork(JobFunc func, void* userData, size_t userDataSize);
 
 private:
@@ -33,6 +40,8 @@ private:
 	std::vector<std::queue<JobParameters>> mThreadQueues;
 	std::vector<std::mutex>                mQueueMutexes;
 
-	size_t                        mLastTaskedThread;
+	std::atomic<size_t>           mLastTaskedThread; //Only a hint for spreading the jobs, can be updated from several producer threads at once
 	std::vector<std::atomic_bool> mThreadFinishFlags;
+
+	std::atomic<uint32_t> mQueuedJobCount;
 };
\ No newline at end of file
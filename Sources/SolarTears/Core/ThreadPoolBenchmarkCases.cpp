@@ -0,0 +1,187 @@
+#include "MicroBenchmark.hpp"
+#include "ThreadPool.hpp"
+#include <atomic>
+#include <cassert>
+#include <latch>
+#include <memory>
+#include <thread>
+#include <vector>
+
+//The argument of each benchmark is the thread count. All of them check that every enqueued job has run,
+//so building them with -fsanitize=thread and running "-microbenchmark -filter ThreadPool" also works as a stress test
+namespace
+{
+	struct CountdownJobData
+	{
+		std::latch* Waitable;
+	};
+
+	struct CounterJobData
+	{
+		std::atomic<uint64_t>* CompletedJobCount;
+		std::latch*            Waitable;
+		uint32_t               WorkAmount;
+	};
+
+	void CountdownJob(void* userData, [[maybe_unused]] uint32_t userDataSize)
+	{
+		CountdownJobData* jobData = reinterpret_cast<CountdownJobData*>(userData);
+		jobData->Waitable->count_down();
+	}
+
+	void CounterJob(void* userData, [[maybe_unused]] uint32_t userDataSize)
+	{
+		CounterJobData* jobData = reinterpret_cast<CounterJobData*>(userData);
+
+		//Busy work that the compiler can't remove
+		uint32_t value = jobData->WorkAmount;
+		for(uint32_t workIndex = 0; workIndex < jobData->WorkAmount; workIndex++)
+		{
+			value = value * 1664525u + 1013904223u;
+		}
+
+		MicroBenchmarkState::DoNotOptimize(value);
+
+		jobData->CompletedJobCount->fetch_add(1, std::memory_order_relaxed);
+		jobData->Waitable->count_down();
+	}
+
+	//Enqueues many jobs that do nothing, measures the overhead of the queues themselves
+	void BenchmarkEmptyJobThroughput(MicroBenchmarkState& state)
+	{
+		const uint32_t jobCount = 1024;
+
+		ThreadPool threadPool((uint_fast16_t)state.GetArgument());
+		while(state.KeepRunning())
+		{
+			std::latch jobLatch(jobCount);
+
+			CountdownJobData jobData = {.Waitable = &jobLatch};
+			for(uint32_t jobIndex = 0; jobIndex < jobCount; jobIndex++)
+			{
+				threadPool.EnqueueWork(CountdownJob, &jobData, sizeof(CountdownJobData));
+			}
+
+			jobLatch.wait();
+		}
+
+		state.SetItemsProcessed(state.GetIterationCount() * jobCount);
+	}
+
+	//One job per worker and a wait for all of them, the same pattern the frame graphs use in Traverse
+	void BenchmarkFanOutFanIn(MicroBenchmarkState& state)
+	{
+		ThreadPool threadPool((uint_fast16_t)state.GetArgument());
+
+		uint32_t jobCount = threadPool.GetWorkerThreadCount();
+		while(state.KeepRunning())
+		{
+			std::latch jobLatch(jobCount);
+
+			CountdownJobData jobData = {.Waitable = &jobLatch};
+			for(uint32_t jobIndex = 0; jobIndex < jobCount; jobIndex++)
+			{
+				threadPool.EnqueueWork(CountdownJob, &jobData, sizeof(CountdownJobData));
+			}
+
+			jobLatch.wait();
+		}
+
+		state.SetItemsProcessed(state.GetIterationCount());
+	}
+
+	//Several threads enqueue at the same time. The argument is the producer count, the worker count is fixed
+	void BenchmarkProducerContention(MicroBenchmarkState& state)
+	{
+		const uint32_t jobsPerProducer = 1024;
+		const uint32_t workerCount     = 4;
+
+		uint32_t producerCount = (uint32_t)state.GetArgument();
+		uint32_t jobCount      = producerCount * jobsPerProducer;
+
+		ThreadPool threadPool(workerCount);
+		while(state.KeepRunning())
+		{
+			std::latch            jobLatch(jobCount);
+			std::atomic<uint64_t> completedJobCount = 0;
+
+			CounterJobData jobData =
+			{
+				.CompletedJobCount = &completedJobCount,
+				.Waitable          = &jobLatch,
+				.WorkAmount        = 0
+			};
+
+			std::vector<std::thread> producers;
+			producers.reserve(producerCount);
+			for(uint32_t producerIndex = 0; producerIndex < producerCount; producerIndex++)
+			{
+				producers.emplace_back([&threadPool, &jobData]()
+				{
+					for(uint32_t jobIndex = 0; jobIndex < jobsPerProducer; jobIndex++)
+					{
+						threadPool.EnqueueWork(CounterJob, &jobData, sizeof(CounterJobData));
+					}
+				});
+			}
+
+			for(std::thread& producer: producers)
+			{
+				producer.join();
+			}
+
+			jobLatch.wait();
+			assert(completedJobCount.load() == jobCount);
+		}
+
+		state.SetItemsProcessed(state.GetIterationCount() * jobCount);
+	}
+
+	//Mostly small jobs with occasional big ones, so the workers have to steal from each other to stay busy
+	void BenchmarkMixedJobSizes(MicroBenchmarkState& state)
+	{
+		const uint32_t jobCount = 512;
+
+		ThreadPool threadPool((uint_fast16_t)state.GetArgument());
+		while(state.KeepRunning())
+		{
+			std::latch            jobLatch(jobCount);
+			std::atomic<uint64_t> completedJobCount = 0;
+
+			for(uint32_t jobIndex = 0; jobIndex < jobCount; jobIndex++)
+			{
+				uint32_t workAmount = 64;
+				if(jobIndex % 64 == 0)
+				{
+					workAmount = 65536;
+				}
+				else if(jobIndex % 8 == 0)
+				{
+					workAmount = 4096;
+				}
+
+				CounterJobData jobData =
+				{
+					.CompletedJobCount = &completedJobCount,
+					.Waitable          = &jobLatch,
+					.WorkAmount        = workAmount
+				};
+
+				threadPool.EnqueueWork(CounterJob, &jobData, sizeof(CounterJobData));
+			}
+
+			jobLatch.wait();
+			assert(completedJobCount.load() == jobCount);
+		}
+
+		state.SetItemsProcessed(state.GetIterationCount() * jobCount);
+	}
+}
+
+void RegisterThreadPoolMicroBenchmarks(MicroBenchmarkSuite* suite)
+{
+	suite->Register("ThreadPool::EmptyJobThroughput", BenchmarkEmptyJobThroughput, {1, 2, 4, 8, 16});
+	suite->Register("ThreadPool::FanOutFanIn",        BenchmarkFanOutFanIn,        {1, 2, 4, 8, 16});
+	suite->Register("ThreadPool::ProducerContention", BenchmarkProducerContention, {1, 2, 4, 8});
+	suite->Register("ThreadPool::MixedJobSizes",      BenchmarkMixedJobSizes,      {1, 2, 4, 8, 16});
+}
\ No newline at end of file
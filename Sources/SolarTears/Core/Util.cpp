@@ -4,12 +4,16 @@
 
 #ifdef _WIN32
 #include <Windows.h>
+#else
+#include <unistd.h>
 #endif // _WIN32
 
 namespace Utils
 {
 #ifdef _WIN32
-#include "..\Platform\Win32\Win32Util.inl"
+#include "../Platform/Win32/Win32Util.inl"
+#else
+#include "../Platform/Posix/PosixUtil.inl"
 #endif // _WIN32
 
     std::string ToString(std::span<std::string_view> strs)
@@ -2,4 +2,6 @@
 
 #ifdef _WIN32
 #include "../Platform/Win32/Win32Window.hpp"
+#else
+#include "../Platform/Headless/HeadlessWindow.hpp"
 #endif // _WIN32
\ No newline at end of file
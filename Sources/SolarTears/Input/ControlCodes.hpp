@@ -14,6 +14,7 @@ enum class ControlCode : uint8_t
 	Action3,
 
 	Pause,
+	TogglePerformanceHud,
 
 	Count,
 	Nothing = Count,
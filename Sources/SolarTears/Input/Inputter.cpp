@@ -45,6 +45,16 @@ DirectX::XMFLOAT2 Inputter::GetAxis2Delta() const
 	return mCurrentControlState.Axis2Delta;
 }
 
+const ControlState& Inputter::GetControlState() const
+{
+	return mCurrentControlState;
+}
+
+void Inputter::OverrideControlState(const ControlState& controlState)
+{
+	mCurrentControlState = controlState;
+}
+
 void Inputter::SetPaused(bool paused)
 {
 	mMouseControl->SetPaused(paused);
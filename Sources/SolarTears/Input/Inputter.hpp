@@ -23,6 +23,10 @@ public:
 
 	DirectX::XMFLOAT2 GetAxis2Delta() const;
 
+	//The whole state, for capture and replay
+	const ControlState& GetControlState() const;
+	void                OverrideControlState(const ControlState& controlState);
+
 	void SetPaused(bool paused);
 
 	void UpdateControls();
@@ -49,4 +49,5 @@ void KeyboardControl::InitKeyMap()
 	mKeyMap->MapKey(KeyCode::D, ControlCode::MoveRight);
 
 	mKeyMap->MapKey(KeyCode::Esc, ControlCode::Pause);
+	mKeyMap->MapKey(KeyCode::F1,  ControlCode::TogglePerformanceHud);
 }
@@ -2,4 +2,6 @@
 
 #ifdef WIN32
 #include "../Platform/Win32/Win32KeyboardKeyMap.hpp"
+#else
+#include "../Platform/Headless/HeadlessKeyboardKeyMap.hpp"
 #endif //WIN32
\ No newline at end of file
@@ -0,0 +1,15 @@
+#include "ConsoleLogger.hpp"
+#include <cstdio>
+
+ConsoleLogger::ConsoleLogger()
+{
+}
+
+ConsoleLogger::~ConsoleLogger()
+{
+}
+
+void ConsoleLogger::LogMessage(const std::string& message)
+{
+	std::fputs(message.c_str(), stderr);
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "Logger.hpp"
+
+//Writes the messages to stderr, keeping stdout free for tool output
+class ConsoleLogger: public Logger
+{
+public:
+	ConsoleLogger();
+	~ConsoleLogger();
+
+	virtual void LogMessage(const std::string& message);
+};
\ No newline at end of file
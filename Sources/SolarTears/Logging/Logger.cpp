@@ -1,5 +1,5 @@
 #include "Logger.hpp"
-#include "..\Core\Util.hpp"
+#include "../Core/Util.hpp"
 
 Logger::Logger()
 {
@@ -1,5 +1,5 @@
 #include "LoggerQueue.hpp"
-#include "..\Core\Util.hpp"
+#include "../Core/Util.hpp"
 #include "Logger.hpp"
 
 LoggerQueue::LoggerQueue()
@@ -31,4 +31,9 @@ void LoggerQueue::FeedMessages(Logger* logger, uint32_t maxCount)
 		logger->LogMessage(msg);
 		fedCount++;
 	}
+}
+
+uint32_t LoggerQueue::GetQueuedMessageCount() const
+{
+	return (uint32_t)mMessageQueue.size();
 }
\ No newline at end of file
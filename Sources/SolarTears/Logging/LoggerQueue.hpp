@@ -16,6 +16,8 @@ public:
 
 	void FeedMessages(Logger* logger, uint32_t maxCount);
 
+	uint32_t GetQueuedMessageCount() const;
+
 private:
 	std::deque<std::string> mMessageQueue;
 };
\ No newline at end of file
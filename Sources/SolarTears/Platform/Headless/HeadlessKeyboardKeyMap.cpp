@@ -0,0 +1,21 @@
+#include "HeadlessKeyboardKeyMap.hpp"
+#include <algorithm>
+
+KeyboardKeyMap::KeyboardKeyMap()
+{
+	std::fill_n(mNativeKeyMap, 256, ControlCode::Nothing);
+}
+
+KeyboardKeyMap::~KeyboardKeyMap()
+{
+}
+
+void KeyboardKeyMap::MapKey(KeyCode keyCode, ControlCode controlCode)
+{
+	mNativeKeyMap[(uint8_t)keyCode] = controlCode;
+}
+
+ControlCode KeyboardKeyMap::GetControlCode(uint8_t nativeKeyCode) const
+{
+	return mNativeKeyMap[nativeKeyCode];
+}
\ No newline at end of file
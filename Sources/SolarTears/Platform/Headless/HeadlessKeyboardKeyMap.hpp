@@ -0,0 +1,19 @@
+#pragma once
+
+#include "../../Input/ControlCodes.hpp"
+#include "../../Input/KeyboardKeyCodes.hpp"
+
+//Headless windows have no native key codes, the agnostic key codes are used as native ones
+class KeyboardKeyMap
+{
+public:
+	KeyboardKeyMap();
+	~KeyboardKeyMap();
+
+	void MapKey(KeyCode keyCode, ControlCode controlCode);
+
+	ControlCode GetControlCode(uint8_t nativeKeyCode) const;
+
+private:
+	ControlCode mNativeKeyMap[256];
+};
\ No newline at end of file
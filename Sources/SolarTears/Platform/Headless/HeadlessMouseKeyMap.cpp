@@ -0,0 +1,42 @@
+#include "HeadlessMouseKeyMap.hpp"
+
+MouseKeyMap::MouseKeyMap()
+{
+	mLButtonAction = ControlCode::Nothing;
+	mRButtonAction = ControlCode::Nothing;
+	mMButtonAction = ControlCode::Nothing;
+}
+
+MouseKeyMap::~MouseKeyMap()
+{
+}
+
+void MouseKeyMap::MapLButton(ControlCode controlCode)
+{
+	mLButtonAction = controlCode;
+}
+
+void MouseKeyMap::MapRButton(ControlCode controlCode)
+{
+	mRButtonAction = controlCode;
+}
+
+void MouseKeyMap::MapMButton(ControlCode controlCode)
+{
+	mMButtonAction = controlCode;
+}
+
+ControlCode MouseKeyMap::GetControlCode(uint8_t nativeMouseCode) const
+{
+	switch(nativeMouseCode)
+	{
+	case 0:
+		return mLButtonAction;
+	case 1:
+		return mRButtonAction;
+	case 2:
+		return mMButtonAction;
+	default:
+		return ControlCode::Nothing;
+	}
+}
\ No newline at end of file
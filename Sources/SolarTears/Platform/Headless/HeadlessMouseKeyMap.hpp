@@ -0,0 +1,22 @@
+#pragma once
+
+#include "../../Input/ControlCodes.hpp"
+
+//Headless windows have no native mouse codes, 0, 1 and 2 are used for the left, right and middle buttons
+class MouseKeyMap
+{
+public:
+	MouseKeyMap();
+	~MouseKeyMap();
+
+	void MapLButton(ControlCode controlCode);
+	void MapRButton(ControlCode controlCode);
+	void MapMButton(ControlCode controlCode);
+
+	ControlCode GetControlCode(uint8_t nativeMouseCode) const;
+
+private:
+	ControlCode mLButtonAction;
+	ControlCode mRButtonAction;
+	ControlCode mMButtonAction;
+};
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include "HeadlessWindow.hpp"
+
+Window::Window(uint32_t width, uint32_t height)
+{
+	mWindowWidth  = width;
+	mWindowHeight = height;
+
+	mCursorVisible = true;
+}
+
+Window::~Window()
+{
+}
+
+uint32_t Window::GetWidth() const
+{
+	return mWindowWidth;
+}
+
+uint32_t Window::GetHeight() const
+{
+	return mWindowHeight;
+}
+
+bool Window::IsCursorVisible() const
+{
+	return mCursorVisible;
+}
+
+void Window::SetCursorVisible(bool cursorVisible)
+{
+	mCursorVisible = cursorVisible;
+}
+
+void Window::CenterCursor()
+{
+}
+
+void Window::GetMousePos(int32_t* outX, int32_t* outY)
+{
+	*outX = (int32_t)(mWindowWidth  / 2);
+	*outY = (int32_t)(mWindowHeight / 2);
+}
+
+void Window::RegisterResizeStartedCallback([[maybe_unused]] ResizeStartedCallback callback)
+{
+}
+
+void Window::RegisterResizeFinishedCallback([[maybe_unused]] ResizeFinishedCallback callback)
+{
+}
+
+void Window::RegisterKeyPressedCallback([[maybe_unused]] KeyPressedCallback callback)
+{
+}
+
+void Window::RegisterKeyReleasedCallback([[maybe_unused]] KeyReleasedCallback callback)
+{
+}
+
+void Window::RegisterMouseMoveCallback([[maybe_unused]] MouseMoveCallback callback)
+{
+}
+
+void Window::SetResizeCallbackUserPtr([[maybe_unused]] void* userPtr)
+{
+}
+
+void Window::SetKeyCallbackUserPtr([[maybe_unused]] void* userPtr)
+{
+}
+
+void Window::SetMouseCallbackUserPtr([[maybe_unused]] void* userPtr)
+{
+}
+
+void Window::SetKeyboardKeyMap([[maybe_unused]] const KeyboardKeyMap* keyMap)
+{
+}
+
+void Window::SetMouseKeyMap([[maybe_unused]] const MouseKeyMap* keyMap)
+{
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include "../../Input/ControlCodes.hpp"
+
+class KeyboardKeyMap;
+class MouseKeyMap;
+
+//Window stand-in for platforms without a windowing implementation. Only carries the size, so the renderer can only render offscreen.
+//There is no input, the callbacks are accepted but never called
+class Window
+{
+public:
+	using ResizeStartedCallback  = void(*)(Window*,              void*);
+	using ResizeFinishedCallback = void(*)(Window*,              void*);
+	using KeyPressedCallback     = void(*)(Window*, ControlCode, void*);
+	using KeyReleasedCallback    = void(*)(Window*, ControlCode, void*);
+	using MouseMoveCallback      = void(*)(Window*, int, int,    void*);
+
+public:
+	Window(uint32_t width, uint32_t height);
+	~Window();
+
+	uint32_t GetWidth()  const;
+	uint32_t GetHeight() const;
+
+	bool IsCursorVisible() const;
+
+	void SetCursorVisible(bool cursorVisible);
+	void CenterCursor();
+
+	void GetMousePos(int32_t* outX, int32_t* outY);
+
+	void RegisterResizeStartedCallback(ResizeStartedCallback callback);
+	void RegisterResizeFinishedCallback(ResizeFinishedCallback callback);
+	void RegisterKeyPressedCallback(KeyPressedCallback callback);
+	void RegisterKeyReleasedCallback(KeyReleasedCallback callback);
+	void RegisterMouseMoveCallback(MouseMoveCallback callback);
+
+	void SetResizeCallbackUserPtr(void* userPtr);
+	void SetKeyCallbackUserPtr(void* userPtr);
+	void SetMouseCallbackUserPtr(void* userPtr);
+
+	void SetKeyboardKeyMap(const KeyboardKeyMap* keyMap);
+	void SetMouseKeyMap(const MouseKeyMap* keyMap);
+
+private:
+	uint32_t mWindowWidth;
+	uint32_t mWindowHeight;
+
+	bool mCursorVisible;
+};
\ No newline at end of file
@@ -0,0 +1,120 @@
+//wchar_t holds UTF-32 code points on POSIX systems
+std::string ConvertWstringToUTF8(const std::wstring_view str)
+{
+	std::string result;
+	result.reserve(str.size());
+
+	for(wchar_t wideChar: str)
+	{
+		uint32_t codePoint = (uint32_t)wideChar;
+		if(codePoint < 0x80)
+		{
+			result.push_back((char)codePoint);
+		}
+		else if(codePoint < 0x800)
+		{
+			result.push_back((char)(0xc0 | (codePoint >> 6)));
+			result.push_back((char)(0x80 | (codePoint & 0x3f)));
+		}
+		else if(codePoint < 0x10000)
+		{
+			result.push_back((char)(0xe0 | (codePoint >> 12)));
+			result.push_back((char)(0x80 | ((codePoint >> 6) & 0x3f)));
+			result.push_back((char)(0x80 | (codePoint & 0x3f)));
+		}
+		else
+		{
+			result.push_back((char)(0xf0 | (codePoint >> 18)));
+			result.push_back((char)(0x80 | ((codePoint >> 12) & 0x3f)));
+			result.push_back((char)(0x80 | ((codePoint >> 6) & 0x3f)));
+			result.push_back((char)(0x80 | (codePoint & 0x3f)));
+		}
+	}
+
+	return result;
+}
+
+std::wstring ConvertUTF8ToWstring(const std::string_view str)
+{
+	std::wstring result;
+	result.reserve(str.size());
+
+	size_t charIndex = 0;
+	while(charIndex < str.size())
+	{
+		uint8_t  leadByte  = (uint8_t)str[charIndex];
+		uint32_t codePoint = 0;
+		size_t   byteCount = 1;
+
+		if(leadByte < 0x80)
+		{
+			codePoint = leadByte;
+		}
+		else if((leadByte & 0xe0) == 0xc0)
+		{
+			codePoint = leadByte & 0x1f;
+			byteCount = 2;
+		}
+		else if((leadByte & 0xf0) == 0xe0)
+		{
+			codePoint = leadByte & 0x0f;
+			byteCount = 3;
+		}
+		else
+		{
+			codePoint = leadByte & 0x07;
+			byteCount = 4;
+		}
+
+		for(size_t continuationIndex = 1; continuationIndex < byteCount && charIndex + continuationIndex < str.size(); continuationIndex++)
+		{
+			codePoint = (codePoint << 6) | ((uint8_t)str[charIndex + continuationIndex] & 0x3f);
+		}
+
+		result.push_back((wchar_t)codePoint);
+		charIndex += byteCount;
+	}
+
+	return result;
+}
+
+void SystemDebugMessage(const std::string_view str)
+{
+	std::fwrite(str.data(), 1, str.size(), stderr);
+}
+
+void SystemDebugMessage(const std::wstring_view str)
+{
+	SystemDebugMessage(ConvertWstringToUTF8(str));
+}
+
+void SystemDebugMessage(const char* str)
+{
+	std::fputs(str, stderr);
+}
+
+void SystemDebugMessage(const wchar_t* str)
+{
+	SystemDebugMessage(std::wstring_view(str));
+}
+
+std::wstring GetMainDirectory()
+{
+	//TODO: only call it once
+	std::vector<char> mainPath;
+	mainPath.resize(256);
+
+	ssize_t pathLength = 0;
+	while((pathLength = readlink("/proc/self/exe", mainPath.data(), mainPath.size())) == (ssize_t)mainPath.size())
+	{
+		mainPath.resize((size_t)(mainPath.size() * 1.5));
+	}
+
+	if(pathLength <= 0)
+	{
+		return std::wstring();
+	}
+
+	std::string_view mainPathView = std::string_view(mainPath.data(), (size_t)pathLength);
+	return ConvertUTF8ToWstring(mainPathView.substr(0, mainPathView.find_last_of('/') + 1));
+}
\ No newline at end of file
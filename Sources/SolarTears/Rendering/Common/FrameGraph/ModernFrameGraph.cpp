@@ -8,6 +8,21 @@ ModernFrameGraph::~ModernFrameGraph()
 {
 }
 
+uint32_t ModernFrameGraph::GetRenderPassCount() const
+{
+	return (uint32_t)mRenderPassNames.size();
+}
+
+std::string_view ModernFrameGraph::GetRenderPassName(uint32_t passSpanIndex) const
+{
+	return mRenderPassNames[passSpanIndex];
+}
+
+float ModernFrameGraph::GetRenderPassGpuTimeMs(uint32_t passSpanIndex) const
+{
+	return mRenderPassGpuTimesMs[passSpanIndex];
+}
+
 
 uint32_t ModernFrameGraph::CalcPassIndex(const PassFrameSpan& passFrameSpan, uint32_t swapchainImageIndex, uint32_t frameIndex) const
 {
@@ -3,6 +3,7 @@
 #include "FrameGraphConfig.hpp"
 #include "ModernFrameGraphMisc.hpp"
 #include <vector>
+#include <string_view>
 #include "../../../Core/DataStructures/Span.hpp"
 
 class ModernFrameGraph
@@ -29,6 +30,11 @@ public:
 	ModernFrameGraph(FrameGraphConfig&& frameGraphConfig);
 	~ModernFrameGraph();
 
+	//Profiling info for the non-amplified render passes, in the order they are executed
+	uint32_t         GetRenderPassCount()                           const;
+	std::string_view GetRenderPassName(uint32_t passSpanIndex)      const;
+	float            GetRenderPassGpuTimeMs(uint32_t passSpanIndex) const;
+
 protected:
 	uint32_t CalcPassIndex(const PassFrameSpan& passFrameSpan, uint32_t swapchainImageIndex, uint32_t frameIndex) const;
 
@@ -40,4 +46,8 @@ protected:
 
 	std::vector<PassFrameSpan>  mFrameSpansPerRenderPass;
 	std::vector<Span<uint32_t>> mGraphicsPassSpansPerDependencyLevel;
+
+	//Non-amplified render pass names and their last measured GPU execution times. The ith element refers to the ith element of mFrameSpansPerRenderPass
+	std::vector<RenderPassName> mRenderPassNames;
+	std::vector<float>          mRenderPassGpuTimesMs;
 };
\ No newline at end of file
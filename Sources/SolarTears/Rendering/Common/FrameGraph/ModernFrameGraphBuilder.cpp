@@ -221,9 +221,11 @@ void ModernFrameGraphBuilder::BuildReadWriteSubresourceSpans(std::vector<std::sp
 		uint32_t writeBeginOffset = readSubresourceCount;
 		uint32_t writeEndOffset   = readSubresourceCount + writeSubresourceCount;
 
-		//We can't store any references to outIndicesFlat right now, because it can reallocate at any moment and invalidate all references. Use mock spans for now
-		std::span readSpan  = Utils::CreateMockSpan<uint32_t>(readBeginOffset,  readEndOffset);
-		std::span writeSpan = Utils::CreateMockSpan<uint32_t>(writeBeginOffset, writeEndOffset);
+		//We can't store any references to outIndicesFlat right now, because it can reallocate at any moment and invalidate all references. Use mock spans for now.
+		//The offsets above are in tempSubresourceIds, the spans point to the part of outIndicesFlat filled by this pass
+		size_t    flatIndicesOffset = outIndicesFlat.size();
+		std::span readSpan          = Utils::CreateMockSpan<uint32_t>(flatIndicesOffset + readBeginOffset,  flatIndicesOffset + readEndOffset);
+		std::span writeSpan         = Utils::CreateMockSpan<uint32_t>(flatIndicesOffset + writeBeginOffset, flatIndicesOffset + writeEndOffset);
 
 		std::span<uint_fast16_t> readSubresources = {tempSubresourceIds.begin() + readBeginOffset, tempSubresourceIds.begin() + readEndOffset};
 		FillPassReadSubresourceIds(renderPassMetadata.Type, readSubresources);
@@ -284,7 +286,7 @@ void ModernFrameGraphBuilder::BuildAdjacencyList(const std::vector<std::span<uin
 		}
 
 		size_t newSize = outAdjacentPassIndicesFlat.size();
-		outAdjacencyList[writePassIndex] = Utils::CreateMockSpan<uint_fast16_t>(oldSize, newSize); //We have to use mock spans here too, for the same reasons as in BuildReadWriteSubresourceSpans
+		outAdjacencyList[writePassIndex] = Utils::CreateMockSpan<uint32_t>(oldSize, newSize); //We have to use mock spans here too, for the same reasons as in BuildReadWriteSubresourceSpans
 	}
 
 	//Validate mock spans
@@ -346,18 +348,25 @@ void ModernFrameGraphBuilder::AssignDependencyLevels(const std::vector<uint32_t>
 void ModernFrameGraphBuilder::SortRenderPassesByTopology(const std::vector<std::span<uint32_t>>& unsortedPassAdjacencyList, std::vector<uint32_t>& outPassIndexRemap)
 {
 	std::vector<uint8_t> traversalMarkFlags(mRenderPassMetadataSpan.End - mRenderPassMetadataSpan.Begin, 0);
+
+	//The passes in the order they were finished by the depth-first traversal, i.e. in the reverse topological order
+	std::vector<uint32_t> finishedPassIndices;
 	for(uint32_t passIndex = 0; passIndex < unsortedPassAdjacencyList.size(); passIndex++)
 	{
-		TopologicalSortNode(passIndex, unsortedPassAdjacencyList, traversalMarkFlags, outPassIndexRemap);
+		TopologicalSortNode(passIndex, unsortedPassAdjacencyList, traversalMarkFlags, finishedPassIndices);
+	}
+
+	//The remap is indexed by the old pass index, not by the finish order
+	outPassIndexRemap.resize(finishedPassIndices.size());
+	for(uint32_t finishIndex = 0; finishIndex < finishedPassIndices.size(); finishIndex++)
+	{
+		outPassIndexRemap[finishedPassIndices[finishIndex]] = (uint32_t)(finishedPassIndices.size() - finishIndex - 1);
 	}
 
 	std::vector<PassMetadata> sortedPasses(mRenderPassMetadataSpan.End - mRenderPassMetadataSpan.Begin);
 	for(uint32_t oldPassIndex = 0; oldPassIndex < outPassIndexRemap.size(); oldPassIndex++)
 	{
-		uint32_t& remappedPassIndex = outPassIndexRemap[oldPassIndex];
-
-		remappedPassIndex = (uint32_t)(outPassIndexRemap.size() - remappedPassIndex - 1);
-		sortedPasses[remappedPassIndex] = mTotalPassMetadatas[mRenderPassMetadataSpan.Begin + oldPassIndex];
+		sortedPasses[outPassIndexRemap[oldPassIndex]] = mTotalPassMetadatas[mRenderPassMetadataSpan.Begin + oldPassIndex];
 	}
 	
 	for(size_t i = 0; i < sortedPasses.size(); i++) //Reverse the order and save the sorted order
@@ -366,7 +375,7 @@ void ModernFrameGraphBuilder::SortRenderPassesByTopology(const std::vector<std::
 	}
 }
 
-void ModernFrameGraphBuilder::TopologicalSortNode(uint32_t passIndex, const std::vector<std::span<uint32_t>>& unsortedPassAdjacencyList, std::vector<uint8_t>& inoutTraversalMarkFlags, std::vector<uint32_t>& inoutPassIndexRemap)
+void ModernFrameGraphBuilder::TopologicalSortNode(uint32_t passIndex, const std::vector<std::span<uint32_t>>& unsortedPassAdjacencyList, std::vector<uint8_t>& inoutTraversalMarkFlags, std::vector<uint32_t>& inoutFinishedPassIndices)
 {
 	constexpr uint8_t AlreadyVisitedFlag     = 0x01;
 	constexpr uint8_t CurrentlyProcessedFlag = 0x02;
@@ -388,11 +397,11 @@ void ModernFrameGraphBuilder::TopologicalSortNode(uint32_t passIndex, const std:
 	std::span<uint32_t> passAdjacencyIndices = unsortedPassAdjacencyList[passIndex];
 	for(uint32_t adjacentPassIndex: passAdjacencyIndices)
 	{
-		TopologicalSortNode(adjacentPassIndex, unsortedPassAdjacencyList, inoutTraversalMarkFlags, inoutPassIndexRemap);
+		TopologicalSortNode(adjacentPassIndex, unsortedPassAdjacencyList, inoutTraversalMarkFlags, inoutFinishedPassIndices);
 	}
 
 	inoutTraversalMarkFlags[passIndex] &= (~CurrentlyProcessedFlag);
-	inoutPassIndexRemap.push_back(passIndex);
+	inoutFinishedPassIndices.push_back(passIndex);
 }
 
 void ModernFrameGraphBuilder::SortRenderPassesByDependency()
@@ -582,6 +591,8 @@ void ModernFrameGraphBuilder::AmplifyResourcesAndPasses()
 			.SwapType = passSwapType
 		});
 
+		mGraphToBuild->mRenderPassNames.push_back(nonAmplifiedPassMetadata.Name);
+
 		for(uint32_t passFrameIndex = 0; passFrameIndex < passFrameCount; passFrameIndex++)
 		{
 			mTotalPassMetadatas.push_back(PassMetadata
@@ -602,6 +613,8 @@ void ModernFrameGraphBuilder::AmplifyResourcesAndPasses()
 	amplifiedRenderPassMetadataSpan.End = (uint32_t)mTotalPassMetadatas.size();
 	mRenderPassMetadataSpan = amplifiedRenderPassMetadataSpan;
 
+	mGraphToBuild->mRenderPassGpuTimesMs.resize(mGraphToBuild->mRenderPassNames.size(), 0.0f);
+
 	Span<uint32_t> amplifiedPresentPassMetadataSpan = {.Begin = (uint32_t)mTotalPassMetadatas.size(), .End = (uint32_t)mTotalPassMetadatas.size()};
 	for(uint32_t nonAmplifiedPresentPassIndex = mPresentPassMetadataSpan.Begin; nonAmplifiedPresentPassIndex < mPresentPassMetadataSpan.End; nonAmplifiedPresentPassIndex++)
 	{
@@ -786,6 +799,21 @@ void ModernFrameGraphBuilder::AmplifyResourcesAndPasses()
 			}
 		}
 	}
+
+	//The helper nodes are copied from their template nodes on allocation. The template can belong to a pass later in the frame, not initialized at that moment yet
+	for(uint32_t templateSubresourceIndex = mPrimarySubresourceNodeSpan.Begin; templateSubresourceIndex < mPrimarySubresourceNodeSpan.End; templateSubresourceIndex++)
+	{
+		const SubresourceMetadataNode& templateSubresource   = mSubresourceMetadataNodesFlat[templateSubresourceIndex];
+		Span<uint32_t>                 helperSubresourceSpan = mHelperNodeSpansPerPassSubresource[templateSubresourceIndex];
+		for(uint32_t helperSubresourceIndex = helperSubresourceSpan.Begin; helperSubresourceIndex < helperSubresourceSpan.End; helperSubresourceIndex++)
+		{
+			mSubresourceMetadataNodesFlat[helperSubresourceIndex].ResourceMetadataIndex = templateSubresource.ResourceMetadataIndex;
+
+#if defined(DEBUG) || defined(_DEBUG)
+			mSubresourceMetadataNodesFlat[helperSubresourceIndex].ResourceName = templateSubresource.ResourceName;
+#endif
+		}
+	}
 }
 
 void ModernFrameGraphBuilder::FindFrameCountAndSwapType(const std::vector<Span<uint32_t>>& resourceRemapInfos, std::span<const SubresourceMetadataNode> oldPassSubresourceMetadataSpan, uint32_t* outFrameCount, RenderPassFrameSwapType* outSwapType)
@@ -911,6 +939,8 @@ void ModernFrameGraphBuilder::InitializeHeadNodes()
 	for(uint32_t metadataIndex = 0; metadataIndex < mSubresourceMetadataNodesFlat.size(); metadataIndex++)
 	{
 		SubresourceMetadataNode& subresourceMetadataNode = mSubresourceMetadataNodesFlat[metadataIndex];
+		assert(subresourceMetadataNode.ResourceMetadataIndex < mResourceMetadatas.size());
+
 		if(mResourceMetadatas[subresourceMetadataNode.ResourceMetadataIndex].HeadNodeIndex == (uint32_t)(-1))
 		{
 			mResourceMetadatas[subresourceMetadataNode.ResourceMetadataIndex].HeadNodeIndex = metadataIndex;
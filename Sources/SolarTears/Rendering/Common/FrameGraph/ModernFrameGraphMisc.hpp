@@ -33,6 +33,7 @@ enum class RenderPassType: uint32_t
 	GBufferGenerate,
 	GBufferDraw,
 	CopyImage,
+	PerformanceHud,
 
 	None = 0xffffffff
 };
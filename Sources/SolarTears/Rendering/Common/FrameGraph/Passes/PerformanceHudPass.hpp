@@ -0,0 +1,42 @@
+#pragma once
+
+#include "../ModernFrameGraphMisc.hpp"
+#include <cassert>
+#include <string_view>
+#include <array>
+
+class PerformanceHudPassBase
+{
+public:
+	static constexpr RenderPassClass PassClass = RenderPassClass::Graphics;
+	static constexpr RenderPassType  PassType  = RenderPassType::PerformanceHud;
+
+	enum class PassSubresourceId: uint_fast16_t
+	{
+		ColorBufferImage = 0,
+
+		Count
+	};
+
+	//The overlay is drawn on top of the existing image contents, so the image is both read and written
+	constexpr static std::array ReadSubresourceIds =
+	{
+		PassSubresourceId::ColorBufferImage
+	};
+
+	constexpr static std::array WriteSubresourceIds =
+	{
+		PassSubresourceId::ColorBufferImage
+	};
+
+	static inline constexpr std::string_view GetSubresourceStringId(PassSubresourceId subresourceId)
+	{
+		switch(subresourceId)
+		{
+			case PassSubresourceId::ColorBufferImage: return "PerformanceHudColorImage";
+		}
+
+		assert(false);
+		return "";
+	}
+};
\ No newline at end of file
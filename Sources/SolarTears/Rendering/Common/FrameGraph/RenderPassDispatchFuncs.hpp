@@ -2,16 +2,18 @@
 
 #include "Passes/GBufferPass.hpp"
 #include "Passes/CopyImagePass.hpp"
+#include "Passes/PerformanceHudPass.hpp"
 #include "RenderPassTraits.h"
 #include <cassert>
 #include <algorithm>
 
-#define CHOOSE_PASS_FUNCTION_WITH_TYPE(PassType, FuncName, FuncVariable, TypeMangle)                 \
-switch(PassType)                                                                                     \
-{                                                                                                    \
-	case RenderPassType::GBufferGenerate: FuncVariable = FuncName<GBufferPass##TypeMangle>;   break; \
-	case RenderPassType::CopyImage:       FuncVariable = FuncName<CopyImagePass##TypeMangle>; break; \
-}                                                                                                    \
+#define CHOOSE_PASS_FUNCTION_WITH_TYPE(PassType, FuncName, FuncVariable, TypeMangle)                      \
+switch(PassType)                                                                                          \
+{                                                                                                         \
+	case RenderPassType::GBufferGenerate: FuncVariable = FuncName<GBufferPass##TypeMangle>;        break; \
+	case RenderPassType::CopyImage:       FuncVariable = FuncName<CopyImagePass##TypeMangle>;      break; \
+	case RenderPassType::PerformanceHud:  FuncVariable = FuncName<PerformanceHudPass##TypeMangle>; break; \
+}                                                                                                         \
 
 #define CHOOSE_PASS_FUNCTION(PassType, FuncName, FuncVariable) CHOOSE_PASS_FUNCTION_WITH_TYPE(PassType, FuncName, FuncVariable, )
 
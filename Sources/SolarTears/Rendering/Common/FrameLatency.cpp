@@ -0,0 +1,154 @@
+#include "FrameLatency.hpp"
+#include "../../Core/Timer.hpp"
+#include "../../Logging/LoggerQueue.hpp"
+#include <algorithm>
+#include <thread>
+#include <string>
+
+namespace
+{
+	//The input delay is adjusted each frame so that the GPU wait approaches the safety margin.
+	//The margin absorbs frame time jitter and sleep inaccuracy, the rate keeps the adjustment from oscillating
+	constexpr float WaitSafetyMarginMs  = 1.5f;
+	constexpr float DelayAdjustmentRate = 0.25f;
+	constexpr float MaxInputDelayMs     = 33.0f;
+}
+
+FrameLatencyTracker::FrameLatencyTracker()
+{
+	mFrameStarted      = false;
+	mLateInputSampling = false;
+
+	mFrameWaitDuration = Clock::duration::zero();
+
+	mInputDelayMs = 0.0f;
+
+	mLastFrameSample   = {};
+	mAccumulatedSample = {};
+
+	mMaxInputToPresentMs   = 0.0f;
+	mAccumulatedFrameCount = 0;
+	mLastLoggedTime        = 0.0f;
+}
+
+FrameLatencyTracker::~FrameLatencyTracker()
+{
+}
+
+void FrameLatencyTracker::SetLateInputSampling(bool enabled)
+{
+	mLateInputSampling = enabled;
+	if(!mLateInputSampling)
+	{
+		mInputDelayMs = 0.0f;
+	}
+}
+
+bool FrameLatencyTracker::IsLateInputSamplingEnabled() const
+{
+	return mLateInputSampling;
+}
+
+void FrameLatencyTracker::WaitForInputSampling()
+{
+	if(mLateInputSampling && mInputDelayMs > 0.0f)
+	{
+		std::this_thread::sleep_for(std::chrono::duration<float, std::milli>(mInputDelayMs));
+	}
+}
+
+void FrameLatencyTracker::MarkInputSampled()
+{
+	mInputSampleTime   = Clock::now();
+	mSimulationEndTime = mInputSampleTime;
+	mSubmitTime        = mInputSampleTime;
+	mFrameWaitDuration = Clock::duration::zero();
+
+	mFrameStarted = true;
+}
+
+void FrameLatencyTracker::MarkSimulationFinished()
+{
+	mSimulationEndTime = Clock::now();
+}
+
+void FrameLatencyTracker::MarkWaitStarted()
+{
+	mWaitStartTime = Clock::now();
+}
+
+void FrameLatencyTracker::MarkWaitFinished()
+{
+	mFrameWaitDuration += Clock::now() - mWaitStartTime;
+}
+
+void FrameLatencyTracker::MarkSubmitted()
+{
+	mSubmitTime = Clock::now();
+}
+
+void FrameLatencyTracker::MarkPresented()
+{
+	Clock::time_point presentTime = Clock::now();
+	if(!mFrameStarted)
+	{
+		//Frames rendered without sampled input (e.g. during initialization) don't have any latency to measure
+		return;
+	}
+
+	mLastFrameSample.InputToSimulationEndMs = MillisecondsBetween(mInputSampleTime, mSimulationEndTime);
+	mLastFrameSample.InputToSubmitMs        = MillisecondsBetween(mInputSampleTime, mSubmitTime);
+	mLastFrameSample.InputToPresentMs       = MillisecondsBetween(mInputSampleTime, presentTime);
+	mLastFrameSample.GpuWaitMs              = std::chrono::duration<float, std::milli>(mFrameWaitDuration).count();
+
+	mAccumulatedSample.InputToSimulationEndMs += mLastFrameSample.InputToSimulationEndMs;
+	mAccumulatedSample.InputToSubmitMs        += mLastFrameSample.InputToSubmitMs;
+	mAccumulatedSample.InputToPresentMs       += mLastFrameSample.InputToPresentMs;
+	mAccumulatedSample.GpuWaitMs              += mLastFrameSample.GpuWaitMs;
+
+	mMaxInputToPresentMs = std::max(mMaxInputToPresentMs, mLastFrameSample.InputToPresentMs);
+	mAccumulatedFrameCount++;
+
+	if(mLateInputSampling)
+	{
+		//Every millisecond spent waiting on the GPU after sampling the input is a millisecond of latency that could be spent before it instead
+		mInputDelayMs = std::clamp(mInputDelayMs + (mLastFrameSample.GpuWaitMs - WaitSafetyMarginMs) * DelayAdjustmentRate, 0.0f, MaxInputDelayMs);
+	}
+
+	mFrameStarted = false;
+}
+
+const FrameLatencySample& FrameLatencyTracker::GetLastFrameSample() const
+{
+	return mLastFrameSample;
+}
+
+float FrameLatencyTracker::GetInputDelayMs() const
+{
+	return mInputDelayMs;
+}
+
+void FrameLatencyTracker::LogLatency(const Timer* timer, LoggerQueue* logger)
+{
+	float currMeasurementTime = timer->GetCurrTime();
+	if(currMeasurementTime - mLastLoggedTime >= 1.0f && mAccumulatedFrameCount > 0)
+	{
+		float frameCount = (float)mAccumulatedFrameCount;
+		logger->PostLogMessage("Input latency, ms: to simulation end: " + std::to_string(mAccumulatedSample.InputToSimulationEndMs / frameCount)
+		                                     + ", to submit: "          + std::to_string(mAccumulatedSample.InputToSubmitMs        / frameCount)
+		                                     + ", to present: "         + std::to_string(mAccumulatedSample.InputToPresentMs       / frameCount)
+		                                     + " (max "                 + std::to_string(mMaxInputToPresentMs) + ")"
+		                                     + ", GPU wait: "           + std::to_string(mAccumulatedSample.GpuWaitMs              / frameCount)
+		                                     + ", input delay: "        + std::to_string(mInputDelayMs));
+
+		mAccumulatedSample     = {};
+		mMaxInputToPresentMs   = 0.0f;
+		mAccumulatedFrameCount = 0;
+		mLastLoggedTime        = currMeasurementTime;
+	}
+}
+
+float FrameLatencyTracker::MillisecondsBetween(Clock::time_point start, Clock::time_point end) const
+{
+	return std::chrono::duration<float, std::milli>(end - start).count();
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <chrono>
+
+class Timer;
+class LoggerQueue;
+
+struct FrameLatencySample
+{
+	float InputToSimulationEndMs;
+	float InputToSubmitMs;
+	float InputToPresentMs; //The closest point to the photons the CPU can see without display timing extensions
+	float GpuWaitMs;        //Time the renderer spent blocked on the GPU and the swapchain during the frame
+};
+
+//Measures the time from sampling the input to presenting the frame made with it.
+//The engine stamps input and simulation, the renderer stamps the GPU waits, submission and presentation.
+//In late input sampling mode the time the renderer would otherwise spend waiting on the GPU is moved to before input sampling
+class FrameLatencyTracker
+{
+	using Clock = std::chrono::steady_clock;
+
+public:
+	FrameLatencyTracker();
+	~FrameLatencyTracker();
+
+	void SetLateInputSampling(bool enabled);
+	bool IsLateInputSamplingEnabled() const;
+
+	//Sleeps for the expected GPU wait time in late input sampling mode, returns immediately otherwise. Should be called right before sampling the input
+	void WaitForInputSampling();
+
+	void MarkInputSampled();
+	void MarkSimulationFinished();
+
+	void MarkWaitStarted();
+	void MarkWaitFinished();
+	void MarkSubmitted();
+	void MarkPresented();
+
+	const FrameLatencySample& GetLastFrameSample() const;
+	float                     GetInputDelayMs()    const;
+
+	void LogLatency(const Timer* timer, LoggerQueue* logger);
+
+private:
+	float MillisecondsBetween(Clock::time_point start, Clock::time_point end) const;
+
+private:
+	bool mFrameStarted;
+	bool mLateInputSampling;
+
+	Clock::time_point mInputSampleTime;
+	Clock::time_point mSimulationEndTime;
+	Clock::time_point mSubmitTime;
+	Clock::time_point mWaitStartTime;
+	Clock::duration   mFrameWaitDuration;
+
+	float mInputDelayMs;
+
+	FrameLatencySample mLastFrameSample;
+
+	FrameLatencySample mAccumulatedSample;
+	float              mMaxInputToPresentMs;
+	uint32_t           mAccumulatedFrameCount;
+	float              mLastLoggedTime;
+};
\ No newline at end of file
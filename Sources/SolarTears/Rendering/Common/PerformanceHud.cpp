@@ -0,0 +1,319 @@
+#include "PerformanceHud.hpp"
+#include "FrameGraph/ModernFrameGraph.hpp"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+
+namespace
+{
+	constexpr uint32_t PackColor(uint32_t r, uint32_t g, uint32_t b, uint32_t a)
+	{
+		return (r << 0) | (g << 8) | (b << 16) | (a << 24);
+	}
+
+	constexpr uint32_t BackgroundColor = PackColor(0,   0,   0,   160);
+	constexpr uint32_t TextColor       = PackColor(255, 255, 255, 255);
+	constexpr uint32_t HeaderColor     = PackColor(255, 220, 80,  255);
+	constexpr uint32_t GoodFrameColor  = PackColor(80,  220, 80,  255);
+	constexpr uint32_t SlowFrameColor  = PackColor(240, 200, 40,  255);
+	constexpr uint32_t BadFrameColor   = PackColor(240, 60,  40,  255);
+	constexpr uint32_t GraphLineColor  = PackColor(255, 255, 255, 96);
+
+	constexpr float FontScale      = 2.0f;                                            //Screen pixels per font pixel
+	constexpr float CellWidth      = (PerformanceHud::GlyphWidth  + 1) * FontScale;   //Glyph + 1 pixel spacing
+	constexpr float CellHeight     = (PerformanceHud::GlyphHeight + 2) * FontScale;   //Glyph + 2 pixels line spacing
+	constexpr float PanelMargin    = 8.0f;
+	constexpr float PanelPadding   = 6.0f;
+	constexpr float GraphBarWidth  = 2.0f;
+	constexpr float GraphHeight    = 64.0f;
+	constexpr float GraphMaxTimeMs = 50.0f;
+
+	constexpr uint32_t MaxLineLength   = 40;
+	constexpr uint32_t StatsLineCount  = 7;
+	constexpr uint32_t VerticesPerQuad = 6;
+
+	//Rows 0-5 of a glyph (bit = row * GlyphWidth + column) and row 6
+	struct GlyphBits
+	{
+		uint32_t UpperRows;
+		uint32_t LastRow;
+	};
+
+	//5x7 font, one glyph per entry in PerformanceHud::GlyphOrder order
+	constexpr std::array FontGlyphs =
+	{
+		GlyphBits{0x00000000, 0x00}, //' '
+		GlyphBits{0x233ae62e, 0x0e}, //'0'
+		GlyphBits{0x084210c4, 0x0e}, //'1'
+		GlyphBits{0x0444422e, 0x1f}, //'2'
+		GlyphBits{0x2304111f, 0x0e}, //'3'
+		GlyphBits{0x11f4a988, 0x08}, //'4'
+		GlyphBits{0x23083c3f, 0x0e}, //'5'
+		GlyphBits{0x2317844c, 0x0e}, //'6'
+		GlyphBits{0x0422221f, 0x02}, //'7'
+		GlyphBits{0x2317462e, 0x0e}, //'8'
+		GlyphBits{0x110f462e, 0x06}, //'9'
+		GlyphBits{0x231fc62e, 0x11}, //'A'
+		GlyphBits{0x2317c62f, 0x0f}, //'B'
+		GlyphBits{0x2210862e, 0x0e}, //'C'
+		GlyphBits{0x1318c527, 0x07}, //'D'
+		GlyphBits{0x0217843f, 0x1f}, //'E'
+		GlyphBits{0x0217843f, 0x01}, //'F'
+		GlyphBits{0x231e862e, 0x1e}, //'G'
+		GlyphBits{0x231fc631, 0x11}, //'H'
+		GlyphBits{0x0842108e, 0x0e}, //'I'
+		GlyphBits{0x1284211c, 0x06}, //'J'
+		GlyphBits{0x12519531, 0x11}, //'K'
+		GlyphBits{0x02108421, 0x1f}, //'L'
+		GlyphBits{0x231ad771, 0x11}, //'M'
+		GlyphBits{0x239ace31, 0x11}, //'N'
+		GlyphBits{0x2318c62e, 0x0e}, //'O'
+		GlyphBits{0x0217c62f, 0x01}, //'P'
+		GlyphBits{0x1358c62e, 0x16}, //'Q'
+		GlyphBits{0x1257c62f, 0x11}, //'R'
+		GlyphBits{0x2107043e, 0x0f}, //'S'
+		GlyphBits{0x0842109f, 0x04}, //'T'
+		GlyphBits{0x2318c631, 0x0e}, //'U'
+		GlyphBits{0x1518c631, 0x04}, //'V'
+		GlyphBits{0x2b5ac631, 0x0a}, //'W'
+		GlyphBits{0x22a22a31, 0x11}, //'X'
+		GlyphBits{0x08422a31, 0x04}, //'Y'
+		GlyphBits{0x0222221f, 0x1f}, //'Z'
+		GlyphBits{0x0c000000, 0x06}, //'.'
+		GlyphBits{0x0c6018c0, 0x00}, //':'
+		GlyphBits{0x02222200, 0x00}, //'/'
+		GlyphBits{0x32222263, 0x18}, //'%'
+		GlyphBits{0x000f8000, 0x00}, //'-'
+		GlyphBits{0x08210888, 0x08}, //'('
+		GlyphBits{0x08842082, 0x02}, //')'
+		GlyphBits{0x00000000, 0x1f}  //'_'
+	};
+
+	static_assert(FontGlyphs.size() == PerformanceHud::GlyphOrder.size());
+	static_assert(PerformanceHud::FontBitmapWidth == 230, "The font bitmap width is hardcoded in the HUD shaders");
+}
+
+PerformanceHud::PerformanceHud()
+{
+	mFrameGraphRef = nullptr;
+
+	mVisible = true;
+
+	mFrameTimeHistory.fill(0.0f);
+	mFrameTimeHistoryHead = 0;
+
+	mLastFrameCounters = {};
+	mLastLatencySample = {};
+	mLastBuildTimeMs   = 0.0f;
+
+	mPixelToNdcX = 0.0f;
+	mPixelToNdcY = 0.0f;
+}
+
+PerformanceHud::~PerformanceHud()
+{
+}
+
+void PerformanceHud::SetFrameGraph(const ModernFrameGraph* frameGraph)
+{
+	mFrameGraphRef = frameGraph;
+}
+
+void PerformanceHud::SetVisible(bool visible)
+{
+	mVisible = visible;
+}
+
+bool PerformanceHud::IsVisible() const
+{
+	return mVisible;
+}
+
+void PerformanceHud::UpdateFrameData(float frameTime, const RenderStatisticsCounters& frameCounters, const FrameLatencySample& latencySample)
+{
+	mFrameTimeHistory[mFrameTimeHistoryHead] = frameTime * 1000.0f;
+	mFrameTimeHistoryHead                    = (mFrameTimeHistoryHead + 1) % FrameTimeHistoryLength;
+
+	mLastFrameCounters = frameCounters;
+	mLastLatencySample = latencySample;
+}
+
+uint32_t PerformanceHud::BuildVertices(std::span<PerformanceHudVertex> outVertices, uint32_t viewportWidth, uint32_t viewportHeight)
+{
+	auto buildStartTime = std::chrono::steady_clock::now();
+
+	mPixelToNdcX = 2.0f / (float)viewportWidth;
+	mPixelToNdcY = 2.0f / (float)viewportHeight;
+
+	uint32_t passCount = (mFrameGraphRef != nullptr) ? mFrameGraphRef->GetRenderPassCount() : 0;
+
+	float panelWidth  = std::max(MaxLineLength * CellWidth, FrameTimeHistoryLength * GraphBarWidth) + 2.0f * PanelPadding;
+	float panelHeight = (StatsLineCount + passCount) * CellHeight + GraphHeight + 3.0f * PanelPadding;
+
+	uint32_t vertexCount = 0;
+	vertexCount += AddRectangle(outVertices, vertexCount, PanelMargin, PanelMargin, panelWidth, panelHeight, BackgroundColor);
+
+	float textLeft = PanelMargin + PanelPadding;
+	float textTop  = PanelMargin + PanelPadding;
+
+	uint32_t lastFrameIndex  = (mFrameTimeHistoryHead + FrameTimeHistoryLength - 1) % FrameTimeHistoryLength;
+	float    lastFrameTimeMs = mFrameTimeHistory[lastFrameIndex];
+	float    lastFps         = (lastFrameTimeMs > 0.0f) ? (1000.0f / lastFrameTimeMs) : 0.0f;
+
+	std::array<char, MaxLineLength + 1> lineBuffer;
+	auto addLine = [&](uint32_t color)
+	{
+		vertexCount += AddText(outVertices, vertexCount, textLeft, textTop, std::string_view(lineBuffer.data()), color);
+		textTop += CellHeight;
+	};
+
+	std::snprintf(lineBuffer.data(), lineBuffer.size(), "FRAME %.2f MS (%.0f FPS)", lastFrameTimeMs, lastFps);
+	addLine(HeaderColor);
+
+	std::snprintf(lineBuffer.data(), lineBuffer.size(), "DRAWS %llu TRIS %llu", (unsigned long long)mLastFrameCounters.DrawCount, (unsigned long long)mLastFrameCounters.TriangleCount);
+	addLine(TextColor);
+
+	std::snprintf(lineBuffer.data(), lineBuffer.size(), "BARRIERS %llu BINDS %llu", (unsigned long long)mLastFrameCounters.BarrierCount, (unsigned long long)mLastFrameCounters.DescriptorSetBindCount);
+	addLine(TextColor);
+
+	std::snprintf(lineBuffer.data(), lineBuffer.size(), "UPLOADS %llu BYTES %llu", (unsigned long long)mLastFrameCounters.UploadCopyRegionCount, (unsigned long long)mLastFrameCounters.UploadByteCount);
+	addLine(TextColor);
+
+	std::snprintf(lineBuffer.data(), lineBuffer.size(), "LATENCY %.2f MS GPU WAIT %.2f MS", mLastLatencySample.InputToPresentMs, mLastLatencySample.GpuWaitMs);
+	addLine(TextColor);
+
+	std::snprintf(lineBuffer.data(), lineBuffer.size(), "HUD CPU %.3f MS", mLastBuildTimeMs);
+	addLine(TextColor);
+
+	std::snprintf(lineBuffer.data(), lineBuffer.size(), "GPU PASS TIMES:");
+	addLine(HeaderColor);
+
+	for(uint32_t passIndex = 0; passIndex < passCount; passIndex++)
+	{
+		std::string_view passName = mFrameGraphRef->GetRenderPassName(passIndex);
+		std::snprintf(lineBuffer.data(), lineBuffer.size(), " %-24.*s %.3f MS", (int)std::min<size_t>(passName.size(), 24), passName.data(), mFrameGraphRef->GetRenderPassGpuTimeMs(passIndex));
+		addLine(TextColor);
+	}
+
+	//Frame time graph, oldest frame on the left. The line marks 16.6 ms
+	float graphLeft   = textLeft;
+	float graphBottom = textTop + PanelPadding + GraphHeight;
+	for(uint32_t barIndex = 0; barIndex < FrameTimeHistoryLength; barIndex++)
+	{
+		float frameTimeMs = mFrameTimeHistory[(mFrameTimeHistoryHead + barIndex) % FrameTimeHistoryLength];
+		float barHeight   = std::min(frameTimeMs / GraphMaxTimeMs, 1.0f) * GraphHeight;
+
+		uint32_t barColor = GoodFrameColor;
+		if(frameTimeMs > 33.4f)
+		{
+			barColor = BadFrameColor;
+		}
+		else if(frameTimeMs > 16.7f)
+		{
+			barColor = SlowFrameColor;
+		}
+
+		vertexCount += AddRectangle(outVertices, vertexCount, graphLeft + barIndex * GraphBarWidth, graphBottom - barHeight, GraphBarWidth, barHeight, barColor);
+	}
+
+	float targetLineTop = graphBottom - (16.6f / GraphMaxTimeMs) * GraphHeight;
+	vertexCount += AddRectangle(outVertices, vertexCount, graphLeft, targetLineTop, FrameTimeHistoryLength * GraphBarWidth, 1.0f, GraphLineColor);
+
+	auto buildEndTime = std::chrono::steady_clock::now();
+	mLastBuildTimeMs = std::chrono::duration<float, std::milli>(buildEndTime - buildStartTime).count();
+
+	return vertexCount;
+}
+
+void PerformanceHud::BuildFontBitmap(std::span<uint8_t> outTexels)
+{
+	assert(outTexels.size() >= FontBitmapSize);
+	std::fill(outTexels.begin(), outTexels.end(), (uint8_t)0);
+
+	constexpr uint8_t CoveredTexel = 0xff;
+	for(uint32_t glyphIndex = 0; glyphIndex < (uint32_t)FontGlyphs.size(); glyphIndex++)
+	{
+		for(uint32_t row = 0; row < GlyphHeight; row++)
+		{
+			for(uint32_t column = 0; column < GlyphWidth; column++)
+			{
+				uint32_t pixelBit = (row < GlyphHeight - 1) ? ((FontGlyphs[glyphIndex].UpperRows >> (row * GlyphWidth + column)) & 1u) : ((FontGlyphs[glyphIndex].LastRow >> column) & 1u);
+				if(pixelBit != 0)
+				{
+					outTexels[row * FontBitmapWidth + glyphIndex * GlyphWidth + column] = CoveredTexel;
+				}
+			}
+		}
+	}
+
+	for(uint32_t row = 0; row < GlyphHeight; row++)
+	{
+		std::fill_n(outTexels.begin() + row * FontBitmapWidth + SolidGlyphIndex * GlyphWidth, GlyphWidth, CoveredTexel);
+	}
+}
+
+uint32_t PerformanceHud::AddRectangle(std::span<PerformanceHudVertex> outVertices, uint32_t vertexOffset, float left, float top, float width, float height, uint32_t color) const
+{
+	return AddQuad(outVertices, vertexOffset, left, top, width, height, SolidGlyphIndex, color);
+}
+
+uint32_t PerformanceHud::AddText(std::span<PerformanceHudVertex> outVertices, uint32_t vertexOffset, float left, float top, std::string_view text, uint32_t color) const
+{
+	uint32_t addedVertexCount = 0;
+	for(size_t charIndex = 0; charIndex < text.size(); charIndex++)
+	{
+		uint32_t glyphIndex = CharToGlyphIndex(text[charIndex]);
+		if(glyphIndex == 0) //Don't waste vertices on spaces
+		{
+			continue;
+		}
+
+		addedVertexCount += AddQuad(outVertices, vertexOffset + addedVertexCount, left + charIndex * CellWidth, top, GlyphWidth * FontScale, GlyphHeight * FontScale, glyphIndex, color);
+	}
+
+	return addedVertexCount;
+}
+
+uint32_t PerformanceHud::AddQuad(std::span<PerformanceHudVertex> outVertices, uint32_t vertexOffset, float left, float top, float width, float height, uint32_t glyphIndex, uint32_t color) const
+{
+	if(vertexOffset + VerticesPerQuad > outVertices.size())
+	{
+		return 0;
+	}
+
+	float ndcLeft   = left             * mPixelToNdcX - 1.0f;
+	float ndcRight  = (left + width)   * mPixelToNdcX - 1.0f;
+	float ndcTop    = top              * mPixelToNdcY - 1.0f;
+	float ndcBottom = (top  + height)  * mPixelToNdcY - 1.0f;
+
+	PerformanceHudVertex topLeft     = {.Position = DirectX::XMFLOAT2(ndcLeft,  ndcTop),    .GlyphCoord = DirectX::XMFLOAT2(0.0f,              0.0f),               .GlyphIndex = glyphIndex, .Color = color};
+	PerformanceHudVertex topRight    = {.Position = DirectX::XMFLOAT2(ndcRight, ndcTop),    .GlyphCoord = DirectX::XMFLOAT2((float)GlyphWidth, 0.0f),               .GlyphIndex = glyphIndex, .Color = color};
+	PerformanceHudVertex bottomLeft  = {.Position = DirectX::XMFLOAT2(ndcLeft,  ndcBottom), .GlyphCoord = DirectX::XMFLOAT2(0.0f,              (float)GlyphHeight), .GlyphIndex = glyphIndex, .Color = color};
+	PerformanceHudVertex bottomRight = {.Position = DirectX::XMFLOAT2(ndcRight, ndcBottom), .GlyphCoord = DirectX::XMFLOAT2((float)GlyphWidth, (float)GlyphHeight), .GlyphIndex = glyphIndex, .Color = color};
+
+	outVertices[vertexOffset + 0] = topLeft;
+	outVertices[vertexOffset + 1] = topRight;
+	outVertices[vertexOffset + 2] = bottomLeft;
+	outVertices[vertexOffset + 3] = topRight;
+	outVertices[vertexOffset + 4] = bottomRight;
+	outVertices[vertexOffset + 5] = bottomLeft;
+
+	return VerticesPerQuad;
+}
+
+uint32_t PerformanceHud::CharToGlyphIndex(char character)
+{
+	if(character >= 'a' && character <= 'z')
+	{
+		character = character - 'a' + 'A';
+	}
+
+	size_t glyphIndex = GlyphOrder.find(character);
+	if(glyphIndex == std::string_view::npos)
+	{
+		return 0;
+	}
+
+	return (uint32_t)glyphIndex;
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <array>
+#include <string_view>
+#include <DirectXMath.h>
+#include "RenderStatistics.hpp"
+#include "FrameLatency.hpp"
+
+class ModernFrameGraph;
+
+struct PerformanceHudVertex
+{
+	DirectX::XMFLOAT2 Position;   //Normalized device coordinates with the origin at the top-left corner and Y pointing down
+	DirectX::XMFLOAT2 GlyphCoord; //Position inside the glyph cell, in font pixels
+	uint32_t          GlyphIndex; //Glyph cell in the font bitmap, or PerformanceHud::SolidGlyphIndex for filled rectangles
+	uint32_t          Color;      //Packed RGBA8 color
+};
+
+//CPU-side data of the performance overlay. The HUD render pass turns it into vertices each frame
+class PerformanceHud
+{
+public:
+	static constexpr uint32_t MaxVertexCount         = 8192;
+	static constexpr uint32_t FrameTimeHistoryLength = 128;
+
+	//The font is 5x7 pixels per glyph, the glyph cells are stored in the font bitmap in this order
+	//The cell after the last glyph is fully filled and used for solid rectangles
+	static constexpr uint32_t         GlyphWidth      = 5;
+	static constexpr uint32_t         GlyphHeight     = 7;
+	static constexpr std::string_view GlyphOrder      = " 0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ.:/%-()_";
+	static constexpr uint32_t         SolidGlyphIndex = (uint32_t)GlyphOrder.size();
+
+	//The font bitmap has one byte of coverage per texel, with all glyph cells in a single row
+	//The size is padded to whole dwords so the shaders can read it as a raw buffer
+	static constexpr uint32_t FontBitmapWidth  = (SolidGlyphIndex + 1) * GlyphWidth;
+	static constexpr uint32_t FontBitmapHeight = GlyphHeight;
+	static constexpr uint32_t FontBitmapSize   = (FontBitmapWidth * FontBitmapHeight + 3) & ~3u;
+
+public:
+	PerformanceHud();
+	~PerformanceHud();
+
+	//Sets the frame graph to take per-pass GPU timings from. Can be nullptr
+	void SetFrameGraph(const ModernFrameGraph* frameGraph);
+
+	//Shows or hides the overlay. The HUD render pass draws nothing while the overlay is hidden
+	void SetVisible(bool visible);
+	bool IsVisible() const;
+
+	//Records the data of the last finished frame. Should be called on the main thread outside of rendering
+	void UpdateFrameData(float frameTime, const RenderStatisticsCounters& frameCounters, const FrameLatencySample& latencySample);
+
+	//Builds the overlay geometry as a triangle list for a viewport of given size. Returns the number of vertices written
+	//Also measures the time it takes to do so, the value is shown on the next frame
+	uint32_t BuildVertices(std::span<PerformanceHudVertex> outVertices, uint32_t viewportWidth, uint32_t viewportHeight);
+
+	//Fills the font bitmap texels, row by row. outTexels should be at least FontBitmapSize bytes
+	static void BuildFontBitmap(std::span<uint8_t> outTexels);
+
+private:
+	uint32_t AddRectangle(std::span<PerformanceHudVertex> outVertices, uint32_t vertexOffset, float left, float top, float width, float height, uint32_t color)                 const;
+	uint32_t AddText(std::span<PerformanceHudVertex> outVertices, uint32_t vertexOffset, float left, float top, std::string_view text, uint32_t color)                          const;
+	uint32_t AddQuad(std::span<PerformanceHudVertex> outVertices, uint32_t vertexOffset, float left, float top, float width, float height, uint32_t glyphIndex, uint32_t color) const;
+
+	static uint32_t CharToGlyphIndex(char character);
+
+private:
+	const ModernFrameGraph* mFrameGraphRef;
+
+	bool mVisible;
+
+	std::array<float, FrameTimeHistoryLength> mFrameTimeHistory;
+	uint32_t                                  mFrameTimeHistoryHead;
+
+	RenderStatisticsCounters mLastFrameCounters;
+	FrameLatencySample       mLastLatencySample;
+
+	float mLastBuildTimeMs;
+
+	//Pixel to normalized device coordinates scale, valid during BuildVertices
+	float mPixelToNdcX;
+	float mPixelToNdcY;
+};
\ No newline at end of file
@@ -0,0 +1,131 @@
+#include "RenderStatistics.hpp"
+#include "../../Core/Timer.hpp"
+#include "../../Core/FrameCounter.hpp"
+#include "../../Logging/LoggerQueue.hpp"
+#include <vector>
+#include <mutex>
+#include <algorithm>
+#include <utility>
+#include <string>
+
+namespace
+{
+	//All live per-thread accumulators. Accumulators of finished threads flush their counters into gRetiredCounters
+	std::mutex                                gAccumulatorRegistryMutex;
+	std::vector<RenderStatisticsAccumulator*> gAccumulatorRegistry;
+	RenderStatisticsCounters                  gRetiredCounters = {};
+}
+
+RenderStatisticsAccumulator::RenderStatisticsAccumulator(): mDrawCount(0), mIndexCount(0), mTriangleCount(0), mPushConstantUpdateCount(0), mDescriptorSetBindCount(0), mBarrierCount(0), mUploadCopyRegionCount(0), mUploadByteCount(0)
+{
+	std::lock_guard<std::mutex> registryLock(gAccumulatorRegistryMutex);
+	gAccumulatorRegistry.push_back(this);
+}
+
+RenderStatisticsAccumulator::~RenderStatisticsAccumulator()
+{
+	std::lock_guard<std::mutex> registryLock(gAccumulatorRegistryMutex);
+	CollectTo(&gRetiredCounters);
+
+	gAccumulatorRegistry.erase(std::remove(gAccumulatorRegistry.begin(), gAccumulatorRegistry.end(), this), gAccumulatorRegistry.end());
+}
+
+RenderStatisticsAccumulator& RenderStatisticsAccumulator::ForCurrentThread()
+{
+	thread_local RenderStatisticsAccumulator threadAccumulator;
+	return threadAccumulator;
+}
+
+void RenderStatisticsAccumulator::CollectTo(RenderStatisticsCounters* outCounters)
+{
+	outCounters->DrawCount               += mDrawCount.exchange(0,               std::memory_order_relaxed);
+	outCounters->IndexCount              += mIndexCount.exchange(0,              std::memory_order_relaxed);
+	outCounters->TriangleCount           += mTriangleCount.exchange(0,           std::memory_order_relaxed);
+	outCounters->PushConstantUpdateCount += mPushConstantUpdateCount.exchange(0, std::memory_order_relaxed);
+	outCounters->DescriptorSetBindCount  += mDescriptorSetBindCount.exchange(0,  std::memory_order_relaxed);
+	outCounters->BarrierCount            += mBarrierCount.exchange(0,            std::memory_order_relaxed);
+	outCounters->UploadCopyRegionCount   += mUploadCopyRegionCount.exchange(0,   std::memory_order_relaxed);
+	outCounters->UploadByteCount         += mUploadByteCount.exchange(0,         std::memory_order_relaxed);
+}
+
+RenderStatistics::RenderStatistics()
+{
+	mLastFrameCounters       = {};
+	mTotalCounters           = {};
+	mLastLoggedTotalCounters = {};
+
+	mLastLoggedFrame = 0;
+	mLastLoggedTime  = 0.0f;
+}
+
+RenderStatistics::~RenderStatistics()
+{
+}
+
+void RenderStatistics::GatherFrame()
+{
+	mLastFrameCounters = {};
+
+	std::lock_guard<std::mutex> registryLock(gAccumulatorRegistryMutex);
+	for(RenderStatisticsAccumulator* accumulator: gAccumulatorRegistry)
+	{
+		accumulator->CollectTo(&mLastFrameCounters);
+	}
+
+	mLastFrameCounters.DrawCount               += std::exchange(gRetiredCounters.DrawCount,               0);
+	mLastFrameCounters.IndexCount              += std::exchange(gRetiredCounters.IndexCount,              0);
+	mLastFrameCounters.TriangleCount           += std::exchange(gRetiredCounters.TriangleCount,           0);
+	mLastFrameCounters.PushConstantUpdateCount += std::exchange(gRetiredCounters.PushConstantUpdateCount, 0);
+	mLastFrameCounters.DescriptorSetBindCount  += std::exchange(gRetiredCounters.DescriptorSetBindCount,  0);
+	mLastFrameCounters.BarrierCount            += std::exchange(gRetiredCounters.BarrierCount,            0);
+	mLastFrameCounters.UploadCopyRegionCount   += std::exchange(gRetiredCounters.UploadCopyRegionCount,   0);
+	mLastFrameCounters.UploadByteCount         += std::exchange(gRetiredCounters.UploadByteCount,         0);
+
+	mTotalCounters.DrawCount               += mLastFrameCounters.DrawCount;
+	mTotalCounters.IndexCount              += mLastFrameCounters.IndexCount;
+	mTotalCounters.TriangleCount           += mLastFrameCounters.TriangleCount;
+	mTotalCounters.PushConstantUpdateCount += mLastFrameCounters.PushConstantUpdateCount;
+	mTotalCounters.DescriptorSetBindCount  += mLastFrameCounters.DescriptorSetBindCount;
+	mTotalCounters.BarrierCount            += mLastFrameCounters.BarrierCount;
+	mTotalCounters.UploadCopyRegionCount   += mLastFrameCounters.UploadCopyRegionCount;
+	mTotalCounters.UploadByteCount         += mLastFrameCounters.UploadByteCount;
+}
+
+const RenderStatisticsCounters& RenderStatistics::GetLastFrameCounters() const
+{
+	return mLastFrameCounters;
+}
+
+const RenderStatisticsCounters& RenderStatistics::GetTotalCounters() const
+{
+	return mTotalCounters;
+}
+
+void RenderStatistics::LogStatistics(const FrameCounter* frameCounter, const Timer* timer, LoggerQueue* logger)
+{
+	float    currMeasurementTime = timer->GetCurrTime();
+	uint64_t frameIndex          = frameCounter->GetFrameCount();
+
+	if(currMeasurementTime - mLastLoggedTime >= 1.0f && frameIndex > mLastLoggedFrame)
+	{
+		//Log the average per-frame values since the last measurement
+		uint64_t frameCount = frameIndex - mLastLoggedFrame;
+		auto perFrame = [frameCount](uint64_t currTotal, uint64_t lastTotal)
+		{
+			return std::to_string((currTotal - lastTotal) / frameCount);
+		};
+
+		logger->PostLogMessage("Render stats per frame: draws: "            + perFrame(mTotalCounters.DrawCount,               mLastLoggedTotalCounters.DrawCount)
+		                                           + ", indices: "          + perFrame(mTotalCounters.IndexCount,              mLastLoggedTotalCounters.IndexCount)
+		                                           + ", triangles: "        + perFrame(mTotalCounters.TriangleCount,           mLastLoggedTotalCounters.TriangleCount)
+		                                           + ", push constants: "   + perFrame(mTotalCounters.PushConstantUpdateCount, mLastLoggedTotalCounters.PushConstantUpdateCount)
+		                                           + ", descriptor binds: " + perFrame(mTotalCounters.DescriptorSetBindCount,  mLastLoggedTotalCounters.DescriptorSetBindCount)
+		                                           + ", barriers: "         + perFrame(mTotalCounters.BarrierCount,            mLastLoggedTotalCounters.BarrierCount)
+		                                           + ", upload copies: "    + perFrame(mTotalCounters.UploadCopyRegionCount,   mLastLoggedTotalCounters.UploadCopyRegionCount)
+		                                           + ", upload bytes: "     + perFrame(mTotalCounters.UploadByteCount,         mLastLoggedTotalCounters.UploadByteCount));
+
+		mLastLoggedTotalCounters = mTotalCounters;
+		mLastLoggedFrame         = frameIndex;
+		mLastLoggedTime          = currMeasurementTime;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+
+class Timer;
+class FrameCounter;
+class LoggerQueue;
+
+struct RenderStatisticsCounters
+{
+	uint64_t DrawCount;
+	uint64_t IndexCount;
+	uint64_t TriangleCount;
+	uint64_t PushConstantUpdateCount;
+	uint64_t DescriptorSetBindCount;
+	uint64_t BarrierCount;
+	uint64_t UploadCopyRegionCount;
+	uint64_t UploadByteCount;
+};
+
+//Per-thread counter storage. Only the owning thread increments the counters, the main thread collects them at the end of the frame
+class alignas(64) RenderStatisticsAccumulator
+{
+	friend class RenderStatistics;
+
+public:
+	RenderStatisticsAccumulator();
+	~RenderStatisticsAccumulator();
+
+	static RenderStatisticsAccumulator& ForCurrentThread();
+
+	inline void AddDraw(uint32_t indexCount, uint32_t instanceCount);
+	inline void AddPushConstantUpdates(uint32_t updateCount);
+	inline void AddDescriptorSetBinds(uint32_t setCount);
+	inline void AddBarriers(uint32_t barrierCount);
+	inline void AddUploadCopies(uint32_t regionCount, uint64_t byteCount);
+
+private:
+	void CollectTo(RenderStatisticsCounters* outCounters);
+
+private:
+	std::atomic<uint64_t> mDrawCount;
+	std::atomic<uint64_t> mIndexCount;
+	std::atomic<uint64_t> mTriangleCount;
+	std::atomic<uint64_t> mPushConstantUpdateCount;
+	std::atomic<uint64_t> mDescriptorSetBindCount;
+	std::atomic<uint64_t> mBarrierCount;
+	std::atomic<uint64_t> mUploadCopyRegionCount;
+	std::atomic<uint64_t> mUploadByteCount;
+};
+
+class RenderStatistics
+{
+public:
+	RenderStatistics();
+	~RenderStatistics();
+
+	//Gathers the counters from all thread accumulators. Should be called once per frame after all command recording is finished
+	void GatherFrame();
+
+	const RenderStatisticsCounters& GetLastFrameCounters() const;
+	const RenderStatisticsCounters& GetTotalCounters()     const;
+
+	void LogStatistics(const FrameCounter* frameCounter, const Timer* timer, LoggerQueue* logger);
+
+private:
+	RenderStatisticsCounters mLastFrameCounters;
+	RenderStatisticsCounters mTotalCounters;
+
+	RenderStatisticsCounters mLastLoggedTotalCounters;
+	uint64_t                 mLastLoggedFrame;
+	float                    mLastLoggedTime;
+};
+
+#include "RenderStatistics.inl"
\ No newline at end of file
@@ -0,0 +1,27 @@
+inline void RenderStatisticsAccumulator::AddDraw(uint32_t indexCount, uint32_t instanceCount)
+{
+	mDrawCount.fetch_add(1, std::memory_order_relaxed);
+	mIndexCount.fetch_add((uint64_t)indexCount * instanceCount, std::memory_order_relaxed);
+	mTriangleCount.fetch_add((uint64_t)(indexCount / 3) * instanceCount, std::memory_order_relaxed);
+}
+
+inline void RenderStatisticsAccumulator::AddPushConstantUpdates(uint32_t updateCount)
+{
+	mPushConstantUpdateCount.fetch_add(updateCount, std::memory_order_relaxed);
+}
+
+inline void RenderStatisticsAccumulator::AddDescriptorSetBinds(uint32_t setCount)
+{
+	mDescriptorSetBindCount.fetch_add(setCount, std::memory_order_relaxed);
+}
+
+inline void RenderStatisticsAccumulator::AddBarriers(uint32_t barrierCount)
+{
+	mBarrierCount.fetch_add(barrierCount, std::memory_order_relaxed);
+}
+
+inline void RenderStatisticsAccumulator::AddUploadCopies(uint32_t regionCount, uint64_t byteCount)
+{
+	mUploadCopyRegionCount.fetch_add(regionCount, std::memory_order_relaxed);
+	mUploadByteCount.fetch_add(byteCount, std::memory_order_relaxed);
+}
\ No newline at end of file
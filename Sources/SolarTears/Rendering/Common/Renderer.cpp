@@ -1,9 +1,27 @@
 #include "Renderer.hpp"
+#include "PerformanceHud.hpp"
+#include "FrameLatency.hpp"
+#include "../../Core/Util.hpp"
 
 Renderer::Renderer(LoggerQueue* loggerQueue): mLoggingBoard(loggerQueue)
 {
+	mPerformanceHud = std::make_unique<PerformanceHud>();
+	mLatencyTracker = std::make_unique<FrameLatencyTracker>();
+	mSceneBakeCache = std::make_unique<RenderableSceneBakeCache>();
+
+	mSceneCacheFilename = Utils::GetMainDirectory() + L"SceneCache.bin";
 }
 
 Renderer::~Renderer()
 {
+}
+
+PerformanceHud* Renderer::GetPerformanceHud() const
+{
+	return mPerformanceHud.get();
+}
+
+FrameLatencyTracker* Renderer::GetLatencyTracker() const
+{
+	return mLatencyTracker.get();
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "../../Core/Window.hpp"
 #include "../../Logging/LoggerQueue.hpp"
 #include "Scene/BaseRenderableSceneBuilder.hpp"
+#include <memory>
 
 /*	
 	My manifesto:
@@ -19,6 +20,8 @@
 struct FrameGraphDescription;
 class  FrameGraphConfig;
 class  BaseRenderableScene;
+class  PerformanceHud;
+class  FrameLatencyTracker;
 
 class Renderer
 {
@@ -34,6 +37,18 @@ public:
 
 	virtual void Render() = 0;
 
+	PerformanceHud*      GetPerformanceHud() const;
+	FrameLatencyTracker* GetLatencyTracker() const;
+
 protected:
 	LoggerQueue* mLoggingBoard;
+
+	std::unique_ptr<PerformanceHud>      mPerformanceHud;
+	std::unique_ptr<FrameLatencyTracker> mLatencyTracker;
+
+	//Outlives the scenes, so the next InitScene() call with an edited description only redoes the CPU work for the changed parts
+	std::unique_ptr<RenderableSceneBakeCache> mSceneBakeCache;
+
+	//The baked scene is saved there, the next launches with the same scene description load it instead of building it again
+	std::wstring mSceneCacheFilename;
 };
\ No newline at end of file
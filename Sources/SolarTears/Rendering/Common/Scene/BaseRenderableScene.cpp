@@ -1,4 +1,10 @@
 #include "BaseRenderableScene.hpp"
+#include "FrustumCuller.hpp"
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <limits>
+#include <cassert>
 
 BaseRenderableScene::BaseRenderableScene()
 {
@@ -7,6 +13,22 @@ BaseRenderableScene::BaseRenderableScene()
 
 	mNonStaticMeshSpan.Begin = 0;
 	mNonStaticMeshSpan.End   = 0;
+
+	mRigidMeshSpan.Begin = 0;
+	mRigidMeshSpan.End   = 0;
+
+	mHlodProxyMeshSpan.Begin = 0;
+	mHlodProxyMeshSpan.End   = 0;
+
+	mDynamicMeshSpan.Begin = 0;
+	mDynamicMeshSpan.End   = 0;
+
+	DirectX::XMStoreFloat4x4(&mCullingViewProjMatrix, DirectX::XMMatrixIdentity());
+	mCullingCameraPosition = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
+	mCullingProjScale      = 1.0f;
+
+	mVisibleNonStaticMeshOffset = 0;
+	mLastFrustumMeshCount       = 0;
 }
 
 BaseRenderableScene::~BaseRenderableScene()
@@ -15,18 +37,21 @@ BaseRenderableScene::~BaseRenderableScene()
 
 BaseRenderableScene::PerObjectData BaseRenderableScene::PackObjectData(const SceneObjectLocation& sceneObjectLocation) const
 {
-	const DirectX::XMVECTOR scale    = DirectX::XMVectorSet(sceneObjectLocation.Scale, sceneObjectLocation.Scale, sceneObjectLocation.Scale, 0.0f);
+	//Same as XMMatrixAffineTransformation(), but the uniform scale doesn't need a full matrix multiplication. It runs for every moved object every frame
+	const DirectX::XMVECTOR scale    = DirectX::XMVectorReplicate(sceneObjectLocation.Scale);
 	const DirectX::XMVECTOR rotation = DirectX::XMLoadFloat4(&sceneObjectLocation.RotationQuaternion);
 	const DirectX::XMVECTOR position = DirectX::XMLoadFloat3(&sceneObjectLocation.Position);
-	const DirectX::XMVECTOR zeroVec  = DirectX::XMVectorZero();
 
-	DirectX::XMFLOAT4X4 objectMatrix;
-	DirectX::XMStoreFloat4x4(&objectMatrix, DirectX::XMMatrixAffineTransformation(scale, zeroVec, rotation, position));
+	DirectX::XMMATRIX objectMatrix = DirectX::XMMatrixRotationQuaternion(rotation);
+	objectMatrix.r[0] = DirectX::XMVectorMultiply(objectMatrix.r[0], scale);
+	objectMatrix.r[1] = DirectX::XMVectorMultiply(objectMatrix.r[1], scale);
+	objectMatrix.r[2] = DirectX::XMVectorMultiply(objectMatrix.r[2], scale);
+	objectMatrix.r[3] = DirectX::XMVectorSetW(position, 1.0f);
 
-	return BaseRenderableScene::PerObjectData
-	{
-		.WorldMatrix = objectMatrix
-	};
+	BaseRenderableScene::PerObjectData objectData;
+	DirectX::XMStoreFloat4x4(&objectData.WorldMatrix, objectMatrix);
+
+	return objectData;
 }
 
 BaseRenderableScene::PerFrameData BaseRenderableScene::PackFrameData(const SceneObjectLocation& cameraLocation, DirectX::FXMMATRIX ProjMatrix) const
@@ -47,4 +72,486 @@ BaseRenderableScene::PerFrameData BaseRenderableScene::PackFrameData(const Scene
 	{
 		.ViewProjMatrix = viewProj
 	};
+}
+
+void BaseRenderableScene::CullMeshes(ThreadPool* threadPool)
+{
+	//The refits keep the rigid mesh tree correct, but not fast to query
+	if(mRigidMeshTree.GetQualityDegradation() > MaxRigidMeshTreeDegradation)
+	{
+		mRigidMeshTree.Rebuild(threadPool);
+	}
+
+	DirectX::XMMATRIX cullingViewProjMatrix = DirectX::XMLoadFloat4x4(&mCullingViewProjMatrix);
+
+	//The tree walk only pays off when it skips most of the meshes. The last frame tells if it does, the camera doesn't move much between the frames
+	mVisibleMeshIndices.clear();
+	if((float)mLastFrustumMeshCount > MaxTreeCullingPassRate * (float)mMeshCuller.GetSphereCount())
+	{
+		mMeshCuller.Cull(threadPool, cullingViewProjMatrix);
+
+		std::span<const uint32_t> frustumMeshIndices = mMeshCuller.GetVisibleIndices();
+		auto frustumDynamicMeshesBegin = std::lower_bound(frustumMeshIndices.begin(), frustumMeshIndices.end(), mDynamicMeshSpan.Begin);
+
+		mVisibleMeshIndices.assign(frustumMeshIndices.begin(), frustumDynamicMeshesBegin);
+		std::copy_if(frustumDynamicMeshesBegin, frustumMeshIndices.end(), std::back_inserter(mVisibleMeshIndices), [this](uint32_t meshIndex)
+		{
+			return mSceneMeshes[meshIndex].InstanceCount != 0;
+		});
+	}
+	else
+	{
+		QueryMeshesInFrustum(cullingViewProjMatrix, mVisibleMeshIndices, threadPool);
+	}
+
+	mLastFrustumMeshCount = (uint32_t)mVisibleMeshIndices.size();
+
+	//The occlusion test only needs to see what gets drawn
+	if(!mHlodClusterParents.empty())
+	{
+		ReplaceFarClustersWithProxies(cullingViewProjMatrix);
+	}
+
+	if(mOcclusionCuller.GetOccluderTriangleCount() != 0)
+	{
+		mOcclusionCuller.RenderOccluders(threadPool, cullingViewProjMatrix);
+		std::erase_if(mVisibleMeshIndices, [this](uint32_t meshIndex)
+		{
+			return !mOcclusionCuller.IsBoxVisible(GetMeshBounds(meshIndex));
+		});
+	}
+
+	SelectMeshLods();
+
+	//Drawing in mesh order keeps the static meshes first and the geometry access coherent. The proxy meshes come after the baked ones in the mesh order, move them to the front
+	std::sort(mVisibleMeshIndices.begin(), mVisibleMeshIndices.end());
+
+	auto visibleProxyMeshesBegin     = std::lower_bound(mVisibleMeshIndices.begin(), mVisibleMeshIndices.end(), mHlodProxyMeshSpan.Begin);
+	auto visibleProxyMeshesEnd       = std::lower_bound(visibleProxyMeshesBegin,     mVisibleMeshIndices.end(), mHlodProxyMeshSpan.End);
+	auto visibleNonStaticMeshesBegin = std::lower_bound(mVisibleMeshIndices.begin(), visibleProxyMeshesBegin,   mNonStaticMeshSpan.Begin);
+
+	mVisibleNonStaticMeshOffset = (uint32_t)(visibleNonStaticMeshesBegin - mVisibleMeshIndices.begin()) + (uint32_t)(visibleProxyMeshesEnd - visibleProxyMeshesBegin);
+	std::rotate(mVisibleMeshIndices.begin(), visibleProxyMeshesBegin, visibleProxyMeshesEnd);
+}
+
+RenderableSceneObjectHandle BaseRenderableScene::AddObject(RenderableSceneObjectHandle prototypeObjectHandle, const SceneObjectLocation& location)
+{
+	assert(IsObjectAlive(prototypeObjectHandle));
+	if(mFreeDynamicObjectSlots.empty())
+	{
+		return InvalidRenderableObjectHandle;
+	}
+
+	uint32_t slotIndex = mFreeDynamicObjectSlots.back();
+	mFreeDynamicObjectSlots.pop_back();
+
+	uint32_t prototypeObjectIndex = GetRenderableObjectIndex(prototypeObjectHandle);
+	uint32_t meshIndex            = mDynamicMeshSpan.Begin + slotIndex;
+
+	//The slot mesh draws the submeshes of the prototype mesh with its own object data
+	const SceneMesh& prototypeMesh = mSceneMeshes[mObjectMeshIndices[prototypeObjectIndex]];
+	SceneMesh&       slotMesh      = mSceneMeshes[meshIndex];
+
+	slotMesh.InstanceCount         = 1;
+	slotMesh.FirstSubmeshIndex     = prototypeMesh.FirstSubmeshIndex;
+	slotMesh.AfterLastSubmeshIndex = prototypeMesh.AfterLastSubmeshIndex;
+
+	mMeshLodLevels[meshIndex] = 0;
+
+	uint32_t objectIndex = slotMesh.PerObjectDataIndex;
+	mObjectLocalBoundingSpheres[objectIndex] = mObjectLocalBoundingSpheres[prototypeObjectIndex];
+	mObjectBoundingSpheres[objectIndex]      = TransformBoundingSphere(mObjectLocalBoundingSpheres[objectIndex], location);
+
+	DirectX::BoundingBox meshBounds;
+	DirectX::BoundingBox::CreateFromSphere(meshBounds, mObjectBoundingSpheres[objectIndex]);
+	mDynamicMeshTree.UpdateItemBounds(slotIndex, meshBounds);
+	mMeshCuller.SetBoundingSphere(meshIndex, mObjectBoundingSpheres[objectIndex]);
+
+	RenderableSceneObjectHandle objectHandle = MakeRenderableObjectHandle(objectIndex, mDynamicObjectGenerations[slotIndex]);
+	mAddedObjectUpdates.push_back(ObjectDataUpdateInfo
+	{
+		.ObjectId          = objectHandle,
+		.NewObjectLocation = location
+	});
+
+	return objectHandle;
+}
+
+void BaseRenderableScene::RemoveObject(RenderableSceneObjectHandle objectHandle)
+{
+	assert(IsObjectAlive(objectHandle));
+
+	uint32_t meshIndex = mObjectMeshIndices[GetRenderableObjectIndex(objectHandle)];
+	assert(meshIndex >= mDynamicMeshSpan.Begin && meshIndex < mDynamicMeshSpan.End);
+
+	uint32_t slotIndex = meshIndex - mDynamicMeshSpan.Begin;
+	mSceneMeshes[meshIndex].InstanceCount = 0;
+	mDynamicObjectGenerations[slotIndex]++;
+
+	mRemovedDynamicObjectSlots.push_back(slotIndex);
+}
+
+bool BaseRenderableScene::IsObjectAlive(RenderableSceneObjectHandle objectHandle) const
+{
+	uint32_t objectIndex = GetRenderableObjectIndex(objectHandle);
+	if(objectIndex >= mObjectMeshIndices.size())
+	{
+		return false;
+	}
+
+	//The baked objects are never removed
+	uint32_t meshIndex = mObjectMeshIndices[objectIndex];
+	if(meshIndex < mDynamicMeshSpan.Begin || meshIndex >= mDynamicMeshSpan.End)
+	{
+		return GetRenderableObjectGeneration(objectHandle) == 0;
+	}
+
+	return mSceneMeshes[meshIndex].InstanceCount != 0 && GetRenderableObjectGeneration(objectHandle) == mDynamicObjectGenerations[meshIndex - mDynamicMeshSpan.Begin];
+}
+
+uint32_t BaseRenderableScene::GetMeshCount() const
+{
+	return (uint32_t)mSceneMeshes.size();
+}
+
+uint32_t BaseRenderableScene::GetVisibleMeshCount() const
+{
+	return (uint32_t)mVisibleMeshIndices.size();
+}
+
+void BaseRenderableScene::QueryMeshesInFrustum(DirectX::FXMMATRIX viewProjMatrix, std::vector<uint32_t>& outMeshIndices, ThreadPool* threadPool) const
+{
+	std::array<DirectX::XMFLOAT4, FrustumCuller::FrustumPlaneCount> frustumPlanes;
+	FrustumCuller::ExtractFrustumPlanes(viewProjMatrix, frustumPlanes);
+
+	mStaticMeshTree.QueryFrustum(frustumPlanes, outMeshIndices, threadPool);
+
+	size_t rigidMeshIndicesStart = outMeshIndices.size();
+	mRigidMeshTree.QueryFrustum(frustumPlanes, outMeshIndices, threadPool);
+	std::for_each(outMeshIndices.begin() + rigidMeshIndicesStart, outMeshIndices.end(), [this](uint32_t& meshIndex) {meshIndex += mRigidMeshSpan.Begin;});
+
+	size_t dynamicMeshIndicesStart = outMeshIndices.size();
+	mDynamicMeshTree.QueryFrustum(frustumPlanes, outMeshIndices, nullptr);
+	FinishDynamicMeshQuery(outMeshIndices, dynamicMeshIndicesStart);
+}
+
+void BaseRenderableScene::QueryMeshesInSphere(const DirectX::BoundingSphere& sphere, std::vector<uint32_t>& outMeshIndices) const
+{
+	mStaticMeshTree.QuerySphere(sphere, outMeshIndices);
+
+	size_t rigidMeshIndicesStart = outMeshIndices.size();
+	mRigidMeshTree.QuerySphere(sphere, outMeshIndices);
+	std::for_each(outMeshIndices.begin() + rigidMeshIndicesStart, outMeshIndices.end(), [this](uint32_t& meshIndex) {meshIndex += mRigidMeshSpan.Begin;});
+
+	size_t dynamicMeshIndicesStart = outMeshIndices.size();
+	mDynamicMeshTree.QuerySphere(sphere, outMeshIndices);
+	FinishDynamicMeshQuery(outMeshIndices, dynamicMeshIndicesStart);
+}
+
+void BaseRenderableScene::QueryMeshesOnRay(DirectX::FXMVECTOR origin, DirectX::FXMVECTOR direction, float maxDistance, std::vector<uint32_t>& outMeshIndices) const
+{
+	mStaticMeshTree.QueryRay(origin, direction, maxDistance, outMeshIndices);
+
+	size_t rigidMeshIndicesStart = outMeshIndices.size();
+	mRigidMeshTree.QueryRay(origin, direction, maxDistance, outMeshIndices);
+	std::for_each(outMeshIndices.begin() + rigidMeshIndicesStart, outMeshIndices.end(), [this](uint32_t& meshIndex) {meshIndex += mRigidMeshSpan.Begin;});
+
+	size_t dynamicMeshIndicesStart = outMeshIndices.size();
+	mDynamicMeshTree.QueryRay(origin, direction, maxDistance, outMeshIndices);
+	FinishDynamicMeshQuery(outMeshIndices, dynamicMeshIndicesStart);
+}
+
+void BaseRenderableScene::ReplaceFarClustersWithProxies(DirectX::FXMMATRIX viewProjMatrix)
+{
+	std::array<DirectX::XMFLOAT4, FrustumCuller::FrustumPlaneCount> frustumPlanes;
+	FrustumCuller::ExtractFrustumPlanes(viewProjMatrix, frustumPlanes);
+
+	//The bounds of a cluster enclose its meshes, so the clusters of all visible meshes are in the frustum
+	mVisibleHlodClusterIndices.clear();
+	mHlodClusterTree.QueryFrustum(frustumPlanes, mVisibleHlodClusterIndices, nullptr);
+	for(uint32_t clusterIndex: mVisibleHlodClusterIndices)
+	{
+		DirectX::BoundingBox clusterBounds = mHlodClusterTree.GetItemBounds(clusterIndex);
+		DirectX::XMVECTOR    extents       = DirectX::XMLoadFloat3(&clusterBounds.Extents);
+
+		float screenSize = CalculateScreenSize(DirectX::XMLoadFloat3(&clusterBounds.Center), DirectX::XMVectorGetX(DirectX::XMVector3Length(extents)));
+
+		//The same hysteresis as for the levels of detail
+		bool wasCollapsed = mHlodClusterFlags[clusterIndex] & (uint8_t)HlodClusterFlags::Collapsed;
+		bool isCollapsed  = wasCollapsed ? (screenSize <= HlodMaxScreenSize * LodHysteresis) : (screenSize < HlodMaxScreenSize);
+		mHlodClusterFlags[clusterIndex] = isCollapsed ? (uint8_t)HlodClusterFlags::Collapsed : 0;
+	}
+
+	mVisibleProxyMeshIndices.clear();
+	std::erase_if(mVisibleMeshIndices, [this](uint32_t meshIndex)
+	{
+		if(meshIndex >= mStaticUniqueMeshSpan.End)
+		{
+			return false;
+		}
+
+		uint32_t collapsedClusterIndex = NoHlodCluster;
+		for(uint32_t clusterIndex = mStaticMeshHlodClusters[meshIndex]; clusterIndex != NoHlodCluster; clusterIndex = mHlodClusterParents[clusterIndex])
+		{
+			if(mHlodClusterFlags[clusterIndex] & (uint8_t)HlodClusterFlags::Collapsed)
+			{
+				collapsedClusterIndex = clusterIndex;
+			}
+		}
+
+		if(collapsedClusterIndex == NoHlodCluster)
+		{
+			return false;
+		}
+
+		if(!(mHlodClusterFlags[collapsedClusterIndex] & (uint8_t)HlodClusterFlags::ProxyVisible))
+		{
+			mHlodClusterFlags[collapsedClusterIndex] |= (uint8_t)HlodClusterFlags::ProxyVisible;
+			mVisibleProxyMeshIndices.push_back(mHlodProxyMeshSpan.Begin + collapsedClusterIndex);
+		}
+
+		return true;
+	});
+
+	for(uint32_t proxyMeshIndex: mVisibleProxyMeshIndices)
+	{
+		mHlodClusterFlags[proxyMeshIndex - mHlodProxyMeshSpan.Begin] &= ~(uint8_t)HlodClusterFlags::ProxyVisible;
+	}
+
+	mVisibleMeshIndices.insert(mVisibleMeshIndices.end(), mVisibleProxyMeshIndices.begin(), mVisibleProxyMeshIndices.end());
+}
+
+void BaseRenderableScene::SelectMeshLods()
+{
+	for(uint32_t meshIndex: mVisibleMeshIndices)
+	{
+		//The proxy meshes have a single level of detail
+		if(meshIndex >= mHlodProxyMeshSpan.Begin && meshIndex < mHlodProxyMeshSpan.End)
+		{
+			continue;
+		}
+
+		float screenSize = 0.0f;
+		if(meshIndex < mNonStaticMeshSpan.Begin)
+		{
+			DirectX::BoundingBox meshBounds = mStaticMeshTree.GetItemBounds(meshIndex);
+			DirectX::XMVECTOR    extents    = DirectX::XMLoadFloat3(&meshBounds.Extents);
+
+			screenSize = CalculateScreenSize(DirectX::XMLoadFloat3(&meshBounds.Center), DirectX::XMVectorGetX(DirectX::XMVector3Length(extents)));
+		}
+		else
+		{
+			const SceneMesh& sceneMesh = mSceneMeshes[meshIndex];
+			for(uint32_t objectIndex = sceneMesh.PerObjectDataIndex; objectIndex < sceneMesh.PerObjectDataIndex + sceneMesh.InstanceCount; objectIndex++)
+			{
+				const DirectX::BoundingSphere& objectSphere = mObjectBoundingSpheres[objectIndex];
+				screenSize = std::max(screenSize, CalculateScreenSize(DirectX::XMLoadFloat3(&objectSphere.Center), objectSphere.Radius));
+			}
+		}
+
+		mMeshLodLevels[meshIndex] = (uint8_t)SelectLodLevel(screenSize, mMeshLodLevels[meshIndex]);
+	}
+}
+
+float BaseRenderableScene::CalculateScreenSize(DirectX::FXMVECTOR center, float radius) const
+{
+	float distance = DirectX::XMVectorGetX(DirectX::XMVector3Length(DirectX::XMVectorSubtract(center, DirectX::XMLoadFloat3(&mCullingCameraPosition))));
+	return (distance > radius) ? (radius * mCullingProjScale / distance) : std::numeric_limits<float>::max();
+}
+
+uint32_t BaseRenderableScene::SelectLodLevel(float screenSize, uint32_t currentLodLevel)
+{
+	//Level k is for the screen sizes between LodZeroMinScreenSize / 2^k and LodZeroMinScreenSize / 2^(k - 1)
+	uint32_t lodLevel         = 0;
+	float    lodMinScreenSize = LodZeroMinScreenSize;
+	while(lodLevel + 1 < MaxLodCount && screenSize < lodMinScreenSize)
+	{
+		lodLevel++;
+		lodMinScreenSize *= 0.5f;
+	}
+
+	if(lodLevel == currentLodLevel)
+	{
+		return lodLevel;
+	}
+
+	//Stay on the current level until the size leaves its range widened by the hysteresis
+	float currentMinScreenSize = (currentLodLevel + 1 < MaxLodCount) ? (LodZeroMinScreenSize / (float)(1u << currentLodLevel)) : 0.0f;
+	float currentMaxScreenSize = (currentLodLevel > 0)               ? (LodZeroMinScreenSize / (float)(1u << (currentLodLevel - 1))) : std::numeric_limits<float>::max();
+	if(screenSize * LodHysteresis >= currentMinScreenSize && screenSize <= currentMaxScreenSize * LodHysteresis)
+	{
+		return currentLodLevel;
+	}
+
+	return lodLevel;
+}
+
+DirectX::BoundingBox BaseRenderableScene::GetMeshBounds(uint32_t meshIndex) const
+{
+	if(meshIndex >= mDynamicMeshSpan.Begin && meshIndex < mDynamicMeshSpan.End)
+	{
+		return mDynamicMeshTree.GetItemBounds(meshIndex - mDynamicMeshSpan.Begin);
+	}
+	else if(meshIndex >= mHlodProxyMeshSpan.Begin && meshIndex < mHlodProxyMeshSpan.End)
+	{
+		return mHlodClusterTree.GetItemBounds(meshIndex - mHlodProxyMeshSpan.Begin);
+	}
+	else if(meshIndex >= mRigidMeshSpan.Begin && meshIndex < mRigidMeshSpan.End)
+	{
+		return mRigidMeshTree.GetItemBounds(meshIndex - mRigidMeshSpan.Begin);
+	}
+	else
+	{
+		return mStaticMeshTree.GetItemBounds(meshIndex);
+	}
+}
+
+DirectX::BoundingSphere BaseRenderableScene::TransformBoundingSphere(const DirectX::BoundingSphere& sphere, const SceneObjectLocation& location)
+{
+	DirectX::BoundingSphere transformedSphere;
+	sphere.Transform(transformedSphere, location.Scale, DirectX::XMLoadFloat4(&location.RotationQuaternion), DirectX::XMLoadFloat3(&location.Position));
+
+	return transformedSphere;
+}
+
+void BaseRenderableScene::UpdateObjectBoundingSpheres(std::span<const ObjectDataUpdateInfo> objectUpdates)
+{
+	//The updates are sorted, so the instances of the same mesh come one after another
+	mMovedInstancedMeshIndices.clear();
+	for(const ObjectDataUpdateInfo& objectUpdate: objectUpdates)
+	{
+		uint32_t objectIndex = GetRenderableObjectIndex(objectUpdate.ObjectId);
+		uint32_t meshIndex   = mObjectMeshIndices[objectIndex];
+
+		assert(IsObjectAlive(objectUpdate.ObjectId));
+		assert((meshIndex >= mRigidMeshSpan.Begin && meshIndex < mRigidMeshSpan.End) || (meshIndex >= mDynamicMeshSpan.Begin && meshIndex < mDynamicMeshSpan.End));
+
+		mObjectBoundingSpheres[objectIndex] = TransformBoundingSphere(mObjectLocalBoundingSpheres[objectIndex], objectUpdate.NewObjectLocation);
+		if(meshIndex >= mDynamicMeshSpan.Begin && meshIndex < mDynamicMeshSpan.End)
+		{
+			DirectX::BoundingBox meshBounds;
+			DirectX::BoundingBox::CreateFromSphere(meshBounds, mObjectBoundingSpheres[objectIndex]);
+			mDynamicMeshTree.UpdateItemBounds(meshIndex - mDynamicMeshSpan.Begin, meshBounds);
+			mMeshCuller.SetBoundingSphere(meshIndex, mObjectBoundingSpheres[objectIndex]);
+		}
+		else if(mSceneMeshes[meshIndex].InstanceCount == 1)
+		{
+			DirectX::BoundingBox meshBounds;
+			DirectX::BoundingBox::CreateFromSphere(meshBounds, mObjectBoundingSpheres[objectIndex]);
+			mRigidMeshTree.UpdateItemBounds(meshIndex - mRigidMeshSpan.Begin, meshBounds);
+			mMeshCuller.SetBoundingSphere(meshIndex, mObjectBoundingSpheres[objectIndex]);
+		}
+		else if(mMovedInstancedMeshIndices.empty() || mMovedInstancedMeshIndices.back() != meshIndex)
+		{
+			mMovedInstancedMeshIndices.push_back(meshIndex);
+		}
+	}
+
+	for(uint32_t meshIndex: mMovedInstancedMeshIndices)
+	{
+		const SceneMesh& sceneMesh = mSceneMeshes[meshIndex];
+
+		DirectX::BoundingSphere meshSphere = mObjectBoundingSpheres[sceneMesh.PerObjectDataIndex];
+		for(uint32_t instanceIndex = 1; instanceIndex < sceneMesh.InstanceCount; instanceIndex++)
+		{
+			DirectX::BoundingSphere::CreateMerged(meshSphere, meshSphere, mObjectBoundingSpheres[sceneMesh.PerObjectDataIndex + instanceIndex]);
+		}
+
+		DirectX::BoundingBox meshBounds;
+		DirectX::BoundingBox::CreateFromSphere(meshBounds, meshSphere);
+		mRigidMeshTree.UpdateItemBounds(meshIndex - mRigidMeshSpan.Begin, meshBounds);
+		mMeshCuller.SetBoundingSphere(meshIndex, meshSphere);
+	}
+
+	mRigidMeshTree.Refit();
+	mDynamicMeshTree.Refit();
+}
+
+std::span<const ObjectDataUpdateInfo> BaseRenderableScene::MergeAddedObjectUpdates(std::span<const ObjectDataUpdateInfo> objectUpdates)
+{
+	if(mAddedObjectUpdates.empty())
+	{
+		return objectUpdates;
+	}
+
+	auto objectIndexLess = [](const ObjectDataUpdateInfo& left, const ObjectDataUpdateInfo& right)
+	{
+		return GetRenderableObjectIndex(left.ObjectId) < GetRenderableObjectIndex(right.ObjectId);
+	};
+
+	//The objects removed right after being added don't need the upload
+	std::erase_if(mAddedObjectUpdates, [this](const ObjectDataUpdateInfo& addedObjectUpdate)
+	{
+		return !IsObjectAlive(addedObjectUpdate.ObjectId);
+	});
+
+	std::sort(mAddedObjectUpdates.begin(), mAddedObjectUpdates.end(), objectIndexLess);
+
+	//The merge keeps the elements of the first range first, so the same frame update of a just added object wins over its initial location
+	mMergedObjectUpdates.clear();
+	std::merge(objectUpdates.begin(), objectUpdates.end(), mAddedObjectUpdates.begin(), mAddedObjectUpdates.end(), std::back_inserter(mMergedObjectUpdates), objectIndexLess);
+	mMergedObjectUpdates.erase(std::unique(mMergedObjectUpdates.begin(), mMergedObjectUpdates.end(), [](const ObjectDataUpdateInfo& left, const ObjectDataUpdateInfo& right)
+	{
+		return GetRenderableObjectIndex(left.ObjectId) == GetRenderableObjectIndex(right.ObjectId);
+	}), mMergedObjectUpdates.end());
+
+	mAddedObjectUpdates.clear();
+	return mMergedObjectUpdates;
+}
+
+void BaseRenderableScene::RecycleRemovedObjectSlots(uint64_t frameNumber)
+{
+	//The slots in this list were removed InFlightFrameCount frames ago, none of the frames in flight draws their old objects anymore
+	std::vector<uint32_t>& retiredSlots = mRetiredDynamicObjectSlots[frameNumber % Utils::InFlightFrameCount];
+	mFreeDynamicObjectSlots.insert(mFreeDynamicObjectSlots.end(), retiredSlots.begin(), retiredSlots.end());
+
+	retiredSlots.clear();
+	std::swap(retiredSlots, mRemovedDynamicObjectSlots);
+}
+
+void BaseRenderableScene::FinishDynamicMeshQuery(std::vector<uint32_t>& inoutMeshIndices, size_t firstResultIndex) const
+{
+	auto resultsBegin = inoutMeshIndices.begin() + firstResultIndex;
+	std::for_each(resultsBegin, inoutMeshIndices.end(), [this](uint32_t& meshIndex) {meshIndex += mDynamicMeshSpan.Begin;});
+
+	inoutMeshIndices.erase(std::remove_if(resultsBegin, inoutMeshIndices.end(), [this](uint32_t meshIndex)
+	{
+		return mSceneMeshes[meshIndex].InstanceCount == 0;
+	}), inoutMeshIndices.end());
+}
+
+void BaseRenderableScene::ResetMeshCuller()
+{
+	mMeshCuller.Resize((uint32_t)mSceneMeshes.size());
+	for(uint32_t meshIndex = 0; meshIndex < (uint32_t)mSceneMeshes.size(); meshIndex++)
+	{
+		if(meshIndex >= mHlodProxyMeshSpan.Begin && meshIndex < mHlodProxyMeshSpan.End)
+		{
+			continue;
+		}
+
+		//The mesh bounds are all made from the bounding spheres of the meshes, the box extents are the sphere radius up to the rounding
+		DirectX::BoundingBox meshBounds = GetMeshBounds(meshIndex);
+		float                meshRadius = std::max(std::max(meshBounds.Extents.x, meshBounds.Extents.y), meshBounds.Extents.z);
+
+		mMeshCuller.SetBoundingSphere(meshIndex, DirectX::BoundingSphere(meshBounds.Center, meshRadius));
+	}
+
+	mLastFrustumMeshCount = 0;
+}
+
+const BaseRenderableScene::SceneSubmeshLod& BaseRenderableScene::GetSubmeshLod(uint32_t meshIndex, uint32_t submeshIndex) const
+{
+	const SceneSubmesh& submesh = mSceneSubmeshes[submeshIndex];
+	return mSceneSubmeshLods[submesh.FirstLodIndex + std::min((uint32_t)mMeshLodLevels[meshIndex], submesh.LodCount - 1)];
+}
+
+std::span<const uint32_t> BaseRenderableScene::GetVisibleStaticMeshIndices() const
+{
+	return std::span(mVisibleMeshIndices).subspan(0, mVisibleNonStaticMeshOffset);
+}
+
+std::span<const uint32_t> BaseRenderableScene::GetVisibleNonStaticMeshIndices() const
+{
+	return std::span(mVisibleMeshIndices).subspan(mVisibleNonStaticMeshOffset);
 }
\ No newline at end of file
@@ -1,16 +1,36 @@
 #pragma once
 
 #include <DirectXMath.h>
+#include <DirectXCollision.h>
 #include "RenderableSceneMisc.hpp"
+#include "BoundingVolumeHierarchy.hpp"
+#include "OcclusionCuller.hpp"
+#include "FrustumCuller.hpp"
+#include "../RenderingUtils.hpp"
 #include "../../../Core/Scene/Scene.hpp"
 #include "../../../Core/Scene/SceneObjectLocation.hpp"
 #include "../../../Core/DataStructures/Span.hpp"
 #include <span>
+#include <array>
+
+class ThreadPool;
 
 class BaseRenderableScene
 {
 	friend class BaseRenderableSceneBuilder;
 
+	static constexpr float MaxRigidMeshTreeDegradation = 1.5f;  //The rigid mesh tree gets rebuilt when the refits make it that much worse than a fresh one
+	static constexpr float MaxTreeCullingPassRate      = 0.05f; //The mesh trees are walked only if less than that part of the meshes was in the frustum on the last frame. With more of them testing every mesh is faster
+
+	static constexpr uint32_t MaxLodCount          = 4;
+	static constexpr float    LodZeroMinScreenSize = 0.25f; //The meshes smaller than that fraction of the screen height use the next level of detail, each next level switches at half the size
+	static constexpr float    LodHysteresis        = 1.25f; //The screen size has to go that much past a switch point to change the level, so the meshes near it don't flicker
+
+	static constexpr uint32_t HlodClusterChildCount = 16;     //The number of meshes in a first level cluster and the number of clusters in a cluster of the next level
+	static constexpr uint32_t MaxHlodLevelCount     = 3;
+	static constexpr float    HlodMaxScreenSize     = 0.125f; //The clusters smaller than that fraction of the screen height are drawn with their proxy meshes
+	static constexpr uint32_t NoHlodCluster         = (uint32_t)(-1);
+
 protected:
 	struct PerObjectData
 	{
@@ -25,12 +45,19 @@ protected:
 	//Describes the info for a single drawcall
 	struct SceneSubmesh
 	{
-		uint32_t IndexCount;    //Index count to draw
-		uint32_t FirstIndex;    //First index in the index buffer to draw
-		int32_t  VertexOffset;  //First vertex in the vertex buffer to draw
+		uint32_t FirstLodIndex; //The start of the level of detail span in mSceneSubmeshLods
+		uint32_t LodCount;      //The number of levels of detail, at least 1
+		int32_t  VertexOffset;  //First vertex in the vertex buffer to draw, the same for all levels of detail
 		uint32_t MaterialIndex; //The per-scene material index to apply to the mesh
 	};
 
+	//The index range of a single level of detail of a submesh
+	struct SceneSubmeshLod
+	{
+		uint32_t IndexCount; //Index count to draw
+		uint32_t FirstIndex; //First index in the index buffer to draw
+	};
+
 	//Describes a single composite object
 	struct SceneMesh
 	{
@@ -40,6 +67,12 @@ protected:
 		uint32_t AfterLastSubmeshIndex; //The end of the submesh span in mSceneSubmeshes
 	};
 
+	enum class HlodClusterFlags: uint8_t
+	{
+		Collapsed    = 0x01, //The cluster is far enough to be drawn with its proxy mesh
+		ProxyVisible = 0x02, //The proxy mesh is already in the visible mesh list
+	};
+
 	enum class SceneDataType: uint32_t
 	{
 		ObjectData = 0x00,
@@ -57,14 +90,129 @@ public:
 	virtual void UpdateFrameData(const FrameDataUpdateInfo& frameUpdate, uint64_t frameNumber)                      = 0;
 	virtual void UpdateRigidSceneObjects(const std::span<ObjectDataUpdateInfo> objectUpdates, uint64_t frameNumber) = 0;
 
+	//Queues the whole output of a system like animation for the next UpdateRigidSceneObjects() call, which applies it together with its own updates.
+	//Should be called at most once per frame. Each object can be updated at most once per frame, by the batch or by UpdateRigidSceneObjects().
+	//The updates already sorted by the object index skip the sorting. The object data is gathered, packed and uploaded on the thread pool, if there's one
+	virtual void UpdateRigidSceneObjectBatch(const ObjectDataUpdateBatch& objectUpdates, ThreadPool* threadPool) = 0;
+
+	//Builds the list of meshes for DrawStaticObjects() and DrawNonStaticObjects() from the camera of the last frame data update.
+	//The far clusters of static meshes are replaced with their proxy meshes.
+	//The meshes in the frustum are also tested against the occluder meshes, if the scene has any.
+	//Should be called after the frame's scene updates and before the command recording
+	void CullMeshes(ThreadPool* threadPool);
+
+	uint32_t GetMeshCount()        const;
+	uint32_t GetVisibleMeshCount() const;
+
+	//Creates a rigid object drawn with the mesh of the prototype object, in one of the slots reserved with RenderableSceneDescription::ReserveDynamicObjects().
+	//The prototype can be any non-static object. Should be called before the frame's scene updates, they upload the object data of the new object.
+	//Returns InvalidRenderableObjectHandle if all slots are taken
+	RenderableSceneObjectHandle AddObject(RenderableSceneObjectHandle prototypeObjectHandle, const SceneObjectLocation& location);
+
+	//Stops drawing the object created with AddObject(). The slot is reused after all frames in flight are done with it
+	void RemoveObject(RenderableSceneObjectHandle objectHandle);
+
+	//False for the removed objects, even after their slots are reused
+	bool IsObjectAlive(RenderableSceneObjectHandle objectHandle) const;
+
+	//Append the indices of the meshes whose bounds pass the test to outMeshIndices, in no particular order.
+	//The bounds of the rigid meshes are the ones from the last UpdateRigidSceneObjects() call. threadPool can be nullptr
+	void QueryMeshesInFrustum(DirectX::FXMMATRIX viewProjMatrix, std::vector<uint32_t>& outMeshIndices, ThreadPool* threadPool)              const;
+	void QueryMeshesInSphere(const DirectX::BoundingSphere& sphere, std::vector<uint32_t>& outMeshIndices)                                   const;
+	void QueryMeshesOnRay(DirectX::FXMVECTOR origin, DirectX::FXMVECTOR direction, float maxDistance, std::vector<uint32_t>& outMeshIndices) const;
+
 protected:
 	PerObjectData PackObjectData(const SceneObjectLocation& sceneObjectLocation)                          const;
 	PerFrameData  PackFrameData(const SceneObjectLocation& cameraLocation, DirectX::FXMMATRIX ProjMatrix) const;
 
+	//The world space bounds the mesh is culled with
+	DirectX::BoundingBox GetMeshBounds(uint32_t meshIndex) const;
+
+	//Replaces the visible static meshes with the proxy meshes of their biggest far enough clusters
+	void ReplaceFarClustersWithProxies(DirectX::FXMMATRIX viewProjMatrix);
+
+	//Picks the level of detail of each visible mesh from its projected size. The instanced meshes use the level of their biggest instance
+	void SelectMeshLods();
+
+	//The projected size of the sphere as a fraction of the screen height. The camera inside the sphere gets the maximum float
+	float CalculateScreenSize(DirectX::FXMVECTOR center, float radius) const;
+
+	static uint32_t SelectLodLevel(float screenSize, uint32_t currentLodLevel);
+
+	static DirectX::BoundingSphere TransformBoundingSphere(const DirectX::BoundingSphere& sphere, const SceneObjectLocation& location);
+
+	//Moves the bounding spheres of the updated objects along with them and refits the rigid mesh tree
+	void UpdateObjectBoundingSpheres(std::span<const ObjectDataUpdateInfo> objectUpdates);
+
+	//Merges the sorted object updates with the initial locations of the objects added since the last call. The result is sorted too
+	std::span<const ObjectDataUpdateInfo> MergeAddedObjectUpdates(std::span<const ObjectDataUpdateInfo> objectUpdates);
+
+	//Frees the slots of the objects removed InFlightFrameCount frames ago. Should be called once per frame
+	void RecycleRemovedObjectSlots(uint64_t frameNumber);
+
+	//Offsets the dynamic mesh tree query results starting at firstResultIndex to mesh indices and drops the free slots
+	void FinishDynamicMeshQuery(std::vector<uint32_t>& inoutMeshIndices, size_t firstResultIndex) const;
+
+	//Puts the bounds of every mesh from the mesh trees into the flat mesh culler. Called once all mesh trees are built
+	void ResetMeshCuller();
+
+	//The level of detail selected for the mesh by the last CullMeshes() call, clamped to the levels the submesh has
+	const SceneSubmeshLod& GetSubmeshLod(uint32_t meshIndex, uint32_t submeshIndex) const;
+
+	//The visible meshes are sorted, so the static ones come first. The visible proxy meshes are static too and go before the others
+	std::span<const uint32_t> GetVisibleStaticMeshIndices()    const;
+	std::span<const uint32_t> GetVisibleNonStaticMeshIndices() const;
+
 protected:
 	std::vector<SceneMesh>    mSceneMeshes;    //All meshes registered in scene
 	std::vector<SceneSubmesh> mSceneSubmeshes; //All submeshes registered in scene
+
+	std::vector<SceneSubmeshLod> mSceneSubmeshLods; //The levels of detail of all submeshes, the submeshes with the same geometry share them
+	std::vector<uint8_t>         mMeshLodLevels;    //The level of detail of each mesh, kept between the frames for the hysteresis
 	
 	Span<uint32_t> mStaticUniqueMeshSpan; //Meshes that have the positional data baked into vertices
 	Span<uint32_t> mNonStaticMeshSpan;    //Meshes with positional data stored in a constant buffer
+	Span<uint32_t> mRigidMeshSpan;        //The part of the non-static meshes that can move
+	Span<uint32_t> mHlodProxyMeshSpan;    //The proxy mesh of each cluster in cluster order, after the baked meshes
+	Span<uint32_t> mDynamicMeshSpan;      //The single-instance rigid mesh of each dynamic object slot, after all other meshes. The free slots have no instances
+
+	//Bounding spheres of the non-static objects, indexed by object data index
+	std::vector<DirectX::BoundingSphere> mObjectLocalBoundingSpheres; //In object space, the same for all instances of a mesh
+	std::vector<DirectX::BoundingSphere> mObjectBoundingSpheres;      //In world space
+	std::vector<uint32_t>                mObjectMeshIndices;          //The mesh each object is an instance of
+
+	//World space bounds of the meshes. The bounds of an instanced mesh enclose all its instances
+	BoundingVolumeHierarchy mStaticMeshTree;  //Items are the mesh indices before mRigidMeshSpan, built once when the scene is baked
+	BoundingVolumeHierarchy mRigidMeshTree;   //Items are the mesh indices in mRigidMeshSpan minus mRigidMeshSpan.Begin, refit as the meshes move
+	BoundingVolumeHierarchy mDynamicMeshTree; //Items are the dynamic object slots, only refit. The objects come and go too fast to pay for the rebuilds
+
+	//The same bounds as in the mesh trees as spheres, indexed by mesh index. The proxy meshes have none, they are only made visible by the clusters
+	FrustumCuller mMeshCuller;
+	uint32_t      mLastFrustumMeshCount; //The number of meshes in the frustum on the last frame, decides between the mesh trees and mMeshCuller
+
+	//The dynamic object slots. A removed object's slot waits in mRetiredDynamicObjectSlots until the frames in flight can't refer to it anymore
+	std::vector<uint8_t>                                         mDynamicObjectGenerations;
+	std::vector<uint32_t>                                        mFreeDynamicObjectSlots;
+	std::vector<uint32_t>                                        mRemovedDynamicObjectSlots;
+	std::array<std::vector<uint32_t>, Utils::InFlightFrameCount> mRetiredDynamicObjectSlots;
+	std::vector<ObjectDataUpdateInfo>                            mAddedObjectUpdates;
+
+	//The static unique meshes are grouped into a hierarchy of clusters. The first level clusters are the ones with the smallest indices
+	std::vector<uint32_t>   mStaticMeshHlodClusters; //The first level cluster of each static unique mesh, or NoHlodCluster
+	std::vector<uint32_t>   mHlodClusterParents;     //The next level cluster each cluster is merged into, or NoHlodCluster
+	std::vector<uint8_t>    mHlodClusterFlags;       //HlodClusterFlags of each cluster, Collapsed is kept between the frames for the hysteresis
+	BoundingVolumeHierarchy mHlodClusterTree;        //Items are the cluster indices
+
+	OcclusionCuller mOcclusionCuller; //The occluders are the static meshes marked in the scene description
+
+	DirectX::XMFLOAT4X4   mCullingViewProjMatrix;
+	DirectX::XMFLOAT3     mCullingCameraPosition;
+	float                 mCullingProjScale; //The projection scale along Y, to get the screen size of the meshes
+	std::vector<uint32_t> mVisibleMeshIndices;
+	uint32_t              mVisibleNonStaticMeshOffset; //Where the non-static meshes start in the visible mesh list
+	std::vector<uint32_t> mMovedInstancedMeshIndices;  //Scratch list for UpdateObjectBoundingSpheres()
+	std::vector<uint32_t> mVisibleHlodClusterIndices;  //Scratch list for ReplaceFarClustersWithProxies()
+	std::vector<uint32_t> mVisibleProxyMeshIndices;    //Scratch list for ReplaceFarClustersWithProxies()
+
+	std::vector<ObjectDataUpdateInfo> mMergedObjectUpdates; //Scratch list for MergeAddedObjectUpdates()
 };
\ No newline at end of file
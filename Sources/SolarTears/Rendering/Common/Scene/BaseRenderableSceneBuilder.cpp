@@ -2,12 +2,45 @@
 #include "BaseRenderableScene.hpp"
 #include <algorithm>
 #include <array>
+#include <chrono>
+#include <filesystem>
+#include <limits>
 #include <numeric>
+#include <cassert>
+
+namespace
+{
+	//The element count goes first, so the neighbouring arrays can't swap elements without changing the hash
+	template<typename T>
+	uint64_t HashArray(uint64_t hash, std::span<const T> values)
+	{
+		uint64_t valueCount = values.size();
+		hash = RenderableSceneBakeCache::HashBytes(hash, std::as_bytes(std::span(&valueCount, 1)));
+		return RenderableSceneBakeCache::HashBytes(hash, std::as_bytes(values));
+	}
+
+	template<typename T>
+	std::span<const T> GetSceneCacheSectionData(const RenderableSceneCacheFile& sceneCacheFile, uint32_t sectionIndex)
+	{
+		std::span<const std::byte> sectionData = sceneCacheFile.GetSection(sectionIndex);
+		assert(sectionData.size() % sizeof(T) == 0);
+
+		return std::span(reinterpret_cast<const T*>(sectionData.data()), sectionData.size() / sizeof(T));
+	}
+}
 
 BaseRenderableSceneBuilder::BaseRenderableSceneBuilder(BaseRenderableScene* sceneToBuild): mSceneToBuild(sceneToBuild)
 {
 	mStaticInstancedObjectCount = 0;
 	mRigidObjectCount           = 0;
+	mDynamicObjectCount         = 0;
+
+	mInMemoryTextureDataRef = nullptr;
+	mBakeCacheRef           = &mOwnBakeCache;
+
+	mLastBuildFromSceneCache = false;
+
+	mBuildStepTimesMs.fill(0.0f);
 }
 
 BaseRenderableSceneBuilder::~BaseRenderableSceneBuilder()
@@ -16,73 +49,242 @@ BaseRenderableSceneBuilder::~BaseRenderableSceneBuilder()
 
 void BaseRenderableSceneBuilder::Build(const RenderableSceneDescription& sceneDescription, const std::unordered_map<std::string_view, SceneObjectLocation>& sceneMeshInitialLocations, std::unordered_map<std::string_view, RenderableSceneObjectHandle>& outObjectHandles)
 {
-	//After this step we'll have a sorted flat list of meshes
-	std::vector<NamedSceneMeshData> namedSceneMeshes;
-	BuildSortedMeshList(sceneDescription.mSceneMeshes, namedSceneMeshes);
-
-	//After this step we'll have instance groups formed
-	std::vector<std::span<const NamedSceneMeshData>> instanceSpans;
-	DetectInstanceSpans(namedSceneMeshes, instanceSpans);
+	auto stepStartTime = std::chrono::steady_clock::now();
+	auto finishStep = [this, &stepStartTime](uint32_t stepIndex)
+	{
+		auto stepEndTime = std::chrono::steady_clock::now();
+		mBuildStepTimesMs[stepIndex] = std::chrono::duration<float, std::milli>(stepEndTime - stepStartTime).count();
+		stepStartTime = stepEndTime;
+	};
 
-	//After this step we'll have instance groups sorted by mesh type
-	InstanceSpanBuckets instanceSpanBuckets;
-	SortInstanceSpans(instanceSpans, &instanceSpanBuckets);
+	mInMemoryTextureDataRef = &sceneDescription.mSceneTextureData;
+	mBuildStepTimesMs.fill(0.0f);
 
-	//After this step we'll have scene mesh buffers created
-	FillMeshLists(instanceSpans, instanceSpanBuckets);
+	//The unchanged scene is loaded from the scene cache file instead of building it
+	uint64_t descriptionHash = 0;
+	mLastBuildFromSceneCache = false;
+	if(!mSceneCacheFilename.empty())
+	{
+		descriptionHash          = HashSceneDescription(sceneDescription, sceneMeshInitialLocations);
+		mLastBuildFromSceneCache = LoadSceneCache(sceneDescription, descriptionHash, outObjectHandles);
+	}
 
-	//After this step we'll have vertex and index buffers ready to be uploaded to GPU
-	AssignSubmeshGeometries(sceneDescription.mSceneGeometries, instanceSpans, sceneMeshInitialLocations);
+	//The bake cache keeps its entries if the build steps are skipped
+	if(!mLastBuildFromSceneCache)
+	{
+		mBakeCacheRef->BeginBake();
+
+		//After this step we'll have a sorted flat list of meshes
+		std::vector<RenderableSceneMeshData> sortedMeshData;
+		std::vector<NamedSceneMeshData>      namedSceneMeshes;
+		BuildSortedMeshList(sceneDescription, sceneMeshInitialLocations, sortedMeshData, namedSceneMeshes);
+		finishStep(0);
+
+		//After this step we'll have instance groups formed
+		std::vector<std::span<const NamedSceneMeshData>> instanceSpans;
+		DetectInstanceSpans(namedSceneMeshes, instanceSpans);
+		finishStep(1);
+
+		//After this step we'll have instance groups sorted by mesh type
+		InstanceSpanBuckets instanceSpanBuckets;
+		SortInstanceSpans(instanceSpans, &instanceSpanBuckets);
+		finishStep(2);
+
+		//After this step we'll have scene mesh buffers created
+		FillMeshLists(instanceSpans, instanceSpanBuckets);
+		finishStep(3);
+
+		//After this step we'll have vertex and index buffers ready to be uploaded to GPU
+		AssignSubmeshGeometries(sceneDescription.mSceneGeometries, instanceSpans);
+		finishStep(4);
+
+		//After this step we'll have material data initialized and texture list prepared to be loaded
+		AssignSubmeshMaterials(sceneDescription.mSceneMaterials, instanceSpans);
+		finishStep(5);
+
+		//After this step we'll have object data initialized
+		FillInitialObjectData(instanceSpans);
+		finishStep(6);
+
+		//After this step we'll have object handles assigned
+		AssignMeshHandles(instanceSpans, outObjectHandles);
+		finishStep(7);
+
+		//After this step we'll have bounding volumes computed
+		ComputeBoundingVolumes(instanceSpans);
+		finishStep(8);
+
+		//After this step we'll have occluder triangles collected
+		CollectOccluders(sceneDescription.mSceneGeometries, instanceSpans);
+		finishStep(9);
+
+		//After this step we'll have the far away mesh clusters ready to be replaced with proxies
+		BuildHlodClusters();
+		finishStep(10);
+
+		mVertexBufferSource = mVertexBufferData;
+		mIndexBufferSource  = mIndexBufferData;
+	}
 
-	//After this step we'll have material data initialized and texture list prepared to be loaded
-	AssignSubmeshMaterials(sceneDescription.mSceneMaterials, instanceSpans);
+	//Loading the scene cache file is not one of the steps
+	stepStartTime = std::chrono::steady_clock::now();
 
-	//After this step we'll have object data initialized
-	FillInitialObjectData(instanceSpans, sceneMeshInitialLocations);
+	//After this step we'll have the slots for the objects added at runtime
+	AllocateDynamicObjectSlots(sceneDescription.mDynamicObjectCapacity);
+	finishStep(11);
 
-	//After this step we'll have object handles assigned
-	AssignMeshHandles(instanceSpans, outObjectHandles);
+	//All mesh trees are built by now
+	mSceneToBuild->ResetMeshCuller();
 
 	//Finalize scene loading
 	Bake();
+
+	if(mLastBuildFromSceneCache)
+	{
+		mSceneCacheTexturePayloads.clear();
+		mSceneCacheFile.Close();
+	}
+	else
+	{
+		if(!mSceneCacheFilename.empty())
+		{
+			SaveSceneCache(descriptionHash, outObjectHandles);
+		}
+
+		mCachedGeometries.clear();
+		mBakeCacheRef->EndBake();
+	}
+
+	mVertexBufferSource = std::span<const RenderableSceneVertex>();
+	mIndexBufferSource  = std::span<const RenderableSceneIndex>();
+
+	mInMemoryTextureDataRef = nullptr;
 }
 
-void BaseRenderableSceneBuilder::BuildSortedMeshList(const std::unordered_map<std::string, RenderableSceneMeshData>& descriptionMeshes, std::vector<NamedSceneMeshData>& outNamedSceneMeshes) const
+std::span<const float> BaseRenderableSceneBuilder::GetLastBuildStepTimesMs() const
 {
-	outNamedSceneMeshes.clear();
-	for(const auto& mesh: descriptionMeshes)
+	return mBuildStepTimesMs;
+}
+
+void BaseRenderableSceneBuilder::SetBakeCache(RenderableSceneBakeCache* bakeCache)
+{
+	mBakeCacheRef = (bakeCache != nullptr) ? bakeCache : &mOwnBakeCache;
+}
+
+void BaseRenderableSceneBuilder::SetSceneCacheFile(const std::wstring& cacheFilename)
+{
+	mSceneCacheFilename = cacheFilename;
+}
+
+bool BaseRenderableSceneBuilder::IsLastBuildFromSceneCache() const
+{
+	return mLastBuildFromSceneCache;
+}
+
+std::span<const std::byte> BaseRenderableSceneBuilder::GetTextureDdsData(size_t textureIndex)
+{
+	if(mLastBuildFromSceneCache)
+	{
+		return mSceneCacheTexturePayloads[textureIndex];
+	}
+
+	auto inMemoryTextureIt = mInMemoryTextureDataRef->find(mTexturesToLoad[textureIndex]);
+	if(inMemoryTextureIt != mInMemoryTextureDataRef->end())
+	{
+		return inMemoryTextureIt->second;
+	}
+
+	//The unchanged files are not read again
+	return mBakeCacheRef->ReadTextureFile(mTexturesToLoad[textureIndex]);
+}
+
+uint64_t BaseRenderableSceneBuilder::GetTextureContentHash(size_t textureIndex, std::span<const std::byte> textureDdsData) const
+{
+	if(!mLastBuildFromSceneCache && !mInMemoryTextureDataRef->contains(mTexturesToLoad[textureIndex]))
+	{
+		return mBakeCacheRef->GetTextureFileHash(mTexturesToLoad[textureIndex]);
+	}
+
+	return RenderableSceneBakeCache::HashBytes(RenderableSceneBakeCache::InitialHash, textureDdsData);
+}
+
+void BaseRenderableSceneBuilder::BuildSortedMeshList(const RenderableSceneDescription& sceneDescription, const std::unordered_map<std::string_view, SceneObjectLocation>& sceneMeshInitialLocations, std::vector<RenderableSceneMeshData>& outSortedMeshData, std::vector<NamedSceneMeshData>& outNamedSceneMeshes) const
+{
+	//The pointers to the sorted mesh data have to stay valid
+	outSortedMeshData.clear();
+	outSortedMeshData.reserve(sceneDescription.mSceneMeshes.size());
+
+	auto geometryNameLess = [](const RenderableSceneSubmeshData& left, const RenderableSceneSubmeshData& right)
+	{
+		return left.GeometryName < right.GeometryName;
+	};
+
+	//The meshes are sorted before the instances are expanded, so the instances of each mesh stay next to each other and get consecutive handles
+	std::vector<NamedSceneMeshData> sortedMeshes;
+	sortedMeshes.reserve(sceneDescription.mSceneMeshes.size());
+
+	size_t totalInstanceCount = 0;
+	for(const auto& mesh: sceneDescription.mSceneMeshes)
 	{
 		if(mesh.second.Submeshes.size() == 0)
 		{
 			continue;
 		}
 
-		outNamedSceneMeshes.push_back(NamedSceneMeshData
+		//Most meshes have their submeshes sorted already, only copy the rest
+		const RenderableSceneMeshData* sortedMesh = &mesh.second;
+		if(!std::is_sorted(mesh.second.Submeshes.begin(), mesh.second.Submeshes.end(), geometryNameLess))
 		{
-			.MeshName = mesh.first,
-			.MeshData = mesh.second
-		});
+			RenderableSceneMeshData& sortedMeshCopy = outSortedMeshData.emplace_back(mesh.second);
+			std::sort(sortedMeshCopy.Submeshes.begin(), sortedMeshCopy.Submeshes.end(), geometryNameLess);
+
+			sortedMesh = &sortedMeshCopy;
+		}
 
-		std::sort(outNamedSceneMeshes.back().MeshData.Submeshes.begin(), outNamedSceneMeshes.back().MeshData.Submeshes.end(), [](const RenderableSceneSubmeshData& left, const RenderableSceneSubmeshData& right)
+		//The meshes without instances are drawn at the location of the scene object with the same name
+		const SceneObjectLocation* initialLocation = (sortedMesh->InstanceCount == 0) ? &sceneMeshInitialLocations.at(mesh.first) : &sceneDescription.mMeshInstanceLocations[sortedMesh->FirstInstanceIndex];
+		sortedMeshes.push_back(NamedSceneMeshData
 		{
-			return left.GeometryName < right.GeometryName;
+			.MeshName        = mesh.first,
+			.MeshData        = sortedMesh,
+			.InitialLocation = initialLocation,
+			.InstanceIndex   = 0
 		});
+
+		totalInstanceCount += std::max(sortedMesh->InstanceCount, 1u);
 	}
 
-	std::sort(outNamedSceneMeshes.begin(), outNamedSceneMeshes.end(), [](const NamedSceneMeshData& left, const NamedSceneMeshData& right)
+	std::sort(sortedMeshes.begin(), sortedMeshes.end(), [](const NamedSceneMeshData& left, const NamedSceneMeshData& right)
 	{
-		bool leftMeshStatic  = !(left.MeshData.MeshFlags  & (uint32_t)RenderableSceneMeshFlags::NonStatic);
-		bool rightMeshStatic = !(right.MeshData.MeshFlags & (uint32_t)RenderableSceneMeshFlags::NonStatic);
+		bool leftMeshStatic  = !(left.MeshData->MeshFlags  & (uint32_t)RenderableSceneMeshFlags::NonStatic);
+		bool rightMeshStatic = !(right.MeshData->MeshFlags & (uint32_t)RenderableSceneMeshFlags::NonStatic);
 		if(leftMeshStatic != rightMeshStatic)
 		{
 			return leftMeshStatic < rightMeshStatic;
 		}
 
-		return std::lexicographical_compare(left.MeshData.Submeshes.begin(), left.MeshData.Submeshes.end(), right.MeshData.Submeshes.begin(), right.MeshData.Submeshes.end(), [](const RenderableSceneSubmeshData& submeshLeft, const RenderableSceneSubmeshData& submeshRight)
+		return std::lexicographical_compare(left.MeshData->Submeshes.begin(), left.MeshData->Submeshes.end(), right.MeshData->Submeshes.begin(), right.MeshData->Submeshes.end(), [](const RenderableSceneSubmeshData& submeshLeft, const RenderableSceneSubmeshData& submeshRight)
 		{
 			return submeshLeft.GeometryName < submeshRight.GeometryName;
 		});
 	});
+
+	outNamedSceneMeshes.clear();
+	outNamedSceneMeshes.reserve(totalInstanceCount);
+	for(const NamedSceneMeshData& sortedMesh: sortedMeshes)
+	{
+		outNamedSceneMeshes.push_back(sortedMesh);
+		for(uint32_t instanceIndex = 1; instanceIndex < sortedMesh.MeshData->InstanceCount; instanceIndex++)
+		{
+			outNamedSceneMeshes.push_back(NamedSceneMeshData
+			{
+				.MeshName        = sortedMesh.MeshName,
+				.MeshData        = sortedMesh.MeshData,
+				.InitialLocation = sortedMesh.InitialLocation + instanceIndex,
+				.InstanceIndex   = instanceIndex
+			});
+		}
+	}
 }
 
 void BaseRenderableSceneBuilder::DetectInstanceSpans(const std::vector<NamedSceneMeshData>& sceneMeshes, std::vector<std::span<const NamedSceneMeshData>>& outInstanceSpans) const
@@ -92,14 +294,20 @@ void BaseRenderableSceneBuilder::DetectInstanceSpans(const std::vector<NamedScen
 	auto meshIt = sceneMeshes.begin();
 	while(meshIt != sceneMeshes.end())
 	{
-		const RenderableSceneMeshData& meshData = meshIt->MeshData;
+		const RenderableSceneMeshData& meshData = *meshIt->MeshData;
 
 		bool thisMeshStatic = !(meshData.MeshFlags & (uint32_t)RenderableSceneMeshFlags::NonStatic);
 
 		auto nextMeshIt = meshIt + 1;
 		while(nextMeshIt != sceneMeshes.end())
 		{
-			const RenderableSceneMeshData& nextMeshData = nextMeshIt->MeshData;
+			//The instances of one mesh share the mesh data, no need to compare the geometry names
+			const RenderableSceneMeshData& nextMeshData = *nextMeshIt->MeshData;
+			if(&nextMeshData == &meshData)
+			{
+				++nextMeshIt;
+				continue;
+			}
 
 			bool nextMeshStatic = !(nextMeshData.MeshFlags & (uint32_t)RenderableSceneMeshFlags::NonStatic);
 			if(!SameGeometry(meshData, nextMeshData) || thisMeshStatic != nextMeshStatic)
@@ -127,7 +335,7 @@ void BaseRenderableSceneBuilder::SortInstanceSpans(std::vector<std::span<const N
 
 	for(std::span<const NamedSceneMeshData> instanceSpan: inoutInstanceSpans)
 	{
-		const RenderableSceneMeshData& representativeMeshData = instanceSpan.front().MeshData;
+		const RenderableSceneMeshData& representativeMeshData = *instanceSpan.front().MeshData;
 
 		bool isSpanNonStatic = representativeMeshData.MeshFlags & (uint32_t)RenderableSceneMeshFlags::NonStatic;
 		uint32_t instanceCount = (uint32_t)instanceSpan.size();
@@ -178,7 +386,7 @@ void BaseRenderableSceneBuilder::SortInstanceSpans(std::vector<std::span<const N
 	for(uint32_t instanceSpanIndex = 0; instanceSpanIndex < inoutInstanceSpans.size(); instanceSpanIndex++)
 	{
 		const std::span<const NamedSceneMeshData> instanceSpan = inoutInstanceSpans[instanceSpanIndex];
-		const RenderableSceneMeshData& representativeMeshData = instanceSpan.front().MeshData;
+		const RenderableSceneMeshData& representativeMeshData = *instanceSpan.front().MeshData;
 
 		bool isSpanNonStatic = representativeMeshData.MeshFlags & (uint32_t)RenderableSceneMeshFlags::NonStatic;
 		uint32_t instanceCount = (uint32_t)instanceSpan.size();
@@ -225,6 +433,9 @@ void BaseRenderableSceneBuilder::FillMeshLists(const std::vector<std::span<const
 	mSceneToBuild->mNonStaticMeshSpan.End   += spanBuckets.RigidUniqueBucket.End     - spanBuckets.RigidUniqueBucket.Begin;
 	mSceneToBuild->mNonStaticMeshSpan.End   += spanBuckets.RigidInstancedBucket.End  - spanBuckets.RigidInstancedBucket.Begin;
 
+	mSceneToBuild->mRigidMeshSpan.Begin = mSceneToBuild->mNonStaticMeshSpan.Begin + (spanBuckets.StaticInstancedBucket.End - spanBuckets.StaticInstancedBucket.Begin);
+	mSceneToBuild->mRigidMeshSpan.End   = mSceneToBuild->mNonStaticMeshSpan.End;
+
 
 	uint32_t totalObjectDataCount = 0;
 	uint32_t totalSubmeshCount    = 0;
@@ -236,7 +447,7 @@ void BaseRenderableSceneBuilder::FillMeshLists(const std::vector<std::span<const
 		for(uint32_t meshIndex = bucketForStaticUniqueMeshes.Begin; meshIndex < bucketForStaticUniqueMeshes.End; meshIndex++)
 		{
 			std::span<const NamedSceneMeshData> instanceSpan = sortedInstanceSpans[meshIndex];
-			const RenderableSceneMeshData& representativeMeshData = instanceSpan.front().MeshData;
+			const RenderableSceneMeshData& representativeMeshData = *instanceSpan.front().MeshData;
 
 			mSceneToBuild->mSceneMeshes[meshIndex] = BaseRenderableScene::SceneMesh
 			{
@@ -270,7 +481,7 @@ void BaseRenderableSceneBuilder::FillMeshLists(const std::vector<std::span<const
 		for(uint32_t meshIndex = bucketForStaticUniqueMeshes.Begin; meshIndex < bucketForStaticUniqueMeshes.End; meshIndex++)
 		{
 			std::span<const NamedSceneMeshData> instanceSpan = sortedInstanceSpans[meshIndex];
-			const RenderableSceneMeshData& representativeMeshData = instanceSpan.front().MeshData;
+			const RenderableSceneMeshData& representativeMeshData = *instanceSpan.front().MeshData;
 
 			uint32_t instanceCount = (uint32_t)instanceSpan.size();
 			uint32_t submeshCount  = (uint32_t)representativeMeshData.Submeshes.size();
@@ -296,13 +507,17 @@ void BaseRenderableSceneBuilder::FillMeshLists(const std::vector<std::span<const
 	mRigidObjectCount           = objectDataCountsForNonStaticMeshes[rigidUniqueBucketIndex] + objectDataCountsForNonStaticMeshes[rigidInstancedBucketIndex];
 
 	mSceneToBuild->mSceneSubmeshes.resize(totalSubmeshCount);
+	mSceneToBuild->mMeshLodLevels.assign(mSceneToBuild->mSceneMeshes.size(), 0);
 }
 
-void BaseRenderableSceneBuilder::AssignSubmeshGeometries(const std::unordered_map<std::string, RenderableSceneGeometryData>& descriptionGeometries, const std::vector<std::span<const NamedSceneMeshData>>& sceneMeshInstanceSpans, const std::unordered_map<std::string_view, SceneObjectLocation>& sceneMeshInitialLocations)
+void BaseRenderableSceneBuilder::AssignSubmeshGeometries(const std::unordered_map<std::string, RenderableSceneGeometryData>& descriptionGeometries, const std::vector<std::span<const NamedSceneMeshData>>& sceneMeshInstanceSpans)
 {
 	mVertexBufferData.clear();
 	mIndexBufferData.clear();
 
+	mSceneToBuild->mSceneSubmeshLods.clear();
+	mCachedGeometries.clear();
+
 	//For static non-instanced meshes the positional data is baked directly into geometry
 	for(uint32_t meshIndex = mSceneToBuild->mStaticUniqueMeshSpan.Begin; meshIndex < mSceneToBuild->mStaticUniqueMeshSpan.End; meshIndex++)
 	{
@@ -313,7 +528,7 @@ void BaseRenderableSceneBuilder::AssignSubmeshGeometries(const std::unordered_ma
 		uint32_t submeshCount = sceneMesh.AfterLastSubmeshIndex - sceneMesh.FirstSubmeshIndex;
 		const NamedSceneMeshData& representativeMesh = instanceSpan.front();
 
-		const SceneObjectLocation& meshLocation = sceneMeshInitialLocations.at(representativeMesh.MeshName);
+		const SceneObjectLocation& meshLocation = *representativeMesh.InitialLocation;
 		DirectX::XMVECTOR meshPosition = DirectX::XMLoadFloat3(&meshLocation.Position);
 		DirectX::XMVECTOR meshRotation = DirectX::XMLoadFloat4(&meshLocation.RotationQuaternion);
 		DirectX::XMVECTOR meshScale    = DirectX::XMVectorSet(meshLocation.Scale, meshLocation.Scale, meshLocation.Scale, 1.0f);
@@ -321,14 +536,11 @@ void BaseRenderableSceneBuilder::AssignSubmeshGeometries(const std::unordered_ma
 		DirectX::XMMATRIX meshMatrix = DirectX::XMMatrixAffineTransformation(meshScale, DirectX::XMVectorZero(), meshRotation, meshPosition);
 		for(uint32_t submeshIndex = 0; submeshIndex < submeshCount; submeshIndex++)
 		{
-			const RenderableSceneGeometryData& geometryData = descriptionGeometries.at(representativeMesh.MeshData.Submeshes[submeshIndex].GeometryName);
+			const RenderableSceneGeometryData& geometryData = descriptionGeometries.at(representativeMesh.MeshData->Submeshes[submeshIndex].GeometryName);
 
 			BaseRenderableScene::SceneSubmesh& submesh = mSceneToBuild->mSceneSubmeshes[sceneMesh.FirstSubmeshIndex + submeshIndex];
-			submesh.IndexCount   = (uint32_t)geometryData.Indices.size();
-			submesh.FirstIndex   = (uint32_t)mIndexBufferData.size();
 			submesh.VertexOffset = (uint32_t)mVertexBufferData.size();
 
-			mVertexBufferData.reserve(mVertexBufferData.size() + geometryData.Vertices.size());
 			for(size_t vertexIndex = 0; vertexIndex < geometryData.Vertices.size(); vertexIndex++)
 			{
 				const RenderableSceneVertex& vertex = geometryData.Vertices[vertexIndex];
@@ -347,26 +559,26 @@ void BaseRenderableSceneBuilder::AssignSubmeshGeometries(const std::unordered_ma
 				mVertexBufferData.push_back(std::move(transformedVertex));
 			}
 
-			mIndexBufferData.insert(mIndexBufferData.end(), geometryData.Indices.begin(), geometryData.Indices.end());
+			AppendSubmeshLods(representativeMesh.MeshData->Submeshes[submeshIndex].GeometryName, geometryData, &submesh.FirstLodIndex, &submesh.LodCount);
 		}
 	}
 
 
 	struct GeometrySubmeshRange
 	{
-		uint32_t IndexCount;
-		uint32_t FirstIndex;
+		uint32_t FirstLodIndex;
+		uint32_t LodCount;
 		uint32_t VertexOffset;
 	};
 
 	std::unordered_map<std::string_view, GeometrySubmeshRange> geometryRanges;
-	for(uint32_t meshIndex = mSceneToBuild->mNonStaticMeshSpan.Begin; meshIndex < mSceneToBuild->mNonStaticMeshSpan.Begin; meshIndex++)
+	for(uint32_t meshIndex = mSceneToBuild->mNonStaticMeshSpan.Begin; meshIndex < mSceneToBuild->mNonStaticMeshSpan.End; meshIndex++)
 	{
 		const BaseRenderableScene::SceneMesh& sceneMesh = mSceneToBuild->mSceneMeshes[meshIndex];
 		std::span<const NamedSceneMeshData> instanceSpan = sceneMeshInstanceSpans[meshIndex];
 
 		uint32_t submeshCount = sceneMesh.AfterLastSubmeshIndex - sceneMesh.FirstSubmeshIndex;
-		const RenderableSceneMeshData& representativeMeshData = instanceSpan.front().MeshData;
+		const RenderableSceneMeshData& representativeMeshData = *instanceSpan.front().MeshData;
 		for(uint32_t submeshIndex = 0; submeshIndex < submeshCount; submeshIndex++)
 		{
 			BaseRenderableScene::SceneSubmesh& submesh = mSceneToBuild->mSceneSubmeshes[sceneMesh.FirstSubmeshIndex + submeshIndex];
@@ -374,34 +586,71 @@ void BaseRenderableSceneBuilder::AssignSubmeshGeometries(const std::unordered_ma
 			auto geometryRangeIt = geometryRanges.find(representativeMeshData.Submeshes[submeshIndex].GeometryName);
 			if(geometryRangeIt != geometryRanges.end())
 			{
-				submesh.IndexCount   = geometryRangeIt->second.IndexCount;
-				submesh.FirstIndex   = geometryRangeIt->second.FirstIndex;
-				submesh.VertexOffset = geometryRangeIt->second.VertexOffset;
+				submesh.FirstLodIndex = geometryRangeIt->second.FirstLodIndex;
+				submesh.LodCount      = geometryRangeIt->second.LodCount;
+				submesh.VertexOffset  = geometryRangeIt->second.VertexOffset;
 			}
 			else
 			{
 				const RenderableSceneGeometryData& geometryData = descriptionGeometries.at(representativeMeshData.Submeshes[submeshIndex].GeometryName);
 
-				GeometrySubmeshRange geometryRange = 
-				{
-					.IndexCount   = (uint32_t)geometryData.Indices.size(),
-					.FirstIndex   = (uint32_t)mIndexBufferData.size(),
-					.VertexOffset = (uint32_t)mVertexBufferData.size()
-				};
-
+				submesh.VertexOffset = (uint32_t)mVertexBufferData.size();
 				mVertexBufferData.insert(mVertexBufferData.end(), geometryData.Vertices.begin(), geometryData.Vertices.end());
-				mIndexBufferData.insert(mIndexBufferData.end(),   geometryData.Indices.begin(),  geometryData.Indices.end());
 
-				submesh.IndexCount   = geometryRange.IndexCount;
-				submesh.FirstIndex   = geometryRange.FirstIndex;
-				submesh.VertexOffset = geometryRange.VertexOffset;
+				AppendSubmeshLods(representativeMeshData.Submeshes[submeshIndex].GeometryName, geometryData, &submesh.FirstLodIndex, &submesh.LodCount);
 
-				geometryRanges[representativeMeshData.Submeshes[submeshIndex].GeometryName] = geometryRange;
+				geometryRanges[representativeMeshData.Submeshes[submeshIndex].GeometryName] = GeometrySubmeshRange
+				{
+					.FirstLodIndex = submesh.FirstLodIndex,
+					.LodCount      = submesh.LodCount,
+					.VertexOffset  = (uint32_t)submesh.VertexOffset
+				};
 			}
 		}
 	}
 }
 
+const RenderableSceneBakeCache::CachedGeometry& BaseRenderableSceneBuilder::GetCachedGeometry(std::string_view geometryName, const RenderableSceneGeometryData& geometryData)
+{
+	auto cachedGeometryIt = mCachedGeometries.find(geometryName);
+	if(cachedGeometryIt == mCachedGeometries.end())
+	{
+		const RenderableSceneBakeCache::CachedGeometry& cachedGeometry = mBakeCacheRef->GetGeometry(geometryData, BaseRenderableScene::MaxLodCount);
+		cachedGeometryIt = mCachedGeometries.emplace(geometryName, &cachedGeometry).first;
+	}
+
+	return *cachedGeometryIt->second;
+}
+
+void BaseRenderableSceneBuilder::AppendSubmeshLods(std::string_view geometryName, const RenderableSceneGeometryData& geometryData, uint32_t* outFirstLodIndex, uint32_t* outLodCount)
+{
+	//The static meshes have their own copies of the geometry, simplify it once
+	const RenderableSceneBakeCache::CachedGeometry& cachedGeometry = GetCachedGeometry(geometryName, geometryData);
+
+	const std::vector<std::vector<RenderableSceneIndex>>* coarserLodIndices = &geometryData.LodIndices;
+	if(coarserLodIndices->empty())
+	{
+		coarserLodIndices = &cachedGeometry.GeneratedLodIndices;
+	}
+
+	uint32_t coarserLodCount = std::min((uint32_t)coarserLodIndices->size(), BaseRenderableScene::MaxLodCount - 1);
+
+	*outFirstLodIndex = (uint32_t)mSceneToBuild->mSceneSubmeshLods.size();
+	*outLodCount      = coarserLodCount + 1;
+
+	for(uint32_t lodIndex = 0; lodIndex <= coarserLodCount; lodIndex++)
+	{
+		const std::vector<RenderableSceneIndex>& lodIndices = (lodIndex == 0) ? geometryData.Indices : (*coarserLodIndices)[lodIndex - 1];
+		mSceneToBuild->mSceneSubmeshLods.push_back(BaseRenderableScene::SceneSubmeshLod
+		{
+			.IndexCount = (uint32_t)lodIndices.size(),
+			.FirstIndex = (uint32_t)mIndexBufferData.size()
+		});
+
+		mIndexBufferData.insert(mIndexBufferData.end(), lodIndices.begin(), lodIndices.end());
+	}
+}
+
 void BaseRenderableSceneBuilder::AssignSubmeshMaterials(const std::unordered_map<std::string, RenderableSceneMaterialData>& descriptionMaterials, const std::vector<std::span<const NamedSceneMeshData>>& meshInstanceSpans)
 {
 	mMaterialData.clear();
@@ -421,7 +670,7 @@ void BaseRenderableSceneBuilder::AssignSubmeshMaterials(const std::unordered_map
 			uint32_t sceneSubmeshIndex = sceneMesh.FirstSubmeshIndex + submeshIndex;
 			for(uint32_t instanceIndex = 0; instanceIndex < sceneMesh.InstanceCount; instanceIndex++)
 			{
-				const RenderableSceneMeshData& meshInstance = instanceSpan[instanceIndex].MeshData;
+				const RenderableSceneMeshData& meshInstance = *instanceSpan[instanceIndex].MeshData;
 
 				auto materialIndexIt = materialIndices.find(meshInstance.Submeshes[submeshIndex].MaterialName);
 				if(materialIndexIt != materialIndices.end())
@@ -461,7 +710,7 @@ void BaseRenderableSceneBuilder::AssignSubmeshMaterials(const std::unordered_map
 					auto normalMapIndexIt = textureIndices.find(materialData.NormalMapFilename);
 					if(normalMapIndexIt != textureIndices.end())
 					{
-						material.NormalMapIndex = textureIndexIt->second;
+						material.NormalMapIndex = normalMapIndexIt->second;
 					}
 					else if(!materialData.NormalMapFilename.empty())
 					{
@@ -481,7 +730,7 @@ void BaseRenderableSceneBuilder::AssignSubmeshMaterials(const std::unordered_map
 	}
 }
 
-void BaseRenderableSceneBuilder::FillInitialObjectData(const std::vector<std::span<const NamedSceneMeshData>>& meshInstanceSpans, const std::unordered_map<std::string_view, SceneObjectLocation>& sceneMeshInitialLocations)
+void BaseRenderableSceneBuilder::FillInitialObjectData(const std::vector<std::span<const NamedSceneMeshData>>& meshInstanceSpans)
 {
 	for(uint32_t meshIndex = mSceneToBuild->mNonStaticMeshSpan.Begin; meshIndex < mSceneToBuild->mNonStaticMeshSpan.End; meshIndex++)
 	{
@@ -493,7 +742,7 @@ void BaseRenderableSceneBuilder::FillInitialObjectData(const std::vector<std::sp
 			const NamedSceneMeshData& meshData = instanceSpan[instanceIndex];
 			assert(sceneMesh.PerObjectDataIndex + instanceIndex == mInitialObjectData.size());
 
-			const SceneObjectLocation& meshInitialLocation = sceneMeshInitialLocations.at(meshData.MeshName);
+			const SceneObjectLocation& meshInitialLocation = *meshData.InitialLocation;
 			mInitialObjectData.push_back(meshInitialLocation);
 		}
 	}
@@ -509,6 +758,10 @@ void BaseRenderableSceneBuilder::AssignMeshHandles(const std::vector<std::span<c
 		for(uint32_t instanceIndex = 0; instanceIndex < (uint32_t)instanceSpan.size(); instanceIndex++)
 		{
 			const NamedSceneMeshData& namedMeshData = instanceSpan[instanceIndex];
+			if(namedMeshData.InstanceIndex != 0)
+			{
+				continue;
+			}
 
 			uint32_t objectDataIndex = sceneMesh.PerObjectDataIndex + instanceIndex;
 			outObjectHandles[namedMeshData.MeshName] = objectDataIndex;
@@ -516,6 +769,311 @@ void BaseRenderableSceneBuilder::AssignMeshHandles(const std::vector<std::span<c
 	}
 }
 
+void BaseRenderableSceneBuilder::ComputeBoundingVolumes(const std::vector<std::span<const NamedSceneMeshData>>& meshInstanceSpans)
+{
+	//The geometries are shared between the meshes, each sphere is computed once. All geometries went through the bake cache in AssignSubmeshGeometries()
+	auto calculateMeshLocalSphere = [this](const RenderableSceneMeshData& meshData)
+	{
+		DirectX::BoundingSphere meshSphere(DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f), 0.0f);
+		for(size_t submeshIndex = 0; submeshIndex < meshData.Submeshes.size(); submeshIndex++)
+		{
+			const DirectX::BoundingSphere& geometrySphere = mCachedGeometries.at(meshData.Submeshes[submeshIndex].GeometryName)->LocalBoundingSphere;
+			if(submeshIndex == 0)
+			{
+				meshSphere = geometrySphere;
+			}
+			else
+			{
+				DirectX::BoundingSphere::CreateMerged(meshSphere, meshSphere, geometrySphere);
+			}
+		}
+
+		return meshSphere;
+	};
+
+	uint32_t meshCount = (uint32_t)mSceneToBuild->mSceneMeshes.size();
+	std::vector<DirectX::BoundingSphere> meshSpheres(meshCount);
+
+	mSceneToBuild->mObjectLocalBoundingSpheres.resize(mInitialObjectData.size());
+	mSceneToBuild->mObjectBoundingSpheres.resize(mInitialObjectData.size());
+	mSceneToBuild->mObjectMeshIndices.resize(mInitialObjectData.size());
+
+	//The geometry of static unique meshes is already in world space, but the vertex data is not kept per mesh. Transform the sphere instead
+	for(uint32_t meshIndex = mSceneToBuild->mStaticUniqueMeshSpan.Begin; meshIndex < mSceneToBuild->mStaticUniqueMeshSpan.End; meshIndex++)
+	{
+		const NamedSceneMeshData& representativeMesh = meshInstanceSpans[meshIndex].front();
+
+		DirectX::BoundingSphere meshLocalSphere = calculateMeshLocalSphere(*representativeMesh.MeshData);
+		meshSpheres[meshIndex] = BaseRenderableScene::TransformBoundingSphere(meshLocalSphere, *representativeMesh.InitialLocation);
+	}
+
+	for(uint32_t meshIndex = mSceneToBuild->mNonStaticMeshSpan.Begin; meshIndex < mSceneToBuild->mNonStaticMeshSpan.End; meshIndex++)
+	{
+		const BaseRenderableScene::SceneMesh& sceneMesh = mSceneToBuild->mSceneMeshes[meshIndex];
+
+		DirectX::BoundingSphere meshLocalSphere = calculateMeshLocalSphere(*meshInstanceSpans[meshIndex].front().MeshData);
+		DirectX::BoundingSphere meshSphere      = meshLocalSphere;
+		for(uint32_t instanceIndex = 0; instanceIndex < sceneMesh.InstanceCount; instanceIndex++)
+		{
+			uint32_t objectIndex = sceneMesh.PerObjectDataIndex + instanceIndex;
+
+			mSceneToBuild->mObjectLocalBoundingSpheres[objectIndex] = meshLocalSphere;
+			mSceneToBuild->mObjectBoundingSpheres[objectIndex]      = BaseRenderableScene::TransformBoundingSphere(meshLocalSphere, mInitialObjectData[objectIndex]);
+			mSceneToBuild->mObjectMeshIndices[objectIndex]          = meshIndex;
+
+			if(instanceIndex == 0)
+			{
+				meshSphere = mSceneToBuild->mObjectBoundingSpheres[objectIndex];
+			}
+			else
+			{
+				DirectX::BoundingSphere::CreateMerged(meshSphere, meshSphere, mSceneToBuild->mObjectBoundingSpheres[objectIndex]);
+			}
+		}
+
+		meshSpheres[meshIndex] = meshSphere;
+	}
+
+	//Spheres make for loose nodes, the trees are built over their boxes
+	std::vector<DirectX::BoundingBox> meshBounds(meshCount);
+	for(uint32_t meshIndex = 0; meshIndex < meshCount; meshIndex++)
+	{
+		DirectX::BoundingBox::CreateFromSphere(meshBounds[meshIndex], meshSpheres[meshIndex]);
+	}
+
+	Span<uint32_t> rigidMeshSpan = mSceneToBuild->mRigidMeshSpan;
+	mSceneToBuild->mStaticMeshTree.Build(std::span(meshBounds).subspan(0, rigidMeshSpan.Begin), nullptr);
+	mSceneToBuild->mRigidMeshTree.Build(std::span(meshBounds).subspan(rigidMeshSpan.Begin, rigidMeshSpan.End - rigidMeshSpan.Begin), nullptr);
+
+	//All meshes are visible until the first CullMeshes() call
+	mSceneToBuild->mVisibleMeshIndices.resize(meshCount);
+	std::iota(mSceneToBuild->mVisibleMeshIndices.begin(), mSceneToBuild->mVisibleMeshIndices.end(), 0);
+	mSceneToBuild->mVisibleNonStaticMeshOffset = mSceneToBuild->mNonStaticMeshSpan.Begin;
+}
+
+void BaseRenderableSceneBuilder::CollectOccluders(const std::unordered_map<std::string, RenderableSceneGeometryData>& descriptionGeometries, const std::vector<std::span<const NamedSceneMeshData>>& meshInstanceSpans)
+{
+	mSceneToBuild->mOcclusionCuller.ClearOccluders();
+
+	//The rigid meshes would need the occluder triangles to move with them, only the static ones are used
+	for(uint32_t meshIndex = 0; meshIndex < mSceneToBuild->mRigidMeshSpan.Begin; meshIndex++)
+	{
+		for(const NamedSceneMeshData& namedMesh: meshInstanceSpans[meshIndex])
+		{
+			if(!(namedMesh.MeshData->MeshFlags & (uint32_t)RenderableSceneMeshFlags::Occluder))
+			{
+				continue;
+			}
+
+			const SceneObjectLocation& meshLocation = *namedMesh.InitialLocation;
+
+			DirectX::XMVECTOR scale    = DirectX::XMVectorSet(meshLocation.Scale, meshLocation.Scale, meshLocation.Scale, 0.0f);
+			DirectX::XMVECTOR rotation = DirectX::XMLoadFloat4(&meshLocation.RotationQuaternion);
+			DirectX::XMVECTOR position = DirectX::XMLoadFloat3(&meshLocation.Position);
+
+			DirectX::XMMATRIX worldMatrix = DirectX::XMMatrixAffineTransformation(scale, DirectX::XMVectorZero(), rotation, position);
+			for(const RenderableSceneSubmeshData& submesh: namedMesh.MeshData->Submeshes)
+			{
+				const RenderableSceneGeometryData& geometry = descriptionGeometries.at(submesh.GeometryName);
+				mSceneToBuild->mOcclusionCuller.AddOccluder(geometry.Vertices, geometry.Indices, worldMatrix);
+			}
+		}
+	}
+}
+
+void BaseRenderableSceneBuilder::BuildHlodClusters()
+{
+	Span<uint32_t> staticUniqueMeshSpan = mSceneToBuild->mStaticUniqueMeshSpan;
+
+	mSceneToBuild->mStaticMeshHlodClusters.assign(staticUniqueMeshSpan.End, BaseRenderableScene::NoHlodCluster);
+	mSceneToBuild->mHlodClusterParents.clear();
+
+	//Only the static unique meshes have world space geometry to merge. Sorting them along the Morton curve puts the nearby ones next to each other
+	DirectX::XMVECTOR centersMin = DirectX::XMVectorReplicate( std::numeric_limits<float>::max());
+	DirectX::XMVECTOR centersMax = DirectX::XMVectorReplicate(-std::numeric_limits<float>::max());
+	for(uint32_t meshIndex = staticUniqueMeshSpan.Begin; meshIndex < staticUniqueMeshSpan.End; meshIndex++)
+	{
+		DirectX::BoundingBox meshBounds = mSceneToBuild->mStaticMeshTree.GetItemBounds(meshIndex);
+
+		centersMin = DirectX::XMVectorMin(centersMin, DirectX::XMLoadFloat3(&meshBounds.Center));
+		centersMax = DirectX::XMVectorMax(centersMax, DirectX::XMLoadFloat3(&meshBounds.Center));
+	}
+
+	const float mortonGridSize = 1023.0f;
+	DirectX::XMVECTOR centersRange = DirectX::XMVectorMax(DirectX::XMVectorSubtract(centersMax, centersMin), DirectX::XMVectorReplicate(std::numeric_limits<float>::min()));
+	DirectX::XMVECTOR mortonScale  = DirectX::XMVectorDivide(DirectX::XMVectorReplicate(mortonGridSize), centersRange);
+
+	auto spreadMortonBits = [](uint32_t coordinate)
+	{
+		coordinate = (coordinate | (coordinate << 16)) & 0x030000ff;
+		coordinate = (coordinate | (coordinate <<  8)) & 0x0300f00f;
+		coordinate = (coordinate | (coordinate <<  4)) & 0x030c30c3;
+		coordinate = (coordinate | (coordinate <<  2)) & 0x09249249;
+		return coordinate;
+	};
+
+	std::vector<std::pair<uint32_t, uint32_t>> meshMortonCodes;
+	meshMortonCodes.reserve(staticUniqueMeshSpan.End - staticUniqueMeshSpan.Begin);
+	for(uint32_t meshIndex = staticUniqueMeshSpan.Begin; meshIndex < staticUniqueMeshSpan.End; meshIndex++)
+	{
+		DirectX::BoundingBox meshBounds = mSceneToBuild->mStaticMeshTree.GetItemBounds(meshIndex);
+
+		DirectX::XMFLOAT3 gridCoordinates;
+		DirectX::XMStoreFloat3(&gridCoordinates, DirectX::XMVectorMultiply(DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&meshBounds.Center), centersMin), mortonScale));
+
+		uint32_t mortonCode = spreadMortonBits((uint32_t)gridCoordinates.x) | (spreadMortonBits((uint32_t)gridCoordinates.y) << 1) | (spreadMortonBits((uint32_t)gridCoordinates.z) << 2);
+		meshMortonCodes.push_back(std::make_pair(mortonCode, meshIndex));
+	}
+
+	std::sort(meshMortonCodes.begin(), meshMortonCodes.end());
+
+	std::vector<uint32_t> levelMemberMeshIndices(meshMortonCodes.size());
+	std::transform(meshMortonCodes.begin(), meshMortonCodes.end(), levelMemberMeshIndices.begin(), [](const std::pair<uint32_t, uint32_t>& mortonCode) {return mortonCode.second;});
+
+	//Each run of the members in the sorted order becomes a cluster. The clusters of a level come in the same order as their members
+	uint32_t proxyMeshSpanBegin = (uint32_t)mSceneToBuild->mSceneMeshes.size();
+
+	std::vector<DirectX::BoundingBox> clusterBounds;
+	std::vector<uint32_t>             nextLevelMemberMeshIndices;
+	for(uint32_t levelIndex = 0; levelIndex < BaseRenderableScene::MaxHlodLevelCount && levelMemberMeshIndices.size() >= 2; levelIndex++)
+	{
+		nextLevelMemberMeshIndices.clear();
+		for(size_t firstMemberIndex = 0; firstMemberIndex < levelMemberMeshIndices.size(); firstMemberIndex += BaseRenderableScene::HlodClusterChildCount)
+		{
+			size_t memberCount = std::min((size_t)BaseRenderableScene::HlodClusterChildCount, levelMemberMeshIndices.size() - firstMemberIndex);
+			std::span<const uint32_t> memberMeshIndices = std::span(levelMemberMeshIndices).subspan(firstMemberIndex, memberCount);
+
+			uint32_t clusterIndex = (uint32_t)mSceneToBuild->mHlodClusterParents.size();
+			mSceneToBuild->mHlodClusterParents.push_back(BaseRenderableScene::NoHlodCluster);
+
+			//The members of the first level are meshes, the members of the next ones are the proxies of the clusters
+			auto getMemberBounds = [this, levelIndex, proxyMeshSpanBegin, &clusterBounds](uint32_t memberMeshIndex)
+			{
+				return (levelIndex == 0) ? mSceneToBuild->mStaticMeshTree.GetItemBounds(memberMeshIndex) : clusterBounds[memberMeshIndex - proxyMeshSpanBegin];
+			};
+
+			DirectX::BoundingBox bounds = getMemberBounds(memberMeshIndices.front());
+			for(uint32_t memberMeshIndex: memberMeshIndices)
+			{
+				if(levelIndex == 0)
+				{
+					mSceneToBuild->mStaticMeshHlodClusters[memberMeshIndex] = clusterIndex;
+				}
+				else
+				{
+					mSceneToBuild->mHlodClusterParents[memberMeshIndex - proxyMeshSpanBegin] = clusterIndex;
+				}
+
+				DirectX::BoundingBox::CreateMerged(bounds, bounds, getMemberBounds(memberMeshIndex));
+			}
+
+			clusterBounds.push_back(bounds);
+
+			AppendHlodProxyMesh(memberMeshIndices);
+			nextLevelMemberMeshIndices.push_back(proxyMeshSpanBegin + clusterIndex);
+		}
+
+		std::swap(levelMemberMeshIndices, nextLevelMemberMeshIndices);
+	}
+
+	mSceneToBuild->mHlodProxyMeshSpan.Begin = proxyMeshSpanBegin;
+	mSceneToBuild->mHlodProxyMeshSpan.End   = (uint32_t)mSceneToBuild->mSceneMeshes.size();
+
+	assert(mSceneToBuild->mHlodProxyMeshSpan.End - mSceneToBuild->mHlodProxyMeshSpan.Begin == (uint32_t)mSceneToBuild->mHlodClusterParents.size());
+
+	mSceneToBuild->mHlodClusterFlags.assign(mSceneToBuild->mHlodClusterParents.size(), 0);
+	mSceneToBuild->mHlodClusterTree.Build(clusterBounds, nullptr);
+
+	mSceneToBuild->mMeshLodLevels.resize(mSceneToBuild->mSceneMeshes.size(), 0);
+}
+
+void BaseRenderableSceneBuilder::AppendHlodProxyMesh(std::span<const uint32_t> memberMeshIndices)
+{
+	std::vector<std::pair<uint32_t, uint32_t>> materialSubmeshIndices;
+	for(uint32_t memberMeshIndex: memberMeshIndices)
+	{
+		const BaseRenderableScene::SceneMesh& memberMesh = mSceneToBuild->mSceneMeshes[memberMeshIndex];
+		for(uint32_t submeshIndex = memberMesh.FirstSubmeshIndex; submeshIndex < memberMesh.AfterLastSubmeshIndex; submeshIndex++)
+		{
+			materialSubmeshIndices.push_back(std::make_pair(mSceneToBuild->mSceneSubmeshes[submeshIndex].MaterialIndex, submeshIndex));
+		}
+	}
+
+	std::sort(materialSubmeshIndices.begin(), materialSubmeshIndices.end());
+
+	uint32_t firstProxySubmeshIndex = (uint32_t)mSceneToBuild->mSceneSubmeshes.size();
+
+	std::vector<RenderableSceneVertex>                mergedVertices;
+	std::vector<RenderableSceneIndex>                 mergedIndices;
+	std::vector<uint32_t>                             mergedVertexBufferIndices;
+	std::unordered_map<uint32_t, RenderableSceneIndex> vertexBufferToMergedIndices;
+
+	auto materialRangeBegin = materialSubmeshIndices.begin();
+	while(materialRangeBegin != materialSubmeshIndices.end())
+	{
+		uint32_t materialIndex = materialRangeBegin->first;
+		auto materialRangeEnd  = std::find_if(materialRangeBegin, materialSubmeshIndices.end(), [materialIndex](const std::pair<uint32_t, uint32_t>& materialSubmesh) {return materialSubmesh.first != materialIndex;});
+
+		//The vertex data of static unique meshes and proxies is in world space, the merged geometry only needs the indices of the used vertices
+		mergedVertices.clear();
+		mergedIndices.clear();
+		mergedVertexBufferIndices.clear();
+		vertexBufferToMergedIndices.clear();
+		for(auto materialSubmeshIt = materialRangeBegin; materialSubmeshIt != materialRangeEnd; ++materialSubmeshIt)
+		{
+			const BaseRenderableScene::SceneSubmesh&    memberSubmesh = mSceneToBuild->mSceneSubmeshes[materialSubmeshIt->second];
+			const BaseRenderableScene::SceneSubmeshLod& coarsestLod   = mSceneToBuild->mSceneSubmeshLods[memberSubmesh.FirstLodIndex + memberSubmesh.LodCount - 1];
+			for(uint32_t indexIndex = coarsestLod.FirstIndex; indexIndex < coarsestLod.FirstIndex + coarsestLod.IndexCount; indexIndex++)
+			{
+				uint32_t vertexBufferIndex = (uint32_t)memberSubmesh.VertexOffset + mIndexBufferData[indexIndex];
+
+				auto [mergedIndexIt, newVertex] = vertexBufferToMergedIndices.emplace(vertexBufferIndex, (RenderableSceneIndex)mergedVertices.size());
+				if(newVertex)
+				{
+					mergedVertices.push_back(mVertexBufferData[vertexBufferIndex]);
+					mergedVertexBufferIndices.push_back(vertexBufferIndex);
+				}
+
+				mergedIndices.push_back(mergedIndexIt->second);
+			}
+		}
+
+		//The merged geometry is in world space, it only stays the same while the members and their locations do
+		const std::vector<std::vector<RenderableSceneIndex>>& simplifiedIndices = mBakeCacheRef->GenerateLods(mergedVertices, mergedIndices, 2);
+
+		//The proxy indices refer to the vertex buffer directly
+		const std::vector<RenderableSceneIndex>& proxyIndices = simplifiedIndices.empty() ? mergedIndices : simplifiedIndices.front();
+		mSceneToBuild->mSceneSubmeshes.push_back(BaseRenderableScene::SceneSubmesh
+		{
+			.FirstLodIndex = (uint32_t)mSceneToBuild->mSceneSubmeshLods.size(),
+			.LodCount      = 1,
+			.VertexOffset  = 0,
+			.MaterialIndex = materialIndex
+		});
+
+		mSceneToBuild->mSceneSubmeshLods.push_back(BaseRenderableScene::SceneSubmeshLod
+		{
+			.IndexCount = (uint32_t)proxyIndices.size(),
+			.FirstIndex = (uint32_t)mIndexBufferData.size()
+		});
+
+		for(RenderableSceneIndex proxyIndex: proxyIndices)
+		{
+			mIndexBufferData.push_back(mergedVertexBufferIndices[proxyIndex]);
+		}
+
+		materialRangeBegin = materialRangeEnd;
+	}
+
+	mSceneToBuild->mSceneMeshes.push_back(BaseRenderableScene::SceneMesh
+	{
+		.PerObjectDataIndex    = (uint32_t)(-1), //The proxies are static unique meshes too
+		.InstanceCount         = 1,
+		.FirstSubmeshIndex     = firstProxySubmeshIndex,
+		.AfterLastSubmeshIndex = (uint32_t)mSceneToBuild->mSceneSubmeshes.size()
+	});
+}
+
 bool BaseRenderableSceneBuilder::SameGeometry(const RenderableSceneMeshData& left, const RenderableSceneMeshData& right) const
 {
 	if(left.Submeshes.size() != right.Submeshes.size())
@@ -532,4 +1090,334 @@ bool BaseRenderableSceneBuilder::SameGeometry(const RenderableSceneMeshData& lef
 	}
 
 	return true;
+}
+
+void BaseRenderableSceneBuilder::AllocateDynamicObjectSlots(uint32_t dynamicObjectCapacity)
+{
+	uint32_t firstSlotMeshIndex   = (uint32_t)mSceneToBuild->mSceneMeshes.size();
+	uint32_t firstSlotObjectIndex = (uint32_t)mInitialObjectData.size();
+	assert(firstSlotObjectIndex + dynamicObjectCapacity <= RenderableObjectIndexMask);
+
+	//The object data of the slots goes right after the rigid objects. The free slots draw nothing until AddObject() gives them the submeshes of a prototype
+	for(uint32_t slotIndex = 0; slotIndex < dynamicObjectCapacity; slotIndex++)
+	{
+		mSceneToBuild->mSceneMeshes.push_back(BaseRenderableScene::SceneMesh
+		{
+			.PerObjectDataIndex    = firstSlotObjectIndex + slotIndex,
+			.InstanceCount         = 0,
+			.FirstSubmeshIndex     = 0,
+			.AfterLastSubmeshIndex = 0
+		});
+	}
+
+	mSceneToBuild->mDynamicMeshSpan.Begin = firstSlotMeshIndex;
+	mSceneToBuild->mDynamicMeshSpan.End   = (uint32_t)mSceneToBuild->mSceneMeshes.size();
+
+	const DirectX::BoundingSphere emptySphere(DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f), 0.0f);
+	mSceneToBuild->mObjectLocalBoundingSpheres.resize(firstSlotObjectIndex + dynamicObjectCapacity, emptySphere);
+	mSceneToBuild->mObjectBoundingSpheres.resize(firstSlotObjectIndex + dynamicObjectCapacity, emptySphere);
+	mSceneToBuild->mObjectMeshIndices.resize(firstSlotObjectIndex + dynamicObjectCapacity);
+	for(uint32_t slotIndex = 0; slotIndex < dynamicObjectCapacity; slotIndex++)
+	{
+		mSceneToBuild->mObjectMeshIndices[firstSlotObjectIndex + slotIndex] = firstSlotMeshIndex + slotIndex;
+	}
+
+	std::vector<DirectX::BoundingBox> slotBounds(dynamicObjectCapacity, DirectX::BoundingBox(DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f), DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f)));
+	mSceneToBuild->mDynamicMeshTree.Build(slotBounds, nullptr);
+
+	//The free list is popped from the back, start with the first slot
+	mSceneToBuild->mFreeDynamicObjectSlots.resize(dynamicObjectCapacity);
+	std::iota(mSceneToBuild->mFreeDynamicObjectSlots.rbegin(), mSceneToBuild->mFreeDynamicObjectSlots.rend(), 0);
+
+	mSceneToBuild->mDynamicObjectGenerations.assign(dynamicObjectCapacity, 0);
+	mSceneToBuild->mRemovedDynamicObjectSlots.clear();
+	for(std::vector<uint32_t>& retiredSlots: mSceneToBuild->mRetiredDynamicObjectSlots)
+	{
+		retiredSlots.clear();
+	}
+
+	mSceneToBuild->mAddedObjectUpdates.clear();
+
+	mSceneToBuild->mMeshLodLevels.resize(mSceneToBuild->mSceneMeshes.size(), 0);
+
+	mDynamicObjectCount = dynamicObjectCapacity;
+}
+
+uint64_t BaseRenderableSceneBuilder::HashSceneDescription(const RenderableSceneDescription& sceneDescription, const std::unordered_map<std::string_view, SceneObjectLocation>& sceneMeshInitialLocations) const
+{
+	//The order of the hash map entries doesn't change the built scene, the hashes of the entries are added up
+	uint64_t meshesHash = 0;
+	for(const auto& [meshName, meshData]: sceneDescription.mSceneMeshes)
+	{
+		uint64_t meshHash = HashArray(RenderableSceneBakeCache::InitialHash, std::span<const char>(meshName));
+		for(const RenderableSceneSubmeshData& submesh: meshData.Submeshes)
+		{
+			meshHash = HashArray(meshHash, std::span<const char>(submesh.GeometryName));
+			meshHash = HashArray(meshHash, std::span<const char>(submesh.MaterialName));
+		}
+
+		std::array meshParameters = {meshData.MeshFlags, meshData.FirstInstanceIndex, meshData.InstanceCount};
+		meshesHash += HashArray(meshHash, std::span<const uint32_t>(meshParameters));
+	}
+
+	uint64_t locationsHash = HashArray(RenderableSceneBakeCache::InitialHash, std::span<const SceneObjectLocation>(sceneDescription.mMeshInstanceLocations));
+	for(const auto& [meshName, meshLocation]: sceneMeshInitialLocations)
+	{
+		uint64_t locationHash = HashArray(RenderableSceneBakeCache::InitialHash, std::span<const char>(meshName));
+		locationsHash += HashArray(locationHash, std::span(&meshLocation, 1));
+	}
+
+	uint64_t geometriesHash = 0;
+	for(const auto& [geometryName, geometryData]: sceneDescription.mSceneGeometries)
+	{
+		uint64_t geometryHash = HashArray(RenderableSceneBakeCache::InitialHash, std::span<const char>(geometryName));
+		geometryHash = HashArray(geometryHash, std::span<const RenderableSceneVertex>(geometryData.Vertices));
+		geometryHash = HashArray(geometryHash, std::span<const RenderableSceneIndex>(geometryData.Indices));
+		for(const std::vector<RenderableSceneIndex>& lodIndices: geometryData.LodIndices)
+		{
+			geometryHash = HashArray(geometryHash, std::span<const RenderableSceneIndex>(lodIndices));
+		}
+
+		geometriesHash += geometryHash;
+	}
+
+	//The texture files are not read to hash them, the changed files are found by their size and write time the same way the bake cache does it
+	auto hashTexture = [&sceneDescription](uint64_t hash, const std::wstring& textureFilename)
+	{
+		hash = HashArray(hash, std::span<const wchar_t>(textureFilename));
+		if(textureFilename.empty() || sceneDescription.mSceneTextureData.contains(textureFilename))
+		{
+			return hash;
+		}
+
+		std::filesystem::path textureFilePath(textureFilename);
+
+		std::error_code fileError;
+		std::array textureFileStats =
+		{
+			(uint64_t)std::filesystem::file_size(textureFilePath, fileError),
+			(uint64_t)std::filesystem::last_write_time(textureFilePath, fileError).time_since_epoch().count()
+		};
+
+		return HashArray(hash, std::span<const uint64_t>(textureFileStats));
+	};
+
+	uint64_t materialsHash = 0;
+	for(const auto& [materialName, materialData]: sceneDescription.mSceneMaterials)
+	{
+		uint64_t materialHash = HashArray(RenderableSceneBakeCache::InitialHash, std::span<const char>(materialName));
+		materialHash = hashTexture(materialHash, materialData.TextureFilename);
+		materialHash = hashTexture(materialHash, materialData.NormalMapFilename);
+
+		materialsHash += materialHash;
+	}
+
+	uint64_t texturesHash = 0;
+	for(const auto& [textureName, textureData]: sceneDescription.mSceneTextureData)
+	{
+		uint64_t textureHash = HashArray(RenderableSceneBakeCache::InitialHash, std::span<const wchar_t>(textureName));
+		texturesHash += HashArray(textureHash, std::span<const std::byte>(textureData));
+	}
+
+	std::array descriptionHashes = {meshesHash, locationsHash, geometriesHash, materialsHash, texturesHash, (uint64_t)sceneDescription.mDynamicObjectCapacity};
+	return HashArray(RenderableSceneBakeCache::InitialHash, std::span<const uint64_t>(descriptionHashes));
+}
+
+bool BaseRenderableSceneBuilder::LoadSceneCache(const RenderableSceneDescription& sceneDescription, uint64_t descriptionHash, std::unordered_map<std::string_view, RenderableSceneObjectHandle>& outObjectHandles)
+{
+	if(!mSceneCacheFile.Open(mSceneCacheFilename, SceneCacheVersion, descriptionHash, (uint32_t)SceneCacheSection::Count))
+	{
+		return false;
+	}
+
+	std::span<const SceneCacheCounts> sceneCacheCounts = GetSceneCacheSectionData<SceneCacheCounts>(mSceneCacheFile, (uint32_t)SceneCacheSection::Counts);
+	assert(sceneCacheCounts.size() == 1);
+
+	const SceneCacheCounts& counts = sceneCacheCounts.front();
+	mSceneToBuild->mStaticUniqueMeshSpan = counts.StaticUniqueMeshSpan;
+	mSceneToBuild->mNonStaticMeshSpan    = counts.NonStaticMeshSpan;
+	mSceneToBuild->mRigidMeshSpan        = counts.RigidMeshSpan;
+	mSceneToBuild->mHlodProxyMeshSpan    = counts.HlodProxyMeshSpan;
+
+	mStaticInstancedObjectCount = counts.StaticInstancedObjectCount;
+	mRigidObjectCount           = counts.RigidObjectCount;
+
+	std::span<const BaseRenderableScene::SceneMesh>       sceneMeshes      = GetSceneCacheSectionData<BaseRenderableScene::SceneMesh>(mSceneCacheFile,       (uint32_t)SceneCacheSection::SceneMeshes);
+	std::span<const BaseRenderableScene::SceneSubmesh>    sceneSubmeshes   = GetSceneCacheSectionData<BaseRenderableScene::SceneSubmesh>(mSceneCacheFile,    (uint32_t)SceneCacheSection::SceneSubmeshes);
+	std::span<const BaseRenderableScene::SceneSubmeshLod> sceneSubmeshLods = GetSceneCacheSectionData<BaseRenderableScene::SceneSubmeshLod>(mSceneCacheFile, (uint32_t)SceneCacheSection::SceneSubmeshLods);
+	mSceneToBuild->mSceneMeshes.assign(sceneMeshes.begin(), sceneMeshes.end());
+	mSceneToBuild->mSceneSubmeshes.assign(sceneSubmeshes.begin(), sceneSubmeshes.end());
+	mSceneToBuild->mSceneSubmeshLods.assign(sceneSubmeshLods.begin(), sceneSubmeshLods.end());
+
+	std::span<const DirectX::BoundingSphere> objectLocalBoundingSpheres = GetSceneCacheSectionData<DirectX::BoundingSphere>(mSceneCacheFile, (uint32_t)SceneCacheSection::ObjectLocalBoundingSpheres);
+	std::span<const DirectX::BoundingSphere> objectBoundingSpheres      = GetSceneCacheSectionData<DirectX::BoundingSphere>(mSceneCacheFile, (uint32_t)SceneCacheSection::ObjectBoundingSpheres);
+	std::span<const uint32_t>                objectMeshIndices          = GetSceneCacheSectionData<uint32_t>(mSceneCacheFile,                (uint32_t)SceneCacheSection::ObjectMeshIndices);
+	mSceneToBuild->mObjectLocalBoundingSpheres.assign(objectLocalBoundingSpheres.begin(), objectLocalBoundingSpheres.end());
+	mSceneToBuild->mObjectBoundingSpheres.assign(objectBoundingSpheres.begin(), objectBoundingSpheres.end());
+	mSceneToBuild->mObjectMeshIndices.assign(objectMeshIndices.begin(), objectMeshIndices.end());
+
+	std::span<const uint32_t> staticMeshHlodClusters = GetSceneCacheSectionData<uint32_t>(mSceneCacheFile, (uint32_t)SceneCacheSection::StaticMeshHlodClusters);
+	std::span<const uint32_t> hlodClusterParents     = GetSceneCacheSectionData<uint32_t>(mSceneCacheFile, (uint32_t)SceneCacheSection::HlodClusterParents);
+	mSceneToBuild->mStaticMeshHlodClusters.assign(staticMeshHlodClusters.begin(), staticMeshHlodClusters.end());
+	mSceneToBuild->mHlodClusterParents.assign(hlodClusterParents.begin(), hlodClusterParents.end());
+	mSceneToBuild->mHlodClusterFlags.assign(hlodClusterParents.size(), 0);
+
+	//Only the item bounds of the trees are stored, building the nodes again is fast
+	mSceneToBuild->mStaticMeshTree.Build(GetSceneCacheSectionData<DirectX::BoundingBox>(mSceneCacheFile,  (uint32_t)SceneCacheSection::StaticMeshBounds),  nullptr);
+	mSceneToBuild->mRigidMeshTree.Build(GetSceneCacheSectionData<DirectX::BoundingBox>(mSceneCacheFile,   (uint32_t)SceneCacheSection::RigidMeshBounds),   nullptr);
+	mSceneToBuild->mHlodClusterTree.Build(GetSceneCacheSectionData<DirectX::BoundingBox>(mSceneCacheFile, (uint32_t)SceneCacheSection::HlodClusterBounds), nullptr);
+
+	std::span<const DirectX::XMFLOAT3> occluderVertices = GetSceneCacheSectionData<DirectX::XMFLOAT3>(mSceneCacheFile, (uint32_t)SceneCacheSection::OccluderVertices);
+	std::span<const uint32_t>          occluderIndices  = GetSceneCacheSectionData<uint32_t>(mSceneCacheFile,          (uint32_t)SceneCacheSection::OccluderIndices);
+	mSceneToBuild->mOcclusionCuller.ClearOccluders();
+	mSceneToBuild->mOcclusionCuller.AddWorldSpaceOccluders(occluderVertices, occluderIndices);
+
+	//All meshes are visible until the first CullMeshes() call. The proxy meshes are only made visible by the culling
+	mSceneToBuild->mVisibleMeshIndices.resize(counts.HlodProxyMeshSpan.Begin);
+	std::iota(mSceneToBuild->mVisibleMeshIndices.begin(), mSceneToBuild->mVisibleMeshIndices.end(), 0);
+	mSceneToBuild->mVisibleNonStaticMeshOffset = counts.NonStaticMeshSpan.Begin;
+
+	//The vertex and index data is uploaded straight from the mapped file
+	mVertexBufferSource = GetSceneCacheSectionData<RenderableSceneVertex>(mSceneCacheFile, (uint32_t)SceneCacheSection::VertexBuffer);
+	mIndexBufferSource  = GetSceneCacheSectionData<RenderableSceneIndex>(mSceneCacheFile,  (uint32_t)SceneCacheSection::IndexBuffer);
+
+	std::span<const RenderableSceneMaterial> materials         = GetSceneCacheSectionData<RenderableSceneMaterial>(mSceneCacheFile, (uint32_t)SceneCacheSection::Materials);
+	std::span<const SceneObjectLocation>     initialObjectData = GetSceneCacheSectionData<SceneObjectLocation>(mSceneCacheFile,     (uint32_t)SceneCacheSection::InitialObjectData);
+	mMaterialData.assign(materials.begin(), materials.end());
+	mInitialObjectData.assign(initialObjectData.begin(), initialObjectData.end());
+
+	std::span<const uint32_t>       textureNameLengths   = GetSceneCacheSectionData<uint32_t>(mSceneCacheFile,       (uint32_t)SceneCacheSection::TextureNameLengths);
+	std::span<const wchar_t>        textureNameChars     = GetSceneCacheSectionData<wchar_t>(mSceneCacheFile,        (uint32_t)SceneCacheSection::TextureNameChars);
+	std::span<const Span<uint64_t>> texturePayloadRanges = GetSceneCacheSectionData<Span<uint64_t>>(mSceneCacheFile, (uint32_t)SceneCacheSection::TexturePayloadRanges);
+	std::span<const std::byte>      texturePayloadData   = mSceneCacheFile.GetSection((uint32_t)SceneCacheSection::TexturePayloadData);
+
+	mTexturesToLoad.clear();
+	mSceneCacheTexturePayloads.clear();
+
+	size_t textureNameOffset = 0;
+	for(size_t textureIndex = 0; textureIndex < textureNameLengths.size(); textureIndex++)
+	{
+		mTexturesToLoad.emplace_back(textureNameChars.data() + textureNameOffset, textureNameLengths[textureIndex]);
+		textureNameOffset += textureNameLengths[textureIndex];
+
+		const Span<uint64_t>& payloadRange = texturePayloadRanges[textureIndex];
+		mSceneCacheTexturePayloads.push_back(texturePayloadData.subspan((size_t)payloadRange.Begin, (size_t)(payloadRange.End - payloadRange.Begin)));
+	}
+
+	//The handle map refers to the mesh names stored in the description. The names are the same, the description hash covers them
+	std::span<const uint32_t>                    objectHandleNameLengths = GetSceneCacheSectionData<uint32_t>(mSceneCacheFile,                    (uint32_t)SceneCacheSection::ObjectHandleNameLengths);
+	std::span<const char>                        objectHandleNameChars   = GetSceneCacheSectionData<char>(mSceneCacheFile,                        (uint32_t)SceneCacheSection::ObjectHandleNameChars);
+	std::span<const RenderableSceneObjectHandle> objectHandles           = GetSceneCacheSectionData<RenderableSceneObjectHandle>(mSceneCacheFile, (uint32_t)SceneCacheSection::ObjectHandles);
+
+	outObjectHandles.reserve(objectHandles.size());
+
+	size_t objectHandleNameOffset = 0;
+	for(size_t handleIndex = 0; handleIndex < objectHandles.size(); handleIndex++)
+	{
+		std::string meshName(objectHandleNameChars.data() + objectHandleNameOffset, objectHandleNameLengths[handleIndex]);
+		objectHandleNameOffset += objectHandleNameLengths[handleIndex];
+
+		auto meshIt = sceneDescription.mSceneMeshes.find(meshName);
+		assert(meshIt != sceneDescription.mSceneMeshes.end());
+
+		outObjectHandles[meshIt->first] = objectHandles[handleIndex];
+	}
+
+	return true;
+}
+
+void BaseRenderableSceneBuilder::SaveSceneCache(uint64_t descriptionHash, const std::unordered_map<std::string_view, RenderableSceneObjectHandle>& objectHandles)
+{
+	//The dynamic object slots go after everything built by the steps
+	uint32_t bakedMeshCount   = mSceneToBuild->mDynamicMeshSpan.Begin;
+	uint32_t bakedObjectCount = (uint32_t)mInitialObjectData.size();
+
+	SceneCacheCounts counts =
+	{
+		.StaticUniqueMeshSpan       = mSceneToBuild->mStaticUniqueMeshSpan,
+		.NonStaticMeshSpan          = mSceneToBuild->mNonStaticMeshSpan,
+		.RigidMeshSpan              = mSceneToBuild->mRigidMeshSpan,
+		.HlodProxyMeshSpan          = mSceneToBuild->mHlodProxyMeshSpan,
+		.StaticInstancedObjectCount = mStaticInstancedObjectCount,
+		.RigidObjectCount           = mRigidObjectCount
+	};
+
+	auto getTreeItemBounds = [](const BoundingVolumeHierarchy& tree)
+	{
+		std::vector<DirectX::BoundingBox> itemBounds(tree.GetItemCount());
+		for(uint32_t itemIndex = 0; itemIndex < (uint32_t)itemBounds.size(); itemIndex++)
+		{
+			itemBounds[itemIndex] = tree.GetItemBounds(itemIndex);
+		}
+
+		return itemBounds;
+	};
+
+	std::vector<DirectX::BoundingBox> staticMeshBounds  = getTreeItemBounds(mSceneToBuild->mStaticMeshTree);
+	std::vector<DirectX::BoundingBox> rigidMeshBounds   = getTreeItemBounds(mSceneToBuild->mRigidMeshTree);
+	std::vector<DirectX::BoundingBox> hlodClusterBounds = getTreeItemBounds(mSceneToBuild->mHlodClusterTree);
+
+	//The strings are stored as their lengths and all their characters one after another
+	std::vector<uint32_t>       textureNameLengths;
+	std::vector<wchar_t>        textureNameChars;
+	std::vector<Span<uint64_t>> texturePayloadRanges;
+	std::vector<std::byte>      texturePayloadData;
+	for(size_t textureIndex = 0; textureIndex < mTexturesToLoad.size(); textureIndex++)
+	{
+		textureNameLengths.push_back((uint32_t)mTexturesToLoad[textureIndex].size());
+		textureNameChars.insert(textureNameChars.end(), mTexturesToLoad[textureIndex].begin(), mTexturesToLoad[textureIndex].end());
+
+		//The DDS loaders read the headers in place
+		std::span<const std::byte> textureDdsData = GetTextureDdsData(textureIndex);
+		uint64_t payloadOffset = Utils::AlignMemory(texturePayloadData.size(), sizeof(uint64_t));
+
+		texturePayloadData.resize((size_t)payloadOffset);
+		texturePayloadData.insert(texturePayloadData.end(), textureDdsData.begin(), textureDdsData.end());
+
+		texturePayloadRanges.push_back(Span<uint64_t>
+		{
+			.Begin = payloadOffset,
+			.End   = payloadOffset + textureDdsData.size()
+		});
+	}
+
+	std::vector<uint32_t>                    objectHandleNameLengths;
+	std::vector<char>                        objectHandleNameChars;
+	std::vector<RenderableSceneObjectHandle> objectHandleValues;
+	for(const auto& [meshName, objectHandle]: objectHandles)
+	{
+		objectHandleNameLengths.push_back((uint32_t)meshName.size());
+		objectHandleNameChars.insert(objectHandleNameChars.end(), meshName.begin(), meshName.end());
+		objectHandleValues.push_back(objectHandle);
+	}
+
+	std::array<std::span<const std::byte>, (size_t)SceneCacheSection::Count> sections;
+	sections[(uint32_t)SceneCacheSection::Counts]                     = std::as_bytes(std::span(&counts, 1));
+	sections[(uint32_t)SceneCacheSection::SceneMeshes]                = std::as_bytes(std::span(mSceneToBuild->mSceneMeshes).subspan(0, bakedMeshCount));
+	sections[(uint32_t)SceneCacheSection::SceneSubmeshes]             = std::as_bytes(std::span(mSceneToBuild->mSceneSubmeshes));
+	sections[(uint32_t)SceneCacheSection::SceneSubmeshLods]           = std::as_bytes(std::span(mSceneToBuild->mSceneSubmeshLods));
+	sections[(uint32_t)SceneCacheSection::StaticMeshBounds]           = std::as_bytes(std::span(staticMeshBounds));
+	sections[(uint32_t)SceneCacheSection::RigidMeshBounds]            = std::as_bytes(std::span(rigidMeshBounds));
+	sections[(uint32_t)SceneCacheSection::HlodClusterBounds]          = std::as_bytes(std::span(hlodClusterBounds));
+	sections[(uint32_t)SceneCacheSection::ObjectLocalBoundingSpheres] = std::as_bytes(std::span(mSceneToBuild->mObjectLocalBoundingSpheres).subspan(0, bakedObjectCount));
+	sections[(uint32_t)SceneCacheSection::ObjectBoundingSpheres]      = std::as_bytes(std::span(mSceneToBuild->mObjectBoundingSpheres).subspan(0, bakedObjectCount));
+	sections[(uint32_t)SceneCacheSection::ObjectMeshIndices]          = std::as_bytes(std::span(mSceneToBuild->mObjectMeshIndices).subspan(0, bakedObjectCount));
+	sections[(uint32_t)SceneCacheSection::StaticMeshHlodClusters]     = std::as_bytes(std::span(mSceneToBuild->mStaticMeshHlodClusters));
+	sections[(uint32_t)SceneCacheSection::HlodClusterParents]         = std::as_bytes(std::span(mSceneToBuild->mHlodClusterParents));
+	sections[(uint32_t)SceneCacheSection::OccluderVertices]           = std::as_bytes(mSceneToBuild->mOcclusionCuller.GetOccluderVertices());
+	sections[(uint32_t)SceneCacheSection::OccluderIndices]            = std::as_bytes(mSceneToBuild->mOcclusionCuller.GetOccluderIndices());
+	sections[(uint32_t)SceneCacheSection::VertexBuffer]               = std::as_bytes(mVertexBufferSource);
+	sections[(uint32_t)SceneCacheSection::IndexBuffer]                = std::as_bytes(mIndexBufferSource);
+	sections[(uint32_t)SceneCacheSection::Materials]                  = std::as_bytes(std::span(mMaterialData));
+	sections[(uint32_t)SceneCacheSection::InitialObjectData]          = std::as_bytes(std::span(mInitialObjectData));
+	sections[(uint32_t)SceneCacheSection::TextureNameLengths]         = std::as_bytes(std::span(textureNameLengths));
+	sections[(uint32_t)SceneCacheSection::TextureNameChars]           = std::as_bytes(std::span(textureNameChars));
+	sections[(uint32_t)SceneCacheSection::TexturePayloadRanges]       = std::as_bytes(std::span(texturePayloadRanges));
+	sections[(uint32_t)SceneCacheSection::TexturePayloadData]         = std::as_bytes(std::span(texturePayloadData));
+	sections[(uint32_t)SceneCacheSection::ObjectHandleNameLengths]    = std::as_bytes(std::span(objectHandleNameLengths));
+	sections[(uint32_t)SceneCacheSection::ObjectHandleNameChars]      = std::as_bytes(std::span(objectHandleNameChars));
+	sections[(uint32_t)SceneCacheSection::ObjectHandles]              = std::as_bytes(std::span(objectHandleValues));
+
+	//The scene is built every time if the file can't be written, nothing else changes
+	RenderableSceneCacheFile::Write(mSceneCacheFilename, SceneCacheVersion, descriptionHash, sections);
 }
\ No newline at end of file
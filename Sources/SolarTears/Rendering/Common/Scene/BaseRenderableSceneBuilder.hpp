@@ -1,8 +1,11 @@
 #pragma once
 
 #include "RenderableSceneDescription.hpp"
+#include "RenderableSceneBakeCache.hpp"
+#include "RenderableSceneCacheFile.hpp"
 #include "../../../Core/DataStructures/Span.hpp"
 #include <span>
+#include <array>
 #include <string_view>
 
 class BaseRenderableScene;
@@ -10,10 +13,13 @@ class PinholeCamera;
 
 class BaseRenderableSceneBuilder
 {
+	//One for each drawn object. The instances of the meshes added with RenderableSceneDescription::AddMeshInstances() share the name and the mesh data
 	struct NamedSceneMeshData
 	{
-		std::string_view        MeshName;
-		RenderableSceneMeshData MeshData;
+		std::string_view               MeshName;
+		const RenderableSceneMeshData* MeshData;
+		const SceneObjectLocation*     InitialLocation;
+		uint32_t                       InstanceIndex;
 	};
 
 	struct InstanceSpanBuckets
@@ -24,20 +30,86 @@ class BaseRenderableSceneBuilder
 		Span<uint32_t> RigidInstancedBucket;
 	};
 
+	//Has to change each time the build steps start producing different data for the same description
+	static constexpr uint32_t SceneCacheVersion = 1;
+
+	//The scene cache file keeps the results of steps 1-11. The dynamic object slots are cheap to allocate again
+	enum class SceneCacheSection: uint32_t
+	{
+		Counts = 0,
+		SceneMeshes,
+		SceneSubmeshes,
+		SceneSubmeshLods,
+		StaticMeshBounds,
+		RigidMeshBounds,
+		HlodClusterBounds,
+		ObjectLocalBoundingSpheres,
+		ObjectBoundingSpheres,
+		ObjectMeshIndices,
+		StaticMeshHlodClusters,
+		HlodClusterParents,
+		OccluderVertices,
+		OccluderIndices,
+		VertexBuffer,
+		IndexBuffer,
+		Materials,
+		InitialObjectData,
+		TextureNameLengths,
+		TextureNameChars,
+		TexturePayloadRanges, //Offsets and sizes in TexturePayloadData
+		TexturePayloadData,
+		ObjectHandleNameLengths,
+		ObjectHandleNameChars,
+		ObjectHandles,
+
+		Count
+	};
+
+	struct SceneCacheCounts
+	{
+		Span<uint32_t> StaticUniqueMeshSpan;
+		Span<uint32_t> NonStaticMeshSpan;
+		Span<uint32_t> RigidMeshSpan;
+		Span<uint32_t> HlodProxyMeshSpan;
+		uint32_t       StaticInstancedObjectCount;
+		uint32_t       RigidObjectCount;
+	};
+
+public:
+	static constexpr uint32_t BuildStepCount = 12;
+
 public:
 	BaseRenderableSceneBuilder(BaseRenderableScene* sceneToBuild);
 	~BaseRenderableSceneBuilder();
 
 	void Build(const RenderableSceneDescription& sceneDescription, const std::unordered_map<std::string_view, SceneObjectLocation>& sceneMeshInitialLocations, std::unordered_map<std::string_view, RenderableSceneObjectHandle>& outObjectHandles);
 
+	//Wall clock time of each of the steps of the last Build() call, not including Bake(). The steps skipped by loading the scene cache file take 0
+	std::span<const float> GetLastBuildStepTimesMs() const;
+
+	//The cache should outlive the builder and be passed to the builders of the next versions of the scene. Without it the results are only reused within one Build()
+	void SetBakeCache(RenderableSceneBakeCache* bakeCache);
+
+	//The built scene is saved to the file. The next builds of the same description load it from there instead, and upload the buffer and texture data straight from the mapped file
+	void SetSceneCacheFile(const std::wstring& cacheFilename);
+
+	//True if the last Build() loaded the scene from the scene cache file
+	bool IsLastBuildFromSceneCache() const;
+
 protected:
 	//Transfers the raw buffer data to GPU, loads textures, allocates per-object constant data, etc.
 	virtual void Bake() = 0;
 
+	//The contents of the DDS file to load the texture from. Empty if the file can't be read, the loader reports the error then. Valid during Bake()
+	std::span<const std::byte> GetTextureDdsData(size_t textureIndex);
+
+	//The hash of the data returned by GetTextureDdsData(). The files read through the bake cache are only hashed when they change
+	uint64_t GetTextureContentHash(size_t textureIndex, std::span<const std::byte> textureDdsData) const;
+
 private:
 	//Step 1 of filling in scene data structures
-	//Creates a list of meshes sorted by submesh geometry names
-	void BuildSortedMeshList(const std::unordered_map<std::string, RenderableSceneMeshData>& descriptionMeshes, std::vector<NamedSceneMeshData>& outNamedSceneMeshes) const;
+	//Creates a list of meshes sorted by submesh geometry names. The copies of the mesh data with unsorted submeshes are stored in outSortedMeshData
+	void BuildSortedMeshList(const RenderableSceneDescription& sceneDescription, const std::unordered_map<std::string_view, SceneObjectLocation>& sceneMeshInitialLocations, std::vector<RenderableSceneMeshData>& outSortedMeshData, std::vector<NamedSceneMeshData>& outNamedSceneMeshes) const;
 
 	//Step 2 of filling in scene data structures
 	//Groups the mesh instances together 
@@ -54,7 +126,8 @@ private:
 	//Step 5 of filling in scene data structures
 	//Loads vertex and index buffer data from geometries and initializes initial positional data
 	//Pre-sorting all meshes by geometry in previous steps achieves coherence
-	void AssignSubmeshGeometries(const std::unordered_map<std::string, RenderableSceneGeometryData>& descriptionGeometries, const std::vector<std::span<const NamedSceneMeshData>>& sceneMeshInstanceSpans, const std::unordered_map<std::string_view, SceneObjectLocation>& sceneMeshInitialLocations);
+	//The geometries without the levels of detail in the description get them generated
+	void AssignSubmeshGeometries(const std::unordered_map<std::string, RenderableSceneGeometryData>& descriptionGeometries, const std::vector<std::span<const NamedSceneMeshData>>& sceneMeshInstanceSpans);
 
 	//Step 6 of filling in scene data structures
 	//Initializes materials for scene submeshes
@@ -62,13 +135,48 @@ private:
 
 	//Step 7 of filling in scene data structures
 	//Initializes initial object data
-	void FillInitialObjectData(const std::vector<std::span<const NamedSceneMeshData>>& meshInstanceSpans, const std::unordered_map<std::string_view, SceneObjectLocation>& sceneMeshInitialLocations);
+	void FillInitialObjectData(const std::vector<std::span<const NamedSceneMeshData>>& meshInstanceSpans);
 
 	//Step 8 of filling in scene data structures
-	//Builds a map of mesh name -> object handle
+	//Builds a map of mesh name -> object handle. The instanced meshes map to the handle of the first instance
 	void AssignMeshHandles(const std::vector<std::span<const NamedSceneMeshData>>& meshInstanceSpans, std::unordered_map<std::string_view, RenderableSceneObjectHandle>& outObjectHandles);
 
+	//Step 9 of filling in scene data structures
+	//Computes the bounding spheres of the objects and builds the bounding volume hierarchies of the meshes
+	void ComputeBoundingVolumes(const std::vector<std::span<const NamedSceneMeshData>>& meshInstanceSpans);
+
+	//Step 10 of filling in scene data structures
+	//Gives the world space triangles of the static occluder meshes to the occlusion culler
+	void CollectOccluders(const std::unordered_map<std::string, RenderableSceneGeometryData>& descriptionGeometries, const std::vector<std::span<const NamedSceneMeshData>>& meshInstanceSpans);
+
+	//Step 11 of filling in scene data structures
+	//Groups the nearby static unique meshes into clusters, and the nearby clusters into the clusters of the next level.
+	//Each cluster gets a proxy mesh to be drawn with when it's far away
+	void BuildHlodClusters();
+
+	//Step 12 of filling in scene data structures
+	//Adds the empty meshes and the object data for the objects added and removed at runtime
+	void AllocateDynamicObjectSlots(uint32_t dynamicObjectCapacity);
+
 private:
+	//The key of the scene cache file. Covers everything the build steps read, including the sizes and write times of the texture files
+	uint64_t HashSceneDescription(const RenderableSceneDescription& sceneDescription, const std::unordered_map<std::string_view, SceneObjectLocation>& sceneMeshInitialLocations) const;
+
+	//Replaces steps 1-11 with the data from the scene cache file. Returns false if the file is missing or was saved for a different description
+	bool LoadSceneCache(const RenderableSceneDescription& sceneDescription, uint64_t descriptionHash, std::unordered_map<std::string_view, RenderableSceneObjectHandle>& outObjectHandles);
+
+	//Saves the results of steps 1-11 to the scene cache file. Should be called before the bake cache drops the texture data
+	void SaveSceneCache(uint64_t descriptionHash, const std::unordered_map<std::string_view, RenderableSceneObjectHandle>& objectHandles);
+
+	//The bake cache hashes the geometry contents, only do it once per geometry
+	const RenderableSceneBakeCache::CachedGeometry& GetCachedGeometry(std::string_view geometryName, const RenderableSceneGeometryData& geometryData);
+
+	//Appends the index data and the index ranges of all levels of detail of the geometry
+	void AppendSubmeshLods(std::string_view geometryName, const RenderableSceneGeometryData& geometryData, uint32_t* outFirstLodIndex, uint32_t* outLodCount);
+
+	//Adds a mesh that merges the coarsest levels of detail of the member meshes. The submeshes with the same material are merged into one and simplified further
+	void AppendHlodProxyMesh(std::span<const uint32_t> memberMeshIndices);
+
 	//Compares the geometry of two meshes. The submeshes have to be sorted by geometry name
 	bool SameGeometry(const RenderableSceneMeshData& left, const RenderableSceneMeshData& right) const;
 
@@ -78,11 +186,32 @@ protected:
 	std::vector<RenderableSceneVertex> mVertexBufferData;
 	std::vector<RenderableSceneIndex>  mIndexBufferData;
 
+	//The data Bake() uploads. Refers to the buffers above after the build steps, or to the mapped scene cache file
+	std::span<const RenderableSceneVertex> mVertexBufferSource;
+	std::span<const RenderableSceneIndex>  mIndexBufferSource;
+
 	std::vector<RenderableSceneMaterial> mMaterialData;
 	std::vector<std::wstring>            mTexturesToLoad;
 
+	//The textures generated in memory, valid during Build()
+	const std::unordered_map<std::wstring, std::vector<std::byte>>* mInMemoryTextureDataRef;
+
 	std::vector<SceneObjectLocation> mInitialObjectData;
 
 	uint32_t mStaticInstancedObjectCount;
 	uint32_t mRigidObjectCount;
+	uint32_t mDynamicObjectCount; //The object data for the dynamic objects follows the rigid one, and is updated the same way
+
+	RenderableSceneBakeCache* mBakeCacheRef;
+
+private:
+	std::array<float, BuildStepCount> mBuildStepTimesMs;
+
+	RenderableSceneBakeCache                                                              mOwnBakeCache;
+	std::unordered_map<std::string_view, const RenderableSceneBakeCache::CachedGeometry*> mCachedGeometries; //Valid during Build()
+
+	std::wstring                            mSceneCacheFilename;
+	RenderableSceneCacheFile                mSceneCacheFile;             //Mapped during Build() if the scene is loaded from it
+	std::vector<std::span<const std::byte>> mSceneCacheTexturePayloads; //The DDS data of mTexturesToLoad in the mapped file
+	bool                                    mLastBuildFromSceneCache;
 };
\ No newline at end of file
@@ -0,0 +1,906 @@
+#include "BoundingVolumeHierarchy.hpp"
+#include "../../../Core/ThreadPool.hpp"
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <numeric>
+#include <latch>
+#include <cmath>
+#include <cassert>
+
+namespace
+{
+	float CalculateSurfaceArea(DirectX::FXMVECTOR boundsMin, DirectX::FXMVECTOR boundsMax)
+	{
+		DirectX::XMFLOAT3 size;
+		DirectX::XMStoreFloat3(&size, DirectX::XMVectorMax(DirectX::XMVectorSubtract(boundsMax, boundsMin), DirectX::XMVectorZero()));
+
+		return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+	}
+
+	//Returns false if the box is entirely behind one of the planes in the mask. The planes the box is entirely in front of are removed from the mask,
+	//the children of a node pass them too and don't need to test them again
+	bool TestBoxAgainstFrustum(std::span<const DirectX::XMFLOAT4> frustumPlanes, const DirectX::XMFLOAT3& boundsMin, const DirectX::XMFLOAT3& boundsMax, uint32_t& inoutPlaneMask)
+	{
+		float centerX = (boundsMin.x + boundsMax.x) * 0.5f;
+		float centerY = (boundsMin.y + boundsMax.y) * 0.5f;
+		float centerZ = (boundsMin.z + boundsMax.z) * 0.5f;
+		float extentX = (boundsMax.x - boundsMin.x) * 0.5f;
+		float extentY = (boundsMax.y - boundsMin.y) * 0.5f;
+		float extentZ = (boundsMax.z - boundsMin.z) * 0.5f;
+
+		for(uint32_t planeIndex = 0; planeIndex < (uint32_t)frustumPlanes.size(); planeIndex++)
+		{
+			if((inoutPlaneMask & (1u << planeIndex)) == 0)
+			{
+				continue;
+			}
+
+			const DirectX::XMFLOAT4& plane = frustumPlanes[planeIndex];
+
+			float centerDistance  = plane.x * centerX + plane.y * centerY + plane.z * centerZ + plane.w;
+			float projectedExtent = fabsf(plane.x) * extentX + fabsf(plane.y) * extentY + fabsf(plane.z) * extentZ;
+			if(centerDistance + projectedExtent < 0.0f)
+			{
+				return false;
+			}
+
+			if(centerDistance - projectedExtent >= 0.0f)
+			{
+				inoutPlaneMask &= ~(1u << planeIndex);
+			}
+		}
+
+		return true;
+	}
+}
+
+BoundingVolumeHierarchy::BoundingVolumeHierarchy(): mInnerNodeAreaSum(0.0f), mBuiltCost(0.0f)
+{
+}
+
+BoundingVolumeHierarchy::~BoundingVolumeHierarchy()
+{
+}
+
+void BoundingVolumeHierarchy::Build(std::span<const DirectX::BoundingBox> itemBounds, ThreadPool* threadPool)
+{
+	mItemMins.resize(itemBounds.size());
+	mItemMaxs.resize(itemBounds.size());
+	for(size_t itemIndex = 0; itemIndex < itemBounds.size(); itemIndex++)
+	{
+		DirectX::XMVECTOR center  = DirectX::XMLoadFloat3(&itemBounds[itemIndex].Center);
+		DirectX::XMVECTOR extents = DirectX::XMLoadFloat3(&itemBounds[itemIndex].Extents);
+
+		DirectX::XMStoreFloat3(&mItemMins[itemIndex], DirectX::XMVectorSubtract(center, extents));
+		DirectX::XMStoreFloat3(&mItemMaxs[itemIndex], DirectX::XMVectorAdd(center, extents));
+	}
+
+	Rebuild(threadPool);
+}
+
+void BoundingVolumeHierarchy::Rebuild(ThreadPool* threadPool)
+{
+	mNodes.clear();
+	mDirtyNodes.clear();
+
+	mItemOrder.resize(mItemMins.size());
+	std::iota(mItemOrder.begin(), mItemOrder.end(), 0);
+
+	if(mItemOrder.empty())
+	{
+		FinalizeBuild();
+		return;
+	}
+
+	//The big subtrees are left for the thread pool workers, the top levels above them are built here
+	std::vector<DeferredSubtree> deferredSubtrees;
+	bool buildInParallel = (threadPool != nullptr && threadPool->GetWorkerThreadCount() != 0 && mItemOrder.size() > MaxParallelSubtreeItems);
+
+	mNodes.reserve(2 * mItemOrder.size());
+	mNodes.push_back(Node());
+	BuildNode(mNodes, 0, 0, 0, (uint32_t)mItemOrder.size(), buildInParallel ? &deferredSubtrees : nullptr);
+
+	if(!deferredSubtrees.empty())
+	{
+		BuildDeferredSubtrees(deferredSubtrees, threadPool);
+	}
+
+	FinalizeBuild();
+}
+
+void BoundingVolumeHierarchy::Clear()
+{
+	mNodes.clear();
+
+	mItemMins.clear();
+	mItemMaxs.clear();
+	mItemOrder.clear();
+	mItemOrderIndices.clear();
+	mItemLeafNodes.clear();
+
+	mOrderedItemCentersX.clear();
+	mOrderedItemCentersY.clear();
+	mOrderedItemCentersZ.clear();
+	mOrderedItemExtentsX.clear();
+	mOrderedItemExtentsY.clear();
+	mOrderedItemExtentsZ.clear();
+
+	mNodeParents.clear();
+	mDirtyNodes.clear();
+	mNodeDirtyFlags.clear();
+
+	mInnerNodeAreaSum = 0.0f;
+	mBuiltCost        = 0.0f;
+}
+
+void BoundingVolumeHierarchy::UpdateItemBounds(uint32_t itemIndex, const DirectX::BoundingBox& bounds)
+{
+	assert(itemIndex < mItemLeafNodes.size());
+
+	DirectX::XMVECTOR center  = DirectX::XMLoadFloat3(&bounds.Center);
+	DirectX::XMVECTOR extents = DirectX::XMLoadFloat3(&bounds.Extents);
+
+	DirectX::XMStoreFloat3(&mItemMins[itemIndex], DirectX::XMVectorSubtract(center, extents));
+	DirectX::XMStoreFloat3(&mItemMaxs[itemIndex], DirectX::XMVectorAdd(center, extents));
+	UpdateOrderedItemBounds(mItemOrderIndices[itemIndex]);
+
+	//Mark the whole path to the root, stopping at the part already marked by another item
+	uint32_t nodeIndex = mItemLeafNodes[itemIndex];
+	while(nodeIndex != InvalidIndex && !mNodeDirtyFlags[nodeIndex])
+	{
+		mNodeDirtyFlags[nodeIndex] = 1;
+		mDirtyNodes.push_back(nodeIndex);
+
+		nodeIndex = mNodeParents[nodeIndex];
+	}
+}
+
+void BoundingVolumeHierarchy::Refit()
+{
+	//The children are always created after their parents, so going from the highest index recomputes the children first
+	std::sort(mDirtyNodes.begin(), mDirtyNodes.end(), std::greater<uint32_t>());
+	for(uint32_t nodeIndex: mDirtyNodes)
+	{
+		Node& node = mNodes[nodeIndex];
+		if(node.ItemCount == 0)
+		{
+			mInnerNodeAreaSum -= CalculateNodeArea(node);
+			ComputeNodeBounds(node);
+			mInnerNodeAreaSum += CalculateNodeArea(node);
+		}
+		else
+		{
+			ComputeNodeBounds(node);
+		}
+
+		mNodeDirtyFlags[nodeIndex] = 0;
+	}
+
+	mDirtyNodes.clear();
+}
+
+float BoundingVolumeHierarchy::GetQualityDegradation() const
+{
+	if(mNodes.empty() || mBuiltCost <= 0.0f)
+	{
+		return 1.0f;
+	}
+
+	//The inner node areas are relative to the root, so a tree that just got bigger as a whole doesn't count as degraded
+	float rootArea = CalculateNodeArea(mNodes[0]);
+	if(rootArea <= 0.0f)
+	{
+		return 1.0f;
+	}
+
+	return (mInnerNodeAreaSum / rootArea) / mBuiltCost;
+}
+
+void BoundingVolumeHierarchy::QueryFrustum(std::span<const DirectX::XMFLOAT4> frustumPlanes, std::vector<uint32_t>& outItems, ThreadPool* threadPool) const
+{
+	assert(frustumPlanes.size() <= MaxFrustumPlaneCount);
+	if(mNodes.empty())
+	{
+		return;
+	}
+
+	FrustumPlaneVectors planeVectors;
+	SplatFrustumPlanes(frustumPlanes, planeVectors);
+
+	uint32_t allPlanesMask = (1u << frustumPlanes.size()) - 1;
+
+	bool queryInParallel = (threadPool != nullptr && threadPool->GetWorkerThreadCount() != 0 && mItemOrder.size() > MaxParallelSubtreeItems);
+	if(!queryInParallel)
+	{
+		QueryFrustumSubtree(frustumPlanes, planeVectors, 0, allPlanesMask, 0, outItems, nullptr);
+		return;
+	}
+
+	//The levels above the split depth are queried here, the subtrees below it are left for the thread pool workers.
+	//The split depth leaves about MinParallelSubtreeItems items in each subtree of a balanced tree
+	uint32_t splitDepth = std::min((uint32_t)std::bit_width(mItemOrder.size() / MinParallelSubtreeItems), MaxSahDepth);
+
+	std::vector<DeferredQuery> deferredQueries;
+	QueryFrustumSubtree(frustumPlanes, planeVectors, 0, allPlanesMask, splitDepth, outItems, &deferredQueries);
+
+	if(!deferredQueries.empty())
+	{
+		QueryDeferredSubtrees(frustumPlanes, planeVectors, deferredQueries, threadPool, outItems);
+	}
+}
+
+void BoundingVolumeHierarchy::QuerySphere(const DirectX::BoundingSphere& sphere, std::vector<uint32_t>& outItems) const
+{
+	if(mNodes.empty())
+	{
+		return;
+	}
+
+	DirectX::XMVECTOR sphereCenter  = DirectX::XMLoadFloat3(&sphere.Center);
+	float             sphereRadiusSq = sphere.Radius * sphere.Radius;
+
+	auto intersectsSphere = [sphereCenter, sphereRadiusSq](DirectX::FXMVECTOR boundsMin, DirectX::FXMVECTOR boundsMax)
+	{
+		DirectX::XMVECTOR closestPoint = DirectX::XMVectorClamp(sphereCenter, boundsMin, boundsMax);
+		return DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(DirectX::XMVectorSubtract(closestPoint, sphereCenter))) <= sphereRadiusSq;
+	};
+
+	uint32_t nodeStack[QueryStackSize];
+	uint32_t stackSize = 0;
+
+	nodeStack[stackSize++] = 0;
+	while(stackSize > 0)
+	{
+		const Node& node = mNodes[nodeStack[--stackSize]];
+		if(!intersectsSphere(DirectX::XMLoadFloat3(&node.BoundsMin), DirectX::XMLoadFloat3(&node.BoundsMax)))
+		{
+			continue;
+		}
+
+		if(node.ItemCount != 0)
+		{
+			for(uint32_t itemOrderIndex = node.FirstChildOrItem; itemOrderIndex < node.FirstChildOrItem + node.ItemCount; itemOrderIndex++)
+			{
+				uint32_t itemIndex = mItemOrder[itemOrderIndex];
+				if(intersectsSphere(DirectX::XMLoadFloat3(&mItemMins[itemIndex]), DirectX::XMLoadFloat3(&mItemMaxs[itemIndex])))
+				{
+					outItems.push_back(itemIndex);
+				}
+			}
+		}
+		else
+		{
+			assert(stackSize + 2 <= std::size(nodeStack));
+
+			nodeStack[stackSize++] = node.FirstChildOrItem + 1;
+			nodeStack[stackSize++] = node.FirstChildOrItem;
+		}
+	}
+}
+
+void BoundingVolumeHierarchy::QueryRay(DirectX::FXMVECTOR origin, DirectX::FXMVECTOR direction, float maxDistance, std::vector<uint32_t>& outItems) const
+{
+	if(mNodes.empty())
+	{
+		return;
+	}
+
+	//Slab test. The zero direction components give infinite reciprocals, which work out as long as the origin is not exactly on the slab plane
+	DirectX::XMVECTOR invDirection = DirectX::XMVectorReciprocal(direction);
+
+	auto intersectsRay = [origin, invDirection, maxDistance](DirectX::FXMVECTOR boundsMin, DirectX::FXMVECTOR boundsMax)
+	{
+		DirectX::XMVECTOR distancesToMin = DirectX::XMVectorMultiply(DirectX::XMVectorSubtract(boundsMin, origin), invDirection);
+		DirectX::XMVECTOR distancesToMax = DirectX::XMVectorMultiply(DirectX::XMVectorSubtract(boundsMax, origin), invDirection);
+
+		DirectX::XMFLOAT3 entryDistances;
+		DirectX::XMFLOAT3 exitDistances;
+		DirectX::XMStoreFloat3(&entryDistances, DirectX::XMVectorMin(distancesToMin, distancesToMax));
+		DirectX::XMStoreFloat3(&exitDistances,  DirectX::XMVectorMax(distancesToMin, distancesToMax));
+
+		float entryDistance = std::max(std::max(entryDistances.x, entryDistances.y), std::max(entryDistances.z, 0.0f));
+		float exitDistance  = std::min(std::min(exitDistances.x,  exitDistances.y),  std::min(exitDistances.z,  maxDistance));
+		return entryDistance <= exitDistance;
+	};
+
+	uint32_t nodeStack[QueryStackSize];
+	uint32_t stackSize = 0;
+
+	nodeStack[stackSize++] = 0;
+	while(stackSize > 0)
+	{
+		const Node& node = mNodes[nodeStack[--stackSize]];
+		if(!intersectsRay(DirectX::XMLoadFloat3(&node.BoundsMin), DirectX::XMLoadFloat3(&node.BoundsMax)))
+		{
+			continue;
+		}
+
+		if(node.ItemCount != 0)
+		{
+			for(uint32_t itemOrderIndex = node.FirstChildOrItem; itemOrderIndex < node.FirstChildOrItem + node.ItemCount; itemOrderIndex++)
+			{
+				uint32_t itemIndex = mItemOrder[itemOrderIndex];
+				if(intersectsRay(DirectX::XMLoadFloat3(&mItemMins[itemIndex]), DirectX::XMLoadFloat3(&mItemMaxs[itemIndex])))
+				{
+					outItems.push_back(itemIndex);
+				}
+			}
+		}
+		else
+		{
+			assert(stackSize + 2 <= std::size(nodeStack));
+
+			nodeStack[stackSize++] = node.FirstChildOrItem + 1;
+			nodeStack[stackSize++] = node.FirstChildOrItem;
+		}
+	}
+}
+
+DirectX::BoundingBox BoundingVolumeHierarchy::GetItemBounds(uint32_t itemIndex) const
+{
+	assert(itemIndex < mItemMins.size());
+
+	DirectX::BoundingBox itemBounds;
+	DirectX::BoundingBox::CreateFromPoints(itemBounds, DirectX::XMLoadFloat3(&mItemMins[itemIndex]), DirectX::XMLoadFloat3(&mItemMaxs[itemIndex]));
+
+	return itemBounds;
+}
+
+uint32_t BoundingVolumeHierarchy::GetItemCount() const
+{
+	return (uint32_t)mItemMins.size();
+}
+
+uint32_t BoundingVolumeHierarchy::GetNodeCount() const
+{
+	return (uint32_t)mNodes.size();
+}
+
+void BoundingVolumeHierarchy::BuildNode(std::vector<Node>& nodes, uint32_t nodeIndex, uint32_t depth, uint32_t itemBegin, uint32_t itemEnd, std::vector<DeferredSubtree>* outDeferredSubtrees)
+{
+	uint32_t itemCount = itemEnd - itemBegin;
+	if(outDeferredSubtrees != nullptr && itemCount >= MinParallelSubtreeItems && itemCount <= MaxParallelSubtreeItems)
+	{
+		outDeferredSubtrees->push_back(DeferredSubtree
+		{
+			.NodeIndex = nodeIndex,
+			.Depth     = depth,
+			.ItemBegin = itemBegin,
+			.ItemEnd   = itemEnd
+		});
+
+		return;
+	}
+
+	DirectX::XMVECTOR boundsMin         = DirectX::XMVectorReplicate(std::numeric_limits<float>::max());
+	DirectX::XMVECTOR boundsMax         = DirectX::XMVectorReplicate(-std::numeric_limits<float>::max());
+	DirectX::XMVECTOR centroidBoundsMin = boundsMin;
+	DirectX::XMVECTOR centroidBoundsMax = boundsMax;
+	for(uint32_t itemOrderIndex = itemBegin; itemOrderIndex < itemEnd; itemOrderIndex++)
+	{
+		DirectX::XMVECTOR itemMin = DirectX::XMLoadFloat3(&mItemMins[mItemOrder[itemOrderIndex]]);
+		DirectX::XMVECTOR itemMax = DirectX::XMLoadFloat3(&mItemMaxs[mItemOrder[itemOrderIndex]]);
+		DirectX::XMVECTOR centroid = DirectX::XMVectorAdd(itemMin, itemMax); //Doubled, the scale doesn't matter for the binning
+
+		boundsMin         = DirectX::XMVectorMin(boundsMin, itemMin);
+		boundsMax         = DirectX::XMVectorMax(boundsMax, itemMax);
+		centroidBoundsMin = DirectX::XMVectorMin(centroidBoundsMin, centroid);
+		centroidBoundsMax = DirectX::XMVectorMax(centroidBoundsMax, centroid);
+	}
+
+	Node& node = nodes[nodeIndex];
+	DirectX::XMStoreFloat3(&node.BoundsMin, boundsMin);
+	DirectX::XMStoreFloat3(&node.BoundsMax, boundsMax);
+
+	node.FirstChildOrItem = itemBegin;
+	node.ItemCount        = itemCount;
+	if(itemCount <= 1)
+	{
+		return;
+	}
+
+	//Bin the centroids along the longest axis of their bounds
+	DirectX::XMFLOAT3 centroidMin;
+	DirectX::XMFLOAT3 centroidExtent;
+	DirectX::XMStoreFloat3(&centroidMin,    centroidBoundsMin);
+	DirectX::XMStoreFloat3(&centroidExtent, DirectX::XMVectorSubtract(centroidBoundsMax, centroidBoundsMin));
+
+	uint32_t splitAxis = 0;
+	if(centroidExtent.y > centroidExtent.x && centroidExtent.y >= centroidExtent.z)
+	{
+		splitAxis = 1;
+	}
+	else if(centroidExtent.z > centroidExtent.x && centroidExtent.z > centroidExtent.y)
+	{
+		splitAxis = 2;
+	}
+
+	float axisMin    = (&centroidMin.x)[splitAxis];
+	float axisExtent = (&centroidExtent.x)[splitAxis];
+
+	uint32_t splitOrderIndex = itemBegin + itemCount / 2;
+	if(axisExtent > 0.0f && depth >= MaxSahDepth)
+	{
+		//Badly distributed items can make the surface area heuristic produce very deep trees. Median splits keep the rest of it within the query stack size
+		std::nth_element(mItemOrder.begin() + itemBegin, mItemOrder.begin() + splitOrderIndex, mItemOrder.begin() + itemEnd, [this, splitAxis](uint32_t leftItemIndex, uint32_t rightItemIndex)
+		{
+			float leftCentroid  = (&mItemMins[leftItemIndex].x)[splitAxis]  + (&mItemMaxs[leftItemIndex].x)[splitAxis];
+			float rightCentroid = (&mItemMins[rightItemIndex].x)[splitAxis] + (&mItemMaxs[rightItemIndex].x)[splitAxis];
+			return leftCentroid < rightCentroid;
+		});
+	}
+	else if(axisExtent > 0.0f)
+	{
+		//Small nodes don't need many bins to find a good split
+		uint32_t binCount = std::min(itemCount, BinCount);
+		float    binScale = (float)binCount / axisExtent;
+		auto calculateBinIndex = [this, splitAxis, axisMin, binScale, binCount](uint32_t itemIndex)
+		{
+			float centroid = (&mItemMins[itemIndex].x)[splitAxis] + (&mItemMaxs[itemIndex].x)[splitAxis];
+			return std::min((uint32_t)((centroid - axisMin) * binScale), binCount - 1);
+		};
+
+		uint32_t          binItemCounts[BinCount] = {0};
+		DirectX::XMVECTOR binBoundsMin[BinCount];
+		DirectX::XMVECTOR binBoundsMax[BinCount];
+		for(uint32_t binIndex = 0; binIndex < binCount; binIndex++)
+		{
+			binBoundsMin[binIndex] = DirectX::XMVectorReplicate(std::numeric_limits<float>::max());
+			binBoundsMax[binIndex] = DirectX::XMVectorReplicate(-std::numeric_limits<float>::max());
+		}
+
+		for(uint32_t itemOrderIndex = itemBegin; itemOrderIndex < itemEnd; itemOrderIndex++)
+		{
+			uint32_t itemIndex = mItemOrder[itemOrderIndex];
+			uint32_t binIndex  = calculateBinIndex(itemIndex);
+
+			binItemCounts[binIndex]++;
+			binBoundsMin[binIndex] = DirectX::XMVectorMin(binBoundsMin[binIndex], DirectX::XMLoadFloat3(&mItemMins[itemIndex]));
+			binBoundsMax[binIndex] = DirectX::XMVectorMax(binBoundsMax[binIndex], DirectX::XMLoadFloat3(&mItemMaxs[itemIndex]));
+		}
+
+		//The cost of splitting after each bin is the item count times the surface area on both sides
+		float    rightCosts[BinCount];
+		uint32_t rightItemCount = 0;
+
+		DirectX::XMVECTOR rightBoundsMin = binBoundsMin[binCount - 1];
+		DirectX::XMVECTOR rightBoundsMax = binBoundsMax[binCount - 1];
+		for(uint32_t binIndex = binCount - 1; binIndex > 0; binIndex--)
+		{
+			rightItemCount += binItemCounts[binIndex];
+			rightBoundsMin  = DirectX::XMVectorMin(rightBoundsMin, binBoundsMin[binIndex]);
+			rightBoundsMax  = DirectX::XMVectorMax(rightBoundsMax, binBoundsMax[binIndex]);
+
+			rightCosts[binIndex] = (float)rightItemCount * CalculateSurfaceArea(rightBoundsMin, rightBoundsMax);
+		}
+
+		uint32_t bestSplitBin  = 0;
+		float    bestSplitCost = std::numeric_limits<float>::max();
+		uint32_t leftItemCount = 0;
+
+		DirectX::XMVECTOR leftBoundsMin = binBoundsMin[0];
+		DirectX::XMVECTOR leftBoundsMax = binBoundsMax[0];
+		for(uint32_t binIndex = 0; binIndex < binCount - 1; binIndex++)
+		{
+			leftItemCount += binItemCounts[binIndex];
+			leftBoundsMin  = DirectX::XMVectorMin(leftBoundsMin, binBoundsMin[binIndex]);
+			leftBoundsMax  = DirectX::XMVectorMax(leftBoundsMax, binBoundsMax[binIndex]);
+			if(leftItemCount == 0 || leftItemCount == itemCount)
+			{
+				continue;
+			}
+
+			float splitCost = (float)leftItemCount * CalculateSurfaceArea(leftBoundsMin, leftBoundsMax) + rightCosts[binIndex + 1];
+			if(splitCost < bestSplitCost)
+			{
+				bestSplitCost = splitCost;
+				bestSplitBin  = binIndex;
+			}
+		}
+
+		//Small nodes stay leaves if no split is cheaper than testing all items. Visiting the two children costs about as much as testing an item
+		float nodeArea = CalculateSurfaceArea(boundsMin, boundsMax);
+		float leafCost = (float)itemCount * nodeArea;
+		if(itemCount <= MaxLeafItemCount && bestSplitCost + nodeArea >= leafCost)
+		{
+			return;
+		}
+
+		if(bestSplitCost < std::numeric_limits<float>::max())
+		{
+			auto splitIt = std::partition(mItemOrder.begin() + itemBegin, mItemOrder.begin() + itemEnd, [&calculateBinIndex, bestSplitBin](uint32_t itemIndex)
+			{
+				return calculateBinIndex(itemIndex) <= bestSplitBin;
+			});
+
+			splitOrderIndex = (uint32_t)(splitIt - mItemOrder.begin());
+		}
+	}
+	else if(itemCount <= MaxLeafItemCount)
+	{
+		return;
+	}
+
+	//The node reference is invalidated by the push_back
+	uint32_t leftChildIndex = (uint32_t)nodes.size();
+	nodes[nodeIndex].FirstChildOrItem = leftChildIndex;
+	nodes[nodeIndex].ItemCount        = 0;
+
+	nodes.push_back(Node());
+	nodes.push_back(Node());
+
+	BuildNode(nodes, leftChildIndex,     depth + 1, itemBegin,       splitOrderIndex, outDeferredSubtrees);
+	BuildNode(nodes, leftChildIndex + 1, depth + 1, splitOrderIndex, itemEnd,         outDeferredSubtrees);
+}
+
+void BoundingVolumeHierarchy::BuildDeferredSubtrees(std::span<const DeferredSubtree> deferredSubtrees, ThreadPool* threadPool)
+{
+	//Each subtree is built into its own array, with its root at index 0. The item ranges don't overlap, so the jobs can reorder them in place
+	std::vector<std::vector<Node>> subtreeNodes(deferredSubtrees.size());
+
+	//Same as in the frame graph traversal: the main thread takes the last subtree and then waits for the others
+	uint32_t jobCount = (uint32_t)deferredSubtrees.size();
+
+	std::latch buildLatch(jobCount - 1);
+	for(uint32_t jobIndex = 0; jobIndex < jobCount - 1; jobIndex++)
+	{
+		struct JobData
+		{
+			BoundingVolumeHierarchy* Hierarchy;
+			std::vector<Node>*       OutNodes;
+			const DeferredSubtree*   Subtree;
+			std::latch*              Waitable;
+		}
+		jobData =
+		{
+			.Hierarchy = this,
+			.OutNodes  = &subtreeNodes[jobIndex],
+			.Subtree   = &deferredSubtrees[jobIndex],
+			.Waitable  = &buildLatch
+		};
+
+		auto buildJob = [](void* userData, [[maybe_unused]] uint32_t userDataSize)
+		{
+			JobData* threadJobData = reinterpret_cast<JobData*>(userData);
+
+			threadJobData->Hierarchy->BuildSubtree(*threadJobData->Subtree, *threadJobData->OutNodes);
+			threadJobData->Waitable->count_down();
+		};
+
+		threadPool->EnqueueWork(buildJob, &jobData, sizeof(JobData));
+	}
+
+	BuildSubtree(deferredSubtrees[jobCount - 1], subtreeNodes[jobCount - 1]);
+	buildLatch.wait();
+
+	//The subtree root replaces the placeholder node, the rest is appended. The child indices move along
+	for(uint32_t subtreeIndex = 0; subtreeIndex < jobCount; subtreeIndex++)
+	{
+		const std::vector<Node>& localNodes = subtreeNodes[subtreeIndex];
+
+		uint32_t appendedNodeOffset = (uint32_t)mNodes.size() - 1;
+		auto relocateNode = [appendedNodeOffset](Node node)
+		{
+			if(node.ItemCount == 0)
+			{
+				node.FirstChildOrItem += appendedNodeOffset;
+			}
+
+			return node;
+		};
+
+		mNodes[deferredSubtrees[subtreeIndex].NodeIndex] = relocateNode(localNodes[0]);
+		for(size_t localNodeIndex = 1; localNodeIndex < localNodes.size(); localNodeIndex++)
+		{
+			mNodes.push_back(relocateNode(localNodes[localNodeIndex]));
+		}
+	}
+}
+
+void BoundingVolumeHierarchy::BuildSubtree(const DeferredSubtree& subtree, std::vector<Node>& outNodes)
+{
+	outNodes.reserve(2 * (subtree.ItemEnd - subtree.ItemBegin));
+	outNodes.push_back(Node());
+
+	BuildNode(outNodes, 0, subtree.Depth, subtree.ItemBegin, subtree.ItemEnd, nullptr);
+}
+
+void BoundingVolumeHierarchy::FinalizeBuild()
+{
+	mNodeParents.assign(mNodes.size(), InvalidIndex);
+	mNodeDirtyFlags.assign(mNodes.size(), 0);
+	mItemLeafNodes.assign(mItemMins.size(), InvalidIndex);
+
+	mItemOrderIndices.resize(mItemOrder.size());
+	for(uint32_t itemOrderIndex = 0; itemOrderIndex < (uint32_t)mItemOrder.size(); itemOrderIndex++)
+	{
+		mItemOrderIndices[mItemOrder[itemOrderIndex]] = itemOrderIndex;
+	}
+
+	size_t paddedItemCount = mItemOrder.size() + 3;
+	mOrderedItemCentersX.assign(paddedItemCount, 0.0f);
+	mOrderedItemCentersY.assign(paddedItemCount, 0.0f);
+	mOrderedItemCentersZ.assign(paddedItemCount, 0.0f);
+	mOrderedItemExtentsX.assign(paddedItemCount, 0.0f);
+	mOrderedItemExtentsY.assign(paddedItemCount, 0.0f);
+	mOrderedItemExtentsZ.assign(paddedItemCount, 0.0f);
+	for(uint32_t itemOrderIndex = 0; itemOrderIndex < (uint32_t)mItemOrder.size(); itemOrderIndex++)
+	{
+		UpdateOrderedItemBounds(itemOrderIndex);
+	}
+
+	mInnerNodeAreaSum = 0.0f;
+	for(uint32_t nodeIndex = 0; nodeIndex < (uint32_t)mNodes.size(); nodeIndex++)
+	{
+		const Node& node = mNodes[nodeIndex];
+		if(node.ItemCount == 0)
+		{
+			mNodeParents[node.FirstChildOrItem]     = nodeIndex;
+			mNodeParents[node.FirstChildOrItem + 1] = nodeIndex;
+
+			mInnerNodeAreaSum += CalculateNodeArea(node);
+		}
+		else
+		{
+			for(uint32_t itemOrderIndex = node.FirstChildOrItem; itemOrderIndex < node.FirstChildOrItem + node.ItemCount; itemOrderIndex++)
+			{
+				mItemLeafNodes[mItemOrder[itemOrderIndex]] = nodeIndex;
+			}
+		}
+	}
+
+	mBuiltCost = 0.0f;
+	if(!mNodes.empty() && CalculateNodeArea(mNodes[0]) > 0.0f)
+	{
+		mBuiltCost = mInnerNodeAreaSum / CalculateNodeArea(mNodes[0]);
+	}
+}
+
+void BoundingVolumeHierarchy::ComputeNodeBounds(Node& node) const
+{
+	DirectX::XMVECTOR boundsMin;
+	DirectX::XMVECTOR boundsMax;
+	if(node.ItemCount == 0)
+	{
+		const Node& leftChild  = mNodes[node.FirstChildOrItem];
+		const Node& rightChild = mNodes[node.FirstChildOrItem + 1];
+
+		boundsMin = DirectX::XMVectorMin(DirectX::XMLoadFloat3(&leftChild.BoundsMin), DirectX::XMLoadFloat3(&rightChild.BoundsMin));
+		boundsMax = DirectX::XMVectorMax(DirectX::XMLoadFloat3(&leftChild.BoundsMax), DirectX::XMLoadFloat3(&rightChild.BoundsMax));
+	}
+	else
+	{
+		boundsMin = DirectX::XMLoadFloat3(&mItemMins[mItemOrder[node.FirstChildOrItem]]);
+		boundsMax = DirectX::XMLoadFloat3(&mItemMaxs[mItemOrder[node.FirstChildOrItem]]);
+		for(uint32_t itemOrderIndex = node.FirstChildOrItem + 1; itemOrderIndex < node.FirstChildOrItem + node.ItemCount; itemOrderIndex++)
+		{
+			boundsMin = DirectX::XMVectorMin(boundsMin, DirectX::XMLoadFloat3(&mItemMins[mItemOrder[itemOrderIndex]]));
+			boundsMax = DirectX::XMVectorMax(boundsMax, DirectX::XMLoadFloat3(&mItemMaxs[mItemOrder[itemOrderIndex]]));
+		}
+	}
+
+	DirectX::XMStoreFloat3(&node.BoundsMin, boundsMin);
+	DirectX::XMStoreFloat3(&node.BoundsMax, boundsMax);
+}
+
+void BoundingVolumeHierarchy::UpdateOrderedItemBounds(uint32_t itemOrderIndex)
+{
+	uint32_t itemIndex = mItemOrder[itemOrderIndex];
+
+	DirectX::XMFLOAT3 itemMin = mItemMins[itemIndex];
+	DirectX::XMFLOAT3 itemMax = mItemMaxs[itemIndex];
+
+	mOrderedItemCentersX[itemOrderIndex] = (itemMin.x + itemMax.x) * 0.5f;
+	mOrderedItemCentersY[itemOrderIndex] = (itemMin.y + itemMax.y) * 0.5f;
+	mOrderedItemCentersZ[itemOrderIndex] = (itemMin.z + itemMax.z) * 0.5f;
+	mOrderedItemExtentsX[itemOrderIndex] = (itemMax.x - itemMin.x) * 0.5f;
+	mOrderedItemExtentsY[itemOrderIndex] = (itemMax.y - itemMin.y) * 0.5f;
+	mOrderedItemExtentsZ[itemOrderIndex] = (itemMax.z - itemMin.z) * 0.5f;
+}
+
+void BoundingVolumeHierarchy::SplatFrustumPlanes(std::span<const DirectX::XMFLOAT4> frustumPlanes, FrustumPlaneVectors& outPlaneVectors)
+{
+	outPlaneVectors.PlaneCount = (uint32_t)frustumPlanes.size();
+	for(uint32_t planeIndex = 0; planeIndex < outPlaneVectors.PlaneCount; planeIndex++)
+	{
+		DirectX::XMVECTOR plane    = DirectX::XMLoadFloat4(&frustumPlanes[planeIndex]);
+		DirectX::XMVECTOR absPlane = DirectX::XMVectorAbs(plane);
+
+		outPlaneVectors.X[planeIndex] = DirectX::XMVectorSplatX(plane);
+		outPlaneVectors.Y[planeIndex] = DirectX::XMVectorSplatY(plane);
+		outPlaneVectors.Z[planeIndex] = DirectX::XMVectorSplatZ(plane);
+		outPlaneVectors.W[planeIndex] = DirectX::XMVectorSplatW(plane);
+
+		outPlaneVectors.AbsX[planeIndex] = DirectX::XMVectorSplatX(absPlane);
+		outPlaneVectors.AbsY[planeIndex] = DirectX::XMVectorSplatY(absPlane);
+		outPlaneVectors.AbsZ[planeIndex] = DirectX::XMVectorSplatZ(absPlane);
+	}
+}
+
+void BoundingVolumeHierarchy::QueryFrustumSubtree(std::span<const DirectX::XMFLOAT4> frustumPlanes, const FrustumPlaneVectors& planeVectors, uint32_t rootNodeIndex, uint32_t rootPlaneMask, uint32_t splitDepth, std::vector<uint32_t>& outItems, std::vector<DeferredQuery>* outDeferredQueries) const
+{
+	uint32_t nodeStack[QueryStackSize];
+	uint32_t planeMaskStack[QueryStackSize];
+	uint32_t depthStack[QueryStackSize];
+	uint32_t stackSize = 0;
+
+	nodeStack[stackSize]      = rootNodeIndex;
+	planeMaskStack[stackSize] = rootPlaneMask;
+	depthStack[stackSize]     = 0;
+	stackSize++;
+
+	while(stackSize > 0)
+	{
+		stackSize--;
+
+		uint32_t    nodeIndex = nodeStack[stackSize];
+		uint32_t    planeMask = planeMaskStack[stackSize];
+		uint32_t    depth     = depthStack[stackSize];
+		const Node& node      = mNodes[nodeIndex];
+		if(!TestBoxAgainstFrustum(frustumPlanes, node.BoundsMin, node.BoundsMax, planeMask))
+		{
+			continue;
+		}
+
+		if(planeMask == 0 || node.ItemCount == 1)
+		{
+			AppendSubtreeItems(nodeIndex, outItems);
+		}
+		else if(node.ItemCount != 0)
+		{
+			QueryFrustumItemRange(planeVectors, planeMask, node.FirstChildOrItem, node.FirstChildOrItem + node.ItemCount, outItems);
+		}
+		else if(outDeferredQueries != nullptr && depth == splitDepth)
+		{
+			outDeferredQueries->push_back(DeferredQuery
+			{
+				.NodeIndex = nodeIndex,
+				.PlaneMask = planeMask
+			});
+		}
+		else
+		{
+			assert(stackSize + 2 <= std::size(nodeStack));
+
+			nodeStack[stackSize]      = node.FirstChildOrItem + 1;
+			planeMaskStack[stackSize] = planeMask;
+			depthStack[stackSize]     = depth + 1;
+			stackSize++;
+
+			nodeStack[stackSize]      = node.FirstChildOrItem;
+			planeMaskStack[stackSize] = planeMask;
+			depthStack[stackSize]     = depth + 1;
+			stackSize++;
+		}
+	}
+}
+
+void BoundingVolumeHierarchy::QueryDeferredSubtrees(std::span<const DirectX::XMFLOAT4> frustumPlanes, const FrustumPlaneVectors& planeVectors, std::span<const DeferredQuery> deferredQueries, ThreadPool* threadPool, std::vector<uint32_t>& outItems) const
+{
+	//Each job takes every jobCount-th subtree and appends to its own array. The subtrees are small, so the jobs even out.
+	//Same as in the frame graph traversal: the main thread takes the last job and then waits for the others
+	uint32_t jobCount = std::min(threadPool->GetWorkerThreadCount() + 1, (uint32_t)deferredQueries.size());
+	std::vector<std::vector<uint32_t>> jobItems(jobCount);
+
+	auto querySubtrees = [this, frustumPlanes, &planeVectors, deferredQueries, jobCount](uint32_t jobIndex, std::vector<uint32_t>& outJobItems)
+	{
+		for(size_t queryIndex = jobIndex; queryIndex < deferredQueries.size(); queryIndex += jobCount)
+		{
+			QueryFrustumSubtree(frustumPlanes, planeVectors, deferredQueries[queryIndex].NodeIndex, deferredQueries[queryIndex].PlaneMask, 0, outJobItems, nullptr);
+		}
+	};
+
+	std::latch queryLatch(jobCount - 1);
+	for(uint32_t jobIndex = 0; jobIndex < jobCount - 1; jobIndex++)
+	{
+		struct JobData
+		{
+			decltype(querySubtrees)* QueryFunc;
+			std::vector<uint32_t>*   OutItems;
+			std::latch*              Waitable;
+			uint32_t                 JobIndex;
+		}
+		jobData =
+		{
+			.QueryFunc = &querySubtrees,
+			.OutItems  = &jobItems[jobIndex],
+			.Waitable  = &queryLatch,
+			.JobIndex  = jobIndex
+		};
+
+		auto queryJob = [](void* userData, [[maybe_unused]] uint32_t userDataSize)
+		{
+			JobData* threadJobData = reinterpret_cast<JobData*>(userData);
+
+			(*threadJobData->QueryFunc)(threadJobData->JobIndex, *threadJobData->OutItems);
+			threadJobData->Waitable->count_down();
+		};
+
+		threadPool->EnqueueWork(queryJob, &jobData, sizeof(JobData));
+	}
+
+	querySubtrees(jobCount - 1, jobItems[jobCount - 1]);
+	queryLatch.wait();
+
+	for(const std::vector<uint32_t>& items: jobItems)
+	{
+		outItems.insert(outItems.end(), items.begin(), items.end());
+	}
+}
+
+void BoundingVolumeHierarchy::QueryFrustumItemRange(const FrustumPlaneVectors& planeVectors, uint32_t planeMask, uint32_t itemOrderBegin, uint32_t itemOrderEnd, std::vector<uint32_t>& outItems) const
+{
+	//Room for all items of the range, trimmed to the ones that pass afterwards
+	size_t outItemCount = outItems.size();
+	outItems.resize(outItemCount + (itemOrderEnd - itemOrderBegin));
+
+	for(uint32_t firstItemOrderIndex = itemOrderBegin; firstItemOrderIndex < itemOrderEnd; firstItemOrderIndex += 4)
+	{
+		DirectX::XMVECTOR centersX = DirectX::XMLoadFloat4(reinterpret_cast<const DirectX::XMFLOAT4*>(&mOrderedItemCentersX[firstItemOrderIndex]));
+		DirectX::XMVECTOR centersY = DirectX::XMLoadFloat4(reinterpret_cast<const DirectX::XMFLOAT4*>(&mOrderedItemCentersY[firstItemOrderIndex]));
+		DirectX::XMVECTOR centersZ = DirectX::XMLoadFloat4(reinterpret_cast<const DirectX::XMFLOAT4*>(&mOrderedItemCentersZ[firstItemOrderIndex]));
+		DirectX::XMVECTOR extentsX = DirectX::XMLoadFloat4(reinterpret_cast<const DirectX::XMFLOAT4*>(&mOrderedItemExtentsX[firstItemOrderIndex]));
+		DirectX::XMVECTOR extentsY = DirectX::XMLoadFloat4(reinterpret_cast<const DirectX::XMFLOAT4*>(&mOrderedItemExtentsY[firstItemOrderIndex]));
+		DirectX::XMVECTOR extentsZ = DirectX::XMLoadFloat4(reinterpret_cast<const DirectX::XMFLOAT4*>(&mOrderedItemExtentsZ[firstItemOrderIndex]));
+
+		//Same test as in TestBoxAgainstFrustum, for 4 boxes at once
+		DirectX::XMVECTOR insideMask = DirectX::XMVectorTrueInt();
+		for(uint32_t planeIndex = 0; planeIndex < planeVectors.PlaneCount; planeIndex++)
+		{
+			if((planeMask & (1u << planeIndex)) == 0)
+			{
+				continue;
+			}
+
+			DirectX::XMVECTOR centerDistances = planeVectors.W[planeIndex];
+			centerDistances = DirectX::XMVectorMultiplyAdd(centersX, planeVectors.X[planeIndex], centerDistances);
+			centerDistances = DirectX::XMVectorMultiplyAdd(centersY, planeVectors.Y[planeIndex], centerDistances);
+			centerDistances = DirectX::XMVectorMultiplyAdd(centersZ, planeVectors.Z[planeIndex], centerDistances);
+
+			DirectX::XMVECTOR projectedExtents = DirectX::XMVectorMultiply(extentsX, planeVectors.AbsX[planeIndex]);
+			projectedExtents = DirectX::XMVectorMultiplyAdd(extentsY, planeVectors.AbsY[planeIndex], projectedExtents);
+			projectedExtents = DirectX::XMVectorMultiplyAdd(extentsZ, planeVectors.AbsZ[planeIndex], projectedExtents);
+
+			insideMask = DirectX::XMVectorAndInt(insideMask, DirectX::XMVectorGreaterOrEqual(DirectX::XMVectorAdd(centerDistances, projectedExtents), DirectX::XMVectorZero()));
+		}
+
+		//Branchless compaction, same as in FrustumCuller. The lanes past the range end are the next items or the padding, they are skipped
+		uint32_t insideLanes[4];
+		DirectX::XMStoreInt4(insideLanes, insideMask);
+
+		uint32_t laneCount = std::min(itemOrderEnd - firstItemOrderIndex, 4u);
+		for(uint32_t laneIndex = 0; laneIndex < laneCount; laneIndex++)
+		{
+			outItems[outItemCount] = mItemOrder[firstItemOrderIndex + laneIndex];
+			outItemCount += insideLanes[laneIndex] & 1;
+		}
+	}
+
+	outItems.resize(outItemCount);
+}
+
+void BoundingVolumeHierarchy::AppendSubtreeItems(uint32_t nodeIndex, std::vector<uint32_t>& outItems) const
+{
+	//The items of a subtree are contiguous in mItemOrder, from the leftmost leaf to the rightmost one
+	uint32_t leftmostNodeIndex = nodeIndex;
+	while(mNodes[leftmostNodeIndex].ItemCount == 0)
+	{
+		leftmostNodeIndex = mNodes[leftmostNodeIndex].FirstChildOrItem;
+	}
+
+	uint32_t rightmostNodeIndex = nodeIndex;
+	while(mNodes[rightmostNodeIndex].ItemCount == 0)
+	{
+		rightmostNodeIndex = mNodes[rightmostNodeIndex].FirstChildOrItem + 1;
+	}
+
+	auto subtreeItemsBegin = mItemOrder.begin() + mNodes[leftmostNodeIndex].FirstChildOrItem;
+	auto subtreeItemsEnd   = mItemOrder.begin() + mNodes[rightmostNodeIndex].FirstChildOrItem + mNodes[rightmostNodeIndex].ItemCount;
+	outItems.insert(outItems.end(), subtreeItemsBegin, subtreeItemsEnd);
+}
+
+float BoundingVolumeHierarchy::CalculateNodeArea(const Node& node) const
+{
+	return CalculateSurfaceArea(DirectX::XMLoadFloat3(&node.BoundsMin), DirectX::XMLoadFloat3(&node.BoundsMax));
+}
\ No newline at end of file
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <span>
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+
+class ThreadPool;
+
+//Bounding volume hierarchy over axis-aligned boxes, built with the binned surface area heuristic.
+//The items are referred to by their indices in the bounds array passed to Build().
+//Moving the items only refits the boxes on the way to the root. The tree quality degrades with that, the owner decides when to rebuild it
+class BoundingVolumeHierarchy
+{
+	static constexpr uint32_t MaxLeafItemCount        = 4;
+	static constexpr uint32_t BinCount                = 16;
+	static constexpr uint32_t MaxSahDepth             = 48;    //Deeper nodes are split at the median
+	static constexpr uint32_t QueryStackSize          = 96;    //Enough for MaxSahDepth levels and 2^48 more items split at the median
+	static constexpr uint32_t MinParallelSubtreeItems = 1024;  //Smaller subtrees are not worth a separate job
+	static constexpr uint32_t MaxParallelSubtreeItems = 16384; //Bigger subtrees are split on the calling thread first
+	static constexpr uint32_t MaxFrustumPlaneCount    = 31;    //The plane masks are 32-bit
+	static constexpr uint32_t InvalidIndex            = (uint32_t)(-1);
+
+	struct Node
+	{
+		DirectX::XMFLOAT3 BoundsMin;
+		uint32_t          FirstChildOrItem; //The left child for inner nodes, the right child follows it. The first index in mItemOrder for leaves
+		DirectX::XMFLOAT3 BoundsMax;
+		uint32_t          ItemCount;        //0 for inner nodes
+	};
+
+	struct DeferredSubtree
+	{
+		uint32_t NodeIndex;
+		uint32_t Depth;
+		uint32_t ItemBegin;
+		uint32_t ItemEnd;
+	};
+
+	struct DeferredQuery
+	{
+		uint32_t NodeIndex;
+		uint32_t PlaneMask; //The planes the subtree root isn't entirely in front of
+	};
+
+	//Each plane component splatted to a whole register, to test 4 item boxes at a time
+	struct FrustumPlaneVectors
+	{
+		uint32_t PlaneCount;
+
+		DirectX::XMVECTOR X[MaxFrustumPlaneCount];
+		DirectX::XMVECTOR Y[MaxFrustumPlaneCount];
+		DirectX::XMVECTOR Z[MaxFrustumPlaneCount];
+		DirectX::XMVECTOR W[MaxFrustumPlaneCount];
+
+		DirectX::XMVECTOR AbsX[MaxFrustumPlaneCount];
+		DirectX::XMVECTOR AbsY[MaxFrustumPlaneCount];
+		DirectX::XMVECTOR AbsZ[MaxFrustumPlaneCount];
+	};
+
+public:
+	BoundingVolumeHierarchy();
+	~BoundingVolumeHierarchy();
+
+	//Builds the tree from scratch. Big trees are built in parallel on the thread pool workers, threadPool can be nullptr
+	void Build(std::span<const DirectX::BoundingBox> itemBounds, ThreadPool* threadPool);
+
+	//Builds the tree from scratch over the current item bounds
+	void Rebuild(ThreadPool* threadPool);
+
+	void Clear();
+
+	//The boxes of the item's ancestors are updated on the next Refit() call
+	void UpdateItemBounds(uint32_t itemIndex, const DirectX::BoundingBox& bounds);
+	void Refit();
+
+	//The surface area heuristic cost of the tree relative to the cost right after the last build. 1.0 for a freshly built tree
+	float GetQualityDegradation() const;
+
+	//The queries append the indices of the items whose boxes pass the test to outItems, in no particular order.
+	//The frustum planes point inside and are normalized. The frustum query of a big tree is split between the thread pool workers, threadPool can be nullptr
+	void QueryFrustum(std::span<const DirectX::XMFLOAT4> frustumPlanes, std::vector<uint32_t>& outItems, ThreadPool* threadPool) const;
+	void QuerySphere(const DirectX::BoundingSphere& sphere, std::vector<uint32_t>& outItems)                                      const;
+	void QueryRay(DirectX::FXMVECTOR origin, DirectX::FXMVECTOR direction, float maxDistance, std::vector<uint32_t>& outItems)       const;
+
+	DirectX::BoundingBox GetItemBounds(uint32_t itemIndex) const;
+
+	uint32_t GetItemCount() const;
+	uint32_t GetNodeCount() const;
+
+private:
+	//Fills nodes[nodeIndex] and creates its subtree in nodes. If outDeferredSubtrees is not nullptr, the subtrees of suitable size are left to be built later
+	void BuildNode(std::vector<Node>& nodes, uint32_t nodeIndex, uint32_t depth, uint32_t itemBegin, uint32_t itemEnd, std::vector<DeferredSubtree>* outDeferredSubtrees);
+
+	//Builds the deferred subtrees as thread pool jobs and puts them in place of their placeholder nodes
+	void BuildDeferredSubtrees(std::span<const DeferredSubtree> deferredSubtrees, ThreadPool* threadPool);
+	void BuildSubtree(const DeferredSubtree& subtree, std::vector<Node>& outNodes);
+
+	//Recomputes parent links, leaf indices of the items and the cost after the nodes are built
+	void FinalizeBuild();
+
+	//Copies the item bounds to the item order arrays
+	void UpdateOrderedItemBounds(uint32_t itemOrderIndex);
+
+	static void SplatFrustumPlanes(std::span<const DirectX::XMFLOAT4> frustumPlanes, FrustumPlaneVectors& outPlaneVectors);
+
+	//Queries the subtree of rootNodeIndex, testing only the planes in rootPlaneMask. If outDeferredQueries is not nullptr, the subtrees at splitDepth are left to be queried later
+	void QueryFrustumSubtree(std::span<const DirectX::XMFLOAT4> frustumPlanes, const FrustumPlaneVectors& planeVectors, uint32_t rootNodeIndex, uint32_t rootPlaneMask, uint32_t splitDepth, std::vector<uint32_t>& outItems, std::vector<DeferredQuery>* outDeferredQueries) const;
+
+	//Queries the deferred subtrees as thread pool jobs and appends their items to outItems
+	void QueryDeferredSubtrees(std::span<const DirectX::XMFLOAT4> frustumPlanes, const FrustumPlaneVectors& planeVectors, std::span<const DeferredQuery> deferredQueries, ThreadPool* threadPool, std::vector<uint32_t>& outItems) const;
+
+	//Tests the items in mItemOrder from itemOrderBegin to itemOrderEnd against the planes in planeMask, 4 at a time
+	void QueryFrustumItemRange(const FrustumPlaneVectors& planeVectors, uint32_t planeMask, uint32_t itemOrderBegin, uint32_t itemOrderEnd, std::vector<uint32_t>& outItems) const;
+
+	void ComputeNodeBounds(Node& node) const;
+	void AppendSubtreeItems(uint32_t nodeIndex, std::vector<uint32_t>& outItems) const;
+
+	float CalculateNodeArea(const Node& node) const;
+
+private:
+	std::vector<Node> mNodes;
+
+	std::vector<DirectX::XMFLOAT3> mItemMins;
+	std::vector<DirectX::XMFLOAT3> mItemMaxs;
+	std::vector<uint32_t>          mItemOrder;        //The leaves refer to the ranges of this array
+	std::vector<uint32_t>          mItemOrderIndices; //The index of each item in mItemOrder
+	std::vector<uint32_t>          mItemLeafNodes;
+
+	//The item boxes in mItemOrder order, each coordinate in its own array like the spheres of FrustumCuller. The leaves load their items with single loads.
+	//Padded with 3 more boxes, so the last leaf can load 4 of them too
+	std::vector<float> mOrderedItemCentersX;
+	std::vector<float> mOrderedItemCentersY;
+	std::vector<float> mOrderedItemCentersZ;
+	std::vector<float> mOrderedItemExtentsX;
+	std::vector<float> mOrderedItemExtentsY;
+	std::vector<float> mOrderedItemExtentsZ;
+
+	std::vector<uint32_t> mNodeParents;
+	std::vector<uint32_t> mDirtyNodes;
+	std::vector<uint8_t>  mNodeDirtyFlags;
+
+	//Sum of the inner node surface areas, the surface area heuristic cost without the leaf terms
+	float mInnerNodeAreaSum;
+	float mBuiltCost;
+};
\ No newline at end of file
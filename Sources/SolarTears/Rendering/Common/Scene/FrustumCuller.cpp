@@ -0,0 +1,188 @@
+#include "FrustumCuller.hpp"
+#include "../../../Core/ThreadPool.hpp"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <latch>
+#include <cassert>
+
+FrustumCuller::FrustumCuller(): mSphereCount(0), mVisibleCount(0)
+{
+	for(uint32_t planeIndex = 0; planeIndex < (uint32_t)FrustumPlane::Count; planeIndex++)
+	{
+		mFrustumPlanes[planeIndex] = DirectX::XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f);
+	}
+}
+
+FrustumCuller::~FrustumCuller()
+{
+}
+
+void FrustumCuller::Resize(uint32_t sphereCount)
+{
+	uint32_t paddedSphereCount = (sphereCount + 3) & ~3u;
+
+	//The padding spheres have infinitely negative radius, no plane distance passes the test against them
+	mCentersX.assign(paddedSphereCount, 0.0f);
+	mCentersY.assign(paddedSphereCount, 0.0f);
+	mCentersZ.assign(paddedSphereCount, 0.0f);
+	mRadii.assign(paddedSphereCount, -std::numeric_limits<float>::infinity());
+
+	mVisibleIndices.resize(paddedSphereCount);
+	std::iota(mVisibleIndices.begin(), mVisibleIndices.end(), 0);
+
+	mSphereCount  = sphereCount;
+	mVisibleCount = sphereCount;
+}
+
+void FrustumCuller::SetBoundingSphere(uint32_t sphereIndex, const DirectX::BoundingSphere& sphere)
+{
+	assert(sphereIndex < mSphereCount);
+
+	mCentersX[sphereIndex] = sphere.Center.x;
+	mCentersY[sphereIndex] = sphere.Center.y;
+	mCentersZ[sphereIndex] = sphere.Center.z;
+	mRadii[sphereIndex]    = sphere.Radius;
+}
+
+DirectX::BoundingSphere FrustumCuller::GetBoundingSphere(uint32_t sphereIndex) const
+{
+	assert(sphereIndex < mSphereCount);
+	return DirectX::BoundingSphere(DirectX::XMFLOAT3(mCentersX[sphereIndex], mCentersY[sphereIndex], mCentersZ[sphereIndex]), mRadii[sphereIndex]);
+}
+
+void FrustumCuller::ExtractFrustumPlanes(DirectX::FXMMATRIX viewProjMatrix, std::span<DirectX::XMFLOAT4, FrustumPlaneCount> outPlanes)
+{
+	//The planes are the sums and differences of the view-projection matrix columns, pointing inside.
+	//The depth range is [0, 1], so the near plane is the third column alone
+	DirectX::XMMATRIX columns = DirectX::XMMatrixTranspose(viewProjMatrix);
+
+	DirectX::XMStoreFloat4(&outPlanes[(uint32_t)FrustumPlane::Left],   DirectX::XMPlaneNormalize(DirectX::XMVectorAdd(columns.r[3], columns.r[0])));
+	DirectX::XMStoreFloat4(&outPlanes[(uint32_t)FrustumPlane::Right],  DirectX::XMPlaneNormalize(DirectX::XMVectorSubtract(columns.r[3], columns.r[0])));
+	DirectX::XMStoreFloat4(&outPlanes[(uint32_t)FrustumPlane::Bottom], DirectX::XMPlaneNormalize(DirectX::XMVectorAdd(columns.r[3], columns.r[1])));
+	DirectX::XMStoreFloat4(&outPlanes[(uint32_t)FrustumPlane::Top],    DirectX::XMPlaneNormalize(DirectX::XMVectorSubtract(columns.r[3], columns.r[1])));
+	DirectX::XMStoreFloat4(&outPlanes[(uint32_t)FrustumPlane::Near],   DirectX::XMPlaneNormalize(columns.r[2]));
+	DirectX::XMStoreFloat4(&outPlanes[(uint32_t)FrustumPlane::Far],    DirectX::XMPlaneNormalize(DirectX::XMVectorSubtract(columns.r[3], columns.r[2])));
+}
+
+void FrustumCuller::Cull(ThreadPool* threadPool, DirectX::FXMMATRIX viewProjMatrix)
+{
+	ExtractFrustumPlanes(viewProjMatrix, mFrustumPlanes);
+
+	uint32_t paddedSphereCount = (uint32_t)mRadii.size();
+	if(threadPool == nullptr || paddedSphereCount <= SpheresPerJob)
+	{
+		mVisibleCount = CullRange(0, paddedSphereCount);
+		return;
+	}
+
+	//Each job compacts its visible spheres to the beginning of its own range, the ranges are merged afterwards.
+	//Same as in the frame graph traversal: the main thread takes the last range and then waits for the others
+	uint32_t jobCount = (paddedSphereCount + SpheresPerJob - 1) / SpheresPerJob;
+	mJobVisibleCounts.resize(jobCount);
+
+	std::latch cullLatch(jobCount - 1);
+	for(uint32_t jobIndex = 0; jobIndex < jobCount - 1; jobIndex++)
+	{
+		struct JobData
+		{
+			const FrustumCuller* Culler;
+			std::latch*          Waitable;
+			uint32_t*            OutVisibleCount;
+			uint32_t             SphereBegin;
+			uint32_t             SphereEnd;
+		}
+		jobData =
+		{
+			.Culler          = this,
+			.Waitable        = &cullLatch,
+			.OutVisibleCount = &mJobVisibleCounts[jobIndex],
+			.SphereBegin     = jobIndex * SpheresPerJob,
+			.SphereEnd       = (jobIndex + 1) * SpheresPerJob
+		};
+
+		auto cullJob = [](void* userData, [[maybe_unused]] uint32_t userDataSize)
+		{
+			JobData* threadJobData = reinterpret_cast<JobData*>(userData);
+
+			*threadJobData->OutVisibleCount = threadJobData->Culler->CullRange(threadJobData->SphereBegin, threadJobData->SphereEnd);
+			threadJobData->Waitable->count_down();
+		};
+
+		threadPool->EnqueueWork(cullJob, &jobData, sizeof(JobData));
+	}
+
+	mJobVisibleCounts[jobCount - 1] = CullRange((jobCount - 1) * SpheresPerJob, paddedSphereCount);
+	cullLatch.wait();
+
+	//The destination never overtakes the source, copying forward is safe
+	mVisibleCount = mJobVisibleCounts[0];
+	for(uint32_t jobIndex = 1; jobIndex < jobCount; jobIndex++)
+	{
+		auto jobVisibleBegin = mVisibleIndices.begin() + (size_t)jobIndex * SpheresPerJob;
+		std::copy(jobVisibleBegin, jobVisibleBegin + mJobVisibleCounts[jobIndex], mVisibleIndices.begin() + mVisibleCount);
+
+		mVisibleCount += mJobVisibleCounts[jobIndex];
+	}
+}
+
+std::span<const uint32_t> FrustumCuller::GetVisibleIndices() const
+{
+	return {mVisibleIndices.begin(), mVisibleIndices.begin() + mVisibleCount};
+}
+
+uint32_t FrustumCuller::GetSphereCount() const
+{
+	return mSphereCount;
+}
+
+uint32_t FrustumCuller::CullRange(uint32_t sphereBegin, uint32_t sphereEnd) const
+{
+	assert(sphereBegin % 4 == 0 && sphereEnd % 4 == 0);
+
+	DirectX::XMVECTOR planesX[(uint32_t)FrustumPlane::Count];
+	DirectX::XMVECTOR planesY[(uint32_t)FrustumPlane::Count];
+	DirectX::XMVECTOR planesZ[(uint32_t)FrustumPlane::Count];
+	DirectX::XMVECTOR planesW[(uint32_t)FrustumPlane::Count];
+	for(uint32_t planeIndex = 0; planeIndex < (uint32_t)FrustumPlane::Count; planeIndex++)
+	{
+		DirectX::XMVECTOR plane = DirectX::XMLoadFloat4(&mFrustumPlanes[planeIndex]);
+
+		planesX[planeIndex] = DirectX::XMVectorSplatX(plane);
+		planesY[planeIndex] = DirectX::XMVectorSplatY(plane);
+		planesZ[planeIndex] = DirectX::XMVectorSplatZ(plane);
+		planesW[planeIndex] = DirectX::XMVectorSplatW(plane);
+	}
+
+	uint32_t visibleCount = 0;
+	for(uint32_t sphereIndex = sphereBegin; sphereIndex < sphereEnd; sphereIndex += 4)
+	{
+		DirectX::XMVECTOR centersX     = DirectX::XMLoadFloat4(reinterpret_cast<const DirectX::XMFLOAT4*>(&mCentersX[sphereIndex]));
+		DirectX::XMVECTOR centersY     = DirectX::XMLoadFloat4(reinterpret_cast<const DirectX::XMFLOAT4*>(&mCentersY[sphereIndex]));
+		DirectX::XMVECTOR centersZ     = DirectX::XMLoadFloat4(reinterpret_cast<const DirectX::XMFLOAT4*>(&mCentersZ[sphereIndex]));
+		DirectX::XMVECTOR negatedRadii = DirectX::XMVectorNegate(DirectX::XMLoadFloat4(reinterpret_cast<const DirectX::XMFLOAT4*>(&mRadii[sphereIndex])));
+
+		//A sphere is outside if it's entirely behind any of the planes
+		DirectX::XMVECTOR insideMask = DirectX::XMVectorTrueInt();
+		for(uint32_t planeIndex = 0; planeIndex < (uint32_t)FrustumPlane::Count; planeIndex++)
+		{
+			DirectX::XMVECTOR distances = planesW[planeIndex];
+			distances = DirectX::XMVectorMultiplyAdd(centersX, planesX[planeIndex], distances);
+			distances = DirectX::XMVectorMultiplyAdd(centersY, planesY[planeIndex], distances);
+			distances = DirectX::XMVectorMultiplyAdd(centersZ, planesZ[planeIndex], distances);
+
+			insideMask = DirectX::XMVectorAndInt(insideMask, DirectX::XMVectorGreaterOrEqual(distances, negatedRadii));
+		}
+
+		//Branchless compaction: the index is always written, but the write position only advances for the visible spheres
+		uint32_t insideLanes[4];
+		DirectX::XMStoreInt4(insideLanes, insideMask);
+		for(uint32_t laneIndex = 0; laneIndex < 4; laneIndex++)
+		{
+			mVisibleIndices[sphereBegin + visibleCount] = sphereIndex + laneIndex;
+			visibleCount += insideLanes[laneIndex] & 1;
+		}
+	}
+
+	return visibleCount;
+}
\ No newline at end of file
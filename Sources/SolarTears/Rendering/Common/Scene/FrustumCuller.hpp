@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <span>
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+
+class ThreadPool;
+
+//Tests bounding spheres against the view frustum, 4 spheres at a time.
+//The sphere components are stored in separate arrays, so each of them loads into one SIMD register
+class FrustumCuller
+{
+	static constexpr uint32_t SpheresPerJob = 8192; //Has to be a multiple of 4
+
+	enum class FrustumPlane: uint32_t
+	{
+		Left = 0,
+		Right,
+		Bottom,
+		Top,
+		Near,
+		Far,
+
+		Count
+	};
+
+public:
+	static constexpr uint32_t FrustumPlaneCount = (uint32_t)FrustumPlane::Count;
+
+	FrustumCuller();
+	~FrustumCuller();
+
+	//The planes of the frustum of viewProjMatrix, normalized and pointing inside
+	static void ExtractFrustumPlanes(DirectX::FXMMATRIX viewProjMatrix, std::span<DirectX::XMFLOAT4, FrustumPlaneCount> outPlanes);
+
+	//Resets the sphere count. All spheres are visible until the first Cull() call
+	void Resize(uint32_t sphereCount);
+
+	void                    SetBoundingSphere(uint32_t sphereIndex, const DirectX::BoundingSphere& sphere);
+	DirectX::BoundingSphere GetBoundingSphere(uint32_t sphereIndex) const;
+
+	//Finds the spheres intersecting the frustum of viewProjMatrix. Big sphere counts are split between the thread pool workers, threadPool can be nullptr
+	void Cull(ThreadPool* threadPool, DirectX::FXMMATRIX viewProjMatrix);
+
+	//The indices of the spheres that passed the last Cull() call, in increasing order
+	std::span<const uint32_t> GetVisibleIndices() const;
+
+	uint32_t GetSphereCount() const;
+
+private:
+	//Writes the indices of the visible spheres to mVisibleIndices, starting at sphereBegin. Returns the number of the visible spheres
+	uint32_t CullRange(uint32_t sphereBegin, uint32_t sphereEnd) const;
+
+private:
+	//Padded to a multiple of 4 with spheres that are never visible
+	std::vector<float> mCentersX;
+	std::vector<float> mCentersY;
+	std::vector<float> mCentersZ;
+	std::vector<float> mRadii;
+
+	DirectX::XMFLOAT4 mFrustumPlanes[(uint32_t)FrustumPlane::Count];
+
+	mutable std::vector<uint32_t> mVisibleIndices;
+	std::vector<uint32_t>         mJobVisibleCounts;
+
+	uint32_t mSphereCount;
+	uint32_t mVisibleCount;
+};
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include "MeshSimplifier.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+MeshSimplifier::MeshSimplifier(): mBoundsMin(0.0f, 0.0f, 0.0f), mBoundsSize(0.0f)
+{
+}
+
+MeshSimplifier::~MeshSimplifier()
+{
+}
+
+void MeshSimplifier::GenerateLods(std::span<const RenderableSceneVertex> vertices, std::span<const RenderableSceneIndex> indices, uint32_t maxLodCount, std::vector<std::vector<RenderableSceneIndex>>& outLodIndices)
+{
+	uint32_t triangleCount = (uint32_t)(indices.size() / 3);
+	if(maxLodCount < 2 || triangleCount * LodTriangleRatio < MinSimplifiedTriangleCount)
+	{
+		return;
+	}
+
+	//The unused vertices don't count for the grid
+	DirectX::XMVECTOR boundsMin = DirectX::XMVectorReplicate( std::numeric_limits<float>::max());
+	DirectX::XMVECTOR boundsMax = DirectX::XMVectorReplicate(-std::numeric_limits<float>::max());
+	for(RenderableSceneIndex index: indices)
+	{
+		DirectX::XMVECTOR position = DirectX::XMLoadFloat3(&vertices[index].Position);
+
+		boundsMin = DirectX::XMVectorMin(boundsMin, position);
+		boundsMax = DirectX::XMVectorMax(boundsMax, position);
+	}
+
+	DirectX::XMFLOAT3 boundsExtents;
+	DirectX::XMStoreFloat3(&boundsExtents, DirectX::XMVectorSubtract(boundsMax, boundsMin));
+	DirectX::XMStoreFloat3(&mBoundsMin, boundsMin);
+
+	mBoundsSize = std::max({boundsExtents.x, boundsExtents.y, boundsExtents.z});
+	if(mBoundsSize <= 0.0f)
+	{
+		return;
+	}
+
+	//The triangle count of a surface goes with the square of the grid resolution. Start a bit finer than the first level needs
+	uint32_t gridResolution    = std::max((uint32_t)(2.0f * std::sqrt((float)triangleCount)), 2u);
+	uint32_t prevTriangleCount  = triangleCount;
+
+	std::vector<RenderableSceneIndex> lodIndices;
+	for(uint32_t lodIndex = 1; lodIndex < maxLodCount; lodIndex++)
+	{
+		uint32_t targetTriangleCount = (uint32_t)(prevTriangleCount * LodTriangleRatio);
+		if(targetTriangleCount < MinSimplifiedTriangleCount)
+		{
+			break;
+		}
+
+		//The coarser levels are clustered from the original too, so the errors don't add up
+		bool targetReached = false;
+		while(gridResolution >= 2 && !targetReached)
+		{
+			ClusterVertices(vertices, indices, gridResolution, lodIndices);
+			targetReached = (lodIndices.size() / 3 <= targetTriangleCount);
+
+			gridResolution = gridResolution * 3 / 4;
+		}
+
+		uint32_t lodTriangleCount = (uint32_t)(lodIndices.size() / 3);
+		if(!targetReached || lodTriangleCount < MinSimplifiedTriangleCount)
+		{
+			break;
+		}
+
+		outLodIndices.push_back(lodIndices);
+		prevTriangleCount = lodTriangleCount;
+	}
+}
+
+void MeshSimplifier::ClusterVertices(std::span<const RenderableSceneVertex> vertices, std::span<const RenderableSceneIndex> indices, uint32_t gridResolution, std::vector<RenderableSceneIndex>& outIndices)
+{
+	mCellRepresentatives.clear();
+	mVertexRemap.assign(vertices.size(), (RenderableSceneIndex)(-1));
+
+	float cellScale = (float)gridResolution / mBoundsSize;
+	auto getCellCoordinate = [cellScale, gridResolution](float position, float boundsMin)
+	{
+		return (uint64_t)std::min((uint32_t)((position - boundsMin) * cellScale), gridResolution - 1);
+	};
+
+	//The vertices are visited in the index order, so the representatives don't depend on the unused vertices
+	for(RenderableSceneIndex index: indices)
+	{
+		if(mVertexRemap[index] != (RenderableSceneIndex)(-1))
+		{
+			continue;
+		}
+
+		const DirectX::XMFLOAT3& position = vertices[index].Position;
+
+		uint64_t cellX = getCellCoordinate(position.x, mBoundsMin.x);
+		uint64_t cellY = getCellCoordinate(position.y, mBoundsMin.y);
+		uint64_t cellZ = getCellCoordinate(position.z, mBoundsMin.z);
+
+		uint64_t cellKey = cellX | (cellY << 21) | (cellZ << 42);
+		mVertexRemap[index] = mCellRepresentatives.emplace(cellKey, index).first->second;
+	}
+
+	outIndices.clear();
+	for(size_t firstIndex = 0; firstIndex + 2 < indices.size(); firstIndex += 3)
+	{
+		RenderableSceneIndex index0 = mVertexRemap[indices[firstIndex + 0]];
+		RenderableSceneIndex index1 = mVertexRemap[indices[firstIndex + 1]];
+		RenderableSceneIndex index2 = mVertexRemap[indices[firstIndex + 2]];
+		if(index0 == index1 || index1 == index2 || index2 == index0)
+		{
+			continue;
+		}
+
+		outIndices.insert(outIndices.end(), {index0, index1, index2});
+	}
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <span>
+#include <unordered_map>
+#include "RenderableSceneMisc.hpp"
+
+//Generates the coarser levels of detail of a geometry by vertex clustering.
+//The vertices in each cell of a uniform grid are snapped to one of them, so the levels only need new indices and share the vertices of the original
+class MeshSimplifier
+{
+	static constexpr float    LodTriangleRatio           = 0.25f; //Each level has at most that many triangles of the previous one
+	static constexpr uint32_t MinSimplifiedTriangleCount = 16;    //Coarser levels would remove the last triangles that keep the shape
+
+public:
+	MeshSimplifier();
+	~MeshSimplifier();
+
+	//Appends up to maxLodCount - 1 levels after the original to outLodIndices. Stops early if the geometry can't be simplified any further
+	void GenerateLods(std::span<const RenderableSceneVertex> vertices, std::span<const RenderableSceneIndex> indices, uint32_t maxLodCount, std::vector<std::vector<RenderableSceneIndex>>& outLodIndices);
+
+private:
+	//Snaps each vertex to the first vertex of its grid cell and drops the collapsed triangles
+	void ClusterVertices(std::span<const RenderableSceneVertex> vertices, std::span<const RenderableSceneIndex> indices, uint32_t gridResolution, std::vector<RenderableSceneIndex>& outIndices);
+
+private:
+	DirectX::XMFLOAT3 mBoundsMin;
+	float             mBoundsSize;
+
+	std::unordered_map<uint64_t, RenderableSceneIndex> mCellRepresentatives;
+	std::vector<RenderableSceneIndex>                  mVertexRemap;
+};
\ No newline at end of file
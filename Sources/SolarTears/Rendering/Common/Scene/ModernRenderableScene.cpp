@@ -1,13 +1,79 @@
 #include "ModernRenderableScene.hpp"
 #include "../RenderingUtils.hpp"
 #include "../../../Core/FrameCounter.hpp"
+#include "../../../Core/ThreadPool.hpp"
+#include <algorithm>
+#include <numeric>
+#include <iterator>
+#include <latch>
+#include <cassert>
+
+namespace
+{
+	//Runs rangeFunc(rangeBegin, rangeEnd) for consecutive ranges of itemsPerJob items on the thread pool.
+	//Same as in the frustum culling: the main thread takes the last range and then waits for the others
+	template<typename RangeFunc>
+	void ForEachItemRange(ThreadPool* threadPool, uint32_t itemCount, uint32_t itemsPerJob, const RangeFunc& rangeFunc)
+	{
+		if(threadPool == nullptr || itemCount <= itemsPerJob)
+		{
+			rangeFunc(0, itemCount);
+			return;
+		}
+
+		uint32_t jobCount = (itemCount + itemsPerJob - 1) / itemsPerJob;
+
+		std::latch rangeLatch(jobCount - 1);
+		for(uint32_t jobIndex = 0; jobIndex < jobCount - 1; jobIndex++)
+		{
+			struct JobData
+			{
+				const RangeFunc* Func;
+				std::latch*      Waitable;
+				uint32_t         RangeBegin;
+				uint32_t         RangeEnd;
+			}
+			jobData =
+			{
+				.Func       = &rangeFunc,
+				.Waitable   = &rangeLatch,
+				.RangeBegin = jobIndex * itemsPerJob,
+				.RangeEnd   = (jobIndex + 1) * itemsPerJob
+			};
+
+			auto rangeJob = [](void* userData, [[maybe_unused]] uint32_t userDataSize)
+			{
+				JobData* threadJobData = reinterpret_cast<JobData*>(userData);
+
+				(*threadJobData->Func)(threadJobData->RangeBegin, threadJobData->RangeEnd);
+				threadJobData->Waitable->count_down();
+			};
+
+			threadPool->EnqueueWork(rangeJob, &jobData, sizeof(JobData));
+		}
+
+		rangeFunc((jobCount - 1) * itemsPerJob, itemCount);
+		rangeLatch.wait();
+	}
+}
 
 ModernRenderableScene::ModernRenderableScene(uint64_t constantDataAlignment)
 {
 	mSceneUploadDataBufferPointer = nullptr;
+	mBatchThreadPoolRef           = nullptr;
 
 	mMaterialDataSize     = 0;
+	mFrameDataSize        = 0;
 	mStaticObjectDataSize = 0;
+	mRigidObjectDataSize  = 0;
+
+	mVertexBufferCapacity   = 0;
+	mIndexBufferCapacity    = 0;
+	mConstantBufferCapacity = 0;
+	mUploadBufferCapacity   = 0;
+
+	mVertexDataSize = 0;
+	mIndexDataSize  = 0;
 
 	mObjectChunkDataSize   = (uint32_t)Utils::AlignMemory(sizeof(BaseRenderableScene::PerObjectData), constantDataAlignment);
 	mFrameChunkDataSize    = (uint32_t)Utils::AlignMemory(sizeof(BaseRenderableScene::PerFrameData),  constantDataAlignment);
@@ -24,6 +90,9 @@ void ModernRenderableScene::UpdateFrameData(const FrameDataUpdateInfo& frameUpda
 
 	DirectX::XMMATRIX projMatrix = DirectX::XMLoadFloat4x4(&frameUpdate.ProjMatrix);
 	PerFrameData perFrameData = PackFrameData(frameUpdate.CameraLocation, projMatrix);
+	mCullingViewProjMatrix = perFrameData.ViewProjMatrix;
+	mCullingCameraPosition = frameUpdate.CameraLocation.Position;
+	mCullingProjScale      = frameUpdate.ProjMatrix.m[1][1];
 
 	uint64_t frameDataOffset = GetUploadFrameDataOffset(frameResourceIndex);
 	memcpy((std::byte*)mSceneUploadDataBufferPointer + frameDataOffset, &perFrameData, sizeof(PerFrameData));
@@ -31,27 +100,102 @@ void ModernRenderableScene::UpdateFrameData(const FrameDataUpdateInfo& frameUpda
 
 void ModernRenderableScene::UpdateRigidSceneObjects(const std::span<ObjectDataUpdateInfo> rigidObjectUpdates, uint64_t frameNumber)
 {
+	if(mBatchObjectUpdates.empty())
+	{
+		ApplyRigidObjectUpdates(rigidObjectUpdates, mBatchThreadPoolRef, frameNumber);
+	}
+	else
+	{
+		auto objectIndexLess = [](const ObjectDataUpdateInfo& left, const ObjectDataUpdateInfo& right)
+		{
+			return GetRenderableObjectIndex(left.ObjectId) < GetRenderableObjectIndex(right.ObjectId);
+		};
+
+		//Both lists are sorted, the merged one is too. The objects updated twice are caught in ApplyRigidObjectUpdates()
+		mCombinedObjectUpdates.clear();
+		std::merge(rigidObjectUpdates.begin(), rigidObjectUpdates.end(), mBatchObjectUpdates.begin(), mBatchObjectUpdates.end(), std::back_inserter(mCombinedObjectUpdates), objectIndexLess);
+
+		ApplyRigidObjectUpdates(mCombinedObjectUpdates, mBatchThreadPoolRef, frameNumber);
+	}
+
+	mBatchObjectUpdates.clear();
+	mBatchThreadPoolRef = nullptr;
+}
+
+void ModernRenderableScene::UpdateRigidSceneObjectBatch(const ObjectDataUpdateBatch& objectUpdates, ThreadPool* threadPool)
+{
+	assert(mBatchObjectUpdates.empty());
+	assert(objectUpdates.Positions.size()           == objectUpdates.ObjectIds.size());
+	assert(objectUpdates.RotationQuaternions.size() == objectUpdates.ObjectIds.size());
+	assert(objectUpdates.Scales.size()              == objectUpdates.ObjectIds.size());
+
+	uint32_t updateCount = (uint32_t)objectUpdates.ObjectIds.size();
+
+	//The merge with the leftover updates needs the object order. Most systems produce it already, so the sorting is only done when needed
+	auto objectIndexLess = [&objectUpdates](uint32_t left, uint32_t right)
+	{
+		return GetRenderableObjectIndex(objectUpdates.ObjectIds[left]) < GetRenderableObjectIndex(objectUpdates.ObjectIds[right]);
+	};
+
+	auto handleIndexLess = [](RenderableSceneObjectHandle left, RenderableSceneObjectHandle right)
+	{
+		return GetRenderableObjectIndex(left) < GetRenderableObjectIndex(right);
+	};
+
+	mBatchUpdateOrder.clear();
+	if(!std::is_sorted(objectUpdates.ObjectIds.begin(), objectUpdates.ObjectIds.end(), handleIndexLess))
+	{
+		mBatchUpdateOrder.resize(updateCount);
+		std::iota(mBatchUpdateOrder.begin(), mBatchUpdateOrder.end(), 0);
+		std::sort(mBatchUpdateOrder.begin(), mBatchUpdateOrder.end(), objectIndexLess);
+	}
+
+	mBatchObjectUpdates.resize(updateCount);
+	ForEachItemRange(threadPool, updateCount, UpdatesPerJob, [this, &objectUpdates](uint32_t updateBegin, uint32_t updateEnd)
+	{
+		GatherBatchUpdateRange(objectUpdates, updateBegin, updateEnd);
+	});
+
+	mBatchThreadPoolRef = threadPool;
+}
+
+void ModernRenderableScene::ApplyRigidObjectUpdates(std::span<const ObjectDataUpdateInfo> rigidObjectUpdates, ThreadPool* threadPool, uint64_t frameNumber)
+{
+	//The merge below needs strictly increasing object indices, an object updated twice in the same frame would get two slots in the frame's updates
+	assert(std::adjacent_find(rigidObjectUpdates.begin(), rigidObjectUpdates.end(), [](const ObjectDataUpdateInfo& left, const ObjectDataUpdateInfo& right)
+	{
+		return GetRenderableObjectIndex(left.ObjectId) >= GetRenderableObjectIndex(right.ObjectId);
+	}) == rigidObjectUpdates.end());
+
+	RecycleRemovedObjectSlots(frameNumber);
+
+	//The objects added since the last frame need their initial object data uploaded
+	std::span<const ObjectDataUpdateInfo> objectUpdates = MergeAddedObjectUpdates(rigidObjectUpdates);
+	UpdateObjectBoundingSpheres(objectUpdates);
+
 	uint32_t prevFrameUpdateIndex = 0;
 	uint32_t currFrameUpdateIndex = 0;
 	uint32_t nextFrameUpdateIndex = 0;
 
 	uint32_t objectUpdateIndex = 0;
 
-	//Merge mPrevFrameMeshUpdates and rigidObjectUpdates into updates for the next frame and leftovers, keeping the result sorted
-	while(mPrevFrameRigidMeshUpdates[prevFrameUpdateIndex].MeshHandleIndex != (uint32_t)(-1) || objectUpdateIndex < rigidObjectUpdates.size())
+	//Merge mPrevFrameMeshUpdates and objectUpdates into updates for the next frame and leftovers, keeping the result sorted.
+	//Only the source of each update is recorded here, the object data is packed afterwards in parallel
+	while(mPrevFrameRigidMeshUpdates[prevFrameUpdateIndex].MeshHandleIndex != (uint32_t)(-1) || objectUpdateIndex < objectUpdates.size())
 	{
-		assert(rigidObjectUpdates[objectUpdateIndex].ObjectId > GetStaticObjectCount());
-
+		//Once the new updates run out, only the leftovers remain. (-1) sorts after any of them
 		uint32_t updatedObjectPrevFrameIndex = mPrevFrameRigidMeshUpdates[prevFrameUpdateIndex].MeshHandleIndex;
-		uint32_t updatedObjectToMergeIndex   = rigidObjectUpdates[objectUpdateIndex].ObjectId;
+		uint32_t updatedObjectToMergeIndex   = (objectUpdateIndex < objectUpdates.size()) ? GetRenderableObjectIndex(objectUpdates[objectUpdateIndex].ObjectId) : (uint32_t)(-1);
+
+		assert(updatedObjectToMergeIndex >= GetStaticObjectCount());
 
 		if(updatedObjectPrevFrameIndex < updatedObjectToMergeIndex)
 		{
-			uint32_t prevDataIndex = mPrevFrameRigidMeshUpdates[objectUpdateIndex].ObjectDataIndex;
+			uint32_t prevDataIndex = mPrevFrameRigidMeshUpdates[prevFrameUpdateIndex].ObjectDataIndex;
 
 			//Schedule 1 update for the current frame
 			mCurrFrameRigidMeshUpdateIndices[currFrameUpdateIndex] = updatedObjectPrevFrameIndex;
-			mCurrFrameDataToUpdate[currFrameUpdateIndex]           = mPrevFrameDataToUpdate[prevDataIndex];
+			mCurrFrameUpdateSources[currFrameUpdateIndex]          = prevDataIndex;
 
 			//The remaining updates of the same object go to the next frame
 			while(mPrevFrameRigidMeshUpdates[++prevFrameUpdateIndex].MeshHandleIndex == updatedObjectPrevFrameIndex)
@@ -69,7 +213,7 @@ void ModernRenderableScene::UpdateRigidSceneObjects(const std::span<ObjectDataUp
 		{
 			//Grab 1 update from objectUpdate into the current frame
 			mCurrFrameRigidMeshUpdateIndices[currFrameUpdateIndex] = updatedObjectToMergeIndex;
-			mCurrFrameDataToUpdate[currFrameUpdateIndex]           = PackObjectData(rigidObjectUpdates[objectUpdateIndex++].NewObjectLocation);
+			mCurrFrameUpdateSources[currFrameUpdateIndex]          = (objectUpdateIndex++) | NewUpdateSourceBit;
 
 			//Grab the same update for next (InFlightFrameCount - 1) frames
 			for(int i = 1; i < Utils::InFlightFrameCount; i++)
@@ -90,7 +234,7 @@ void ModernRenderableScene::UpdateRigidSceneObjects(const std::span<ObjectDataUp
 		{
 			//Grab 1 update from objectUpdate into the current frame
 			mCurrFrameRigidMeshUpdateIndices[currFrameUpdateIndex] = updatedObjectToMergeIndex;
-			mCurrFrameDataToUpdate[currFrameUpdateIndex]           = PackObjectData(rigidObjectUpdates[objectUpdateIndex++].NewObjectLocation);
+			mCurrFrameUpdateSources[currFrameUpdateIndex]          = (objectUpdateIndex++) | NewUpdateSourceBit;
 
 			//Grab the same update for next (InFlightFrameCount - 1) frames
 			for(int i = 1; i < Utils::InFlightFrameCount; i++)
@@ -112,17 +256,55 @@ void ModernRenderableScene::UpdateRigidSceneObjects(const std::span<ObjectDataUp
 	mCurrFrameUpdatedObjectCount = currFrameUpdateIndex;
 
 	uint32_t frameResourceIndex = frameNumber % Utils::InFlightFrameCount;
-	for(uint32_t updateIndex = 0; updateIndex < mCurrFrameUpdatedObjectCount; updateIndex++)
+	ForEachItemRange(threadPool, mCurrFrameUpdatedObjectCount, UpdatesPerJob, [this, objectUpdates, frameResourceIndex](uint32_t updateBegin, uint32_t updateEnd)
+	{
+		UploadRigidObjectUpdateRange(objectUpdates, frameResourceIndex, updateBegin, updateEnd);
+	});
+
+	std::swap(mPrevFrameDataToUpdate, mCurrFrameDataToUpdate);
+}
+
+void ModernRenderableScene::UploadRigidObjectUpdateRange(std::span<const ObjectDataUpdateInfo> objectUpdates, uint32_t frameResourceIndex, uint32_t updateBegin, uint32_t updateEnd)
+{
+	for(uint32_t updateIndex = updateBegin; updateIndex < updateEnd; updateIndex++)
 	{
+		uint32_t updateSource = mCurrFrameUpdateSources[updateIndex];
+		if(updateSource & NewUpdateSourceBit)
+		{
+			mCurrFrameDataToUpdate[updateIndex] = PackObjectData(objectUpdates[updateSource & ~NewUpdateSourceBit].NewObjectLocation);
+		}
+		else
+		{
+			mCurrFrameDataToUpdate[updateIndex] = mPrevFrameDataToUpdate[updateSource];
+		}
+
 		uint32_t meshIndex = mCurrFrameRigidMeshUpdateIndices[updateIndex];
 
-		uint64_t objectDataOffset = GetUploadRigidObjectDataOffset(frameResourceIndex, meshIndex) - GetStaticObjectCount();
+		uint64_t objectDataOffset = GetUploadRigidObjectDataOffset(frameResourceIndex, meshIndex - GetStaticObjectCount());
 		memcpy((std::byte*)mSceneUploadDataBufferPointer + objectDataOffset, &mCurrFrameDataToUpdate[updateIndex], sizeof(PerObjectData));
 	}
+}
 
-	std::swap(mPrevFrameDataToUpdate, mCurrFrameDataToUpdate);
+void ModernRenderableScene::GatherBatchUpdateRange(const ObjectDataUpdateBatch& objectUpdates, uint32_t updateBegin, uint32_t updateEnd)
+{
+	for(uint32_t updateIndex = updateBegin; updateIndex < updateEnd; updateIndex++)
+	{
+		uint32_t sourceIndex = mBatchUpdateOrder.empty() ? updateIndex : mBatchUpdateOrder[updateIndex];
+
+		mBatchObjectUpdates[updateIndex] = ObjectDataUpdateInfo
+		{
+			.ObjectId          = objectUpdates.ObjectIds[sourceIndex],
+			.NewObjectLocation = SceneObjectLocation
+			{
+				.Position           = objectUpdates.Positions[sourceIndex],
+				.Scale              = objectUpdates.Scales[sourceIndex],
+				.RotationQuaternion = objectUpdates.RotationQuaternions[sourceIndex]
+			}
+		};
+	}
 }
 
+
 uint64_t ModernRenderableScene::GetMaterialDataOffset(uint32_t materialIndex) const
 {
 	return GetBaseMaterialDataOffset() + (uint64_t)materialIndex * mMaterialChunkDataSize;
@@ -8,6 +8,11 @@ class ModernRenderableScene: public BaseRenderableScene
 {
 	friend class ModernRenderableSceneBuilder;
 
+	//Packing and uploading this many updates is worth a separate thread pool job
+	static constexpr uint32_t UpdatesPerJob = 8192;
+
+	static constexpr uint32_t NewUpdateSourceBit = 0x80000000;
+
 	struct RigidObjectUpdateMetadata
 	{
 		uint32_t MeshHandleIndex; //Unique for each instance of the mesh (NOT the index into mSceneMeshes)
@@ -18,8 +23,19 @@ public:
 	ModernRenderableScene(uint64_t constantDataAlignment);
 	~ModernRenderableScene();
 
-	void UpdateFrameData(const FrameDataUpdateInfo& frameUpdate, uint64_t frameNumber)                           override final;
-	void UpdateRigidSceneObjects(const std::span<ObjectDataUpdateInfo> rigidObjectUpdates, uint64_t frameNumber) override final;
+	void UpdateFrameData(const FrameDataUpdateInfo& frameUpdate, uint64_t frameNumber)                                                override final;
+	void UpdateRigidSceneObjects(const std::span<ObjectDataUpdateInfo> rigidObjectUpdates, uint64_t frameNumber)                      override final;
+	void UpdateRigidSceneObjectBatch(const ObjectDataUpdateBatch& objectUpdates, ThreadPool* threadPool)                              override final;
+
+private:
+	//Runs the per-frame update bookkeeping and uploads the object data, once per frame. The object updates are sorted, one per object at most
+	void ApplyRigidObjectUpdates(std::span<const ObjectDataUpdateInfo> rigidObjectUpdates, ThreadPool* threadPool, uint64_t frameNumber);
+
+	//Packs the new object data and copies it to the upload buffer for the updates in [updateBegin, updateEnd)
+	void UploadRigidObjectUpdateRange(std::span<const ObjectDataUpdateInfo> objectUpdates, uint32_t frameResourceIndex, uint32_t updateBegin, uint32_t updateEnd);
+
+	//Gathers the batch updates [updateBegin, updateEnd) in sorted order into mBatchObjectUpdates
+	void GatherBatchUpdateRange(const ObjectDataUpdateBatch& objectUpdates, uint32_t updateBegin, uint32_t updateEnd);
 
 protected:
 	uint64_t GetMaterialDataOffset(uint32_t materialIndex) const;
@@ -49,9 +65,20 @@ protected:
 	std::vector<PerObjectData> mCurrFrameDataToUpdate;
 	uint32_t                   mCurrFrameUpdatedObjectCount;
 
+	//Where each element of mCurrFrameDataToUpdate comes from: the index into mPrevFrameDataToUpdate or the index of the new update marked with NewUpdateSourceBit
+	std::vector<uint32_t> mCurrFrameUpdateSources;
+
 	//Leftover updates from the previous frame
 	std::vector<PerObjectData> mPrevFrameDataToUpdate;
 
+	//The sorted updates of the batch queued by UpdateRigidSceneObjectBatch() and the thread pool to apply them with
+	std::vector<uint32_t>             mBatchUpdateOrder;
+	std::vector<ObjectDataUpdateInfo> mBatchObjectUpdates;
+	ThreadPool*                       mBatchThreadPoolRef;
+
+	//Scratch list for merging the queued batch with the updates of UpdateRigidSceneObjects()
+	std::vector<ObjectDataUpdateInfo> mCombinedObjectUpdates;
+
 	//Persistently mapped pointer into host-visible upload data
 	void* mSceneUploadDataBufferPointer;
 
@@ -65,4 +92,20 @@ protected:
 	uint32_t mObjectChunkDataSize;
 	uint32_t mFrameChunkDataSize;
 	uint32_t mMaterialChunkDataSize;
+
+	//The sizes the device buffers were created with. A scene that took the buffers of the previous one can use less
+	uint64_t mVertexBufferCapacity;
+	uint64_t mIndexBufferCapacity;
+	uint64_t mConstantBufferCapacity;
+	uint64_t mUploadBufferCapacity;
+
+	//What the device buffers and textures were baked from: the hash of each chunk of the buffer data, and the layout and the contents of each texture.
+	//The next bake of the edited scene compares its data with them and only uploads the changed parts, into the same allocations
+	uint64_t              mVertexDataSize;
+	uint64_t              mIndexDataSize;
+	std::vector<uint64_t> mVertexDataChunkHashes;
+	std::vector<uint64_t> mIndexDataChunkHashes;
+	std::vector<uint64_t> mStaticConstantDataChunkHashes;
+	std::vector<uint64_t> mTextureLayoutHashes;
+	std::vector<uint64_t> mTextureContentHashes;
 };
\ No newline at end of file
@@ -1,14 +1,65 @@
 #include "ModernRenderableSceneBuilder.hpp"
 #include "ModernRenderableScene.hpp"
 #include "../RenderingUtils.hpp"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <array>
+#include <cassert>
+
+namespace
+{
+	//The part of the DDS file that defines the size and the format of the texture: the magic number, the header and the DX10 header if present
+	uint64_t HashDdsLayout(std::span<const std::byte> ddsData)
+	{
+		constexpr size_t   ddsHeaderSize           = 4 + 124;
+		constexpr size_t   ddsDx10HeaderSize       = 20;
+		constexpr size_t   pixelFormatFlagsOffset  = 4 + 76;
+		constexpr size_t   pixelFormatFourCCOffset = 4 + 80;
+		constexpr uint32_t pixelFormatFourCCFlag   = 0x4;
+
+		size_t layoutByteCount = std::min(ddsData.size(), ddsHeaderSize);
+		if(ddsData.size() >= ddsHeaderSize)
+		{
+			uint32_t pixelFormatFlags = 0;
+			memcpy(&pixelFormatFlags, ddsData.data() + pixelFormatFlagsOffset, sizeof(uint32_t));
+
+			if((pixelFormatFlags & pixelFormatFourCCFlag) && memcmp(ddsData.data() + pixelFormatFourCCOffset, "DX10", 4) == 0)
+			{
+				layoutByteCount = std::min(ddsData.size(), ddsHeaderSize + ddsDx10HeaderSize);
+			}
+		}
+
+		//The file size makes the files with the same header but different data sizes (e.g. with some mips cut off) different
+		uint64_t ddsDataSize = ddsData.size();
+
+		uint64_t layoutHash = RenderableSceneBakeCache::HashBytes(RenderableSceneBakeCache::InitialHash, ddsData.first(layoutByteCount));
+		return RenderableSceneBakeCache::HashBytes(layoutHash, std::as_bytes(std::span(&ddsDataSize, 1)));
+	}
+
+	void HashChunks(std::span<const std::byte> data, uint64_t chunkSize, std::vector<uint64_t>& outChunkHashes)
+	{
+		outChunkHashes.clear();
+		for(uint64_t chunkOffset = 0; chunkOffset < data.size(); chunkOffset += chunkSize)
+		{
+			std::span<const std::byte> chunkData = data.subspan(chunkOffset, std::min(chunkSize, data.size() - chunkOffset));
+			outChunkHashes.push_back(RenderableSceneBakeCache::HashBytes(RenderableSceneBakeCache::InitialHash, chunkData));
+		}
+	}
+}
 
 ModernRenderableSceneBuilder::ModernRenderableSceneBuilder(ModernRenderableScene* sceneToBuild, size_t texturePlacementAlignment): BaseRenderableSceneBuilder(sceneToBuild), mModernSceneToBuild(sceneToBuild), mTexturePlacementAlignment(texturePlacementAlignment)
 {
+	mPreviousModernSceneRef = nullptr;
+	mPatchingPreviousScene  = false;
+
 	mVertexBufferGpuMemoryOffset   = 0;
 	mIndexBufferGpuMemoryOffset    = 0;
 	mConstantBufferGpuMemoryOffset = 0;
 	mUploadBufferMemoryOffset      = 0;
 
+	mIntermediateBufferTextureDataOffset = 0;
+
 	mIntermediateBufferSize = 0;
 }
 
@@ -18,14 +69,40 @@ ModernRenderableSceneBuilder::~ModernRenderableSceneBuilder()
 
 void ModernRenderableSceneBuilder::Bake()
 {
-	//Initialize everything needed to create buffers
-	InitializeBufferCreationData();
+	//Hash the buffer and texture data to compare it with the data of the previous scene
+	InitializeBakedDataHashes();
+
+	//The edited scene of the same buffer sizes and texture formats is uploaded into the buffers and textures of the previous one
+	mPatchingPreviousScene = CanPatchPreviousScene();
+	if(mPatchingPreviousScene)
+	{
+		//Take the buffers and textures of the previous scene. Its upload buffer stays mapped
+		TakePreviousSceneResources();
+		mModernSceneToBuild->mSceneUploadDataBufferPointer = std::exchange(mPreviousModernSceneRef->mSceneUploadDataBufferPointer, nullptr);
+
+		//Find the changed buffer ranges and textures
+		InitializeBufferPatchData();
+
+		//Load the changed textures
+		InitializeTextureCreationData();
+	}
+	else
+	{
+		//The previous scene is replaced as a whole, don't keep both in memory
+		if(mPreviousModernSceneRef != nullptr)
+		{
+			FreePreviousSceneResources();
+		}
 
-	//Initialize everything needed to create textures
-	InitializeTextureCreationData();
+		//Initialize everything needed to create buffers
+		InitializeBufferCreationData();
 
-	//Create the buffers and textures
-	FinalizeBuffersAndTexturesCreation();
+		//Initialize everything needed to create textures
+		InitializeTextureCreationData();
+
+		//Create the buffers and textures
+		FinalizeBuffersAndTexturesCreation();
+	}
 
 	//Create and fill intermediate buffer
 	UploadIntermediateData();
@@ -35,62 +112,172 @@ void ModernRenderableSceneBuilder::Bake()
 
 	//Send the upload commands to GPU and wait
 	HandleUploadCommands();
+
+	//Remember the uploaded data for the next bake
+	SaveBakedDataHashes();
 }
 
-void ModernRenderableSceneBuilder::InitializeBufferCreationData()
+void ModernRenderableSceneBuilder::SetPreviousScene(ModernRenderableScene* previousScene)
 {
-	//Create vertex buffer data
-	const size_t vertexDataSize = mVertexBufferData.size() * sizeof(RenderableSceneVertex);
-	CreateVertexBufferInfo(vertexDataSize);
-
-	mIntermediateBufferVertexDataOffset = mIntermediateBufferSize;
-	mIntermediateBufferSize            += vertexDataSize;
-
-
-	//Create index buffer data
-	const size_t indexDataSize = mIndexBufferData.size() * sizeof(RenderableSceneIndex);
-	CreateIndexBufferInfo(indexDataSize);
-
-	mIntermediateBufferIndexDataOffset = mIntermediateBufferSize;
-	mIntermediateBufferSize           += indexDataSize;
+	assert(previousScene != mModernSceneToBuild);
+	mPreviousModernSceneRef = previousScene;
+}
 
+void ModernRenderableSceneBuilder::InitializeBakedDataHashes()
+{
+	mModernSceneToBuild->mVertexDataSize = mVertexBufferSource.size() * sizeof(RenderableSceneVertex);
+	mModernSceneToBuild->mIndexDataSize  = mIndexBufferSource.size()  * sizeof(RenderableSceneIndex);
 
-	//Create static constant buffer data
 	mModernSceneToBuild->mMaterialDataSize     = mMaterialData.size() * mModernSceneToBuild->mMaterialChunkDataSize;
 	mModernSceneToBuild->mFrameDataSize        = mModernSceneToBuild->mFrameChunkDataSize;
 	mModernSceneToBuild->mStaticObjectDataSize = mStaticInstancedObjectCount * mModernSceneToBuild->mObjectChunkDataSize;
-	mModernSceneToBuild->mRigidObjectDataSize  = mRigidObjectCount * mModernSceneToBuild->mObjectChunkDataSize;
+	mModernSceneToBuild->mRigidObjectDataSize  = (mRigidObjectCount + mDynamicObjectCount) * mModernSceneToBuild->mObjectChunkDataSize;
 
-	const size_t constantDataSize = mModernSceneToBuild->mMaterialDataSize + mModernSceneToBuild->mFrameDataSize + mModernSceneToBuild->mStaticObjectDataSize + mModernSceneToBuild->mRigidObjectDataSize;
-	CreateConstantBufferInfo(constantDataSize);
+	//The frame data between the materials and the static object data is uploaded each frame, it's left zeroed here
+	mStaticConstantData.assign(mModernSceneToBuild->GetBaseRigidObjectDataOffset(), std::byte(0));
 
-	mIntermediateBufferStaticConstantDataOffset = mIntermediateBufferSize;
-	mIntermediateBufferSize                    += constantDataSize;
-
-	mStaticConstantData.resize(mModernSceneToBuild->mMaterialDataSize + mModernSceneToBuild->mStaticObjectDataSize);
-
-	std::byte* staticMaterialDataStart = mStaticConstantData.data();
 	for(uint32_t materialIndex = 0; materialIndex < (uint32_t)mMaterialData.size(); materialIndex++)
 	{
-		std::byte* materialDataPointer = staticMaterialDataStart + materialIndex * mModernSceneToBuild->mMaterialChunkDataSize;
+		std::byte* materialDataPointer = mStaticConstantData.data() + mModernSceneToBuild->GetMaterialDataOffset(materialIndex);
 		memcpy(materialDataPointer, &mMaterialData[materialIndex], sizeof(RenderableSceneMaterial));
 	}
 
 	const uint32_t initialDataStaticObjectsOffset = 0;
-	std::byte* staticObjectDataStart = mStaticConstantData.data() + mModernSceneToBuild->mMaterialDataSize;
 	for(uint32_t staticObjectIndex = 0; staticObjectIndex < mStaticInstancedObjectCount; staticObjectIndex++)
 	{
 		const BaseRenderableScene::PerObjectData perObjectData = mModernSceneToBuild->PackObjectData(mInitialObjectData[initialDataStaticObjectsOffset + staticObjectIndex]);
 
-		std::byte* staticDataPointer = staticObjectDataStart + staticObjectIndex * mModernSceneToBuild->mStaticObjectDataSize;
+		std::byte* staticDataPointer = mStaticConstantData.data() + mModernSceneToBuild->GetObjectDataOffset(staticObjectIndex);
 		memcpy(staticDataPointer, &perObjectData, sizeof(BaseRenderableScene::PerObjectData));
 	}
 
+	HashChunks(std::as_bytes(mVertexBufferSource), BakeChunkSize, mVertexDataChunkHashes);
+	HashChunks(std::as_bytes(mIndexBufferSource),  BakeChunkSize, mIndexDataChunkHashes);
+	HashChunks(mStaticConstantData,                BakeChunkSize, mStaticConstantDataChunkHashes);
+
+	mTextureDdsData.resize(mTexturesToLoad.size());
+	mTextureLayoutHashes.resize(mTexturesToLoad.size());
+	mTextureContentHashes.resize(mTexturesToLoad.size());
+	for(size_t textureIndex = 0; textureIndex < mTexturesToLoad.size(); textureIndex++)
+	{
+		mTextureDdsData[textureIndex] = GetTextureDdsData(textureIndex);
+
+		//The textures that can't be read are loaded from the file by the loader to report the error, and never patched
+		mTextureLayoutHashes[textureIndex]  = 0;
+		mTextureContentHashes[textureIndex] = 0;
+		if(!mTextureDdsData[textureIndex].empty())
+		{
+			mTextureLayoutHashes[textureIndex]  = HashDdsLayout(mTextureDdsData[textureIndex]);
+			mTextureContentHashes[textureIndex] = GetTextureContentHash(textureIndex, mTextureDdsData[textureIndex]);
+		}
+	}
+}
+
+bool ModernRenderableSceneBuilder::CanPatchPreviousScene() const
+{
+	const ModernRenderableScene* previousScene = mPreviousModernSceneRef;
+	if(previousScene == nullptr)
+	{
+		return false;
+	}
+
+	//The constant data offsets are computed from the sizes, any layout that fits is fine. The capacities stay 0 if the previous bake didn't finish
+	bool buffersFit = mModernSceneToBuild->mVertexDataSize <= previousScene->mVertexBufferCapacity
+		           && mModernSceneToBuild->mIndexDataSize  <= previousScene->mIndexBufferCapacity
+		           && CalcConstantBufferSize()             <= previousScene->mConstantBufferCapacity
+		           && CalcUploadBufferSize()               <= previousScene->mUploadBufferCapacity;
+
+	if(!buffersFit || previousScene->mTextureLayoutHashes.size() != mTextureLayoutHashes.size())
+	{
+		return false;
+	}
+
+	//The same DDS headers mean the same image sizes and formats, the new contents fit into the old images
+	for(size_t textureIndex = 0; textureIndex < mTextureLayoutHashes.size(); textureIndex++)
+	{
+		if(mTextureDdsData[textureIndex].empty() || previousScene->mTextureLayoutHashes[textureIndex] != mTextureLayoutHashes[textureIndex])
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+uint64_t ModernRenderableSceneBuilder::CalcConstantBufferSize() const
+{
+	return mModernSceneToBuild->mMaterialDataSize + mModernSceneToBuild->mFrameDataSize + mModernSceneToBuild->mStaticObjectDataSize + mModernSceneToBuild->mRigidObjectDataSize;
+}
+
+uint64_t ModernRenderableSceneBuilder::CalcUploadBufferSize() const
+{
+	const uint64_t uploadPerObjectDataSize = mModernSceneToBuild->mRigidObjectDataSize * Utils::InFlightFrameCount;
+	const uint64_t uploadPerFrameDataSize  = mModernSceneToBuild->mFrameDataSize * Utils::InFlightFrameCount;
+	return uploadPerObjectDataSize + uploadPerFrameDataSize;
+}
+
+void ModernRenderableSceneBuilder::InitializeBufferCreationData()
+{
+	mIntermediateBufferSize = 0;
+
+	mVertexBufferUploadRanges.clear();
+	mIndexBufferUploadRanges.clear();
+	mConstantBufferUploadRanges.clear();
+
+
+	//Create vertex buffer data
+	const size_t vertexDataSize = mModernSceneToBuild->mVertexDataSize;
+	CreateVertexBufferInfo(vertexDataSize);
+
+	AddBufferUploadRange(0, vertexDataSize, mVertexBufferUploadRanges);
+
+
+	//Create index buffer data
+	const size_t indexDataSize = mModernSceneToBuild->mIndexDataSize;
+	CreateIndexBufferInfo(indexDataSize);
+
+	AddBufferUploadRange(0, indexDataSize, mIndexBufferUploadRanges);
+
+
+	//Create static constant buffer data
+	const size_t constantDataSize = CalcConstantBufferSize();
+	CreateConstantBufferInfo(constantDataSize);
+
+	AddBufferUploadRange(0, mStaticConstantData.size(), mConstantBufferUploadRanges);
+
 
 	//Create non-static constant buffer data
-	const size_t uploadPerObjectDataSize = mModernSceneToBuild->mRigidObjectDataSize * Utils::InFlightFrameCount;
-	const size_t uploadPerFrameDataSize  = mModernSceneToBuild->mFrameDataSize * Utils::InFlightFrameCount;
-	CreateUploadBufferInfo(uploadPerObjectDataSize + uploadPerFrameDataSize);
+	CreateUploadBufferInfo(CalcUploadBufferSize());
+
+
+	//All textures of a new scene are uploaded
+	mUploadedTextureIndices.resize(mTexturesToLoad.size());
+	for(uint32_t textureIndex = 0; textureIndex < (uint32_t)mTexturesToLoad.size(); textureIndex++)
+	{
+		mUploadedTextureIndices[textureIndex] = textureIndex;
+	}
+}
+
+void ModernRenderableSceneBuilder::InitializeBufferPatchData()
+{
+	mIntermediateBufferSize = 0;
+
+	mVertexBufferUploadRanges.clear();
+	mIndexBufferUploadRanges.clear();
+	mConstantBufferUploadRanges.clear();
+
+	AddChangedChunkRanges(mVertexDataChunkHashes,         mPreviousModernSceneRef->mVertexDataChunkHashes,         mModernSceneToBuild->mVertexDataSize, mVertexBufferUploadRanges);
+	AddChangedChunkRanges(mIndexDataChunkHashes,          mPreviousModernSceneRef->mIndexDataChunkHashes,          mModernSceneToBuild->mIndexDataSize,  mIndexBufferUploadRanges);
+	AddChangedChunkRanges(mStaticConstantDataChunkHashes, mPreviousModernSceneRef->mStaticConstantDataChunkHashes, mStaticConstantData.size(),           mConstantBufferUploadRanges);
+
+	mUploadedTextureIndices.clear();
+	for(uint32_t textureIndex = 0; textureIndex < (uint32_t)mTexturesToLoad.size(); textureIndex++)
+	{
+		if(mTextureContentHashes[textureIndex] != mPreviousModernSceneRef->mTextureContentHashes[textureIndex])
+		{
+			mUploadedTextureIndices.push_back(textureIndex);
+		}
+	}
 }
 
 void ModernRenderableSceneBuilder::InitializeTextureCreationData()
@@ -101,10 +288,14 @@ void ModernRenderableSceneBuilder::InitializeTextureCreationData()
 	mTextureData.clear();
 
 	AllocateTextureMetadataArrays(mTexturesToLoad.size());
-	for(size_t textureIndex = 0; textureIndex < mTexturesToLoad.size(); textureIndex++)
+	for(uint32_t textureIndex: mUploadedTextureIndices)
 	{
+		//Each texture starts at the placement alignment, not only the first one
+		mIntermediateBufferSize = Utils::AlignMemory(mIntermediateBufferSize, mTexturePlacementAlignment);
+		mTextureData.resize(mIntermediateBufferSize - mIntermediateBufferTextureDataOffset);
+
 		std::vector<std::byte> textureData;
-		LoadTextureFromFile(mTexturesToLoad[textureIndex], mIntermediateBufferSize, textureIndex, textureData);
+		LoadTexture(mTexturesToLoad[textureIndex], mTextureDdsData[textureIndex], mIntermediateBufferSize, textureIndex, textureData);
 
 		mTextureData.insert(mTextureData.end(), textureData.begin(), textureData.end());
 		mIntermediateBufferSize += textureData.size();
@@ -119,37 +310,56 @@ void ModernRenderableSceneBuilder::FinalizeBuffersAndTexturesCreation()
 
 void ModernRenderableSceneBuilder::UploadIntermediateData()
 {
-	CreateIntermediateBuffer();
+	//Nothing changed since the previous bake
+	if(mIntermediateBufferSize == 0)
+	{
+		return;
+	}
 
-	const uint64_t vertexDataSize         = mVertexBufferData.size()   * sizeof(RenderableSceneVertex);
-	const uint64_t indexDataSize          = mIndexBufferData.size()    * sizeof(RenderableSceneIndex);
-	const uint64_t staticConstantDataSize = mStaticConstantData.size() * sizeof(std::byte);
-	const uint64_t textureDataSize        = mTextureData.size()        * sizeof(std::byte);
+	CreateIntermediateBuffer();
 
 	std::byte* bufferDataBytes = MapIntermediateBuffer();
 
-	memcpy(bufferDataBytes + mIntermediateBufferVertexDataOffset,         mVertexBufferData.data(),   vertexDataSize);
-	memcpy(bufferDataBytes + mIntermediateBufferIndexDataOffset,          mIndexBufferData.data(),    indexDataSize);
-	memcpy(bufferDataBytes + mIntermediateBufferStaticConstantDataOffset, mStaticConstantData.data(), staticConstantDataSize);
-	memcpy(bufferDataBytes + mIntermediateBufferTextureDataOffset,        mTextureData.data(),        textureDataSize);
+	std::array bufferDataSources  = {std::as_bytes(mVertexBufferSource), std::as_bytes(mIndexBufferSource), std::span<const std::byte>(mStaticConstantData)};
+	std::array bufferUploadRanges = {&mVertexBufferUploadRanges,         &mIndexBufferUploadRanges,         &mConstantBufferUploadRanges};
+	for(size_t bufferIndex = 0; bufferIndex < bufferDataSources.size(); bufferIndex++)
+	{
+		for(const BufferUploadRange& uploadRange: *bufferUploadRanges[bufferIndex])
+		{
+			memcpy(bufferDataBytes + uploadRange.IntermediateBufferOffset, bufferDataSources[bufferIndex].data() + uploadRange.BufferOffset, uploadRange.ByteSize);
+		}
+	}
+
+	//A scene without textures has no texture data, and memcpy doesn't accept the null pointer even for zero bytes
+	if(!mTextureData.empty())
+	{
+		memcpy(bufferDataBytes + mIntermediateBufferTextureDataOffset, mTextureData.data(), mTextureData.size());
+	}
 
 	UnmapIntermediateBuffer();
 }
 
 void ModernRenderableSceneBuilder::InitializeUploadBuffer()
 {
-	mModernSceneToBuild->mSceneUploadDataBufferPointer = MapUploadBuffer();
+	//The upload buffer taken from the previous scene is already mapped
+	if(!mPatchingPreviousScene)
+	{
+		mModernSceneToBuild->mSceneUploadDataBufferPointer = MapUploadBuffer();
+	}
 
 
-	//Prepare update data
-	mModernSceneToBuild->mPrevFrameRigidMeshUpdates.resize((size_t)mRigidObjectCount * Utils::InFlightFrameCount + 1); //1 for each potential update and terminating (-1)
-	mModernSceneToBuild->mNextFrameRigidMeshUpdates.resize((size_t)mRigidObjectCount * Utils::InFlightFrameCount + 1); //1 for each potential update and terminating (-1)
+	//Prepare update data. The dynamic objects are updated the same way as the rigid ones
+	const uint32_t updatedObjectCount = mRigidObjectCount + mDynamicObjectCount;
 
-	mModernSceneToBuild->mCurrFrameRigidMeshUpdateIndices.resize(mRigidObjectCount); //1 for each potential update
+	mModernSceneToBuild->mPrevFrameRigidMeshUpdates.resize((size_t)updatedObjectCount * Utils::InFlightFrameCount + 1); //1 for each potential update and terminating (-1)
+	mModernSceneToBuild->mNextFrameRigidMeshUpdates.resize((size_t)updatedObjectCount * Utils::InFlightFrameCount + 1); //1 for each potential update and terminating (-1)
+
+	mModernSceneToBuild->mCurrFrameRigidMeshUpdateIndices.resize(updatedObjectCount); //1 for each potential update
+	mModernSceneToBuild->mCurrFrameUpdateSources.resize(updatedObjectCount);          //1 for each potential update
 	mModernSceneToBuild->mCurrFrameUpdatedObjectCount = 0;
 
-	mModernSceneToBuild->mPrevFrameDataToUpdate.resize(mRigidObjectCount); //1 for each potential update
-	mModernSceneToBuild->mCurrFrameDataToUpdate.resize(mRigidObjectCount); //1 for each potential update
+	mModernSceneToBuild->mPrevFrameDataToUpdate.resize(updatedObjectCount); //1 for each potential update
+	mModernSceneToBuild->mCurrFrameDataToUpdate.resize(updatedObjectCount); //1 for each potential update
 
 	mModernSceneToBuild->mPrevFrameRigidMeshUpdates[0] =
 	{
@@ -174,7 +384,87 @@ void ModernRenderableSceneBuilder::InitializeUploadBuffer()
 
 void ModernRenderableSceneBuilder::HandleUploadCommands()
 {
+	//Nothing changed since the previous bake
+	if(mIntermediateBufferSize == 0)
+	{
+		return;
+	}
+
 	WriteInitializationCommands();
 	SubmitInitializationCommands();
 	WaitForInitializationCommands();
+}
+
+void ModernRenderableSceneBuilder::SaveBakedDataHashes()
+{
+	if(mPatchingPreviousScene)
+	{
+		mModernSceneToBuild->mVertexBufferCapacity   = mPreviousModernSceneRef->mVertexBufferCapacity;
+		mModernSceneToBuild->mIndexBufferCapacity    = mPreviousModernSceneRef->mIndexBufferCapacity;
+		mModernSceneToBuild->mConstantBufferCapacity = mPreviousModernSceneRef->mConstantBufferCapacity;
+		mModernSceneToBuild->mUploadBufferCapacity   = mPreviousModernSceneRef->mUploadBufferCapacity;
+	}
+	else
+	{
+		mModernSceneToBuild->mVertexBufferCapacity   = mModernSceneToBuild->mVertexDataSize;
+		mModernSceneToBuild->mIndexBufferCapacity    = mModernSceneToBuild->mIndexDataSize;
+		mModernSceneToBuild->mConstantBufferCapacity = CalcConstantBufferSize();
+		mModernSceneToBuild->mUploadBufferCapacity   = CalcUploadBufferSize();
+	}
+
+	mModernSceneToBuild->mVertexDataChunkHashes         = std::move(mVertexDataChunkHashes);
+	mModernSceneToBuild->mIndexDataChunkHashes          = std::move(mIndexDataChunkHashes);
+	mModernSceneToBuild->mStaticConstantDataChunkHashes = std::move(mStaticConstantDataChunkHashes);
+	mModernSceneToBuild->mTextureLayoutHashes           = std::move(mTextureLayoutHashes);
+	mModernSceneToBuild->mTextureContentHashes          = std::move(mTextureContentHashes);
+
+	mTextureDdsData.clear();
+}
+
+void ModernRenderableSceneBuilder::AddBufferUploadRange(uint64_t bufferOffset, uint64_t byteSize, std::vector<BufferUploadRange>& inoutUploadRanges)
+{
+	//Zero-sized copies are invalid in both APIs
+	if(byteSize == 0)
+	{
+		return;
+	}
+
+	inoutUploadRanges.push_back(BufferUploadRange
+	{
+		.IntermediateBufferOffset = mIntermediateBufferSize,
+		.BufferOffset             = bufferOffset,
+		.ByteSize                 = byteSize
+	});
+
+	mIntermediateBufferSize += byteSize;
+}
+
+void ModernRenderableSceneBuilder::AddChangedChunkRanges(std::span<const uint64_t> chunkHashes, std::span<const uint64_t> prevChunkHashes, uint64_t dataSize, std::vector<BufferUploadRange>& inoutUploadRanges)
+{
+	//The chunks past the end of the previous data are always new
+	auto chunkChanged = [chunkHashes, prevChunkHashes](size_t chunkIndex)
+	{
+		return chunkIndex >= prevChunkHashes.size() || chunkHashes[chunkIndex] != prevChunkHashes[chunkIndex];
+	};
+
+	for(size_t chunkIndex = 0; chunkIndex < chunkHashes.size(); chunkIndex++)
+	{
+		if(!chunkChanged(chunkIndex))
+		{
+			continue;
+		}
+
+		size_t changedChunkEnd = chunkIndex + 1;
+		while(changedChunkEnd < chunkHashes.size() && chunkChanged(changedChunkEnd))
+		{
+			changedChunkEnd++;
+		}
+
+		//The last chunk can be shorter than the others
+		uint64_t rangeBegin = chunkIndex * BakeChunkSize;
+		uint64_t rangeEnd   = std::min(changedChunkEnd * BakeChunkSize, dataSize);
+		AddBufferUploadRange(rangeBegin, rangeEnd - rangeBegin, inoutUploadRanges);
+
+		chunkIndex = changedChunkEnd;
+	}
 }
\ No newline at end of file
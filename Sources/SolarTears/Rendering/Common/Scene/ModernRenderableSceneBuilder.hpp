@@ -7,6 +7,18 @@ class ModernRenderableScene;
 
 class ModernRenderableSceneBuilder: public BaseRenderableSceneBuilder
 {
+	//The granularity of finding the changed buffer data. Smaller chunks upload less of the unchanged data around the changes, but keep more hashes
+	static constexpr uint64_t BakeChunkSize = 64 * 1024;
+
+protected:
+	//A part of a scene buffer to copy from the intermediate buffer
+	struct BufferUploadRange
+	{
+		uint64_t IntermediateBufferOffset;
+		uint64_t BufferOffset;
+		uint64_t ByteSize;
+	};
+
 public:
 	ModernRenderableSceneBuilder(ModernRenderableScene* sceneToBuild, size_t texturePlacementAlignment);
 	~ModernRenderableSceneBuilder();
@@ -14,18 +26,26 @@ public:
 protected:
 	void Bake() override;
 
+	//The scene the built one replaces. If the new data fits into its buffers and the texture sizes and formats stay the same, the built scene takes its device buffers and textures
+	//and only the changed buffer ranges and textures are uploaded. Otherwise its device memory is freed before allocating the new one. Has to outlive Build()
+	void SetPreviousScene(ModernRenderableScene* previousScene);
+
 protected:
 	virtual void CreateVertexBufferInfo(size_t vertexDataSize)     = 0; //Prepare the necessary data for vertex buffer creation
 	virtual void CreateIndexBufferInfo(size_t indexDataSize)       = 0; //Prepare the necessary data for index buffer creation
 	virtual void CreateConstantBufferInfo(size_t constantDataSize) = 0; //Prepare the necessary data for constant buffer creation
 	virtual void CreateUploadBufferInfo(size_t constantDataSize)   = 0; //Prepare the necessary data for upload buffer creation (intermediate buffer for dynamic constant data)
 
-	virtual void AllocateTextureMetadataArrays(size_t textureCount)                                                                                                              = 0;
-	virtual void LoadTextureFromFile(const std::wstring& textureFilename, uint64_t currentIntermediateBufferOffset, size_t textureIndex, std::vector<std::byte>& outTextureData) = 0;
+	virtual void AllocateTextureMetadataArrays(size_t textureCount)                                                                                                                                                = 0;
+	//Loads the texture from textureDdsData if it's not empty, from textureFilename otherwise
+	virtual void LoadTexture(const std::wstring& textureFilename, std::span<const std::byte> textureDdsData, uint64_t currentIntermediateBufferOffset, size_t textureIndex, std::vector<std::byte>& outTextureData) = 0;
 
 	virtual void FinishBufferCreation()  = 0;
 	virtual void FinishTextureCreation() = 0;
 
+	virtual void TakePreviousSceneResources() = 0; //Move the device buffers, textures and their memory from the previous scene to the built one
+	virtual void FreePreviousSceneResources() = 0; //Free the device buffers, textures and their memory of the previous scene
+
 	virtual std::byte* MapUploadBuffer() = 0;
 
 	virtual void       CreateIntermediateBuffer()      = 0;
@@ -37,29 +57,55 @@ protected:
 	virtual void WaitForInitializationCommands() const = 0;
 
 private:
+	//Initialize the static buffer data and the hashes of the buffer and texture data
+	void InitializeBakedDataHashes();
+
+	//Check if the previous scene can be patched instead of creating new buffers and textures
+	bool CanPatchPreviousScene() const;
+
+	//The sizes of the constant buffer and the upload buffer the built scene needs
+	uint64_t CalcConstantBufferSize() const;
+	uint64_t CalcUploadBufferSize()   const;
+
 	//Initialize the buffer data and API-specific info to create buffers
 	void InitializeBufferCreationData();
-	
-	//Initialize the texture data and API-specific info to create textures
+
+	//Find the buffer ranges and the textures that differ from the ones of the previous scene
+	void InitializeBufferPatchData();
+
+	//Initialize the texture data and API-specific info to create textures, or only to upload them if patching the previous scene
 	void InitializeTextureCreationData();
-	
+
 	//Create and allocate buffers and textures
 	void FinalizeBuffersAndTexturesCreation();
-	
+
 	//Upload the static data to the intermediate buffer
 	void UploadIntermediateData();
-	
+
 	//Initialize the CPU-visible buffer for dynamic data
 	void InitializeUploadBuffer();
 
 	//Send the upload commands to GPU and wait
 	void HandleUploadCommands();
 
+	//Remember the hashes of the uploaded data in the scene, for the next bake
+	void SaveBakedDataHashes();
+
+	//Add the range of the buffer data to upload, placing it at the end of the intermediate buffer
+	void AddBufferUploadRange(uint64_t bufferOffset, uint64_t byteSize, std::vector<BufferUploadRange>& inoutUploadRanges);
+
+	//Add the ranges of the chunks that differ from the previous ones. The neighbouring chunks are merged into one range
+	void AddChangedChunkRanges(std::span<const uint64_t> chunkHashes, std::span<const uint64_t> prevChunkHashes, uint64_t dataSize, std::vector<BufferUploadRange>& inoutUploadRanges);
+
 protected:
 	ModernRenderableScene* mModernSceneToBuild;
+	ModernRenderableScene* mPreviousModernSceneRef;
+
+	//True if the built scene took the device buffers and textures of the previous one, and only the changed parts are uploaded
+	bool mPatchingPreviousScene;
 
 	std::vector<std::byte> mTextureData;
-	std::vector<std::byte> mStaticConstantData;
+	std::vector<std::byte> mStaticConstantData; //Laid out as the beginning of the constant buffer, up to the rigid object data
 
 	size_t mTexturePlacementAlignment;
 
@@ -68,10 +114,23 @@ protected:
 	uint64_t mConstantBufferGpuMemoryOffset;
 	uint64_t mUploadBufferMemoryOffset;
 
-	uint64_t mIntermediateBufferVertexDataOffset;
-	uint64_t mIntermediateBufferIndexDataOffset;
-	uint64_t mIntermediateBufferStaticConstantDataOffset;
+	std::vector<BufferUploadRange> mVertexBufferUploadRanges;
+	std::vector<BufferUploadRange> mIndexBufferUploadRanges;
+	std::vector<BufferUploadRange> mConstantBufferUploadRanges;
+
+	//All textures for a new scene, only the changed ones when patching the previous scene
+	std::vector<uint32_t> mUploadedTextureIndices;
+
 	uint64_t mIntermediateBufferTextureDataOffset;
 
 	size_t mIntermediateBufferSize;
+
+private:
+	std::vector<std::span<const std::byte>> mTextureDdsData;
+
+	std::vector<uint64_t> mVertexDataChunkHashes;
+	std::vector<uint64_t> mIndexDataChunkHashes;
+	std::vector<uint64_t> mStaticConstantDataChunkHashes;
+	std::vector<uint64_t> mTextureLayoutHashes;
+	std::vector<uint64_t> mTextureContentHashes;
 };
\ No newline at end of file
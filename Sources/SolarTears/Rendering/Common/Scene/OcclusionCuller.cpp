@@ -0,0 +1,372 @@
+#include "OcclusionCuller.hpp"
+#include "../../../Core/ThreadPool.hpp"
+#include <algorithm>
+#include <latch>
+#include <limits>
+#include <cassert>
+
+OcclusionCuller::OcclusionCuller()
+{
+	mDepthBuffer.assign(DepthBufferWidth * DepthBufferHeight, 1.0f);
+	std::fill(std::begin(mTileMaxDepths), std::end(mTileMaxDepths), 1.0f);
+
+	DirectX::XMStoreFloat4x4(&mViewProjMatrix, DirectX::XMMatrixIdentity());
+}
+
+OcclusionCuller::~OcclusionCuller()
+{
+}
+
+void OcclusionCuller::ClearOccluders()
+{
+	mOccluderVertices.clear();
+	mOccluderIndices.clear();
+
+	mDepthBuffer.assign(DepthBufferWidth * DepthBufferHeight, 1.0f);
+	std::fill(std::begin(mTileMaxDepths), std::end(mTileMaxDepths), 1.0f);
+}
+
+void OcclusionCuller::AddOccluder(std::span<const RenderableSceneVertex> vertices, std::span<const RenderableSceneIndex> indices, DirectX::FXMMATRIX worldMatrix)
+{
+	assert(indices.size() % 3 == 0);
+
+	uint32_t firstVertexIndex = (uint32_t)mOccluderVertices.size();
+	for(const RenderableSceneVertex& vertex: vertices)
+	{
+		DirectX::XMFLOAT3 worldPosition;
+		DirectX::XMStoreFloat3(&worldPosition, DirectX::XMVector3Transform(DirectX::XMLoadFloat3(&vertex.Position), worldMatrix));
+
+		mOccluderVertices.push_back(worldPosition);
+	}
+
+	for(RenderableSceneIndex index: indices)
+	{
+		mOccluderIndices.push_back(firstVertexIndex + index);
+	}
+}
+
+void OcclusionCuller::AddWorldSpaceOccluders(std::span<const DirectX::XMFLOAT3> vertices, std::span<const uint32_t> indices)
+{
+	assert(indices.size() % 3 == 0);
+
+	uint32_t firstVertexIndex = (uint32_t)mOccluderVertices.size();
+	mOccluderVertices.insert(mOccluderVertices.end(), vertices.begin(), vertices.end());
+
+	for(uint32_t index: indices)
+	{
+		mOccluderIndices.push_back(firstVertexIndex + index);
+	}
+}
+
+void OcclusionCuller::RenderOccluders(ThreadPool* threadPool, DirectX::FXMMATRIX viewProjMatrix)
+{
+	SetupTriangles(viewProjMatrix);
+
+	const uint32_t tileCount = TileCountX * TileCountY;
+	if(threadPool == nullptr || threadPool->GetWorkerThreadCount() == 0)
+	{
+		for(uint32_t tileIndex = 0; tileIndex < tileCount; tileIndex++)
+		{
+			RasterizeTile(tileIndex);
+		}
+
+		return;
+	}
+
+	//The tiles don't share any pixels. Same as in the frame graph traversal: the main thread takes the last tile and then waits for the others
+	std::latch rasterizeLatch(tileCount - 1);
+	for(uint32_t tileIndex = 0; tileIndex < tileCount - 1; tileIndex++)
+	{
+		struct JobData
+		{
+			OcclusionCuller* Culler;
+			std::latch*      Waitable;
+			uint32_t         TileIndex;
+		}
+		jobData =
+		{
+			.Culler    = this,
+			.Waitable  = &rasterizeLatch,
+			.TileIndex = tileIndex
+		};
+
+		auto rasterizeJob = [](void* userData, [[maybe_unused]] uint32_t userDataSize)
+		{
+			JobData* threadJobData = reinterpret_cast<JobData*>(userData);
+
+			threadJobData->Culler->RasterizeTile(threadJobData->TileIndex);
+			threadJobData->Waitable->count_down();
+		};
+
+		threadPool->EnqueueWork(rasterizeJob, &jobData, sizeof(JobData));
+	}
+
+	RasterizeTile(tileCount - 1);
+	rasterizeLatch.wait();
+}
+
+bool OcclusionCuller::IsBoxVisible(const DirectX::BoundingBox& box) const
+{
+	DirectX::XMMATRIX viewProjMatrix = DirectX::XMLoadFloat4x4(&mViewProjMatrix);
+
+	DirectX::XMFLOAT3 corners[DirectX::BoundingBox::CORNER_COUNT];
+	box.GetCorners(corners);
+
+	float minX     = std::numeric_limits<float>::max();
+	float minY     = std::numeric_limits<float>::max();
+	float maxX     = -std::numeric_limits<float>::max();
+	float maxY     = -std::numeric_limits<float>::max();
+	float minDepth = std::numeric_limits<float>::max();
+	for(const DirectX::XMFLOAT3& corner: corners)
+	{
+		DirectX::XMFLOAT4 clipCorner;
+		DirectX::XMStoreFloat4(&clipCorner, DirectX::XMVector3Transform(DirectX::XMLoadFloat3(&corner), viewProjMatrix));
+		if(clipCorner.w < MinVertexW)
+		{
+			return true;
+		}
+
+		float invW   = 1.0f / clipCorner.w;
+		float pixelX = (clipCorner.x * invW *  0.5f + 0.5f) * (float)DepthBufferWidth;
+		float pixelY = (clipCorner.y * invW * -0.5f + 0.5f) * (float)DepthBufferHeight;
+
+		minX     = std::min(minX, pixelX);
+		minY     = std::min(minY, pixelY);
+		maxX     = std::max(maxX, pixelX);
+		maxY     = std::max(maxY, pixelY);
+		minDepth = std::min(minDepth, clipCorner.z * invW);
+	}
+
+	if(maxX < 0.0f || maxY < 0.0f || minX >= (float)DepthBufferWidth || minY >= (float)DepthBufferHeight)
+	{
+		return true;
+	}
+
+	//Every pixel the box touches has to have an occluder in front of the nearest point of the box
+	uint32_t rectMinX = (uint32_t)std::max(minX, 0.0f);
+	uint32_t rectMinY = (uint32_t)std::max(minY, 0.0f);
+	uint32_t rectMaxX = std::min((uint32_t)maxX, DepthBufferWidth  - 1);
+	uint32_t rectMaxY = std::min((uint32_t)maxY, DepthBufferHeight - 1);
+	for(uint32_t tileY = rectMinY / TileHeight; tileY <= rectMaxY / TileHeight; tileY++)
+	{
+		for(uint32_t tileX = rectMinX / TileWidth; tileX <= rectMaxX / TileWidth; tileX++)
+		{
+			if(mTileMaxDepths[tileY * TileCountX + tileX] < minDepth)
+			{
+				continue;
+			}
+
+			uint32_t tileRectMinX = std::max(rectMinX, tileX * TileWidth);
+			uint32_t tileRectMinY = std::max(rectMinY, tileY * TileHeight);
+			uint32_t tileRectMaxX = std::min(rectMaxX, (tileX + 1) * TileWidth  - 1);
+			uint32_t tileRectMaxY = std::min(rectMaxY, (tileY + 1) * TileHeight - 1);
+			for(uint32_t y = tileRectMinY; y <= tileRectMaxY; y++)
+			{
+				const float* depthRow = &mDepthBuffer[(size_t)y * DepthBufferWidth];
+				for(uint32_t x = tileRectMinX; x <= tileRectMaxX; x++)
+				{
+					if(depthRow[x] >= minDepth)
+					{
+						return true;
+					}
+				}
+			}
+		}
+	}
+
+	return false;
+}
+
+uint32_t OcclusionCuller::GetOccluderTriangleCount() const
+{
+	return (uint32_t)(mOccluderIndices.size() / 3);
+}
+
+std::span<const DirectX::XMFLOAT3> OcclusionCuller::GetOccluderVertices() const
+{
+	return mOccluderVertices;
+}
+
+std::span<const uint32_t> OcclusionCuller::GetOccluderIndices() const
+{
+	return mOccluderIndices;
+}
+
+void OcclusionCuller::SetupTriangles(DirectX::FXMMATRIX viewProjMatrix)
+{
+	DirectX::XMStoreFloat4x4(&mViewProjMatrix, viewProjMatrix);
+
+	//Clip space to pixel space, with Y pointing down
+	DirectX::XMVECTOR viewportScale  = DirectX::XMVectorSet(0.5f * (float)DepthBufferWidth, -0.5f * (float)DepthBufferHeight, 1.0f, 1.0f);
+	DirectX::XMVECTOR viewportOffset = DirectX::XMVectorSet(0.5f * (float)DepthBufferWidth,  0.5f * (float)DepthBufferHeight, 0.0f, 0.0f);
+
+	mPixelSpaceVertices.resize(mOccluderVertices.size());
+	for(size_t vertexIndex = 0; vertexIndex < mOccluderVertices.size(); vertexIndex++)
+	{
+		DirectX::XMVECTOR clipPosition = DirectX::XMVector3Transform(DirectX::XMLoadFloat3(&mOccluderVertices[vertexIndex]), viewProjMatrix);
+		float             clipW        = DirectX::XMVectorGetW(clipPosition);
+
+		//The vertices behind the camera only keep their w, it marks their triangles as skipped
+		DirectX::XMVECTOR pixelPosition = DirectX::XMVectorZero();
+		if(clipW >= MinVertexW)
+		{
+			pixelPosition = DirectX::XMVectorMultiplyAdd(DirectX::XMVectorScale(clipPosition, 1.0f / clipW), viewportScale, viewportOffset);
+		}
+
+		DirectX::XMStoreFloat4(&mPixelSpaceVertices[vertexIndex], DirectX::XMVectorSetW(pixelPosition, clipW));
+	}
+
+	mRasterTriangles.clear();
+	for(std::vector<uint32_t>& tileTriangleIndices: mTileTriangleIndices)
+	{
+		tileTriangleIndices.clear();
+	}
+
+	for(size_t firstIndex = 0; firstIndex < mOccluderIndices.size(); firstIndex += 3)
+	{
+		DirectX::XMFLOAT4 vertex0 = mPixelSpaceVertices[mOccluderIndices[firstIndex + 0]];
+		DirectX::XMFLOAT4 vertex1 = mPixelSpaceVertices[mOccluderIndices[firstIndex + 1]];
+		DirectX::XMFLOAT4 vertex2 = mPixelSpaceVertices[mOccluderIndices[firstIndex + 2]];
+		if(vertex0.w < MinVertexW || vertex1.w < MinVertexW || vertex2.w < MinVertexW)
+		{
+			continue;
+		}
+
+		//Both windings are rasterized, the occluders don't have to be closed meshes
+		float doubleArea = (vertex1.x - vertex0.x) * (vertex2.y - vertex0.y) - (vertex2.x - vertex0.x) * (vertex1.y - vertex0.y);
+		if(doubleArea == 0.0f)
+		{
+			continue;
+		}
+		else if(doubleArea < 0.0f)
+		{
+			std::swap(vertex1, vertex2);
+			doubleArea = -doubleArea;
+		}
+
+		//Only the pixel centers inside the bounds can be covered
+		float minX = std::min({vertex0.x, vertex1.x, vertex2.x});
+		float minY = std::min({vertex0.y, vertex1.y, vertex2.y});
+		float maxX = std::max({vertex0.x, vertex1.x, vertex2.x});
+		float maxY = std::max({vertex0.y, vertex1.y, vertex2.y});
+		if(maxX < 0.5f || maxY < 0.5f || minX >= (float)DepthBufferWidth - 0.5f || minY >= (float)DepthBufferHeight - 0.5f || std::min({vertex0.z, vertex1.z, vertex2.z}) > 1.0f)
+		{
+			continue;
+		}
+
+		RasterTriangle rasterTriangle;
+		rasterTriangle.MinX = (uint32_t)std::max(minX - 0.5f, 0.0f);
+		rasterTriangle.MinY = (uint32_t)std::max(minY - 0.5f, 0.0f);
+		rasterTriangle.MaxX = std::min((uint32_t)std::max(maxX - 0.5f, 0.0f), DepthBufferWidth  - 1);
+		rasterTriangle.MaxY = std::min((uint32_t)std::max(maxY - 0.5f, 0.0f), DepthBufferHeight - 1);
+
+		const DirectX::XMFLOAT4* triangleVertices[3] = {&vertex0, &vertex1, &vertex2};
+		for(uint32_t edgeIndex = 0; edgeIndex < 3; edgeIndex++)
+		{
+			const DirectX::XMFLOAT4* edgeStart = triangleVertices[edgeIndex];
+			const DirectX::XMFLOAT4* edgeEnd   = triangleVertices[(edgeIndex + 1) % 3];
+
+			rasterTriangle.EdgeA[edgeIndex] = edgeStart->y - edgeEnd->y;
+			rasterTriangle.EdgeB[edgeIndex] = edgeEnd->x   - edgeStart->x;
+			rasterTriangle.EdgeC[edgeIndex] = -(rasterTriangle.EdgeA[edgeIndex] * edgeStart->x + rasterTriangle.EdgeB[edgeIndex] * edgeStart->y);
+		}
+
+		//The depth is linear in pixel space
+		rasterTriangle.DepthDx = ((vertex1.z - vertex0.z) * (vertex2.y - vertex0.y) - (vertex2.z - vertex0.z) * (vertex1.y - vertex0.y)) / doubleArea;
+		rasterTriangle.DepthDy = ((vertex2.z - vertex0.z) * (vertex1.x - vertex0.x) - (vertex1.z - vertex0.z) * (vertex2.x - vertex0.x)) / doubleArea;
+		rasterTriangle.DepthC  = vertex0.z - rasterTriangle.DepthDx * vertex0.x - rasterTriangle.DepthDy * vertex0.y;
+
+		uint32_t rasterTriangleIndex = (uint32_t)mRasterTriangles.size();
+		mRasterTriangles.push_back(rasterTriangle);
+
+		for(uint32_t tileY = rasterTriangle.MinY / TileHeight; tileY <= rasterTriangle.MaxY / TileHeight; tileY++)
+		{
+			for(uint32_t tileX = rasterTriangle.MinX / TileWidth; tileX <= rasterTriangle.MaxX / TileWidth; tileX++)
+			{
+				mTileTriangleIndices[tileY * TileCountX + tileX].push_back(rasterTriangleIndex);
+			}
+		}
+	}
+}
+
+void OcclusionCuller::RasterizeTile(uint32_t tileIndex)
+{
+	uint32_t tileMinX = (tileIndex % TileCountX) * TileWidth;
+	uint32_t tileMinY = (tileIndex / TileCountX) * TileHeight;
+	uint32_t tileMaxX = tileMinX + TileWidth  - 1;
+	uint32_t tileMaxY = tileMinY + TileHeight - 1;
+
+	for(uint32_t y = tileMinY; y <= tileMaxY; y++)
+	{
+		std::fill_n(mDepthBuffer.begin() + (size_t)y * DepthBufferWidth + tileMinX, TileWidth, 1.0f);
+	}
+
+	const DirectX::XMVECTOR pixelCenterOffsets = DirectX::XMVectorSet(0.5f, 1.5f, 2.5f, 3.5f);
+	const DirectX::XMVECTOR zero               = DirectX::XMVectorZero();
+
+	for(uint32_t triangleIndex: mTileTriangleIndices[tileIndex])
+	{
+		const RasterTriangle& triangle = mRasterTriangles[triangleIndex];
+
+		//4 pixels at a time, starting at a multiple of 4. The tile bounds are multiples of 4 too
+		uint32_t rectMinX = std::max(triangle.MinX, tileMinX) & ~3u;
+		uint32_t rectMinY = std::max(triangle.MinY, tileMinY);
+		uint32_t rectMaxX = std::min(triangle.MaxX, tileMaxX);
+		uint32_t rectMaxY = std::min(triangle.MaxY, tileMaxY);
+
+		DirectX::XMVECTOR edgeStepsX[3];
+		DirectX::XMVECTOR edgeRowStarts[3];
+		for(uint32_t edgeIndex = 0; edgeIndex < 3; edgeIndex++)
+		{
+			DirectX::XMVECTOR edgeA = DirectX::XMVectorReplicate(triangle.EdgeA[edgeIndex]);
+
+			edgeStepsX[edgeIndex]    = DirectX::XMVectorScale(edgeA, 4.0f);
+			edgeRowStarts[edgeIndex] = DirectX::XMVectorMultiplyAdd(edgeA, DirectX::XMVectorAdd(DirectX::XMVectorReplicate((float)rectMinX), pixelCenterOffsets), DirectX::XMVectorReplicate(triangle.EdgeC[edgeIndex]));
+		}
+
+		DirectX::XMVECTOR depthDx       = DirectX::XMVectorReplicate(triangle.DepthDx);
+		DirectX::XMVECTOR depthStepX    = DirectX::XMVectorScale(depthDx, 4.0f);
+		DirectX::XMVECTOR depthRowStart = DirectX::XMVectorMultiplyAdd(depthDx, DirectX::XMVectorAdd(DirectX::XMVectorReplicate((float)rectMinX), pixelCenterOffsets), DirectX::XMVectorReplicate(triangle.DepthC));
+
+		for(uint32_t y = rectMinY; y <= rectMaxY; y++)
+		{
+			float pixelCenterY = (float)y + 0.5f;
+
+			DirectX::XMVECTOR edgeValues[3];
+			for(uint32_t edgeIndex = 0; edgeIndex < 3; edgeIndex++)
+			{
+				edgeValues[edgeIndex] = DirectX::XMVectorAdd(edgeRowStarts[edgeIndex], DirectX::XMVectorReplicate(triangle.EdgeB[edgeIndex] * pixelCenterY));
+			}
+
+			DirectX::XMVECTOR depthValues = DirectX::XMVectorAdd(depthRowStart, DirectX::XMVectorReplicate(triangle.DepthDy * pixelCenterY));
+
+			float* depthRow = &mDepthBuffer[(size_t)y * DepthBufferWidth];
+			for(uint32_t x = rectMinX; x <= rectMaxX; x += 4)
+			{
+				DirectX::XMVECTOR insideMask = DirectX::XMVectorGreaterOrEqual(edgeValues[0], zero);
+				insideMask = DirectX::XMVectorAndInt(insideMask, DirectX::XMVectorGreaterOrEqual(edgeValues[1], zero));
+				insideMask = DirectX::XMVectorAndInt(insideMask, DirectX::XMVectorGreaterOrEqual(edgeValues[2], zero));
+
+				DirectX::XMVECTOR oldDepths = DirectX::XMLoadFloat4(reinterpret_cast<const DirectX::XMFLOAT4*>(&depthRow[x]));
+				DirectX::XMVECTOR newDepths = DirectX::XMVectorSelect(oldDepths, DirectX::XMVectorMin(oldDepths, depthValues), insideMask);
+				DirectX::XMStoreFloat4(reinterpret_cast<DirectX::XMFLOAT4*>(&depthRow[x]), newDepths);
+
+				for(uint32_t edgeIndex = 0; edgeIndex < 3; edgeIndex++)
+				{
+					edgeValues[edgeIndex] = DirectX::XMVectorAdd(edgeValues[edgeIndex], edgeStepsX[edgeIndex]);
+				}
+
+				depthValues = DirectX::XMVectorAdd(depthValues, depthStepX);
+			}
+		}
+	}
+
+	float tileMaxDepth = 0.0f;
+	for(uint32_t y = tileMinY; y <= tileMaxY; y++)
+	{
+		const float* depthRow = &mDepthBuffer[(size_t)y * DepthBufferWidth];
+		tileMaxDepth = std::max(tileMaxDepth, *std::max_element(depthRow + tileMinX, depthRow + tileMaxX + 1));
+	}
+
+	mTileMaxDepths[tileIndex] = tileMaxDepth;
+}
\ No newline at end of file
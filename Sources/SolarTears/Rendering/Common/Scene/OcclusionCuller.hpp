@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <span>
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+#include "RenderableSceneMisc.hpp"
+
+class ThreadPool;
+
+//Rasterizes the occluder triangles into a small depth buffer on the CPU and tests bounding boxes against it.
+//The depth buffer is split into tiles, each tile is rasterized by its own thread pool job 4 pixels at a time.
+//The occluders are sampled at the pixel centers, so a pixel an occluder covers only partially still counts as covered
+class OcclusionCuller
+{
+public:
+	static constexpr uint32_t DepthBufferWidth  = 256;
+	static constexpr uint32_t DepthBufferHeight = 128;
+
+private:
+	static constexpr uint32_t TileWidth  = 64; //Has to be a multiple of 4
+	static constexpr uint32_t TileHeight = 32;
+	static constexpr uint32_t TileCountX = DepthBufferWidth  / TileWidth;
+	static constexpr uint32_t TileCountY = DepthBufferHeight / TileHeight;
+
+	static_assert(TileWidth % 4 == 0 && DepthBufferWidth % TileWidth == 0 && DepthBufferHeight % TileHeight == 0);
+
+	//The triangles crossing the near plane are not clipped, they are skipped
+	static constexpr float MinVertexW = 1e-4f;
+
+	//The edge functions and the depth plane of a triangle in depth buffer pixel space.
+	//A pixel center (x, y) is inside if all EdgeA * x + EdgeB * y + EdgeC are non-negative
+	struct RasterTriangle
+	{
+		float EdgeA[3];
+		float EdgeB[3];
+		float EdgeC[3];
+
+		float DepthC;
+		float DepthDx;
+		float DepthDy;
+
+		uint32_t MinX;
+		uint32_t MinY;
+		uint32_t MaxX;
+		uint32_t MaxY;
+	};
+
+public:
+	OcclusionCuller();
+	~OcclusionCuller();
+
+	void ClearOccluders();
+
+	//Adds the triangles of an occluder mesh. The vertex positions are transformed with worldMatrix
+	void AddOccluder(std::span<const RenderableSceneVertex> vertices, std::span<const RenderableSceneIndex> indices, DirectX::FXMMATRIX worldMatrix);
+
+	//Adds the triangles already transformed to world space, such as the ones from GetOccluderVertices() and GetOccluderIndices() of another culler
+	void AddWorldSpaceOccluders(std::span<const DirectX::XMFLOAT3> vertices, std::span<const uint32_t> indices);
+
+	//Rasterizes all occluders as seen with viewProjMatrix. The tiles are split between the thread pool workers, threadPool can be nullptr
+	void RenderOccluders(ThreadPool* threadPool, DirectX::FXMMATRIX viewProjMatrix);
+
+	//False if the box is entirely behind the occluders rendered by the last RenderOccluders() call.
+	//The boxes crossing the near plane are always visible, the boxes partially off screen are tested by their on-screen part
+	bool IsBoxVisible(const DirectX::BoundingBox& box) const;
+
+	uint32_t GetOccluderTriangleCount() const;
+
+	//The world space triangles of all added occluders
+	std::span<const DirectX::XMFLOAT3> GetOccluderVertices() const;
+	std::span<const uint32_t>          GetOccluderIndices()  const;
+
+private:
+	//Transforms the vertices to pixel space and bins the triangles to the tiles they overlap
+	void SetupTriangles(DirectX::FXMMATRIX viewProjMatrix);
+
+	void RasterizeTile(uint32_t tileIndex);
+
+private:
+	std::vector<DirectX::XMFLOAT3> mOccluderVertices; //In world space
+	std::vector<uint32_t>          mOccluderIndices;
+
+	std::vector<DirectX::XMFLOAT4> mPixelSpaceVertices; //Pixel x, pixel y, depth, clip space w
+	std::vector<RasterTriangle>    mRasterTriangles;
+	std::vector<uint32_t>          mTileTriangleIndices[TileCountX * TileCountY];
+
+	std::vector<float> mDepthBuffer;                            //The nearest occluder depth of each pixel, 1.0 if there is none
+	float              mTileMaxDepths[TileCountX * TileCountY]; //The farthest depth in each tile, for early outs
+
+	DirectX::XMFLOAT4X4 mViewProjMatrix;
+};
\ No newline at end of file
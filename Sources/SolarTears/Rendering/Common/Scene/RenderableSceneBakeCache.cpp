@@ -0,0 +1,214 @@
+#include "RenderableSceneBakeCache.hpp"
+#include <fstream>
+#include <cstring>
+#include <cassert>
+
+namespace
+{
+	uint64_t HashGeometry(std::span<const RenderableSceneVertex> vertices, std::span<const RenderableSceneIndex> indices, uint32_t maxLodCount)
+	{
+		uint64_t geometryHash = RenderableSceneBakeCache::InitialHash;
+		geometryHash = RenderableSceneBakeCache::HashBytes(geometryHash, std::as_bytes(vertices));
+		geometryHash = RenderableSceneBakeCache::HashBytes(geometryHash, std::as_bytes(indices));
+		geometryHash = RenderableSceneBakeCache::HashBytes(geometryHash, std::as_bytes(std::span(&maxLodCount, 1)));
+
+		return geometryHash;
+	}
+}
+
+uint64_t RenderableSceneBakeCache::HashBytes(uint64_t hash, std::span<const std::byte> bytes)
+{
+	constexpr uint64_t fnvPrime = 0x100000001b3ull;
+
+	size_t byteIndex = 0;
+	for(; byteIndex + sizeof(uint64_t) <= bytes.size(); byteIndex += sizeof(uint64_t))
+	{
+		uint64_t word = 0;
+		memcpy(&word, bytes.data() + byteIndex, sizeof(uint64_t));
+
+		hash = (hash ^ word) * fnvPrime;
+	}
+
+	for(; byteIndex < bytes.size(); byteIndex++)
+	{
+		hash = (hash ^ (uint64_t)bytes[byteIndex]) * fnvPrime;
+	}
+
+	return hash;
+}
+
+RenderableSceneBakeCache::RenderableSceneBakeCache(): mBakeIndex(0)
+{
+	mLastBakeStats = BakeStats
+	{
+		.GeometryHits             = 0,
+		.GeometryMisses           = 0,
+		.SimplifiedGeometryHits   = 0,
+		.SimplifiedGeometryMisses = 0,
+		.TextureFileHits          = 0,
+		.TextureFileMisses        = 0
+	};
+}
+
+RenderableSceneBakeCache::~RenderableSceneBakeCache()
+{
+}
+
+void RenderableSceneBakeCache::BeginBake()
+{
+	mBakeIndex++;
+
+	mLastBakeStats = BakeStats
+	{
+		.GeometryHits             = 0,
+		.GeometryMisses           = 0,
+		.SimplifiedGeometryHits   = 0,
+		.SimplifiedGeometryMisses = 0,
+		.TextureFileHits          = 0,
+		.TextureFileMisses        = 0
+	};
+}
+
+void RenderableSceneBakeCache::EndBake()
+{
+	std::erase_if(mGeometries, [this](const auto& geometry)
+	{
+		return geometry.second.LastUsedBakeIndex != mBakeIndex;
+	});
+
+	std::erase_if(mSimplifiedGeometries, [this](const auto& simplifiedGeometry)
+	{
+		return simplifiedGeometry.second.LastUsedBakeIndex != mBakeIndex;
+	});
+
+	std::erase_if(mTextureFiles, [this](const auto& textureFile)
+	{
+		return textureFile.second.LastUsedBakeIndex != mBakeIndex;
+	});
+}
+
+const RenderableSceneBakeCache::CachedGeometry& RenderableSceneBakeCache::GetGeometry(const RenderableSceneGeometryData& geometryData, uint32_t maxLodCount)
+{
+	//The levels of detail of the description are used as is, only the geometries without them depend on maxLodCount
+	uint32_t generatedLodCount = geometryData.LodIndices.empty() ? maxLodCount : 0;
+	uint64_t geometryHash      = HashGeometry(geometryData.Vertices, geometryData.Indices, generatedLodCount);
+
+	//The sizes make an accidental hash collision even less likely
+	auto [geometryIt, newGeometry] = mGeometries.try_emplace(geometryHash);
+	GeometryEntry& geometryEntry = geometryIt->second;
+	if(!newGeometry && geometryEntry.VertexCount == geometryData.Vertices.size() && geometryEntry.IndexCount == geometryData.Indices.size())
+	{
+		geometryEntry.LastUsedBakeIndex = mBakeIndex;
+
+		mLastBakeStats.GeometryHits++;
+		return geometryEntry.Geometry;
+	}
+
+	geometryEntry.VertexCount       = geometryData.Vertices.size();
+	geometryEntry.IndexCount        = geometryData.Indices.size();
+	geometryEntry.LastUsedBakeIndex = mBakeIndex;
+
+	geometryEntry.Geometry.LocalBoundingSphere = DirectX::BoundingSphere(DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f), 0.0f);
+	if(!geometryData.Vertices.empty())
+	{
+		DirectX::BoundingSphere::CreateFromPoints(geometryEntry.Geometry.LocalBoundingSphere, geometryData.Vertices.size(), &geometryData.Vertices[0].Position, sizeof(RenderableSceneVertex));
+	}
+
+	geometryEntry.Geometry.GeneratedLodIndices.clear();
+	mMeshSimplifier.GenerateLods(geometryData.Vertices, geometryData.Indices, generatedLodCount, geometryEntry.Geometry.GeneratedLodIndices);
+
+	mLastBakeStats.GeometryMisses++;
+	return geometryEntry.Geometry;
+}
+
+const std::vector<std::vector<RenderableSceneIndex>>& RenderableSceneBakeCache::GenerateLods(std::span<const RenderableSceneVertex> vertices, std::span<const RenderableSceneIndex> indices, uint32_t maxLodCount)
+{
+	uint64_t geometryHash = HashGeometry(vertices, indices, maxLodCount);
+
+	//The sizes make an accidental hash collision even less likely
+	auto [geometryIt, newGeometry] = mSimplifiedGeometries.try_emplace(geometryHash);
+	SimplifiedGeometryEntry& geometryEntry = geometryIt->second;
+	if(!newGeometry && geometryEntry.VertexCount == vertices.size() && geometryEntry.IndexCount == indices.size() && geometryEntry.MaxLodCount == maxLodCount)
+	{
+		geometryEntry.LastUsedBakeIndex = mBakeIndex;
+
+		mLastBakeStats.SimplifiedGeometryHits++;
+		return geometryEntry.LodIndices;
+	}
+
+	geometryEntry.VertexCount       = vertices.size();
+	geometryEntry.IndexCount        = indices.size();
+	geometryEntry.MaxLodCount       = maxLodCount;
+	geometryEntry.LastUsedBakeIndex = mBakeIndex;
+
+	geometryEntry.LodIndices.clear();
+	mMeshSimplifier.GenerateLods(vertices, indices, maxLodCount, geometryEntry.LodIndices);
+
+	mLastBakeStats.SimplifiedGeometryMisses++;
+	return geometryEntry.LodIndices;
+}
+
+std::span<const std::byte> RenderableSceneBakeCache::ReadTextureFile(const std::wstring& textureFilename)
+{
+	std::filesystem::path textureFilePath(textureFilename);
+
+	std::error_code fileError;
+	std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(textureFilePath, fileError);
+	uintmax_t                       fileSize  = std::filesystem::file_size(textureFilePath, fileError);
+	if(fileError)
+	{
+		mTextureFiles.erase(textureFilename);
+		return std::span<const std::byte>();
+	}
+
+	auto [textureIt, newTexture] = mTextureFiles.try_emplace(textureFilename);
+	TextureFileEntry& textureEntry = textureIt->second;
+	textureEntry.LastUsedBakeIndex = mBakeIndex;
+	if(!newTexture && textureEntry.WriteTime == writeTime && textureEntry.FileSize == fileSize)
+	{
+		mLastBakeStats.TextureFileHits++;
+		return textureEntry.FileData;
+	}
+
+	mLastBakeStats.TextureFileMisses++;
+
+	textureEntry.WriteTime = writeTime;
+	textureEntry.FileSize  = fileSize;
+	textureEntry.FileData.resize((size_t)fileSize);
+
+	std::ifstream fin(textureFilePath, std::ios::binary);
+	fin.read(reinterpret_cast<char*>(textureEntry.FileData.data()), (std::streamsize)textureEntry.FileData.size());
+	if(!fin)
+	{
+		mTextureFiles.erase(textureIt);
+		return std::span<const std::byte>();
+	}
+
+	textureEntry.ContentHash = HashBytes(InitialHash, textureEntry.FileData);
+	return textureEntry.FileData;
+}
+
+uint64_t RenderableSceneBakeCache::GetTextureFileHash(const std::wstring& textureFilename) const
+{
+	auto textureIt = mTextureFiles.find(textureFilename);
+	assert(textureIt != mTextureFiles.end());
+
+	return textureIt->second.ContentHash;
+}
+
+size_t RenderableSceneBakeCache::DropTextureFiles()
+{
+	size_t droppedByteCount = 0;
+	for(const auto& textureFile: mTextureFiles)
+	{
+		droppedByteCount += textureFile.second.FileData.size();
+	}
+
+	mTextureFiles.clear();
+	return droppedByteCount;
+}
+
+const RenderableSceneBakeCache::BakeStats& RenderableSceneBakeCache::GetLastBakeStats() const
+{
+	return mLastBakeStats;
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <filesystem>
+#include <DirectXCollision.h>
+#include "MeshSimplifier.hpp"
+#include "RenderableSceneDescriptionMisc.hpp"
+
+//CPU-side cache of the expensive intermediate results of a scene bake, for the next bakes of the same, slightly edited scene.
+//The data computed from the geometries is found by the content hash of the geometry, so renaming the geometry or using it in other meshes doesn't invalidate it.
+//The texture files are kept in memory and only read again once their size or write time changes.
+//The entries not used by the last bake are dropped at its end.
+//The device side is handled by ModernRenderableSceneBuilder, which patches the previous scene instead of creating new buffers and textures if it can
+class RenderableSceneBakeCache
+{
+public:
+	struct CachedGeometry
+	{
+		DirectX::BoundingSphere LocalBoundingSphere;
+
+		//Empty if the geometry has its own levels of detail
+		std::vector<std::vector<RenderableSceneIndex>> GeneratedLodIndices;
+	};
+
+private:
+	struct GeometryEntry
+	{
+		uint64_t VertexCount;
+		uint64_t IndexCount;
+		uint32_t LastUsedBakeIndex;
+
+		CachedGeometry Geometry;
+	};
+
+	struct SimplifiedGeometryEntry
+	{
+		uint64_t VertexCount;
+		uint64_t IndexCount;
+		uint32_t MaxLodCount;
+		uint32_t LastUsedBakeIndex;
+
+		std::vector<std::vector<RenderableSceneIndex>> LodIndices;
+	};
+
+	struct TextureFileEntry
+	{
+		std::filesystem::file_time_type WriteTime;
+		uintmax_t                       FileSize;
+		uint64_t                        ContentHash;
+		uint32_t                        LastUsedBakeIndex;
+
+		std::vector<std::byte> FileData;
+	};
+
+public:
+	struct BakeStats
+	{
+		uint32_t GeometryHits;
+		uint32_t GeometryMisses;
+		uint32_t SimplifiedGeometryHits;
+		uint32_t SimplifiedGeometryMisses;
+		uint32_t TextureFileHits;
+		uint32_t TextureFileMisses;
+	};
+
+public:
+	//FNV-1a over 8-byte words instead of single bytes, the geometry data is large and hashed on every bake. Also used for the scene cache files
+	static constexpr uint64_t InitialHash = 0xcbf29ce484222325ull;
+	static uint64_t HashBytes(uint64_t hash, std::span<const std::byte> bytes);
+
+public:
+	RenderableSceneBakeCache();
+	~RenderableSceneBakeCache();
+
+	void BeginBake();
+	void EndBake();
+
+	//Computes the bounding sphere and the missing levels of detail of the geometry, or finds them if the same geometry was seen before.
+	//The returned reference stays valid until EndBake()
+	const CachedGeometry& GetGeometry(const RenderableSceneGeometryData& geometryData, uint32_t maxLodCount);
+
+	//Same as MeshSimplifier::GenerateLods(), but only runs the simplification for the geometry not seen before.
+	//The returned reference stays valid until EndBake()
+	const std::vector<std::vector<RenderableSceneIndex>>& GenerateLods(std::span<const RenderableSceneVertex> vertices, std::span<const RenderableSceneIndex> indices, uint32_t maxLodCount);
+
+	//Returns the contents of the file, or an empty span if it can't be read. The returned span stays valid until EndBake()
+	std::span<const std::byte> ReadTextureFile(const std::wstring& textureFilename);
+
+	//The hash of the contents returned by the last ReadTextureFile() call for the file. The file is hashed once per change
+	uint64_t GetTextureFileHash(const std::wstring& textureFilename) const;
+
+	//Releases the kept texture file contents, the next bake reads the files again. Returns the number of bytes freed.
+	//Meant for memory pressure, shouldn't be called during a bake
+	size_t DropTextureFiles();
+
+	const BakeStats& GetLastBakeStats() const;
+
+private:
+	MeshSimplifier mMeshSimplifier;
+
+	std::unordered_map<uint64_t, GeometryEntry>           mGeometries;
+	std::unordered_map<uint64_t, SimplifiedGeometryEntry> mSimplifiedGeometries;
+	std::unordered_map<std::wstring, TextureFileEntry>    mTextureFiles;
+
+	uint32_t  mBakeIndex;
+	BakeStats mLastBakeStats;
+};
\ No newline at end of file
@@ -0,0 +1,248 @@
+#include "RenderableSceneCacheFile.hpp"
+#include "RenderableSceneBakeCache.hpp"
+#include "../RenderingUtils.hpp"
+#include <vector>
+#include <fstream>
+#include <filesystem>
+#include <cassert>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+RenderableSceneCacheFile::RenderableSceneCacheFile()
+{
+#ifdef _WIN32
+	mFileHandle    = nullptr;
+	mMappingHandle = nullptr;
+#else
+	mFileDescriptor = -1;
+#endif
+
+	mMappedData = nullptr;
+	mMappedSize = 0;
+}
+
+RenderableSceneCacheFile::~RenderableSceneCacheFile()
+{
+	Close();
+}
+
+bool RenderableSceneCacheFile::Open(const std::wstring& filename, uint32_t contentVersion, uint64_t contentKey, uint32_t sectionCount)
+{
+	Close();
+
+	std::filesystem::path filePath(filename);
+
+#ifdef _WIN32
+	mFileHandle = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if(mFileHandle == INVALID_HANDLE_VALUE)
+	{
+		mFileHandle = nullptr;
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if(!GetFileSizeEx(mFileHandle, &fileSize) || fileSize.QuadPart < (LONGLONG)sizeof(FileHeader))
+	{
+		Close();
+		return false;
+	}
+
+	mMappingHandle = CreateFileMappingW(mFileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if(mMappingHandle == nullptr)
+	{
+		Close();
+		return false;
+	}
+
+	mMappedData = reinterpret_cast<const std::byte*>(MapViewOfFile(mMappingHandle, FILE_MAP_READ, 0, 0, 0));
+	mMappedSize = (size_t)fileSize.QuadPart;
+#else
+	mFileDescriptor = open(filePath.c_str(), O_RDONLY);
+	if(mFileDescriptor < 0)
+	{
+		return false;
+	}
+
+	struct stat fileStat;
+	if(fstat(mFileDescriptor, &fileStat) != 0 || fileStat.st_size < (off_t)sizeof(FileHeader))
+	{
+		Close();
+		return false;
+	}
+
+	void* mappedData = mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, mFileDescriptor, 0);
+	if(mappedData != MAP_FAILED)
+	{
+		//The whole file is read right away for the checksum and the upload
+		madvise(mappedData, (size_t)fileStat.st_size, MADV_WILLNEED);
+
+		mMappedData = reinterpret_cast<const std::byte*>(mappedData);
+		mMappedSize = (size_t)fileStat.st_size;
+	}
+#endif
+
+	if(mMappedData == nullptr)
+	{
+		Close();
+		return false;
+	}
+
+	const FileHeader* header = reinterpret_cast<const FileHeader*>(mMappedData);
+	if(header->Magic != FileMagic || header->FormatVersion != FormatVersion || header->ContentVersion != contentVersion || header->ContentKey != contentKey || header->SectionCount != sectionCount)
+	{
+		Close();
+		return false;
+	}
+
+	if(mMappedSize < sizeof(FileHeader) + sectionCount * sizeof(SectionRange))
+	{
+		Close();
+		return false;
+	}
+
+	mSectionTable = std::span(reinterpret_cast<const SectionRange*>(mMappedData + sizeof(FileHeader)), sectionCount);
+
+	std::vector<std::span<const std::byte>> sections(sectionCount);
+	for(uint32_t sectionIndex = 0; sectionIndex < sectionCount; sectionIndex++)
+	{
+		const SectionRange& sectionRange = mSectionTable[sectionIndex];
+		if(sectionRange.Offset % SectionAlignment != 0 || sectionRange.Offset > mMappedSize || sectionRange.Size > mMappedSize - sectionRange.Offset)
+		{
+			Close();
+			return false;
+		}
+
+		sections[sectionIndex] = std::span(mMappedData + sectionRange.Offset, (size_t)sectionRange.Size);
+	}
+
+	if(CalculateChecksum(mSectionTable, sections) != header->Checksum)
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void RenderableSceneCacheFile::Close()
+{
+	mSectionTable = std::span<const SectionRange>();
+
+#ifdef _WIN32
+	if(mMappedData != nullptr)
+	{
+		UnmapViewOfFile(mMappedData);
+		mMappedData = nullptr;
+	}
+
+	if(mMappingHandle != nullptr)
+	{
+		CloseHandle(mMappingHandle);
+		mMappingHandle = nullptr;
+	}
+
+	if(mFileHandle != nullptr)
+	{
+		CloseHandle(mFileHandle);
+		mFileHandle = nullptr;
+	}
+#else
+	if(mMappedData != nullptr)
+	{
+		munmap(const_cast<std::byte*>(mMappedData), mMappedSize);
+		mMappedData = nullptr;
+	}
+
+	if(mFileDescriptor >= 0)
+	{
+		close(mFileDescriptor);
+		mFileDescriptor = -1;
+	}
+#endif
+
+	mMappedSize = 0;
+}
+
+std::span<const std::byte> RenderableSceneCacheFile::GetSection(uint32_t sectionIndex) const
+{
+	assert(sectionIndex < mSectionTable.size());
+
+	const SectionRange& sectionRange = mSectionTable[sectionIndex];
+	return std::span(mMappedData + sectionRange.Offset, (size_t)sectionRange.Size);
+}
+
+bool RenderableSceneCacheFile::Write(const std::wstring& filename, uint32_t contentVersion, uint64_t contentKey, std::span<const std::span<const std::byte>> sections)
+{
+	std::vector<SectionRange> sectionTable(sections.size());
+
+	uint64_t fileSize = sizeof(FileHeader) + sections.size() * sizeof(SectionRange);
+	for(size_t sectionIndex = 0; sectionIndex < sections.size(); sectionIndex++)
+	{
+		fileSize = Utils::AlignMemory(fileSize, SectionAlignment);
+
+		sectionTable[sectionIndex].Offset = fileSize;
+		sectionTable[sectionIndex].Size   = sections[sectionIndex].size();
+
+		fileSize += sections[sectionIndex].size();
+	}
+
+	FileHeader header =
+	{
+		.Magic          = FileMagic,
+		.FormatVersion  = FormatVersion,
+		.ContentVersion = contentVersion,
+		.SectionCount   = (uint32_t)sections.size(),
+		.ContentKey     = contentKey,
+		.Checksum       = CalculateChecksum(sectionTable, sections)
+	};
+
+	std::filesystem::path filePath(filename);
+	std::filesystem::path tempFilePath = filePath;
+	tempFilePath += L".tmp";
+
+	bool fileWritten = false;
+	{
+		std::ofstream fout(tempFilePath, std::ios::binary | std::ios::trunc);
+		fout.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+		fout.write(reinterpret_cast<const char*>(sectionTable.data()), (std::streamsize)(sectionTable.size() * sizeof(SectionRange)));
+
+		const char padding[SectionAlignment] = {0};
+		for(size_t sectionIndex = 0; sectionIndex < sections.size(); sectionIndex++)
+		{
+			uint64_t paddingSize = sectionTable[sectionIndex].Offset - (uint64_t)fout.tellp();
+			fout.write(padding, (std::streamsize)paddingSize);
+			fout.write(reinterpret_cast<const char*>(sections[sectionIndex].data()), (std::streamsize)sections[sectionIndex].size());
+		}
+
+		fout.close();
+		fileWritten = !fout.fail();
+	}
+
+	std::error_code fileError;
+	if(!fileWritten)
+	{
+		std::filesystem::remove(tempFilePath, fileError);
+		return false;
+	}
+
+	std::filesystem::rename(tempFilePath, filePath, fileError);
+	return !fileError;
+}
+
+uint64_t RenderableSceneCacheFile::CalculateChecksum(std::span<const SectionRange> sectionTable, std::span<const std::span<const std::byte>> sections)
+{
+	uint64_t checksum = RenderableSceneBakeCache::HashBytes(RenderableSceneBakeCache::InitialHash, std::as_bytes(sectionTable));
+	for(std::span<const std::byte> section: sections)
+	{
+		checksum = RenderableSceneBakeCache::HashBytes(checksum, section);
+	}
+
+	return checksum;
+}
\ No newline at end of file
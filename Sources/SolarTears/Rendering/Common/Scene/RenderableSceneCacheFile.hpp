@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <string>
+
+//A file of untyped data sections, written after a scene bake and mapped to memory on the next launches.
+//The header keeps the format version, the version of the section contents, the key of the data the sections were made from and the checksum of the sections.
+//Opening the file fails if any of them doesn't match, the caller is expected to build the data again and rewrite the file
+class RenderableSceneCacheFile
+{
+	static constexpr uint32_t FileMagic        = 0x43535453; //"STSC"
+	static constexpr uint32_t FormatVersion    = 1;
+	static constexpr uint64_t SectionAlignment = 64;
+
+	struct FileHeader
+	{
+		uint32_t Magic;
+		uint32_t FormatVersion;
+		uint32_t ContentVersion;
+		uint32_t SectionCount;
+		uint64_t ContentKey;
+		uint64_t Checksum; //Of the section table and the section data, without the alignment padding
+	};
+
+	struct SectionRange
+	{
+		uint64_t Offset; //From the start of the file
+		uint64_t Size;
+	};
+
+public:
+	RenderableSceneCacheFile();
+	~RenderableSceneCacheFile();
+
+	//Maps the file to memory and checks it. Returns false if the file can't be opened, is damaged, or was written with a different content version, key or section count
+	bool Open(const std::wstring& filename, uint32_t contentVersion, uint64_t contentKey, uint32_t sectionCount);
+	void Close();
+
+	//The mapped section data, valid until Close(). Each section starts at an aligned offset, so it can be read as an array of any type
+	std::span<const std::byte> GetSection(uint32_t sectionIndex) const;
+
+	//Writes the sections to a temporary file first and replaces the old file with it, so the file is never left half-written
+	static bool Write(const std::wstring& filename, uint32_t contentVersion, uint64_t contentKey, std::span<const std::span<const std::byte>> sections);
+
+private:
+	static uint64_t CalculateChecksum(std::span<const SectionRange> sectionTable, std::span<const std::span<const std::byte>> sections);
+
+private:
+#ifdef _WIN32
+	void* mFileHandle;
+	void* mMappingHandle;
+#else
+	int mFileDescriptor;
+#endif
+
+	const std::byte* mMappedData;
+	size_t           mMappedSize;
+
+	std::span<const SectionRange> mSectionTable;
+};
\ No newline at end of file
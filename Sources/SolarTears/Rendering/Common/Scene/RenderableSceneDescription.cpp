@@ -1,7 +1,9 @@
 #include "RenderableSceneDescription.hpp"
+#include <cassert>
 
 RenderableSceneDescription::RenderableSceneDescription()
 {
+	mDynamicObjectCapacity = 0;
 }
 
 RenderableSceneDescription::~RenderableSceneDescription()
@@ -26,7 +28,10 @@ void RenderableSceneDescription::AddMesh(const std::string& name)
 	mSceneMeshes[name] = RenderableSceneMeshData
 	{
 		.Submeshes = {},
-		.MeshFlags = 0
+		.MeshFlags = 0,
+
+		.FirstInstanceIndex = 0,
+		.InstanceCount      = 0
 	};
 }
 
@@ -40,7 +45,50 @@ void RenderableSceneDescription::MarkMeshAsNonStatic(const std::string& name)
 	mSceneMeshes.at(name).MeshFlags |= (uint32_t)(RenderableSceneMeshFlags::NonStatic);
 }
 
+void RenderableSceneDescription::AddMeshInstances(const std::string& meshName, std::span<const SceneObjectLocation> instanceLocations)
+{
+	RenderableSceneMeshData& meshData = mSceneMeshes.at(meshName);
+	assert(meshData.InstanceCount == 0);
+
+	meshData.FirstInstanceIndex = (uint32_t)mMeshInstanceLocations.size();
+	meshData.InstanceCount      = (uint32_t)instanceLocations.size();
+
+	mMeshInstanceLocations.insert(mMeshInstanceLocations.end(), instanceLocations.begin(), instanceLocations.end());
+}
+
+void RenderableSceneDescription::MarkMeshAsOccluder(const std::string& name)
+{
+	mSceneMeshes.at(name).MeshFlags |= (uint32_t)(RenderableSceneMeshFlags::Occluder);
+}
+
+void RenderableSceneDescription::AddTextureData(const std::wstring& name, std::vector<std::byte>&& ddsData)
+{
+	assert(!mSceneTextureData.contains(name));
+	mSceneTextureData[name] = std::move(ddsData);
+}
+
+void RenderableSceneDescription::ReserveMeshes(size_t meshCount)
+{
+	mSceneMeshes.reserve(meshCount);
+}
+
+void RenderableSceneDescription::ReserveMeshInstances(size_t instanceCount)
+{
+	mMeshInstanceLocations.reserve(mMeshInstanceLocations.size() + instanceCount);
+}
+
+void RenderableSceneDescription::ReserveDynamicObjects(uint32_t objectCount)
+{
+	mDynamicObjectCapacity = objectCount;
+}
+
 bool RenderableSceneDescription::IsMeshStatic(const std::string& meshName)
 {
 	return !(mSceneMeshes.at(meshName).MeshFlags & (uint32_t)RenderableSceneMeshFlags::NonStatic);
+}
+
+std::span<const SceneObjectLocation> RenderableSceneDescription::GetMeshInstanceLocations(const std::string& meshName) const
+{
+	const RenderableSceneMeshData& meshData = mSceneMeshes.at(meshName);
+	return std::span(mMeshInstanceLocations).subspan(meshData.FirstInstanceIndex, meshData.InstanceCount);
 }
\ No newline at end of file
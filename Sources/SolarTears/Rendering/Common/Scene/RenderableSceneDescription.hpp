@@ -4,6 +4,8 @@
 #include <string>
 #include <unordered_set>
 #include <unordered_map>
+#include <span>
+#include <cstddef>
 #include "RenderableSceneDescriptionMisc.hpp"
 
 class RenderableSceneDescription
@@ -22,12 +24,40 @@ public:
 
 	void MarkMeshAsNonStatic(const std::string& name);
 
+	//Draws the mesh once for each location, instead of once at the location of the scene object with the same name.
+	//The instances get consecutive object handles, starting from the one the mesh name maps to. Can only be called once per mesh
+	void AddMeshInstances(const std::string& meshName, std::span<const SceneObjectLocation> instanceLocations);
+
+	//The occluder meshes hide the meshes behind them during the culling. Only the static meshes are used as occluders
+	void MarkMeshAsOccluder(const std::string& name);
+
+	//Registers the contents of a DDS file generated in memory. Materials refer to it by name the same way as to texture files
+	void AddTextureData(const std::wstring& name, std::vector<std::byte>&& ddsData);
+
+	//Avoids rehashing when adding a lot of meshes
+	void ReserveMeshes(size_t meshCount);
+
+	//Avoids reallocations when adding a lot of mesh instances
+	void ReserveMeshInstances(size_t instanceCount);
+
+	//The baked scene gets this many slots for the objects added and removed at runtime with BaseRenderableScene::AddObject() and RemoveObject()
+	void ReserveDynamicObjects(uint32_t objectCount);
+
 public:
 	bool IsMeshStatic(const std::string& meshName);
 
+	std::span<const SceneObjectLocation> GetMeshInstanceLocations(const std::string& meshName) const;
+
 protected:
 	std::unordered_map<std::string, RenderableSceneMeshData> mSceneMeshes;
 
 	std::unordered_map<std::string, RenderableSceneGeometryData> mSceneGeometries;
 	std::unordered_map<std::string, RenderableSceneMaterialData> mSceneMaterials;
+
+	std::unordered_map<std::wstring, std::vector<std::byte>> mSceneTextureData;
+
+	//The locations of all mesh instances, contiguous for each mesh
+	std::vector<SceneObjectLocation> mMeshInstanceLocations;
+
+	uint32_t mDynamicObjectCapacity;
 };
\ No newline at end of file
@@ -5,6 +5,7 @@
 enum class RenderableSceneMeshFlags: uint32_t
 {
 	NonStatic = 0x01,
+	Occluder  = 0x02,
 };
 
 struct RenderableSceneMaterialData
@@ -17,6 +18,9 @@ struct RenderableSceneGeometryData
 {
 	std::vector<RenderableSceneVertex> Vertices;
 	std::vector<RenderableSceneIndex>  Indices;
+
+	//The coarser levels of detail, from finer to coarser. They index the same vertices. Generated when the scene is built if empty
+	std::vector<std::vector<RenderableSceneIndex>> LodIndices;
 };
 
 struct RenderableSceneSubmeshData
@@ -29,4 +33,8 @@ struct RenderableSceneMeshData
 {
 	std::vector<RenderableSceneSubmeshData> Submeshes;
 	uint32_t                                MeshFlags;
+
+	//The range of the instance locations, for the meshes drawn several times with RenderableSceneDescription::AddMeshInstances()
+	uint32_t FirstInstanceIndex;
+	uint32_t InstanceCount;
 };
\ No newline at end of file
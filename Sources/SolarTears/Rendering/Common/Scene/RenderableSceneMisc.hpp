@@ -3,11 +3,33 @@
 #include <cstdint>
 #include <string>
 #include <vector>
+#include <span>
 #include <DirectXMath.h>
 #include "../../../Core/Scene/SceneObjectLocation.hpp"
 
+//The object data index in the low bits and the generation of the object slot in the high bits. The generation changes each time the slot is freed,
+//so the handles of the removed objects never refer to the objects that take their slots. The objects created when the scene is baked have generation 0
 using RenderableSceneObjectHandle = uint32_t;
 
+constexpr uint32_t                    RenderableObjectIndexBitCount = 24;
+constexpr uint32_t                    RenderableObjectIndexMask     = (1u << RenderableObjectIndexBitCount) - 1;
+constexpr RenderableSceneObjectHandle InvalidRenderableObjectHandle = (uint32_t)(-1);
+
+inline RenderableSceneObjectHandle MakeRenderableObjectHandle(uint32_t objectIndex, uint32_t generation)
+{
+	return (generation << RenderableObjectIndexBitCount) | (objectIndex & RenderableObjectIndexMask);
+}
+
+inline uint32_t GetRenderableObjectIndex(RenderableSceneObjectHandle objectHandle)
+{
+	return objectHandle & RenderableObjectIndexMask;
+}
+
+inline uint32_t GetRenderableObjectGeneration(RenderableSceneObjectHandle objectHandle)
+{
+	return objectHandle >> RenderableObjectIndexBitCount;
+}
+
 
 struct RenderableSceneVertex
 {
@@ -32,6 +54,15 @@ struct ObjectDataUpdateInfo
 	SceneObjectLocation         NewObjectLocation;
 };
 
+//The same updates as separate arrays of the same size, for the systems that keep the locations that way
+struct ObjectDataUpdateBatch
+{
+	std::span<const RenderableSceneObjectHandle> ObjectIds;
+	std::span<const DirectX::XMFLOAT3>           Positions;
+	std::span<const DirectX::XMFLOAT4>           RotationQuaternions;
+	std::span<const float>                       Scales;
+};
+
 struct FrameDataUpdateInfo
 {
 	SceneObjectLocation CameraLocation;
@@ -10,6 +10,8 @@
 #include "FrameGraph/D3D12FrameGraphBuilder.hpp"
 #include "../../Core/ThreadPool.hpp"
 #include "../Common/RenderingUtils.hpp"
+#include "../Common/PerformanceHud.hpp"
+#include "../Common/FrameLatency.hpp"
 
 #include "FrameGraph/Passes/D3D12GBufferPass.hpp"
 #include "FrameGraph/Passes/D3D12CopyImagePass.hpp"
@@ -60,8 +62,14 @@ BaseRenderableScene* D3D12::Renderer::InitScene(const RenderableSceneDescription
 {
 	mDeviceQueues->AllQueuesWaitStrong();
 
+	//The edited scene reuses the buffers and textures of the previous one if it can
+	std::unique_ptr<D3D12::RenderableScene> previousScene = std::move(mScene);
+
 	mScene = std::make_unique<D3D12::RenderableScene>();
 	D3D12::RenderableSceneBuilder sceneBuilder(mDevice.get(), mScene.get(), mMemoryAllocator.get(), mDeviceQueues.get(), mWorkerCommandLists.get());
+	sceneBuilder.SetBakeCache(mSceneBakeCache.get());
+	sceneBuilder.SetSceneCacheFile(mSceneCacheFilename);
+	sceneBuilder.SetPreviousScene(previousScene.get());
 
 	sceneBuilder.Build(sceneDescription, sceneMeshInitialLocations, outObjectHandles);
 
@@ -80,8 +88,10 @@ void D3D12::Renderer::InitFrameGraph(FrameGraphConfig&& frameGraphConfig, FrameG
 	buildInfo.Device          = mDevice.get();
 	buildInfo.ShaderMgr       = mShaderManager.get();
 	buildInfo.MemoryAllocator = mMemoryAllocator.get();
+	buildInfo.Hud             = mPerformanceHud.get();
 
 	frameGraphBuilder.Build(std::move(frameGraphDescription), buildInfo);
+	mPerformanceHud->SetFrameGraph(mFrameGraph.get());
 
 	RecreateSceneAndFrameGraphDescriptors();
 }
@@ -90,15 +100,20 @@ void D3D12::Renderer::Render()
 {
 	const uint32_t currentFrameResourceIndex = mFrameCounterRef->GetFrameCount() % Utils::InFlightFrameCount;
 
+	mLatencyTracker->MarkWaitStarted();
 	mDeviceQueues->GraphicsQueueCpuWait(mFrameGraphicsFenceValues[currentFrameResourceIndex]);
+	mLatencyTracker->MarkWaitFinished();
 
 	mScene->CopyUploadedSceneObjects(mWorkerCommandLists.get(), mDeviceQueues.get(), currentFrameResourceIndex);
+	mScene->CullMeshes(mThreadPoolRef);
 
 	mFrameGraph->Traverse(mThreadPoolRef, mScene.get(), currentFrameResourceIndex, mSwapChain->GetCurrentImageIndex());
 
 	mFrameGraphicsFenceValues[currentFrameResourceIndex] = mDeviceQueues->GraphicsFenceSignal();
+	mLatencyTracker->MarkSubmitted();
 
 	mSwapChain->Present();
+	mLatencyTracker->MarkPresented();
 }
 
 void D3D12::Renderer::CreateFactory()
@@ -5,6 +5,7 @@
 #include "../D3D12SwapChain.hpp"
 #include "../D3D12DeviceQueues.hpp"
 #include "../D3D12SrvDescriptorManager.hpp"
+#include "../../Common/RenderStatistics.hpp"
 #include <latch>
 #include <array>
 #include <wil/com.h>
@@ -16,6 +17,9 @@ D3D12::FrameGraph::FrameGraph(FrameGraphConfig&& frameGraphConfig, const WorkerC
 {
 	//We don't have any shader-visible descriptor heap yet. Until that we'll store all descriptors offseted from address 0
 	mFrameGraphDescriptorStart = D3D12_GPU_DESCRIPTOR_HANDLE{.ptr = 0};
+
+	mTimestampFrequency = 0;
+	mTimestampsRecorded.fill(false);
 }
 
 D3D12::FrameGraph::~FrameGraph()
@@ -25,6 +29,12 @@ D3D12::FrameGraph::~FrameGraph()
 void D3D12::FrameGraph::Traverse(ThreadPool* threadPool, const RenderableScene* scene, uint32_t frameIndex, uint32_t swapchainImageIndex)
 {
 	uint32_t currentFrameResourceIndex = frameIndex % Utils::InFlightFrameCount;
+	if(mTimestampsRecorded[currentFrameResourceIndex])
+	{
+		//The frame that used these timestamps is already finished
+		ReadPassTimestamps(currentFrameResourceIndex);
+	}
+
 	if(mGraphicsPassSpansPerDependencyLevel.size() > 0)
 	{
 		struct ExecuteParameters
@@ -109,6 +119,8 @@ void D3D12::FrameGraph::Traverse(ThreadPool* threadPool, const RenderableScene*
 
 		ID3D12CommandQueue* graphicsQueue = mDeviceQueuesRef->GraphicsQueueHandle();
 		graphicsQueue->ExecuteCommandLists((UINT)mGraphicsPassSpansPerDependencyLevel.size(), mFrameRecordedGraphicsCommandLists.data());
+
+		mTimestampsRecorded[currentFrameResourceIndex] = (mTimestampQueryHeap != nullptr);
 	}
 }
 
@@ -126,10 +138,21 @@ void D3D12::FrameGraph::EndCommandList(ID3D12GraphicsCommandList* commandList) c
 
 void D3D12::FrameGraph::RecordGraphicsPasses(ID3D12GraphicsCommandList6* commandList, const RenderableScene* scene, uint32_t dependencyLevelSpanIndex, uint32_t frameIndex, uint32_t swapchainImageIndex) const
 {
+	RenderStatisticsAccumulator& statistics = RenderStatisticsAccumulator::ForCurrentThread();
+
+	uint32_t frameResourceIndex = frameIndex % Utils::InFlightFrameCount;
+	UINT     frameQueryStart    = frameResourceIndex * (UINT)mRenderPassNames.size() * 2;
+
 	Span<uint32_t> levelSpan = mGraphicsPassSpansPerDependencyLevel[dependencyLevelSpanIndex];
 	for(uint32_t passSpanIndex = levelSpan.Begin; passSpanIndex < levelSpan.End; passSpanIndex++)
 	{
 		uint32_t passIndex = CalcPassIndex(mFrameSpansPerRenderPass[passSpanIndex], frameIndex, swapchainImageIndex);
+		UINT     queryIndex = frameQueryStart + passSpanIndex * 2;
+
+		if(mTimestampQueryHeap != nullptr)
+		{
+			commandList->EndQuery(mTimestampQueryHeap.get(), D3D12_QUERY_TYPE_TIMESTAMP, queryIndex);
+		}
 
 		const BarrierPassSpan& barrierSpan            = mRenderPassBarriers[passIndex];
 		UINT                   beforePassBarrierCount = barrierSpan.BeforePassEnd - barrierSpan.BeforePassBegin;
@@ -139,14 +162,50 @@ void D3D12::FrameGraph::RecordGraphicsPasses(ID3D12GraphicsCommandList6* command
 		{
 			const D3D12_RESOURCE_BARRIER* barrierPointer = mResourceBarriers.data() + barrierSpan.BeforePassBegin;
 			commandList->ResourceBarrier(beforePassBarrierCount, barrierPointer);
+			statistics.AddBarriers(beforePassBarrierCount);
 		}
 
-		mRenderPasses[passIndex]->RecordExecution(commandList, scene, mFrameGraphConfig);
+		mRenderPasses[passIndex]->RecordExecution(commandList, scene, mFrameGraphConfig, frameResourceIndex);
 
 		if(afterPassBarrierCount != 0)
 		{
 			const D3D12_RESOURCE_BARRIER* barrierPointer = mResourceBarriers.data() + barrierSpan.AfterPassBegin;
 			commandList->ResourceBarrier(afterPassBarrierCount, barrierPointer);
+			statistics.AddBarriers(afterPassBarrierCount);
+		}
+
+		if(mTimestampQueryHeap != nullptr)
+		{
+			commandList->EndQuery(mTimestampQueryHeap.get(), D3D12_QUERY_TYPE_TIMESTAMP, queryIndex + 1);
+			commandList->ResolveQueryData(mTimestampQueryHeap.get(), D3D12_QUERY_TYPE_TIMESTAMP, queryIndex, 2, mTimestampReadbackBuffer.get(), queryIndex * sizeof(UINT64));
 		}
 	}
+}
+
+void D3D12::FrameGraph::ReadPassTimestamps(uint32_t frameResourceIndex)
+{
+	UINT frameQueryCount = (UINT)mRenderPassNames.size() * 2;
+	UINT frameQueryStart = frameResourceIndex * frameQueryCount;
+
+	D3D12_RANGE readRange;
+	readRange.Begin = frameQueryStart * sizeof(UINT64);
+	readRange.End   = (frameQueryStart + frameQueryCount) * sizeof(UINT64);
+
+	void* timestampData = nullptr;
+	THROW_IF_FAILED(mTimestampReadbackBuffer->Map(0, &readRange, &timestampData));
+
+	const UINT64* frameTimestamps = reinterpret_cast<const UINT64*>(timestampData) + frameQueryStart;
+	for(uint32_t passSpanIndex = 0; passSpanIndex < mRenderPassNames.size(); passSpanIndex++)
+	{
+		UINT64 passBeginTimestamp = frameTimestamps[passSpanIndex * 2 + 0];
+		UINT64 passEndTimestamp   = frameTimestamps[passSpanIndex * 2 + 1];
+
+		mRenderPassGpuTimesMs[passSpanIndex] = (float)((double)(passEndTimestamp - passBeginTimestamp) * 1000.0 / (double)mTimestampFrequency);
+	}
+
+	D3D12_RANGE writeRange;
+	writeRange.Begin = 0;
+	writeRange.End   = 0;
+
+	mTimestampReadbackBuffer->Unmap(0, &writeRange);
 }
\ No newline at end of file
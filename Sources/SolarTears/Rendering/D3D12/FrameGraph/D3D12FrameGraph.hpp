@@ -2,7 +2,9 @@
 
 #include <d3d12.h>
 #include <vector>
+#include <array>
 #include "D3D12RenderPass.hpp"
+#include "../../Common/RenderingUtils.hpp"
 #include "../../Common/FrameGraph/FrameGraphConfig.hpp"
 #include "../../Common/FrameGraph/ModernFrameGraph.hpp"
 
@@ -33,6 +35,8 @@ namespace D3D12
 
 		void RecordGraphicsPasses(ID3D12GraphicsCommandList6* commandList, const RenderableScene* scene, uint32_t dependencyLevelSpanIndex, uint32_t frameIndex, uint32_t swapchainImageIndex) const;
 
+		void ReadPassTimestamps(uint32_t frameResourceIndex);
+
 	private:
 		const WorkerCommandLists*   mCommandListsRef;
 		const SrvDescriptorManager* mDescriptorManagerRef;
@@ -53,5 +57,12 @@ namespace D3D12
 
 		//Used to track the command lists used to record the render passes
 		std::vector<ID3D12CommandList*> mFrameRecordedGraphicsCommandLists;
+
+		//Timestamps written before and after each render pass, for each frame in flight
+		wil::com_ptr_nothrow<ID3D12QueryHeap> mTimestampQueryHeap;
+		wil::com_ptr_nothrow<ID3D12Resource>  mTimestampReadbackBuffer;
+		UINT64                                mTimestampFrequency;
+
+		std::array<bool, Utils::InFlightFrameCount> mTimestampsRecorded;
 	};
 }
\ No newline at end of file
@@ -29,6 +29,11 @@ const D3D12::ShaderManager* D3D12::FrameGraphBuilder::GetShaderManager() const
 	return mShaderManager;
 }
 
+PerformanceHud* D3D12::FrameGraphBuilder::GetPerformanceHud() const
+{
+	return mPerformanceHud;
+}
+
 ID3D12Resource2* D3D12::FrameGraphBuilder::GetRegisteredResource(uint32_t passIndex, uint_fast16_t subresourceIndex) const
 {
 	Span<uint32_t> metadataSpan = mTotalPassMetadatas[passIndex].SubresourceMetadataSpan;
@@ -120,6 +125,7 @@ void D3D12::FrameGraphBuilder::Build(FrameGraphDescription&& frameGraphDescripti
 	mDevice          = buildInfo.Device;
 	mShaderManager   = buildInfo.ShaderMgr;
 	mMemoryAllocator = buildInfo.MemoryAllocator;
+	mPerformanceHud  = buildInfo.Hud;
 
 	ModernFrameGraphBuilder::Build(std::move(frameGraphDescription));
 }
@@ -654,6 +660,54 @@ void D3D12::FrameGraphBuilder::BuildPassObjects()
 
 	//Allocate a separate storage for each per-thread command list
 	mD3d12GraphToBuild->mFrameRecordedGraphicsCommandLists.resize(mD3d12GraphToBuild->mGraphicsPassSpansPerDependencyLevel.size());
+
+	CreateTimestampQueries();
+}
+
+void D3D12::FrameGraphBuilder::CreateTimestampQueries()
+{
+	UINT passCount = (UINT)mD3d12GraphToBuild->mRenderPassNames.size();
+	if(passCount == 0)
+	{
+		return;
+	}
+
+	//Two timestamps (begin and end) per pass per frame in flight
+	UINT queryCount = passCount * 2 * Utils::InFlightFrameCount;
+
+	D3D12_QUERY_HEAP_DESC queryHeapDesc;
+	queryHeapDesc.Type     = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+	queryHeapDesc.Count    = queryCount;
+	queryHeapDesc.NodeMask = 0;
+
+	THROW_IF_FAILED(mDevice->CreateQueryHeap(&queryHeapDesc, IID_PPV_ARGS(mD3d12GraphToBuild->mTimestampQueryHeap.put())));
+
+	D3D12_RESOURCE_DESC1 readbackBufferDesc;
+	readbackBufferDesc.Dimension                       = D3D12_RESOURCE_DIMENSION_BUFFER;
+	readbackBufferDesc.Alignment                       = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+	readbackBufferDesc.Width                           = queryCount * sizeof(UINT64);
+	readbackBufferDesc.Height                          = 1;
+	readbackBufferDesc.DepthOrArraySize                = 1;
+	readbackBufferDesc.MipLevels                       = 1;
+	readbackBufferDesc.Format                          = DXGI_FORMAT_UNKNOWN;
+	readbackBufferDesc.SampleDesc.Count                = 1;
+	readbackBufferDesc.SampleDesc.Quality              = 0;
+	readbackBufferDesc.Layout                          = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+	readbackBufferDesc.Flags                           = D3D12_RESOURCE_FLAG_NONE;
+	readbackBufferDesc.SamplerFeedbackMipRegion.Width  = 1;
+	readbackBufferDesc.SamplerFeedbackMipRegion.Height = 1;
+	readbackBufferDesc.SamplerFeedbackMipRegion.Depth  = 1;
+
+	D3D12_HEAP_PROPERTIES readbackBufferHeapProperties;
+	readbackBufferHeapProperties.Type                 = D3D12_HEAP_TYPE_READBACK;
+	readbackBufferHeapProperties.CPUPageProperty      = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+	readbackBufferHeapProperties.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+	readbackBufferHeapProperties.CreationNodeMask     = 0;
+	readbackBufferHeapProperties.VisibleNodeMask      = 0;
+
+	THROW_IF_FAILED(mDevice->CreateCommittedResource2(&readbackBufferHeapProperties, D3D12_HEAP_FLAG_NONE, &readbackBufferDesc, D3D12_RESOURCE_STATE_COPY_DEST, nullptr, nullptr, IID_PPV_ARGS(mD3d12GraphToBuild->mTimestampReadbackBuffer.put())));
+
+	THROW_IF_FAILED(mD3d12GraphToBuild->mDeviceQueuesRef->GraphicsQueueHandle()->GetTimestampFrequency(&mD3d12GraphToBuild->mTimestampFrequency));
 }
 
 void D3D12::FrameGraphBuilder::CreateBeforePassBarriers(const PassMetadata& passMetadata, uint32_t barrierSpanIndex)
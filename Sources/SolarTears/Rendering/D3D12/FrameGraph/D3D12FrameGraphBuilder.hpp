@@ -9,6 +9,8 @@
 #include <array>
 #include "../../Common/FrameGraph/ModernFrameGraphBuilder.hpp"
 
+class PerformanceHud;
+
 namespace D3D12
 {
 	class MemoryManager;
@@ -21,6 +23,7 @@ namespace D3D12
 		ID3D12Device8*       Device; 
 		const ShaderManager* ShaderMgr;
 		const MemoryManager* MemoryAllocator;
+		PerformanceHud*      Hud;
 	};
 
 	class FrameGraphBuilder final: public ModernFrameGraphBuilder
@@ -32,6 +35,7 @@ namespace D3D12
 		ID3D12Device8* GetDevice() const;
 
 		const ShaderManager* GetShaderManager() const;
+		PerformanceHud*      GetPerformanceHud() const;
 
 		ID3D12Resource2*            GetRegisteredResource(uint32_t passIndex,          uint_fast16_t subresourceIndex) const;
 		D3D12_GPU_DESCRIPTOR_HANDLE GetRegisteredSubresourceSrvUav(uint32_t passIndex, uint_fast16_t subresourceIndex) const;
@@ -53,6 +57,8 @@ namespace D3D12
 	private:
 		D3D12_COMMAND_LIST_TYPE PassClassToListType(RenderPassClass passType);
 
+		void CreateTimestampQueries();
+
 	private:
 		//Registers subresource api-specific metadata
 		void InitMetadataPayloads() override final;
@@ -91,5 +97,6 @@ namespace D3D12
 		const MemoryManager*   mMemoryAllocator;
 		const SwapChain*       mSwapChain;
 		const ShaderManager*   mShaderManager;
+		PerformanceHud*        mPerformanceHud;
 	};
 }
\ No newline at end of file
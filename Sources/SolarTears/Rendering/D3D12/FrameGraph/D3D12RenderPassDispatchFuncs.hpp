@@ -3,6 +3,7 @@
 #include "../../Common/FrameGraph/RenderPassDispatchFuncs.hpp"
 #include "Passes/D3D12GBufferPass.hpp"
 #include "Passes/D3D12CopyImagePass.hpp"
+#include "Passes/D3D12PerformanceHudPass.hpp"
 #include "D3D12FrameGraphMisc.hpp"
 #include <memory>
 
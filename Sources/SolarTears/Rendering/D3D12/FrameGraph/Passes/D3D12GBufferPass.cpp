@@ -5,6 +5,7 @@
 #include "../D3D12FrameGraph.hpp"
 #include "../D3D12FrameGraphBuilder.hpp"
 #include "../../../Common/FrameGraph/FrameGraphConfig.hpp"
+#include "../../../Common/RenderStatistics.hpp"
 #include "../../../../Core/Util.hpp"
 #include <array>
 
@@ -44,7 +45,7 @@ D3D12::GBufferPass::~GBufferPass()
 {
 }
 
-void D3D12::GBufferPass::RecordExecution(ID3D12GraphicsCommandList6* commandList, [[maybe_unused]] const RenderableScene* scene, [[maybe_unused]] const FrameGraphConfig& frameGraphConfig) const
+void D3D12::GBufferPass::RecordExecution(ID3D12GraphicsCommandList6* commandList, [[maybe_unused]] const RenderableScene* scene, [[maybe_unused]] const FrameGraphConfig& frameGraphConfig, [[maybe_unused]] uint32_t frameResourceIndex) const
 {
 	D3D12_RENDER_PASS_RENDER_TARGET_DESC colorsRtvDesc;
 	colorsRtvDesc.cpuDescriptor                             = mColorsRenderTarget;
@@ -85,6 +86,7 @@ void D3D12::GBufferPass::RecordExecution(ID3D12GraphicsCommandList6* commandList
 
 	commandList->SetGraphicsRootDescriptorTable((UINT)GBufferRootBindings::Materials, mSceneMaterialsTable);
 	commandList->SetGraphicsRootDescriptorTable((UINT)GBufferRootBindings::Textures,  mSceneTexturesTable);
+	RenderStatisticsAccumulator::ForCurrentThread().AddDescriptorSetBinds(2);
 
 	commandList->SetPipelineState(mStaticPipelineState.get());
 	scene->DrawStaticObjects(commandList, perSubmeshFunction);
@@ -92,6 +94,7 @@ void D3D12::GBufferPass::RecordExecution(ID3D12GraphicsCommandList6* commandList
 	commandList->SetPipelineState(mRigidPipelineState.get());
 
 	commandList->SetGraphicsRootDescriptorTable((UINT)GBufferRootBindings::PerObjectBuffers, mSceneObjectsTable);
+	RenderStatisticsAccumulator::ForCurrentThread().AddDescriptorSetBinds(1);
 	scene->DrawNonStaticObjects(commandList, perMeshFunction, perSubmeshFunction);
 
 	commandList->EndRenderPass();
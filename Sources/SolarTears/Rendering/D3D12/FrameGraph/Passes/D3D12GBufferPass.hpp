@@ -33,7 +33,7 @@ namespace D3D12
 		GBufferPass(const FrameGraphBuilder* frameGraphBuilder, uint32_t passIndex);
 		~GBufferPass();
 
-		void RecordExecution(ID3D12GraphicsCommandList6* commandList, const RenderableScene* scene, const FrameGraphConfig& frameGraphConfig) const override;
+		void RecordExecution(ID3D12GraphicsCommandList6* commandList, const RenderableScene* scene, const FrameGraphConfig& frameGraphConfig, uint32_t frameResourceIndex) const override;
 
 		ID3D12PipelineState* FirstPipeline() const override;
 
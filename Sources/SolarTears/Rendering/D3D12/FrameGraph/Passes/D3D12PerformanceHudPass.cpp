@@ -0,0 +1,346 @@
+#include "D3D12PerformanceHudPass.hpp"
+#include "../../D3D12Shaders.hpp"
+#include "../D3D12FrameGraph.hpp"
+#include "../D3D12FrameGraphBuilder.hpp"
+#include "../../../Common/FrameGraph/FrameGraphConfig.hpp"
+#include "../../../Common/RenderStatistics.hpp"
+#include "../../../Common/PerformanceHud.hpp"
+#include "../../../../Core/Util.hpp"
+#include <array>
+
+D3D12::PerformanceHudPass::PerformanceHudPass(const FrameGraphBuilder* frameGraphBuilder, uint32_t frameGraphPassId)
+{
+	mPerformanceHudRef   = frameGraphBuilder->GetPerformanceHud();
+	mVertexBufferPointer = nullptr;
+
+	mColorsRenderTarget = frameGraphBuilder->GetRegisteredSubresourceRtv(frameGraphPassId, (uint_fast16_t)PassSubresourceId::ColorBufferImage);
+
+	mOutputFormat = frameGraphBuilder->GetRegisteredSubresourceFormat(frameGraphPassId, (uint_fast16_t)PassSubresourceId::ColorBufferImage);
+
+	wil::com_ptr_t<IDxcBlobEncoding> vertexShaderBlob;
+	wil::com_ptr_t<IDxcBlobEncoding> pixelShaderBlob;
+	LoadShaders(frameGraphBuilder->GetShaderManager(), vertexShaderBlob.put(), pixelShaderBlob.put());
+
+	CreateRootSignature(frameGraphBuilder->GetShaderManager(), frameGraphBuilder->GetDevice(), vertexShaderBlob.get(), pixelShaderBlob.get());
+	CreatePipelineState(frameGraphBuilder->GetDevice(), vertexShaderBlob.get(), pixelShaderBlob.get());
+
+	CreateVertexBuffer(frameGraphBuilder->GetDevice());
+	CreateFontBitmapBuffer(frameGraphBuilder->GetDevice());
+
+	const FrameGraphConfig* frameGraphConfig = frameGraphBuilder->GetConfig();
+
+	mViewport.TopLeftX = 0.0f;
+	mViewport.TopLeftY = 0.0f;
+	mViewport.Width    = (FLOAT)frameGraphConfig->GetViewportWidth();
+	mViewport.Height   = (FLOAT)frameGraphConfig->GetViewportHeight();
+	mViewport.MinDepth = 0.0f;
+	mViewport.MaxDepth = 1.0f;
+
+	mScissorRect.left   = 0;
+	mScissorRect.top    = 0;
+	mScissorRect.right  = frameGraphConfig->GetViewportWidth();
+	mScissorRect.bottom = frameGraphConfig->GetViewportHeight();
+}
+
+D3D12::PerformanceHudPass::~PerformanceHudPass()
+{
+	if(mVertexBufferPointer != nullptr)
+	{
+		mVertexBuffer->Unmap(0, nullptr);
+	}
+}
+
+void D3D12::PerformanceHudPass::RecordExecution(ID3D12GraphicsCommandList6* commandList, [[maybe_unused]] const RenderableScene* scene, const FrameGraphConfig& frameGraphConfig, uint32_t frameResourceIndex) const
+{
+	if(mPerformanceHudRef == nullptr || !mPerformanceHudRef->IsVisible())
+	{
+		return;
+	}
+
+	//The region for this frame is not used by the GPU anymore, the frame fence was already waited on
+	PerformanceHudVertex* frameVertices = mVertexBufferPointer + frameResourceIndex * PerformanceHud::MaxVertexCount;
+	uint32_t vertexCount = mPerformanceHudRef->BuildVertices({frameVertices, PerformanceHud::MaxVertexCount}, frameGraphConfig.GetViewportWidth(), frameGraphConfig.GetViewportHeight());
+
+	//The overlay is drawn over the existing contents
+	D3D12_RENDER_PASS_RENDER_TARGET_DESC colorsRtvDesc;
+	colorsRtvDesc.cpuDescriptor        = mColorsRenderTarget;
+	colorsRtvDesc.BeginningAccess.Type = D3D12_RENDER_PASS_BEGINNING_ACCESS_TYPE_PRESERVE;
+	colorsRtvDesc.EndingAccess.Type    = D3D12_RENDER_PASS_ENDING_ACCESS_TYPE_PRESERVE;
+
+	std::array renderPassRenderTargets = {colorsRtvDesc};
+	commandList->BeginRenderPass((UINT)renderPassRenderTargets.size(), renderPassRenderTargets.data(), nullptr, D3D12_RENDER_PASS_FLAG_NONE);
+
+	std::array viewports = {mViewport};
+	commandList->RSSetViewports((UINT)viewports.size(), viewports.data());
+
+	std::array scissorRects = {mScissorRect};
+	commandList->RSSetScissorRects((UINT)scissorRects.size(), scissorRects.data());
+
+	commandList->SetGraphicsRootSignature(mRootSignature.get());
+	commandList->SetPipelineState(mPipelineState.get());
+
+	commandList->SetGraphicsRootShaderResourceView((UINT)HudRootBindings::FontBitmap, mFontBitmapBuffer->GetGPUVirtualAddress());
+
+	std::array vertexBufferViews = {mVertexBufferViews[frameResourceIndex]};
+	commandList->IASetVertexBuffers(0, (UINT)vertexBufferViews.size(), vertexBufferViews.data());
+	commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+	commandList->DrawInstanced(vertexCount, 1, 0, 0);
+	RenderStatisticsAccumulator::ForCurrentThread().AddDraw(vertexCount, 1);
+
+	commandList->EndRenderPass();
+}
+
+ID3D12PipelineState* D3D12::PerformanceHudPass::FirstPipeline() const
+{
+	return mPipelineState.get();
+}
+
+UINT D3D12::PerformanceHudPass::GetPassDescriptorCountNeeded()
+{
+	//No specific pass descriptors for this pass
+	return 0;
+}
+
+void D3D12::PerformanceHudPass::ValidatePassDescriptors([[maybe_unused]] D3D12_GPU_DESCRIPTOR_HANDLE prevHeapStart, [[maybe_unused]] D3D12_GPU_DESCRIPTOR_HANDLE newHeapStart)
+{
+	//No specific pass descriptors for this pass
+}
+
+void D3D12::PerformanceHudPass::RequestSceneDescriptors([[maybe_unused]] DescriptorCreator* descriptorCreator)
+{
+	//No scene descriptors for this pass
+}
+
+void D3D12::PerformanceHudPass::ValidateSceneDescriptors([[maybe_unused]] const DescriptorCreator* descriptorCreator)
+{
+	//No scene descriptors for this pass
+}
+
+void D3D12::PerformanceHudPass::LoadShaders(const ShaderManager* shaderManager, IDxcBlobEncoding** outVertexShader, IDxcBlobEncoding** outPixelShader)
+{
+	const std::wstring shaderFolder = Utils::GetMainDirectory() + L"Shaders/D3D12/PerformanceHud/";
+
+	shaderManager->LoadShaderBlob(shaderFolder + L"PerformanceHudVS.cso", outVertexShader);
+	shaderManager->LoadShaderBlob(shaderFolder + L"PerformanceHudPS.cso", outPixelShader);
+}
+
+void D3D12::PerformanceHudPass::CreateRootSignature(const ShaderManager* shaderManager, ID3D12Device8* device, IDxcBlobEncoding* vertexShader, IDxcBlobEncoding* pixelShader)
+{
+	std::array<std::string_view, (UINT)HudRootBindings::Count> shaderInputs;
+	shaderInputs[(UINT)HudRootBindings::FontBitmap] = "gFontBitmap";
+
+	std::array<D3D12_ROOT_PARAMETER_TYPE, shaderInputs.size()> shaderInputTypes;
+	shaderInputTypes[(UINT)HudRootBindings::FontBitmap] = D3D12_ROOT_PARAMETER_TYPE_SRV;
+
+	std::array shaderBlobs = {vertexShader, pixelShader};
+	shaderManager->CreateRootSignature(device, shaderBlobs, shaderInputs, shaderInputTypes, mRootSignature.put());
+}
+
+void D3D12::PerformanceHudPass::CreatePipelineState(ID3D12Device8* device, IDxcBlobEncoding* vertexShader, IDxcBlobEncoding* pixelShader)
+{
+	D3D12Utils::StateSubobjectHelper stateSubobjectHelper;
+
+	stateSubobjectHelper.AddSubobjectGeneric(mRootSignature.get());
+
+	stateSubobjectHelper.AddVertexShader(vertexShader->GetBufferPointer(), vertexShader->GetBufferSize());
+	stateSubobjectHelper.AddPixelShader(pixelShader->GetBufferPointer(), pixelShader->GetBufferSize());
+
+	stateSubobjectHelper.AddSampleMask(0xffffffff);
+
+	//The overlay is alpha-blended over the image
+	D3D12_BLEND_DESC blendDesc;
+	blendDesc.AlphaToCoverageEnable                 = FALSE;
+	blendDesc.IndependentBlendEnable                = FALSE;
+	blendDesc.RenderTarget[0].BlendEnable           = TRUE;
+	blendDesc.RenderTarget[0].LogicOpEnable         = FALSE;
+	blendDesc.RenderTarget[0].SrcBlend              = D3D12_BLEND_SRC_ALPHA;
+	blendDesc.RenderTarget[0].DestBlend             = D3D12_BLEND_INV_SRC_ALPHA;
+	blendDesc.RenderTarget[0].BlendOp               = D3D12_BLEND_OP_ADD;
+	blendDesc.RenderTarget[0].SrcBlendAlpha         = D3D12_BLEND_ZERO;
+	blendDesc.RenderTarget[0].DestBlendAlpha        = D3D12_BLEND_ONE;
+	blendDesc.RenderTarget[0].BlendOpAlpha          = D3D12_BLEND_OP_ADD;
+	blendDesc.RenderTarget[0].LogicOp               = D3D12_LOGIC_OP_NOOP;
+	blendDesc.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+
+	stateSubobjectHelper.AddSubobjectGeneric(blendDesc);
+
+	D3D12_RASTERIZER_DESC rasterizerDesc;
+	rasterizerDesc.FillMode              = D3D12_FILL_MODE_SOLID;
+	rasterizerDesc.CullMode              = D3D12_CULL_MODE_NONE;
+	rasterizerDesc.FrontCounterClockwise = FALSE;
+	rasterizerDesc.DepthBias             = D3D12_DEFAULT_DEPTH_BIAS;
+	rasterizerDesc.DepthBiasClamp        = D3D12_DEFAULT_DEPTH_BIAS_CLAMP;
+	rasterizerDesc.SlopeScaledDepthBias  = D3D12_DEFAULT_SLOPE_SCALED_DEPTH_BIAS;
+	rasterizerDesc.DepthClipEnable       = TRUE;
+	rasterizerDesc.MultisampleEnable     = FALSE;
+	rasterizerDesc.AntialiasedLineEnable = FALSE;
+	rasterizerDesc.ForcedSampleCount     = 0;
+	rasterizerDesc.ConservativeRaster    = D3D12_CONSERVATIVE_RASTERIZATION_MODE_OFF;
+
+	stateSubobjectHelper.AddSubobjectGeneric(rasterizerDesc);
+
+	D3D12_DEPTH_STENCIL_DESC depthStencilDesc;
+	depthStencilDesc.DepthEnable                  = FALSE;
+	depthStencilDesc.DepthWriteMask               = D3D12_DEPTH_WRITE_MASK_ZERO;
+	depthStencilDesc.DepthFunc                    = D3D12_COMPARISON_FUNC_ALWAYS;
+	depthStencilDesc.StencilEnable                = FALSE;
+	depthStencilDesc.StencilReadMask              = D3D12_DEFAULT_STENCIL_READ_MASK;
+	depthStencilDesc.StencilWriteMask             = D3D12_DEFAULT_STENCIL_WRITE_MASK;
+	depthStencilDesc.FrontFace.StencilFailOp      = D3D12_STENCIL_OP_KEEP;
+	depthStencilDesc.FrontFace.StencilDepthFailOp = D3D12_STENCIL_OP_KEEP;
+	depthStencilDesc.FrontFace.StencilPassOp      = D3D12_STENCIL_OP_KEEP;
+	depthStencilDesc.FrontFace.StencilFunc        = D3D12_COMPARISON_FUNC_ALWAYS;
+	depthStencilDesc.BackFace                     = depthStencilDesc.FrontFace;
+
+	stateSubobjectHelper.AddSubobjectGeneric(depthStencilDesc);
+
+	std::array<D3D12_INPUT_ELEMENT_DESC, 4> vertexInputDescs;
+	vertexInputDescs[0].SemanticName         = "POSITION";
+	vertexInputDescs[0].SemanticIndex        = 0;
+	vertexInputDescs[0].Format               = D3D12Utils::FormatForVectorType<decltype(PerformanceHudVertex::Position)>;
+	vertexInputDescs[0].InputSlot            = 0;
+	vertexInputDescs[0].AlignedByteOffset    = offsetof(PerformanceHudVertex, Position);
+	vertexInputDescs[0].InputSlotClass       = D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA;
+	vertexInputDescs[0].InstanceDataStepRate = 0;
+	vertexInputDescs[1].SemanticName         = "TEXCOORD";
+	vertexInputDescs[1].SemanticIndex        = 0;
+	vertexInputDescs[1].Format               = D3D12Utils::FormatForVectorType<decltype(PerformanceHudVertex::GlyphCoord)>;
+	vertexInputDescs[1].InputSlot            = 0;
+	vertexInputDescs[1].AlignedByteOffset    = offsetof(PerformanceHudVertex, GlyphCoord);
+	vertexInputDescs[1].InputSlotClass       = D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA;
+	vertexInputDescs[1].InstanceDataStepRate = 0;
+	vertexInputDescs[2].SemanticName         = "GLYPHINDEX";
+	vertexInputDescs[2].SemanticIndex        = 0;
+	vertexInputDescs[2].Format               = DXGI_FORMAT_R32_UINT;
+	vertexInputDescs[2].InputSlot            = 0;
+	vertexInputDescs[2].AlignedByteOffset    = offsetof(PerformanceHudVertex, GlyphIndex);
+	vertexInputDescs[2].InputSlotClass       = D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA;
+	vertexInputDescs[2].InstanceDataStepRate = 0;
+	vertexInputDescs[3].SemanticName         = "COLOR";
+	vertexInputDescs[3].SemanticIndex        = 0;
+	vertexInputDescs[3].Format               = DXGI_FORMAT_R8G8B8A8_UNORM;
+	vertexInputDescs[3].InputSlot            = 0;
+	vertexInputDescs[3].AlignedByteOffset    = offsetof(PerformanceHudVertex, Color);
+	vertexInputDescs[3].InputSlotClass       = D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA;
+	vertexInputDescs[3].InstanceDataStepRate = 0;
+
+	stateSubobjectHelper.AddSubobjectGeneric(D3D12_INPUT_LAYOUT_DESC
+	{
+		.pInputElementDescs = vertexInputDescs.data(),
+		.NumElements        = (UINT)vertexInputDescs.size()
+	});
+
+	stateSubobjectHelper.AddSubobjectGeneric(D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE);
+
+	D3D12_RT_FORMAT_ARRAY renderTargetFormats;
+	renderTargetFormats.NumRenderTargets = 1;
+	renderTargetFormats.RTFormats[0] = mOutputFormat;
+	renderTargetFormats.RTFormats[1] = DXGI_FORMAT_UNKNOWN;
+	renderTargetFormats.RTFormats[2] = DXGI_FORMAT_UNKNOWN;
+	renderTargetFormats.RTFormats[3] = DXGI_FORMAT_UNKNOWN;
+	renderTargetFormats.RTFormats[4] = DXGI_FORMAT_UNKNOWN;
+	renderTargetFormats.RTFormats[5] = DXGI_FORMAT_UNKNOWN;
+	renderTargetFormats.RTFormats[6] = DXGI_FORMAT_UNKNOWN;
+	renderTargetFormats.RTFormats[7] = DXGI_FORMAT_UNKNOWN;
+
+	stateSubobjectHelper.AddSubobjectGeneric(renderTargetFormats);
+
+	//TODO: mGPU?
+	stateSubobjectHelper.AddNodeMask(0);
+
+	D3D12_PIPELINE_STATE_STREAM_DESC pipelineStateStreamDesc;
+	pipelineStateStreamDesc.pPipelineStateSubobjectStream = stateSubobjectHelper.GetStreamPointer();
+	pipelineStateStreamDesc.SizeInBytes                   = stateSubobjectHelper.GetStreamSize();
+
+	THROW_IF_FAILED(device->CreatePipelineState(&pipelineStateStreamDesc, IID_PPV_ARGS(mPipelineState.put())));
+}
+
+void D3D12::PerformanceHudPass::CreateVertexBuffer(ID3D12Device8* device)
+{
+	const UINT frameVertexDataSize = PerformanceHud::MaxVertexCount * sizeof(PerformanceHudVertex);
+
+	D3D12_RESOURCE_DESC1 vertexBufferDesc;
+	vertexBufferDesc.Dimension                       = D3D12_RESOURCE_DIMENSION_BUFFER;
+	vertexBufferDesc.Alignment                       = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+	vertexBufferDesc.Width                           = (UINT64)frameVertexDataSize * Utils::InFlightFrameCount;
+	vertexBufferDesc.Height                          = 1;
+	vertexBufferDesc.DepthOrArraySize                = 1;
+	vertexBufferDesc.MipLevels                       = 1;
+	vertexBufferDesc.Format                          = DXGI_FORMAT_UNKNOWN;
+	vertexBufferDesc.SampleDesc.Count                = 1;
+	vertexBufferDesc.SampleDesc.Quality              = 0;
+	vertexBufferDesc.Layout                          = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+	vertexBufferDesc.Flags                           = D3D12_RESOURCE_FLAG_NONE;
+	vertexBufferDesc.SamplerFeedbackMipRegion.Width  = 1;
+	vertexBufferDesc.SamplerFeedbackMipRegion.Height = 1;
+	vertexBufferDesc.SamplerFeedbackMipRegion.Depth  = 1;
+
+	//The vertex data is small and rewritten every frame, it's read directly from the upload heap
+	//TODO: mGPU?
+	D3D12_HEAP_PROPERTIES vertexBufferHeapProperties;
+	vertexBufferHeapProperties.Type                 = D3D12_HEAP_TYPE_UPLOAD;
+	vertexBufferHeapProperties.CPUPageProperty      = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+	vertexBufferHeapProperties.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+	vertexBufferHeapProperties.CreationNodeMask     = 0;
+	vertexBufferHeapProperties.VisibleNodeMask      = 0;
+
+	THROW_IF_FAILED(device->CreateCommittedResource2(&vertexBufferHeapProperties, D3D12_HEAP_FLAG_NONE, &vertexBufferDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, nullptr, IID_PPV_ARGS(mVertexBuffer.put())));
+
+	D3D12_RANGE readRange;
+	readRange.Begin = 0;
+	readRange.End   = 0;
+
+	void* bufferData = nullptr;
+	THROW_IF_FAILED(mVertexBuffer->Map(0, &readRange, &bufferData));
+
+	mVertexBufferPointer = reinterpret_cast<PerformanceHudVertex*>(bufferData);
+
+	for(uint32_t frameResourceIndex = 0; frameResourceIndex < Utils::InFlightFrameCount; frameResourceIndex++)
+	{
+		mVertexBufferViews[frameResourceIndex].BufferLocation = mVertexBuffer->GetGPUVirtualAddress() + (UINT64)frameResourceIndex * frameVertexDataSize;
+		mVertexBufferViews[frameResourceIndex].SizeInBytes    = frameVertexDataSize;
+		mVertexBufferViews[frameResourceIndex].StrideInBytes  = sizeof(PerformanceHudVertex);
+	}
+}
+
+void D3D12::PerformanceHudPass::CreateFontBitmapBuffer(ID3D12Device8* device)
+{
+	D3D12_RESOURCE_DESC1 fontBitmapBufferDesc;
+	fontBitmapBufferDesc.Dimension                       = D3D12_RESOURCE_DIMENSION_BUFFER;
+	fontBitmapBufferDesc.Alignment                       = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+	fontBitmapBufferDesc.Width                           = PerformanceHud::FontBitmapSize;
+	fontBitmapBufferDesc.Height                          = 1;
+	fontBitmapBufferDesc.DepthOrArraySize                = 1;
+	fontBitmapBufferDesc.MipLevels                       = 1;
+	fontBitmapBufferDesc.Format                          = DXGI_FORMAT_UNKNOWN;
+	fontBitmapBufferDesc.SampleDesc.Count                = 1;
+	fontBitmapBufferDesc.SampleDesc.Quality              = 0;
+	fontBitmapBufferDesc.Layout                          = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+	fontBitmapBufferDesc.Flags                           = D3D12_RESOURCE_FLAG_NONE;
+	fontBitmapBufferDesc.SamplerFeedbackMipRegion.Width  = 1;
+	fontBitmapBufferDesc.SamplerFeedbackMipRegion.Height = 1;
+	fontBitmapBufferDesc.SamplerFeedbackMipRegion.Depth  = 1;
+
+	//The bitmap is a couple of kilobytes, it's not worth a copy to the default heap
+	//TODO: mGPU?
+	D3D12_HEAP_PROPERTIES fontBitmapHeapProperties;
+	fontBitmapHeapProperties.Type                 = D3D12_HEAP_TYPE_UPLOAD;
+	fontBitmapHeapProperties.CPUPageProperty      = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+	fontBitmapHeapProperties.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+	fontBitmapHeapProperties.CreationNodeMask     = 0;
+	fontBitmapHeapProperties.VisibleNodeMask      = 0;
+
+	THROW_IF_FAILED(device->CreateCommittedResource2(&fontBitmapHeapProperties, D3D12_HEAP_FLAG_NONE, &fontBitmapBufferDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, nullptr, IID_PPV_ARGS(mFontBitmapBuffer.put())));
+
+	D3D12_RANGE readRange;
+	readRange.Begin = 0;
+	readRange.End   = 0;
+
+	void* bufferData = nullptr;
+	THROW_IF_FAILED(mFontBitmapBuffer->Map(0, &readRange, &bufferData));
+
+	PerformanceHud::BuildFontBitmap({reinterpret_cast<uint8_t*>(bufferData), PerformanceHud::FontBitmapSize});
+
+	mFontBitmapBuffer->Unmap(0, nullptr);
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "../D3D12RenderPass.hpp"
+#include "../../../Common/FrameGraph/Passes/PerformanceHudPass.hpp"
+#include "../../../Common/RenderingUtils.hpp"
+#include "../D3D12FrameGraphMisc.hpp"
+#include <dxc/dxcapi.h>
+#include <span>
+#include <array>
+
+class PerformanceHud;
+struct PerformanceHudVertex;
+
+namespace D3D12
+{
+	class FrameGraphBuilder;
+
+	class PerformanceHudPass: public RenderPass, public PerformanceHudPassBase
+	{
+		enum class HudRootBindings: UINT
+		{
+			FontBitmap = 0,
+
+			Count
+		};
+
+	public:
+		inline static void RegisterSubresources(std::span<SubresourceMetadataPayload> inoutMetadataPayloads);
+		inline static bool PropagateSubresourceInfos(std::span<SubresourceMetadataPayload> inoutMetadataPayloads);
+
+	public:
+		PerformanceHudPass(const FrameGraphBuilder* frameGraphBuilder, uint32_t passIndex);
+		~PerformanceHudPass();
+
+		void RecordExecution(ID3D12GraphicsCommandList6* commandList, const RenderableScene* scene, const FrameGraphConfig& frameGraphConfig, uint32_t frameResourceIndex) const override;
+
+		ID3D12PipelineState* FirstPipeline() const override;
+
+		virtual UINT GetPassDescriptorCountNeeded()                                                                               override;
+		virtual void ValidatePassDescriptors(D3D12_GPU_DESCRIPTOR_HANDLE prevHeapStart, D3D12_GPU_DESCRIPTOR_HANDLE newHeapStart) override;
+
+		virtual void RequestSceneDescriptors(DescriptorCreator* sceneDescriptorCreator)        override;
+		virtual void ValidateSceneDescriptors(const DescriptorCreator* sceneDescriptorCreator) override;
+
+	private:
+		void LoadShaders(const ShaderManager* shaderManager, IDxcBlobEncoding** outVertexShader, IDxcBlobEncoding** outPixelShader);
+		void CreateRootSignature(const ShaderManager* shaderManager, ID3D12Device8* device, IDxcBlobEncoding* vertexShader, IDxcBlobEncoding* pixelShader);
+		void CreatePipelineState(ID3D12Device8* device, IDxcBlobEncoding* vertexShader, IDxcBlobEncoding* pixelShader);
+		void CreateVertexBuffer(ID3D12Device8* device);
+		void CreateFontBitmapBuffer(ID3D12Device8* device);
+
+	private:
+		PerformanceHud* mPerformanceHudRef;
+
+		D3D12_CPU_DESCRIPTOR_HANDLE mColorsRenderTarget;
+
+		D3D12_VIEWPORT mViewport;
+		D3D12_RECT     mScissorRect;
+		DXGI_FORMAT    mOutputFormat;
+
+		wil::com_ptr_nothrow<ID3D12RootSignature> mRootSignature;
+		wil::com_ptr_nothrow<ID3D12PipelineState> mPipelineState;
+
+		//Upload heap vertex buffer, one region of PerformanceHud::MaxVertexCount vertices per frame in flight
+		wil::com_ptr_nothrow<ID3D12Resource> mVertexBuffer;
+		PerformanceHudVertex*                mVertexBufferPointer;
+
+		std::array<D3D12_VERTEX_BUFFER_VIEW, Utils::InFlightFrameCount> mVertexBufferViews;
+
+		//Upload heap font bitmap, written once and read by the pixel shader through a root SRV
+		wil::com_ptr_nothrow<ID3D12Resource> mFontBitmapBuffer;
+	};
+}
+
+#include "D3D12PerformanceHudPass.inl"
\ No newline at end of file
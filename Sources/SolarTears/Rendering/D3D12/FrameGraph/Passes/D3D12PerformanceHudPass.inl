@@ -0,0 +1,11 @@
+inline void D3D12::PerformanceHudPass::RegisterSubresources(std::span<SubresourceMetadataPayload> inoutMetadataPayloads)
+{
+	assert(inoutMetadataPayloads.size() == (size_t)PassSubresourceId::Count);
+
+	inoutMetadataPayloads[(size_t)PassSubresourceId::ColorBufferImage].State = D3D12_RESOURCE_STATE_RENDER_TARGET;
+}
+
+inline bool D3D12::PerformanceHudPass::PropagateSubresourceInfos([[maybe_unused]] std::span<SubresourceMetadataPayload> inoutMetadataPayloads)
+{
+	return false; //No horizontal propagation happens here
+}
\ No newline at end of file
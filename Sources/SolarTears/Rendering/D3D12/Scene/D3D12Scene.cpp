@@ -16,11 +16,28 @@ D3D12::RenderableScene::RenderableScene(): ModernRenderableScene(D3D12_CONSTANT_
 }
 
 D3D12::RenderableScene::~RenderableScene()
+{
+	ReleaseDeviceResources();
+}
+
+void D3D12::RenderableScene::ReleaseDeviceResources()
 {
 	if(mSceneUploadBuffer)
 	{
 		mSceneUploadBuffer->Unmap(0, nullptr);
+		mSceneUploadDataBufferPointer = nullptr;
 	}
+
+	mSceneVertexBuffer.reset();
+	mSceneIndexBuffer.reset();
+	mSceneConstantBuffer.reset();
+	mSceneUploadBuffer.reset();
+
+	mSceneTextures.clear();
+
+	mHeapForGpuBuffers.reset();
+	mHeapForCpuVisibleBuffers.reset();
+	mHeapForTextures.reset();
 }
 
 void D3D12::RenderableScene::CopyUploadedSceneObjects(WorkerCommandLists* commandLists, DeviceQueues* deviceQueues, uint32_t frameResourceIndex)
@@ -40,6 +57,8 @@ void D3D12::RenderableScene::CopyUploadedSceneObjects(WorkerCommandLists* comman
 		cmdList->CopyBufferRegion(mSceneConstantBuffer.get(), objectDataOffset, mSceneUploadBuffer.get(), objectUploadDataOffset, mObjectChunkDataSize);
 	}
 
+	RenderStatisticsAccumulator::ForCurrentThread().AddUploadCopies(mCurrFrameUpdatedObjectCount + 1, mFrameChunkDataSize + (uint64_t)mCurrFrameUpdatedObjectCount * mObjectChunkDataSize);
+
 	THROW_IF_FAILED(cmdList->Close());
 
 	std::array commandListHandles = {(ID3D12CommandList*)cmdList};
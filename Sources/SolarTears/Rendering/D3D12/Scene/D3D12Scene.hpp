@@ -5,6 +5,7 @@
 #include <string>
 #include <wil/com.h>
 #include "../../Common/RenderingUtils.hpp"
+#include "../../Common/RenderStatistics.hpp"
 #include "../../Common/Scene/ModernRenderableScene.hpp"
 #include "../../../Core/FrameCounter.hpp"
 
@@ -42,6 +43,10 @@ namespace D3D12
 		D3D12_GPU_VIRTUAL_ADDRESS GetMaterialDataStart(uint32_t materialIndex) const;
 		D3D12_GPU_VIRTUAL_ADDRESS GetObjectDataStart(uint32_t objectIndex)     const;
 
+	private:
+		//Release the buffers, textures and their heaps. The scene that replaces this one can do it before allocating its own
+		void ReleaseDeviceResources();
+
 	private:
 		wil::com_ptr_nothrow<ID3D12Resource> mSceneVertexBuffer;
 		wil::com_ptr_nothrow<ID3D12Resource> mSceneIndexBuffer;
@@ -1,12 +1,17 @@
 template<typename SubmeshCallback>
 inline void RenderableScene::DrawStaticObjects(ID3D12GraphicsCommandList* cmdList, SubmeshCallback submeshCallback) const
 {
-	for(uint32_t meshIndex = mStaticUniqueMeshSpan.Begin; meshIndex < mStaticUniqueMeshSpan.End; meshIndex++)
+	RenderStatisticsAccumulator& statistics = RenderStatisticsAccumulator::ForCurrentThread();
+
+	for(uint32_t meshIndex: GetVisibleStaticMeshIndices())
 	{
 		for(uint32_t submeshIndex = mSceneMeshes[meshIndex].FirstSubmeshIndex; submeshIndex < mSceneMeshes[meshIndex].AfterLastSubmeshIndex; submeshIndex++)
 		{
 			submeshCallback(cmdList, mSceneSubmeshes[submeshIndex].MaterialIndex);
-			cmdList->DrawIndexedInstanced(mSceneSubmeshes[submeshIndex].IndexCount, mSceneMeshes[meshIndex].InstanceCount, mSceneSubmeshes[submeshIndex].FirstIndex, mSceneSubmeshes[submeshIndex].VertexOffset, 0);
+			statistics.AddPushConstantUpdates(1);
+			const SceneSubmeshLod& submeshLod = GetSubmeshLod(meshIndex, submeshIndex);
+			cmdList->DrawIndexedInstanced(submeshLod.IndexCount, mSceneMeshes[meshIndex].InstanceCount, submeshLod.FirstIndex, mSceneSubmeshes[submeshIndex].VertexOffset, 0);
+			statistics.AddDraw(submeshLod.IndexCount, mSceneMeshes[meshIndex].InstanceCount);
 		}
 	}
 }
@@ -14,13 +19,20 @@ inline void RenderableScene::DrawStaticObjects(ID3D12GraphicsCommandList* cmdLis
 template<typename MeshCallback, typename SubmeshCallback>
 inline void RenderableScene::DrawNonStaticObjects(ID3D12GraphicsCommandList* cmdList, MeshCallback meshCallback, SubmeshCallback submeshCallback) const
 {
-	for(uint32_t meshIndex = mNonStaticMeshSpan.Begin; meshIndex < mNonStaticMeshSpan.End; meshIndex++)
+	RenderStatisticsAccumulator& statistics = RenderStatisticsAccumulator::ForCurrentThread();
+
+	for(uint32_t meshIndex: GetVisibleNonStaticMeshIndices())
 	{
 		meshCallback(cmdList, mSceneMeshes[meshIndex].PerObjectDataIndex);
+		statistics.AddPushConstantUpdates(1);
+
 		for(uint32_t submeshIndex = mSceneMeshes[meshIndex].FirstSubmeshIndex; submeshIndex < mSceneMeshes[meshIndex].AfterLastSubmeshIndex; submeshIndex++)
 		{
 			submeshCallback(cmdList, mSceneSubmeshes[submeshIndex].MaterialIndex);
-			cmdList->DrawIndexedInstanced(mSceneSubmeshes[submeshIndex].IndexCount, mSceneMeshes[meshIndex].InstanceCount, mSceneSubmeshes[submeshIndex].FirstIndex, mSceneSubmeshes[submeshIndex].VertexOffset, 0);
+			statistics.AddPushConstantUpdates(1);
+			const SceneSubmeshLod& submeshLod = GetSubmeshLod(meshIndex, submeshIndex);
+			cmdList->DrawIndexedInstanced(submeshLod.IndexCount, mSceneMeshes[meshIndex].InstanceCount, submeshLod.FirstIndex, mSceneSubmeshes[submeshIndex].VertexOffset, 0);
+			statistics.AddDraw(submeshLod.IndexCount, mSceneMeshes[meshIndex].InstanceCount);
 		}
 	}
 }
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include <array>
 #include <cassert>
 #include <vector>
+#include <utility>
 
 D3D12::RenderableSceneBuilder::RenderableSceneBuilder(ID3D12Device8* device, RenderableScene* sceneToBuild, 
 	                                                  MemoryManager* memoryAllocator, DeviceQueues* deviceQueues, 
@@ -45,12 +46,20 @@ D3D12::RenderableSceneBuilder::RenderableSceneBuilder(ID3D12Device8* device, Ren
 	mIndexBufferDesc    = defaultBufferDesc;
 	mConstantBufferDesc = defaultBufferDesc;
 	mUploadBufferDesc   = defaultBufferDesc;
+
+	mPreviousD3d12SceneRef = nullptr;
 }
 
 D3D12::RenderableSceneBuilder::~RenderableSceneBuilder()
 {
 }
 
+void D3D12::RenderableSceneBuilder::SetPreviousScene(RenderableScene* previousScene)
+{
+	ModernRenderableSceneBuilder::SetPreviousScene(previousScene);
+	mPreviousD3d12SceneRef = previousScene;
+}
+
 void D3D12::RenderableSceneBuilder::CreateVertexBufferInfo(size_t vertexDataSize)
 {
 	mVertexBufferDesc.Width = vertexDataSize;
@@ -79,7 +88,7 @@ void D3D12::RenderableSceneBuilder::AllocateTextureMetadataArrays(size_t texture
 	mSceneTextureSubresourceFootprints.clear();
 }
 
-void D3D12::RenderableSceneBuilder::LoadTextureFromFile(const std::wstring& textureFilename, uint64_t currentIntermediateBufferOffset, size_t textureIndex, std::vector<std::byte>& outTextureData)
+void D3D12::RenderableSceneBuilder::LoadTexture(const std::wstring& textureFilename, std::span<const std::byte> textureDdsData, uint64_t currentIntermediateBufferOffset, size_t textureIndex, std::vector<std::byte>& outTextureData)
 {
 	outTextureData.clear();
 
@@ -87,7 +96,15 @@ void D3D12::RenderableSceneBuilder::LoadTextureFromFile(const std::wstring& text
 	std::vector<D3D12_SUBRESOURCE_DATA> subresources;
 
 	wil::com_ptr_nothrow<ID3D12Resource> texCommited = nullptr;
-	THROW_IF_FAILED(DirectX::LoadDDSTextureFromFile(mDeviceRef, textureFilename.c_str(), texCommited.put(), textureData, subresources));
+	if(textureDdsData.empty())
+	{
+		THROW_IF_FAILED(DirectX::LoadDDSTextureFromFile(mDeviceRef, textureFilename.c_str(), texCommited.put(), textureData, subresources));
+	}
+	else
+	{
+		//The subresources point into textureDdsData
+		THROW_IF_FAILED(DirectX::LoadDDSTextureFromMemory(mDeviceRef, reinterpret_cast<const uint8_t*>(textureDdsData.data()), textureDdsData.size(), texCommited.put(), subresources));
+	}
 
 	D3D12_RESOURCE_DESC texDesc = texCommited->GetDesc();
 
@@ -119,11 +136,13 @@ void D3D12::RenderableSceneBuilder::LoadTextureFromFile(const std::wstring& text
 
 	outTextureData.resize(textureByteSize);
 
-	size_t currentTextureOffset = 0;
 	for(uint32_t j = 0; j < subresources.size(); j++)
 	{
 		uint32_t globalSubresourceIndex = subresourceSliceBegin + j;
 
+		//Subresources are placed at D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT, there can be a gap after the previous one
+		size_t currentTextureOffset = (size_t)(mSceneTextureSubresourceFootprints[globalSubresourceIndex].Offset - currentIntermediateBufferOffset);
+
 		//Mips are 256 byte aligned on a per-row basis
 		if(footprintByteWidths[j] != mSceneTextureSubresourceFootprints[globalSubresourceIndex].Footprint.RowPitch)
 		{
@@ -133,13 +152,10 @@ void D3D12::RenderableSceneBuilder::LoadTextureFromFile(const std::wstring& text
 				memcpy(outTextureData.data() + currentTextureOffset + rowOffset, (uint8_t*)subresources[j].pData + y * subresources[j].RowPitch, subresources[j].RowPitch);
 				rowOffset += mSceneTextureSubresourceFootprints[globalSubresourceIndex].Footprint.RowPitch;
 			}
-
-			currentTextureOffset += rowOffset;
 		}
 		else
 		{
 			memcpy(outTextureData.data() + currentTextureOffset, (uint8_t*)subresources[j].pData, subresources[j].SlicePitch * texDesc.DepthOrArraySize);
-			currentTextureOffset += subresources[j].SlicePitch * texDesc.DepthOrArraySize;
 		}
 	}
 }
@@ -167,6 +183,28 @@ void D3D12::RenderableSceneBuilder::FinishTextureCreation()
 	}
 }
 
+void D3D12::RenderableSceneBuilder::TakePreviousSceneResources()
+{
+	mD3d12SceneToBuild->mSceneVertexBuffer   = std::move(mPreviousD3d12SceneRef->mSceneVertexBuffer);
+	mD3d12SceneToBuild->mSceneIndexBuffer    = std::move(mPreviousD3d12SceneRef->mSceneIndexBuffer);
+	mD3d12SceneToBuild->mSceneConstantBuffer = std::move(mPreviousD3d12SceneRef->mSceneConstantBuffer);
+	mD3d12SceneToBuild->mSceneUploadBuffer   = std::move(mPreviousD3d12SceneRef->mSceneUploadBuffer);
+
+	mD3d12SceneToBuild->mSceneVertexBufferView = mPreviousD3d12SceneRef->mSceneVertexBufferView;
+	mD3d12SceneToBuild->mSceneIndexBufferView  = mPreviousD3d12SceneRef->mSceneIndexBufferView;
+
+	mD3d12SceneToBuild->mSceneTextures = std::exchange(mPreviousD3d12SceneRef->mSceneTextures, std::vector<wil::com_ptr_nothrow<ID3D12Resource2>>());
+
+	mD3d12SceneToBuild->mHeapForGpuBuffers        = std::move(mPreviousD3d12SceneRef->mHeapForGpuBuffers);
+	mD3d12SceneToBuild->mHeapForCpuVisibleBuffers = std::move(mPreviousD3d12SceneRef->mHeapForCpuVisibleBuffers);
+	mD3d12SceneToBuild->mHeapForTextures          = std::move(mPreviousD3d12SceneRef->mHeapForTextures);
+}
+
+void D3D12::RenderableSceneBuilder::FreePreviousSceneResources()
+{
+	mPreviousD3d12SceneRef->ReleaseDeviceResources();
+}
+
 std::byte* D3D12::RenderableSceneBuilder::MapUploadBuffer()
 {
 	D3D12_RANGE readRange;
@@ -233,13 +271,35 @@ void D3D12::RenderableSceneBuilder::WriteInitializationCommands() const
 	THROW_IF_FAILED(commandAllocator->Reset());
 	THROW_IF_FAILED(commandList->Reset(commandAllocator, nullptr));
 
-	for(size_t i = 0; i < mSceneTextureSubresourceSpans.size(); i++)
+	//The textures of the previous scene are read by the shaders since the previous bake.
+	//The buffers decay to the common state after each ExecuteCommandLists() and get promoted to the copy destination state implicitly
+	if(mPatchingPreviousScene && !mUploadedTextureIndices.empty())
+	{
+		std::vector<D3D12_RESOURCE_BARRIER> copyBarriers;
+		copyBarriers.reserve(mUploadedTextureIndices.size());
+		for(uint32_t textureIndex: mUploadedTextureIndices)
+		{
+			D3D12_RESOURCE_BARRIER textureBarrier;
+			textureBarrier.Type                   = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+			textureBarrier.Flags                  = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+			textureBarrier.Transition.pResource   = mD3d12SceneToBuild->mSceneTextures[textureIndex].get();
+			textureBarrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+			textureBarrier.Transition.StateBefore = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+			textureBarrier.Transition.StateAfter  = D3D12_RESOURCE_STATE_COPY_DEST;
+
+			copyBarriers.push_back(textureBarrier);
+		}
+
+		commandList->ResourceBarrier((UINT)copyBarriers.size(), copyBarriers.data());
+	}
+
+	for(uint32_t textureIndex: mUploadedTextureIndices)
 	{
-		Span<uint32_t> subresourceSpan = mSceneTextureSubresourceSpans[i];
+		Span<uint32_t> subresourceSpan = mSceneTextureSubresourceSpans[textureIndex];
 		for(uint32_t j = subresourceSpan.Begin; j < subresourceSpan.End; j++)
 		{
 			D3D12_TEXTURE_COPY_LOCATION dstLocation;
-			dstLocation.pResource        = mD3d12SceneToBuild->mSceneTextures[i].get();
+			dstLocation.pResource        = mD3d12SceneToBuild->mSceneTextures[textureIndex].get();
 			dstLocation.Type             = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
 			dstLocation.SubresourceIndex = (UINT)(j - subresourceSpan.Begin);
 
@@ -253,24 +313,27 @@ void D3D12::RenderableSceneBuilder::WriteInitializationCommands() const
 	}
 
 
-	std::array sceneBuffers           = {mD3d12SceneToBuild->mSceneVertexBuffer.get(),             mD3d12SceneToBuild->mSceneIndexBuffer.get(),            mD3d12SceneToBuild->mSceneConstantBuffer.get()};
-	std::array sceneBufferDataOffsets = {mIntermediateBufferVertexDataOffset,                      mIntermediateBufferIndexDataOffset,                     mIntermediateBufferStaticConstantDataOffset};
-	std::array sceneBufferDataSizes   = {mVertexBufferData.size() * sizeof(RenderableSceneVertex), mIndexBufferData.size() * sizeof(RenderableSceneIndex), mStaticConstantData.size() * sizeof(std::byte)};
-	std::array sceneBufferStates      = {D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER,          D3D12_RESOURCE_STATE_INDEX_BUFFER,                      D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER};
+	//Only the buffers with the changed data are copied to
+	std::array sceneBuffers            = {mD3d12SceneToBuild->mSceneVertexBuffer.get(),    mD3d12SceneToBuild->mSceneIndexBuffer.get(), mD3d12SceneToBuild->mSceneConstantBuffer.get()};
+	std::array sceneBufferUploadRanges = {&mVertexBufferUploadRanges,                      &mIndexBufferUploadRanges,                   &mConstantBufferUploadRanges};
+	std::array sceneBufferStates       = {D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER, D3D12_RESOURCE_STATE_INDEX_BUFFER,           D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER};
 	for(size_t i = 0; i < sceneBuffers.size(); i++)
 	{
-		commandList->CopyBufferRegion(sceneBuffers[i], 0, mIntermediateBuffer.get(), sceneBufferDataOffsets[i], sceneBufferDataSizes[i]);
+		for(const BufferUploadRange& uploadRange: *sceneBufferUploadRanges[i])
+		{
+			commandList->CopyBufferRegion(sceneBuffers[i], uploadRange.BufferOffset, mIntermediateBuffer.get(), uploadRange.IntermediateBufferOffset, uploadRange.ByteSize);
+		}
 	}
 
 
 	std::vector<D3D12_RESOURCE_BARRIER> barriers;
-	barriers.reserve(mD3d12SceneToBuild->mSceneTextures.size() + sceneBuffers.size());
-	for(int i = 0; i < mD3d12SceneToBuild->mSceneTextures.size(); i++)
+	barriers.reserve(mUploadedTextureIndices.size() + sceneBuffers.size());
+	for(uint32_t textureIndex: mUploadedTextureIndices)
 	{
 		D3D12_RESOURCE_BARRIER textureBarrier;
 		textureBarrier.Type                   = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
 		textureBarrier.Flags                  = D3D12_RESOURCE_BARRIER_FLAG_NONE;
-		textureBarrier.Transition.pResource   = mD3d12SceneToBuild->mSceneTextures[i].get();
+		textureBarrier.Transition.pResource   = mD3d12SceneToBuild->mSceneTextures[textureIndex].get();
 		textureBarrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
 		textureBarrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
 		textureBarrier.Transition.StateAfter  = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
@@ -278,8 +341,14 @@ void D3D12::RenderableSceneBuilder::WriteInitializationCommands() const
 		barriers.push_back(textureBarrier);
 	}
 
-	for(int i = 0; i < sceneBuffers.size(); i++)
+	for(size_t i = 0; i < sceneBuffers.size(); i++)
 	{
+		//Nothing was copied to the buffers with the unchanged data, their state stays the same
+		if(sceneBufferUploadRanges[i]->empty())
+		{
+			continue;
+		}
+
 		D3D12_RESOURCE_BARRIER bufferBarrier;
 		bufferBarrier.Type                   = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
 		bufferBarrier.Flags                  = D3D12_RESOURCE_BARRIER_FLAG_NONE;
@@ -291,7 +360,10 @@ void D3D12::RenderableSceneBuilder::WriteInitializationCommands() const
 		barriers.push_back(bufferBarrier);
 	}
 
-	commandList->ResourceBarrier((UINT)barriers.size(), barriers.data());
+	if(!barriers.empty())
+	{
+		commandList->ResourceBarrier((UINT)barriers.size(), barriers.data());
+	}
 
 
 	THROW_IF_FAILED(commandList->Close());
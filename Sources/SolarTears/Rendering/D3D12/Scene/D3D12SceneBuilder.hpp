@@ -21,18 +21,24 @@ namespace D3D12
 		RenderableSceneBuilder(ID3D12Device8* device, RenderableScene* sceneToBuild, MemoryManager* memoryAllocator, DeviceQueues* deviceQueues, const WorkerCommandLists* commandLists);
 		~RenderableSceneBuilder();
 
+		//The scene the built one replaces, see ModernRenderableSceneBuilder::SetPreviousScene()
+		void SetPreviousScene(RenderableScene* previousScene);
+
 	protected:
 		void CreateVertexBufferInfo(size_t vertexDataSize)     override final;
 		void CreateIndexBufferInfo(size_t indexDataSize)       override final;
 		void CreateConstantBufferInfo(size_t constantDataSize) override final;
 		void CreateUploadBufferInfo(size_t uploadDataSize)     override final;
 
-		void AllocateTextureMetadataArrays(size_t textureCount)                                                                                                              override final;
-		void LoadTextureFromFile(const std::wstring& textureFilename, uint64_t currentIntermediateBufferOffset, size_t textureIndex, std::vector<std::byte>& outTextureData) override final;
+		void AllocateTextureMetadataArrays(size_t textureCount)                                                                                                                                                override final;
+		void LoadTexture(const std::wstring& textureFilename, std::span<const std::byte> textureDdsData, uint64_t currentIntermediateBufferOffset, size_t textureIndex, std::vector<std::byte>& outTextureData) override final;
 
 		virtual void FinishBufferCreation()  override final;
 		virtual void FinishTextureCreation() override final;
 
+		virtual void TakePreviousSceneResources() override final;
+		virtual void FreePreviousSceneResources() override final;
+
 		virtual std::byte* MapUploadBuffer() override final;
 
 		virtual void       CreateIntermediateBuffer()      override final;
@@ -53,6 +59,7 @@ namespace D3D12
 		ID3D12Device8* mDeviceRef;
 
 		RenderableScene* mD3d12SceneToBuild;
+		RenderableScene* mPreviousD3d12SceneRef;
 
 		MemoryManager*            mMemoryAllocator;
 		DeviceQueues*             mDeviceQueues;
@@ -3,6 +3,7 @@
 #include "../../Scene/VulkanScene.hpp"
 #include "../../VulkanShaders.hpp"
 #include "../VulkanFrameGraphBuilder.hpp"
+#include "../../../Common/RenderStatistics.hpp"
 #include <array>
 #include <VulkanGenericStructures.h>
 
@@ -40,7 +41,7 @@ Vulkan::GBufferPass::~GBufferPass()
 	SafeDestroyObject(vkDestroyFramebuffer, mDeviceRef, mFramebuffer);
 }
 
-void Vulkan::GBufferPass::RecordExecution(VkCommandBuffer commandBuffer, const RenderableScene* scene, const FrameGraphConfig& frameGraphConfig) const
+void Vulkan::GBufferPass::RecordExecution(VkCommandBuffer commandBuffer, const RenderableScene* scene, const FrameGraphConfig& frameGraphConfig, [[maybe_unused]] uint32_t frameResourceIndex) const
 {
 	constexpr uint32_t WriteAttachmentCount = 1;
 
@@ -86,6 +87,7 @@ void Vulkan::GBufferPass::RecordExecution(VkCommandBuffer commandBuffer, const R
 
 	//Prepare to first drawing
 	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, currentPipelineLayout, mStaticDrawSetBindOffset, mStaticDrawChangedSetSpan.End - mStaticDrawChangedSetSpan.Begin, mDescriptorSets.data() + mStaticDrawChangedSetSpan.Begin, 0, nullptr);
+	RenderStatisticsAccumulator::ForCurrentThread().AddDescriptorSetBinds(mStaticDrawChangedSetSpan.End - mStaticDrawChangedSetSpan.Begin);
 	scene->PrepareDrawBuffers(commandBuffer);
 	
 	//Draw static meshes
@@ -97,6 +99,7 @@ void Vulkan::GBufferPass::RecordExecution(VkCommandBuffer commandBuffer, const R
 
 	//Draw rigid meshes
 	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, currentPipelineLayout, mRigidDrawSetBindOffset, mRigidDrawChangedSetSpan.End - mRigidDrawChangedSetSpan.Begin, mDescriptorSets.data() + mRigidDrawChangedSetSpan.Begin, 0, nullptr);
+	RenderStatisticsAccumulator::ForCurrentThread().AddDescriptorSetBinds(mRigidDrawChangedSetSpan.End - mRigidDrawChangedSetSpan.Begin);
 	scene->DrawNonStaticObjects(commandBuffer, meshCallback, submeshCallback);
 
 	vkCmdEndRenderPass(commandBuffer);
@@ -194,7 +197,7 @@ void Vulkan::GBufferPass::CreateRenderPass(const FrameGraphBuilder* frameGraphBu
 	renderPassCreateInfo.dependencyCount         = (uint32_t)(dependencies.size());
 	renderPassCreateInfo.pDependencies           = dependencies.data();
 
-	ThrowIfFailed(vkCreateRenderPass(mDeviceRef, &renderPassCreateInfo, nullptr, &mRenderPass));
+	ThrowIfFailed(vkCreateRenderPass(mDeviceRef, &renderPassCreateInfo, HostAllocator::Callbacks(), &mRenderPass));
 }
 
 void Vulkan::GBufferPass::CreateFramebuffer(const FrameGraphBuilder* frameGraphBuilder, uint32_t frameGraphPassId, const FrameGraphConfig* frameGraphConfig)
@@ -219,7 +222,7 @@ void Vulkan::GBufferPass::CreateFramebuffer(const FrameGraphBuilder* frameGraphB
 	framebufferCreateInfo.height                   = frameGraphConfig->GetViewportHeight();
 	framebufferCreateInfo.layers                   = 1;
 
-	ThrowIfFailed(vkCreateFramebuffer(mDeviceRef, &framebufferCreateInfo, nullptr, &mFramebuffer));
+	ThrowIfFailed(vkCreateFramebuffer(mDeviceRef, &framebufferCreateInfo, HostAllocator::Callbacks(), &mFramebuffer));
 }
 
 void Vulkan::GBufferPass::CreatePipelineLayouts(const ShaderDatabase* shaderDatabase)
@@ -276,8 +279,8 @@ void Vulkan::GBufferPass::CreateGBufferPipeline(const uint32_t* vertexShaderModu
 	std::array<VkPipelineShaderStageCreateInfo, 2> pipelineShaderStageCreateInfos;
 
 	std::array<VkShaderModule, pipelineShaderStageCreateInfos.size()> shaderModules;
-	ThrowIfFailed(vkCreateShaderModule(mDeviceRef, &vertexShaderModuleCreateInfo,   nullptr, &shaderModules[0]));
-	ThrowIfFailed(vkCreateShaderModule(mDeviceRef, &fragmentShaderModuleCreateInfo, nullptr, &shaderModules[1]));
+	ThrowIfFailed(vkCreateShaderModule(mDeviceRef, &vertexShaderModuleCreateInfo,   HostAllocator::Callbacks(), &shaderModules[0]));
+	ThrowIfFailed(vkCreateShaderModule(mDeviceRef, &fragmentShaderModuleCreateInfo, HostAllocator::Callbacks(), &shaderModules[1]));
 
 	const char* enrtyPointName = "main";
 
@@ -488,7 +491,7 @@ void Vulkan::GBufferPass::CreateGBufferPipeline(const uint32_t* vertexShaderModu
 	gbufferPipelineCreateInfo.basePipelineIndex   = 0;
 
 	std::array graphicsPipelineCreateInfos = {gbufferPipelineCreateInfo};
-	ThrowIfFailed(vkCreateGraphicsPipelines(mDeviceRef, VK_NULL_HANDLE, (uint32_t)graphicsPipelineCreateInfos.size(), graphicsPipelineCreateInfos.data(), nullptr, outPipeline));
+	ThrowIfFailed(vkCreateGraphicsPipelines(mDeviceRef, VK_NULL_HANDLE, (uint32_t)graphicsPipelineCreateInfos.size(), graphicsPipelineCreateInfos.data(), HostAllocator::Callbacks(), outPipeline));
 
 	for(size_t i = 0; i < shaderModules.size(); i++)
 	{
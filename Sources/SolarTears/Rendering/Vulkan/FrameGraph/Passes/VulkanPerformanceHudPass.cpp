@@ -0,0 +1,584 @@
+#include "VulkanPerformanceHudPass.hpp"
+#include "../../VulkanFunctions.hpp"
+#include "../../VulkanMemory.hpp"
+#include "../../VulkanUtils.hpp"
+#include "../../VulkanDeviceQueues.hpp"
+#include "../../VulkanShaders.hpp"
+#include "../VulkanFrameGraphBuilder.hpp"
+#include "../../../Common/FrameGraph/FrameGraphConfig.hpp"
+#include "../../../Common/RenderStatistics.hpp"
+#include "../../../Common/PerformanceHud.hpp"
+#include <array>
+#include <vector>
+#include <VulkanGenericStructures.h>
+
+Vulkan::PerformanceHudPass::PerformanceHudPass(const FrameGraphBuilder* frameGraphBuilder, uint32_t frameGraphPassId): RenderPass(frameGraphBuilder->GetDevice())
+{
+	mPerformanceHudRef = frameGraphBuilder->GetPerformanceHud();
+	mMemoryManagerRef  = frameGraphBuilder->GetMemoryManager();
+
+	mRenderPass  = VK_NULL_HANDLE;
+	mFramebuffer = VK_NULL_HANDLE;
+
+	mPipelineLayout = VK_NULL_HANDLE;
+	mPipeline       = VK_NULL_HANDLE;
+
+	mDescriptorSetLayout = VK_NULL_HANDLE;
+	mDescriptorPool      = VK_NULL_HANDLE;
+	mDescriptorSet       = VK_NULL_HANDLE;
+
+	mVertexBuffer         = VK_NULL_HANDLE;
+	mFontBitmapBuffer     = VK_NULL_HANDLE;
+	mFontBitmapBufferView = VK_NULL_HANDLE;
+	mBufferMemory         = VK_NULL_HANDLE;
+	mVertexBufferPointer  = nullptr;
+
+	CreateRenderPass(frameGraphBuilder,  frameGraphPassId);
+	CreateFramebuffer(frameGraphBuilder, frameGraphPassId, frameGraphBuilder->GetConfig());
+	CreateBuffers(frameGraphBuilder);
+	CreateFontBitmapView();
+
+	CreateDescriptorSet();
+	CreatePipelineLayout();
+	CreatePipeline(frameGraphBuilder->GetLogger(), frameGraphBuilder->GetConfig());
+}
+
+Vulkan::PerformanceHudPass::~PerformanceHudPass()
+{
+	if(mVertexBufferPointer != nullptr)
+	{
+		vkUnmapMemory(mDeviceRef, mBufferMemory);
+	}
+
+	SafeDestroyObject(vkDestroyBufferView, mDeviceRef, mFontBitmapBufferView);
+	SafeDestroyObject(vkDestroyBuffer,     mDeviceRef, mFontBitmapBuffer);
+	SafeDestroyObject(vkDestroyBuffer,     mDeviceRef, mVertexBuffer);
+	mMemoryManagerRef->FreeMemory(mDeviceRef, mBufferMemory);
+
+	SafeDestroyObject(vkDestroyPipeline,       mDeviceRef, mPipeline);
+	SafeDestroyObject(vkDestroyPipelineLayout, mDeviceRef, mPipelineLayout);
+
+	SafeDestroyObject(vkDestroyDescriptorPool,      mDeviceRef, mDescriptorPool);
+	SafeDestroyObject(vkDestroyDescriptorSetLayout, mDeviceRef, mDescriptorSetLayout);
+
+	SafeDestroyObject(vkDestroyRenderPass,  mDeviceRef, mRenderPass);
+	SafeDestroyObject(vkDestroyFramebuffer, mDeviceRef, mFramebuffer);
+}
+
+void Vulkan::PerformanceHudPass::RecordExecution(VkCommandBuffer commandBuffer, [[maybe_unused]] const RenderableScene* scene, const FrameGraphConfig& frameGraphConfig, uint32_t frameResourceIndex) const
+{
+	if(mPerformanceHudRef == nullptr)
+	{
+		return;
+	}
+
+	//The render pass still has to run while the overlay is hidden, it transitions the color buffer layout
+	uint32_t vertexCount = 0;
+	if(mPerformanceHudRef->IsVisible())
+	{
+		//The region for this frame is not used by the GPU anymore, the frame fence was already waited on
+		PerformanceHudVertex* frameVertices = mVertexBufferPointer + frameResourceIndex * PerformanceHud::MaxVertexCount;
+		vertexCount = mPerformanceHudRef->BuildVertices({frameVertices, PerformanceHud::MaxVertexCount}, frameGraphConfig.GetViewportWidth(), frameGraphConfig.GetViewportHeight());
+	}
+
+	VkRenderPassBeginInfo renderPassBeginInfo;
+	renderPassBeginInfo.sType                    = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+	renderPassBeginInfo.pNext                    = nullptr;
+	renderPassBeginInfo.renderPass               = mRenderPass;
+	renderPassBeginInfo.framebuffer              = mFramebuffer;
+	renderPassBeginInfo.renderArea.offset.x      = 0;
+	renderPassBeginInfo.renderArea.offset.y      = 0;
+	renderPassBeginInfo.renderArea.extent.width  = frameGraphConfig.GetViewportWidth();
+	renderPassBeginInfo.renderArea.extent.height = frameGraphConfig.GetViewportHeight();
+	renderPassBeginInfo.clearValueCount          = 0;
+	renderPassBeginInfo.pClearValues             = nullptr;
+
+	vkCmdBeginRenderPass(commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+	if(vertexCount != 0)
+	{
+		std::array vertexBuffers = {mVertexBuffer};
+		std::array vertexOffsets = {(VkDeviceSize)(frameResourceIndex * PerformanceHud::MaxVertexCount * sizeof(PerformanceHudVertex))};
+
+		std::array descriptorSets = {mDescriptorSet};
+
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mPipeline);
+		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mPipelineLayout, 0, (uint32_t)descriptorSets.size(), descriptorSets.data(), 0, nullptr);
+		vkCmdBindVertexBuffers(commandBuffer, 0, (uint32_t)vertexBuffers.size(), vertexBuffers.data(), vertexOffsets.data());
+		vkCmdDraw(commandBuffer, vertexCount, 1, 0, 0);
+
+		RenderStatisticsAccumulator::ForCurrentThread().AddDraw(vertexCount, 1);
+	}
+
+	vkCmdEndRenderPass(commandBuffer);
+}
+
+void Vulkan::PerformanceHudPass::ValidateDescriptorSetSpans([[maybe_unused]] DescriptorDatabase* descriptorDatabase, [[maybe_unused]] const VkDescriptorSet* originalSetStartPoint)
+{
+	//The only descriptor set of this pass is created and owned by the pass itself
+}
+
+void Vulkan::PerformanceHudPass::CreateRenderPass(const FrameGraphBuilder* frameGraphBuilder, uint32_t frameGraphPassId)
+{
+	//The overlay is drawn over the existing contents
+	std::array<VkAttachmentDescription, 1> attachments;
+	attachments[0].flags          = 0;
+	attachments[0].format         = frameGraphBuilder->GetRegisteredSubresourceFormat(frameGraphPassId, (uint_fast16_t)PassSubresourceId::ColorBufferImage);
+	attachments[0].samples        = VK_SAMPLE_COUNT_1_BIT;
+	attachments[0].loadOp         = VK_ATTACHMENT_LOAD_OP_LOAD;
+	attachments[0].storeOp        = VK_ATTACHMENT_STORE_OP_STORE;
+	attachments[0].stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	attachments[0].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	attachments[0].initialLayout  = frameGraphBuilder->GetPreviousPassSubresourceLayout(frameGraphPassId, (uint_fast16_t)PassSubresourceId::ColorBufferImage);
+	attachments[0].finalLayout    = frameGraphBuilder->GetNextPassSubresourceLayout(frameGraphPassId, (uint_fast16_t)PassSubresourceId::ColorBufferImage);
+
+	VkAttachmentReference colorBufferAttachment;
+	colorBufferAttachment.attachment = 0;
+	colorBufferAttachment.layout     = frameGraphBuilder->GetRegisteredSubresourceLayout(frameGraphPassId, (uint_fast16_t)PassSubresourceId::ColorBufferImage);
+
+	std::array colorAttachments = {colorBufferAttachment};
+
+	std::array<VkSubpassDescription, 1> subpasses;
+	subpasses[0].flags                   = 0;
+	subpasses[0].pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	subpasses[0].inputAttachmentCount    = 0;
+	subpasses[0].pInputAttachments       = nullptr;
+	subpasses[0].colorAttachmentCount    = (uint32_t)(colorAttachments.size());
+	subpasses[0].pColorAttachments       = colorAttachments.data();
+	subpasses[0].pResolveAttachments     = nullptr;
+	subpasses[0].pDepthStencilAttachment = nullptr;
+	subpasses[0].preserveAttachmentCount = 0;
+	subpasses[0].pPreserveAttachments    = 0;
+
+	std::array<VkSubpassDependency, 2> dependencies;
+	dependencies[0].srcSubpass      = VK_SUBPASS_EXTERNAL;
+	dependencies[0].dstSubpass      = 0;
+	dependencies[0].srcStageMask    = frameGraphBuilder->GetPreviousPassSubresourceStageFlags(frameGraphPassId, (uint_fast16_t)PassSubresourceId::ColorBufferImage);
+	dependencies[0].dstStageMask    = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	dependencies[0].srcAccessMask   = frameGraphBuilder->GetPreviousPassSubresourceAccessFlags(frameGraphPassId, (uint_fast16_t)PassSubresourceId::ColorBufferImage);
+	dependencies[0].dstAccessMask   = (VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT);
+	dependencies[0].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+	dependencies[1].srcSubpass      = 0;
+	dependencies[1].dstSubpass      = VK_SUBPASS_EXTERNAL;
+	dependencies[1].srcStageMask    = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	dependencies[1].dstStageMask    = frameGraphBuilder->GetNextPassSubresourceStageFlags(frameGraphPassId, (uint_fast16_t)PassSubresourceId::ColorBufferImage);
+	dependencies[1].srcAccessMask   = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	dependencies[1].dstAccessMask   = frameGraphBuilder->GetNextPassSubresourceAccessFlags(frameGraphPassId, (uint_fast16_t)PassSubresourceId::ColorBufferImage);
+	dependencies[1].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+	VkRenderPassCreateInfo renderPassCreateInfo;
+	renderPassCreateInfo.sType           = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+	renderPassCreateInfo.pNext           = nullptr;
+	renderPassCreateInfo.flags           = 0;
+	renderPassCreateInfo.attachmentCount = (uint32_t)(attachments.size());
+	renderPassCreateInfo.pAttachments    = attachments.data();
+	renderPassCreateInfo.subpassCount    = (uint32_t)(subpasses.size());
+	renderPassCreateInfo.pSubpasses      = subpasses.data();
+	renderPassCreateInfo.dependencyCount = (uint32_t)(dependencies.size());
+	renderPassCreateInfo.pDependencies   = dependencies.data();
+
+	ThrowIfFailed(vkCreateRenderPass(mDeviceRef, &renderPassCreateInfo, HostAllocator::Callbacks(), &mRenderPass));
+}
+
+void Vulkan::PerformanceHudPass::CreateFramebuffer(const FrameGraphBuilder* frameGraphBuilder, uint32_t frameGraphPassId, const FrameGraphConfig* frameGraphConfig)
+{
+	std::array attachments = {frameGraphBuilder->GetRegisteredSubresource(frameGraphPassId, (uint_fast16_t)PassSubresourceId::ColorBufferImage)};
+
+	VkFramebufferCreateInfo framebufferCreateInfo;
+	framebufferCreateInfo.sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+	framebufferCreateInfo.pNext           = nullptr;
+	framebufferCreateInfo.flags           = 0;
+	framebufferCreateInfo.renderPass      = mRenderPass;
+	framebufferCreateInfo.attachmentCount = (uint32_t)(attachments.size());
+	framebufferCreateInfo.pAttachments    = attachments.data();
+	framebufferCreateInfo.width           = frameGraphConfig->GetViewportWidth();
+	framebufferCreateInfo.height          = frameGraphConfig->GetViewportHeight();
+	framebufferCreateInfo.layers          = 1;
+
+	ThrowIfFailed(vkCreateFramebuffer(mDeviceRef, &framebufferCreateInfo, HostAllocator::Callbacks(), &mFramebuffer));
+}
+
+void Vulkan::PerformanceHudPass::CreateBuffers(const FrameGraphBuilder* frameGraphBuilder)
+{
+	std::array bufferQueueFamilies = {frameGraphBuilder->GetDeviceQueues()->GetGraphicsQueueFamilyIndex()};
+
+	VkBufferCreateInfo vertexBufferCreateInfo;
+	vertexBufferCreateInfo.sType                 = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	vertexBufferCreateInfo.pNext                 = nullptr;
+	vertexBufferCreateInfo.flags                 = 0;
+	vertexBufferCreateInfo.size                  = Utils::InFlightFrameCount * PerformanceHud::MaxVertexCount * sizeof(PerformanceHudVertex);
+	vertexBufferCreateInfo.usage                 = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+	vertexBufferCreateInfo.sharingMode           = VK_SHARING_MODE_EXCLUSIVE;
+	vertexBufferCreateInfo.queueFamilyIndexCount = (uint32_t)bufferQueueFamilies.size();
+	vertexBufferCreateInfo.pQueueFamilyIndices   = bufferQueueFamilies.data();
+
+	ThrowIfFailed(vkCreateBuffer(mDeviceRef, &vertexBufferCreateInfo, HostAllocator::Callbacks(), &mVertexBuffer));
+
+	VkBufferCreateInfo fontBitmapBufferCreateInfo;
+	fontBitmapBufferCreateInfo.sType                 = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	fontBitmapBufferCreateInfo.pNext                 = nullptr;
+	fontBitmapBufferCreateInfo.flags                 = 0;
+	fontBitmapBufferCreateInfo.size                  = PerformanceHud::FontBitmapSize;
+	fontBitmapBufferCreateInfo.usage                 = VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT;
+	fontBitmapBufferCreateInfo.sharingMode           = VK_SHARING_MODE_EXCLUSIVE;
+	fontBitmapBufferCreateInfo.queueFamilyIndexCount = (uint32_t)bufferQueueFamilies.size();
+	fontBitmapBufferCreateInfo.pQueueFamilyIndices   = bufferQueueFamilies.data();
+
+	ThrowIfFailed(vkCreateBuffer(mDeviceRef, &fontBitmapBufferCreateInfo, HostAllocator::Callbacks(), &mFontBitmapBuffer));
+
+	std::vector hostVisibleBuffers = {mVertexBuffer, mFontBitmapBuffer};
+
+	std::vector<VkDeviceSize> hostVisibleBufferOffsets;
+	mBufferMemory = mMemoryManagerRef->AllocateBuffersMemory(mDeviceRef, hostVisibleBuffers, MemoryManager::BufferAllocationType::HOST_VISIBLE, MemoryManager::AllocationCategory::UploadBuffers, hostVisibleBufferOffsets);
+
+	std::array<VkBindBufferMemoryInfo, 2> bindBufferMemoryInfos;
+	for(size_t bufferIndex = 0; bufferIndex < bindBufferMemoryInfos.size(); bufferIndex++)
+	{
+		bindBufferMemoryInfos[bufferIndex].sType        = VK_STRUCTURE_TYPE_BIND_BUFFER_MEMORY_INFO;
+		bindBufferMemoryInfos[bufferIndex].pNext        = nullptr;
+		bindBufferMemoryInfos[bufferIndex].buffer       = hostVisibleBuffers[bufferIndex];
+		bindBufferMemoryInfos[bufferIndex].memory       = mBufferMemory;
+		bindBufferMemoryInfos[bufferIndex].memoryOffset = hostVisibleBufferOffsets[bufferIndex];
+	}
+
+	ThrowIfFailed(vkBindBufferMemory2(mDeviceRef, (uint32_t)(bindBufferMemoryInfos.size()), bindBufferMemoryInfos.data()));
+
+	//The memory is host-coherent, keep it mapped for the whole pass lifetime
+	void* bufferPointer = nullptr;
+	ThrowIfFailed(vkMapMemory(mDeviceRef, mBufferMemory, 0, VK_WHOLE_SIZE, 0, &bufferPointer));
+
+	mVertexBufferPointer = reinterpret_cast<PerformanceHudVertex*>(reinterpret_cast<uint8_t*>(bufferPointer) + hostVisibleBufferOffsets[0]);
+
+	uint8_t* fontBitmapPointer = reinterpret_cast<uint8_t*>(bufferPointer) + hostVisibleBufferOffsets[1];
+	PerformanceHud::BuildFontBitmap({fontBitmapPointer, PerformanceHud::FontBitmapSize});
+}
+
+void Vulkan::PerformanceHudPass::CreateFontBitmapView()
+{
+	//R8_UINT is one of the formats required to support uniform texel buffers
+	VkBufferViewCreateInfo fontBitmapViewCreateInfo;
+	fontBitmapViewCreateInfo.sType  = VK_STRUCTURE_TYPE_BUFFER_VIEW_CREATE_INFO;
+	fontBitmapViewCreateInfo.pNext  = nullptr;
+	fontBitmapViewCreateInfo.flags  = 0;
+	fontBitmapViewCreateInfo.buffer = mFontBitmapBuffer;
+	fontBitmapViewCreateInfo.format = VK_FORMAT_R8_UINT;
+	fontBitmapViewCreateInfo.offset = 0;
+	fontBitmapViewCreateInfo.range  = VK_WHOLE_SIZE;
+
+	ThrowIfFailed(vkCreateBufferView(mDeviceRef, &fontBitmapViewCreateInfo, HostAllocator::Callbacks(), &mFontBitmapBufferView));
+}
+
+void Vulkan::PerformanceHudPass::CreateDescriptorSet()
+{
+	std::array<VkDescriptorSetLayoutBinding, 1> setLayoutBindings;
+	setLayoutBindings[0].binding            = 0;
+	setLayoutBindings[0].descriptorType     = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+	setLayoutBindings[0].descriptorCount    = 1;
+	setLayoutBindings[0].stageFlags         = VK_SHADER_STAGE_FRAGMENT_BIT;
+	setLayoutBindings[0].pImmutableSamplers = nullptr;
+
+	VkDescriptorSetLayoutCreateInfo setLayoutCreateInfo;
+	setLayoutCreateInfo.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	setLayoutCreateInfo.pNext        = nullptr;
+	setLayoutCreateInfo.flags        = 0;
+	setLayoutCreateInfo.bindingCount = (uint32_t)setLayoutBindings.size();
+	setLayoutCreateInfo.pBindings    = setLayoutBindings.data();
+
+	ThrowIfFailed(vkCreateDescriptorSetLayout(mDeviceRef, &setLayoutCreateInfo, HostAllocator::Callbacks(), &mDescriptorSetLayout));
+
+	std::array<VkDescriptorPoolSize, 1> poolSizes;
+	poolSizes[0].type            = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+	poolSizes[0].descriptorCount = 1;
+
+	VkDescriptorPoolCreateInfo descriptorPoolCreateInfo;
+	descriptorPoolCreateInfo.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	descriptorPoolCreateInfo.pNext         = nullptr;
+	descriptorPoolCreateInfo.flags         = 0;
+	descriptorPoolCreateInfo.maxSets       = 1;
+	descriptorPoolCreateInfo.poolSizeCount = (uint32_t)poolSizes.size();
+	descriptorPoolCreateInfo.pPoolSizes    = poolSizes.data();
+
+	ThrowIfFailed(vkCreateDescriptorPool(mDeviceRef, &descriptorPoolCreateInfo, HostAllocator::Callbacks(), &mDescriptorPool));
+
+	std::array setLayouts = {mDescriptorSetLayout};
+
+	VkDescriptorSetAllocateInfo setAllocateInfo;
+	setAllocateInfo.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	setAllocateInfo.pNext              = nullptr;
+	setAllocateInfo.descriptorPool     = mDescriptorPool;
+	setAllocateInfo.descriptorSetCount = (uint32_t)setLayouts.size();
+	setAllocateInfo.pSetLayouts        = setLayouts.data();
+
+	ThrowIfFailed(vkAllocateDescriptorSets(mDeviceRef, &setAllocateInfo, &mDescriptorSet));
+
+	std::array texelBufferViews = {mFontBitmapBufferView};
+
+	VkWriteDescriptorSet writeDescriptorSet;
+	writeDescriptorSet.sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	writeDescriptorSet.pNext            = nullptr;
+	writeDescriptorSet.dstSet           = mDescriptorSet;
+	writeDescriptorSet.dstBinding       = 0;
+	writeDescriptorSet.dstArrayElement  = 0;
+	writeDescriptorSet.descriptorCount  = (uint32_t)texelBufferViews.size();
+	writeDescriptorSet.descriptorType   = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+	writeDescriptorSet.pImageInfo       = nullptr;
+	writeDescriptorSet.pBufferInfo      = nullptr;
+	writeDescriptorSet.pTexelBufferView = texelBufferViews.data();
+
+	std::array writeDescriptorSets = {writeDescriptorSet};
+	vkUpdateDescriptorSets(mDeviceRef, (uint32_t)writeDescriptorSets.size(), writeDescriptorSets.data(), 0, nullptr);
+}
+
+void Vulkan::PerformanceHudPass::CreatePipelineLayout()
+{
+	std::array setLayouts = {mDescriptorSetLayout};
+
+	VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo;
+	pipelineLayoutCreateInfo.sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	pipelineLayoutCreateInfo.pNext                  = nullptr;
+	pipelineLayoutCreateInfo.flags                  = 0;
+	pipelineLayoutCreateInfo.setLayoutCount         = (uint32_t)setLayouts.size();
+	pipelineLayoutCreateInfo.pSetLayouts            = setLayouts.data();
+	pipelineLayoutCreateInfo.pushConstantRangeCount = 0;
+	pipelineLayoutCreateInfo.pPushConstantRanges    = nullptr;
+
+	ThrowIfFailed(vkCreatePipelineLayout(mDeviceRef, &pipelineLayoutCreateInfo, HostAllocator::Callbacks(), &mPipelineLayout));
+}
+
+void Vulkan::PerformanceHudPass::CreatePipeline(LoggerQueue* logger, const FrameGraphConfig* frameGraphConfig)
+{
+	const std::wstring shaderFolder = Utils::GetMainDirectory() + L"Shaders/Vulkan/PerformanceHud/";
+
+	std::vector<uint32_t> vertexShaderCode;
+	VulkanUtils::LoadShaderModuleFromFile(shaderFolder + L"PerformanceHud.vert.spv", vertexShaderCode, logger);
+
+	std::vector<uint32_t> fragmentShaderCode;
+	VulkanUtils::LoadShaderModuleFromFile(shaderFolder + L"PerformanceHud.frag.spv", fragmentShaderCode, logger);
+
+	VkShaderModuleCreateInfo vertexShaderModuleCreateInfo;
+	vertexShaderModuleCreateInfo.sType    = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+	vertexShaderModuleCreateInfo.pNext    = nullptr;
+	vertexShaderModuleCreateInfo.flags    = 0;
+	vertexShaderModuleCreateInfo.codeSize = vertexShaderCode.size() * sizeof(uint32_t);
+	vertexShaderModuleCreateInfo.pCode    = vertexShaderCode.data();
+
+	VkShaderModuleCreateInfo fragmentShaderModuleCreateInfo;
+	fragmentShaderModuleCreateInfo.sType    = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+	fragmentShaderModuleCreateInfo.pNext    = nullptr;
+	fragmentShaderModuleCreateInfo.flags    = 0;
+	fragmentShaderModuleCreateInfo.codeSize = fragmentShaderCode.size() * sizeof(uint32_t);
+	fragmentShaderModuleCreateInfo.pCode    = fragmentShaderCode.data();
+
+	std::array<VkPipelineShaderStageCreateInfo, 2> pipelineShaderStageCreateInfos;
+
+	std::array<VkShaderModule, pipelineShaderStageCreateInfos.size()> shaderModules;
+	ThrowIfFailed(vkCreateShaderModule(mDeviceRef, &vertexShaderModuleCreateInfo,   HostAllocator::Callbacks(), &shaderModules[0]));
+	ThrowIfFailed(vkCreateShaderModule(mDeviceRef, &fragmentShaderModuleCreateInfo, HostAllocator::Callbacks(), &shaderModules[1]));
+
+	const char* enrtyPointName = "main";
+
+	std::array pipelineShaderStages = {VK_SHADER_STAGE_VERTEX_BIT, VK_SHADER_STAGE_FRAGMENT_BIT};
+	for(size_t i = 0; i < pipelineShaderStageCreateInfos.size(); i++)
+	{
+		pipelineShaderStageCreateInfos[i].sType               = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		pipelineShaderStageCreateInfos[i].pNext               = nullptr;
+		pipelineShaderStageCreateInfos[i].flags               = 0;
+		pipelineShaderStageCreateInfos[i].stage               = pipelineShaderStages[i];
+		pipelineShaderStageCreateInfos[i].module              = shaderModules[i];
+		pipelineShaderStageCreateInfos[i].pName               = enrtyPointName;
+		pipelineShaderStageCreateInfos[i].pSpecializationInfo = nullptr;
+	}
+
+
+	//Vertex input state
+	std::array<VkVertexInputBindingDescription, 1> vertexInputBindingDescriptions;
+	vertexInputBindingDescriptions[0].stride    = (uint32_t)sizeof(PerformanceHudVertex);
+	vertexInputBindingDescriptions[0].binding   = 0;
+	vertexInputBindingDescriptions[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+	std::array<VkVertexInputAttributeDescription, 4> vertexAttributeDescriptions;
+	vertexAttributeDescriptions[0].binding  = 0;
+	vertexAttributeDescriptions[0].format   = VulkanUtils::FormatForVectorType<decltype(PerformanceHudVertex::Position)>;
+	vertexAttributeDescriptions[0].location = 0;
+	vertexAttributeDescriptions[0].offset   = offsetof(PerformanceHudVertex, Position);
+	vertexAttributeDescriptions[1].binding  = 0;
+	vertexAttributeDescriptions[1].format   = VulkanUtils::FormatForVectorType<decltype(PerformanceHudVertex::GlyphCoord)>;
+	vertexAttributeDescriptions[1].location = 1;
+	vertexAttributeDescriptions[1].offset   = offsetof(PerformanceHudVertex, GlyphCoord);
+	vertexAttributeDescriptions[2].binding  = 0;
+	vertexAttributeDescriptions[2].format   = VK_FORMAT_R32_UINT;
+	vertexAttributeDescriptions[2].location = 2;
+	vertexAttributeDescriptions[2].offset   = offsetof(PerformanceHudVertex, GlyphIndex);
+	vertexAttributeDescriptions[3].binding  = 0;
+	vertexAttributeDescriptions[3].format   = VK_FORMAT_R8G8B8A8_UNORM;
+	vertexAttributeDescriptions[3].location = 3;
+	vertexAttributeDescriptions[3].offset   = offsetof(PerformanceHudVertex, Color);
+
+	VkPipelineVertexInputStateCreateInfo pipelineVertexInputStateCreateInfo;
+	pipelineVertexInputStateCreateInfo.sType                           = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+	pipelineVertexInputStateCreateInfo.pNext                           = nullptr;
+	pipelineVertexInputStateCreateInfo.flags                           = 0;
+	pipelineVertexInputStateCreateInfo.vertexBindingDescriptionCount   = (uint32_t)(vertexInputBindingDescriptions.size());
+	pipelineVertexInputStateCreateInfo.pVertexBindingDescriptions      = vertexInputBindingDescriptions.data();
+	pipelineVertexInputStateCreateInfo.vertexAttributeDescriptionCount = (uint32_t)(vertexAttributeDescriptions.size());
+	pipelineVertexInputStateCreateInfo.pVertexAttributeDescriptions    = vertexAttributeDescriptions.data();
+
+
+	//Input assembly state
+	VkPipelineInputAssemblyStateCreateInfo pipelineInputAssemblyStateCreateInfo;
+	pipelineInputAssemblyStateCreateInfo.sType                  = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+	pipelineInputAssemblyStateCreateInfo.pNext                  = nullptr;
+	pipelineInputAssemblyStateCreateInfo.flags                  = 0;
+	pipelineInputAssemblyStateCreateInfo.topology               = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+	pipelineInputAssemblyStateCreateInfo.primitiveRestartEnable = false;
+
+
+	//Viewport state
+	std::array<VkViewport, 1> viewports;
+	std::array<VkRect2D, 1>   scissors;
+
+	viewports[0].x        = 0.0f;
+	viewports[0].y        = 0.0f;
+	viewports[0].width    = (float)frameGraphConfig->GetViewportWidth();
+	viewports[0].height   = (float)frameGraphConfig->GetViewportHeight();
+	viewports[0].minDepth = 0.0f;
+	viewports[0].maxDepth = 1.0f;
+
+	scissors[0].offset.x      = 0;
+	scissors[0].offset.y      = 0;
+	scissors[0].extent.width  = frameGraphConfig->GetViewportWidth();
+	scissors[0].extent.height = frameGraphConfig->GetViewportHeight();
+
+	VkPipelineViewportStateCreateInfo pipelineViewportStateCreateInfo;
+	pipelineViewportStateCreateInfo.sType         = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+	pipelineViewportStateCreateInfo.pNext         = nullptr;
+	pipelineViewportStateCreateInfo.flags         = 0;
+	pipelineViewportStateCreateInfo.viewportCount = (uint32_t)(viewports.size());
+	pipelineViewportStateCreateInfo.pViewports    = viewports.data();
+	pipelineViewportStateCreateInfo.scissorCount  = (uint32_t)(scissors.size());
+	pipelineViewportStateCreateInfo.pScissors     = scissors.data();
+
+
+	//Rasterization state
+	VkPipelineRasterizationStateCreateInfo pipelineRasterizationStateCreateInfo;
+	pipelineRasterizationStateCreateInfo.sType                   = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+	pipelineRasterizationStateCreateInfo.pNext                   = nullptr; 
+	pipelineRasterizationStateCreateInfo.flags                   = 0;
+	pipelineRasterizationStateCreateInfo.depthClampEnable        = false;
+	pipelineRasterizationStateCreateInfo.rasterizerDiscardEnable = false;
+	pipelineRasterizationStateCreateInfo.polygonMode             = VK_POLYGON_MODE_FILL;
+	pipelineRasterizationStateCreateInfo.cullMode                = VK_CULL_MODE_NONE;
+	pipelineRasterizationStateCreateInfo.frontFace               = VK_FRONT_FACE_CLOCKWISE;
+	pipelineRasterizationStateCreateInfo.depthBiasEnable         = false;
+	pipelineRasterizationStateCreateInfo.depthBiasConstantFactor = 0.0f;
+	pipelineRasterizationStateCreateInfo.depthBiasClamp          = 0.0f;
+	pipelineRasterizationStateCreateInfo.depthBiasSlopeFactor    = 0.0f;
+	pipelineRasterizationStateCreateInfo.lineWidth               = 1.0f;
+
+
+	//Multisample state
+	std::array sampleMasks = {0xffffffff};
+
+	VkPipelineMultisampleStateCreateInfo pipelineMultisampleStateCreateInfo;
+	pipelineMultisampleStateCreateInfo.sType                 = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+	pipelineMultisampleStateCreateInfo.pNext                 = nullptr;
+	pipelineMultisampleStateCreateInfo.flags                 = 0;
+	pipelineMultisampleStateCreateInfo.rasterizationSamples  = VK_SAMPLE_COUNT_1_BIT;
+	pipelineMultisampleStateCreateInfo.sampleShadingEnable   = VK_FALSE;
+	pipelineMultisampleStateCreateInfo.minSampleShading      = 1.0f;
+	pipelineMultisampleStateCreateInfo.pSampleMask           = sampleMasks.data();
+	pipelineMultisampleStateCreateInfo.alphaToCoverageEnable = VK_FALSE;
+	pipelineMultisampleStateCreateInfo.alphaToOneEnable      = VK_FALSE;
+
+
+	//Depth-stencil state
+	VkPipelineDepthStencilStateCreateInfo pipelineDepthStencilStateCreateInfo;
+	pipelineDepthStencilStateCreateInfo.sType                 = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+	pipelineDepthStencilStateCreateInfo.pNext                 = nullptr;
+	pipelineDepthStencilStateCreateInfo.flags                 = 0;
+	pipelineDepthStencilStateCreateInfo.depthTestEnable       = VK_FALSE;
+	pipelineDepthStencilStateCreateInfo.depthWriteEnable      = VK_FALSE;
+	pipelineDepthStencilStateCreateInfo.depthCompareOp        = VK_COMPARE_OP_ALWAYS;
+	pipelineDepthStencilStateCreateInfo.depthBoundsTestEnable = VK_FALSE;
+	pipelineDepthStencilStateCreateInfo.stencilTestEnable     = VK_FALSE;
+	pipelineDepthStencilStateCreateInfo.front.failOp          = VK_STENCIL_OP_KEEP;
+	pipelineDepthStencilStateCreateInfo.front.passOp          = VK_STENCIL_OP_KEEP;
+	pipelineDepthStencilStateCreateInfo.front.depthFailOp     = VK_STENCIL_OP_KEEP;
+	pipelineDepthStencilStateCreateInfo.front.compareOp       = VK_COMPARE_OP_ALWAYS;
+	pipelineDepthStencilStateCreateInfo.front.compareMask     = 0xffffffff;
+	pipelineDepthStencilStateCreateInfo.front.writeMask       = 0xffffffff;
+	pipelineDepthStencilStateCreateInfo.front.reference       = 0;
+	pipelineDepthStencilStateCreateInfo.back.failOp           = VK_STENCIL_OP_KEEP;
+	pipelineDepthStencilStateCreateInfo.back.passOp           = VK_STENCIL_OP_KEEP;
+	pipelineDepthStencilStateCreateInfo.back.depthFailOp      = VK_STENCIL_OP_KEEP;
+	pipelineDepthStencilStateCreateInfo.back.compareOp        = VK_COMPARE_OP_ALWAYS;
+	pipelineDepthStencilStateCreateInfo.back.compareMask      = 0xffffffff;
+	pipelineDepthStencilStateCreateInfo.back.writeMask        = 0xffffffff;
+	pipelineDepthStencilStateCreateInfo.back.reference        = 0;
+	pipelineDepthStencilStateCreateInfo.minDepthBounds        = 0.0f;
+	pipelineDepthStencilStateCreateInfo.maxDepthBounds        = 1.0f;
+
+
+	//Blend state, the overlay is alpha-blended over the image
+	std::array<VkPipelineColorBlendAttachmentState, 1> blendAttachments;
+	blendAttachments[0].blendEnable         = VK_TRUE;
+	blendAttachments[0].srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+	blendAttachments[0].dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+	blendAttachments[0].colorBlendOp        = VK_BLEND_OP_ADD;
+	blendAttachments[0].srcAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+	blendAttachments[0].dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+	blendAttachments[0].alphaBlendOp        = VK_BLEND_OP_ADD;
+	blendAttachments[0].colorWriteMask      = (VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT);
+
+	VkPipelineColorBlendStateCreateInfo pipelineBlendStateCreateInfo;
+	pipelineBlendStateCreateInfo.sType             = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+	pipelineBlendStateCreateInfo.pNext             = nullptr;
+	pipelineBlendStateCreateInfo.flags             = 0;
+	pipelineBlendStateCreateInfo.logicOpEnable     = VK_FALSE;
+	pipelineBlendStateCreateInfo.logicOp           = VK_LOGIC_OP_NO_OP;
+	pipelineBlendStateCreateInfo.attachmentCount   = (uint32_t)(blendAttachments.size());
+	pipelineBlendStateCreateInfo.pAttachments      = blendAttachments.data();
+	pipelineBlendStateCreateInfo.blendConstants[0] = 1.0f;
+	pipelineBlendStateCreateInfo.blendConstants[1] = 1.0f;
+	pipelineBlendStateCreateInfo.blendConstants[2] = 1.0f;
+	pipelineBlendStateCreateInfo.blendConstants[3] = 1.0f;
+
+
+	//Dynamic state
+	VkPipelineDynamicStateCreateInfo pipelineDynamicStateCreateInfo;
+	pipelineDynamicStateCreateInfo.sType             = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+	pipelineDynamicStateCreateInfo.pNext             = nullptr;
+	pipelineDynamicStateCreateInfo.flags             = 0;
+	pipelineDynamicStateCreateInfo.dynamicStateCount = 0;
+	pipelineDynamicStateCreateInfo.pDynamicStates    = nullptr;
+
+
+	VkGraphicsPipelineCreateInfo hudPipelineCreateInfo;
+	hudPipelineCreateInfo.sType               = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+	hudPipelineCreateInfo.pNext               = nullptr;
+	hudPipelineCreateInfo.flags               = 0;
+	hudPipelineCreateInfo.stageCount          = (uint32_t)(pipelineShaderStageCreateInfos.size());
+	hudPipelineCreateInfo.pStages             = pipelineShaderStageCreateInfos.data();
+	hudPipelineCreateInfo.pVertexInputState   = &pipelineVertexInputStateCreateInfo;
+	hudPipelineCreateInfo.pInputAssemblyState = &pipelineInputAssemblyStateCreateInfo;
+	hudPipelineCreateInfo.pTessellationState  = nullptr;
+	hudPipelineCreateInfo.pViewportState      = &pipelineViewportStateCreateInfo;
+	hudPipelineCreateInfo.pRasterizationState = &pipelineRasterizationStateCreateInfo;
+	hudPipelineCreateInfo.pMultisampleState   = &pipelineMultisampleStateCreateInfo;
+	hudPipelineCreateInfo.pDepthStencilState  = &pipelineDepthStencilStateCreateInfo;
+	hudPipelineCreateInfo.pColorBlendState    = &pipelineBlendStateCreateInfo;
+	hudPipelineCreateInfo.pDynamicState       = &pipelineDynamicStateCreateInfo;
+	hudPipelineCreateInfo.layout              = mPipelineLayout;
+	hudPipelineCreateInfo.renderPass          = mRenderPass;
+	hudPipelineCreateInfo.subpass             = 0;
+	hudPipelineCreateInfo.basePipelineHandle  = nullptr;
+	hudPipelineCreateInfo.basePipelineIndex   = 0;
+
+	std::array graphicsPipelineCreateInfos = {hudPipelineCreateInfo};
+	ThrowIfFailed(vkCreateGraphicsPipelines(mDeviceRef, VK_NULL_HANDLE, (uint32_t)graphicsPipelineCreateInfos.size(), graphicsPipelineCreateInfos.data(), HostAllocator::Callbacks(), &mPipeline));
+
+	for(size_t i = 0; i < shaderModules.size(); i++)
+	{
+		SafeDestroyObject(vkDestroyShaderModule, mDeviceRef, shaderModules[i]);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "../VulkanRenderPass.hpp"
+#include "../VulkanFrameGraphMisc.hpp"
+#include "../../VulkanShaders.hpp"
+#include "../../../Common/FrameGraph/Passes/PerformanceHudPass.hpp"
+#include "../../../Common/RenderingUtils.hpp"
+#include "../../../../Core/DataStructures/Span.hpp"
+#include "../../../../Core/Util.hpp"
+#include <span>
+#include <string>
+#include <array>
+
+class PerformanceHud;
+struct PerformanceHudVertex;
+class LoggerQueue;
+
+namespace Vulkan
+{
+	class DeviceParameters;
+	class MemoryManager;
+
+	class PerformanceHudPass: public RenderPass, public PerformanceHudPassBase
+	{
+	public:
+		inline static void             RegisterSubresources(std::span<SubresourceMetadataPayload> inoutMetadataPayloads);
+		inline static void             RegisterShaders(ShaderDatabase* shaderDatabase);
+		inline static bool             PropagateSubresourceInfos(std::span<SubresourceMetadataPayload> inoutMetadataPayloads);
+		inline static VkDescriptorType GetSubresourceDescriptorType(uint_fast16_t subresourceId);
+
+	public:
+		PerformanceHudPass(const FrameGraphBuilder* frameGraphBuilder, uint32_t frameGraphPassIndex);
+		~PerformanceHudPass();
+
+		void RecordExecution(VkCommandBuffer commandBuffer, const RenderableScene* renderableScene, const FrameGraphConfig& frameGraphConfig, uint32_t frameResourceIndex) const override;
+
+		void ValidateDescriptorSetSpans(DescriptorDatabase* descriptorDatabase, const VkDescriptorSet* originalSetStartPoint) override;
+
+	private:
+		void CreateRenderPass(const FrameGraphBuilder* frameGraphBuilder, uint32_t frameGraphPassId);
+		void CreateFramebuffer(const FrameGraphBuilder* frameGraphBuilder, uint32_t frameGraphPassId, const FrameGraphConfig* frameGraphConfig);
+		void CreateBuffers(const FrameGraphBuilder* frameGraphBuilder);
+		void CreateFontBitmapView();
+		void CreateDescriptorSet();
+		void CreatePipelineLayout();
+		void CreatePipeline(LoggerQueue* logger, const FrameGraphConfig* frameGraphConfig);
+
+	private:
+		PerformanceHud* mPerformanceHudRef;
+		MemoryManager*  mMemoryManagerRef;
+
+		VkRenderPass  mRenderPass;
+		VkFramebuffer mFramebuffer;
+
+		VkPipelineLayout mPipelineLayout;
+		VkPipeline       mPipeline;
+
+		//The font bitmap descriptor is private to the pass and doesn't go through the descriptor databases
+		VkDescriptorSetLayout mDescriptorSetLayout;
+		VkDescriptorPool      mDescriptorPool;
+		VkDescriptorSet       mDescriptorSet;
+
+		//Host-visible vertex buffer, one region of PerformanceHud::MaxVertexCount vertices per frame in flight
+		//The font bitmap buffer shares the same memory, it's written once on creation
+		VkBuffer              mVertexBuffer;
+		VkBuffer              mFontBitmapBuffer;
+		VkBufferView          mFontBitmapBufferView;
+		VkDeviceMemory        mBufferMemory;
+		PerformanceHudVertex* mVertexBufferPointer;
+	};
+}
+
+#include "VulkanPerformanceHudPass.inl"
\ No newline at end of file
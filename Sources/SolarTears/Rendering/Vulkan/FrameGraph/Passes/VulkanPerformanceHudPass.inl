@@ -0,0 +1,26 @@
+inline void Vulkan::PerformanceHudPass::RegisterSubresources(std::span<SubresourceMetadataPayload> inoutMetadataPayloads)
+{
+	assert(inoutMetadataPayloads.size() == (size_t)PassSubresourceId::Count);
+
+	inoutMetadataPayloads[(size_t)PassSubresourceId::ColorBufferImage].Aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+	inoutMetadataPayloads[(size_t)PassSubresourceId::ColorBufferImage].Layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+	inoutMetadataPayloads[(size_t)PassSubresourceId::ColorBufferImage].Usage  = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+	inoutMetadataPayloads[(size_t)PassSubresourceId::ColorBufferImage].Stage  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	inoutMetadataPayloads[(size_t)PassSubresourceId::ColorBufferImage].Access = (VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT);
+	inoutMetadataPayloads[(size_t)PassSubresourceId::ColorBufferImage].Flags  = (TextureFlagAutoBeforeBarrier | TextureFlagAutoAfterBarrier);
+}
+
+inline void Vulkan::PerformanceHudPass::RegisterShaders([[maybe_unused]] ShaderDatabase* shaderDatabase)
+{
+	//The font bitmap binding is not known to the shader database, the pass loads its shaders by itself
+}
+
+inline bool Vulkan::PerformanceHudPass::PropagateSubresourceInfos([[maybe_unused]] std::span<SubresourceMetadataPayload> inoutMetadataPayloads)
+{
+	return false; //No horizontal propagation happens here
+}
+
+inline VkDescriptorType Vulkan::PerformanceHudPass::GetSubresourceDescriptorType([[maybe_unused]] uint_fast16_t subresourceId)
+{
+	return VK_DESCRIPTOR_TYPE_MAX_ENUM; //No subresources in this pass have an associated descriptor type
+}
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "VulkanFrameGraph.hpp"
+#include "../VulkanMemory.hpp"
 #include "../VulkanWorkerCommandBuffers.hpp"
 #include "../VulkanFunctions.hpp"
 #include "../VulkanSwapChain.hpp"
@@ -6,13 +7,18 @@
 #include "../Scene/VulkanScene.hpp"
 #include "../../../Core/ThreadPool.hpp"
 #include "../../Common/RenderingUtils.hpp"
+#include "../../Common/RenderStatistics.hpp"
 #include <array>
 #include <latch>
 
-Vulkan::FrameGraph::FrameGraph(VkDevice device, FrameGraphConfig&& frameGraphConfig, const WorkerCommandBuffers* workerCommandBuffers, DeviceQueues* deviceQueues): ModernFrameGraph(std::move(frameGraphConfig)), mDeviceRef(device), mCommandBuffersRef(workerCommandBuffers), mDeviceQueuesRef(deviceQueues)
+Vulkan::FrameGraph::FrameGraph(VkDevice device, FrameGraphConfig&& frameGraphConfig, const WorkerCommandBuffers* workerCommandBuffers, DeviceQueues* deviceQueues, MemoryManager* memoryManager): ModernFrameGraph(std::move(frameGraphConfig)), mDeviceRef(device), mCommandBuffersRef(workerCommandBuffers), mDeviceQueuesRef(deviceQueues), mMemoryManagerRef(memoryManager)
 {
 	mImageMemory = VK_NULL_HANDLE;
 
+	mTimestampQueryPool = VK_NULL_HANDLE;
+	mTimestampPeriod    = 0.0f;
+	mTimestampsRecorded.fill(false);
+
 	CreateSemaphores();
 }
 
@@ -38,7 +44,9 @@ Vulkan::FrameGraph::~FrameGraph()
 		SafeDestroyObject(vkDestroySemaphore, mDeviceRef, mPresentSemaphores[i]);
 	}
 
-	SafeDestroyObject(vkFreeMemory, mDeviceRef, mImageMemory);
+	SafeDestroyObject(vkDestroyQueryPool, mDeviceRef, mTimestampQueryPool);
+
+	mMemoryManagerRef->FreeMemory(mDeviceRef, mImageMemory);
 }
 
 void Vulkan::FrameGraph::Traverse(ThreadPool* threadPool, RenderableScene* scene, SwapChain* swapchain, VkFence traverseFence, uint32_t frameIndex, uint32_t swapchainImageIndex, VkSemaphore preTraverseSemaphore, VkSemaphore* outPostTraverseSemaphore)
@@ -46,11 +54,17 @@ void Vulkan::FrameGraph::Traverse(ThreadPool* threadPool, RenderableScene* scene
 	uint32_t currentFrameResourceIndex = frameIndex % Utils::InFlightFrameCount;
 	VkSemaphore lastTraverseSemaphore = preTraverseSemaphore;
 
+	if(mTimestampsRecorded[currentFrameResourceIndex])
+	{
+		//The frame that used these timestamps is already finished
+		ReadPassTimestamps(currentFrameResourceIndex);
+	}
+
 	BarrierPassSpan presentAcquirePassBarrierSpan = mRenderPassBarriers[mRenderPassBarriers.size() - SwapChain::SwapchainImageCount + swapchainImageIndex];
 
 	const bool hasAcquirePass    = (presentAcquirePassBarrierSpan.AfterPassBegin != presentAcquirePassBarrierSpan.AfterPassEnd);
 	const bool hasGraphicsPasses = (mGraphicsPassSpansPerDependencyLevel.size() > 0);
-	const bool hasPresentPass    = (presentAcquirePassBarrierSpan.BeforePassBegin != presentAcquirePassBarrierSpan.BeforePassBegin);
+	const bool hasPresentPass    = (presentAcquirePassBarrierSpan.BeforePassBegin != presentAcquirePassBarrierSpan.BeforePassEnd);
 
 	const bool presentPassLast    = hasPresentPass;
 	const bool graphicsPassesLast = hasGraphicsPasses && !presentPassLast;
@@ -75,6 +89,7 @@ void Vulkan::FrameGraph::Traverse(ThreadPool* threadPool, RenderableScene* scene
 
 		uint32_t barrierCount = presentAcquirePassBarrierSpan.AfterPassEnd - presentAcquirePassBarrierSpan.AfterPassBegin;
 		vkCmdPipelineBarrier(acquireCommandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, memoryBarrierPointer, 0, bufferBarrierPointer, barrierCount, imageBarrierPointer);
+		RenderStatisticsAccumulator::ForCurrentThread().AddBarriers(barrierCount);
 
 		EndCommandBuffer(acquireCommandBuffer);
 
@@ -170,6 +185,8 @@ void Vulkan::FrameGraph::Traverse(ThreadPool* threadPool, RenderableScene* scene
 		std::span commandBuffers = {mFrameRecordedGraphicsCommandBuffers.begin(), mFrameRecordedGraphicsCommandBuffers.end()};
 		mDeviceQueuesRef->GraphicsQueueSubmit(commandBuffers, graphicsWaitStages, graphicsWaitSemaphores, graphicsSemaphore, graphicsFenceToSignal);
 
+		mTimestampsRecorded[currentFrameResourceIndex] = (mTimestampQueryPool != VK_NULL_HANDLE);
+
 		lastTraverseSemaphore = mGraphicsSemaphores[currentFrameResourceIndex];
 	}	
 
@@ -186,8 +203,9 @@ void Vulkan::FrameGraph::Traverse(ThreadPool* threadPool, RenderableScene* scene
 		const VkBufferMemoryBarrier* bufferBarrierPointer = nullptr;
 		const VkMemoryBarrier*       memoryBarrierPointer = nullptr;
 
-		uint32_t barrierCount = presentAcquirePassBarrierSpan.BeforePassBegin - presentAcquirePassBarrierSpan.BeforePassEnd;
+		uint32_t barrierCount = presentAcquirePassBarrierSpan.BeforePassEnd - presentAcquirePassBarrierSpan.BeforePassBegin;
 		vkCmdPipelineBarrier(presentCommandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, memoryBarrierPointer, 0, bufferBarrierPointer, barrierCount, imageBarrierPointer);
+		RenderStatisticsAccumulator::ForCurrentThread().AddBarriers(barrierCount);
 
 		EndCommandBuffer(presentCommandBuffer);
 
@@ -212,9 +230,9 @@ void Vulkan::FrameGraph::CreateSemaphores()
 		semaphoreCreateInfo.pNext = nullptr;
 		semaphoreCreateInfo.flags = 0;
 
-		ThrowIfFailed(vkCreateSemaphore(mDeviceRef, &semaphoreCreateInfo, nullptr, &mAcquireSemaphores[i]));
-		ThrowIfFailed(vkCreateSemaphore(mDeviceRef, &semaphoreCreateInfo, nullptr, &mGraphicsSemaphores[i]));
-		ThrowIfFailed(vkCreateSemaphore(mDeviceRef, &semaphoreCreateInfo, nullptr, &mPresentSemaphores[i]));
+		ThrowIfFailed(vkCreateSemaphore(mDeviceRef, &semaphoreCreateInfo, HostAllocator::Callbacks(), &mAcquireSemaphores[i]));
+		ThrowIfFailed(vkCreateSemaphore(mDeviceRef, &semaphoreCreateInfo, HostAllocator::Callbacks(), &mGraphicsSemaphores[i]));
+		ThrowIfFailed(vkCreateSemaphore(mDeviceRef, &semaphoreCreateInfo, HostAllocator::Callbacks(), &mPresentSemaphores[i]));
 	}
 }
 
@@ -238,10 +256,22 @@ void Vulkan::FrameGraph::EndCommandBuffer(VkCommandBuffer cmdBuffer) const
 
 void Vulkan::FrameGraph::RecordGraphicsPasses(VkCommandBuffer graphicsCommandBuffer, const RenderableScene* scene, uint32_t dependencyLevelSpanIndex, uint32_t frameIndex, uint32_t swapchainImageIndex) const
 {
+	RenderStatisticsAccumulator& statistics = RenderStatisticsAccumulator::ForCurrentThread();
+
+	uint32_t frameResourceIndex = frameIndex % Utils::InFlightFrameCount;
+	uint32_t frameQueryStart    = frameResourceIndex * (uint32_t)mRenderPassNames.size() * 2;
+
 	Span<uint32_t> levelSpan = mGraphicsPassSpansPerDependencyLevel[dependencyLevelSpanIndex];
 	for(uint32_t passSpanIndex = levelSpan.Begin; passSpanIndex < levelSpan.End; passSpanIndex++)
 	{
-		uint32_t passIndex = CalcPassIndex(mFrameSpansPerRenderPass[passSpanIndex], frameIndex, swapchainImageIndex);
+		uint32_t passIndex  = CalcPassIndex(mFrameSpansPerRenderPass[passSpanIndex], frameIndex, swapchainImageIndex);
+		uint32_t queryIndex = frameQueryStart + passSpanIndex * 2;
+
+		if(mTimestampQueryPool != VK_NULL_HANDLE)
+		{
+			vkCmdResetQueryPool(graphicsCommandBuffer, mTimestampQueryPool, queryIndex, 2);
+			vkCmdWriteTimestamp(graphicsCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, mTimestampQueryPool, queryIndex);
+		}
 
 		const BarrierPassSpan& barrierSpan            = mRenderPassBarriers[passIndex];
 		uint32_t               beforePassBarrierCount = barrierSpan.BeforePassEnd - barrierSpan.BeforePassBegin;
@@ -254,9 +284,10 @@ void Vulkan::FrameGraph::RecordGraphicsPasses(VkCommandBuffer graphicsCommandBuf
 			const VkMemoryBarrier*       memoryBarrierPointer = nullptr;
 
 			vkCmdPipelineBarrier(graphicsCommandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, memoryBarrierPointer, 0, bufferBarrierPointer, beforePassBarrierCount, imageBarrierPointer);
+			statistics.AddBarriers(beforePassBarrierCount);
 		}
 
-		mRenderPasses[passIndex]->RecordExecution(graphicsCommandBuffer, scene, mFrameGraphConfig);
+		mRenderPasses[passIndex]->RecordExecution(graphicsCommandBuffer, scene, mFrameGraphConfig, frameResourceIndex);
 
 		if(afterPassBarrierCount != 0)
 		{
@@ -264,7 +295,37 @@ void Vulkan::FrameGraph::RecordGraphicsPasses(VkCommandBuffer graphicsCommandBuf
 			const VkBufferMemoryBarrier* bufferBarrierPointer = nullptr;
 			const VkMemoryBarrier*       memoryBarrierPointer = nullptr;
 
-			vkCmdPipelineBarrier(graphicsCommandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, memoryBarrierPointer, 0, bufferBarrierPointer, beforePassBarrierCount, imageBarrierPointer);
+			vkCmdPipelineBarrier(graphicsCommandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, memoryBarrierPointer, 0, bufferBarrierPointer, afterPassBarrierCount, imageBarrierPointer);
+			statistics.AddBarriers(afterPassBarrierCount);
+		}
+
+		if(mTimestampQueryPool != VK_NULL_HANDLE)
+		{
+			vkCmdWriteTimestamp(graphicsCommandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, mTimestampQueryPool, queryIndex + 1);
 		}
 	}
+}
+
+void Vulkan::FrameGraph::ReadPassTimestamps(uint32_t frameResourceIndex)
+{
+	uint32_t frameQueryCount = (uint32_t)mRenderPassNames.size() * 2;
+	uint32_t frameQueryStart = frameResourceIndex * frameQueryCount;
+
+	//Only the passes executed on the previous use of this frame resource have valid results
+	VkDeviceSize readbackDataSize = mTimestampReadbackData.size() * sizeof(uint64_t);
+	VkResult queryResult = vkGetQueryPoolResults(mDeviceRef, mTimestampQueryPool, frameQueryStart, frameQueryCount, readbackDataSize, mTimestampReadbackData.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+	if(queryResult == VK_NOT_READY)
+	{
+		return;
+	}
+
+	ThrowIfFailed(queryResult);
+
+	for(uint32_t passSpanIndex = 0; passSpanIndex < mRenderPassNames.size(); passSpanIndex++)
+	{
+		uint64_t passBeginTimestamp = mTimestampReadbackData[passSpanIndex * 2 + 0];
+		uint64_t passEndTimestamp   = mTimestampReadbackData[passSpanIndex * 2 + 1];
+
+		mRenderPassGpuTimesMs[passSpanIndex] = (float)((double)(passEndTimestamp - passBeginTimestamp) * (double)mTimestampPeriod / 1000000.0);
+	}
 }
\ No newline at end of file
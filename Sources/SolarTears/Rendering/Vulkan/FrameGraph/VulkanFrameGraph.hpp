@@ -3,6 +3,7 @@
 #include <vector>
 #include <memory>
 #include <unordered_set>
+#include <array>
 #include "VulkanRenderPass.hpp"
 #include "../../Common/RenderingUtils.hpp"
 #include "../../Common/FrameGraph/FrameGraphConfig.hpp"
@@ -15,13 +16,14 @@ namespace Vulkan
 	class WorkerCommandBuffers;
 	class SwapChain;
 	class DeviceQueues;
+	class MemoryManager;
 
 	class FrameGraph: public ModernFrameGraph
 	{
 		friend class FrameGraphBuilder;
 
 	public:
-		FrameGraph(VkDevice device, FrameGraphConfig&& frameGraphConfig, const WorkerCommandBuffers* workerCommandBuffers, DeviceQueues* deviceQueues);
+		FrameGraph(VkDevice device, FrameGraphConfig&& frameGraphConfig, const WorkerCommandBuffers* workerCommandBuffers, DeviceQueues* deviceQueues, MemoryManager* memoryManager);
 		~FrameGraph();
 
 		void Traverse(ThreadPool* threadPool, RenderableScene* scene, SwapChain* swapchain, VkFence traverseFence, uint32_t frameIndex, uint32_t swapchainImageIndex, VkSemaphore preTraverseSemaphore, VkSemaphore* outPostTraverseSemaphore);
@@ -34,11 +36,14 @@ namespace Vulkan
 
 		void RecordGraphicsPasses(VkCommandBuffer graphicsCommandBuffer, const RenderableScene* scene, uint32_t dependencyLevelSpanIndex, uint32_t frameIndex, uint32_t swapchainImageIndex) const;
 
+		void ReadPassTimestamps(uint32_t frameResourceIndex);
+
 	private:
 		const VkDevice mDeviceRef;
 
 		const WorkerCommandBuffers* mCommandBuffersRef;
 		const DeviceQueues*         mDeviceQueuesRef;
+		MemoryManager*              mMemoryManagerRef;
 
 		std::vector<std::unique_ptr<RenderPass>> mRenderPasses; //All render passes
 
@@ -58,5 +63,11 @@ namespace Vulkan
 		std::vector<VkCommandBuffer> mFrameRecordedGraphicsCommandBuffers;
 
 		std::vector<Span<uint32_t>> mOwnedImageSpans;
+
+		//Per-pass GPU timestamps, two per pass per frame in flight. The pool is VK_NULL_HANDLE if the device doesn't support timestamps
+		VkQueryPool                                 mTimestampQueryPool;
+		float                                       mTimestampPeriod;
+		std::array<bool, Utils::InFlightFrameCount> mTimestampsRecorded;
+		std::vector<uint64_t>                       mTimestampReadbackData;
 	};
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "VulkanFrameGraphBuilder.hpp"
 #include "VulkanFrameGraph.hpp"
 #include "../VulkanInstanceParameters.hpp"
+#include "../VulkanDeviceParameters.hpp"
 #include "../VulkanWorkerCommandBuffers.hpp"
 #include "../VulkanFunctions.hpp"
 #include "../VulkanMemory.hpp"
@@ -41,6 +42,21 @@ const Vulkan::DeviceParameters* Vulkan::FrameGraphBuilder::GetDeviceParameters()
 	return mDeviceParameters;
 }
 
+Vulkan::MemoryManager* Vulkan::FrameGraphBuilder::GetMemoryManager() const
+{
+	return mMemoryManager;
+}
+
+PerformanceHud* Vulkan::FrameGraphBuilder::GetPerformanceHud() const
+{
+	return mPerformanceHud;
+}
+
+LoggerQueue* Vulkan::FrameGraphBuilder::GetLogger() const
+{
+	return mLogger;
+}
+
 Vulkan::ShaderDatabase* Vulkan::FrameGraphBuilder::GetShaderDatabase() const
 {
 	return mShaderDatabase.get();
@@ -182,6 +198,7 @@ void Vulkan::FrameGraphBuilder::Build(FrameGraphDescription&& frameGraphDescript
 	mMemoryManager        = buildInfo.MemoryAllocator;
 	mDeviceQueues         = buildInfo.Queues;
 	mWorkerCommandBuffers = buildInfo.CommandBuffers;
+	mPerformanceHud       = buildInfo.Hud;
 
 	ModernFrameGraphBuilder::Build(std::move(frameGraphDescription));
 }
@@ -363,7 +380,7 @@ void Vulkan::FrameGraphBuilder::CreateTextures()
 			}
 
 			VkImage image = VK_NULL_HANDLE;
-			ThrowIfFailed(vkCreateImage(mVulkanGraphToBuild->mDeviceRef, &imageCreateInfo, nullptr, &image));
+			ThrowIfFailed(vkCreateImage(mVulkanGraphToBuild->mDeviceRef, &imageCreateInfo, HostAllocator::Callbacks(), &image));
 			mVulkanGraphToBuild->mImages[resourceMetadataIndex] = image;
 
 			bindImageMemoryInfos.push_back(VkBindImageMemoryInfo
@@ -429,8 +446,8 @@ void Vulkan::FrameGraphBuilder::CreateTextures()
 
 
 	//Allocate the memory
-	SafeDestroyObject(vkFreeMemory, mVulkanGraphToBuild->mDeviceRef, mVulkanGraphToBuild->mImageMemory);
-	mVulkanGraphToBuild->mImageMemory = mMemoryManager->AllocateImagesMemory(mVulkanGraphToBuild->mDeviceRef, bindImageMemoryInfos);
+	mMemoryManager->FreeMemory(mVulkanGraphToBuild->mDeviceRef, mVulkanGraphToBuild->mImageMemory);
+	mVulkanGraphToBuild->mImageMemory = mMemoryManager->AllocateImagesMemory(mVulkanGraphToBuild->mDeviceRef, bindImageMemoryInfos, MemoryManager::AllocationCategory::FrameGraphImages);
 
 	//Barrier the images
 	VkCommandPool   graphicsCommandPool   = mWorkerCommandBuffers->GetMainThreadGraphicsCommandPool(0);
@@ -525,6 +542,35 @@ void Vulkan::FrameGraphBuilder::BuildPassObjects()
 
 	//Allocate a separate storage for each per-thread command buffer
 	mVulkanGraphToBuild->mFrameRecordedGraphicsCommandBuffers.resize(mVulkanGraphToBuild->mGraphicsPassSpansPerDependencyLevel.size());
+
+	CreateTimestampQueries();
+}
+
+void Vulkan::FrameGraphBuilder::CreateTimestampQueries()
+{
+	const VkPhysicalDeviceLimits& limits = mDeviceParameters->GetDeviceProperties().limits;
+
+	uint32_t passCount = (uint32_t)mVulkanGraphToBuild->mRenderPassNames.size();
+	if(passCount == 0 || !limits.timestampComputeAndGraphics)
+	{
+		return;
+	}
+
+	//Two timestamps (begin and end) per pass per frame in flight
+	uint32_t frameQueryCount = passCount * 2;
+
+	VkQueryPoolCreateInfo queryPoolCreateInfo;
+	queryPoolCreateInfo.sType              = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	queryPoolCreateInfo.pNext              = nullptr;
+	queryPoolCreateInfo.flags              = 0;
+	queryPoolCreateInfo.queryType          = VK_QUERY_TYPE_TIMESTAMP;
+	queryPoolCreateInfo.queryCount         = frameQueryCount * Utils::InFlightFrameCount;
+	queryPoolCreateInfo.pipelineStatistics = 0;
+
+	ThrowIfFailed(vkCreateQueryPool(mVulkanGraphToBuild->mDeviceRef, &queryPoolCreateInfo, HostAllocator::Callbacks(), &mVulkanGraphToBuild->mTimestampQueryPool));
+
+	mVulkanGraphToBuild->mTimestampPeriod = limits.timestampPeriod;
+	mVulkanGraphToBuild->mTimestampReadbackData.resize(frameQueryCount, 0);
 }
 
 void Vulkan::FrameGraphBuilder::CreateBeforePassBarriers(const PassMetadata& passMetadata, uint32_t barrierSpanIndex)
@@ -706,7 +752,7 @@ VkImageView Vulkan::FrameGraphBuilder::CreateImageView(VkImage image, VkFormat f
 	imageViewCreateInfo.subresourceRange.layerCount     = 1;
 
 	VkImageView imageView = VK_NULL_HANDLE;
-	ThrowIfFailed(vkCreateImageView(mVulkanGraphToBuild->mDeviceRef, &imageViewCreateInfo, nullptr, &imageView));
+	ThrowIfFailed(vkCreateImageView(mVulkanGraphToBuild->mDeviceRef, &imageViewCreateInfo, HostAllocator::Callbacks(), &imageView));
 
 	return imageView;
 }
@@ -10,6 +10,9 @@
 #include "../../../Core/DataStructures/Span.hpp"
 #include "../../Common/FrameGraph/ModernFrameGraphBuilder.hpp"
 
+class PerformanceHud;
+class LoggerQueue;
+
 namespace Vulkan
 {
 	class FrameGraph;
@@ -28,9 +31,10 @@ namespace Vulkan
 	{
 		const InstanceParameters*   InstanceParams;
 		const DeviceParameters*     DeviceParams; 
-		const MemoryManager*        MemoryAllocator; 
+		MemoryManager*              MemoryAllocator; 
 		const DeviceQueues*         Queues;
 		const WorkerCommandBuffers* CommandBuffers;
+		PerformanceHud*             Hud;
 	};
 
 	class FrameGraphBuilder final: public ModernFrameGraphBuilder
@@ -45,6 +49,9 @@ namespace Vulkan
 		const DeviceParameters* GetDeviceParameters() const;
 		const DeviceQueues*     GetDeviceQueues()     const;
 		const SwapChain*        GetSwapChain()        const;
+		MemoryManager*          GetMemoryManager()    const;
+		PerformanceHud*         GetPerformanceHud()   const;
+		LoggerQueue*            GetLogger()           const;
 		
 		ShaderDatabase* GetShaderDatabase() const;
 
@@ -80,6 +87,9 @@ namespace Vulkan
 		//Creates an image view
 		VkImageView CreateImageView(VkImage image, VkFormat format, VkImageAspectFlags aspect) const;
 
+		//Creates the query pool for per-pass GPU timestamps
+		void CreateTimestampQueries();
+
 	private:
 		//Registers subresource api-specific metadata
 		void InitMetadataPayloads() override final;
@@ -121,7 +131,8 @@ namespace Vulkan
 		const WorkerCommandBuffers* mWorkerCommandBuffers;
 		const InstanceParameters*   mInstanceParameters;
 		const DeviceParameters*     mDeviceParameters;
-		const MemoryManager*        mMemoryManager;
+		MemoryManager*              mMemoryManager;
+		PerformanceHud*             mPerformanceHud;
 
 		std::unique_ptr<ShaderDatabase> mShaderDatabase;
 	};
@@ -3,6 +3,7 @@
 #include "../../Common/FrameGraph/RenderPassDispatchFuncs.hpp"
 #include "Passes/VulkanGBufferPass.hpp"
 #include "Passes/VulkanCopyImagePass.hpp"
+#include "Passes/VulkanPerformanceHudPass.hpp"
 #include "VulkanFrameGraphMisc.hpp"
 #include <memory>
 #include <vulkan/vulkan.h>
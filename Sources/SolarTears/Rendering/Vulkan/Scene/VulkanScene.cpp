@@ -10,7 +10,7 @@
 #include "../../Common/RenderingUtils.hpp"
 #include <array>
 
-Vulkan::RenderableScene::RenderableScene(const VkDevice device, const DeviceParameters& deviceParameters): ModernRenderableScene(VulkanUtils::CalcUniformAlignment(deviceParameters)), mDeviceRef(device)
+Vulkan::RenderableScene::RenderableScene(const VkDevice device, const DeviceParameters& deviceParameters, MemoryManager* memoryManager): ModernRenderableScene(VulkanUtils::CalcUniformAlignment(deviceParameters)), mDeviceRef(device), mMemoryManagerRef(memoryManager)
 {
 	mSceneVertexBuffer  = VK_NULL_HANDLE;
 	mSceneIndexBuffer   = VK_NULL_HANDLE;
@@ -28,15 +28,21 @@ Vulkan::RenderableScene::RenderableScene(const VkDevice device, const DevicePara
 		semaphoreCreateInfo.pNext = nullptr;
 		semaphoreCreateInfo.flags = 0;
 
-		ThrowIfFailed(vkCreateSemaphore(device, &semaphoreCreateInfo, nullptr, &mUploadCopySemaphores[frameIndex]));
+		ThrowIfFailed(vkCreateSemaphore(device, &semaphoreCreateInfo, HostAllocator::Callbacks(), &mUploadCopySemaphores[frameIndex]));
 	}
 }
 
 Vulkan::RenderableScene::~RenderableScene()
+{
+	DestroyDeviceResources();
+}
+
+void Vulkan::RenderableScene::DestroyDeviceResources()
 {
 	if(mSceneUploadDataBufferPointer != nullptr)
 	{
 		vkUnmapMemory(mDeviceRef, mBufferHostVisibleMemory);
+		mSceneUploadDataBufferPointer = nullptr;
 	}
 
 	SafeDestroyObject(vkDestroyBuffer, mDeviceRef, mSceneVertexBuffer);
@@ -54,9 +60,12 @@ Vulkan::RenderableScene::~RenderableScene()
 		SafeDestroyObject(vkDestroyImage, mDeviceRef, mSceneTextures[i]);
 	}
 
-	SafeDestroyObject(vkFreeMemory, mDeviceRef, mTextureMemory);
-	SafeDestroyObject(vkFreeMemory, mDeviceRef, mBufferMemory);
-	SafeDestroyObject(vkFreeMemory, mDeviceRef, mBufferHostVisibleMemory);
+	mSceneTextureViews.clear();
+	mSceneTextures.clear();
+
+	mMemoryManagerRef->FreeMemory(mDeviceRef, mTextureMemory);
+	mMemoryManagerRef->FreeMemory(mDeviceRef, mBufferMemory);
+	mMemoryManagerRef->FreeMemory(mDeviceRef, mBufferHostVisibleMemory);
 }
 
 void Vulkan::RenderableScene::CopyUploadedSceneObjects(WorkerCommandBuffers* commandBuffers, DeviceQueues* deviceQueues, uint32_t frameResourceIndex)
@@ -93,6 +102,7 @@ void Vulkan::RenderableScene::CopyUploadedSceneObjects(WorkerCommandBuffers* com
 	}
 
 	vkCmdCopyBuffer(cmdBuffer, mSceneUploadBuffer, mSceneUniformBuffer, mCurrFrameUpdatedObjectCount + 1, mCurrFrameUploadCopyRegions.data());
+	RenderStatisticsAccumulator::ForCurrentThread().AddUploadCopies(mCurrFrameUpdatedObjectCount + 1, mFrameChunkDataSize + (uint64_t)mCurrFrameUpdatedObjectCount * mObjectChunkDataSize);
 
 	ThrowIfFailed(vkEndCommandBuffer(cmdBuffer));
 
@@ -6,6 +6,7 @@
 #include "../VulkanDeviceParameters.hpp"
 #include "../../Common/Scene/ModernRenderableScene.hpp"
 #include "../../Common/RenderingUtils.hpp"
+#include "../../Common/RenderStatistics.hpp"
 #include "../../../Core/FrameCounter.hpp"
 #include "../VulkanFunctions.hpp"
 
@@ -13,6 +14,7 @@ namespace Vulkan
 {
 	class WorkerCommandBuffers;
 	class DeviceQueues;
+	class MemoryManager;
 
 	class RenderableScene: public ModernRenderableScene
 	{
@@ -20,7 +22,7 @@ namespace Vulkan
 		friend class SharedDescriptorDatabaseBuilder;
 
 	public:
-		RenderableScene(const VkDevice device, const DeviceParameters& deviceParameters);
+		RenderableScene(const VkDevice device, const DeviceParameters& deviceParameters, MemoryManager* memoryManager);
 		~RenderableScene();
 
 	public:
@@ -35,8 +37,13 @@ namespace Vulkan
 		template<typename MeshCallback, typename SubmeshCallback>
 		inline void DrawNonStaticObjects(VkCommandBuffer commandBuffer, MeshCallback meshCallback, SubmeshCallback submeshCallback) const;
 
+	private:
+		//Destroy the buffers and textures and free their memory. The scene that replaces this one can do it before allocating its own
+		void DestroyDeviceResources();
+
 	private:
 		const VkDevice mDeviceRef;
+		MemoryManager* mMemoryManagerRef;
 
 		VkBuffer mSceneVertexBuffer;
 		VkBuffer mSceneIndexBuffer;
@@ -1,12 +1,17 @@
 template<typename SubmeshCallback>
 void RenderableScene::DrawStaticObjects(VkCommandBuffer commandBuffer, SubmeshCallback submeshCallback) const
 {
-	for(uint32_t meshIndex = mStaticUniqueMeshSpan.Begin; meshIndex < mStaticUniqueMeshSpan.End; meshIndex++)
+	RenderStatisticsAccumulator& statistics = RenderStatisticsAccumulator::ForCurrentThread();
+
+	for(uint32_t meshIndex: GetVisibleStaticMeshIndices())
 	{
 		for(uint32_t submeshIndex = mSceneMeshes[meshIndex].FirstSubmeshIndex; submeshIndex < mSceneMeshes[meshIndex].AfterLastSubmeshIndex; submeshIndex++)
 		{
 			submeshCallback(commandBuffer, mSceneSubmeshes[submeshIndex].MaterialIndex);
-			vkCmdDrawIndexed(commandBuffer, mSceneSubmeshes[submeshIndex].IndexCount, mSceneMeshes[meshIndex].InstanceCount, mSceneSubmeshes[submeshIndex].FirstIndex, mSceneSubmeshes[submeshIndex].VertexOffset, 0);
+			statistics.AddPushConstantUpdates(1);
+			const SceneSubmeshLod& submeshLod = GetSubmeshLod(meshIndex, submeshIndex);
+			vkCmdDrawIndexed(commandBuffer, submeshLod.IndexCount, mSceneMeshes[meshIndex].InstanceCount, submeshLod.FirstIndex, mSceneSubmeshes[submeshIndex].VertexOffset, 0);
+			statistics.AddDraw(submeshLod.IndexCount, mSceneMeshes[meshIndex].InstanceCount);
 		}
 	}
 }
@@ -14,13 +19,20 @@ void RenderableScene::DrawStaticObjects(VkCommandBuffer commandBuffer, SubmeshCa
 template<typename MeshCallback, typename SubmeshCallback>
 void RenderableScene::DrawNonStaticObjects(VkCommandBuffer commandBuffer, MeshCallback meshCallback, SubmeshCallback submeshCallback) const
 {
-	for(uint32_t meshIndex = mNonStaticMeshSpan.Begin; meshIndex < mNonStaticMeshSpan.End; meshIndex++)
+	RenderStatisticsAccumulator& statistics = RenderStatisticsAccumulator::ForCurrentThread();
+
+	for(uint32_t meshIndex: GetVisibleNonStaticMeshIndices())
 	{
 		meshCallback(commandBuffer, mSceneMeshes[meshIndex].PerObjectDataIndex);
+		statistics.AddPushConstantUpdates(1);
+
 		for(uint32_t submeshIndex = mSceneMeshes[meshIndex].FirstSubmeshIndex; submeshIndex < mSceneMeshes[meshIndex].AfterLastSubmeshIndex; submeshIndex++)
 		{
 			submeshCallback(commandBuffer, mSceneSubmeshes[submeshIndex].MaterialIndex);
-			vkCmdDrawIndexed(commandBuffer, mSceneSubmeshes[submeshIndex].IndexCount, mSceneMeshes[meshIndex].InstanceCount, mSceneSubmeshes[submeshIndex].FirstIndex, mSceneSubmeshes[submeshIndex].VertexOffset, 0);
+			statistics.AddPushConstantUpdates(1);
+			const SceneSubmeshLod& submeshLod = GetSubmeshLod(meshIndex, submeshIndex);
+			vkCmdDrawIndexed(commandBuffer, submeshLod.IndexCount, mSceneMeshes[meshIndex].InstanceCount, submeshLod.FirstIndex, mSceneSubmeshes[submeshIndex].VertexOffset, 0);
+			statistics.AddDraw(submeshLod.IndexCount, mSceneMeshes[meshIndex].InstanceCount);
 		}
 	}
 }
\ No newline at end of file
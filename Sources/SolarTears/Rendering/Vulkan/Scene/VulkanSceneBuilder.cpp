@@ -9,23 +9,44 @@
 #include "../../../../3rdParty/DDSTextureLoaderVk/DDSTextureLoaderVk.h"
 #include <array>
 #include <cassert>
+#include <utility>
+
+namespace
+{
+	//The texture loader creates images by itself. They are destroyed by the scene, so they have to be created with the same allocation callbacks
+	VKAPI_ATTR VkResult VKAPI_CALL CreateTextureImage(VkDevice device, const VkImageCreateInfo* pCreateInfo, [[maybe_unused]] const VkAllocationCallbacks* pAllocator, VkImage* pImage)
+	{
+		return vkCreateImage(device, pCreateInfo, Vulkan::HostAllocator::Callbacks(), pImage);
+	}
+
+	//Buffer-to-image copies have to start at a multiple of the texel block size (up to 16 bytes for BC formats) and of 4
+	constexpr uint64_t TextureDataAlignment = 16;
+}
 
 Vulkan::RenderableSceneBuilder::RenderableSceneBuilder(RenderableScene* sceneToBuild, MemoryManager* memoryAllocator, DeviceQueues* deviceQueues, 
-	                                                   WorkerCommandBuffers* workerCommandBuffers, const DeviceParameters* deviceParameters): ModernRenderableSceneBuilder(sceneToBuild, 1), mVulkanSceneToBuild(sceneToBuild), mMemoryAllocator(memoryAllocator),
+	                                                   WorkerCommandBuffers* workerCommandBuffers, const DeviceParameters* deviceParameters): ModernRenderableSceneBuilder(sceneToBuild, TextureDataAlignment), mVulkanSceneToBuild(sceneToBuild), mMemoryAllocator(memoryAllocator),
                                                                                                                                               mDeviceQueues(deviceQueues), mWorkerCommandBuffers(workerCommandBuffers), mDeviceParametersRef(deviceParameters)
 {
 	assert(sceneToBuild != nullptr);
 
+	mPreviousVulkanSceneRef = nullptr;
+
 	mIntermediateBuffer        = VK_NULL_HANDLE;
 	mIntermediateBufferMemory  = VK_NULL_HANDLE;
 
-	DDSTextureLoaderVk::SetVkCreateImageFuncPtr(vkCreateImage);
+	DDSTextureLoaderVk::SetVkCreateImageFuncPtr(CreateTextureImage);
 }
 
 Vulkan::RenderableSceneBuilder::~RenderableSceneBuilder()
 {
 	SafeDestroyObject(vkDestroyBuffer, mVulkanSceneToBuild->mDeviceRef, mIntermediateBuffer);
-	SafeDestroyObject(vkFreeMemory,    mVulkanSceneToBuild->mDeviceRef, mIntermediateBufferMemory);
+	mMemoryAllocator->FreeMemory(mVulkanSceneToBuild->mDeviceRef, mIntermediateBufferMemory);
+}
+
+void Vulkan::RenderableSceneBuilder::SetPreviousScene(RenderableScene* previousScene)
+{
+	ModernRenderableSceneBuilder::SetPreviousScene(previousScene);
+	mPreviousVulkanSceneRef = previousScene;
 }
 
 void Vulkan::RenderableSceneBuilder::CreateVertexBufferInfo(size_t vertexDataSize)
@@ -46,7 +67,7 @@ void Vulkan::RenderableSceneBuilder::CreateVertexBufferInfo(size_t vertexDataSiz
 	vertexBufferCreateInfo.queueFamilyIndexCount = (uint32_t)bufferQueueFamilies.size();
 	vertexBufferCreateInfo.pQueueFamilyIndices   = bufferQueueFamilies.data();
 
-	ThrowIfFailed(vkCreateBuffer(mVulkanSceneToBuild->mDeviceRef, &vertexBufferCreateInfo, nullptr, &mVulkanSceneToBuild->mSceneVertexBuffer));
+	ThrowIfFailed(vkCreateBuffer(mVulkanSceneToBuild->mDeviceRef, &vertexBufferCreateInfo, HostAllocator::Callbacks(), &mVulkanSceneToBuild->mSceneVertexBuffer));
 }
 
 void Vulkan::RenderableSceneBuilder::CreateIndexBufferInfo(size_t indexDataSize)
@@ -67,7 +88,7 @@ void Vulkan::RenderableSceneBuilder::CreateIndexBufferInfo(size_t indexDataSize)
 	indexBufferCreateInfo.queueFamilyIndexCount = (uint32_t)bufferQueueFamilies.size();
 	indexBufferCreateInfo.pQueueFamilyIndices   = bufferQueueFamilies.data();
 
-	ThrowIfFailed(vkCreateBuffer(mVulkanSceneToBuild->mDeviceRef, &indexBufferCreateInfo, nullptr, &mVulkanSceneToBuild->mSceneIndexBuffer));
+	ThrowIfFailed(vkCreateBuffer(mVulkanSceneToBuild->mDeviceRef, &indexBufferCreateInfo, HostAllocator::Callbacks(), &mVulkanSceneToBuild->mSceneIndexBuffer));
 }
 
 void Vulkan::RenderableSceneBuilder::CreateConstantBufferInfo(size_t constantDataSize)
@@ -88,7 +109,7 @@ void Vulkan::RenderableSceneBuilder::CreateConstantBufferInfo(size_t constantDat
 	uniformBufferCreateInfo.queueFamilyIndexCount = (uint32_t)bufferQueueFamilies.size();
 	uniformBufferCreateInfo.pQueueFamilyIndices   = bufferQueueFamilies.data();
 
-	ThrowIfFailed(vkCreateBuffer(mVulkanSceneToBuild->mDeviceRef, &uniformBufferCreateInfo, nullptr, &mVulkanSceneToBuild->mSceneUniformBuffer));
+	ThrowIfFailed(vkCreateBuffer(mVulkanSceneToBuild->mDeviceRef, &uniformBufferCreateInfo, HostAllocator::Callbacks(), &mVulkanSceneToBuild->mSceneUniformBuffer));
 }
 
 void Vulkan::RenderableSceneBuilder::CreateUploadBufferInfo(size_t uploadDataSize)
@@ -109,7 +130,7 @@ void Vulkan::RenderableSceneBuilder::CreateUploadBufferInfo(size_t uploadDataSiz
 	uniformBufferCreateInfo.queueFamilyIndexCount = (uint32_t)bufferQueueFamilies.size();
 	uniformBufferCreateInfo.pQueueFamilyIndices   = bufferQueueFamilies.data();
 
-	ThrowIfFailed(vkCreateBuffer(mVulkanSceneToBuild->mDeviceRef, &uniformBufferCreateInfo, nullptr, &mVulkanSceneToBuild->mSceneUploadBuffer));
+	ThrowIfFailed(vkCreateBuffer(mVulkanSceneToBuild->mDeviceRef, &uniformBufferCreateInfo, HostAllocator::Callbacks(), &mVulkanSceneToBuild->mSceneUploadBuffer));
 }
 
 void Vulkan::RenderableSceneBuilder::AllocateTextureMetadataArrays(size_t textureCount)
@@ -122,7 +143,7 @@ void Vulkan::RenderableSceneBuilder::AllocateTextureMetadataArrays(size_t textur
 	mSceneImageCopyInfos.clear();
 }
 
-void Vulkan::RenderableSceneBuilder::LoadTextureFromFile(const std::wstring& textureFilename, uint64_t currentIntermediateBufferOffset, size_t textureIndex, std::vector<std::byte>& outTextureData)
+void Vulkan::RenderableSceneBuilder::LoadTexture(const std::wstring& textureFilename, std::span<const std::byte> textureDdsData, uint64_t currentIntermediateBufferOffset, size_t textureIndex, std::vector<std::byte>& outTextureData)
 {
 	outTextureData.clear();
 
@@ -131,9 +152,26 @@ void Vulkan::RenderableSceneBuilder::LoadTextureFromFile(const std::wstring& tex
 
 	VkImage texture = VK_NULL_HANDLE;
 	VkImageCreateInfo createInfo;
-	DDSTextureLoaderVk::LoadDDSTextureFromFile(mVulkanSceneToBuild->mDeviceRef, textureFilename.c_str(), &texture, texData, subresources, mDeviceParametersRef->GetDeviceProperties().limits.maxImageDimension2D, &createInfo);
+	if(textureDdsData.empty())
+	{
+		DDSTextureLoaderVk::LoadDDSTextureFromFile(mVulkanSceneToBuild->mDeviceRef, textureFilename.c_str(), &texture, texData, subresources, mDeviceParametersRef->GetDeviceProperties().limits.maxImageDimension2D, &createInfo);
+	}
+	else
+	{
+		//The subresources point into textureDdsData
+		DDSTextureLoaderVk::LoadDDSTextureFromMemory(mVulkanSceneToBuild->mDeviceRef, reinterpret_cast<const uint8_t*>(textureDdsData.data()), textureDdsData.size(), &texture, subresources, mDeviceParametersRef->GetDeviceProperties().limits.maxImageDimension2D, &createInfo);
+	}
+
+	if(mPatchingPreviousScene)
+	{
+		//Only the data is needed, the image of the previous scene has the same size and format
+		SafeDestroyObject(vkDestroyImage, mVulkanSceneToBuild->mDeviceRef, texture);
+	}
+	else
+	{
+		mVulkanSceneToBuild->mSceneTextures[textureIndex] = texture;
+	}
 
-	mVulkanSceneToBuild->mSceneTextures[textureIndex] = texture;
 	mSceneImageFormats[textureIndex] = createInfo.format;
 
 	uint32_t subresourceSliceBegin = (uint32_t)(mSceneImageCopyInfos.size());
@@ -141,16 +179,18 @@ void Vulkan::RenderableSceneBuilder::LoadTextureFromFile(const std::wstring& tex
 	mSceneTextureSubresourceSpans[textureIndex] = {.Begin = subresourceSliceBegin, .End = subresourceSliceEnd};
 	mSceneImageCopyInfos.resize(mSceneImageCopyInfos.size() + subresources.size());
 
-	VkDeviceSize currentOffset = (VkDeviceSize)currentIntermediateBufferOffset;
 	for(size_t j = 0; j < subresources.size(); j++)
 	{
 		uint32_t globalSubresourceIndex = subresourceSliceBegin + (uint32_t)j;
 
-		currentOffset = outTextureData.size();
+		//The small mips can have the sizes not divisible by the alignment
+		outTextureData.resize(Utils::AlignMemory(outTextureData.size(), TextureDataAlignment));
+
+		VkDeviceSize currentOffset = (VkDeviceSize)(currentIntermediateBufferOffset + outTextureData.size());
 		outTextureData.insert(outTextureData.end(), reinterpret_cast<const std::byte*>(subresources[j].PData), reinterpret_cast<const std::byte*>(subresources[j].PData + subresources[j].DataByteSize));
 
 		VkBufferImageCopy& bufferImageCopy = mSceneImageCopyInfos[globalSubresourceIndex];
-		bufferImageCopy.bufferOffset                    = currentOffset + mIntermediateBufferTextureDataOffset;
+		bufferImageCopy.bufferOffset                    = currentOffset;
 		bufferImageCopy.bufferRowLength                 = 0;
 		bufferImageCopy.bufferImageHeight               = 0;
 		bufferImageCopy.imageSubresource.aspectMask     = subresources[j].SubresourceSlice.aspectMask;
@@ -177,6 +217,28 @@ void Vulkan::RenderableSceneBuilder::FinishTextureCreation()
 	CreateImageViews();
 }
 
+void Vulkan::RenderableSceneBuilder::TakePreviousSceneResources()
+{
+	mVulkanSceneToBuild->mSceneVertexBuffer  = std::exchange(mPreviousVulkanSceneRef->mSceneVertexBuffer,  VK_NULL_HANDLE);
+	mVulkanSceneToBuild->mSceneIndexBuffer   = std::exchange(mPreviousVulkanSceneRef->mSceneIndexBuffer,   VK_NULL_HANDLE);
+	mVulkanSceneToBuild->mSceneUniformBuffer = std::exchange(mPreviousVulkanSceneRef->mSceneUniformBuffer, VK_NULL_HANDLE);
+	mVulkanSceneToBuild->mSceneUploadBuffer  = std::exchange(mPreviousVulkanSceneRef->mSceneUploadBuffer,  VK_NULL_HANDLE);
+
+	mVulkanSceneToBuild->mSceneTextures     = std::exchange(mPreviousVulkanSceneRef->mSceneTextures,     std::vector<VkImage>());
+	mVulkanSceneToBuild->mSceneTextureViews = std::exchange(mPreviousVulkanSceneRef->mSceneTextureViews, std::vector<VkImageView>());
+
+	mVulkanSceneToBuild->mBufferMemory            = std::exchange(mPreviousVulkanSceneRef->mBufferMemory,            VK_NULL_HANDLE);
+	mVulkanSceneToBuild->mBufferHostVisibleMemory = std::exchange(mPreviousVulkanSceneRef->mBufferHostVisibleMemory, VK_NULL_HANDLE);
+	mVulkanSceneToBuild->mTextureMemory           = std::exchange(mPreviousVulkanSceneRef->mTextureMemory,           VK_NULL_HANDLE);
+
+	mVulkanSceneToBuild->mCurrFrameUploadCopyRegions.resize(mRigidObjectCount + 1); //One for frame data update and one for each potential object data update
+}
+
+void Vulkan::RenderableSceneBuilder::FreePreviousSceneResources()
+{
+	mPreviousVulkanSceneRef->DestroyDeviceResources();
+}
+
 std::byte* Vulkan::RenderableSceneBuilder::MapUploadBuffer()
 {
 	void* bufferPointer = nullptr;
@@ -199,7 +261,7 @@ void Vulkan::RenderableSceneBuilder::CreateIntermediateBuffer()
 	intermediateBufferCreateInfo.queueFamilyIndexCount = (uint32_t)intermediateBufferQueues.size();
 	intermediateBufferCreateInfo.pQueueFamilyIndices   = intermediateBufferQueues.data();
 
-	vkCreateBuffer(mVulkanSceneToBuild->mDeviceRef, &intermediateBufferCreateInfo, nullptr, &mIntermediateBuffer);
+	vkCreateBuffer(mVulkanSceneToBuild->mDeviceRef, &intermediateBufferCreateInfo, HostAllocator::Callbacks(), &mIntermediateBuffer);
 
 	mIntermediateBufferMemory = mMemoryAllocator->AllocateIntermediateBufferMemory(mVulkanSceneToBuild->mDeviceRef, mIntermediateBuffer);
 
@@ -257,13 +319,41 @@ void Vulkan::RenderableSceneBuilder::WriteInitializationCommands() const
 
 	ThrowIfFailed(vkBeginCommandBuffer(graphicsCommandBuffer, &graphicsCmdBufferBeginInfo));
 
-	std::array sceneBuffers           = {mVulkanSceneToBuild->mSceneVertexBuffer, mVulkanSceneToBuild->mSceneIndexBuffer, mVulkanSceneToBuild->mSceneUniformBuffer};
-	std::array sceneBufferAccessMasks = {VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT,     VK_ACCESS_INDEX_READ_BIT,               VK_ACCESS_UNIFORM_READ_BIT};
+	//Only the buffers with the changed data are copied to
+	std::array sceneBuffers            = {mVulkanSceneToBuild->mSceneVertexBuffer,  mVulkanSceneToBuild->mSceneIndexBuffer, mVulkanSceneToBuild->mSceneUniformBuffer};
+	std::array sceneBufferAccessMasks  = {VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT,      VK_ACCESS_INDEX_READ_BIT,                VK_ACCESS_UNIFORM_READ_BIT};
+	std::array sceneBufferUploadRanges = {&mVertexBufferUploadRanges,               &mIndexBufferUploadRanges,               &mConstantBufferUploadRanges};
+
+	std::vector<VkBufferCopy>   bufferCopyRegions;
+	std::vector<Span<uint32_t>> sceneBufferCopyRegionSpans;
+	std::vector<size_t>         updatedSceneBufferIndices;
+	for(size_t i = 0; i < sceneBuffers.size(); i++)
+	{
+		if(sceneBufferUploadRanges[i]->empty())
+		{
+			continue;
+		}
+
+		uint32_t copyRegionSpanBegin = (uint32_t)bufferCopyRegions.size();
+		for(const BufferUploadRange& uploadRange: *sceneBufferUploadRanges[i])
+		{
+			VkBufferCopy copyRegion;
+			copyRegion.srcOffset = uploadRange.IntermediateBufferOffset;
+			copyRegion.dstOffset = uploadRange.BufferOffset;
+			copyRegion.size      = uploadRange.ByteSize;
+
+			bufferCopyRegions.push_back(copyRegion);
+		}
+
+		sceneBufferCopyRegionSpans.push_back({.Begin = copyRegionSpanBegin, .End = (uint32_t)bufferCopyRegions.size()});
+		updatedSceneBufferIndices.push_back(i);
+	}
 
 	//TODO: multithread this!
-	std::vector<VkImageMemoryBarrier> imageTransferBarriers(mVulkanSceneToBuild->mSceneTextures.size());
-	for(size_t i = 0; i < mVulkanSceneToBuild->mSceneTextures.size(); i++)
+	std::vector<VkImageMemoryBarrier> imageTransferBarriers(mUploadedTextureIndices.size());
+	for(size_t i = 0; i < mUploadedTextureIndices.size(); i++)
 	{
+		//The old contents of the patched textures are overwritten completely
 		imageTransferBarriers[i].sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
 		imageTransferBarriers[i].pNext                           = nullptr;
 		imageTransferBarriers[i].srcAccessMask                   = 0;
@@ -272,7 +362,7 @@ void Vulkan::RenderableSceneBuilder::WriteInitializationCommands() const
 		imageTransferBarriers[i].newLayout                       = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
 		imageTransferBarriers[i].srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
 		imageTransferBarriers[i].dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
-		imageTransferBarriers[i].image                           = mVulkanSceneToBuild->mSceneTextures[i];
+		imageTransferBarriers[i].image                           = mVulkanSceneToBuild->mSceneTextures[mUploadedTextureIndices[i]];
 		imageTransferBarriers[i].subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
 		imageTransferBarriers[i].subresourceRange.baseMipLevel   = 0;
 		imageTransferBarriers[i].subresourceRange.levelCount     = VK_REMAINING_MIP_LEVELS;
@@ -280,8 +370,8 @@ void Vulkan::RenderableSceneBuilder::WriteInitializationCommands() const
 		imageTransferBarriers[i].subresourceRange.layerCount     = VK_REMAINING_ARRAY_LAYERS;
 	}
 
-	std::array<VkBufferMemoryBarrier, sceneBuffers.size()> bufferTransferBarriers;
-	for(size_t i = 0; i < sceneBuffers.size(); i++)
+	std::vector<VkBufferMemoryBarrier> bufferTransferBarriers(updatedSceneBufferIndices.size());
+	for(size_t i = 0; i < updatedSceneBufferIndices.size(); i++)
 	{
 		bufferTransferBarriers[i].sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
 		bufferTransferBarriers[i].pNext               = nullptr;
@@ -289,7 +379,7 @@ void Vulkan::RenderableSceneBuilder::WriteInitializationCommands() const
 		bufferTransferBarriers[i].dstAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT;
 		bufferTransferBarriers[i].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 		bufferTransferBarriers[i].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		bufferTransferBarriers[i].buffer              = sceneBuffers[i];
+		bufferTransferBarriers[i].buffer              = sceneBuffers[updatedSceneBufferIndices[i]];
 		bufferTransferBarriers[i].offset              = 0;
 		bufferTransferBarriers[i].size                = VK_WHOLE_SIZE;
 	}
@@ -301,27 +391,20 @@ void Vulkan::RenderableSceneBuilder::WriteInitializationCommands() const
 		                 (uint32_t)imageTransferBarriers.size(),  imageTransferBarriers.data());
 
 
-	for(size_t i = 0; i < mVulkanSceneToBuild->mSceneTextures.size(); i++)
+	for(uint32_t textureIndex: mUploadedTextureIndices)
 	{
-		Span<uint32_t> subresourceSpan = mSceneTextureSubresourceSpans[i];
-		vkCmdCopyBufferToImage(graphicsCommandBuffer, mIntermediateBuffer, mVulkanSceneToBuild->mSceneTextures[i], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, subresourceSpan.End - subresourceSpan.Begin, mSceneImageCopyInfos.data() + subresourceSpan.Begin);
+		Span<uint32_t> subresourceSpan = mSceneTextureSubresourceSpans[textureIndex];
+		vkCmdCopyBufferToImage(graphicsCommandBuffer, mIntermediateBuffer, mVulkanSceneToBuild->mSceneTextures[textureIndex], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, subresourceSpan.End - subresourceSpan.Begin, mSceneImageCopyInfos.data() + subresourceSpan.Begin);
 	}
 
-	std::array sceneBufferDataOffsets = {mIntermediateBufferVertexDataOffset,                      mIntermediateBufferIndexDataOffset,                     mIntermediateBufferStaticConstantDataOffset};
-	std::array sceneBufferDataSizes   = {mVertexBufferData.size() * sizeof(RenderableSceneVertex), mIndexBufferData.size() * sizeof(RenderableSceneIndex), mStaticConstantData.size() * sizeof(std::byte)};
-	for(size_t i = 0; i < sceneBuffers.size(); i++)
+	for(size_t i = 0; i < updatedSceneBufferIndices.size(); i++)
 	{
-		VkBufferCopy copyRegion;
-		copyRegion.srcOffset = sceneBufferDataOffsets[i];
-		copyRegion.dstOffset = 0;
-		copyRegion.size      = sceneBufferDataSizes[i];
-
-		std::array copyRegions = {copyRegion};
-		vkCmdCopyBuffer(graphicsCommandBuffer, mIntermediateBuffer, sceneBuffers[i], (uint32_t)(copyRegions.size()), copyRegions.data());
+		Span<uint32_t> copyRegionSpan = sceneBufferCopyRegionSpans[i];
+		vkCmdCopyBuffer(graphicsCommandBuffer, mIntermediateBuffer, sceneBuffers[updatedSceneBufferIndices[i]], copyRegionSpan.End - copyRegionSpan.Begin, bufferCopyRegions.data() + copyRegionSpan.Begin);
 	}
 
-	std::vector<VkImageMemoryBarrier> imageValidateBarriers(mVulkanSceneToBuild->mSceneTextures.size());
-	for(size_t i = 0; i < mVulkanSceneToBuild->mSceneTextures.size(); i++)
+	std::vector<VkImageMemoryBarrier> imageValidateBarriers(mUploadedTextureIndices.size());
+	for(size_t i = 0; i < mUploadedTextureIndices.size(); i++)
 	{
 		imageValidateBarriers[i].sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
 		imageValidateBarriers[i].pNext                           = nullptr;
@@ -331,7 +414,7 @@ void Vulkan::RenderableSceneBuilder::WriteInitializationCommands() const
 		imageValidateBarriers[i].newLayout                       = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 		imageValidateBarriers[i].srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
 		imageValidateBarriers[i].dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
-		imageValidateBarriers[i].image                           = mVulkanSceneToBuild->mSceneTextures[i];
+		imageValidateBarriers[i].image                           = mVulkanSceneToBuild->mSceneTextures[mUploadedTextureIndices[i]];
 		imageValidateBarriers[i].subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
 		imageValidateBarriers[i].subresourceRange.baseMipLevel   = 0;
 		imageValidateBarriers[i].subresourceRange.levelCount     = VK_REMAINING_MIP_LEVELS;
@@ -339,16 +422,16 @@ void Vulkan::RenderableSceneBuilder::WriteInitializationCommands() const
 		imageValidateBarriers[i].subresourceRange.layerCount     = VK_REMAINING_ARRAY_LAYERS;
 	}
 
-	std::array<VkBufferMemoryBarrier, sceneBuffers.size()> bufferValidateBarriers;
-	for(size_t i = 0; i < sceneBuffers.size(); i++)
+	std::vector<VkBufferMemoryBarrier> bufferValidateBarriers(updatedSceneBufferIndices.size());
+	for(size_t i = 0; i < updatedSceneBufferIndices.size(); i++)
 	{
 		bufferValidateBarriers[i].sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
 		bufferValidateBarriers[i].pNext               = nullptr;
 		bufferValidateBarriers[i].srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT;
-		bufferValidateBarriers[i].dstAccessMask       = sceneBufferAccessMasks[i];
+		bufferValidateBarriers[i].dstAccessMask       = sceneBufferAccessMasks[updatedSceneBufferIndices[i]];
 		bufferValidateBarriers[i].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 		bufferValidateBarriers[i].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		bufferValidateBarriers[i].buffer              = sceneBuffers[i];
+		bufferValidateBarriers[i].buffer              = sceneBuffers[updatedSceneBufferIndices[i]];
 		bufferValidateBarriers[i].offset              = 0;
 		bufferValidateBarriers[i].size                = VK_WHOLE_SIZE;
 	}
@@ -375,7 +458,7 @@ void Vulkan::RenderableSceneBuilder::WaitForInitializationCommands() const
 
 void Vulkan::RenderableSceneBuilder::AllocateImageMemory()
 {
-	SafeDestroyObject(vkFreeMemory, mVulkanSceneToBuild->mDeviceRef, mVulkanSceneToBuild->mTextureMemory);
+	mMemoryAllocator->FreeMemory(mVulkanSceneToBuild->mDeviceRef, mVulkanSceneToBuild->mTextureMemory);
 
 	std::vector<VkBindImageMemoryInfo> bindImageMemoryInfos(mVulkanSceneToBuild->mSceneTextures.size());
 	for(size_t i = 0; i < mVulkanSceneToBuild->mSceneTextures.size(); i++)
@@ -386,19 +469,19 @@ void Vulkan::RenderableSceneBuilder::AllocateImageMemory()
 		bindImageMemoryInfos[i].image = mVulkanSceneToBuild->mSceneTextures[i];
 	}
 
-	mVulkanSceneToBuild->mTextureMemory = mMemoryAllocator->AllocateImagesMemory(mVulkanSceneToBuild->mDeviceRef, bindImageMemoryInfos);
+	mVulkanSceneToBuild->mTextureMemory = mMemoryAllocator->AllocateImagesMemory(mVulkanSceneToBuild->mDeviceRef, bindImageMemoryInfos, MemoryManager::AllocationCategory::SceneTextures);
 }
 
 void Vulkan::RenderableSceneBuilder::AllocateBuffersMemory()
 {
-	SafeDestroyObject(vkFreeMemory, mVulkanSceneToBuild->mDeviceRef, mVulkanSceneToBuild->mBufferMemory);
-	SafeDestroyObject(vkFreeMemory, mVulkanSceneToBuild->mDeviceRef, mVulkanSceneToBuild->mBufferHostVisibleMemory);
+	mMemoryAllocator->FreeMemory(mVulkanSceneToBuild->mDeviceRef, mVulkanSceneToBuild->mBufferMemory);
+	mMemoryAllocator->FreeMemory(mVulkanSceneToBuild->mDeviceRef, mVulkanSceneToBuild->mBufferHostVisibleMemory);
 
 
 	std::vector deviceLocalBuffers = {mVulkanSceneToBuild->mSceneVertexBuffer, mVulkanSceneToBuild->mSceneIndexBuffer, mVulkanSceneToBuild->mSceneUniformBuffer};
 
 	std::vector<VkDeviceSize> deviceLocalBufferOffsets;
-	mVulkanSceneToBuild->mBufferMemory = mMemoryAllocator->AllocateBuffersMemory(mVulkanSceneToBuild->mDeviceRef, deviceLocalBuffers, MemoryManager::BufferAllocationType::DEVICE_LOCAL, deviceLocalBufferOffsets);
+	mVulkanSceneToBuild->mBufferMemory = mMemoryAllocator->AllocateBuffersMemory(mVulkanSceneToBuild->mDeviceRef, deviceLocalBuffers, MemoryManager::BufferAllocationType::DEVICE_LOCAL, MemoryManager::AllocationCategory::SceneBuffers, deviceLocalBufferOffsets);
 
 	std::vector<VkBindBufferMemoryInfo> bindBufferMemoryInfos(deviceLocalBuffers.size());
 	for(size_t i = 0; i < deviceLocalBuffers.size(); i++)
@@ -417,7 +500,7 @@ void Vulkan::RenderableSceneBuilder::AllocateBuffersMemory()
 	std::vector hostVisibleBuffers = {mVulkanSceneToBuild->mSceneUploadBuffer};
 
 	std::vector<VkDeviceSize> hostVisibleBufferOffsets;
-	mVulkanSceneToBuild->mBufferHostVisibleMemory = mMemoryAllocator->AllocateBuffersMemory(mVulkanSceneToBuild->mDeviceRef, hostVisibleBuffers, MemoryManager::BufferAllocationType::HOST_VISIBLE, hostVisibleBufferOffsets);
+	mVulkanSceneToBuild->mBufferHostVisibleMemory = mMemoryAllocator->AllocateBuffersMemory(mVulkanSceneToBuild->mDeviceRef, hostVisibleBuffers, MemoryManager::BufferAllocationType::HOST_VISIBLE, MemoryManager::AllocationCategory::UploadBuffers, hostVisibleBufferOffsets);
 
 	std::vector<VkBindBufferMemoryInfo> bindHostVisibleBufferMemoryInfos(hostVisibleBuffers.size());
 	for(size_t i = 0; i < hostVisibleBuffers.size(); i++)
@@ -455,7 +538,7 @@ void Vulkan::RenderableSceneBuilder::CreateImageViews()
 		imageViewCreateInfo.subresourceRange.layerCount     = VK_REMAINING_ARRAY_LAYERS;
 
 		VkImageView imageView = VK_NULL_HANDLE;
-		ThrowIfFailed(vkCreateImageView(mVulkanSceneToBuild->mDeviceRef, &imageViewCreateInfo, nullptr, &imageView));
+		ThrowIfFailed(vkCreateImageView(mVulkanSceneToBuild->mDeviceRef, &imageViewCreateInfo, HostAllocator::Callbacks(), &imageView));
 
 		mVulkanSceneToBuild->mSceneTextureViews.push_back(imageView);
 	}
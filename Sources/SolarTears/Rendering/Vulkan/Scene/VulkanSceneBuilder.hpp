@@ -24,18 +24,24 @@ namespace Vulkan
 		RenderableSceneBuilder(RenderableScene* sceneToBuild, MemoryManager* memoryAllocator, DeviceQueues* deviceQueues, WorkerCommandBuffers* workerCommandBuffers, const DeviceParameters* deviceParameters);
 		~RenderableSceneBuilder();
 
+		//The scene the built one replaces, see ModernRenderableSceneBuilder::SetPreviousScene()
+		void SetPreviousScene(RenderableScene* previousScene);
+
 	protected:
 		void CreateVertexBufferInfo(size_t vertexDataSize)     override final;
 		void CreateIndexBufferInfo(size_t indexDataSize)       override final;
 		void CreateConstantBufferInfo(size_t constantDataSize) override final;
 		void CreateUploadBufferInfo(size_t uploadDataSize)     override final;
 
-		void AllocateTextureMetadataArrays(size_t textureCount)                                                                                                              override final;
-		void LoadTextureFromFile(const std::wstring& textureFilename, uint64_t currentIntermediateBufferOffset, size_t textureIndex, std::vector<std::byte>& outTextureData) override final;
+		void AllocateTextureMetadataArrays(size_t textureCount)                                                                                                                                                override final;
+		void LoadTexture(const std::wstring& textureFilename, std::span<const std::byte> textureDdsData, uint64_t currentIntermediateBufferOffset, size_t textureIndex, std::vector<std::byte>& outTextureData) override final;
 
 		virtual void FinishBufferCreation()  override final;
 		virtual void FinishTextureCreation() override final;
 
+		virtual void TakePreviousSceneResources() override final;
+		virtual void FreePreviousSceneResources() override final;
+
 		virtual std::byte* MapUploadBuffer() override final;
 
 		virtual void       CreateIntermediateBuffer()      override final;
@@ -54,6 +60,7 @@ namespace Vulkan
 
 	private:
 		RenderableScene* mVulkanSceneToBuild;
+		RenderableScene* mPreviousVulkanSceneRef;
 
 		MemoryManager*        mMemoryAllocator;
 		DeviceQueues*         mDeviceQueues;
@@ -4,7 +4,7 @@
 #include <string>
 #include <vulkan/vulkan.h>
 #include <unordered_map>
-#include "..\..\Logging\LoggerQueue.hpp"
+#include "../../Logging/LoggerQueue.hpp"
 
 namespace vgs
 {
@@ -4,19 +4,35 @@
 
 Vulkan::FunctionsLibrary::FunctionsLibrary(): mLibrary(nullptr)
 {
-#ifdef WIN32
+#ifdef _WIN32
 	mLibrary = LoadLibraryA("vulkan-1.dll");
 	assert(mLibrary != 0);
 
 	vkGetInstanceProcAddr = (PFN_vkGetInstanceProcAddr)(GetProcAddress(mLibrary, "vkGetInstanceProcAddr"));
-#endif // WIN32
+#else
+	//The unversioned name is only there if the development package is installed
+	mLibrary = dlopen("libvulkan.so.1", RTLD_NOW | RTLD_LOCAL);
+	if(mLibrary == nullptr)
+	{
+		mLibrary = dlopen("libvulkan.so", RTLD_NOW | RTLD_LOCAL);
+	}
+
+	assert(mLibrary != nullptr);
+
+	vkGetInstanceProcAddr = (PFN_vkGetInstanceProcAddr)(dlsym(mLibrary, "vkGetInstanceProcAddr"));
+#endif // _WIN32
 }
 
 Vulkan::FunctionsLibrary::~FunctionsLibrary()
 {
-#ifdef WIN32
+#ifdef _WIN32
 	FreeLibrary(mLibrary);
-#endif // WIN32
+#else
+	if(mLibrary != nullptr)
+	{
+		dlclose(mLibrary);
+	}
+#endif // _WIN32
 }
 
 void Vulkan::FunctionsLibrary::LoadGlobalFunctions()
@@ -7,7 +7,8 @@ using LIBRARY_TYPE = HMODULE;
 
 #else
 
-//TODO: Linux/etc. library
+#include <dlfcn.h>
+using LIBRARY_TYPE = void*;
 
 #endif
 
@@ -0,0 +1,213 @@
+#include "VulkanHostAllocator.hpp"
+#include "../../Logging/LoggerQueue.hpp"
+#include "../Common/RenderingUtils.hpp"
+#include <new>
+#include <cstring>
+#include <string>
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+	//Stored right before every returned pointer so Free and Reallocate know what they deal with
+	struct AllocationHeader
+	{
+		size_t   Size;
+		uint32_t HeaderOffset; //From the start of the underlying allocation to the returned pointer
+		uint32_t Alignment;
+		uint32_t Scope;
+	};
+
+	constexpr std::string_view ScopeNames[] =
+	{
+		"Command",
+		"Object",
+		"Cache",
+		"Device",
+		"Instance"
+	};
+
+	AllocationHeader* GetAllocationHeader(void* memory)
+	{
+		return reinterpret_cast<AllocationHeader*>(memory) - 1;
+	}
+}
+
+Vulkan::HostAllocator::HostAllocator()
+{
+	mCallbacks.pUserData             = this;
+	mCallbacks.pfnAllocation         = Allocate;
+	mCallbacks.pfnReallocation       = Reallocate;
+	mCallbacks.pfnFree               = Free;
+	mCallbacks.pfnInternalAllocation = InternalAllocationNotification;
+	mCallbacks.pfnInternalFree       = InternalFreeNotification;
+
+	for(uint32_t scopeIndex = 0; scopeIndex < ScopeCount; scopeIndex++)
+	{
+		mScopeCounters[scopeIndex].CurrentBytes        = 0;
+		mScopeCounters[scopeIndex].PeakBytes           = 0;
+		mScopeCounters[scopeIndex].AllocationCount     = 0;
+		mScopeCounters[scopeIndex].LiveAllocationCount = 0;
+
+		mInternalScopeCounters[scopeIndex].CurrentBytes        = 0;
+		mInternalScopeCounters[scopeIndex].PeakBytes           = 0;
+		mInternalScopeCounters[scopeIndex].AllocationCount     = 0;
+		mInternalScopeCounters[scopeIndex].LiveAllocationCount = 0;
+	}
+}
+
+Vulkan::HostAllocator::~HostAllocator()
+{
+}
+
+const VkAllocationCallbacks* Vulkan::HostAllocator::Callbacks()
+{
+	return &Instance().mCallbacks;
+}
+
+Vulkan::HostAllocator& Vulkan::HostAllocator::Instance()
+{
+	static HostAllocator hostAllocator;
+	return hostAllocator;
+}
+
+Vulkan::HostAllocator::ScopeStatistics Vulkan::HostAllocator::GetScopeStatistics(VkSystemAllocationScope scope) const
+{
+	return mScopeCounters[scope].Snapshot();
+}
+
+Vulkan::HostAllocator::ScopeStatistics Vulkan::HostAllocator::GetInternalScopeStatistics(VkSystemAllocationScope scope) const
+{
+	return mInternalScopeCounters[scope].Snapshot();
+}
+
+void Vulkan::HostAllocator::LogStatistics(LoggerQueue* logger, std::string_view label) const
+{
+	std::string statisticsMessage = "Vulkan host allocations (" + std::string(label) + "):\n";
+	for(uint32_t scopeIndex = 0; scopeIndex < ScopeCount; scopeIndex++)
+	{
+		ScopeStatistics scopeStatistics         = mScopeCounters[scopeIndex].Snapshot();
+		ScopeStatistics internalScopeStatistics = mInternalScopeCounters[scopeIndex].Snapshot();
+
+		statisticsMessage += "    " + std::string(ScopeNames[scopeIndex]) + ": " + std::to_string(scopeStatistics.CurrentBytes) + " bytes in " + std::to_string(scopeStatistics.LiveAllocationCount) + " allocations, "
+		                   + "peak " + std::to_string(scopeStatistics.PeakBytes) + " bytes, " + std::to_string(scopeStatistics.AllocationCount) + " allocations total, "
+		                   + std::to_string(internalScopeStatistics.CurrentBytes) + " internal bytes\n";
+	}
+
+	logger->PostLogMessage(statisticsMessage);
+}
+
+void* Vulkan::HostAllocator::Allocate(void* pUserData, size_t size, size_t alignment, VkSystemAllocationScope allocationScope)
+{
+	if(size == 0)
+	{
+		return nullptr;
+	}
+
+	HostAllocator* that = reinterpret_cast<HostAllocator*>(pUserData);
+
+	size_t headerAlignment = std::max(alignment, alignof(AllocationHeader));
+	size_t headerOffset    = Utils::AlignMemory(sizeof(AllocationHeader), headerAlignment);
+
+	std::byte* allocationStart = reinterpret_cast<std::byte*>(::operator new(headerOffset + size, std::align_val_t(headerAlignment), std::nothrow));
+	if(allocationStart == nullptr)
+	{
+		return nullptr;
+	}
+
+	void* memory = allocationStart + headerOffset;
+
+	AllocationHeader* allocationHeader = GetAllocationHeader(memory);
+	allocationHeader->Size         = size;
+	allocationHeader->HeaderOffset = (uint32_t)headerOffset;
+	allocationHeader->Alignment    = (uint32_t)headerAlignment;
+	allocationHeader->Scope        = (uint32_t)allocationScope;
+
+	that->mScopeCounters[allocationScope].RegisterAllocation(size);
+	return memory;
+}
+
+void* Vulkan::HostAllocator::Reallocate(void* pUserData, void* pOriginal, size_t size, size_t alignment, VkSystemAllocationScope allocationScope)
+{
+	if(pOriginal == nullptr)
+	{
+		return Allocate(pUserData, size, alignment, allocationScope);
+	}
+
+	if(size == 0)
+	{
+		Free(pUserData, pOriginal);
+		return nullptr;
+	}
+
+	//The spec requires the original allocation to be left untouched if reallocation fails
+	void* newMemory = Allocate(pUserData, size, alignment, allocationScope);
+	if(newMemory == nullptr)
+	{
+		return nullptr;
+	}
+
+	memcpy(newMemory, pOriginal, std::min(GetAllocationHeader(pOriginal)->Size, size));
+	Free(pUserData, pOriginal);
+
+	return newMemory;
+}
+
+void Vulkan::HostAllocator::Free(void* pUserData, void* pMemory)
+{
+	if(pMemory == nullptr)
+	{
+		return;
+	}
+
+	HostAllocator* that = reinterpret_cast<HostAllocator*>(pUserData);
+
+	const AllocationHeader* allocationHeader = GetAllocationHeader(pMemory);
+	assert(allocationHeader->Scope < ScopeCount);
+
+	that->mScopeCounters[allocationHeader->Scope].RegisterFree(allocationHeader->Size);
+
+	std::byte* allocationStart = reinterpret_cast<std::byte*>(pMemory) - allocationHeader->HeaderOffset;
+	::operator delete(allocationStart, std::align_val_t(allocationHeader->Alignment));
+}
+
+void Vulkan::HostAllocator::InternalAllocationNotification(void* pUserData, size_t size, [[maybe_unused]] VkInternalAllocationType allocationType, VkSystemAllocationScope allocationScope)
+{
+	HostAllocator* that = reinterpret_cast<HostAllocator*>(pUserData);
+	that->mInternalScopeCounters[allocationScope].RegisterAllocation(size);
+}
+
+void Vulkan::HostAllocator::InternalFreeNotification(void* pUserData, size_t size, [[maybe_unused]] VkInternalAllocationType allocationType, VkSystemAllocationScope allocationScope)
+{
+	HostAllocator* that = reinterpret_cast<HostAllocator*>(pUserData);
+	that->mInternalScopeCounters[allocationScope].RegisterFree(size);
+}
+
+void Vulkan::HostAllocator::ScopeCounters::RegisterAllocation(size_t size)
+{
+	uint64_t currentBytes = CurrentBytes.fetch_add(size, std::memory_order_relaxed) + size;
+	AllocationCount.fetch_add(1, std::memory_order_relaxed);
+	LiveAllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+	uint64_t peakBytes = PeakBytes.load(std::memory_order_relaxed);
+	while(currentBytes > peakBytes && !PeakBytes.compare_exchange_weak(peakBytes, currentBytes, std::memory_order_relaxed))
+	{
+	}
+}
+
+void Vulkan::HostAllocator::ScopeCounters::RegisterFree(size_t size)
+{
+	CurrentBytes.fetch_sub(size, std::memory_order_relaxed);
+	LiveAllocationCount.fetch_sub(1, std::memory_order_relaxed);
+}
+
+Vulkan::HostAllocator::ScopeStatistics Vulkan::HostAllocator::ScopeCounters::Snapshot() const
+{
+	return ScopeStatistics
+	{
+		.CurrentBytes        = CurrentBytes.load(std::memory_order_relaxed),
+		.PeakBytes           = PeakBytes.load(std::memory_order_relaxed),
+		.AllocationCount     = AllocationCount.load(std::memory_order_relaxed),
+		.LiveAllocationCount = LiveAllocationCount.load(std::memory_order_relaxed)
+	};
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <atomic>
+#include <array>
+#include <string_view>
+
+class LoggerQueue;
+
+namespace Vulkan
+{
+	//Routes the host allocations of the Vulkan implementation through the engine and collects statistics per allocation scope.
+	//The same callbacks have to be passed to the creation and destruction of every object, so there is one process-wide instance
+	class HostAllocator
+	{
+		static constexpr uint32_t ScopeCount = VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE + 1;
+
+	public:
+		struct ScopeStatistics
+		{
+			uint64_t CurrentBytes;
+			uint64_t PeakBytes;
+			uint64_t AllocationCount;
+			uint64_t LiveAllocationCount;
+		};
+
+	public:
+		static const VkAllocationCallbacks* Callbacks();
+		static HostAllocator&               Instance();
+
+		ScopeStatistics GetScopeStatistics(VkSystemAllocationScope scope)         const;
+		ScopeStatistics GetInternalScopeStatistics(VkSystemAllocationScope scope) const; //Allocations the implementation made on its own and only reported to us
+
+		void LogStatistics(LoggerQueue* logger, std::string_view label) const;
+
+	private:
+		HostAllocator();
+		~HostAllocator();
+
+		HostAllocator(const HostAllocator&)            = delete;
+		HostAllocator& operator=(const HostAllocator&) = delete;
+
+		static VKAPI_ATTR void* VKAPI_CALL Allocate(void* pUserData, size_t size, size_t alignment, VkSystemAllocationScope allocationScope);
+		static VKAPI_ATTR void* VKAPI_CALL Reallocate(void* pUserData, void* pOriginal, size_t size, size_t alignment, VkSystemAllocationScope allocationScope);
+		static VKAPI_ATTR void  VKAPI_CALL Free(void* pUserData, void* pMemory);
+
+		static VKAPI_ATTR void VKAPI_CALL InternalAllocationNotification(void* pUserData, size_t size, VkInternalAllocationType allocationType, VkSystemAllocationScope allocationScope);
+		static VKAPI_ATTR void VKAPI_CALL InternalFreeNotification(void* pUserData, size_t size, VkInternalAllocationType allocationType, VkSystemAllocationScope allocationScope);
+
+	private:
+		struct ScopeCounters
+		{
+			std::atomic<uint64_t> CurrentBytes;
+			std::atomic<uint64_t> PeakBytes;
+			std::atomic<uint64_t> AllocationCount;
+			std::atomic<uint64_t> LiveAllocationCount;
+
+			void RegisterAllocation(size_t size);
+			void RegisterFree(size_t size);
+
+			ScopeStatistics Snapshot() const;
+		};
+
+	private:
+		VkAllocationCallbacks mCallbacks;
+
+		std::array<ScopeCounters, ScopeCount> mScopeCounters;
+		std::array<ScopeCounters, ScopeCount> mInternalScopeCounters;
+	};
+}
\ No newline at end of file
@@ -4,26 +4,53 @@
 #include "../Common/RenderingUtils.hpp"
 #include <VulkanGenericStructures.h>
 #include <cassert>
+#include <string>
 
-Vulkan::MemoryManager::MemoryManager(LoggerQueue* logger, VkPhysicalDevice physicalDevice, const DeviceParameters& deviceParameters): mLogger(logger)
+namespace
 {
-	vgs::GenericStructureChain<VkPhysicalDeviceMemoryProperties2> memoryPropertiesChain;
-	if(deviceParameters.IsMemoryBudgetExtensionEnabled())
+	//Fractions of the heap budget. A heap goes down a level only after its usage drops below the threshold by the hysteresis value, so the events don't flicker
+	constexpr double WarningPressureThreshold  = 0.80;
+	constexpr double CriticalPressureThreshold = 0.95;
+	constexpr double PressureHysteresis        = 0.05;
+
+	constexpr std::string_view AllocationCategoryNames[] =
 	{
-		memoryPropertiesChain.AppendToChain(mMemoryBudgetProperties);
-	}
+		"Scene buffers",
+		"Scene textures",
+		"Frame graph images",
+		"Upload buffers"
+	};
+
+	constexpr std::string_view PressureLevelNames[] =
+	{
+		"normal",
+		"warning",
+		"critical"
+	};
+
+	static_assert(std::size(AllocationCategoryNames) == (size_t)Vulkan::MemoryManager::AllocationCategory::Count);
+}
+
+Vulkan::MemoryManager::MemoryManager(LoggerQueue* logger, VkPhysicalDevice physicalDevice, const DeviceParameters& deviceParameters): mLogger(logger), mPhysicalDeviceRef(physicalDevice)
+{
+	mBudgetExtensionEnabled = deviceParameters.IsMemoryBudgetExtensionEnabled();
+
+	mCategoryUsages.fill(0);
+	mTrackedHeapUsages.fill(0);
+	mHeapPressureLevels.fill(PressureLevel::Normal);
 
-	mMemoryBudgetProperties.pNext = nullptr;
-	vkGetPhysicalDeviceMemoryProperties2(physicalDevice, &memoryPropertiesChain.GetChainHead());
+	//The memory types and heaps never change, only the budget does. This makes FindMemoryTypeIndex() safe to call from any thread without the lock
+	vkGetPhysicalDeviceMemoryProperties(mPhysicalDeviceRef, &mMemoryProperties);
 
-	mMemoryProperties = memoryPropertiesChain.GetChainHead().memoryProperties;
+	UpdateMemoryBudget();
 }
 
 Vulkan::MemoryManager::~MemoryManager()
 {
+	assert(mAllocationRecords.empty()); //All memory should be freed through FreeMemory before the manager is destroyed
 }
 
-VkDeviceMemory Vulkan::MemoryManager::AllocateImagesMemory(VkDevice device, std::span<VkBindImageMemoryInfo> inoutBindMemoryInfos) const
+VkDeviceMemory Vulkan::MemoryManager::AllocateImagesMemory(VkDevice device, std::span<VkBindImageMemoryInfo> inoutBindMemoryInfos, AllocationCategory category)
 {
 	VkMemoryRequirements memoryRequirements;
 	memoryRequirements.alignment      = 0;
@@ -56,17 +83,7 @@ VkDeviceMemory Vulkan::MemoryManager::AllocateImagesMemory(VkDevice device, std:
 		memoryRequirements.memoryTypeBits &= imageMemoryRequirements.memoryRequirements.memoryTypeBits;
 	}
 
-	uint32_t imagesMemoryIndex = (uint32_t)(-1);
-
-	VkMemoryPropertyFlags memoryFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
-	for(uint32_t typeIndex = 0; typeIndex < mMemoryProperties.memoryTypeCount; typeIndex++)
-	{
-		if((memoryRequirements.memoryTypeBits & (1 << typeIndex)) && (mMemoryProperties.memoryTypes[typeIndex].propertyFlags & memoryFlags) == memoryFlags)
-		{
-			imagesMemoryIndex = typeIndex;
-		}
-	}
-
+	uint32_t imagesMemoryIndex = FindMemoryTypeIndex(memoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 	assert(imagesMemoryIndex != (uint32_t)(-1));
 
 	VkMemoryAllocateInfo memoryAllocateInfo;
@@ -75,8 +92,7 @@ VkDeviceMemory Vulkan::MemoryManager::AllocateImagesMemory(VkDevice device, std:
 	memoryAllocateInfo.allocationSize  = memoryRequirements.size;
 	memoryAllocateInfo.memoryTypeIndex = imagesMemoryIndex;
 
-	VkDeviceMemory allocatedMemory = nullptr;
-	ThrowIfFailed(vkAllocateMemory(device, &memoryAllocateInfo, nullptr, &allocatedMemory));
+	VkDeviceMemory allocatedMemory = AllocateTrackedMemory(device, &memoryAllocateInfo, category);
 
 	for(size_t imageIndex = 0; imageIndex < inoutBindMemoryInfos.size(); imageIndex++)
 	{
@@ -88,7 +104,7 @@ VkDeviceMemory Vulkan::MemoryManager::AllocateImagesMemory(VkDevice device, std:
 	return allocatedMemory;
 }
 
-VkDeviceMemory Vulkan::MemoryManager::AllocateBuffersMemory(VkDevice device, const std::span<VkBuffer> buffers, BufferAllocationType allocationType, std::vector<VkDeviceSize>& outMemoryOffsets) const
+VkDeviceMemory Vulkan::MemoryManager::AllocateBuffersMemory(VkDevice device, const std::span<VkBuffer> buffers, BufferAllocationType allocationType, AllocationCategory category, std::vector<VkDeviceSize>& outMemoryOffsets)
 {
 	outMemoryOffsets.clear();
 
@@ -123,8 +139,6 @@ VkDeviceMemory Vulkan::MemoryManager::AllocateBuffersMemory(VkDevice device, con
 		memoryRequirements.memoryTypeBits &= bufferMemoryRequirements.memoryRequirements.memoryTypeBits;
 	}
 
-	uint32_t bufferMemoryIndex = (uint32_t)(-1);
-
 	VkMemoryPropertyFlags memoryFlags = 0;
 	switch (allocationType)
 	{
@@ -139,14 +153,8 @@ VkDeviceMemory Vulkan::MemoryManager::AllocateBuffersMemory(VkDevice device, con
 	}
 
 	assert(memoryFlags != 0);
-	for(uint32_t typeIndex = 0; typeIndex < mMemoryProperties.memoryTypeCount; typeIndex++)
-	{
-		if((memoryRequirements.memoryTypeBits & (1 << typeIndex)) && (mMemoryProperties.memoryTypes[typeIndex].propertyFlags & memoryFlags) == memoryFlags)
-		{
-			bufferMemoryIndex = typeIndex;
-		}
-	}
 
+	uint32_t bufferMemoryIndex = FindMemoryTypeIndex(memoryRequirements.memoryTypeBits, memoryFlags);
 	assert(bufferMemoryIndex != (uint32_t)(-1));
 
 	VkMemoryAllocateInfo memoryAllocateInfo;
@@ -155,28 +163,15 @@ VkDeviceMemory Vulkan::MemoryManager::AllocateBuffersMemory(VkDevice device, con
 	memoryAllocateInfo.allocationSize  = memoryRequirements.size;
 	memoryAllocateInfo.memoryTypeIndex = bufferMemoryIndex;
 
-	VkDeviceMemory allocatedMemory = nullptr;
-	ThrowIfFailed(vkAllocateMemory(device, &memoryAllocateInfo, nullptr, &allocatedMemory));
-
-	return allocatedMemory;
+	return AllocateTrackedMemory(device, &memoryAllocateInfo, category);
 }
 
-VkDeviceMemory Vulkan::MemoryManager::AllocateIntermediateBufferMemory(VkDevice device, VkBuffer buffer) const
+VkDeviceMemory Vulkan::MemoryManager::AllocateIntermediateBufferMemory(VkDevice device, VkBuffer buffer)
 {
 	VkMemoryRequirements bufferMemoryRequirements;
 	vkGetBufferMemoryRequirements(device, buffer, &bufferMemoryRequirements);
 
-	uint32_t intermediateBufferMemoryIndex = (uint32_t)(-1);
-
-	VkMemoryPropertyFlags memoryFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
-	for(uint32_t typeIndex = 0; typeIndex < mMemoryProperties.memoryTypeCount; typeIndex++)
-	{
-		if((bufferMemoryRequirements.memoryTypeBits & (1 << typeIndex)) && (mMemoryProperties.memoryTypes[typeIndex].propertyFlags & memoryFlags) == memoryFlags)
-		{
-			intermediateBufferMemoryIndex = typeIndex;
-		}
-	}
-
+	uint32_t intermediateBufferMemoryIndex = FindMemoryTypeIndex(bufferMemoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
 	assert(intermediateBufferMemoryIndex != (uint32_t)(-1));
 
 	vgs::GenericStructureChain<VkMemoryAllocateInfo> memoryAllocateInfoChain;
@@ -194,8 +189,222 @@ VkDeviceMemory Vulkan::MemoryManager::AllocateIntermediateBufferMemory(VkDevice
 
 	memoryAllocateInfoChain.AppendToChain(dedicatedMemoryAllocationInfo);
 
-	VkDeviceMemory allocatedMemory = nullptr;
-	ThrowIfFailed(vkAllocateMemory(device, &memoryAllocateInfoChain.GetChainHead(), nullptr, &allocatedMemory));
+	return AllocateTrackedMemory(device, &memoryAllocateInfoChain.GetChainHead(), AllocationCategory::UploadBuffers);
+}
+
+void Vulkan::MemoryManager::FreeMemory(VkDevice device, VkDeviceMemory& memory)
+{
+	if(memory == VK_NULL_HANDLE)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> trackingLock(mTrackingMutex);
+
+		auto recordIt = mAllocationRecords.find(memory);
+		assert(recordIt != mAllocationRecords.end());
+
+		const AllocationRecord& allocationRecord = recordIt->second;
+		mCategoryUsages[(size_t)allocationRecord.Category] -= allocationRecord.Size;
+		mTrackedHeapUsages[allocationRecord.HeapIndex]     -= allocationRecord.Size;
+
+		mAllocationRecords.erase(recordIt);
+	}
+
+	SafeDestroyObject(vkFreeMemory, device, memory);
+}
+
+void Vulkan::MemoryManager::UpdateMemoryBudget()
+{
+	VkPhysicalDeviceMemoryBudgetPropertiesEXT memoryBudgetProperties;
+
+	vgs::GenericStructureChain<VkPhysicalDeviceMemoryProperties2> memoryPropertiesChain;
+	if(mBudgetExtensionEnabled)
+	{
+		memoryPropertiesChain.AppendToChain(memoryBudgetProperties);
+	}
+
+	memoryBudgetProperties.pNext = nullptr;
+	vkGetPhysicalDeviceMemoryProperties2(mPhysicalDeviceRef, &memoryPropertiesChain.GetChainHead());
+
+	//The callbacks are called after the lock is released, so they can free memory through the manager
+	std::vector<PressureEvent>          pressureEvents;
+	std::vector<PressureCallbackRecord> pressureCallbacks;
+
+	{
+		std::lock_guard<std::mutex> trackingLock(mTrackingMutex);
+
+		for(uint32_t heapIndex = 0; heapIndex < mMemoryProperties.memoryHeapCount; heapIndex++)
+		{
+			if(mBudgetExtensionEnabled)
+			{
+				mMemoryBudgetProperties.heapUsage[heapIndex]  = memoryBudgetProperties.heapUsage[heapIndex];
+				mMemoryBudgetProperties.heapBudget[heapIndex] = memoryBudgetProperties.heapBudget[heapIndex];
+			}
+			else
+			{
+				//Without the extension the best estimation is the memory allocated by the manager itself against the whole heap
+				mMemoryBudgetProperties.heapUsage[heapIndex]  = mTrackedHeapUsages[heapIndex];
+				mMemoryBudgetProperties.heapBudget[heapIndex] = mMemoryProperties.memoryHeaps[heapIndex].size;
+			}
+
+			VkDeviceSize heapUsage  = mMemoryBudgetProperties.heapUsage[heapIndex];
+			VkDeviceSize heapBudget = mMemoryBudgetProperties.heapBudget[heapIndex];
+
+			PressureLevel oldLevel = mHeapPressureLevels[heapIndex];
+			PressureLevel newLevel = CalculatePressureLevel(oldLevel, heapUsage, heapBudget);
+			if(newLevel == oldLevel)
+			{
+				continue;
+			}
+
+			mHeapPressureLevels[heapIndex] = newLevel;
+
+			mLogger->PostLogMessage("Vulkan memory heap " + std::to_string(heapIndex) + " pressure changed to " + std::string(PressureLevelNames[(uint32_t)newLevel]) 
+			                      + ": " + std::to_string(heapUsage / (1024 * 1024)) + " MB used of " + std::to_string(heapBudget / (1024 * 1024)) + " MB budget");
+
+			pressureEvents.push_back(PressureEvent
+			{
+				.HeapIndex  = heapIndex,
+				.OldLevel   = oldLevel,
+				.NewLevel   = newLevel,
+				.HeapUsage  = heapUsage,
+				.HeapBudget = heapBudget
+			});
+		}
+
+		if(!pressureEvents.empty())
+		{
+			pressureCallbacks = mPressureCallbacks;
+		}
+	}
+
+	for(const PressureEvent& pressureEvent: pressureEvents)
+	{
+		for(const PressureCallbackRecord& callbackRecord: pressureCallbacks)
+		{
+			callbackRecord.Callback(pressureEvent, callbackRecord.UserObject);
+		}
+	}
+}
+
+void Vulkan::MemoryManager::RegisterPressureCallback(PressureCallback callback, void* userObject)
+{
+	std::lock_guard<std::mutex> trackingLock(mTrackingMutex);
+
+	mPressureCallbacks.push_back(PressureCallbackRecord
+	{
+		.Callback   = callback,
+		.UserObject = userObject
+	});
+}
+
+VkDeviceSize Vulkan::MemoryManager::GetCategoryUsage(AllocationCategory category) const
+{
+	std::lock_guard<std::mutex> trackingLock(mTrackingMutex);
+	return mCategoryUsages[(size_t)category];
+}
+
+VkDeviceSize Vulkan::MemoryManager::GetHeapUsage(uint32_t heapIndex) const
+{
+	assert(heapIndex < mMemoryProperties.memoryHeapCount);
+
+	std::lock_guard<std::mutex> trackingLock(mTrackingMutex);
+	return mMemoryBudgetProperties.heapUsage[heapIndex];
+}
+
+VkDeviceSize Vulkan::MemoryManager::GetHeapBudget(uint32_t heapIndex) const
+{
+	assert(heapIndex < mMemoryProperties.memoryHeapCount);
+
+	std::lock_guard<std::mutex> trackingLock(mTrackingMutex);
+	return mMemoryBudgetProperties.heapBudget[heapIndex];
+}
+
+void Vulkan::MemoryManager::LogMemoryReport() const
+{
+	std::lock_guard<std::mutex> trackingLock(mTrackingMutex);
+
+	std::string report = "Vulkan memory report:\n";
+	for(size_t categoryIndex = 0; categoryIndex < mCategoryUsages.size(); categoryIndex++)
+	{
+		report += "    " + std::string(AllocationCategoryNames[categoryIndex]) + ": " + std::to_string(mCategoryUsages[categoryIndex] / 1024) + " KB\n";
+	}
+
+	for(uint32_t heapIndex = 0; heapIndex < mMemoryProperties.memoryHeapCount; heapIndex++)
+	{
+		bool isDeviceLocal = mMemoryProperties.memoryHeaps[heapIndex].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT;
+		report += "    Heap " + std::to_string(heapIndex) + (isDeviceLocal ? " (device local)" : "") + ": " + std::to_string(mTrackedHeapUsages[heapIndex] / 1024) + " KB allocated, " 
+		        + std::to_string(mMemoryBudgetProperties.heapUsage[heapIndex] / 1024) + " KB used of " + std::to_string(mMemoryBudgetProperties.heapBudget[heapIndex] / 1024) + " KB budget\n";
+	}
+
+	mLogger->PostLogMessage(report);
+}
+
+uint32_t Vulkan::MemoryManager::FindMemoryTypeIndex(uint32_t memoryTypeBits, VkMemoryPropertyFlags memoryFlags) const
+{
+	uint32_t memoryTypeIndex = (uint32_t)(-1);
+	for(uint32_t typeIndex = 0; typeIndex < mMemoryProperties.memoryTypeCount; typeIndex++)
+	{
+		if((memoryTypeBits & (1 << typeIndex)) && (mMemoryProperties.memoryTypes[typeIndex].propertyFlags & memoryFlags) == memoryFlags)
+		{
+			memoryTypeIndex = typeIndex;
+		}
+	}
+
+	return memoryTypeIndex;
+}
+
+VkDeviceMemory Vulkan::MemoryManager::AllocateTrackedMemory(VkDevice device, const VkMemoryAllocateInfo* allocateInfo, AllocationCategory category)
+{
+	VkDeviceMemory allocatedMemory = VK_NULL_HANDLE;
+	ThrowIfFailed(vkAllocateMemory(device, allocateInfo, HostAllocator::Callbacks(), &allocatedMemory));
+
+	uint32_t heapIndex = mMemoryProperties.memoryTypes[allocateInfo->memoryTypeIndex].heapIndex;
+
+	std::lock_guard<std::mutex> trackingLock(mTrackingMutex);
+	mAllocationRecords[allocatedMemory] = AllocationRecord
+	{
+		.Size      = allocateInfo->allocationSize,
+		.HeapIndex = heapIndex,
+		.Category  = category
+	};
+
+	mCategoryUsages[(size_t)category] += allocateInfo->allocationSize;
+	mTrackedHeapUsages[heapIndex]     += allocateInfo->allocationSize;
 
 	return allocatedMemory;
+}
+
+Vulkan::MemoryManager::PressureLevel Vulkan::MemoryManager::CalculatePressureLevel(PressureLevel currentLevel, VkDeviceSize heapUsage, VkDeviceSize heapBudget) const
+{
+	if(heapBudget == 0)
+	{
+		return PressureLevel::Normal;
+	}
+
+	double usageFraction = (double)heapUsage / (double)heapBudget;
+	if(usageFraction >= CriticalPressureThreshold)
+	{
+		return PressureLevel::Critical;
+	}
+	else if(usageFraction >= WarningPressureThreshold)
+	{
+		if(currentLevel == PressureLevel::Critical && usageFraction >= CriticalPressureThreshold - PressureHysteresis)
+		{
+			return PressureLevel::Critical;
+		}
+
+		return PressureLevel::Warning;
+	}
+	else
+	{
+		if(currentLevel != PressureLevel::Normal && usageFraction >= WarningPressureThreshold - PressureHysteresis)
+		{
+			return PressureLevel::Warning;
+		}
+
+		return PressureLevel::Normal;
+	}
 }
\ No newline at end of file
@@ -4,9 +4,15 @@
 #include "../../Logging/LoggerQueue.hpp"
 #include "VulkanDeviceParameters.hpp"
 #include <span>
+#include <array>
+#include <vector>
+#include <mutex>
+#include <unordered_map>
 
 namespace Vulkan
 {
+	//Allocations and frees can come from any thread, the tracking data is guarded by a mutex.
+	//Pressure callbacks are called on the thread that calls UpdateMemoryBudget(), with the mutex unlocked
 	class MemoryManager
 	{
 	public:
@@ -16,18 +22,93 @@ namespace Vulkan
 			HOST_VISIBLE
 		};
 
+		enum class AllocationCategory: uint32_t
+		{
+			SceneBuffers,
+			SceneTextures,
+			FrameGraphImages,
+			UploadBuffers,
+
+			Count
+		};
+
+		enum class PressureLevel: uint32_t
+		{
+			Normal,   //Heap usage is below the warning threshold
+			Warning,  //Heap usage is close to the budget, caches should trim themselves
+			Critical  //Heap usage is at the budget, further allocations may fail or get demoted to slower memory
+		};
+
+		struct PressureEvent
+		{
+			uint32_t      HeapIndex;
+			PressureLevel OldLevel;
+			PressureLevel NewLevel;
+			VkDeviceSize  HeapUsage;
+			VkDeviceSize  HeapBudget;
+		};
+
+		using PressureCallback = void(*)(const PressureEvent& pressureEvent, void* userObject);
+
+	public:
 		MemoryManager(LoggerQueue* logger, VkPhysicalDevice physicalDevice, const DeviceParameters& deviceParameters);
 		~MemoryManager();
 
-		VkDeviceMemory AllocateImagesMemory(VkDevice device, std::span<VkBindImageMemoryInfo> inoutBindMemoryInfos) const;
-		VkDeviceMemory AllocateBuffersMemory(VkDevice device, const std::span<VkBuffer> buffers, BufferAllocationType allocationType, std::vector<VkDeviceSize>& outMemoryOffsets) const;
+		VkDeviceMemory AllocateImagesMemory(VkDevice device, std::span<VkBindImageMemoryInfo> inoutBindMemoryInfos, AllocationCategory category);
+		VkDeviceMemory AllocateBuffersMemory(VkDevice device, const std::span<VkBuffer> buffers, BufferAllocationType allocationType, AllocationCategory category, std::vector<VkDeviceSize>& outMemoryOffsets);
+
+		VkDeviceMemory AllocateIntermediateBufferMemory(VkDevice device, VkBuffer buffer);
+
+		//Frees the memory allocated by the manager and resets the handle, the same way SafeDestroyObject does
+		void FreeMemory(VkDevice device, VkDeviceMemory& memory);
+
+		//Re-queries per-heap usage and budget and raises pressure events for heaps that crossed the thresholds. Should be called once per frame
+		void UpdateMemoryBudget();
+
+		void RegisterPressureCallback(PressureCallback callback, void* userObject);
 
-		VkDeviceMemory AllocateIntermediateBufferMemory(VkDevice device, VkBuffer buffer) const;
+		VkDeviceSize GetCategoryUsage(AllocationCategory category) const;
+		VkDeviceSize GetHeapUsage(uint32_t heapIndex)              const;
+		VkDeviceSize GetHeapBudget(uint32_t heapIndex)             const;
+
+		void LogMemoryReport() const;
+
+	private:
+		uint32_t       FindMemoryTypeIndex(uint32_t memoryTypeBits, VkMemoryPropertyFlags memoryFlags) const;
+		VkDeviceMemory AllocateTrackedMemory(VkDevice device, const VkMemoryAllocateInfo* allocateInfo, AllocationCategory category);
+
+		PressureLevel CalculatePressureLevel(PressureLevel currentLevel, VkDeviceSize heapUsage, VkDeviceSize heapBudget) const;
+
+	private:
+		struct AllocationRecord
+		{
+			VkDeviceSize       Size;
+			uint32_t           HeapIndex;
+			AllocationCategory Category;
+		};
+
+		struct PressureCallbackRecord
+		{
+			PressureCallback Callback;
+			void*            UserObject;
+		};
 
 	private:
 		LoggerQueue* mLogger;
 
+		VkPhysicalDevice mPhysicalDeviceRef;
+		bool             mBudgetExtensionEnabled;
+
 		VkPhysicalDeviceMemoryProperties          mMemoryProperties;
 		VkPhysicalDeviceMemoryBudgetPropertiesEXT mMemoryBudgetProperties;
+
+		std::unordered_map<VkDeviceMemory, AllocationRecord>        mAllocationRecords;
+		std::array<VkDeviceSize, (size_t)AllocationCategory::Count> mCategoryUsages;
+		std::array<VkDeviceSize, VK_MAX_MEMORY_HEAPS>               mTrackedHeapUsages;
+		std::array<PressureLevel, VK_MAX_MEMORY_HEAPS>              mHeapPressureLevels;
+
+		std::vector<PressureCallbackRecord> mPressureCallbacks;
+
+		mutable std::mutex mTrackingMutex;
 	};
 }
\ No newline at end of file
@@ -100,7 +100,7 @@ void Vulkan::PassDescriptorDatabaseBuilder::RecreatePassDescriptorPool(const Fra
 	descriptorPoolCreateInfo.poolSizeCount = poolSizeCount;
 	descriptorPoolCreateInfo.pPoolSizes    = poolSizes.data();
 
-	ThrowIfFailed(vkCreateDescriptorPool(mDatabaseToBuild->mDeviceRef, &descriptorPoolCreateInfo, nullptr, &mDatabaseToBuild->mPassDescriptorPool));
+	ThrowIfFailed(vkCreateDescriptorPool(mDatabaseToBuild->mDeviceRef, &descriptorPoolCreateInfo, HostAllocator::Callbacks(), &mDatabaseToBuild->mPassDescriptorPool));
 }
 
 void Vulkan::PassDescriptorDatabaseBuilder::AllocateDescriptorSets(std::vector<VkDescriptorSet>& outAllocatedSetsPerLayout)
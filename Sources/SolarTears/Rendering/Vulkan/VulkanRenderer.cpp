@@ -16,6 +16,8 @@
 #include "VulkanSharedDescriptorDatabaseBuilder.hpp"
 #include "VulkanPassDescriptorDatabaseBuilder.hpp"
 #include "../Common/RenderingUtils.hpp"
+#include "../Common/PerformanceHud.hpp"
+#include "../Common/FrameLatency.hpp"
 #include "../../Core/Util.hpp"
 #include "../../Core/ThreadPool.hpp"
 #include "../../Core/FrameCounter.hpp"
@@ -52,6 +54,17 @@ Vulkan::Renderer::Renderer(LoggerQueue* loggerQueue, FrameCounter* frameCounter,
 	CreateFences();
 
 	mMemoryAllocator = std::make_unique<MemoryManager>(mLoggingBoard, mPhysicalDevice, mDeviceParameters);
+	mMemoryAllocator->RegisterPressureCallback([](const MemoryManager::PressureEvent& pressureEvent, void* userObject)
+	{
+		//The kept texture files only speed up the next scene bake, they are the first thing to give back
+		if(pressureEvent.NewLevel > pressureEvent.OldLevel && pressureEvent.NewLevel >= MemoryManager::PressureLevel::Warning)
+		{
+			Renderer* that = reinterpret_cast<Renderer*>(userObject);
+
+			size_t droppedByteCount = that->mSceneBakeCache->DropTextureFiles();
+			that->mLoggingBoard->PostLogMessage("Memory pressure: dropped " + std::to_string(droppedByteCount / 1024) + " KB of cached texture files");
+		}
+	}, this);
 
 	mDescriptorDatabase = std::make_unique<DescriptorDatabase>(mDevice);
 	mSamplerManager     = std::make_unique<SamplerManager>(mDevice);
@@ -113,6 +126,20 @@ void Vulkan::Renderer::AttachToWindow(Window* window)
 	InitializeSwapchainImages();
 }
 
+void Vulkan::Renderer::AttachToOffscreenTarget(uint32_t width, uint32_t height)
+{
+	assert(mPhysicalDevice != VK_NULL_HANDLE);
+
+	ThrowIfFailed(vkDeviceWaitIdle(mDevice));
+
+	//The graphics queue is always there, so no device recreation is needed
+	mSwapChain->BindToOffscreenTarget(mMemoryAllocator.get(), mDeviceQueues->GetGraphicsQueueFamilyIndex(), width, height);
+
+	mCommandBuffers->CreatePresentCommandBuffers(mSwapChain.get());
+
+	InitializeSwapchainImages();
+}
+
 void Vulkan::Renderer::ResizeWindowBuffers(Window* window)
 {
 	assert(mPhysicalDevice);
@@ -128,20 +155,27 @@ BaseRenderableScene* Vulkan::Renderer::InitScene(const RenderableSceneDescriptio
 {
 	ThrowIfFailed(vkDeviceWaitIdle(mDevice));
 
-	mScene = std::make_unique<RenderableScene>(mDevice, mDeviceParameters);
+	//The edited scene reuses the buffers and textures of the previous one if it can
+	std::unique_ptr<RenderableScene> previousScene = std::move(mScene);
+
+	mScene = std::make_unique<RenderableScene>(mDevice, mDeviceParameters, mMemoryAllocator.get());
 	RenderableSceneBuilder sceneBuilder(mScene.get(), mMemoryAllocator.get(), mDeviceQueues.get(), mCommandBuffers.get(), &mDeviceParameters);
+	sceneBuilder.SetBakeCache(mSceneBakeCache.get());
+	sceneBuilder.SetSceneCacheFile(mSceneCacheFilename);
+	sceneBuilder.SetPreviousScene(previousScene.get());
 
 	sceneBuilder.Build(sceneDescription, sceneMeshInitialLocations, outObjectHandles);
 
 	SharedDescriptorDatabaseBuilder sharedDatabaseBuilder(mDescriptorDatabase.get());
 	sharedDatabaseBuilder.RecreateSharedSets(mScene.get(), mSamplerManager.get());
 
+	HostAllocator::Instance().LogStatistics(mLoggingBoard, "after scene creation");
 	return mScene.get();
 }
 
 void Vulkan::Renderer::InitFrameGraph(FrameGraphConfig&& frameGraphConfig, FrameGraphDescription&& frameGraphDescription)
 {
-	mFrameGraph = std::make_unique<FrameGraph>(mDevice, std::move(frameGraphConfig), mCommandBuffers.get(), mDeviceQueues.get());
+	mFrameGraph = std::make_unique<FrameGraph>(mDevice, std::move(frameGraphConfig), mCommandBuffers.get(), mDeviceQueues.get(), mMemoryAllocator.get());
 
 	FrameGraphBuildInfo frameGraphBuildInfo = 
 	{
@@ -149,11 +183,13 @@ void Vulkan::Renderer::InitFrameGraph(FrameGraphConfig&& frameGraphConfig, Frame
 		.DeviceParams    = &mDeviceParameters,
 		.MemoryAllocator = mMemoryAllocator.get(),
 		.Queues          = mDeviceQueues.get(),
-		.CommandBuffers  = mCommandBuffers.get()
+		.CommandBuffers  = mCommandBuffers.get(),
+		.Hud             = mPerformanceHud.get()
 	};
 
 	FrameGraphBuilder frameGraphBuilder(mLoggingBoard, mFrameGraph.get(), mSamplerManager.get(), mSwapChain.get());
 	frameGraphBuilder.Build(std::move(frameGraphDescription), frameGraphBuildInfo);
+	mPerformanceHud->SetFrameGraph(mFrameGraph.get());
 
 	PassDescriptorDatabaseBuilder   passDatabaseBuilder(mDescriptorDatabase.get());
 	SharedDescriptorDatabaseBuilder sharedDatabaseBuilder(mDescriptorDatabase.get());
@@ -161,6 +197,9 @@ void Vulkan::Renderer::InitFrameGraph(FrameGraphConfig&& frameGraphConfig, Frame
 
 	passDatabaseBuilder.RecreatePassSets(&frameGraphBuilder);
 	sharedDatabaseBuilder.RecreateSharedSets(mScene.get(), mSamplerManager.get());
+
+	mMemoryAllocator->LogMemoryReport();
+	HostAllocator::Instance().LogStatistics(mLoggingBoard, "after frame graph creation");
 }
 
 void Vulkan::Renderer::Render()
@@ -170,19 +209,35 @@ void Vulkan::Renderer::Render()
 
 	VkFence frameFence = mRenderFences[currentFrameResourceIndex];
 	std::array frameFences = {frameFence};
+	mLatencyTracker->MarkWaitStarted();
 	ThrowIfFailed(vkWaitForFences(mDevice, (uint32_t)(frameFences.size()), frameFences.data(), VK_TRUE, 3000000000));
+	mLatencyTracker->MarkWaitFinished();
 
 	ThrowIfFailed(vkResetFences(mDevice, (uint32_t)(frameFences.size()), frameFences.data()));
 
+	mMemoryAllocator->UpdateMemoryBudget();
+
 	mScene->CopyUploadedSceneObjects(mCommandBuffers.get(), mDeviceQueues.get(), currentFrameResourceIndex);
 
 	VkSemaphore preTraverseSemaphore = mSwapChain->GetImageAcquiredSemaphore(currentFrameResourceIndex);
+	mLatencyTracker->MarkWaitStarted();
 	mSwapChain->AcquireImage(mDevice, currentFrameResourceIndex);
+	mLatencyTracker->MarkWaitFinished();
+
+	mScene->CullMeshes(mThreadPoolRef);
 
 	VkSemaphore postTraverseSemaphore = VK_NULL_HANDLE;
 	mFrameGraph->Traverse(mThreadPoolRef, mScene.get(), mSwapChain.get(), frameFence, currentFrameResourceIndex, currentSwapchainIndex, preTraverseSemaphore, &postTraverseSemaphore);
 
+	mLatencyTracker->MarkSubmitted();
+
 	mSwapChain->Present(postTraverseSemaphore);
+	mLatencyTracker->MarkPresented();
+}
+
+const ModernFrameGraph* Vulkan::Renderer::GetFrameGraph() const
+{
+	return mFrameGraph.get();
 }
 
 void Vulkan::Renderer::InitInstance()
@@ -225,7 +280,7 @@ void Vulkan::Renderer::InitInstance()
 	instanceCreateInfo.enabledExtensionCount   = (uint32_t)enabledExtensionsCStrs.size();
 	instanceCreateInfo.ppEnabledExtensionNames = enabledExtensionsCStrs.data();
 
-	ThrowIfFailed(vkCreateInstance(&instanceCreateInfo, nullptr, &mInstance));
+	ThrowIfFailed(vkCreateInstance(&instanceCreateInfo, HostAllocator::Callbacks(), &mInstance));
 }
 
 void Vulkan::Renderer::InitDebuggingEnvironment()
@@ -242,7 +297,7 @@ void Vulkan::Renderer::InitDebuggingEnvironment()
 	debugMessengerCreateInfo.pfnUserCallback = VulkanUtils::DebugReportCallback;
 	debugMessengerCreateInfo.pUserData       = nullptr;
 
-	ThrowIfFailed(vkCreateDebugUtilsMessengerEXT(mInstance, &debugMessengerCreateInfo, nullptr, &mDebugMessenger));
+	ThrowIfFailed(vkCreateDebugUtilsMessengerEXT(mInstance, &debugMessengerCreateInfo, HostAllocator::Callbacks(), &mDebugMessenger));
 #endif
 }
 
@@ -309,7 +364,7 @@ void Vulkan::Renderer::CreateLogicalDevice(VkPhysicalDevice physicalDevice, cons
 	deviceCreateInfo.ppEnabledExtensionNames = enabledExtensionsCStrs.data();
 	deviceCreateInfo.pEnabledFeatures        = nullptr;
 
-	ThrowIfFailed(vkCreateDevice(mPhysicalDevice, &deviceCreateInfo, nullptr, &mDevice));
+	ThrowIfFailed(vkCreateDevice(mPhysicalDevice, &deviceCreateInfo, HostAllocator::Callbacks(), &mDevice));
 }
 
 void Vulkan::Renderer::CreateFences()
@@ -321,7 +376,7 @@ void Vulkan::Renderer::CreateFences()
 		fenceCreateInfo.pNext = nullptr;
 		fenceCreateInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
 
-		ThrowIfFailed(vkCreateFence(mDevice, &fenceCreateInfo, nullptr, &mRenderFences[i]));
+		ThrowIfFailed(vkCreateFence(mDevice, &fenceCreateInfo, HostAllocator::Callbacks(), &mRenderFences[i]));
 	}
 }
 
@@ -10,6 +10,7 @@
 
 class ThreadPool;
 class FrameCounter;
+class ModernFrameGraph;
 
 namespace Vulkan
 {
@@ -32,11 +33,16 @@ namespace Vulkan
 		void AttachToWindow(Window* window)      override;
 		void ResizeWindowBuffers(Window* window) override;
 
+		//Renders to engine-owned images instead of a window. Works without any windowing system, e.g. for benchmarking on headless machines
+		void AttachToOffscreenTarget(uint32_t width, uint32_t height);
+
 		BaseRenderableScene* InitScene(const RenderableSceneDescription& sceneDescription, const std::unordered_map<std::string_view, SceneObjectLocation>& sceneMeshInitialLocations, std::unordered_map<std::string_view, RenderableSceneObjectHandle>& outObjectHandles) override;
 		void                 InitFrameGraph(FrameGraphConfig&& frameGraphConfig, FrameGraphDescription&& frameGraphDescription)                                                                                                                                             override;
 
 		void Render() override;
 
+		const ModernFrameGraph* GetFrameGraph() const;
+
 	private:
 		void InitInstance();
 		void InitDebuggingEnvironment();
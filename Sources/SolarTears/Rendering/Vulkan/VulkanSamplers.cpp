@@ -68,6 +68,6 @@ void Vulkan::SamplerManager::InitializeSamplers()
 		samplerCreateInfo.borderColor             = VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK;
 		samplerCreateInfo.unnormalizedCoordinates = VK_FALSE;
 
-		ThrowIfFailed(vkCreateSampler(mDeviceRef, &samplerCreateInfo, nullptr, &mSamplers[i]));
+		ThrowIfFailed(vkCreateSampler(mDeviceRef, &samplerCreateInfo, HostAllocator::Callbacks(), &mSamplers[i]));
 	}
 }
\ No newline at end of file
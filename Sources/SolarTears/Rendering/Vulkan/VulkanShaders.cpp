@@ -157,7 +157,7 @@ void Vulkan::ShaderDatabase::CreateMatchingPipelineLayout(std::span<std::string_
 		pipelineLayoutCreateInfo.pushConstantRangeCount = (uint32_t)pushConstants.size();
 		pipelineLayoutCreateInfo.pPushConstantRanges    = pushConstants.data();
 
-		ThrowIfFailed(vkCreatePipelineLayout(mDeviceRef, &pipelineLayoutCreateInfo, nullptr, outPipelineLayout));
+		ThrowIfFailed(vkCreatePipelineLayout(mDeviceRef, &pipelineLayoutCreateInfo, HostAllocator::Callbacks(), outPipelineLayout));
 	}
 	else
 	{
@@ -1206,7 +1206,7 @@ void Vulkan::ShaderDatabase::BuildSetLayouts(const DeviceParameters* deviceParam
 		setLayoutCreateInfo.pBindings    = mLayoutBindingsFlat.data() + layoutRecordNode.BindingSpan.Begin;
 		setLayoutCreateInfo.bindingCount = layoutBindingCount;
 
-		ThrowIfFailed(vkCreateDescriptorSetLayout(mDeviceRef, &setLayoutCreateInfo, nullptr, &layoutRecordNode.SetLayout));
+		ThrowIfFailed(vkCreateDescriptorSetLayout(mDeviceRef, &setLayoutCreateInfo, HostAllocator::Callbacks(), &layoutRecordNode.SetLayout));
 	}
 
 	mSetLayoutsForCreatePipelineFlat.resize(mLayoutRecordNodeIndicesFlat.size());
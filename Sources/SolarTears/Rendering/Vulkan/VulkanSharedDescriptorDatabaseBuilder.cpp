@@ -143,7 +143,7 @@ void Vulkan::SharedDescriptorDatabaseBuilder::RecreateSharedDescriptorPool(const
 	descriptorPoolCreateInfo.poolSizeCount = poolSizeCount;
 	descriptorPoolCreateInfo.pPoolSizes    = poolSizes.data();
 
-	ThrowIfFailed(vkCreateDescriptorPool(mDatabaseToBuild->mDeviceRef, &descriptorPoolCreateInfo, nullptr, &mDatabaseToBuild->mSharedDescriptorPool));
+	ThrowIfFailed(vkCreateDescriptorPool(mDatabaseToBuild->mDeviceRef, &descriptorPoolCreateInfo, HostAllocator::Callbacks(), &mDatabaseToBuild->mSharedDescriptorPool));
 }
 
 void Vulkan::SharedDescriptorDatabaseBuilder::AllocateSharedDescriptorSets(const RenderableScene* scene, const SamplerManager* samplerManager, std::vector<VkDescriptorSet>& outAllocatedSets)
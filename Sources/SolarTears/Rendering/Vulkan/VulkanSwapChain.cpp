@@ -1,18 +1,25 @@
 #include "VulkanSwapChain.hpp"
 #include "VulkanFunctions.hpp"
 #include "VulkanUtils.hpp"
+#include "VulkanMemory.hpp"
 #include "../Common/RenderingUtils.hpp"
 #include <VulkanGenericStructures.h>
 #include <unordered_set>
 #include <array>
 #include <algorithm>
+#include <cassert>
 
 Vulkan::SwapChain::SwapChain(LoggerQueue* logger, VkInstance instance, VkDevice device): mLogger(logger), mInstanceRef(instance), mDeviceRef(device), mPresentQueueFamilyIndex((uint32_t)(-1)),
                                                                                          mSwapchainWidth(0), mSwapchainHeight(0),
                                                                                          mSwapChainColorSpace(VK_COLOR_SPACE_SRGB_NONLINEAR_KHR), mSwapChainFormat(VK_FORMAT_B8G8R8A8_UNORM),
 	                                                                                     mCurrentImageIndex((uint32_t)(-1)), mSurface(VK_NULL_HANDLE), mSwapchain(VK_NULL_HANDLE),
-	                                                                                     mPresentQueue(VK_NULL_HANDLE)
+	                                                                                     mPresentQueue(VK_NULL_HANDLE), mOffscreen(false), mOffscreenMemoryManagerRef(nullptr), mOffscreenImageMemory(VK_NULL_HANDLE)
 {
+	for(uint32_t i = 0; i < SwapchainImageCount; i++)
+	{
+		mSwapchainImages[i] = VK_NULL_HANDLE;
+	}
+
 	for(uint32_t i = 0; i < Utils::InFlightFrameCount; i++)
 	{
 		VkSemaphoreCreateInfo semaphoreCreateInfo;
@@ -20,12 +27,14 @@ Vulkan::SwapChain::SwapChain(LoggerQueue* logger, VkInstance instance, VkDevice
 		semaphoreCreateInfo.pNext = nullptr;
 		semaphoreCreateInfo.flags = 0;
 
-		ThrowIfFailed(vkCreateSemaphore(device, &semaphoreCreateInfo, nullptr, &mImageAcquiredSemaphores[i]));
+		ThrowIfFailed(vkCreateSemaphore(device, &semaphoreCreateInfo, HostAllocator::Callbacks(), &mImageAcquiredSemaphores[i]));
 	}
 }
 
 Vulkan::SwapChain::~SwapChain()
 {
+	DestroyOffscreenImages();
+
 	SafeDestroyObject(vkDestroySwapchainKHR, mDeviceRef, mSwapchain);
 	SafeDestroyObject(vkDestroySurfaceKHR,   mInstanceRef, mSurface);
 
@@ -37,6 +46,8 @@ Vulkan::SwapChain::~SwapChain()
 
 void Vulkan::SwapChain::BindToWindow(VkPhysicalDevice physicalDevice, const InstanceParameters& instanceParameters, const DeviceParameters& deviceParameters, Window* window)
 {
+	DestroyOffscreenImages();
+
 	SafeDestroyObject(vkDestroySurfaceKHR, mInstanceRef, mSurface);
 
 	CreateSurface(mInstanceRef, window);
@@ -74,8 +85,39 @@ void Vulkan::SwapChain::Recreate(VkPhysicalDevice physicalDevice, const Instance
 	ThrowIfFailed(vkGetSwapchainImagesKHR(mDeviceRef, mSwapchain, &swapchainImageCount, &mSwapchainImages[0]));
 }
 
+void Vulkan::SwapChain::BindToOffscreenTarget(MemoryManager* memoryManager, uint32_t presentQueueFamilyIndex, uint32_t width, uint32_t height)
+{
+	SafeDestroyObject(vkDestroySwapchainKHR, mDeviceRef,   mSwapchain);
+	SafeDestroyObject(vkDestroySurfaceKHR,   mInstanceRef, mSurface);
+	DestroyOffscreenImages();
+
+	mOffscreen                 = true;
+	mOffscreenMemoryManagerRef = memoryManager;
+
+	mPresentQueueFamilyIndex = presentQueueFamilyIndex;
+	GetPresentQueue(mDeviceRef, mPresentQueueFamilyIndex);
+
+	mSwapchainWidth      = width;
+	mSwapchainHeight     = height;
+	mSwapChainColorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
+	mSwapChainFormat     = VK_FORMAT_B8G8R8A8_UNORM;
+
+	mSurfaceHDRCapabilities.localDimmingSupport                    = false;
+	mExclussiveFullscreenCapabilities.fullScreenExclusiveSupported = false;
+
+	CreateOffscreenImages();
+}
+
 void Vulkan::SwapChain::AcquireImage(VkDevice device, uint32_t frameInFlightIndex)
 {
+	if(mOffscreen)
+	{
+		//The renderer expects the images in frame order, same as FIFO presentation gives them
+		mCurrentImageIndex = frameInFlightIndex % SwapchainImageCount;
+		SignalSemaphoreOffscreen(mImageAcquiredSemaphores[frameInFlightIndex]);
+		return;
+	}
+
 	//TODO: mGPU?
 	VkAcquireNextImageInfoKHR acquireNextImageInfo;
 	acquireNextImageInfo.sType      = VK_STRUCTURE_TYPE_ACQUIRE_NEXT_IMAGE_INFO_KHR;
@@ -98,6 +140,13 @@ VkSemaphore Vulkan::SwapChain::GetImageAcquiredSemaphore(uint32_t frameInFlightI
 
 void Vulkan::SwapChain::Present(VkSemaphore presentSemaphore)
 {
+	if(mOffscreen)
+	{
+		//Nothing to show, but the semaphore still has to be waited on to be reused
+		WaitSemaphoreOffscreen(presentSemaphore);
+		return;
+	}
+
 	std::array presentSemaphores = {presentSemaphore};
 	std::array swapchains        = {mSwapchain};
 	std::array imageIndices      = {mCurrentImageIndex};
@@ -164,9 +213,19 @@ bool Vulkan::SwapChain::IsBackbufferHDR() const
 	return (mSwapChainColorSpace == VK_COLOR_SPACE_HDR10_HLG_EXT) || (mSwapChainColorSpace == VK_COLOR_SPACE_HDR10_ST2084_EXT) || (mSwapChainColorSpace == VK_COLOR_SPACE_DOLBYVISION_EXT);
 }
 
-void Vulkan::SwapChain::CreateSurface(VkInstance instance, Window* window)
+bool Vulkan::SwapChain::IsOffscreen() const
+{
+	return mOffscreen;
+}
+
+void Vulkan::SwapChain::CreateSurface([[maybe_unused]] VkInstance instance, [[maybe_unused]] Window* window)
 {
+#if defined(_WIN32) && defined(VK_USE_PLATFORM_WIN32_KHR)
 	CreateSurface(instance, window->NativeHandle());
+#else
+	//Headless windows don't have a native handle to create a surface for, BindToOffscreenTarget() has to be used instead
+	assert(false);
+#endif
 }
 
 void Vulkan::SwapChain::CreateSwapChain(VkPhysicalDevice physicalDevice, VkDevice device, Window* window)
@@ -297,7 +356,7 @@ void Vulkan::SwapChain::CreateSwapChain(VkPhysicalDevice physicalDevice, VkDevic
 	swapchainCreateInfo.oldSwapchain              = mSwapchain;
 
 	VkSwapchainKHR newSwapchain = VK_NULL_HANDLE;
-	ThrowIfFailed(vkCreateSwapchainKHR(device, &swapchainCreateInfo, nullptr, &newSwapchain));
+	ThrowIfFailed(vkCreateSwapchainKHR(device, &swapchainCreateInfo, HostAllocator::Callbacks(), &newSwapchain));
 
 	mSwapchain = newSwapchain;
 }
@@ -390,6 +449,105 @@ void Vulkan::SwapChain::GetPresentQueue(VkDevice device, uint32_t presentIndex)
 	}
 }
 
+void Vulkan::SwapChain::CreateOffscreenImages()
+{
+	std::array<VkBindImageMemoryInfo, SwapchainImageCount> bindImageMemoryInfos;
+	for(uint32_t imageIndex = 0; imageIndex < SwapchainImageCount; imageIndex++)
+	{
+		//Same usages a window swapchain is created with, plus copying from to read the results back
+		VkImageCreateInfo imageCreateInfo;
+		imageCreateInfo.sType                 = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		imageCreateInfo.pNext                 = nullptr;
+		imageCreateInfo.flags                 = 0;
+		imageCreateInfo.imageType             = VK_IMAGE_TYPE_2D;
+		imageCreateInfo.format                = mSwapChainFormat;
+		imageCreateInfo.extent.width          = mSwapchainWidth;
+		imageCreateInfo.extent.height         = mSwapchainHeight;
+		imageCreateInfo.extent.depth          = 1;
+		imageCreateInfo.mipLevels             = 1;
+		imageCreateInfo.arrayLayers           = 1;
+		imageCreateInfo.samples               = VK_SAMPLE_COUNT_1_BIT;
+		imageCreateInfo.tiling                = VK_IMAGE_TILING_OPTIMAL;
+		imageCreateInfo.usage                 = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+		imageCreateInfo.sharingMode           = VK_SHARING_MODE_EXCLUSIVE;
+		imageCreateInfo.queueFamilyIndexCount = 0;
+		imageCreateInfo.pQueueFamilyIndices   = nullptr;
+		imageCreateInfo.initialLayout         = VK_IMAGE_LAYOUT_UNDEFINED;
+
+		ThrowIfFailed(vkCreateImage(mDeviceRef, &imageCreateInfo, HostAllocator::Callbacks(), &mSwapchainImages[imageIndex]));
+
+		bindImageMemoryInfos[imageIndex].sType        = VK_STRUCTURE_TYPE_BIND_IMAGE_MEMORY_INFO;
+		bindImageMemoryInfos[imageIndex].pNext        = nullptr;
+		bindImageMemoryInfos[imageIndex].image        = mSwapchainImages[imageIndex];
+		bindImageMemoryInfos[imageIndex].memory       = VK_NULL_HANDLE;
+		bindImageMemoryInfos[imageIndex].memoryOffset = 0;
+	}
+
+	mOffscreenImageMemory = mOffscreenMemoryManagerRef->AllocateImagesMemory(mDeviceRef, bindImageMemoryInfos, MemoryManager::AllocationCategory::FrameGraphImages);
+}
+
+void Vulkan::SwapChain::DestroyOffscreenImages()
+{
+	if(!mOffscreen)
+	{
+		return;
+	}
+
+	for(uint32_t imageIndex = 0; imageIndex < SwapchainImageCount; imageIndex++)
+	{
+		SafeDestroyObject(vkDestroyImage, mDeviceRef, mSwapchainImages[imageIndex]);
+	}
+
+	mOffscreenMemoryManagerRef->FreeMemory(mDeviceRef, mOffscreenImageMemory);
+
+	mOffscreen                 = false;
+	mOffscreenMemoryManagerRef = nullptr;
+}
+
+void Vulkan::SwapChain::SignalSemaphoreOffscreen(VkSemaphore semaphore)
+{
+	std::array signalSemaphores = {semaphore};
+
+	VkSubmitInfo submitInfo;
+	submitInfo.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.pNext                = nullptr;
+	submitInfo.waitSemaphoreCount   = 0;
+	submitInfo.pWaitSemaphores      = nullptr;
+	submitInfo.pWaitDstStageMask    = nullptr;
+	submitInfo.commandBufferCount   = 0;
+	submitInfo.pCommandBuffers      = nullptr;
+	submitInfo.signalSemaphoreCount = (uint32_t)signalSemaphores.size();
+	submitInfo.pSignalSemaphores    = signalSemaphores.data();
+
+	std::array submitInfos = {submitInfo};
+	ThrowIfFailed(vkQueueSubmit(mPresentQueue, (uint32_t)submitInfos.size(), submitInfos.data(), VK_NULL_HANDLE));
+}
+
+void Vulkan::SwapChain::WaitSemaphoreOffscreen(VkSemaphore semaphore)
+{
+	if(semaphore == VK_NULL_HANDLE)
+	{
+		return;
+	}
+
+	std::array waitSemaphores = {semaphore};
+	std::array waitStageFlags = {(VkPipelineStageFlags)VK_PIPELINE_STAGE_ALL_COMMANDS_BIT};
+
+	VkSubmitInfo submitInfo;
+	submitInfo.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.pNext                = nullptr;
+	submitInfo.waitSemaphoreCount   = (uint32_t)waitSemaphores.size();
+	submitInfo.pWaitSemaphores      = waitSemaphores.data();
+	submitInfo.pWaitDstStageMask    = waitStageFlags.data();
+	submitInfo.commandBufferCount   = 0;
+	submitInfo.pCommandBuffers      = nullptr;
+	submitInfo.signalSemaphoreCount = 0;
+	submitInfo.pSignalSemaphores    = nullptr;
+
+	std::array submitInfos = {submitInfo};
+	ThrowIfFailed(vkQueueSubmit(mPresentQueue, (uint32_t)submitInfos.size(), submitInfos.data(), VK_NULL_HANDLE));
+}
+
 #if defined(_WIN32) && defined(VK_USE_PLATFORM_WIN32_KHR)
 	void Vulkan::SwapChain::CreateSurface(VkInstance instance, HWND hwnd)
 	{
@@ -400,6 +558,6 @@ void Vulkan::SwapChain::GetPresentQueue(VkDevice device, uint32_t presentIndex)
 		surfaceCreateInfo.hinstance = GetModuleHandle(nullptr);
 		surfaceCreateInfo.hwnd      = hwnd;
 
-		ThrowIfFailed(vkCreateWin32SurfaceKHR(instance, &surfaceCreateInfo, nullptr, &mSurface));
+		ThrowIfFailed(vkCreateWin32SurfaceKHR(instance, &surfaceCreateInfo, HostAllocator::Callbacks(), &mSurface));
 	}
 #endif
\ No newline at end of file
@@ -9,6 +9,8 @@
 
 namespace Vulkan
 {
+	class MemoryManager;
+
 	class SwapChain
 	{
 	public:
@@ -21,6 +23,9 @@ namespace Vulkan
 		void BindToWindow(VkPhysicalDevice physicalDevice, const InstanceParameters& instanceParameters, const DeviceParameters& deviceParameters, Window* window);
 		void Recreate(VkPhysicalDevice physicalDevice, const InstanceParameters& instanceParameters, const DeviceParameters& deviceParameters, Window* window);
 
+		//Replaces the window swapchain with engine-owned images, acquire and present only pass the semaphores through. Doesn't need any surface support
+		void BindToOffscreenTarget(MemoryManager* memoryManager, uint32_t presentQueueFamilyIndex, uint32_t width, uint32_t height);
+
 		void AcquireImage(VkDevice device, uint32_t frameInFlightIndex);
 		void Present(VkSemaphore presentSemaphore);
 
@@ -36,6 +41,7 @@ namespace Vulkan
 		VkFormat GetBackbufferFormat() const;
 
 		bool IsBackbufferHDR() const;
+		bool IsOffscreen()     const;
 
 	private:
 		void CreateSurface(VkInstance instance, Window* window);
@@ -46,6 +52,12 @@ namespace Vulkan
 		void FindPresentQueueIndex(VkPhysicalDevice physicalDevice);
 		void GetPresentQueue(VkDevice device, uint32_t presentQueueIndex);
 
+		void CreateOffscreenImages();
+		void DestroyOffscreenImages();
+
+		void SignalSemaphoreOffscreen(VkSemaphore semaphore);
+		void WaitSemaphoreOffscreen(VkSemaphore semaphore);
+
 	#if defined(_WIN32) && defined(VK_USE_PLATFORM_WIN32_KHR)
 		void CreateSurface(VkInstance instance, HWND hwnd);
 	#endif 
@@ -76,6 +88,10 @@ namespace Vulkan
 
 		VkImage mSwapchainImages[SwapchainImageCount];
 
+		bool           mOffscreen;
+		MemoryManager* mOffscreenMemoryManagerRef;
+		VkDeviceMemory mOffscreenImageMemory;
+
 		VkColorSpaceKHR mSwapChainColorSpace;
 		VkFormat        mSwapChainFormat;
 	};
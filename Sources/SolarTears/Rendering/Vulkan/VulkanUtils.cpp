@@ -1,10 +1,11 @@
 #include "VulkanUtils.hpp"
-#include "..\..\Core\Util.hpp"
-#include "..\..\Logging\LoggerQueue.hpp"
+#include "../../Core/Util.hpp"
+#include "../../Logging/LoggerQueue.hpp"
 #include "VulkanFunctions.hpp"
 #include "VulkanDeviceParameters.hpp"
 #include <string>
 #include <fstream>
+#include <filesystem>
 #include <cinttypes>
 #include <format>
 #include <numeric>
@@ -34,7 +35,7 @@ std::wstring Vulkan::VulkanUtils::VkException::ToString() const
 
 void Vulkan::VulkanUtils::LoadShaderModuleFromFile(const std::wstring_view filename, std::vector<uint32_t>& dataBlob, LoggerQueue* logger)
 {
-    std::ifstream fin(filename.data(), std::ios::binary); // 
+    std::ifstream fin(std::filesystem::path(filename), std::ios::binary); // 
     if(!fin)
     {
         logger->PostLogMessage(L"Cannot read shader file " + std::wstring(filename) + L"!\n");
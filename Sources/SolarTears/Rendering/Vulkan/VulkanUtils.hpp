@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include <DirectXMath.h>
+#include "VulkanHostAllocator.hpp"
 
 class LoggerQueue;
 
@@ -64,47 +65,53 @@ namespace Vulkan
 	}
 }
 
+//L#x and __FILEW__ are MSVC-only, token pasting the L prefix works everywhere
+#ifndef VulkanWidenString
+#define VulkanWidenStringImpl(x) L##x
+#define VulkanWidenString(x)     VulkanWidenStringImpl(x)
+#endif
+
 #ifndef ThrowIfFailed
-#define ThrowIfFailed(x)                                                     \
-{                                                                            \
-	VkResult vkres__ = (x);                                                  \
-	if(vkres__ != VK_SUCCESS)                                                \
-	{                                                                        \
-		std::wstring wfn = __FILEW__;                                        \
-		throw Vulkan::VulkanUtils::VkException(vkres__, L#x, wfn, __LINE__); \
-	}                                                                        \
+#define ThrowIfFailed(x)                                                                       \
+{                                                                                              \
+	VkResult vkres__ = (x);                                                                    \
+	if(vkres__ != VK_SUCCESS)                                                                  \
+	{                                                                                          \
+		std::wstring wfn = VulkanWidenString(__FILE__);                                        \
+		throw Vulkan::VulkanUtils::VkException(vkres__, VulkanWidenString(#x), wfn, __LINE__); \
+	}                                                                                          \
 }
 #endif
 
 #ifndef SafeDestroyObject
-#define SafeDestroyObject(vkDestroyObject, Owner, Object) \
-{                                                         \
-	if(Object != VK_NULL_HANDLE)                          \
-	{                                                     \
-		vkDestroyObject(Owner, Object, nullptr);          \
-		Object = VK_NULL_HANDLE;                          \
-	}                                                     \
+#define SafeDestroyObject(vkDestroyObject, Owner, Object)                       \
+{                                                                               \
+	if(Object != VK_NULL_HANDLE)                                                \
+	{                                                                           \
+		vkDestroyObject(Owner, Object, Vulkan::HostAllocator::Callbacks());     \
+		Object = VK_NULL_HANDLE;                                                \
+	}                                                                           \
 } 
 #endif
 
 #ifndef SafeDestroyDevice
-#define SafeDestroyDevice(Device)         \
-{                                         \
-	if(Device != VK_NULL_HANDLE)          \
-	{                                     \
-		vkDestroyDevice(Device, nullptr); \
-		Device = VK_NULL_HANDLE;          \
-	}                                     \
+#define SafeDestroyDevice(Device)                                   \
+{                                                                   \
+	if(Device != VK_NULL_HANDLE)                                    \
+	{                                                               \
+		vkDestroyDevice(Device, Vulkan::HostAllocator::Callbacks()); \
+		Device = VK_NULL_HANDLE;                                    \
+	}                                                               \
 } 
 #endif
 
 #ifndef SafeDestroyInstance
-#define SafeDestroyInstance(Instance)         \
-{                                             \
-	if(Instance != VK_NULL_HANDLE)            \
-	{                                         \
-		vkDestroyInstance(Instance, nullptr); \
-		Instance = VK_NULL_HANDLE;            \
-	}                                         \
+#define SafeDestroyInstance(Instance)                                   \
+{                                                                       \
+	if(Instance != VK_NULL_HANDLE)                                      \
+	{                                                                   \
+		vkDestroyInstance(Instance, Vulkan::HostAllocator::Callbacks()); \
+		Instance = VK_NULL_HANDLE;                                      \
+	}                                                                   \
 } 
 #endif
\ No newline at end of file
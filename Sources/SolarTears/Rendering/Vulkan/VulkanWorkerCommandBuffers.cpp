@@ -153,7 +153,7 @@ VkCommandPool Vulkan::WorkerCommandBuffers::CreateCommandPool(uint32_t queueFami
 	commandPoolCreateInfo.queueFamilyIndex = queueFamilyIndex;
 
 	VkCommandPool commandPool = nullptr;
-	ThrowIfFailed(vkCreateCommandPool(mDeviceRef, &commandPoolCreateInfo, nullptr, &commandPool));
+	ThrowIfFailed(vkCreateCommandPool(mDeviceRef, &commandPoolCreateInfo, HostAllocator::Callbacks(), &commandPool));
 
 	return commandPool;
 }
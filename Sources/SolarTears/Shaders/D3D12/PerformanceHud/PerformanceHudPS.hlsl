@@ -0,0 +1,29 @@
+static const uint GlyphWidth      = 5;
+static const uint GlyphHeight     = 7;
+static const uint FontBitmapWidth = 230;
+
+//One byte of coverage per texel, see PerformanceHud::BuildFontBitmap()
+ByteAddressBuffer gFontBitmap: register(t0);
+
+//================================================================
+
+struct VertexOut
+{
+	float4               ClipPos:    SV_POSITION;
+	float2               GlyphCoord: TEXCOORD;
+	nointerpolation uint GlyphIndex: GLYPHINDEX;
+	float4               Color:      COLOR;
+};
+
+//================================================================
+
+float4 main(VertexOut pin): SV_TARGET
+{
+	uint2 glyphPixel = (uint2)clamp(floor(pin.GlyphCoord), float2(0.0f, 0.0f), float2(GlyphWidth - 1, GlyphHeight - 1));
+	uint  texelIndex = glyphPixel.y * FontBitmapWidth + pin.GlyphIndex * GlyphWidth + glyphPixel.x;
+
+	uint  texelDword = gFontBitmap.Load(texelIndex & ~3u);
+	float coverage   = (float)((texelDword >> ((texelIndex & 3u) * 8u)) & 0xffu) / 255.0f;
+
+	return float4(pin.Color.rgb, pin.Color.a * coverage);
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+struct VertexIn
+{
+	float2 Position:   POSITION;
+	float2 GlyphCoord: TEXCOORD;
+	uint   GlyphIndex: GLYPHINDEX;
+	float4 Color:      COLOR;
+};
+
+struct VertexOut
+{
+	float4               ClipPos:    SV_POSITION;
+	float2               GlyphCoord: TEXCOORD;
+	nointerpolation uint GlyphIndex: GLYPHINDEX;
+	float4               Color:      COLOR;
+};
+
+//================================================================
+
+VertexOut main(VertexIn vin)
+{
+	//The HUD positions have Y pointing down, D3D12 clip space has Y pointing up
+	VertexOut vout;
+	vout.ClipPos    = float4(vin.Position.x, -vin.Position.y, 0.0f, 1.0f);
+	vout.GlyphCoord = vin.GlyphCoord;
+	vout.GlyphIndex = vin.GlyphIndex;
+	vout.Color      = vin.Color;
+
+	return vout;
+}
\ No newline at end of file
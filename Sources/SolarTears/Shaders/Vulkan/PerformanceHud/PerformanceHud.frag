@@ -0,0 +1,28 @@
+#version 450
+
+const uint GlyphWidth      = 5;
+const uint GlyphHeight     = 7;
+const uint FontBitmapWidth = 230;
+
+//One byte of coverage per texel, see PerformanceHud::BuildFontBitmap()
+layout(set = 0, binding = 0) uniform usamplerBuffer FontBitmap;
+
+//================================================================
+
+layout(location = 0)      in vec2 fragGlyphCoord;
+layout(location = 1) flat in uint fragGlyphIndex;
+layout(location = 2)      in vec4 fragColor;
+
+layout(location = 0) out vec4 outColor;
+
+//================================================================
+
+void main()
+{
+	uvec2 glyphPixel = uvec2(clamp(floor(fragGlyphCoord), vec2(0.0f), vec2(GlyphWidth - 1, GlyphHeight - 1)));
+	uint  texelIndex = glyphPixel.y * FontBitmapWidth + fragGlyphIndex * GlyphWidth + glyphPixel.x;
+
+	float coverage = float(texelFetch(FontBitmap, int(texelIndex)).r) / 255.0f;
+
+	outColor = vec4(fragColor.rgb, fragColor.a * coverage);
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+#version 450
+
+//================================================================
+
+layout(location = 0) in vec2 inPosition;
+layout(location = 1) in vec2 inGlyphCoord;
+layout(location = 2) in uint inGlyphIndex;
+layout(location = 3) in vec4 inColor;
+
+layout(location = 0)      out vec2 fragGlyphCoord;
+layout(location = 1) flat out uint fragGlyphIndex;
+layout(location = 2)      out vec4 fragColor;
+
+//================================================================
+
+void main()
+{
+	//The HUD positions are already in normalized device coordinates with Y pointing down, same as Vulkan
+	gl_Position = vec4(inPosition, 0.0f, 1.0f);
+
+	fragGlyphCoord = inGlyphCoord;
+	fragGlyphIndex = inGlyphIndex;
+	fragColor      = inColor;
+}
\ No newline at end of file
@@ -1,21 +1,89 @@
 #include "Core/Application.hpp"
 #include "Core/Window.hpp"
 #include "Core/Engine.hpp"
+#include "Core/Benchmark.hpp"
+#include "Core/MicroBenchmark.hpp"
+#include <algorithm>
+#include <charconv>
 #include <memory>
+#include <vector>
+#include <string_view>
 
 #ifdef _WIN32
 int WinMain(HINSTANCE hInstance, [[maybe_unused]] HINSTANCE hPrevInstance, [[maybe_unused]] LPSTR nCmdLine, [[maybe_unused]] int nCmdShow)
 {
+	//The benchmark results go to stdout, redirect it to a file to see them from a GUI subsystem executable
+	std::vector<std::string_view> arguments(__argv + 1, __argv + __argc);
+	if(std::find(arguments.begin(), arguments.end(), "-microbenchmark") != arguments.end())
+	{
+		MicroBenchmarkSuite microBenchmarkSuite;
+		RegisterEngineMicroBenchmarks(&microBenchmarkSuite);
+		return microBenchmarkSuite.Run(MicroBenchmarkSuite::ParseCommandLine(arguments));
+	}
+
+	if(std::find(arguments.begin(), arguments.end(), "-benchmark") != arguments.end())
+	{
+		Benchmark benchmark(Benchmark::ParseCommandLine(arguments));
+		return benchmark.Run();
+	}
+
 	Application app(hInstance);
-#else
-int main(int argc, char* argv[])
-{
-#endif
 
 	std::unique_ptr<Engine> engine = std::make_unique<Engine>();
 
+	//-lateinput enables late input sampling to reduce the input latency
+	if(std::find(arguments.begin(), arguments.end(), "-lateinput") != arguments.end())
+	{
+		engine->SetLateInputSampling(true);
+	}
+
+	//-hud shows the performance overlay
+	if(std::find(arguments.begin(), arguments.end(), "-hud") != arguments.end())
+	{
+		engine->SetPerformanceHudEnabled(true);
+	}
+
+	//-record PATH saves the frame input on exit, -replay PATH plays it back for A/B frame time comparisons, -fps N limits the frame rate, -gltf PATH loads a glTF scene
+	for(size_t argumentIndex = 0; argumentIndex + 1 < arguments.size(); argumentIndex++)
+	{
+		if(arguments[argumentIndex] == "-gltf")
+		{
+			engine->ImportGltfScene(std::string(arguments[argumentIndex + 1]));
+		}
+		else if(arguments[argumentIndex] == "-record")
+		{
+			engine->StartCaptureRecording(std::string(arguments[argumentIndex + 1]));
+		}
+		else if(arguments[argumentIndex] == "-replay")
+		{
+			engine->StartCaptureReplay(std::string(arguments[argumentIndex + 1]));
+		}
+		else if(arguments[argumentIndex] == "-fps")
+		{
+			uint32_t targetFps = 0;
+			std::from_chars(arguments[argumentIndex + 1].data(), arguments[argumentIndex + 1].data() + arguments[argumentIndex + 1].size(), targetFps);
+			engine->SetTargetFrameTime((targetFps != 0) ? (1.0f / (float)targetFps) : 0.0f);
+		}
+	}
+
 	Window window(app.NativeHandle(), L"Solar Tears", 100, 100, 768, 768);
 	engine->BindToWindow(&window);
 
 	return app.Run(engine.get());
-}
\ No newline at end of file
+}
+#else
+int main(int argc, char* argv[])
+{
+	//Only the benchmarks are supported outside of Windows
+	std::vector<std::string_view> arguments(argv + 1, argv + argc);
+	if(std::find(arguments.begin(), arguments.end(), "-microbenchmark") != arguments.end())
+	{
+		MicroBenchmarkSuite microBenchmarkSuite;
+		RegisterEngineMicroBenchmarks(&microBenchmarkSuite);
+		return microBenchmarkSuite.Run(MicroBenchmarkSuite::ParseCommandLine(arguments));
+	}
+
+	Benchmark benchmark(Benchmark::ParseCommandLine(arguments));
+	return benchmark.Run();
+}
+#endif
\ No newline at end of file
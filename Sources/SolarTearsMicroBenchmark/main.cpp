@@ -0,0 +1,15 @@
+#include "../SolarTears/Core/MicroBenchmark.hpp"
+#include <vector>
+#include <string_view>
+
+//Runs the CPU-only microbenchmarks, same as SolarTears -microbenchmark but without the renderer, so it builds without a graphics API
+//Usage: SolarTearsMicroBenchmark [-filter NAME] [-json PATH] [-baseline PATH] [-threshold RATIO] [-mintime SECONDS]
+
+int main(int argc, char* argv[])
+{
+	std::vector<std::string_view> arguments(argv + 1, argv + argc);
+
+	MicroBenchmarkSuite microBenchmarkSuite;
+	RegisterEngineMicroBenchmarks(&microBenchmarkSuite);
+	return microBenchmarkSuite.Run(MicroBenchmarkSuite::ParseCommandLine(arguments));
+}
\ No newline at end of file
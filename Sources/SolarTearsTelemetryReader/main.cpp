@@ -0,0 +1,93 @@
+#include "../SolarTears/Core/Telemetry/TelemetryBlock.hpp"
+#include "../SolarTears/Core/Telemetry/TelemetrySharedMemory.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <thread>
+
+//Reads the telemetry block published by a running SolarTears instance
+//Usage: SolarTearsTelemetryReader [--tail [intervalMs]]
+
+namespace
+{
+	constexpr uint32_t MaxReadAttempts = 64;
+
+	void PrintHeader()
+	{
+		printf("%10s %10s %9s %8s %12s %9s %8s %12s %10s %10s %6s %6s\n", "frame", "time s", "frame ms", "draws", "triangles", "barriers", "binds", "upload B", "ws MiB", "priv MiB", "logq", "jobq");
+	}
+
+	void PrintFrameData(const TelemetryFrameData& frameData)
+	{
+		constexpr double bytesInMiB = 1024.0 * 1024.0;
+
+		printf("%10llu %10.2f %9.3f %8llu %12llu %9llu %8llu %12llu %10.1f %10.1f %6u %6u\n",
+			(unsigned long long)frameData.FrameIndex,
+			frameData.TimeSeconds,
+			frameData.FrameTimeMs,
+			(unsigned long long)frameData.DrawCount,
+			(unsigned long long)frameData.TriangleCount,
+			(unsigned long long)frameData.BarrierCount,
+			(unsigned long long)frameData.DescriptorSetBindCount,
+			(unsigned long long)frameData.UploadByteCount,
+			frameData.ProcessWorkingSetBytes / bytesInMiB,
+			frameData.ProcessPrivateBytes    / bytesInMiB,
+			frameData.LogQueueDepth,
+			frameData.JobQueueDepth);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	bool     tail       = false;
+	uint32_t intervalMs = 100;
+
+	for(int argIndex = 1; argIndex < argc; argIndex++)
+	{
+		if(strcmp(argv[argIndex], "--tail") == 0)
+		{
+			tail = true;
+			if(argIndex + 1 < argc && argv[argIndex + 1][0] != '-')
+			{
+				intervalMs = (uint32_t)strtoul(argv[++argIndex], nullptr, 10);
+			}
+		}
+		else
+		{
+			fprintf(stderr, "Usage: %s [--tail [intervalMs]]\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	TelemetrySharedMemory sharedMemory;
+	const TelemetryBlock* block = sharedMemory.Open();
+	if(block == nullptr)
+	{
+		fprintf(stderr, "No telemetry block found. Is the engine running?\n");
+		return EXIT_FAILURE;
+	}
+
+	printf("Reading telemetry of process %u\n", block->WriterProcessId);
+	PrintHeader();
+
+	uint64_t lastPrintedFrame = UINT64_MAX;
+	do
+	{
+		TelemetryFrameData frameData;
+		if(Telemetry::ReadFrameData(block, &frameData, MaxReadAttempts) && frameData.FrameIndex != lastPrintedFrame)
+		{
+			PrintFrameData(frameData);
+			fflush(stdout);
+
+			lastPrintedFrame = frameData.FrameIndex;
+		}
+
+		if(tail)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+		}
+	} while(tail);
+
+	return EXIT_SUCCESS;
+}
\ No newline at end of file